@@ -9,7 +9,9 @@
 #ifndef ANALYZE_SIM_RESONANCE_HPP
 #define ANALYZE_SIM_RESONANCE_HPP
 
+#include <array>
 #include <thread>
+#include <algorithm>
 
 #include "TF1.h"
 #include "TH1.h"
@@ -17,7 +19,6 @@
 #include "TH3.h"
 #include "TFile.h"
 
-#include "ROOT/TThreadedObject.hxx"
 #include "ROOT/TTreeProcessorMT.hxx"
 
 #include "InputYAMLReader.hpp"
@@ -29,7 +30,11 @@
 #include "Constants.hpp"
 #include "SingleTrackFunc.hpp"
 #include "PairTrackFunc.hpp"
+#include "MixedEventPool.hpp"
 #include "SimTreeReader.hpp"
+#include "SimTreeIndex.hpp"
+#include "FlatHist.hpp"
+#include "ProgressMonitor.hpp"
 #include "DeadMapCutter.hpp"
 #include "SimSigmalizedResiduals.hpp"
 #include "SimM2Identificator.hpp"
@@ -58,6 +63,13 @@ namespace AnalyzeSimResonance
    double pTMax;
    /// shows whether the  particles will be reweighted to the corresponding spectra
    bool reweightForSpectra;
+   /// mass of the resonance [GeV/c^2]
+   double resonanceMass;
+   /// width of the resonance [GeV/c^2]
+   double resonanceGamma;
+   /// shows whether the mixed event pairs skipped by kinematic bounds are also 
+   /// evaluated to check that none of them could have filled the mixed event histograms
+   bool verifyPairPruning = false;
    /// file reader for all required parameters for the resonance and for its simulation processing
    InputYAMLReader inputYAMLResonance;
    /// file reader for all required parameters for the current run
@@ -65,26 +77,36 @@ namespace AnalyzeSimResonance
    /// file reader for all required parameters for the simulation processing 
    /// of widthless resonance decay products
    InputYAMLReader inputYAMLSimSingleTrack;
-   /// pT scale (original pT as well as all single tracks) for systematics evaluation
-   double pTScale = 1.;
-   /// acceptance variation by the value of acceptance systematic uncertainty
-   /// can have any value, but only 3 interpretations by the program:
-   /// 1. 0 (by default) - no variation
-   /// 2. negative - acceptance is decreased by its systematic uncertainty
-   /// 2. positive - acceptance is increased by its systematic uncertainty
-   int acceptanceVar = 0;
-   /// cuts offset variation by the value of detectors resolution systematic uncertainty, by the width of sigmalized variables (sdphi, sdz), and by other fiducialy chosen variations
-   /// can have any value, but only 3 interpretations by the program:
-   /// 1. 0 (by default) - no variation
-   /// 2. negative - cuts are tightened
-   /// 2. positive - cuts are loosened
-   int cutsVar = 0;
+   /// shows whether all variations from the list "variations" of the input file 
+   /// are processed in the same event loop
+   bool isMultiVariation = false;
    /// number of threads
    int numberOfThreads;
    /// number of events across all trees
    unsigned long numberOfEvents = 0;
-   /// parameter for monitoring the progress
-   unsigned long numberOfCalls = 0;
+   /// counters of processed events, tracks, and read bytes for monitoring the progress
+   ProgressMonitor progress;
+   /// names of all simulated trees that will be analyzed in the order they are processed
+   std::vector<std::string> simInputFileNames;
+   /// size of TTreeCache as a factor of the cluster size of simulated trees
+   double treeCacheSizeFactor;
+   /// number of entries TTreeCache learns which branches are read
+   int treeCacheLearnEntries;
+   /// shows whether the baskets of simulated trees are prefetched asynchronously
+   bool asyncPrefetching;
+   /// shows whether the next file in the queue is prefetched while the current one is processed
+   bool prefetchNextFile;
+   /// compression level of the output file
+   int outputCompressionLevel;
+   /// branches of simulated trees that are read (other branches are never activated)
+   const std::vector<std::string> simTreeBranches = 
+   {
+      "mom_orig", "nch", "bbcz", "dcarm", "phi", "alpha", "zed", "mom", "the0", "phi0",
+      "qual", "charge", "ttof", "pltof", "ppc1x", "ppc1y", "ppc1z", "ppc2x", "ppc2y", "ppc2z",
+      "ppc3x", "ppc3y", "ppc3z", "tofdz", "tofdphi", "tofwdz", "tofwdphi", "emcdz", "emcdphi",
+      "pc2dz", "pc2dphi", "pc3dz", "pc3dphi", "striptofw", "slat", "etof", "ecore", "sect",
+      "ysect", "zsect"
+   };
    /// cutter for deadmaps
    DeadMapCutter dmCutter;
    /// calibrator for simulated sigmalized residuals of charged tracks sdphi and sdz
@@ -103,241 +125,225 @@ namespace AnalyzeSimResonance
    bool useEMCal;
    /// shows whether identification with EMCal is used
    bool useEMCalId;
-
-   /* @struct ThrContainerCopy
-    * @brief Container for storing local ThrContainer copies (at least 1 for each thread) 
-    * since copying speeds up the calculation because local copies 
-    * do not require synchronization from each other
-    *
-    * Contains the same histograms ThrContainer but as shared_ptr<T>
+   /// pair selection methods of M_inv distributions (see SelectPair)
+   enum PairMethod {DCPC1_NO_PID = 0, NO_PID, PC2_NO_PID, PC3_NO_PID, TOFE_NO_PID, TOFW_NO_PID,
+                    EMCAL_NO_PID, DCPC1_1PID, TOF_DCPC1_1PID, K_TOF_DCPC1_1PID, 
+                    EMCAL_DCPC1_1PID, ONE_PID, TOF_1PID, K_TOF_1PID, EMCAL_1PID, TWO_PID, 
+                    TOF_2PID, TOFE_2PID, TOFW_2PID, EMCAL_2PID, NUMBER_OF_PAIR_METHODS};
+   /// names of the pair selection methods in the same order as in PairMethod
+   /// (same as the names of the methods of the real data)
+   const std::array<std::string, NUMBER_OF_PAIR_METHODS> pairMethodsNames = 
+   {
+      "DCPC1NoPID", "NoPID", "PC2NoPID", "PC3NoPID", "TOFeNoPID", "TOFwNoPID", "EMCalNoPID", 
+      "DCPC11PID", "1TOFDCPC11PID", "1K1TOFDCPC11PID", "1EMCalDCPC11PID", "1PID", "1TOF1PID", 
+      "1K1TOF1PID", "1EMCal1PID", "2PID", "TOF2PID", "TOFe2PID", "TOFw2PID", "EMCal2PID"
+   };
+   /* @struct PairSelection
+    * @brief Pair selection methods the pair of tracks passes and the weights of the pair for them
     */
-   struct ThrContainerCopy
+   struct PairSelection
    {
-      /// distribution of original unscaled generated pT
-      std::shared_ptr<TH1D> distrOrigUnscaledPT;
-      /// distribution of original generated pT
-      std::shared_ptr<TH1D> distrOrigPT;
-      /// distribution of original generated pT vs reconstructed pT of daughters
-      std::shared_ptr<TH2F> distrOrigPTVsRecDaughtersPT;
-      /// distribution of original generated pT vs reconstructed pT in the simulation
-      std::shared_ptr<TH2F> distrOrigPTVsRecPT;
-      /// distribution of original resonance pT vs pT of all particles in events (decay products and secondary particles)
-      std::shared_ptr<TH2F> distrOrigPTVsDecayRecPT;
-      /// invariant mass distribution with the cut opposite to one arm cut
-      std::shared_ptr<TH2F> distrMInvOneArmAntiCut;
-      /// TOFeNoPID invariant mass distribution with ghost anti cut
-      std::shared_ptr<TH2F> distrMInvTOFeGhostNoPID;
-      /// TOFwNoPID invariant mass distribution with ghost anti cut
-      std::shared_ptr<TH2F> distrMInvTOFwGhostNoPID;
-      /// EMCalNoPID invariant mass distribution with ghost anti cut
-      std::shared_ptr<TH2F> distrMInvEMCalGhostNoPID;
-      /// DCPC1NoPID invariant mass distribution
-      std::shared_ptr<TH2F> distrMInvDCPC1NoPID;
-      /// NoPID invariant mass distribution
-      std::shared_ptr<TH2F> distrMInvNoPID;
-      /// PC2NoPID invariant mass distribution
-      std::shared_ptr<TH2F> distrMInvPC2NoPID;
-      /// PC3NoPID invariant mass distribution
-      std::shared_ptr<TH2F> distrMInvPC3NoPID;
-      /// TOFeNoPID invariant mass distribution
-      std::shared_ptr<TH2F> distrMInvTOFeNoPID;
-      /// TOFwNoPID invariant mass distribution
-      std::shared_ptr<TH2F> distrMInvTOFwNoPID;
-      /// EMCalNoPID invariant mass distribution
-      std::shared_ptr<TH2F> distrMInvEMCalNoPID;
-      /// DCPC11PID invariant mass distribution
-      std::shared_ptr<TH2F> distrMInvDCPC11PID;
-      /// 1TOFDCPC11PID invariant mass distribution
-      std::shared_ptr<TH2F> distrMInv1TOFDCPC11PID;
-      /// 1K1TOFDCPC11PID invariant mass distribution
-      std::shared_ptr<TH2F> distrMInv1K1TOFDCPC11PID;
-      /// 1EMCalDCPC11PID invariant mass distribution
-      std::shared_ptr<TH2F> distrMInv1EMCalDCPC11PID;
-      /// 1PID invariant mass distribution
-      std::shared_ptr<TH2F> distrMInv1PID;
-      /// 1TOF1PID invariant mass distribution
-      std::shared_ptr<TH2F> distrMInv1TOF1PID;
-      /// 1K1TOF1PID invariant mass distribution
-      std::shared_ptr<TH2F> distrMInv1K1TOF1PID;
-      /// 1EMCal1PID invariant mass distribution
-      std::shared_ptr<TH2F> distrMInv1EMCal1PID;
-      /// 2PID invariant mass distribution
-      std::shared_ptr<TH2F> distrMInv2PID;
-      /// TOF2PID invariant mass distribution
-      std::shared_ptr<TH2F> distrMInvTOF2PID;
-      /// TOFe2PID invariant mass distribution
-      std::shared_ptr<TH2F> distrMInvTOFe2PID;
-      /// TOFw2PID invariant mass distribution
-      std::shared_ptr<TH2F> distrMInvTOFw2PID;
-      /// EMCal2PID invariant mass distribution
-      std::shared_ptr<TH2F> distrMInvEMCal2PID;
-      /// zed1 - zed2 vs pT vs Minv for pairs of tracks
-      std::shared_ptr<TH3F> distrDZedVsPT;
-      /// pc2phi1 - pc2phi2 vs pc2z1 - pc2z2 vs pT within 
-      /// 2*Gamma + 10 MeV of the center of the signal for PC2
-      std::shared_ptr<TH2F> distrDPC2PhiDPC2ZVsPT;
-      /// pc2phi1 - pc2phi2 vs pc3z1 - pc3z2 vs pT in the same arm within
-      /// 2*Gamma + 10 MeV of the center of the signal for PC3
-      std::shared_ptr<TH2F> distrDPC3PhiDPC3ZVsPT;
-      /// chamber1 - chamber2 vs slat1 - slat2 vs pT within 
-      /// 2*Gamma + 10 MeV of the center of the signal for TOFe
-      std::shared_ptr<TH3F> distrDChamberDSlatVsPT;
-      /// chamber1 - chamber2 vs strip1 - strip2 vs pT within 
-      /// 2*Gamma + 10 MeV of the center of the signal for TOFw
-      std::shared_ptr<TH3F> distrDChamberDStripVsPT;
-      /// ytower1 - ytower2 vs ztower1 - ztower2 vs pT within 
-      /// 2*Gamma + 10 MeV of the center of the signal for the same sector of EMCal
-      std::shared_ptr<TH3F> distrDYTowerDZTowerVsPT;
+      /// bit (1 << PairMethod) is set for every method the pair passes
+      unsigned int methods = 0;
+      /// weights of the pair (without the weight of the event) for the methods it passes
+      std::array<double, NUMBER_OF_PAIR_METHODS> weights;
    };
-   /* @struct ThrContainer
-    * @brief Container for storing ROOT::TThreadedObject variables 
-    * (histograms for multithreading with TTreeProcessorMT)
+   /// maximum number of events in each pool of the mixed event background (0 disables mixing)
+   unsigned long mixedEventPoolDepth = 0;
+   /// pair selection methods (PairMethod) for which the mixed event histograms are filled
+   std::vector<int> mixedPairMethods;
+   /// decay modes (e.g. piK) of the configurations; histograms of the mixed event
+   /// background are filled separately for each decay mode as in the real data
+   std::vector<std::string> mixedDecayModes;
+   /// upper edge of pT axes of the mixed event histograms [GeV/c]
+   const double mixedPTMax = 20.;
+   /// upper edge of M_inv axes of the mixed event histograms [GeV/c^2]
+   const double mixedMInvMax = 5.;
+   /// pools of the events of each thread for the mixed event background
+   std::unique_ptr<ThrEventPools> eventPools;
+
+   /* @struct HistContainer
+    * @brief Container of the histograms that are filled by one thread
+    *
+    * Histograms are declared only here; ThrContainer constructs one HistContainer for each thread from this declaration. Histograms of the detectors that are disabled in detectors_configuration are never allocated and are written empty
     */
-   struct ThrContainer
+   struct HistContainer
    {
-      /// @brief returns ThrContainerCopy with std::shared_ptr 
-      /// copies of ROOT::TThreadedObject histograms
-      ThrContainerCopy GetCopy();
-      /// @brief writes the merged histograms across all threads into the file with a specified name
-      void Write(const std::string& outputFileName);
+      /*! @brief Constructor
+       * @param[in] detectorsConfiguration detectors_configuration from main.yaml
+       */
+      HistContainer(const std::string& detectorsConfiguration);
+      /// registry of the histograms (must be declared before the histograms)
+      HistRegistry registry;
       /// distribution of original generated unscaled pT
-      std::unique_ptr<ROOT::TThreadedObject<TH1D>> distrOrigUnscaledPT = 
-         std::make_unique<ROOT::TThreadedObject<TH1D>>("orig unscaled pT", "p_{T}", 100., 0., 10.);
+      FlatHist<TH1D> distrOrigUnscaledPT{registry, HistRegistry::ANY, "", "orig unscaled pT",
+                                         "p_{T}", 100., 0., 10.};
       /// distribution of original generated pT
-      std::unique_ptr<ROOT::TThreadedObject<TH1D>> distrOrigPT = 
-         std::make_unique<ROOT::TThreadedObject<TH1D>>("orig pT", "p_{T}", 100., 0., 10.);
+      FlatHist<TH1D> distrOrigPT{registry, HistRegistry::ANY, "", "orig pT", "p_{T}", 100., 0.,
+                                 10.};
       // distribution of original generated pT vs reconstructed pT of daughters in the simulation
-      ROOT::TThreadedObject<TH2F> 
-         distrOrigPTVsRecDaughtersPT{"orig pT vs rec daughters pT", "p_{T}^{orig} vs p_{T}^{rec}", 
-                            100, 0., 10., 100, 0., 10.};
+      FlatHist<TH2F> distrOrigPTVsRecDaughtersPT{registry, HistRegistry::ANY, "",
+                                                 "orig pT vs rec daughters pT",
+                                                 "p_{T}^{orig} vs p_{T}^{rec}", 100, 0., 10., 100,
+                                                 0., 10.};
       // distribution of original generated pT vs reconstructed pT in the simulation
-      ROOT::TThreadedObject<TH2F> 
-         distrOrigPTVsRecPT{"orig pT vs rec pT", "p_{T}^{orig} vs p_{T}^{rec}", 
-                            100, 0., 10., 100, 0., 10.};
+      FlatHist<TH2F> distrOrigPTVsRecPT{registry, HistRegistry::ANY, "", "orig pT vs rec pT",
+                                        "p_{T}^{orig} vs p_{T}^{rec}", 100, 0., 10., 100, 0., 10.};
       /// distribution of original resonance pT vs pT of all particles in events (decay products and secondary particles)
-      ROOT::TThreadedObject<TH2F> 
-         distrOrigPTVsDecayRecPT{"orig pT vs decay rec pT", "p_{T}^{orig} vs p_{T}^{rec}", 
-                                 100, 0., 10., 100, 0., 10.};
+      FlatHist<TH2F> distrOrigPTVsDecayRecPT{registry, HistRegistry::ANY, "",
+                                             "orig pT vs decay rec pT",
+                                             "p_{T}^{orig} vs p_{T}^{rec}", 100, 0., 10., 100, 0.,
+                                             10.};
       /// invariant mass distribution with the cut opposite to one arm cut
-      ROOT::TThreadedObject<TH2F> distrMInvOneArmAntiCut{"M_inv: DCPC1NoPID, one arm anti cut", 
-                                                         "M_{inv} vs p_{T}", 
-                                                         200, 0., 20., 1000, 0., 5.};
+      FlatHist<TH2F> distrMInvOneArmAntiCut{registry, HistRegistry::ANY, "",
+                                            "M_inv: DCPC1NoPID, one arm anti cut",
+                                            "M_{inv} vs p_{T}", 200, 0., 20., 1000, 0., 5.};
       /// TOFeNoPID invariant mass distribution with TOFe ghost anticut
-      ROOT::TThreadedObject<TH2F> distrMInvTOFeGhostNoPID{"M_inv: TOFeNoPID, ghost anticut", 
-                                                          "M_{inv} vs p_{T}", 
-                                                          200, 0., 20., 1000, 0., 5.};
+      FlatHist<TH2F> distrMInvTOFeGhostNoPID{registry, HistRegistry::TOFe, "",
+                                             "M_inv: TOFeNoPID, ghost anticut", "M_{inv} vs p_{T}",
+                                             200, 0., 20., 1000, 0., 5.};
       /// TOFwNoPID invariant mass distribution with TOFw ghost anticut
-      ROOT::TThreadedObject<TH2F> distrMInvTOFwGhostNoPID{"M_inv: TOFwNoPID, ghost anticut", 
-                                                          "M_{inv} vs p_{T}", 
-                                                          200, 0., 20., 1000, 0., 5.};
+      FlatHist<TH2F> distrMInvTOFwGhostNoPID{registry, HistRegistry::TOFw, "",
+                                             "M_inv: TOFwNoPID, ghost anticut", "M_{inv} vs p_{T}",
+                                             200, 0., 20., 1000, 0., 5.};
       /// EMCalNoPID invariant mass distribution with EMCal ghost anticut
-      ROOT::TThreadedObject<TH2F> distrMInvEMCalGhostNoPID{"M_inv: EMCalNoPID, ghost anticut", 
-                                                           "M_{inv} vs p_{T}", 
-                                                           200, 0., 20., 1000, 0., 5.};
+      FlatHist<TH2F> distrMInvEMCalGhostNoPID{registry, HistRegistry::EMCal, "",
+                                              "M_inv: EMCalNoPID, ghost anticut",
+                                              "M_{inv} vs p_{T}", 200, 0., 20., 1000, 0., 5.};
       /// DCPC1NoPID invariant mass distribution
-      ROOT::TThreadedObject<TH2F> distrMInvDCPC1NoPID{"M_inv: DCPC1NoPID", "M_{inv} vs p_{T}", 
-                                                      200, 0., 20., 1000, 0., 5.};
+      FlatHist<TH2F> distrMInvDCPC1NoPID{registry, HistRegistry::ANY, "", "M_inv: DCPC1NoPID",
+                                         "M_{inv} vs p_{T}", 200, 0., 20., 1000, 0., 5.};
       /// NoPID invariant mass distribution
-      ROOT::TThreadedObject<TH2F> distrMInvNoPID{"M_inv: NoPID", "M_{inv} vs p_{T}", 
-                                                 200, 0., 20., 1000, 0., 5.};
+      FlatHist<TH2F> distrMInvNoPID{registry, HistRegistry::ANY, "", "M_inv: NoPID",
+                                    "M_{inv} vs p_{T}", 200, 0., 20., 1000, 0., 5.};
       /// PC2NoPID invariant mass distribution
-      ROOT::TThreadedObject<TH2F> distrMInvPC2NoPID{"M_inv: PC2NoPID", "M_{inv} vs p_{T}", 
-                                                    200, 0., 20., 1000, 0., 5.};
+      FlatHist<TH2F> distrMInvPC2NoPID{registry, HistRegistry::PC2, "", "M_inv: PC2NoPID",
+                                       "M_{inv} vs p_{T}", 200, 0., 20., 1000, 0., 5.};
       /// PC3NoPID invariant mass distribution
-      ROOT::TThreadedObject<TH2F> distrMInvPC3NoPID{"M_inv: PC3NoPID", "M_{inv} vs p_{T}", 
-                                                    200, 0., 20., 1000, 0., 5.};
+      FlatHist<TH2F> distrMInvPC3NoPID{registry, HistRegistry::PC3, "", "M_inv: PC3NoPID",
+                                       "M_{inv} vs p_{T}", 200, 0., 20., 1000, 0., 5.};
       /// TOFeNoPID invariant mass distribution
-      ROOT::TThreadedObject<TH2F> distrMInvTOFeNoPID{"M_inv: TOFeNoPID", "M_{inv} vs p_{T}", 
-                                                     200, 0., 20., 1000, 0., 5.};
+      FlatHist<TH2F> distrMInvTOFeNoPID{registry, HistRegistry::TOFe, "", "M_inv: TOFeNoPID",
+                                        "M_{inv} vs p_{T}", 200, 0., 20., 1000, 0., 5.};
       /// TOFwNoPID invariant mass distribution
-      ROOT::TThreadedObject<TH2F> distrMInvTOFwNoPID{"M_inv: TOFwNoPID", "M_{inv} vs p_{T}", 
-                                                     200, 0., 20., 1000, 0., 5.};
+      FlatHist<TH2F> distrMInvTOFwNoPID{registry, HistRegistry::TOFw, "", "M_inv: TOFwNoPID",
+                                        "M_{inv} vs p_{T}", 200, 0., 20., 1000, 0., 5.};
       /// EMCalNoPID invariant mass distribution
-      ROOT::TThreadedObject<TH2F> distrMInvEMCalNoPID{"M_inv: EMCalNoPID", "M_{inv} vs p_{T}", 
-                                                      200, 0., 20., 1000, 0., 5.};
+      FlatHist<TH2F> distrMInvEMCalNoPID{registry, HistRegistry::EMCal, "", "M_inv: EMCalNoPID",
+                                         "M_{inv} vs p_{T}", 200, 0., 20., 1000, 0., 5.};
       /// DCPC11PID invariant mass distribution
-      ROOT::TThreadedObject<TH2F> distrMInvDCPC11PID{"M_inv: DCPC11PID", "M_{inv} vs p_{T}", 
-                                                     200, 0., 20., 1000, 0., 5.};
+      FlatHist<TH2F> distrMInvDCPC11PID{registry, HistRegistry::ANY, "", "M_inv: DCPC11PID",
+                                        "M_{inv} vs p_{T}", 200, 0., 20., 1000, 0., 5.};
       /// 1TOFDCPC11PID invariant mass distribution
-      ROOT::TThreadedObject<TH2F> distrMInv1TOFDCPC11PID{"M_inv: 1TOFDCPC11PID", "M_{inv} vs p_{T}", 
-                                                         200, 0., 20., 1000, 0., 5.};
+      FlatHist<TH2F> distrMInv1TOFDCPC11PID{registry, HistRegistry::ANY, "", "M_inv: 1TOFDCPC11PID",
+                                            "M_{inv} vs p_{T}", 200, 0., 20., 1000, 0., 5.};
       /// 1K1TOFDCPC11PID invariant mass distribution
-      ROOT::TThreadedObject<TH2F> distrMInv1K1TOFDCPC11PID{"M_inv: 1K1TOFDCPC11PID", "M_{inv} vs p_{T}", 
-                                                           200, 0., 20., 1000, 0., 5.};
+      FlatHist<TH2F> distrMInv1K1TOFDCPC11PID{registry, HistRegistry::ANY, "",
+                                              "M_inv: 1K1TOFDCPC11PID", "M_{inv} vs p_{T}", 200, 0.,
+                                              20., 1000, 0., 5.};
       /// 1EMCalDCPC11PID invariant mass distribution
-      ROOT::TThreadedObject<TH2F> distrMInv1EMCalDCPC11PID{"M_inv: 1EMCalDCPC11PID", 
-                                                           "M_{inv} vs p_{T}", 
-                                                           200, 0., 20., 1000, 0., 5.};
+      FlatHist<TH2F> distrMInv1EMCalDCPC11PID{registry, HistRegistry::ANY, "",
+                                              "M_inv: 1EMCalDCPC11PID", "M_{inv} vs p_{T}", 200, 0.,
+                                              20., 1000, 0., 5.};
       /// 1PID invariant mass distribution
-      ROOT::TThreadedObject<TH2F> distrMInv1PID{"M_inv: 1PID", "M_{inv} vs p_{T}", 
-                                                200, 0., 20., 1000, 0., 5.};
+      FlatHist<TH2F> distrMInv1PID{registry, HistRegistry::ANY, "", "M_inv: 1PID",
+                                   "M_{inv} vs p_{T}", 200, 0., 20., 1000, 0., 5.};
       /// 1TOF1PID invariant mass distribution
-      ROOT::TThreadedObject<TH2F> distrMInv1TOF1PID{"M_inv: 1TOF1PID", "M_{inv} vs p_{T}", 
-                                                    200, 0., 20., 1000, 0., 5.};
+      FlatHist<TH2F> distrMInv1TOF1PID{registry, HistRegistry::ANY, "", "M_inv: 1TOF1PID",
+                                       "M_{inv} vs p_{T}", 200, 0., 20., 1000, 0., 5.};
       /// 1K1TOF1PID invariant mass distribution
-      ROOT::TThreadedObject<TH2F> distrMInv1K1TOF1PID{"M_inv: 1K1TOF1PID", "M_{inv} vs p_{T}", 
-                                                      200, 0., 20., 1000, 0., 5.};
+      FlatHist<TH2F> distrMInv1K1TOF1PID{registry, HistRegistry::ANY, "", "M_inv: 1K1TOF1PID",
+                                         "M_{inv} vs p_{T}", 200, 0., 20., 1000, 0., 5.};
       /// 1EMCal1PID invariant mass distribution
-      ROOT::TThreadedObject<TH2F> distrMInv1EMCal1PID{"M_inv: 1EMCal1PID", "M_{inv} vs p_{T}", 
-                                                      200, 0., 20., 1000, 0., 5.};
+      FlatHist<TH2F> distrMInv1EMCal1PID{registry, HistRegistry::ANY, "", "M_inv: 1EMCal1PID",
+                                         "M_{inv} vs p_{T}", 200, 0., 20., 1000, 0., 5.};
       /// 2PID invariant mass distribution
-      ROOT::TThreadedObject<TH2F> distrMInv2PID{"M_inv: 2PID", "M_{inv} vs p_{T}", 
-                                                200, 0., 20., 1000, 0., 5.};
+      FlatHist<TH2F> distrMInv2PID{registry, HistRegistry::ANY, "", "M_inv: 2PID",
+                                   "M_{inv} vs p_{T}", 200, 0., 20., 1000, 0., 5.};
       /// TOF2PID invariant mass distribution
-      ROOT::TThreadedObject<TH2F> distrMInvTOF2PID{"M_inv: TOF2PID", "M_{inv} vs p_{T}", 
-                                                   200, 0., 20., 1000, 0., 5.};
+      FlatHist<TH2F> distrMInvTOF2PID{registry, HistRegistry::ANY, "", "M_inv: TOF2PID",
+                                      "M_{inv} vs p_{T}", 200, 0., 20., 1000, 0., 5.};
       /// TOFe2PID invariant mass distribution
-      ROOT::TThreadedObject<TH2F> distrMInvTOFe2PID{"M_inv: TOFe2PID", "M_{inv} vs p_{T}", 
-                                                    200, 0., 20., 1000, 0., 5.};
+      FlatHist<TH2F> distrMInvTOFe2PID{registry, HistRegistry::TOFe, "", "M_inv: TOFe2PID",
+                                       "M_{inv} vs p_{T}", 200, 0., 20., 1000, 0., 5.};
       /// TOFw2PID invariant mass distribution
-      ROOT::TThreadedObject<TH2F> distrMInvTOFw2PID{"M_inv: TOFw2PID", "M_{inv} vs p_{T}", 
-                                                    200, 0., 20., 1000, 0., 5.};
+      FlatHist<TH2F> distrMInvTOFw2PID{registry, HistRegistry::TOFw, "", "M_inv: TOFw2PID",
+                                       "M_{inv} vs p_{T}", 200, 0., 20., 1000, 0., 5.};
       /// EMCal2PID invariant mass distribution
-      ROOT::TThreadedObject<TH2F> distrMInvEMCal2PID{"M_inv: EMCal2PID", "M_{inv} vs p_{T}", 
-                                                     200, 0., 20., 1000, 0., 5.};
+      FlatHist<TH2F> distrMInvEMCal2PID{registry, HistRegistry::EMCal, "", "M_inv: EMCal2PID",
+                                        "M_{inv} vs p_{T}", 200, 0., 20., 1000, 0., 5.};
       /// pc2phi1 - pc2phi2 vs pc2z1 - pc2z vs pT within 
       /// 2*Gamma + 10 MeV of the center of the signal for the same sector of EMCal
-      ROOT::TThreadedObject<TH2F> 
-         distrDPC2PhiDPC2ZVsPT{"delta pc2phi vs delta pc2z", 
-                                "z_{1}^{PC2} - z_{2}^{PC2} vs "\
-                                "#varphi_{1}^{PC2} - #varphi_{2}^{PC2}",
-                                200, -10., 10., 200, -0.1, 0.1};
+      FlatHist<TH2F> distrDPC2PhiDPC2ZVsPT{registry, HistRegistry::PC2, "",
+                                           "delta pc2phi vs delta pc2z",
+                                           "z_{1}^{PC2} - z_{2}^{PC2} vs "\
+                                           "#varphi_{1}^{PC2} - #varphi_{2}^{PC2}",
+                                           200, -10., 10., 200, -0.1, 0.1};
       /// pc3phi1 - pc3phi2 vs pc3z1 - pc3z vs pT in the same arm within 
       /// 2*Gamma + 10 MeV of the center of the signal
-      ROOT::TThreadedObject<TH2F> 
-         distrDPC3PhiDPC3ZVsPT{"delta pc3phi vs delta pc3z", 
-                                "z_{1}^{PC3} - z_{2}^{PC3} vs "\
-                                "#varphi_{1}^{PC3} - #varphi_{2}^{PC3}",
-                                200, -10., 10., 200., -0.1, 0.1};
+      FlatHist<TH2F> distrDPC3PhiDPC3ZVsPT{registry, HistRegistry::PC3, "",
+                                           "delta pc3phi vs delta pc3z",
+                                           "z_{1}^{PC3} - z_{2}^{PC3} vs "\
+                                           "#varphi_{1}^{PC3} - #varphi_{2}^{PC3}",
+                                           200, -10., 10., 200., -0.1, 0.1};
       /// ytower1 - ytower2 vs ztower1 - ztower2 vs pT for the pair in the same sector within 
       /// 2*Gamma + 10 MeV of the center of the signal for the same sector of EMCal
-      ROOT::TThreadedObject<TH3F> 
-         distrDYTowerDZTowerVsPT{"delta ytower vs delta ztower", 
-                                 "ytower_{1} - ytower_{2} vs ztower_{1} - ztower_{2} vs p_{T}",
-                                 96, -48., 48., 194, -97., 97, 10, 0., 10.};
+      FlatHist<TH3F> distrDYTowerDZTowerVsPT{registry, HistRegistry::EMCal, "",
+                                             "delta ytower vs delta ztower",
+                                             "ytower_{1} - ytower_{2} vs "\
+                                             "ztower_{1} - ztower_{2} vs p_{T}",
+                                             96, -48., 48., 194, -97., 97, 10, 0., 10.};
       /// chamber1 - chamber2 vs slat1 - slat2 vs pT within 
       /// 2*Gamma + 10 MeV of the center of the signal for TOFe
-      ROOT::TThreadedObject<TH3F> 
-         distrDChamberDSlatVsPT{"delta chamber vs delta slat", 
-                                "chamber_{1} - chamber_{2} vs slat_{1} - slat_{2} vs p_{T}",
-                                20, -10., 10., 192, -96., 96, 10, 0., 10.};
+      FlatHist<TH3F> distrDChamberDSlatVsPT{registry, HistRegistry::TOFe, "",
+                                            "delta chamber vs delta slat",
+                                            "chamber_{1} - chamber_{2} vs "\
+                                            "slat_{1} - slat_{2} vs p_{T}",
+                                            20, -10., 10., 192, -96., 96, 10, 0., 10.};
       /// chamber1 - chamber2 vs strip1 - strip2 vs pT within 
       /// 2*Gamma + 10 MeV of the center of the signal for TOFw
-      ROOT::TThreadedObject<TH3F> 
-         distrDChamberDStripVsPT{"delta chamber vs delta strip", 
-                                "chamber_{1} - chamber_{2} vs strip_{1} - strip_{2} vs p_{T}",
-                                20, -10., 10., 128, -64., 64, 10, 0., 10.};
+      FlatHist<TH3F> distrDChamberDStripVsPT{registry, HistRegistry::TOFw, "",
+                                             "delta chamber vs delta strip",
+                                             "chamber_{1} - chamber_{2} vs "\
+                                             "strip_{1} - strip_{2} vs p_{T}",
+                                             20, -10., 10., 128, -64., 64, 10, 0., 10.};
+      /// invariant mass distributions of the pair selection methods in the order of PairMethod
+      std::array<FlatHist<TH2F> *, NUMBER_OF_PAIR_METHODS> distrMInvMethods;
    };
-   /* @brief Processes the single configuration (for the given particle, 
-    * magnetic field, and pT range) from one file
+   /// container that provides each thread with its own HistContainer and merges them on write
+   using ThrContainer = ThrHistContainer<HistContainer>;
+   /* @struct MixedHistContainer
+    * @brief Container of the histograms of the same event pairs (FG) and of the mixed event pairs (BG) that are filled by one thread for every pool bin in the same layout as the histograms of the real data (see MInv::Merge)
     *
-    * @param[in] thrContainer the current ThrContainer in which the data will be written to 
-    * @param[in] particleName name of the particle to be analyzed 
-    * @param[in] pTRangeName name of the pT range to be analyzed 
+    * Histograms are declared from eventPools, mixedDecayModes, and mixedPairMethods which must be set before the container is constructed. Only the histograms of the pool bins that receive events are allocated
     */
-   void AnalyzeConfiguration(ThrContainer& thrContainer, const std::string& particleName,
-                             const int daughter1Id, const int daugther2Id,
-                             const std::string& magneticFieldName, const std::string& pTRangeName);
+   struct MixedHistContainer
+   {
+      /*! @brief Constructor
+       * @param[in] detectorsConfiguration detectors_configuration from main.yaml
+       */
+      MixedHistContainer(const std::string& detectorsConfiguration);
+      /// returns the index of the histograms of the pool bin, the decay mode, 
+      /// and the position of the method in mixedPairMethods
+      unsigned long GetIndex(const int poolBin, const unsigned long decayModeIndex, 
+                             const unsigned long methodIndex) const;
+      /// registry of the histograms (must be declared before the histograms)
+      HistRegistry registry;
+      /// number of events in each pool bin (bin 2 is used for normalization as in the real data)
+      std::vector<std::unique_ptr<FlatHist<TH1D>>> poolStatistics;
+      /// M_inv vs pT distributions of the same event pairs
+      std::vector<std::unique_ptr<FlatHist<TH2F>>> distrMInvFG;
+      /// M_inv vs pT distributions of the mixed event pairs
+      std::vector<std::unique_ptr<FlatHist<TH2F>>> distrMInvBG;
+      /// M_inv vs pT distributions of the same event pairs with low resolution 
+      /// (for background scaling)
+      std::vector<std::unique_ptr<FlatHist<TH2F>>> distrMInvFGLR;
+      /// M_inv vs pT distributions of the mixed event pairs with low resolution 
+      /// (for background scaling)
+      std::vector<std::unique_ptr<FlatHist<TH2F>>> distrMInvBGLR;
+   };
+   /// container that provides each thread with its own MixedHistContainer
+   std::unique_ptr<ThrHistContainer<MixedHistContainer>> thrMixedContainer;
    /* @struct AcceptanceVar
     * @brief Container for storing acceptance variations for different detectors
     */
@@ -366,6 +372,263 @@ namespace AnalyzeSimResonance
       /// values of acceptance variation for EMCale(0-3) and EMCalw(0-3)
       std::array<std::array<double, 4>, 2> EMCal{{{{0., 0., 0., 0.}}, {{0., 0., 0., 0.}}}};
    };
+   /* @struct Variation
+    * @brief Parameters of the single systematic variation and the histograms filled for it
+    */
+   struct Variation
+   {
+      /// pT scale (original pT as well as all single tracks) for systematics evaluation
+      double pTScale = 1.;
+      /// acceptance variation by the value of acceptance systematic uncertainty
+      /// can have any value, but only 3 interpretations by the program:
+      /// 1. 0 (by default) - no variation
+      /// 2. negative - acceptance is decreased by its systematic uncertainty
+      /// 2. positive - acceptance is increased by its systematic uncertainty
+      int acceptanceVar = 0;
+      /// cuts offset variation by the value of detectors resolution systematic uncertainty, by the width of sigmalized variables (sdphi, sdz), and by other fiducialy chosen variations
+      /// can have any value, but only 3 interpretations by the program:
+      /// 1. 0 (by default) - no variation
+      /// 2. negative - cuts are tightened
+      /// 2. positive - cuts are loosened
+      int cutsVar = 0;
+      /// acceptance variation values
+      AcceptanceVar accVar;
+      /// name of the output file (without extension) or of the output 
+      /// directory if all variations are written in one file
+      std::string name;
+      /// histograms of the variation
+      std::unique_ptr<ThrContainer> thrContainer;
+   };
+   /// variations that are processed in the same event loop
+   std::vector<Variation> variations;
+   /// @brief indexes of the variations with the same pT scale; tracks and pair kinematics 
+   /// are evaluated once for each group and only the weights differ between its variations
+   std::vector<std::vector<unsigned long>> pTScaleGroups;
+   /* @struct CandidateTracks
+    * @brief Charged tracks of the event that passed the cuts that do not depend on deadmaps;
+    * quantities are kept in columns so that DC and PC1 deadmaps of all tracks of the event 
+    * are looked up in one batch
+    */
+   struct CandidateTracks
+   {
+      /// removes all tracks (memory is kept for the next event)
+      void Clear();
+      /// index of a track in the current event
+      std::vector<int> index;
+      /// dcarm of a track
+      std::vector<int> dcarm;
+      /// zed of a track
+      std::vector<double> zed;
+      /// DC board of a track
+      std::vector<double> board;
+      /// alpha of a track
+      std::vector<double> alpha;
+      /// ppc1z of a track
+      std::vector<double> ppc1z;
+      /// phi of a track in PC1
+      std::vector<double> ppc1phi;
+      /// masks of the deadmaps (see DeadMapCutter::DeadBit)
+      std::vector<unsigned int> deadMasks;
+   };
+   /* @struct TrackDeadmaps
+    * @brief Results of the deadmap lookups of the charged track that do not depend on pT scale; 
+    * deadmaps are only looked up for the detectors in which the track has a hit
+    */
+   struct TrackDeadmaps
+   {
+      /// index of a track in the current event
+      int index;
+      /// pT of a track without pT scale [GeV/c]
+      double pT;
+      /// shows whether the track hit the dead area of PC2
+      bool isDeadPC2 = true;
+      /// shows whether the track hit the dead area of PC3
+      bool isDeadPC3 = true;
+      /// shows whether the track hit the dead area of EMCal
+      bool isDeadEMCal = true;
+      /// shows whether the track hit the area of EMCal with bad timing
+      bool isDeadTimingEMCal = true;
+      /// shows whether the track hit the dead area of TOFe
+      bool isDeadTOFe = true;
+      /// shows whether the track hit the area of TOFe with bad timing
+      bool isDeadTimingTOFe = true;
+      /// shows whether the track hit the dead area of TOFw
+      bool isDeadTOFw = true;
+      /// shows whether the track hit the area of TOFw with bad timing
+      bool isDeadTimingTOFw = true;
+   };
+   /* @struct TrackState
+    * @brief Detector matches and identification probabilities of the charged track 
+    * for the given pT scale; the weights of the track are evaluated from it for each variation
+    */
+   struct TrackState
+   {
+      /// charge of a track
+      int charge;
+      /// DC arm of a track
+      int dcarm;
+      /// EMCal sector of a track
+      int sector;
+      /// shows whether the track is matched in PC2 outside of the deadmap
+      bool isPC2 = false;
+      /// shows whether the track is matched in PC3 outside of the deadmap
+      bool isPC3 = false;
+      /// shows whether the track is matched in EMCal outside of the deadmap
+      bool isEMCal = false;
+      /// shows whether the track is matched in TOFe outside of the deadmap
+      bool isTOFe = false;
+      /// shows whether the track is matched in TOFw outside of the deadmap
+      bool isTOFw = false;
+      /// shows whether the track can be identified in EMCal
+      bool isIdEMCal = false;
+      /// shows whether the track can be identified in TOFe
+      bool isIdTOFe = false;
+      /// shows whether the track can be identified in TOFw
+      bool isIdTOFw = false;
+      /// probability of a particle being identified in EMCal when it is registered there
+      double probIdEMCal = 0.;
+      /// probability of a particle being identified in TOFe when it is registered there
+      double probIdTOFe = 0.;
+      /// probability of a particle being identified in TOFw when it is registered there
+      double probIdTOFw = 0.;
+   };
+   /* @struct PairCuts
+    * @brief Pair cuts of the pair of tracks that do not depend on the weights
+    */
+   struct PairCuts
+   {
+      /// shows whether the pair is cut by ghost cut
+      bool isGhostCut;
+      /// shows whether the pair is cut by one arm cut
+      bool isOneArmCut;
+      /// mask of detectors (DETECTOR_BIT) for which the pair does not pass pair ghost cut
+      unsigned int ghostMask;
+   };
+   /* @struct Configuration
+    * @brief Parameters of the single configuration (for the given particle, 
+    * magnetic field, and pT range) that are needed to process the events from its file
+    */
+   struct Configuration
+   {
+      /// name of the file with the simulated tree
+      std::string simInputFileName;
+      /// id of the first daughter particle
+      int daughter1Id;
+      /// id of the second daughter particle
+      int daughter2Id;
+      /// normalization of the number of particles to the number of events
+      double eventNormWeight;
+      /// weight function for spectra
+      std::unique_ptr<TF1> weightFunc;
+      /// shows whether the sidecar index of the file exists
+      bool isIndexed = false;
+      /// entries that pass the event level cuts (only filled if the sidecar index exists)
+      std::vector<unsigned long> selectedEntries;
+      /// index of the decay mode of the configuration in mixedDecayModes
+      unsigned long decayModeIndex = 0;
+      /// index of the configuration that is used as the set of events of eventPools 
+      /// so that only the events of the same configuration are mixed
+      unsigned long index = 0;
+   };
+   /* @brief Sets the parameters of the single configuration (for the given particle, 
+    * magnetic field, and pT range); events that are rejected by the sidecar index 
+    * of the file are written in ThrContainer of every variation
+    *
+    * @param[out] configuration parameters of the configuration
+    * @param[in] particleName name of the particle to be analyzed 
+    * @param[in] pTRangeName name of the pT range to be analyzed 
+    */
+   void SetConfiguration(Configuration& configuration, const std::string& particleName, 
+                         const int daughter1Id, const int daugther2Id,
+                         const std::string& magneticFieldName, const std::string& pTRangeName);
+   /* @brief Processes the events of one task from the file of the configuration 
+    * for all variations
+    *
+    * @param[in] simCNT reader that iterates over the events of the task
+    * @param[in] configuration parameters of the configuration the file of which is processed
+    */
+   void ProcessTask(SimTreeReader& simCNT, const Configuration& configuration);
+   /* @brief Sets the weights and ids of the track for the given acceptance variation
+    *
+    * @param[out] track track which weights and ids are set
+    * @param[in] state detector matches and identification probabilities of the track
+    * @param[in] accVar acceptance variation values
+    * @param[in] id id of the particle the track is identified as
+    */
+   void SetTrackWeights(ChargedTrack& track, const TrackState& state, 
+                        const AcceptanceVar& accVar, const int id);
+   /* @brief Fills pair histograms of one variation for all pairs of the event
+    *
+    * @param[in] histContainer container of the histograms of the variation
+    * @param[in] positiveTracks positive tracks with the weights of the variation
+    * @param[in] negativeTracks negative tracks with the weights of the variation
+    * @param[in] pairsMInv invariant masses of the pairs in the order 
+    * positive track (outer), negative track (inner)
+    * @param[in] pairsPT pT of the pairs in the same order
+    * @param[in] pairsCuts cuts of the pairs in the same order
+    * @param[in] origPT original pT of the resonance
+    * @param[in] eventWeight weight of the event
+    * @param[in] configuration parameters of the configuration the file of which is processed
+    */
+   void FillPairs(HistContainer& histContainer, const std::vector<ChargedTrack>& positiveTracks,
+                  const std::vector<ChargedTrack>& negativeTracks, 
+                  const std::vector<double>& pairsMInv, const std::vector<double>& pairsPT,
+                  const std::vector<PairCuts>& pairsCuts, 
+                  const double origPT, const double eventWeight, 
+                  const Configuration& configuration);
+   /* @brief Evaluates the pair selection methods the pair of tracks passes and its weights
+    *
+    * @param[out] selection methods the pair passes and the weights of the pair for them
+    * @param[in] posTrack positive track of the pair
+    * @param[in] negTrack negative track of the pair
+    * @param[in] masks masks of the pair for the ids of the daughters
+    * @param[in] kaonMasks masks of the pair for the ids of kaons
+    */
+   void SelectPair(PairSelection& selection, const ChargedTrack& posTrack, 
+                   const ChargedTrack& negTrack, const PairMasks& masks, 
+                   const PairMasks& kaonMasks);
+   /* @brief Fills the same event (FG) histograms of the pool bin of the event with the pairs of the event and the mixed event (BG) histograms with the pairs of the tracks of the event and of the events in the pool; then the event is added to the pool
+    *
+    * @param[in] mixedHistContainer container of the FG and BG histograms of the thread
+    * @param[in] pool pool of the events of the same configuration and bin as the event
+    * @param[in] poolBin bin of the pool
+    * @param[in] positiveTracks positive tracks of the event with the weights of the default variation
+    * @param[in] negativeTracks negative tracks of the event with the weights of the default variation
+    * @param[in] negativeTracksBlock negative tracks of the event in the same order
+    * @param[in] pairsMInv invariant masses of the pairs of the event (see FillPairs)
+    * @param[in] pairsPT pT of the pairs of the event in the same order
+    * @param[in] pairsCuts cuts of the pairs of the event in the same order
+    * @param[in] mixedPairsMInv buffer for invariant masses of the mixed pairs (reused between events)
+    * @param[in] mixedPairsPT buffer for pT of the mixed pairs (reused between events)
+    * @param[in] eventWeight weight of the event
+    * @param[in] configuration parameters of the configuration the file of which is processed
+    */
+   void MixEvent(MixedHistContainer& mixedHistContainer, EventPool& pool, const int poolBin,
+                 const std::vector<ChargedTrack>& positiveTracks,
+                 const std::vector<ChargedTrack>& negativeTracks, 
+                 const TrackBlock& negativeTracksBlock,
+                 const std::vector<double>& pairsMInv, const std::vector<double>& pairsPT,
+                 const std::vector<PairCuts>& pairsCuts, 
+                 std::vector<double>& mixedPairsMInv, std::vector<double>& mixedPairsPT,
+                 const double eventWeight, const Configuration& configuration);
+   /* @brief Fills FG or BG histograms of the pool bin with the pair of tracks
+    *
+    * @param[in] mixedHistContainer container of the FG and BG histograms of the thread
+    * @param[in] isMixed true if the tracks are from different events (BG)
+    * @param[in] poolBin bin of the pool
+    * @param[in] posTrack positive track of the pair
+    * @param[in] negTrack negative track of the pair
+    * @param[in] mInv invariant mass of the pair [GeV/c^2]
+    * @param[in] pT pT of the pair [GeV/c]
+    * @param[in] ghostMask mask of detectors for which the pair does not pass pair ghost cut
+    * @param[in] weight weight of the pair
+    * @param[in] configuration parameters of the configuration the file of which is processed
+    */
+   void FillMixedHists(MixedHistContainer& mixedHistContainer, const bool isMixed, 
+                       const int poolBin, const ChargedTrack& posTrack, 
+                       const ChargedTrack& negTrack, const double mInv, const double pT, 
+                       const unsigned int ghostMask, const double weight, 
+                       const Configuration& configuration);
 }
 
 #endif /* ANALYZE_SIM_RESONANCE_HPP */
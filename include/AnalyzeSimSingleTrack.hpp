@@ -10,6 +10,7 @@
 #define ANALYZE_SIM_SINGLE_TRACK_HPP
 
 #include <thread>
+#include <algorithm>
 
 #include "TF1.h"
 #include "TH1.h"
@@ -17,7 +18,6 @@
 #include "TH3.h"
 #include "TFile.h"
 
-#include "ROOT/TThreadedObject.hxx"
 #include "ROOT/TTreeProcessorMT.hxx"
 
 #include "InputYAMLReader.hpp"
@@ -30,6 +30,10 @@
 #include "SingleTrackFunc.hpp"
 #include "PairTrackFunc.hpp"
 #include "SimTreeReader.hpp"
+#include "SimTreeIndex.hpp"
+#include "SimTrackCache.hpp"
+#include "FlatHist.hpp"
+#include "ProgressMonitor.hpp"
 #include "DeadMapCutter.hpp"
 #include "SimSigmalizedResiduals.hpp"
 #include "SimM2Identificator.hpp"
@@ -94,6 +98,29 @@ namespace AnalyzeSimSingleTrack
    TH2F *reweightPC1wPos;
    /// histogram with scaling for PC1w, charge<0 that is used when doReweightPC1 is true
    TH2F *reweightPC1wNeg;
+   /// lookup table of alphaReweightDCe0 that is used in the event loop
+   FlatHistTable alphaReweightDCe0Table;
+   /// lookup table of alphaReweightDCe1 that is used in the event loop
+   FlatHistTable alphaReweightDCe1Table;
+   /// lookup table of alphaReweightDCw0 that is used in the event loop
+   FlatHistTable alphaReweightDCw0Table;
+   /// lookup table of alphaReweightDCw1 that is used in the event loop
+   FlatHistTable alphaReweightDCw1Table;
+   /// lookup table of reweightPC1ePos that is used in the event loop
+   FlatHistTable reweightPC1ePosTable;
+   /// lookup table of reweightPC1eNeg that is used in the event loop
+   FlatHistTable reweightPC1eNegTable;
+   /// lookup table of reweightPC1wPos that is used in the event loop
+   FlatHistTable reweightPC1wPosTable;
+   /// lookup table of reweightPC1wNeg that is used in the event loop
+   FlatHistTable reweightPC1wNegTable;
+   /// @brief shows whether alpha and PC1 reweights are derived in the same run: simulated trees 
+   /// are read once in the pass for alpha reweight with the track cache written, then PC1 
+   /// reweight and the final histograms are produced in 2 more passes that replay the cache
+   bool cachedReweight = false;
+   /// shows whether the current pass only produces PC1 heatmaps for PC1 reweight
+   /// (the histograms of other detectors are not filled in this pass)
+   bool isPC1ReweightPass = false;
    /// simple reweight to adjust PC1 distributions only areas on average for 
    /// different arms (0, 1), charges (positive, negative), and z_{PC1} (positive, negative)
    /// this reweight is needed for PC1 heatmap reweight only due to the need to
@@ -102,8 +129,37 @@ namespace AnalyzeSimSingleTrack
    std::array<double, 8> reweightPC1Simple;
    /// number of events across all trees
    unsigned long numberOfEvents = 0;
-   /// parameter for monitoring the progress
-   unsigned long numberOfCalls = 0;
+   /// counters of processed events, tracks, and read bytes for monitoring the progress
+   ProgressMonitor progress;
+   /// names of all simulated trees that will be analyzed in the order they are processed
+   std::vector<std::string> simInputFileNames;
+   /// size of TTreeCache as a factor of the cluster size of simulated trees
+   double treeCacheSizeFactor;
+   /// number of entries TTreeCache learns which branches are read
+   int treeCacheLearnEntries;
+   /// shows whether the baskets of simulated trees are prefetched asynchronously
+   bool asyncPrefetching;
+   /// shows whether the next file in the queue is prefetched while the current one is processed
+   bool prefetchNextFile;
+   /// compression level of the output files
+   int outputCompressionLevel;
+   /// @brief mode of the track cache: "none", "write" (tracks read from the simulated trees 
+   /// are also written in the cache), or "replay" (tracks are read from the cache instead 
+   /// of simulated trees; this is useful when only cuts or weights are changed)
+   std::string trackCacheMode = "none";
+   /// @brief hash of the dead maps, calibrations, and DC board offsets from which 
+   /// the derived quantities of the cached tracks are evaluated
+   unsigned long trackCacheInputsHash;
+   /// branches of simulated trees that are read (other branches are never activated)
+   const std::vector<std::string> simTreeBranches = 
+   {
+      "mom_orig", "nch", "bbcz", "dcarm", "phi", "alpha", "zed", "mom", "the0", "phi0",
+      "nx1hits", "nx2hits", "qual", "charge", "primary_id", "particle_id", "ttof", "ttofw",
+      "temc", "pltof", "pltofw", "plemc", "ppc1x", "ppc1y", "ppc1z", "ppc2x", "ppc2y",
+      "ppc2z", "ppc3x", "ppc3y", "ppc3z", "tofdz", "tofdphi", "tofwdz", "tofwdphi", "emcdz",
+      "emcdphi", "pc2dz", "pc2dphi", "pc3dz", "pc3dphi", "striptofw", "slat", "etof", "ecore",
+      "prob", "sect", "ysect", "zsect"
+   };
    /// cutter for deadmaps
    DeadMapCutter dmCutter;
    /// cutter for additional MC deadmaps
@@ -112,6 +168,18 @@ namespace AnalyzeSimSingleTrack
    SimSigmalizedResiduals simSigmRes;
    /// identificator for m2 hadron identification procedure in MC
    SimM2Identificator simM2Id;
+   /// detectors_configuration from main.yaml
+   std::string detectorsConfiguration;
+   /// shows whether PC2 is used
+   bool usePC2;
+   /// shows whether PC3 is used
+   bool usePC3;
+   /// shows whether TOFe is used
+   bool useTOFe;
+   /// shows whether TOFw is used
+   bool useTOFw;
+   /// shows whether EMCal is used
+   bool useEMCal;
    /* @brief Returns the histogram from the specified file
     * @param[in] file file from which the histogram will be read
     * @param[in] histName name of the histogram which will be read
@@ -141,975 +209,847 @@ namespace AnalyzeSimSingleTrack
     * @param[out] hist read histogram
     */
    bool CheckHistsAxis(const TH2F *hist1, const TH2F *hist2);
-   /* @struct ThrContainerCopy
-    * @brief Container for storing local ThrContainer copies (at least 1 for each thread) 
-    * since copying speeds up the calculation because local copies 
-    * do not require synchronization from each other
+   /* @struct HistContainer
+    * @brief Container of the histograms that are filled by one thread
     *
-    * Contains the same histograms ThrContainer but as shared_ptr<T>
-    */
-   struct ThrContainerCopy
-   {
-      /// distribution of original generated pT
-      std::shared_ptr<TH1D> distrOrigPT;
-      /// reconstructed pT distribution of registered tracks passed DC-PC1 cuts
-      std::shared_ptr<TH1D> distrRecPT;
-      /// reconstructed pT distribution of registered tracks passed DC-PC1 cuts scale additional reweight
-      std::shared_ptr<TH1D> distrRecPTNoScaleReweight;
-      /// distribution of original generated pT vs reconstructed pT in the simulation
-      std::shared_ptr<TH2D> distrOrigPTVsRecPT;
-      /// unscaled by alpha heatmap of DCe, zDC>=0
-      std::shared_ptr<TH2F> heatmapUnscaledDCe0;
-      /// unscaled by alpha heatmap of DCe, zDC<0
-      std::shared_ptr<TH2F> heatmapUnscaledDCe1;
-      /// unscaled by alpha heatmap of DCw, zDC>=0
-      std::shared_ptr<TH2F> heatmapUnscaledDCw0;
-      /// unscaled by alpha heatmap of DCw, zDC<0
-      std::shared_ptr<TH2F> heatmapUnscaledDCw1;
-      /// heatmap of DCe, zDC>=0
-      std::shared_ptr<TH2F> heatmapDCe0;
-      /// heatmap of DCe, zDC<0
-      std::shared_ptr<TH2F> heatmapDCe1;
-      /// heatmap of DCw, zDC>=0
-      std::shared_ptr<TH2F> heatmapDCw0;
-      /// heatmap of DCw, zDC<0
-      std::shared_ptr<TH2F> heatmapDCw1;
-      /// heatmap of DCe X1, zDC>=0
-      std::shared_ptr<TH2F> heatmapDCe0X1;
-      /// heatmap of DCe X1, zDC<0
-      std::shared_ptr<TH2F> heatmapDCe1X1;
-      /// heatmap of DCw X1, zDC>=0
-      std::shared_ptr<TH2F> heatmapDCw0X1;
-      /// heatmap of DCw X1, zDC<0
-      std::shared_ptr<TH2F> heatmapDCw1X1;
-      /// heatmap of DCe X2, zDC>=0
-      std::shared_ptr<TH2F> heatmapDCe0X2;
-      /// heatmap of DCe X2, zDC<0
-      std::shared_ptr<TH2F> heatmapDCe1X2;
-      /// heatmap of DCw X2, zDC>=0
-      std::shared_ptr<TH2F> heatmapDCw0X2;
-      /// heatmap of DCw X2, zDC<0
-      std::shared_ptr<TH2F> heatmapDCw1X2;
-      /// heatmap of PC1e
-      std::shared_ptr<TH2F> heatmapPC1e;
-      /// heatmap of PC1w
-      std::shared_ptr<TH2F> heatmapPC1w;
-      /// heatmap of PC1e for positive tracks
-      std::shared_ptr<TH2F> heatmapPC1ePos;
-      /// heatmap of PC1e for negative tracks
-      std::shared_ptr<TH2F> heatmapPC1eNeg;
-      /// heatmap of PC1w for positive tracks
-      std::shared_ptr<TH2F> heatmapPC1wPos;
-      /// heatmap of PC1w for negative tracks
-      std::shared_ptr<TH2F> heatmapPC1wNeg;
-      /// heatmap of PC2
-      std::shared_ptr<TH2F> heatmapPC2;
-      /// heatmap of PC3e
-      std::shared_ptr<TH2F> heatmapPC3e;
-      /// heatmap of PC3w
-      std::shared_ptr<TH2F> heatmapPC3w;
-      /// heatmap of TOFe
-      std::shared_ptr<TH2F> heatmapTOFe;
-      /// heatmap of TOFe hits
-      std::shared_ptr<TH2F> heatmapTOFeHit;
-      /// heatmap of TOFw
-      std::shared_ptr<TH2F> heatmapTOFw;
-      /// heatmaps of EMCale(0-3)
-      std::array<std::shared_ptr<TH2F>, 4> heatmapEMCale;
-      /// heatmaps of EMCalw(0-3)
-      std::array<std::shared_ptr<TH2F>, 4> heatmapEMCalw;
-      /// heatmaps of EMCale(0-3) hits
-      std::array<std::shared_ptr<TH2F>, 4> heatmapEMCaleHit;
-      /// heatmaps of EMCalw(0-3) hits
-      std::array<std::shared_ptr<TH2F>, 4> heatmapEMCalwHit;
-      /// prob in EMCale(0-3) vs pT distributions
-      std::array<std::shared_ptr<TH2F>, 4> distrProbVsPTEMCale;
-      /// prob in EMCalw(0-3) vs pT distributions
-      std::array<std::shared_ptr<TH2F>, 4> distrProbVsPTEMCalw;
-      /// ecore in EMCale(0-3) vs pT distributions
-      std::array<std::shared_ptr<TH2F>, 4> distrECoreVsPTEMCale;
-      /// ecore in EMCalw(0-3) vs pT distributions
-      std::array<std::shared_ptr<TH2F>, 4> distrECoreVsPTEMCalw;
-      /// ecore in EMCale(0-3) vs pT distributions for original particles only
-      std::array<std::shared_ptr<TH2F>, 4> distrECoreVsPTEMCaleOrig;
-      /// ecore in EMCalw(0-3) vs pT distributions for original particles only
-      std::array<std::shared_ptr<TH2F>, 4> distrECoreVsPTEMCalwOrig;
-      /// reconstructed pT distribution of tracks regisetered and passed all cuts in PC2
-      std::shared_ptr<TH1D> distrRecPTPC2;
-      /// reconstructed pT distribution of tracks regisetered and passed all cuts in PC3
-      std::shared_ptr<TH1D> distrRecPTPC3;
-      /// reconstructed pT distribution of tracks regisetered and passed all cuts in EMCale
-      std::array<std::shared_ptr<TH1D>, 4> distrRecPTEMCale;
-      /// reconstructed pT distribution of tracks regisetered and passed all cuts in EMCalw
-      std::array<std::shared_ptr<TH1D>, 4> distrRecPTEMCalw;
-      /// reconstructed pT distribution of tracks regisetered and passed all cuts in TOFe
-      std::shared_ptr<TH1D> distrRecPTTOFe;
-      /// reconstructed pT distribution of tracks regisetered and passed all cuts in TOFw
-      std::shared_ptr<TH1D> distrRecPTTOFw;
-      /// reconstructed pT distribution of tracks identified in EMCale
-      std::array<std::shared_ptr<TH1D>, 2> distrRecIdPTEMCale;
-      /// reconstructed pT distribution of tracks identified in EMCalw
-      std::array<std::shared_ptr<TH1D>, 4> distrRecIdPTEMCalw;
-      /// reconstructed pT distribution of tracks identified in TOFe
-      std::shared_ptr<TH1D> distrRecIdPTTOFe;
-      /// reconstructed pT distribution of tracks identified in TOFw
-      std::shared_ptr<TH1D> distrRecIdPTTOFw;
-      /// eloss vs beta distribution in TOFe
-      std::shared_ptr<TH2F> distrBetaVsETOFe;
-      /// pc2dphi vs pT distribution for positive tracks
-      std::shared_ptr<TH2F> distrDPhiVsPTPC2Pos;
-      /// pc2dz vs pT distribution for positive tracks
-      std::shared_ptr<TH2F> distrDZVsPTPC2Pos;
-      /// pc2dphi vs pT distribution for negative tracks
-      std::shared_ptr<TH2F> distrDPhiVsPTPC2Neg;
-      /// pc2dz vs pT distribution for negative tracks
-      std::shared_ptr<TH2F> distrDZVsPTPC2Neg;
-      /// pc3dphi vs pT distribution for positive tracks for east arm
-      std::shared_ptr<TH2F> distrDPhiVsPTPC3ePos;
-      /// pc3dz vs pT distribution for positive tracks for east arm
-      std::shared_ptr<TH2F> distrDZVsPTPC3ePos;
-      /// pc3dphi vs pT distribution for negative tracks for east arm
-      std::shared_ptr<TH2F> distrDPhiVsPTPC3eNeg;
-      /// pc3dz vs pT distribution for negative tracks for east arm
-      std::shared_ptr<TH2F> distrDZVsPTPC3eNeg;
-      /// pc3dphi vs pT distribution for positive tracks for west arm
-      std::shared_ptr<TH2F> distrDPhiVsPTPC3wPos;
-      /// pc3dz vs pT distribution for positive tracks for west arm
-      std::shared_ptr<TH2F> distrDZVsPTPC3wPos;
-      /// pc3dphi vs pT distribution for negative tracks for west arm
-      std::shared_ptr<TH2F> distrDPhiVsPTPC3wNeg;
-      /// pc3dz vs pT distribution for negative tracks for west arm
-      std::shared_ptr<TH2F> distrDZVsPTPC3wNeg;
-      /// tofdphi vs pT distribution for positive tracks
-      std::shared_ptr<TH2F> distrDPhiVsPTTOFePos;
-      /// tofdz vs pT distribution for positive tracks
-      std::shared_ptr<TH2F> distrDZVsPTTOFePos;
-      /// tofdphi vs pT distribution for negative tracks
-      std::shared_ptr<TH2F> distrDPhiVsPTTOFeNeg;
-      /// tofdz vs pT distribution for negative tracks
-      std::shared_ptr<TH2F> distrDZVsPTTOFeNeg;
-      /// tofwdphi vs pT distribution for positive tracks
-      std::shared_ptr<TH2F> distrDPhiVsPTTOFwPos;
-      /// tofwdz vs pT distribution for positive tracks
-      std::shared_ptr<TH2F> distrDZVsPTTOFwPos;
-      /// tofwdphi vs pT distribution for negative tracks
-      std::shared_ptr<TH2F> distrDPhiVsPTTOFwNeg;
-      /// tofwdz vs pT distribution for negative tracks
-      std::shared_ptr<TH2F> distrDZVsPTTOFwNeg;
-      /// emcdphi vs pT distributions for (0-3) sectors in east arm for positive tracks
-      std::array<std::shared_ptr<TH2F>, 4> distrDPhiVsPTEMCalePos;
-      /// emcdz vs pT distributions for (0-3) sectors in east arm for positive tracks
-      std::array<std::shared_ptr<TH2F>, 4> distrDZVsPTEMCalePos;
-      /// emcdphi vs pT distributions for (0-3) sectors in east arm for negative tracks
-      std::array<std::shared_ptr<TH2F>, 4> distrDPhiVsPTEMCaleNeg;
-      /// emcdz vs pT distributions for (0-3) sectors in east arm for negative tracks
-      std::array<std::shared_ptr<TH2F>, 4> distrDZVsPTEMCaleNeg;
-      /// emcdphi vs pT distributions for (0-3) sectors in west arm for positive tracks
-      std::array<std::shared_ptr<TH2F>, 4> distrDPhiVsPTEMCalwPos;
-      /// emcdz vs pT distributions for (0-3) sectors in west arm for positive tracks
-      std::array<std::shared_ptr<TH2F>, 4> distrDZVsPTEMCalwPos;
-      /// emcdphi vs pT distributions for (0-3) sectors in west arm for negative tracks
-      std::array<std::shared_ptr<TH2F>, 4> distrDPhiVsPTEMCalwNeg;
-      /// emcdz vs pT distributions for (0-3) sectors in west arm for negative tracks
-      std::array<std::shared_ptr<TH2F>, 4> distrDZVsPTEMCalwNeg;
-      /// pc2dphi vs pT distribution for positive tracks
-      std::shared_ptr<TH2F> distrSDPhiVsPTPC2Pos;
-      /// pc2dz vs pT distribution for positive tracks
-      std::shared_ptr<TH2F> distrSDZVsPTPC2Pos;
-      /// pc2dphi vs pT distribution for negative tracks
-      std::shared_ptr<TH2F> distrSDPhiVsPTPC2Neg;
-      /// pc2dz vs pT distribution for negative tracks
-      std::shared_ptr<TH2F> distrSDZVsPTPC2Neg;
-      /// pc3dphi vs pT distribution for positive tracks for east arm
-      std::shared_ptr<TH2F> distrSDPhiVsPTPC3ePos;
-      /// pc3dz vs pT distribution for positive tracks for east arm
-      std::shared_ptr<TH2F> distrSDZVsPTPC3ePos;
-      /// pc3dphi vs pT distribution for negative tracks for east arm
-      std::shared_ptr<TH2F> distrSDPhiVsPTPC3eNeg;
-      /// pc3dz vs pT distribution for negative tracks for east arm
-      std::shared_ptr<TH2F> distrSDZVsPTPC3eNeg;
-      /// pc3dphi vs pT distribution for positive tracks for west arm
-      std::shared_ptr<TH2F> distrSDPhiVsPTPC3wPos;
-      /// pc3dz vs pT distribution for positive tracks for west arm
-      std::shared_ptr<TH2F> distrSDZVsPTPC3wPos;
-      /// pc3dphi vs pT distribution for negative tracks for west arm
-      std::shared_ptr<TH2F> distrSDPhiVsPTPC3wNeg;
-      /// pc3dz vs pT distribution for negative tracks for west arm
-      std::shared_ptr<TH2F> distrSDZVsPTPC3wNeg;
-      /// tofdphi vs pT distribution for positive tracks
-      std::shared_ptr<TH2F> distrSDPhiVsPTTOFePos;
-      /// tofdz vs pT distribution for positive tracks
-      std::shared_ptr<TH2F> distrSDZVsPTTOFePos;
-      /// tofdphi vs pT distribution for negative tracks
-      std::shared_ptr<TH2F> distrSDPhiVsPTTOFeNeg;
-      /// tofdz vs pT distribution for negative tracks
-      std::shared_ptr<TH2F> distrSDZVsPTTOFeNeg;
-      /// tofwdphi vs pT distribution for positive tracks
-      std::shared_ptr<TH2F> distrSDPhiVsPTTOFwPos;
-      /// tofwdz vs pT distribution for positive tracks
-      std::shared_ptr<TH2F> distrSDZVsPTTOFwPos;
-      /// tofwdphi vs pT distribution for negative tracks
-      std::shared_ptr<TH2F> distrSDPhiVsPTTOFwNeg;
-      /// tofwdz vs pT distribution for negative tracks
-      std::shared_ptr<TH2F> distrSDZVsPTTOFwNeg;
-      /// emcdphi vs pT distributions for (0-3) sectors in east arm for positive tracks
-      std::array<std::shared_ptr<TH2F>, 4> distrSDPhiVsPTEMCalePos;
-      /// emcdz vs pT distributions for (0-3) sectors in east arm for positive tracks
-      std::array<std::shared_ptr<TH2F>, 4> distrSDZVsPTEMCalePos;
-      /// emcdphi vs pT distributions for (0-3) sectors in east arm for negative tracks
-      std::array<std::shared_ptr<TH2F>, 4> distrSDPhiVsPTEMCaleNeg;
-      /// emcdz vs pT distributions for (0-3) sectors in east arm for negative tracks
-      std::array<std::shared_ptr<TH2F>, 4> distrSDZVsPTEMCaleNeg;
-      /// emcdphi vs pT distributions for (0-3) sectors in west arm for positive tracks
-      std::array<std::shared_ptr<TH2F>, 4> distrSDPhiVsPTEMCalwPos;
-      /// emcdz vs pT distributions for (0-3) sectors in west arm for positive tracks
-      std::array<std::shared_ptr<TH2F>, 4> distrSDZVsPTEMCalwPos;
-      /// emcdphi vs pT distributions for (0-3) sectors in west arm for negative tracks
-      std::array<std::shared_ptr<TH2F>, 4> distrSDPhiVsPTEMCalwNeg;
-      /// emcdz vs pT distributions for (0-3) sectors in west arm for negative tracks
-      std::array<std::shared_ptr<TH2F>, 4> distrSDZVsPTEMCalwNeg;
-      /// TOFe t-t_{exp}^{pi} distribution
-      std::shared_ptr<TH2F> distrTTOFe;
-      /// TOFw t-t_{exp}^{pi} distribution
-      std::shared_ptr<TH2F> distrTTOFw;
-      /// EMCale(0-3) t-t_{exp}^{pi} distributions
-      std::array<std::shared_ptr<TH2F>, 4> distrTEMCale;
-      /// EMCalw(0-3) t-t_{exp}^{pi} distributions
-      std::array<std::shared_ptr<TH2F>, 4> distrTEMCalw;
-      /// TOFe m2 distribution for positive tracks
-      std::shared_ptr<TH2F> distrM2TOFePosCharge;
-      /// TOFe m2 distribution for negative tracks
-      std::shared_ptr<TH2F> distrM2TOFeNegCharge;
-      /// TOFw m2 distribution for positive tracks
-      std::shared_ptr<TH2F> distrM2TOFwPosCharge;
-      /// TOFw m2 distribution for negative tracks
-      std::shared_ptr<TH2F> distrM2TOFwNegCharge;
-      /// EMCale(0-3) m2 distributions for positive tracks
-      std::array<std::shared_ptr<TH2F>, 4> distrM2EMCalePosCharge;
-      /// EMCale(0-3) m2 distributions for negative tracks
-      std::array<std::shared_ptr<TH2F>, 4> distrM2EMCaleNegCharge;
-      /// EMCalw(0-3) m2 distributions for positive tracks
-      std::array<std::shared_ptr<TH2F>, 4> distrM2EMCalwPosCharge;
-      /// EMCalw(0-3) m2 distributions for negative tracks
-      std::array<std::shared_ptr<TH2F>, 4> distrM2EMCalwNegCharge;
-      /// NoPID invariant mass distribution
-      std::shared_ptr<TH2F> distrMInvNoPID;
-      /// NoPID invariant mass distribution without ghost cuts on detectors
-      std::shared_ptr<TH2F> distrMInvNoPIDNoGhost;
-   };
-   /* @struct ThrContainer
-    * @brief Container for storing ROOT::TThreadedObject variables 
-    * (histograms for multithreading with TTreeProcessorMT)
+    * Histograms are declared only here; ThrContainer constructs one HistContainer for each thread from this declaration. Histograms of the detectors that are disabled in detectors_configuration are never allocated and are written empty
     */
-   struct ThrContainer
+   struct HistContainer
    {
-      /// @brief returns ThrContainerCopy with std::shared_ptr 
-      /// copies of ROOT::TThreadedObject histograms
-      ThrContainerCopy GetCopy();
-      /// @brief writes the merged histograms across all threads into the file with a specified name
-      void Write(const std::string& outputFileName);
+      /*! @brief Constructor
+       * @param[in] detectorsConfiguration detectors_configuration from main.yaml
+       */
+      HistContainer(const std::string& detectorsConfiguration);
+      /// registry of the histograms (must be declared before the histograms)
+      HistRegistry registry;
       /// distribution of original generated pT
-      ROOT::TThreadedObject<TH1D> distrOrigPT{"orig pT", "p_{T}", 100., 0., 10.};
+      FlatHist<TH1D> distrOrigPT{registry, HistRegistry::ANY, "", "orig pT", "p_{T}", 100., 0.,
+                                 10.};
       /// reconstructed pT distribution of registered tracks passed DC-PC1 cuts
-      ROOT::TThreadedObject<TH1D> distrRecPT{"rec pT: DC-PC1", "p_{T}", 100., 0., 10.};
+      FlatHist<TH1D> distrRecPT{registry, HistRegistry::ANY, "", "rec pT: DC-PC1", "p_{T}", 100.,
+                                0., 10.};
       /// reconstructed pT distribution of registered tracks passed DC-PC1 cuts without scale reweight
-      ROOT::TThreadedObject<TH1D> distrRecPTNoScaleReweight{"rec pT: DC-PC1, no scale reweight", 
-                                                            "p_{T}", 100., 0., 10.};
+      FlatHist<TH1D> distrRecPTNoScaleReweight{registry, HistRegistry::ANY, "",
+                                               "rec pT: DC-PC1, no scale reweight", "p_{T}", 100.,
+                                               0., 10.};
       // distribution of original generated pT vs pT of reconstructed tracks in the simulation
-      ROOT::TThreadedObject<TH2D> 
-         distrOrigPTVsRecPT{"orig pT vs rec pT", "p_{T}^{orig} vs p_{T}^{rec}", 
-                            100, 0., 10., 100, 0., 10.};
+      FlatHist<TH2D> distrOrigPTVsRecPT{registry, HistRegistry::ANY, "", "orig pT vs rec pT",
+                                        "p_{T}^{orig} vs p_{T}^{rec}", 100, 0., 10., 100, 0., 10.};
       /// unscaled by alpha heatmap of DCe, zDC>=0
-      ROOT::TThreadedObject<TH2F> 
-         heatmapUnscaledDCe0{"Unscaled heatmap: DCe, zDC>=0", "board vs alpha", 
-                             810, 0., 80., 195, -0.39, 0.39};
+      FlatHist<TH2F> heatmapUnscaledDCe0{registry, HistRegistry::ANY, "",
+                                         "Unscaled heatmap: DCe, zDC>=0", "board vs alpha", 810, 0.,
+                                         80., 195, -0.39, 0.39};
       /// unscaled by alpha heatmap of DCe, zDC<0
-      ROOT::TThreadedObject<TH2F> 
-         heatmapUnscaledDCe1{"Unscaled heatmap: DCe, zDC<0", "board vs alpha", 
-                             810, 0., 80., 195, -0.39, 0.39};
+      FlatHist<TH2F> heatmapUnscaledDCe1{registry, HistRegistry::ANY, "",
+                                         "Unscaled heatmap: DCe, zDC<0", "board vs alpha", 810, 0.,
+                                         80., 195, -0.39, 0.39};
       /// unscaled by alpha heatmap of DCw, zDC>=0
-      ROOT::TThreadedObject<TH2F> 
-         heatmapUnscaledDCw0{"Unscaled heatmap: DCw, zDC>=0", "board vs alpha", 
-                             810, 0., 80., 195, -0.39, 0.39};
+      FlatHist<TH2F> heatmapUnscaledDCw0{registry, HistRegistry::ANY, "",
+                                         "Unscaled heatmap: DCw, zDC>=0", "board vs alpha", 810, 0.,
+                                         80., 195, -0.39, 0.39};
       /// unscaled by alpha heatmap of DCw, zDC<0
-      ROOT::TThreadedObject<TH2F> 
-         heatmapUnscaledDCw1{"Unscaled heatmap: DCw, zDC<0", "board vs alpha", 
-                             810, 0., 80., 195, -0.39, 0.39};
+      FlatHist<TH2F> heatmapUnscaledDCw1{registry, HistRegistry::ANY, "",
+                                         "Unscaled heatmap: DCw, zDC<0", "board vs alpha", 810, 0.,
+                                         80., 195, -0.39, 0.39};
       /// heatmap of DCe, zDC>=0
-      ROOT::TThreadedObject<TH2F> heatmapDCe0{"_Heatmap: DCe, zDC>=0", "board vs alpha", 
-                                              810, 0., 80., 195, -0.39, 0.39};
+      FlatHist<TH2F> heatmapDCe0{registry, HistRegistry::ANY, "", "_Heatmap: DCe, zDC>=0",
+                                 "board vs alpha", 810, 0., 80., 195, -0.39, 0.39};
       /// heatmap of DCe, zDC<0
-      ROOT::TThreadedObject<TH2F> heatmapDCe1{"_Heatmap: DCe, zDC<0", "board vs alpha", 
-                                              810, 0., 80., 195, -0.39, 0.39};
+      FlatHist<TH2F> heatmapDCe1{registry, HistRegistry::ANY, "", "_Heatmap: DCe, zDC<0",
+                                 "board vs alpha", 810, 0., 80., 195, -0.39, 0.39};
       /// heatmap of DCw, zDC>=0
-      ROOT::TThreadedObject<TH2F> heatmapDCw0{"_Heatmap: DCw, zDC>=0", "board vs alpha", 
-                                              810, 0., 80., 195, -0.39, 0.39};
+      FlatHist<TH2F> heatmapDCw0{registry, HistRegistry::ANY, "", "_Heatmap: DCw, zDC>=0",
+                                 "board vs alpha", 810, 0., 80., 195, -0.39, 0.39};
       /// heatmap of DCw, zDC<0
-      ROOT::TThreadedObject<TH2F> heatmapDCw1{"_Heatmap: DCw, zDC<0", "board vs alpha", 
-                                              810, 0., 80., 195, -0.39, 0.39};
+      FlatHist<TH2F> heatmapDCw1{registry, HistRegistry::ANY, "", "_Heatmap: DCw, zDC<0",
+                                 "board vs alpha", 810, 0., 80., 195, -0.39, 0.39};
       /// heatmap of DCeX1, zDC>=0
-      ROOT::TThreadedObject<TH2F> heatmapDCe0X1{"Heatmap: DCeX1, zDC>=0", "board vs alpha", 
-                                                810, 0., 80., 195, -0.39, 0.39};
+      FlatHist<TH2F> heatmapDCe0X1{registry, HistRegistry::ANY, "", "Heatmap: DCeX1, zDC>=0",
+                                   "board vs alpha", 810, 0., 80., 195, -0.39, 0.39};
       /// heatmap of DCeX1, zDC<0
-      ROOT::TThreadedObject<TH2F> heatmapDCe1X1{"Heatmap: DCeX1, zDC<0", "board vs alpha", 
-                                                810, 0., 80., 195, -0.39, 0.39};
+      FlatHist<TH2F> heatmapDCe1X1{registry, HistRegistry::ANY, "", "Heatmap: DCeX1, zDC<0",
+                                   "board vs alpha", 810, 0., 80., 195, -0.39, 0.39};
       /// heatmap of DCwX1, zDC>=0
-      ROOT::TThreadedObject<TH2F> heatmapDCw0X1{"Heatmap: DCwX1, zDC>=0", "board vs alpha", 
-                                                810, 0., 80., 195, -0.39, 0.39};
+      FlatHist<TH2F> heatmapDCw0X1{registry, HistRegistry::ANY, "", "Heatmap: DCwX1, zDC>=0",
+                                   "board vs alpha", 810, 0., 80., 195, -0.39, 0.39};
       /// heatmap of DCwX1, zDC<0
-      ROOT::TThreadedObject<TH2F> heatmapDCw1X1{"Heatmap: DCwX1, zDC<0", "board vs alpha", 
-                                                810, 0., 80., 195, -0.39, 0.39};
+      FlatHist<TH2F> heatmapDCw1X1{registry, HistRegistry::ANY, "", "Heatmap: DCwX1, zDC<0",
+                                   "board vs alpha", 810, 0., 80., 195, -0.39, 0.39};
       /// heatmap of DCeX2, zDC>=0
-      ROOT::TThreadedObject<TH2F> heatmapDCe0X2{"Heatmap: DCeX2, zDC>=0", "board vs alpha", 
-                                                810, 0., 80., 195, -0.39, 0.39};
+      FlatHist<TH2F> heatmapDCe0X2{registry, HistRegistry::ANY, "", "Heatmap: DCeX2, zDC>=0",
+                                   "board vs alpha", 810, 0., 80., 195, -0.39, 0.39};
       /// heatmap of DCeX2, zDC<0
-      ROOT::TThreadedObject<TH2F> heatmapDCe1X2{"Heatmap: DCeX2, zDC<0", "board vs alpha", 
-                                                810, 0., 80., 195, -0.39, 0.39};
+      FlatHist<TH2F> heatmapDCe1X2{registry, HistRegistry::ANY, "", "Heatmap: DCeX2, zDC<0",
+                                   "board vs alpha", 810, 0., 80., 195, -0.39, 0.39};
       /// heatmap of DCwX2, zDC>=0
-      ROOT::TThreadedObject<TH2F> heatmapDCw0X2{"Heatmap: DCwX2, zDC>=0", "board vs alpha", 
-                                                810, 0., 80., 195, -0.39, 0.39};
+      FlatHist<TH2F> heatmapDCw0X2{registry, HistRegistry::ANY, "", "Heatmap: DCwX2, zDC>=0",
+                                   "board vs alpha", 810, 0., 80., 195, -0.39, 0.39};
       /// heatmap of DCwX2, zDC<0
-      ROOT::TThreadedObject<TH2F> heatmapDCw1X2{"Heatmap: DCwX2, zDC<0", "board vs alpha", 
-                                                810, 0., 80., 195, -0.39, 0.39};
+      FlatHist<TH2F> heatmapDCw1X2{registry, HistRegistry::ANY, "", "Heatmap: DCwX2, zDC<0",
+                                   "board vs alpha", 810, 0., 80., 195, -0.39, 0.39};
       /// heatmap of PC1e
-      ROOT::TThreadedObject<TH2F> heatmapPC1e{"Heatmap: PC1e", "pc1z vs pc1phi", 
-                                              380, -95., 95., 170, 2.05, 3.75};
+      FlatHist<TH2F> heatmapPC1e{registry, HistRegistry::ANY, "", "Heatmap: PC1e", "pc1z vs pc1phi",
+                                 380, -95., 95., 170, 2.05, 3.75};
       /// heatmap of PC1w
-      ROOT::TThreadedObject<TH2F> heatmapPC1w{"Heatmap: PC1w", "pc1z vs pc1phi", 
-                                              380, -95., 95., 165, -0.6, 1.05};
+      FlatHist<TH2F> heatmapPC1w{registry, HistRegistry::ANY, "", "Heatmap: PC1w", "pc1z vs pc1phi",
+                                 380, -95., 95., 165, -0.6, 1.05};
       /// heatmap of PC1e for positive tracks
-      ROOT::TThreadedObject<TH2F> heatmapPC1ePos{"_Heatmap: PC1e, charge>0", "pc1z vs pc1phi", 
-                                                 380, -95., 95., 170, 2.05, 3.75};
+      FlatHist<TH2F> heatmapPC1ePos{registry, HistRegistry::ANY, "", "_Heatmap: PC1e, charge>0",
+                                    "pc1z vs pc1phi", 380, -95., 95., 170, 2.05, 3.75};
       /// heatmap of PC1e for negative tracks
-      ROOT::TThreadedObject<TH2F> heatmapPC1eNeg{"_Heatmap: PC1e, charge<0", "pc1z vs pc1phi", 
-                                                 380, -95., 95., 170, 2.05, 3.75};
+      FlatHist<TH2F> heatmapPC1eNeg{registry, HistRegistry::ANY, "", "_Heatmap: PC1e, charge<0",
+                                    "pc1z vs pc1phi", 380, -95., 95., 170, 2.05, 3.75};
       /// heatmap of PC1w for positive tracks
-      ROOT::TThreadedObject<TH2F> heatmapPC1wPos{"_Heatmap: PC1w, charge>0", "pc1z vs pc1phi", 
-                                                 380, -95., 95., 165, -0.6, 1.05};
+      FlatHist<TH2F> heatmapPC1wPos{registry, HistRegistry::ANY, "", "_Heatmap: PC1w, charge>0",
+                                    "pc1z vs pc1phi", 380, -95., 95., 165, -0.6, 1.05};
       /// heatmap of PC1w for negative tracks
-      ROOT::TThreadedObject<TH2F> heatmapPC1wNeg{"_Heatmap: PC1w, charge<0", "pc1z vs pc1phi", 
-                                                 380, -95., 95., 165, -0.6, 1.05};
+      FlatHist<TH2F> heatmapPC1wNeg{registry, HistRegistry::ANY, "", "_Heatmap: PC1w, charge<0",
+                                    "pc1z vs pc1phi", 380, -95., 95., 165, -0.6, 1.05};
       /// heatmap of PC2
-      ROOT::TThreadedObject<TH2F> heatmapPC2{"Heatmap: PC2", "pc2z vs pc2phi", 
-                                             330, -165., 165., 165, -0.6, 1.05};
+      FlatHist<TH2F> heatmapPC2{registry, HistRegistry::PC2, "", "Heatmap: PC2", "pc2z vs pc2phi",
+                                330, -165., 165., 165, -0.6, 1.05};
       /// heatmap of PC3e
-      ROOT::TThreadedObject<TH2F> heatmapPC3e{"Heatmap: PC3e", "pc3z vs pc3phi", 
-                                              390, -195., 195., 170, 2.1, 3.8};
+      FlatHist<TH2F> heatmapPC3e{registry, HistRegistry::PC3, "", "Heatmap: PC3e", "pc3z vs pc3phi",
+                                 390, -195., 195., 170, 2.1, 3.8};
       /// heatmap of PC3w
-      ROOT::TThreadedObject<TH2F> heatmapPC3w{"Heatmap: PC3w", "pc3z vs pc3phi", 
-                                              390, -195., 195., 170, -0.65, 1.05};
+      FlatHist<TH2F> heatmapPC3w{registry, HistRegistry::PC3, "", "Heatmap: PC3w", "pc3z vs pc3phi",
+                                 390, -195., 195., 170, -0.65, 1.05};
       /// heatmap of TOFe
-      ROOT::TThreadedObject<TH2F> heatmapTOFe{"Heatmap: TOFe", "chamber vs slat", 
-                                              10, 0., 10., 96, 0., 96.};
+      FlatHist<TH2F> heatmapTOFe{registry, HistRegistry::TOFe, "", "Heatmap: TOFe",
+                                 "chamber vs slat", 10, 0., 10., 96, 0., 96.};
 
       /// heatmap of TOFe hits
-      ROOT::TThreadedObject<TH2F> heatmapTOFeHit{"_Heatmap: TOFe hit", "chamber vs slat", 
-                                                 10, 0., 10., 96, 0., 96.};
+      FlatHist<TH2F> heatmapTOFeHit{registry, HistRegistry::TOFe, "", "_Heatmap: TOFe hit",
+                                    "chamber vs slat", 10, 0., 10., 96, 0., 96.};
       /// heatmap of TOFw
-      ROOT::TThreadedObject<TH2F> heatmapTOFw{"Heatmap: TOFw", "chamber vs strip", 
-                                              8, 0., 8., 64, 0., 64.};
+      FlatHist<TH2F> heatmapTOFw{registry, HistRegistry::TOFw, "", "Heatmap: TOFw",
+                                 "chamber vs strip", 8, 0., 8., 64, 0., 64.};
       /// heatmaps of EMCale(0-3)
-      std::array<ROOT::TThreadedObject<TH2F>, 4> heatmapEMCale
+      std::array<FlatHist<TH2F>, 4> heatmapEMCale
       {
-         ROOT::TThreadedObject<TH2F>("Heatmap: EMCale0", "ytower vs ztower", 
-                                     48, 0., 48., 97, 0., 97.),
-         ROOT::TThreadedObject<TH2F>("Heatmap: EMCale1", "ytower vs ztower", 
-                                     48, 0., 48., 97, 0., 97.),
-         ROOT::TThreadedObject<TH2F>("Heatmap: EMCale2", "ytower vs ztower", 
-                                     36, 0., 36, 72, 0., 72.),
-         ROOT::TThreadedObject<TH2F>("Heatmap: EMCale3", "ytower vs ztower", 
-                                     36, 0., 36, 72, 0., 72.)
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "Heatmap: EMCale0", "ytower vs ztower",
+                        48, 0., 48., 97, 0., 97.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "Heatmap: EMCale1", "ytower vs ztower",
+                        48, 0., 48., 97, 0., 97.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "Heatmap: EMCale2", "ytower vs ztower",
+                        36, 0., 36, 72, 0., 72.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "Heatmap: EMCale3", "ytower vs ztower",
+                        36, 0., 36, 72, 0., 72.)
       };
       /// heatmaps of EMCalw(0-3)
-      std::array<ROOT::TThreadedObject<TH2F>, 4> heatmapEMCalw
+      std::array<FlatHist<TH2F>, 4> heatmapEMCalw
       {
-         ROOT::TThreadedObject<TH2F>("Heatmap: EMCalw0", "ytower vs ztower", 
-                                     36, 0., 36., 72, 0., 72.),
-         ROOT::TThreadedObject<TH2F>("Heatmap: EMCalw1", "ytower vs ztower", 
-                                     36, 0., 36., 72, 0., 72.),
-         ROOT::TThreadedObject<TH2F>("Heatmap: EMCalw2", "ytower vs ztower", 
-                                     36, 0., 36., 72, 0., 72.),
-         ROOT::TThreadedObject<TH2F>("Heatmap: EMCalw3", "ytower vs ztower", 
-                                     36, 0., 36., 72, 0., 72.)
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "Heatmap: EMCalw0", "ytower vs ztower",
+                        36, 0., 36., 72, 0., 72.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "Heatmap: EMCalw1", "ytower vs ztower",
+                        36, 0., 36., 72, 0., 72.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "Heatmap: EMCalw2", "ytower vs ztower",
+                        36, 0., 36., 72, 0., 72.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "Heatmap: EMCalw3", "ytower vs ztower",
+                        36, 0., 36., 72, 0., 72.)
       };
       /// heatmaps of EMCale(0-3) hits
-      std::array<ROOT::TThreadedObject<TH2F>, 4> heatmapEMCaleHit
+      std::array<FlatHist<TH2F>, 4> heatmapEMCaleHit
       {
-         ROOT::TThreadedObject<TH2F>("_Heatmap: EMCale0 hit", "ytower vs ztower", 
-                                     48, 0., 48., 97, 0., 97.),
-         ROOT::TThreadedObject<TH2F>("_Heatmap: EMCale1 hit", "ytower vs ztower", 
-                                     48, 0., 48., 97, 0., 97.),
-         ROOT::TThreadedObject<TH2F>("_Heatmap: EMCale2 hit", "ytower vs ztower", 
-                                     36, 0., 36., 72, 0., 72.),
-         ROOT::TThreadedObject<TH2F>("_Heatmap: EMCale3 hit", "ytower vs ztower", 
-                                     36, 0., 36., 72, 0., 72.)
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "_Heatmap: EMCale0 hit",
+                        "ytower vs ztower", 48, 0., 48., 97, 0., 97.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "_Heatmap: EMCale1 hit",
+                        "ytower vs ztower", 48, 0., 48., 97, 0., 97.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "_Heatmap: EMCale2 hit",
+                        "ytower vs ztower", 36, 0., 36., 72, 0., 72.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "_Heatmap: EMCale3 hit",
+                        "ytower vs ztower", 36, 0., 36., 72, 0., 72.)
       };
       /// heatmaps of EMCalw(0-3) hits
-      std::array<ROOT::TThreadedObject<TH2F>, 4> heatmapEMCalwHit
+      std::array<FlatHist<TH2F>, 4> heatmapEMCalwHit
       {
-         ROOT::TThreadedObject<TH2F>("_Heatmap: EMCalw0 hit", "ytower vs ztower", 
-                                     36, 0., 36., 72, 0., 72.),
-         ROOT::TThreadedObject<TH2F>("_Heatmap: EMCalw1 hit", "ytower vs ztower", 
-                                     36, 0., 36., 72, 0., 72.),
-         ROOT::TThreadedObject<TH2F>("_Heatmap: EMCalw2 hit", "ytower vs ztower", 
-                                     36, 0., 36., 72, 0., 72.),
-         ROOT::TThreadedObject<TH2F>("_Heatmap: EMCalw3 hit", "ytower vs ztower", 
-                                     36, 0., 36., 72, 0., 72.)
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "_Heatmap: EMCalw0 hit",
+                        "ytower vs ztower", 36, 0., 36., 72, 0., 72.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "_Heatmap: EMCalw1 hit",
+                        "ytower vs ztower", 36, 0., 36., 72, 0., 72.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "_Heatmap: EMCalw2 hit",
+                        "ytower vs ztower", 36, 0., 36., 72, 0., 72.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "_Heatmap: EMCalw3 hit",
+                        "ytower vs ztower", 36, 0., 36., 72, 0., 72.)
       };
 
       /// pT distribution of particles regisetered and passed all cuts in PC2
-      ROOT::TThreadedObject<TH1D> distrRecPTPC2{"rec pT: PC2", "p_{T}", 100., 0., 10.};
+      FlatHist<TH1D> distrRecPTPC2{registry, HistRegistry::PC2, "", "rec pT: PC2", "p_{T}", 100.,
+                                   0., 10.};
       /// pT distribution of particles regisetered and passed all cuts in PC3
-      ROOT::TThreadedObject<TH1D> distrRecPTPC3{"rec pT: PC3", "p_{T}", 100., 0., 10.};
+      FlatHist<TH1D> distrRecPTPC3{registry, HistRegistry::PC3, "", "rec pT: PC3", "p_{T}", 100.,
+                                   0., 10.};
       /// pT distribution of particles regisetered and passed all cuts in EMCale(0-3)
-      std::array<ROOT::TThreadedObject<TH1D>, 4> distrRecPTEMCale
+      std::array<FlatHist<TH1D>, 4> distrRecPTEMCale
       {
-         ROOT::TThreadedObject<TH1D>("rec pT: EMCale0", "p_{T}", 100., 0., 10.),
-         ROOT::TThreadedObject<TH1D>("rec pT: EMCale1", "p_{T}", 100., 0., 10.),
-         ROOT::TThreadedObject<TH1D>("rec pT: EMCale2", "p_{T}", 100., 0., 10.),
-         ROOT::TThreadedObject<TH1D>("rec pT: EMCale3", "p_{T}", 100., 0., 10.)
+         FlatHist<TH1D>(registry, HistRegistry::EMCal, "", "rec pT: EMCale0", "p_{T}", 100., 0.,
+                        10.),
+         FlatHist<TH1D>(registry, HistRegistry::EMCal, "", "rec pT: EMCale1", "p_{T}", 100., 0.,
+                        10.),
+         FlatHist<TH1D>(registry, HistRegistry::EMCal, "", "rec pT: EMCale2", "p_{T}", 100., 0.,
+                        10.),
+         FlatHist<TH1D>(registry, HistRegistry::EMCal, "", "rec pT: EMCale3", "p_{T}", 100., 0.,
+                        10.)
       };
       /// pT distribution of particles regisetered and passed all cuts in EMCalw(0-3)
-      std::array<ROOT::TThreadedObject<TH1D>, 4> distrRecPTEMCalw
+      std::array<FlatHist<TH1D>, 4> distrRecPTEMCalw
       {
-         ROOT::TThreadedObject<TH1D>("rec pT: EMCalw0", "p_{T}", 100., 0., 10.),
-         ROOT::TThreadedObject<TH1D>("rec pT: EMCalw1", "p_{T}", 100., 0., 10.),
-         ROOT::TThreadedObject<TH1D>("rec pT: EMCalw2", "p_{T}", 100., 0., 10.),
-         ROOT::TThreadedObject<TH1D>("rec pT: EMCalw3", "p_{T}", 100., 0., 10.)
+         FlatHist<TH1D>(registry, HistRegistry::EMCal, "", "rec pT: EMCalw0", "p_{T}", 100., 0.,
+                        10.),
+         FlatHist<TH1D>(registry, HistRegistry::EMCal, "", "rec pT: EMCalw1", "p_{T}", 100., 0.,
+                        10.),
+         FlatHist<TH1D>(registry, HistRegistry::EMCal, "", "rec pT: EMCalw2", "p_{T}", 100., 0.,
+                        10.),
+         FlatHist<TH1D>(registry, HistRegistry::EMCal, "", "rec pT: EMCalw3", "p_{T}", 100., 0.,
+                        10.)
       };
       /// pT distribution of particles regisetered and passed all cuts in TOFe
-      ROOT::TThreadedObject<TH1D> distrRecPTTOFe{"rec pT: TOFe", "p_{T}", 100., 0., 10.};
+      FlatHist<TH1D> distrRecPTTOFe{registry, HistRegistry::TOFe, "", "rec pT: TOFe", "p_{T}", 100.,
+                                    0., 10.};
       /// pT distribution of particles regisetered and passed all cuts in TOFw
-      ROOT::TThreadedObject<TH1D> distrRecPTTOFw{"rec pT: TOFw", "p_{T}", 100., 0., 10.};
+      FlatHist<TH1D> distrRecPTTOFw{registry, HistRegistry::TOFw, "", "rec pT: TOFw", "p_{T}", 100.,
+                                    0., 10.};
       /// pT distribution of particles identified in EMCale(0-3)
-      std::array<ROOT::TThreadedObject<TH1D>, 2> distrRecIdPTEMCale
+      std::array<FlatHist<TH1D>, 2> distrRecIdPTEMCale
       {
-         ROOT::TThreadedObject<TH1D>("rec id pT: EMCale2", "p_{T}", 100., 0., 10.),
-         ROOT::TThreadedObject<TH1D>("rec id pT: EMCale3", "p_{T}", 100., 0., 10.)
+         FlatHist<TH1D>(registry, HistRegistry::EMCal, "", "rec id pT: EMCale2", "p_{T}", 100., 0.,
+                        10.),
+         FlatHist<TH1D>(registry, HistRegistry::EMCal, "", "rec id pT: EMCale3", "p_{T}", 100., 0.,
+                        10.)
       };
       /// pT distribution of particles identified in EMCalw(0-3)
-      std::array<ROOT::TThreadedObject<TH1D>, 4> distrRecIdPTEMCalw
+      std::array<FlatHist<TH1D>, 4> distrRecIdPTEMCalw
       {
-         ROOT::TThreadedObject<TH1D>("rec id pT: EMCalw0", "p_{T}", 100., 0., 10.),
-         ROOT::TThreadedObject<TH1D>("rec id pT: EMCalw1", "p_{T}", 100., 0., 10.),
-         ROOT::TThreadedObject<TH1D>("rec id pT: EMCalw2", "p_{T}", 100., 0., 10.),
-         ROOT::TThreadedObject<TH1D>("rec id pT: EMCalw3", "p_{T}", 100., 0., 10.)
+         FlatHist<TH1D>(registry, HistRegistry::EMCal, "", "rec id pT: EMCalw0", "p_{T}", 100., 0.,
+                        10.),
+         FlatHist<TH1D>(registry, HistRegistry::EMCal, "", "rec id pT: EMCalw1", "p_{T}", 100., 0.,
+                        10.),
+         FlatHist<TH1D>(registry, HistRegistry::EMCal, "", "rec id pT: EMCalw2", "p_{T}", 100., 0.,
+                        10.),
+         FlatHist<TH1D>(registry, HistRegistry::EMCal, "", "rec id pT: EMCalw3", "p_{T}", 100., 0.,
+                        10.)
       };
       /// pT distribution of particles identified in TOFe
-      ROOT::TThreadedObject<TH1D> distrRecIdPTTOFe{"rec id pT: TOFe", "p_{T}", 100., 0., 10.};
+      FlatHist<TH1D> distrRecIdPTTOFe{registry, HistRegistry::TOFe, "", "rec id pT: TOFe", "p_{T}",
+                                      100., 0., 10.};
       /// pT distribution of particles identified in TOFw
-      ROOT::TThreadedObject<TH1D> distrRecIdPTTOFw{"rec id pT: TOFw", "p_{T}", 100., 0., 10.};
+      FlatHist<TH1D> distrRecIdPTTOFw{registry, HistRegistry::TOFw, "", "rec id pT: TOFw", "p_{T}",
+                                      100., 0., 10.};
       /// prob in EMCale(0-3) vs pT distributions
-      std::array<ROOT::TThreadedObject<TH2F>, 4> distrProbVsPTEMCale
+      std::array<FlatHist<TH2F>, 4> distrProbVsPTEMCale
       {
-         ROOT::TThreadedObject<TH2F>("prob vs pT, EMCale0", "prob vs p_{T}", 
-                                     20, 0., 10., 100, 0., 1.),
-         ROOT::TThreadedObject<TH2F>("prob vs pT, EMCale1", "prob vs p_{T}", 
-                                     20, 0., 10., 100, 0., 1.),
-         ROOT::TThreadedObject<TH2F>("prob vs pT, EMCale2", "prob vs p_{T}", 
-                                     20, 0., 10., 100, 0., 1.),
-         ROOT::TThreadedObject<TH2F>("prob vs pT, EMCale3", "prob vs p_{T}", 
-                                     20, 0., 10., 100, 0., 1.)
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "prob vs pT, EMCale0", "prob vs p_{T}",
+                        20, 0., 10., 100, 0., 1.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "prob vs pT, EMCale1", "prob vs p_{T}",
+                        20, 0., 10., 100, 0., 1.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "prob vs pT, EMCale2", "prob vs p_{T}",
+                        20, 0., 10., 100, 0., 1.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "prob vs pT, EMCale3", "prob vs p_{T}",
+                        20, 0., 10., 100, 0., 1.)
       };
       /// prob in EMCalw(0-3) vs pT distributions
-      std::array<ROOT::TThreadedObject<TH2F>, 4> distrProbVsPTEMCalw
+      std::array<FlatHist<TH2F>, 4> distrProbVsPTEMCalw
       {
-         ROOT::TThreadedObject<TH2F>("prob vs pT, EMCalw0", "prob vs p_{T}", 
-                                     20, 0., 10., 100, 0., 1.),
-         ROOT::TThreadedObject<TH2F>("prob vs pT, EMCalw1", "prob vs p_{T}", 
-                                     20, 0., 10., 100, 0., 1.),
-         ROOT::TThreadedObject<TH2F>("prob vs pT, EMCalw2", "prob vs p_{T}", 
-                                     20, 0., 10., 100, 0., 1.),
-         ROOT::TThreadedObject<TH2F>("prob vs pT, EMCalw3", "prob vs p_{T}", 
-                                     20, 0., 10., 100, 0., 1.)
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "prob vs pT, EMCalw0", "prob vs p_{T}",
+                        20, 0., 10., 100, 0., 1.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "prob vs pT, EMCalw1", "prob vs p_{T}",
+                        20, 0., 10., 100, 0., 1.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "prob vs pT, EMCalw2", "prob vs p_{T}",
+                        20, 0., 10., 100, 0., 1.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "prob vs pT, EMCalw3", "prob vs p_{T}",
+                        20, 0., 10., 100, 0., 1.)
       };
       /// ecore in EMCale(0-3) vs pT distributions
-      std::array<ROOT::TThreadedObject<TH2F>, 4> distrECoreVsPTEMCale
+      std::array<FlatHist<TH2F>, 4> distrECoreVsPTEMCale
       {
-         ROOT::TThreadedObject<TH2F>("ecore vs pT, EMCale0", "E_{core} vs p_{T}", 
-                                     100, 0., 10., 100, 0., 2.),
-         ROOT::TThreadedObject<TH2F>("ecore vs pT, EMCale1", "E_{core} vs p_{T}", 
-                                     100, 0., 10., 200, 0., 2.),
-         ROOT::TThreadedObject<TH2F>("ecore vs pT, EMCale2", "E_{core} vs p_{T}", 
-                                     100, 0., 10., 100, 0., 2.),
-         ROOT::TThreadedObject<TH2F>("ecore vs pT, EMCale3", "E_{core} vs p_{T}", 
-                                     100, 0., 10., 100, 0., 2.)
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "ecore vs pT, EMCale0",
+                        "E_{core} vs p_{T}", 100, 0., 10., 100, 0., 2.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "ecore vs pT, EMCale1",
+                        "E_{core} vs p_{T}", 100, 0., 10., 200, 0., 2.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "ecore vs pT, EMCale2",
+                        "E_{core} vs p_{T}", 100, 0., 10., 100, 0., 2.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "ecore vs pT, EMCale3",
+                        "E_{core} vs p_{T}", 100, 0., 10., 100, 0., 2.)
       };
       /// ecore in EMCalw(0-3) vs pT distributions
-      std::array<ROOT::TThreadedObject<TH2F>, 4> distrECoreVsPTEMCalw
+      std::array<FlatHist<TH2F>, 4> distrECoreVsPTEMCalw
       {
-         ROOT::TThreadedObject<TH2F>("ecore vs pT, EMCalw0", "E_{core} vs p_{T}", 
-                                     100, 0., 10., 100, 0., 2.),
-         ROOT::TThreadedObject<TH2F>("ecore vs pT, EMCalw1", "E_{core} vs p_{T}", 
-                                     100, 0., 10., 100, 0., 2.),
-         ROOT::TThreadedObject<TH2F>("ecore vs pT, EMCalw2", "E_{core} vs p_{T}", 
-                                     100, 0., 10., 100, 0., 2.),
-         ROOT::TThreadedObject<TH2F>("ecore vs pT, EMCalw3", "E_{core} vs p_{T}", 
-                                     100, 0., 10., 100, 0., 2.)
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "ecore vs pT, EMCalw0",
+                        "E_{core} vs p_{T}", 100, 0., 10., 100, 0., 2.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "ecore vs pT, EMCalw1",
+                        "E_{core} vs p_{T}", 100, 0., 10., 100, 0., 2.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "ecore vs pT, EMCalw2",
+                        "E_{core} vs p_{T}", 100, 0., 10., 100, 0., 2.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "ecore vs pT, EMCalw3",
+                        "E_{core} vs p_{T}", 100, 0., 10., 100, 0., 2.)
       };
       /// ecore in EMCale(0-3) vs pT distributions for original particles only
-      std::array<ROOT::TThreadedObject<TH2F>, 4> distrECoreVsPTEMCaleOrig
+      std::array<FlatHist<TH2F>, 4> distrECoreVsPTEMCaleOrig
       {
-         ROOT::TThreadedObject<TH2F>("ecore vs pT, EMCale0, orig only", "E_{core} vs p_{T}", 
-                                     100, 0., 10., 100, 0., 2.),
-         ROOT::TThreadedObject<TH2F>("ecore vs pT, EMCale1, orig only", "E_{core} vs p_{T}", 
-                                     100, 0., 10., 100, 0., 2.),
-         ROOT::TThreadedObject<TH2F>("ecore vs pT, EMCale2, orig only", "E_{core} vs p_{T}", 
-                                     100, 0., 10., 100, 0., 2.),
-         ROOT::TThreadedObject<TH2F>("ecore vs pT, EMCale3, orig only", "E_{core} vs p_{T}", 
-                                     100, 0., 10., 100, 0., 2.)
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "ecore vs pT, EMCale0, orig only",
+                        "E_{core} vs p_{T}", 100, 0., 10., 100, 0., 2.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "ecore vs pT, EMCale1, orig only",
+                        "E_{core} vs p_{T}", 100, 0., 10., 100, 0., 2.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "ecore vs pT, EMCale2, orig only",
+                        "E_{core} vs p_{T}", 100, 0., 10., 100, 0., 2.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "ecore vs pT, EMCale3, orig only",
+                        "E_{core} vs p_{T}", 100, 0., 10., 100, 0., 2.)
       };
       /// ecore in EMCalw(0-3) vs pT distributions
-      std::array<ROOT::TThreadedObject<TH2F>, 4> distrECoreVsPTEMCalwOrig
+      std::array<FlatHist<TH2F>, 4> distrECoreVsPTEMCalwOrig
       {
-         ROOT::TThreadedObject<TH2F>("ecore vs pT, EMCalw0, orig only", "E_{core} vs p_{T}", 
-                                     100, 0., 10., 100, 0., 2.),
-         ROOT::TThreadedObject<TH2F>("ecore vs pT, EMCalw1, orig only", "E_{core} vs p_{T}", 
-                                     100, 0., 10., 100, 0., 2.),
-         ROOT::TThreadedObject<TH2F>("ecore vs pT, EMCalw2, orig only", "E_{core} vs p_{T}", 
-                                     100, 0., 10., 100, 0., 2.),
-         ROOT::TThreadedObject<TH2F>("ecore vs pT, EMCalw3, orig only", "E_{core} vs p_{T}", 
-                                     100, 0., 10., 100, 0., 2.)
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "ecore vs pT, EMCalw0, orig only",
+                        "E_{core} vs p_{T}", 100, 0., 10., 100, 0., 2.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "ecore vs pT, EMCalw1, orig only",
+                        "E_{core} vs p_{T}", 100, 0., 10., 100, 0., 2.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "ecore vs pT, EMCalw2, orig only",
+                        "E_{core} vs p_{T}", 100, 0., 10., 100, 0., 2.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "ecore vs pT, EMCalw3, orig only",
+                        "E_{core} vs p_{T}", 100, 0., 10., 100, 0., 2.)
       };
       /// eloss vs beta distribution in TOFe
-      ROOT::TThreadedObject<TH2F> distrBetaVsETOFe{"beta vs E, TOFe", "#beta vs E_{TOFe}", 
-                                                   100, 0., 1., 100, 0., 0.03};
+      FlatHist<TH2F> distrBetaVsETOFe{registry, HistRegistry::TOFe, "", "beta vs E, TOFe",
+                                      "#beta vs E_{TOFe}", 100, 0., 1., 100, 0., 0.03};
       /// pc2dphi vs pT distribution for positive tracks
-      ROOT::TThreadedObject<TH2F> distrDPhiVsPTPC2Pos
-         {"dphi vs pT: PC2, charge>0", "d#varphi_{PC2} vs p_{T}", 200, -0.1, 0.1, 30, 0., 3.};
+      FlatHist<TH2F> distrDPhiVsPTPC2Pos{registry, HistRegistry::PC2, "dphi",
+                                         "dphi vs pT: PC2, charge>0", "d#varphi_{PC2} vs p_{T}",
+                                         200, -0.1, 0.1, 30, 0., 3.};
       /// pc2dz vs pT distribution for positive tracks
-      ROOT::TThreadedObject<TH2F> distrDZVsPTPC2Pos
-         {"dz vs pT: PC2, charge>0", "dz_{PC2} vs p_{T}", 200, -50., 50., 30, 0., 3.};
+      FlatHist<TH2F> distrDZVsPTPC2Pos{registry, HistRegistry::PC2, "dz", "dz vs pT: PC2, charge>0",
+                                       "dz_{PC2} vs p_{T}", 200, -50., 50., 30, 0., 3.};
       /// pc2dphi vs pT distribution for negative tracks
-      ROOT::TThreadedObject<TH2F> distrDPhiVsPTPC2Neg
-         {"dphi vs pT: PC2, charge<0", "d#varphi_{PC2} vs p_{T}", 200, -0.1, 0.1, 30, 0., 3.};
+      FlatHist<TH2F> distrDPhiVsPTPC2Neg{registry, HistRegistry::PC2, "dphi",
+                                         "dphi vs pT: PC2, charge<0", "d#varphi_{PC2} vs p_{T}",
+                                         200, -0.1, 0.1, 30, 0., 3.};
       /// pc2dz vs pT distribution for negative tracks
-      ROOT::TThreadedObject<TH2F> distrDZVsPTPC2Neg
-         {"dz vs pT: PC2, charge<0", "dz_{PC2} vs p_{T}", 200, -50., 50., 30, 0., 3.};
+      FlatHist<TH2F> distrDZVsPTPC2Neg{registry, HistRegistry::PC2, "dz", "dz vs pT: PC2, charge<0",
+                                       "dz_{PC2} vs p_{T}", 200, -50., 50., 30, 0., 3.};
       /// pc3dphi vs pT distribution for positive tracks for east arm
-      ROOT::TThreadedObject<TH2F> distrDPhiVsPTPC3ePos
-         {"dphi vs pT: PC3e, charge>0", "d#varphi_{PC3e} vs p_{T}", 200, -0.1, 0.1, 30, 0., 3.};
+      FlatHist<TH2F> distrDPhiVsPTPC3ePos{registry, HistRegistry::PC3, "dphi",
+                                          "dphi vs pT: PC3e, charge>0", "d#varphi_{PC3e} vs p_{T}",
+                                          200, -0.1, 0.1, 30, 0., 3.};
       /// pc3dz vs pT distribution for positive tracks for east arm
-      ROOT::TThreadedObject<TH2F> distrDZVsPTPC3ePos
-         {"dz vs pT: PC3e, charge>0", "dz_{PC3e} vs p_{T}", 200, -50., 50., 30, 0., 3.};
+      FlatHist<TH2F> distrDZVsPTPC3ePos{registry, HistRegistry::PC3, "dz",
+                                        "dz vs pT: PC3e, charge>0", "dz_{PC3e} vs p_{T}", 200, -50.,
+                                        50., 30, 0., 3.};
       /// pc3dphi vs pT distribution for negative tracks for east arm
-      ROOT::TThreadedObject<TH2F> distrDPhiVsPTPC3eNeg
-         {"dphi vs pT: PC3e, charge<0", "d#varphi_{PC3e} vs p_{T}", 200, -0.1, 0.1, 30, 0., 3.};
+      FlatHist<TH2F> distrDPhiVsPTPC3eNeg{registry, HistRegistry::PC3, "dphi",
+                                          "dphi vs pT: PC3e, charge<0", "d#varphi_{PC3e} vs p_{T}",
+                                          200, -0.1, 0.1, 30, 0., 3.};
       /// pc3dz vs pT distribution for negative tracks for east arm
-      ROOT::TThreadedObject<TH2F> distrDZVsPTPC3eNeg
-         {"dz vs pT: PC3e, charge<0", "dz_{PC3e} vs p_{T}", 200, -50., 50., 30, 0., 3.};
+      FlatHist<TH2F> distrDZVsPTPC3eNeg{registry, HistRegistry::PC3, "dz",
+                                        "dz vs pT: PC3e, charge<0", "dz_{PC3e} vs p_{T}", 200, -50.,
+                                        50., 30, 0., 3.};
       /// pc3dphi vs pT distribution for positive tracks for west arm
-      ROOT::TThreadedObject<TH2F> distrDPhiVsPTPC3wPos
-         {"dphi vs pT: PC3w, charge>0", "d#varphi_{PC3w} vs p_{T}", 200, -0.1, 0.1, 30, 0., 3.};
+      FlatHist<TH2F> distrDPhiVsPTPC3wPos{registry, HistRegistry::PC3, "dphi",
+                                          "dphi vs pT: PC3w, charge>0", "d#varphi_{PC3w} vs p_{T}",
+                                          200, -0.1, 0.1, 30, 0., 3.};
       /// pc3dz vs pT distribution for positive tracks for west arm
-      ROOT::TThreadedObject<TH2F> distrDZVsPTPC3wPos
-         {"dz vs pT: PC3w, charge>0", "dz_{PC3w} vs p_{T}", 200, -50., 50., 30, 0., 3.};
+      FlatHist<TH2F> distrDZVsPTPC3wPos{registry, HistRegistry::PC3, "dz",
+                                        "dz vs pT: PC3w, charge>0", "dz_{PC3w} vs p_{T}", 200, -50.,
+                                        50., 30, 0., 3.};
       /// pc3dphi vs pT distribution for negative tracks for west arm
-      ROOT::TThreadedObject<TH2F> distrDPhiVsPTPC3wNeg
-         {"dphi vs pT: PC3w, charge<0", "d#varphi_{PC3w} vs p_{T}", 200, -0.1, 0.1, 30, 0., 3.};
+      FlatHist<TH2F> distrDPhiVsPTPC3wNeg{registry, HistRegistry::PC3, "dphi",
+                                          "dphi vs pT: PC3w, charge<0", "d#varphi_{PC3w} vs p_{T}",
+                                          200, -0.1, 0.1, 30, 0., 3.};
       /// pc3dz vs pT distribution for negative tracks for west arm
-      ROOT::TThreadedObject<TH2F> distrDZVsPTPC3wNeg
-         {"dz vs pT: PC3w, charge<0", "dz_{PC3w} vs p_{T}", 200, -50., 50., 30, 0., 3.};
+      FlatHist<TH2F> distrDZVsPTPC3wNeg{registry, HistRegistry::PC3, "dz",
+                                        "dz vs pT: PC3w, charge<0", "dz_{PC3w} vs p_{T}", 200, -50.,
+                                        50., 30, 0., 3.};
       /// tofdphi vs pT distribution for positive tracks
-      ROOT::TThreadedObject<TH2F> distrDPhiVsPTTOFePos
-         {"dphi vs pT: TOFe, charge>0", "d#varphi_{TOFe} vs p_{T}", 200, -0.1, 0.1, 30, 0., 3.};
+      FlatHist<TH2F> distrDPhiVsPTTOFePos{registry, HistRegistry::TOFe, "dphi",
+                                          "dphi vs pT: TOFe, charge>0", "d#varphi_{TOFe} vs p_{T}",
+                                          200, -0.1, 0.1, 30, 0., 3.};
       /// tofdz vs pT distribution for positive tracks
-      ROOT::TThreadedObject<TH2F> distrDZVsPTTOFePos
-         {"dz vs pT: TOFe, charge>0", "dz_{TOFe} vs p_{T}", 200, -50., 50., 30, 0., 3.};
+      FlatHist<TH2F> distrDZVsPTTOFePos{registry, HistRegistry::TOFe, "dz",
+                                        "dz vs pT: TOFe, charge>0", "dz_{TOFe} vs p_{T}", 200, -50.,
+                                        50., 30, 0., 3.};
       /// tofdphi vs pT distribution for negative tracks
-      ROOT::TThreadedObject<TH2F> distrDPhiVsPTTOFeNeg
-         {"dphi vs pT: TOFe, charge<0", "d#varphi_{TOFe} vs p_{T}", 200, -0.1, 0.1, 30, 0., 3.};
+      FlatHist<TH2F> distrDPhiVsPTTOFeNeg{registry, HistRegistry::TOFe, "dphi",
+                                          "dphi vs pT: TOFe, charge<0", "d#varphi_{TOFe} vs p_{T}",
+                                          200, -0.1, 0.1, 30, 0., 3.};
       /// tofdz vs pT distribution for negative tracks
-      ROOT::TThreadedObject<TH2F> distrDZVsPTTOFeNeg
-         {"dz vs pT: TOFe, charge<0", "dz_{TOFe} vs p_{T}", 200, -50., 50., 30, 0., 3.};
+      FlatHist<TH2F> distrDZVsPTTOFeNeg{registry, HistRegistry::TOFe, "dz",
+                                        "dz vs pT: TOFe, charge<0", "dz_{TOFe} vs p_{T}", 200, -50.,
+                                        50., 30, 0., 3.};
       /// tofwdphi vs pT distribution for positive tracks
-      ROOT::TThreadedObject<TH2F> distrDPhiVsPTTOFwPos
-         {"dphi vs pT: TOFw, charge>0", "d#varphi_{TOFw} vs p_{T}", 200, -0.1, 0.1, 30, 0., 3.};
+      FlatHist<TH2F> distrDPhiVsPTTOFwPos{registry, HistRegistry::TOFw, "dphi",
+                                          "dphi vs pT: TOFw, charge>0", "d#varphi_{TOFw} vs p_{T}",
+                                          200, -0.1, 0.1, 30, 0., 3.};
       /// tofwdz vs pT distribution for positive tracks
-      ROOT::TThreadedObject<TH2F> distrDZVsPTTOFwPos
-         {"dz vs pT: TOFw, charge>0", "dz_{TOFw} vs p_{T}", 200, -50., 50., 30, 0., 3.};
+      FlatHist<TH2F> distrDZVsPTTOFwPos{registry, HistRegistry::TOFw, "dz",
+                                        "dz vs pT: TOFw, charge>0", "dz_{TOFw} vs p_{T}", 200, -50.,
+                                        50., 30, 0., 3.};
       /// tofwdphi vs pT distribution for negative tracks
-      ROOT::TThreadedObject<TH2F> distrDPhiVsPTTOFwNeg
-         {"dphi vs pT: TOFw, charge<0", "d#varphi_{TOFw} vs p_{T}", 200, -0.1, 0.1, 30, 0., 3.};
+      FlatHist<TH2F> distrDPhiVsPTTOFwNeg{registry, HistRegistry::TOFw, "dphi",
+                                          "dphi vs pT: TOFw, charge<0", "d#varphi_{TOFw} vs p_{T}",
+                                          200, -0.1, 0.1, 30, 0., 3.};
       /// tofwdz vs pT distribution for negative tracks
-      ROOT::TThreadedObject<TH2F> distrDZVsPTTOFwNeg
-         {"dz vs pT: TOFw, charge<0", "dz_{TOFw} vs p_{T}", 200, -50., 50., 30, 0., 3.};
+      FlatHist<TH2F> distrDZVsPTTOFwNeg{registry, HistRegistry::TOFw, "dz",
+                                        "dz vs pT: TOFw, charge<0", "dz_{TOFw} vs p_{T}", 200, -50.,
+                                        50., 30, 0., 3.};
       /// emcdphi vs pT distributions for (0-3) sectors in east arm for positive tracks
-      std::array<ROOT::TThreadedObject<TH2F>, 4> distrDPhiVsPTEMCalePos
+      std::array<FlatHist<TH2F>, 4> distrDPhiVsPTEMCalePos
       {
-         ROOT::TThreadedObject<TH2F>("dphi vs pT: EMCale0, charge>0", 
-                                     "d#varphi_{EMCale0} vs p_{T}", 
-                                     200, -0.1, 0.1, 30, 0., 3.),
-         ROOT::TThreadedObject<TH2F>("dphi vs pT: EMCale1, charge>0", 
-                                     "d#varphi_{EMCale1} vs p_{T}", 
-                                     200, -0.1, 0.1, 30, 0., 3.),
-         ROOT::TThreadedObject<TH2F>("dphi vs pT: EMCale2, charge>0", 
-                                     "d#varphi_{EMCale2} vs p_{T}", 
-                                     200, -0.1, 0.1, 30, 0., 3.),
-         ROOT::TThreadedObject<TH2F>("dphi vs pT: EMCale3, charge>0", 
-                                     "d#varphi_{EMCale3} vs p_{T}", 
-                                     200, -0.1, 0.1, 30, 0., 3.)
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "dphi", "dphi vs pT: EMCale0, charge>0",
+                        "d#varphi_{EMCale0} vs p_{T}", 200, -0.1, 0.1, 30, 0., 3.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "dphi", "dphi vs pT: EMCale1, charge>0",
+                        "d#varphi_{EMCale1} vs p_{T}", 200, -0.1, 0.1, 30, 0., 3.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "dphi", "dphi vs pT: EMCale2, charge>0",
+                        "d#varphi_{EMCale2} vs p_{T}", 200, -0.1, 0.1, 30, 0., 3.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "dphi", "dphi vs pT: EMCale3, charge>0",
+                        "d#varphi_{EMCale3} vs p_{T}", 200, -0.1, 0.1, 30, 0., 3.)
       };
       /// emcdz vs pT distributions for (0-3) sectors in east arm for positive tracks
-      std::array<ROOT::TThreadedObject<TH2F>, 4> distrDZVsPTEMCalePos
+      std::array<FlatHist<TH2F>, 4> distrDZVsPTEMCalePos
       {
-         ROOT::TThreadedObject<TH2F>("dz vs pT: EMCale0, charge>0", "dz_{EMCale0} vs p_{T}", 
-                                     200, -50., 50., 30, 0., 3.),
-         ROOT::TThreadedObject<TH2F>("dz vs pT: EMCale1, charge>0", "dz_{EMCale1} vs p_{T}", 
-                                     200, -50., 50., 30, 0., 3.),
-         ROOT::TThreadedObject<TH2F>("dz vs pT: EMCale2, charge>0", "dz_{EMCale2} vs p_{T}", 
-                                     200, -50., 50., 30, 0., 3.),
-         ROOT::TThreadedObject<TH2F>("dz vs pT: EMCale3, charge>0", "dz_{EMCale3} vs p_{T}", 
-                                     200, -50., 50., 30, 0., 3.)
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "dz", "dz vs pT: EMCale0, charge>0",
+                        "dz_{EMCale0} vs p_{T}", 200, -50., 50., 30, 0., 3.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "dz", "dz vs pT: EMCale1, charge>0",
+                        "dz_{EMCale1} vs p_{T}", 200, -50., 50., 30, 0., 3.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "dz", "dz vs pT: EMCale2, charge>0",
+                        "dz_{EMCale2} vs p_{T}", 200, -50., 50., 30, 0., 3.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "dz", "dz vs pT: EMCale3, charge>0",
+                        "dz_{EMCale3} vs p_{T}", 200, -50., 50., 30, 0., 3.)
       };
       /// emcdphi vs pT distributions for (0-3) sectors in east arm for negative tracks
-      std::array<ROOT::TThreadedObject<TH2F>, 4> distrDPhiVsPTEMCaleNeg
+      std::array<FlatHist<TH2F>, 4> distrDPhiVsPTEMCaleNeg
       {
-         ROOT::TThreadedObject<TH2F>("dphi vs pT: EMCale0, charge<0", 
-                                     "d#varphi_{EMCale0} vs p_{T}", 
-                                     200, -0.1, 0.1, 30, 0., 3.),
-         ROOT::TThreadedObject<TH2F>("dphi vs pT: EMCale1, charge<0", 
-                                     "d#varphi_{EMCale1} vs p_{T}", 
-                                     200, -0.1, 0.1, 30, 0., 3.),
-         ROOT::TThreadedObject<TH2F>("dphi vs pT: EMCale2, charge<0", 
-                                     "d#varphi_{EMCale2} vs p_{T}", 
-                                     200, -0.1, 0.1, 30, 0., 3.),
-         ROOT::TThreadedObject<TH2F>("dphi vs pT: EMCale3, charge<0", 
-                                     "d#varphi_{EMCale3} vs p_{T}", 
-                                     200, -0.1, 0.1, 30, 0., 3.)
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "dphi", "dphi vs pT: EMCale0, charge<0",
+                        "d#varphi_{EMCale0} vs p_{T}", 200, -0.1, 0.1, 30, 0., 3.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "dphi", "dphi vs pT: EMCale1, charge<0",
+                        "d#varphi_{EMCale1} vs p_{T}", 200, -0.1, 0.1, 30, 0., 3.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "dphi", "dphi vs pT: EMCale2, charge<0",
+                        "d#varphi_{EMCale2} vs p_{T}", 200, -0.1, 0.1, 30, 0., 3.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "dphi", "dphi vs pT: EMCale3, charge<0",
+                        "d#varphi_{EMCale3} vs p_{T}", 200, -0.1, 0.1, 30, 0., 3.)
       };
       /// emcdz vs pT distributions for (0-3) sectors in east arm for negative tracks
-      std::array<ROOT::TThreadedObject<TH2F>, 4> distrDZVsPTEMCaleNeg
+      std::array<FlatHist<TH2F>, 4> distrDZVsPTEMCaleNeg
       {
-         ROOT::TThreadedObject<TH2F>("dz vs pT: EMCale0, charge<0", "dz_{EMCale0} vs p_{T}", 
-                                     200, -50., 50., 30, 0., 3.),
-         ROOT::TThreadedObject<TH2F>("dz vs pT: EMCale1, charge<0", "dz_{EMCale1} vs p_{T}", 
-                                     200, -50., 50., 30, 0., 3.),
-         ROOT::TThreadedObject<TH2F>("dz vs pT: EMCale2, charge<0", "dz_{EMCale2} vs p_{T}", 
-                                     200, -50., 50., 30, 0., 3.),
-         ROOT::TThreadedObject<TH2F>("dz vs pT: EMCale3, charge<0", "dz_{EMCale3} vs p_{T}", 
-                                     200, -50., 50., 30, 0., 3.)
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "dz", "dz vs pT: EMCale0, charge<0",
+                        "dz_{EMCale0} vs p_{T}", 200, -50., 50., 30, 0., 3.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "dz", "dz vs pT: EMCale1, charge<0",
+                        "dz_{EMCale1} vs p_{T}", 200, -50., 50., 30, 0., 3.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "dz", "dz vs pT: EMCale2, charge<0",
+                        "dz_{EMCale2} vs p_{T}", 200, -50., 50., 30, 0., 3.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "dz", "dz vs pT: EMCale3, charge<0",
+                        "dz_{EMCale3} vs p_{T}", 200, -50., 50., 30, 0., 3.)
       };
       /// emcdphi vs pT distributions for (0-3) sectors in west arm for positive tracks
-      std::array<ROOT::TThreadedObject<TH2F>, 4> distrDPhiVsPTEMCalwPos
+      std::array<FlatHist<TH2F>, 4> distrDPhiVsPTEMCalwPos
       {
-         ROOT::TThreadedObject<TH2F>("dphi vs pT: EMCalw0, charge>0", 
-                                     "d#varphi_{EMCale0} vs p_{T}", 
-                                     200, -0.1, 0.1, 30, 0., 3.),
-         ROOT::TThreadedObject<TH2F>("dphi vs pT: EMCalw1, charge>0", 
-                                     "d#varphi_{EMCale1} vs p_{T}", 
-                                     200, -0.1, 0.1, 30, 0., 3.),
-         ROOT::TThreadedObject<TH2F>("dphi vs pT: EMCalw2, charge>0", 
-                                     "d#varphi_{EMCale2} vs p_{T}", 
-                                     200, -0.1, 0.1, 30, 0., 3.),
-         ROOT::TThreadedObject<TH2F>("dphi vs pT: EMCalw3, charge>0", 
-                                     "d#varphi_{EMCale3} vs p_{T}", 
-                                     200, -0.1, 0.1, 30, 0., 3.)
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "dphi", "dphi vs pT: EMCalw0, charge>0",
+                        "d#varphi_{EMCale0} vs p_{T}", 200, -0.1, 0.1, 30, 0., 3.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "dphi", "dphi vs pT: EMCalw1, charge>0",
+                        "d#varphi_{EMCale1} vs p_{T}", 200, -0.1, 0.1, 30, 0., 3.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "dphi", "dphi vs pT: EMCalw2, charge>0",
+                        "d#varphi_{EMCale2} vs p_{T}", 200, -0.1, 0.1, 30, 0., 3.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "dphi", "dphi vs pT: EMCalw3, charge>0",
+                        "d#varphi_{EMCale3} vs p_{T}", 200, -0.1, 0.1, 30, 0., 3.)
       };
       /// emcdz vs pT distributions for (0-3) sectors in west arm for positive tracks
-      std::array<ROOT::TThreadedObject<TH2F>, 4> distrDZVsPTEMCalwPos
+      std::array<FlatHist<TH2F>, 4> distrDZVsPTEMCalwPos
       {
-         ROOT::TThreadedObject<TH2F>("dz vs pT: EMCalw0, charge>0", "dz_{EMCalw0} vs p_{T}", 
-                                     200, -50., 50., 30, 0., 3.),
-         ROOT::TThreadedObject<TH2F>("dz vs pT: EMCalw1, charge>0", "dz_{EMCalw1} vs p_{T}", 
-                                     200, -50., 50., 30, 0., 3.),
-         ROOT::TThreadedObject<TH2F>("dz vs pT: EMCalw2, charge>0", "dz_{EMCalw2} vs p_{T}", 
-                                     200, -50., 50., 30, 0., 3.),
-         ROOT::TThreadedObject<TH2F>("dz vs pT: EMCalw3, charge>0", "dz_{EMCalw3} vs p_{T}", 
-                                     200, -50., 50., 30, 0., 3.)
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "dz", "dz vs pT: EMCalw0, charge>0",
+                        "dz_{EMCalw0} vs p_{T}", 200, -50., 50., 30, 0., 3.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "dz", "dz vs pT: EMCalw1, charge>0",
+                        "dz_{EMCalw1} vs p_{T}", 200, -50., 50., 30, 0., 3.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "dz", "dz vs pT: EMCalw2, charge>0",
+                        "dz_{EMCalw2} vs p_{T}", 200, -50., 50., 30, 0., 3.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "dz", "dz vs pT: EMCalw3, charge>0",
+                        "dz_{EMCalw3} vs p_{T}", 200, -50., 50., 30, 0., 3.)
       };
       /// emcdphi vs pT distributions for (0-3) sectors in west arm for negative tracks
-      std::array<ROOT::TThreadedObject<TH2F>, 4> distrDPhiVsPTEMCalwNeg
+      std::array<FlatHist<TH2F>, 4> distrDPhiVsPTEMCalwNeg
       {
-         ROOT::TThreadedObject<TH2F>("dphi vs pT: EMCalw0, charge<0", 
-                                     "d#varphi_{EMCale0} vs p_{T}", 
-                                     200, -0.1, 0.1, 30, 0., 3.),
-         ROOT::TThreadedObject<TH2F>("dphi vs pT: EMCalw1, charge<0", 
-                                     "d#varphi_{EMCale1} vs p_{T}", 
-                                     200, -0.1, 0.1, 30, 0., 3.),
-         ROOT::TThreadedObject<TH2F>("dphi vs pT: EMCalw2, charge<0", 
-                                     "d#varphi_{EMCale2} vs p_{T}", 
-                                     200, -0.1, 0.1, 30, 0., 3.),
-         ROOT::TThreadedObject<TH2F>("dphi vs pT: EMCalw3, charge<0", 
-                                     "d#varphi_{EMCale3} vs p_{T}", 
-                                     200, -0.1, 0.1, 30, 0., 3.)
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "dphi", "dphi vs pT: EMCalw0, charge<0",
+                        "d#varphi_{EMCale0} vs p_{T}", 200, -0.1, 0.1, 30, 0., 3.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "dphi", "dphi vs pT: EMCalw1, charge<0",
+                        "d#varphi_{EMCale1} vs p_{T}", 200, -0.1, 0.1, 30, 0., 3.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "dphi", "dphi vs pT: EMCalw2, charge<0",
+                        "d#varphi_{EMCale2} vs p_{T}", 200, -0.1, 0.1, 30, 0., 3.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "dphi", "dphi vs pT: EMCalw3, charge<0",
+                        "d#varphi_{EMCale3} vs p_{T}", 200, -0.1, 0.1, 30, 0., 3.)
       };
       /// emcdz vs pT distributions for (0-3) sectors in west arm for negative tracks
-      std::array<ROOT::TThreadedObject<TH2F>, 4> distrDZVsPTEMCalwNeg
+      std::array<FlatHist<TH2F>, 4> distrDZVsPTEMCalwNeg
       {
-         ROOT::TThreadedObject<TH2F>("dz vs pT: EMCalw0, charge<0", "dz_{EMCalw0} vs p_{T}", 
-                                     200, -50., 50., 30, 0., 3.),
-         ROOT::TThreadedObject<TH2F>("dz vs pT: EMCalw1, charge<0", "dz_{EMCalw1} vs p_{T}", 
-                                     200, -50., 50., 30, 0., 3.),
-         ROOT::TThreadedObject<TH2F>("dz vs pT: EMCalw2, charge<0", "dz_{EMCalw2} vs p_{T}", 
-                                     200, -50., 50., 30, 0., 3.),
-         ROOT::TThreadedObject<TH2F>("dz vs pT: EMCalw3, charge<0", "dz_{EMCalw3} vs p_{T}", 
-                                     200, -50., 50., 30, 0., 3.)
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "dz", "dz vs pT: EMCalw0, charge<0",
+                        "dz_{EMCalw0} vs p_{T}", 200, -50., 50., 30, 0., 3.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "dz", "dz vs pT: EMCalw1, charge<0",
+                        "dz_{EMCalw1} vs p_{T}", 200, -50., 50., 30, 0., 3.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "dz", "dz vs pT: EMCalw2, charge<0",
+                        "dz_{EMCalw2} vs p_{T}", 200, -50., 50., 30, 0., 3.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "dz", "dz vs pT: EMCalw3, charge<0",
+                        "dz_{EMCalw3} vs p_{T}", 200, -50., 50., 30, 0., 3.)
       };
       /// pc2sdphi vs pT distribution for positive tracks
-      ROOT::TThreadedObject<TH2F> distrSDPhiVsPTPC2Pos
-         {"sdphi vs pT: PC2, charge>0", "sd#varphi_{PC2} vs p_{T}", 100, -5., 5., 20, 0., 10.};
+      FlatHist<TH2F> distrSDPhiVsPTPC2Pos{registry, HistRegistry::PC2, "sdphi",
+                                          "sdphi vs pT: PC2, charge>0", "sd#varphi_{PC2} vs p_{T}",
+                                          100, -5., 5., 20, 0., 10.};
       /// pc2sdz vs pT distribution for positive tracks
-      ROOT::TThreadedObject<TH2F> distrSDZVsPTPC2Pos
-         {"sdz vs pT: PC2, charge>0", "sdz_{PC2} vs p_{T}", 100, -5., 5., 20, 0., 10.};
+      FlatHist<TH2F> distrSDZVsPTPC2Pos{registry, HistRegistry::PC2, "sdz",
+                                        "sdz vs pT: PC2, charge>0", "sdz_{PC2} vs p_{T}", 100, -5.,
+                                        5., 20, 0., 10.};
       /// pc2sdphi vs pT distribution for negative tracks
-      ROOT::TThreadedObject<TH2F> distrSDPhiVsPTPC2Neg
-         {"sdphi vs pT: PC2, charge<0", "sd#varphi_{PC2} vs p_{T}", 100, -5., 5., 20, 0., 10.};
+      FlatHist<TH2F> distrSDPhiVsPTPC2Neg{registry, HistRegistry::PC2, "sdphi",
+                                          "sdphi vs pT: PC2, charge<0", "sd#varphi_{PC2} vs p_{T}",
+                                          100, -5., 5., 20, 0., 10.};
       /// pc2sdz vs pT distribution for negative tracks
-      ROOT::TThreadedObject<TH2F> distrSDZVsPTPC2Neg
-         {"sdz vs pT: PC2, charge<0", "sdz_{PC2} vs p_{T}", 100, -5., 5., 20, 0., 10.};
+      FlatHist<TH2F> distrSDZVsPTPC2Neg{registry, HistRegistry::PC2, "sdz",
+                                        "sdz vs pT: PC2, charge<0", "sdz_{PC2} vs p_{T}", 100, -5.,
+                                        5., 20, 0., 10.};
       /// pc3sdphi vs pT distribution for positive tracks for east arm
-      ROOT::TThreadedObject<TH2F> distrSDPhiVsPTPC3ePos
-         {"sdphi vs pT: PC3e, charge>0", "sd#varphi_{PC3e} vs p_{T}", 100, -5., 5., 20, 0., 10.};
+      FlatHist<TH2F> distrSDPhiVsPTPC3ePos{registry, HistRegistry::PC3, "sdphi",
+                                           "sdphi vs pT: PC3e, charge>0",
+                                           "sd#varphi_{PC3e} vs p_{T}", 100, -5., 5., 20, 0., 10.};
       /// pc3sdz vs pT distribution for positive tracks for east arm
-      ROOT::TThreadedObject<TH2F> distrSDZVsPTPC3ePos
-         {"sdz vs pT: PC3e, charge>0", "sdz_{PC3e} vs p_{T}", 100, -5., 5., 20, 0., 10.};
+      FlatHist<TH2F> distrSDZVsPTPC3ePos{registry, HistRegistry::PC3, "sdz",
+                                         "sdz vs pT: PC3e, charge>0", "sdz_{PC3e} vs p_{T}", 100,
+                                         -5., 5., 20, 0., 10.};
       /// pc3sdphi vs pT distribution for negative tracks for east arm
-      ROOT::TThreadedObject<TH2F> distrSDPhiVsPTPC3eNeg
-         {"sdphi vs pT: PC3e, charge<0", "sd#varphi_{PC3e} vs p_{T}", 100, -5., 5., 20, 0., 10.};
+      FlatHist<TH2F> distrSDPhiVsPTPC3eNeg{registry, HistRegistry::PC3, "sdphi",
+                                           "sdphi vs pT: PC3e, charge<0",
+                                           "sd#varphi_{PC3e} vs p_{T}", 100, -5., 5., 20, 0., 10.};
       /// pc3sdz vs pT distribution for negative tracks for east arm
-      ROOT::TThreadedObject<TH2F> distrSDZVsPTPC3eNeg
-         {"sdz vs pT: PC3e, charge<0", "sdz_{PC3e} vs p_{T}", 100, -5., 5., 20, 0., 10.};
+      FlatHist<TH2F> distrSDZVsPTPC3eNeg{registry, HistRegistry::PC3, "sdz",
+                                         "sdz vs pT: PC3e, charge<0", "sdz_{PC3e} vs p_{T}", 100,
+                                         -5., 5., 20, 0., 10.};
       /// pc3sdphi vs pT distribution for positive tracks for west arm
-      ROOT::TThreadedObject<TH2F> distrSDPhiVsPTPC3wPos
-         {"sdphi vs pT: PC3w, charge>0", "sd#varphi_{PC3w} vs p_{T}", 100, -5., 5., 20, 0., 10.};
+      FlatHist<TH2F> distrSDPhiVsPTPC3wPos{registry, HistRegistry::PC3, "sdphi",
+                                           "sdphi vs pT: PC3w, charge>0",
+                                           "sd#varphi_{PC3w} vs p_{T}", 100, -5., 5., 20, 0., 10.};
       /// pc3sdz vs pT distribution for positive tracks for west arm
-      ROOT::TThreadedObject<TH2F> distrSDZVsPTPC3wPos
-         {"sdz vs pT: PC3w, charge>0", "sdz_{PC3w} vs p_{T}", 100, -5., 5., 20, 0., 10.};
+      FlatHist<TH2F> distrSDZVsPTPC3wPos{registry, HistRegistry::PC3, "sdz",
+                                         "sdz vs pT: PC3w, charge>0", "sdz_{PC3w} vs p_{T}", 100,
+                                         -5., 5., 20, 0., 10.};
       /// pc3sdphi vs pT distribution for negative tracks for west arm
-      ROOT::TThreadedObject<TH2F> distrSDPhiVsPTPC3wNeg
-         {"sdphi vs pT: PC3w, charge<0", "sd#varphi_{PC3w} vs p_{T}", 100, -5., 5., 20, 0., 10.};
+      FlatHist<TH2F> distrSDPhiVsPTPC3wNeg{registry, HistRegistry::PC3, "sdphi",
+                                           "sdphi vs pT: PC3w, charge<0",
+                                           "sd#varphi_{PC3w} vs p_{T}", 100, -5., 5., 20, 0., 10.};
       /// pc3sdz vs pT distribution for negative tracks for west arm
-      ROOT::TThreadedObject<TH2F> distrSDZVsPTPC3wNeg
-         {"sdz vs pT: PC3w, charge<0", "sdz_{PC3w} vs p_{T}", 100, -5., 5., 20, 0., 10.};
+      FlatHist<TH2F> distrSDZVsPTPC3wNeg{registry, HistRegistry::PC3, "sdz",
+                                         "sdz vs pT: PC3w, charge<0", "sdz_{PC3w} vs p_{T}", 100,
+                                         -5., 5., 20, 0., 10.};
       /// tofsdphi vs pT distribution for positive tracks
-      ROOT::TThreadedObject<TH2F> distrSDPhiVsPTTOFePos
-         {"sdphi vs pT: TOFe, charge>0", "sd#varphi_{TOFe} vs p_{T}", 100, -5., 5., 20, 0., 10.};
+      FlatHist<TH2F> distrSDPhiVsPTTOFePos{registry, HistRegistry::TOFe, "sdphi",
+                                           "sdphi vs pT: TOFe, charge>0",
+                                           "sd#varphi_{TOFe} vs p_{T}", 100, -5., 5., 20, 0., 10.};
       /// tofsdz vs pT distribution for positive tracks
-      ROOT::TThreadedObject<TH2F> distrSDZVsPTTOFePos
-         {"sdz vs pT: TOFe, charge>0", "sdz_{TOFe} vs p_{T}", 100, -5., 5., 20, 0., 10.};
+      FlatHist<TH2F> distrSDZVsPTTOFePos{registry, HistRegistry::TOFe, "sdz",
+                                         "sdz vs pT: TOFe, charge>0", "sdz_{TOFe} vs p_{T}", 100,
+                                         -5., 5., 20, 0., 10.};
       /// tofsdphi vs pT distribution for negative tracks
-      ROOT::TThreadedObject<TH2F> distrSDPhiVsPTTOFeNeg
-         {"sdphi vs pT: TOFe, charge<0", "sd#varphi_{TOFe} vs p_{T}", 100, -5., 5., 20, 0., 10.};
+      FlatHist<TH2F> distrSDPhiVsPTTOFeNeg{registry, HistRegistry::TOFe, "sdphi",
+                                           "sdphi vs pT: TOFe, charge<0",
+                                           "sd#varphi_{TOFe} vs p_{T}", 100, -5., 5., 20, 0., 10.};
       /// tofsdz vs pT distribution for negative tracks
-      ROOT::TThreadedObject<TH2F> distrSDZVsPTTOFeNeg
-         {"sdz vs pT: TOFe, charge<0", "sdz_{TOFe} vs p_{T}", 100, -5., 5., 20, 0., 10.};
+      FlatHist<TH2F> distrSDZVsPTTOFeNeg{registry, HistRegistry::TOFe, "sdz",
+                                         "sdz vs pT: TOFe, charge<0", "sdz_{TOFe} vs p_{T}", 100,
+                                         -5., 5., 20, 0., 10.};
       /// tofwsdphi vs pT distribution for positive tracks
-      ROOT::TThreadedObject<TH2F> distrSDPhiVsPTTOFwPos
-         {"sdphi vs pT: TOFw, charge>0", "sd#varphi_{TOFw} vs p_{T}", 100, -5., 5., 20, 0., 10.};
+      FlatHist<TH2F> distrSDPhiVsPTTOFwPos{registry, HistRegistry::TOFw, "sdphi",
+                                           "sdphi vs pT: TOFw, charge>0",
+                                           "sd#varphi_{TOFw} vs p_{T}", 100, -5., 5., 20, 0., 10.};
       /// tofwsdz vs pT distribution for positive tracks
-      ROOT::TThreadedObject<TH2F> distrSDZVsPTTOFwPos
-         {"sdz vs pT: TOFw, charge>0", "sdz_{TOFw} vs p_{T}", 100, -5., 5., 20, 0., 10.};
+      FlatHist<TH2F> distrSDZVsPTTOFwPos{registry, HistRegistry::TOFw, "sdz",
+                                         "sdz vs pT: TOFw, charge>0", "sdz_{TOFw} vs p_{T}", 100,
+                                         -5., 5., 20, 0., 10.};
       /// tofwsdphi vs pT distribution for negative tracks
-      ROOT::TThreadedObject<TH2F> distrSDPhiVsPTTOFwNeg
-         {"sdphi vs pT: TOFw, charge<0", "sd#varphi_{TOFw} vs p_{T}", 100, -5., 5., 20, 0., 10.};
+      FlatHist<TH2F> distrSDPhiVsPTTOFwNeg{registry, HistRegistry::TOFw, "sdphi",
+                                           "sdphi vs pT: TOFw, charge<0",
+                                           "sd#varphi_{TOFw} vs p_{T}", 100, -5., 5., 20, 0., 10.};
       /// tofwsdz vs pT distribution for negative tracks
-      ROOT::TThreadedObject<TH2F> distrSDZVsPTTOFwNeg
-         {"sdz vs pT: TOFw, charge<0", "sdz_{TOFw} vs p_{T}", 100, -5., 5., 20, 0., 10.};
+      FlatHist<TH2F> distrSDZVsPTTOFwNeg{registry, HistRegistry::TOFw, "sdz",
+                                         "sdz vs pT: TOFw, charge<0", "sdz_{TOFw} vs p_{T}", 100,
+                                         -5., 5., 20, 0., 10.};
       /// emcsdphi vs pT distributions for (0-3) sectors in east arm for positive tracks
-      std::array<ROOT::TThreadedObject<TH2F>, 4> distrSDPhiVsPTEMCalePos
+      std::array<FlatHist<TH2F>, 4> distrSDPhiVsPTEMCalePos
       {
-         ROOT::TThreadedObject<TH2F>("sdphi vs pT: EMCale0, charge>0", 
-                                     "sd#varphi_{EMCale0} vs p_{T}", 100, -5., 5., 20, 0., 10.),
-         ROOT::TThreadedObject<TH2F>("sdphi vs pT: EMCale1, charge>0", 
-                                     "sd#varphi_{EMCale1} vs p_{T}", 100, -5., 5., 20, 0., 10.),
-         ROOT::TThreadedObject<TH2F>("sdphi vs pT: EMCale2, charge>0", 
-                                     "sd#varphi_{EMCale2} vs p_{T}", 100, -5., 5., 20, 0., 10.),
-         ROOT::TThreadedObject<TH2F>("sdphi vs pT: EMCale3, charge>0", 
-                                     "sd#varphi_{EMCale3} vs p_{T}", 100, -5., 5., 20, 0., 10.)
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "sdphi", "sdphi vs pT: EMCale0, charge>0",
+                        "sd#varphi_{EMCale0} vs p_{T}", 100, -5., 5., 20, 0., 10.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "sdphi", "sdphi vs pT: EMCale1, charge>0",
+                        "sd#varphi_{EMCale1} vs p_{T}", 100, -5., 5., 20, 0., 10.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "sdphi", "sdphi vs pT: EMCale2, charge>0",
+                        "sd#varphi_{EMCale2} vs p_{T}", 100, -5., 5., 20, 0., 10.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "sdphi", "sdphi vs pT: EMCale3, charge>0",
+                        "sd#varphi_{EMCale3} vs p_{T}", 100, -5., 5., 20, 0., 10.)
       };
       /// emcsdz vs pT distributions for (0-3) sectors in east arm for positive tracks
-      std::array<ROOT::TThreadedObject<TH2F>, 4> distrSDZVsPTEMCalePos
+      std::array<FlatHist<TH2F>, 4> distrSDZVsPTEMCalePos
       {
-         ROOT::TThreadedObject<TH2F>("sdz vs pT: EMCale0, charge>0", "sdz_{EMCale0} vs p_{T}", 
-                                     100, -5., 5., 20, 0., 10.),
-         ROOT::TThreadedObject<TH2F>("sdz vs pT: EMCale1, charge>0", "sdz_{EMCale1} vs p_{T}", 
-                                     100, -5., 5., 20, 0., 10.),
-         ROOT::TThreadedObject<TH2F>("sdz vs pT: EMCale2, charge>0", "sdz_{EMCale2} vs p_{T}", 
-                                     100, -5., 5., 20, 0., 10.),
-         ROOT::TThreadedObject<TH2F>("sdz vs pT: EMCale3, charge>0", "sdz_{EMCale3} vs p_{T}", 
-                                     100, -5., 5., 20, 0., 10.)
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "sdz", "sdz vs pT: EMCale0, charge>0",
+                        "sdz_{EMCale0} vs p_{T}", 100, -5., 5., 20, 0., 10.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "sdz", "sdz vs pT: EMCale1, charge>0",
+                        "sdz_{EMCale1} vs p_{T}", 100, -5., 5., 20, 0., 10.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "sdz", "sdz vs pT: EMCale2, charge>0",
+                        "sdz_{EMCale2} vs p_{T}", 100, -5., 5., 20, 0., 10.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "sdz", "sdz vs pT: EMCale3, charge>0",
+                        "sdz_{EMCale3} vs p_{T}", 100, -5., 5., 20, 0., 10.)
       };
       /// emcsdphi vs pT distributions for (0-3) sectors in east arm for negative tracks
-      std::array<ROOT::TThreadedObject<TH2F>, 4> distrSDPhiVsPTEMCaleNeg
+      std::array<FlatHist<TH2F>, 4> distrSDPhiVsPTEMCaleNeg
       {
-         ROOT::TThreadedObject<TH2F>("sdphi vs pT: EMCale0, charge<0", 
-                                     "sd#varphi_{EMCale0} vs p_{T}", 100, -5., 5., 20, 0., 10.),
-         ROOT::TThreadedObject<TH2F>("sdphi vs pT: EMCale1, charge<0", 
-                                     "sd#varphi_{EMCale1} vs p_{T}", 100, -5., 5., 20, 0., 10.),
-         ROOT::TThreadedObject<TH2F>("sdphi vs pT: EMCale2, charge<0", 
-                                     "sd#varphi_{EMCale2} vs p_{T}", 100, -5., 5., 20, 0., 10.),
-         ROOT::TThreadedObject<TH2F>("sdphi vs pT: EMCale3, charge<0", 
-                                     "sd#varphi_{EMCale3} vs p_{T}", 100, -5., 5., 20, 0., 10.)
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "sdphi", "sdphi vs pT: EMCale0, charge<0",
+                        "sd#varphi_{EMCale0} vs p_{T}", 100, -5., 5., 20, 0., 10.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "sdphi", "sdphi vs pT: EMCale1, charge<0",
+                        "sd#varphi_{EMCale1} vs p_{T}", 100, -5., 5., 20, 0., 10.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "sdphi", "sdphi vs pT: EMCale2, charge<0",
+                        "sd#varphi_{EMCale2} vs p_{T}", 100, -5., 5., 20, 0., 10.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "sdphi", "sdphi vs pT: EMCale3, charge<0",
+                        "sd#varphi_{EMCale3} vs p_{T}", 100, -5., 5., 20, 0., 10.)
       };
       /// emcsdz vs pT distributions for (0-3) sectors in east arm for negative tracks
-      std::array<ROOT::TThreadedObject<TH2F>, 4> distrSDZVsPTEMCaleNeg
+      std::array<FlatHist<TH2F>, 4> distrSDZVsPTEMCaleNeg
       {
-         ROOT::TThreadedObject<TH2F>("sdz vs pT: EMCale0, charge<0", "sdz_{EMCale0} vs p_{T}", 
-                                     100, -5., 5., 20, 0., 10.),
-         ROOT::TThreadedObject<TH2F>("sdz vs pT: EMCale1, charge<0", "sdz_{EMCale1} vs p_{T}", 
-                                     100, -5., 5., 20, 0., 10.),
-         ROOT::TThreadedObject<TH2F>("sdz vs pT: EMCale2, charge<0", "sdz_{EMCale2} vs p_{T}", 
-                                     100, -5., 5., 20, 0., 10.),
-         ROOT::TThreadedObject<TH2F>("sdz vs pT: EMCale3, charge<0", "sdz_{EMCale3} vs p_{T}", 
-                                     100, -5., 5., 20, 0., 10.)
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "sdz", "sdz vs pT: EMCale0, charge<0",
+                        "sdz_{EMCale0} vs p_{T}", 100, -5., 5., 20, 0., 10.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "sdz", "sdz vs pT: EMCale1, charge<0",
+                        "sdz_{EMCale1} vs p_{T}", 100, -5., 5., 20, 0., 10.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "sdz", "sdz vs pT: EMCale2, charge<0",
+                        "sdz_{EMCale2} vs p_{T}", 100, -5., 5., 20, 0., 10.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "sdz", "sdz vs pT: EMCale3, charge<0",
+                        "sdz_{EMCale3} vs p_{T}", 100, -5., 5., 20, 0., 10.)
       };
       /// emcsdphi vs pT distributions for (0-3) sectors in west arm for positive tracks
-      std::array<ROOT::TThreadedObject<TH2F>, 4> distrSDPhiVsPTEMCalwPos
+      std::array<FlatHist<TH2F>, 4> distrSDPhiVsPTEMCalwPos
       {
-         ROOT::TThreadedObject<TH2F>("sdphi vs pT: EMCalw0, charge>0", 
-                                     "sd#varphi_{EMCale0} vs p_{T}", 100, -5., 5., 20, 0., 10.),
-         ROOT::TThreadedObject<TH2F>("sdphi vs pT: EMCalw1, charge>0", 
-                                     "sd#varphi_{EMCale1} vs p_{T}", 100, -5., 5., 20, 0., 10.),
-         ROOT::TThreadedObject<TH2F>("sdphi vs pT: EMCalw2, charge>0", 
-                                     "sd#varphi_{EMCale2} vs p_{T}", 100, -5., 5., 20, 0., 10.),
-         ROOT::TThreadedObject<TH2F>("sdphi vs pT: EMCalw3, charge>0", 
-                                     "sd#varphi_{EMCale3} vs p_{T}", 100, -5., 5., 20, 0., 10.)
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "sdphi", "sdphi vs pT: EMCalw0, charge>0",
+                        "sd#varphi_{EMCale0} vs p_{T}", 100, -5., 5., 20, 0., 10.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "sdphi", "sdphi vs pT: EMCalw1, charge>0",
+                        "sd#varphi_{EMCale1} vs p_{T}", 100, -5., 5., 20, 0., 10.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "sdphi", "sdphi vs pT: EMCalw2, charge>0",
+                        "sd#varphi_{EMCale2} vs p_{T}", 100, -5., 5., 20, 0., 10.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "sdphi", "sdphi vs pT: EMCalw3, charge>0",
+                        "sd#varphi_{EMCale3} vs p_{T}", 100, -5., 5., 20, 0., 10.)
       };
       /// emcsdz vs pT distributions for (0-3) sectors in west arm for positive tracks
-      std::array<ROOT::TThreadedObject<TH2F>, 4> distrSDZVsPTEMCalwPos
+      std::array<FlatHist<TH2F>, 4> distrSDZVsPTEMCalwPos
       {
-         ROOT::TThreadedObject<TH2F>("sdz vs pT: EMCalw0, charge>0", "sdz_{EMCalw0} vs p_{T}", 
-                                     100, -5., 5., 20, 0., 10.),
-         ROOT::TThreadedObject<TH2F>("sdz vs pT: EMCalw1, charge>0", "sdz_{EMCalw1} vs p_{T}", 
-                                     100, -5., 5., 20, 0., 10.),
-         ROOT::TThreadedObject<TH2F>("sdz vs pT: EMCalw2, charge>0", "sdz_{EMCalw2} vs p_{T}", 
-                                     100, -5., 5., 20, 0., 10.),
-         ROOT::TThreadedObject<TH2F>("sdz vs pT: EMCalw3, charge>0", "sdz_{EMCalw3} vs p_{T}", 
-                                     100, -5., 5., 20, 0., 10.)
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "sdz", "sdz vs pT: EMCalw0, charge>0",
+                        "sdz_{EMCalw0} vs p_{T}", 100, -5., 5., 20, 0., 10.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "sdz", "sdz vs pT: EMCalw1, charge>0",
+                        "sdz_{EMCalw1} vs p_{T}", 100, -5., 5., 20, 0., 10.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "sdz", "sdz vs pT: EMCalw2, charge>0",
+                        "sdz_{EMCalw2} vs p_{T}", 100, -5., 5., 20, 0., 10.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "sdz", "sdz vs pT: EMCalw3, charge>0",
+                        "sdz_{EMCalw3} vs p_{T}", 100, -5., 5., 20, 0., 10.)
       };
       /// emcsdphi vs pT distributions for (0-3) sectors in west arm for negative tracks
-      std::array<ROOT::TThreadedObject<TH2F>, 4> distrSDPhiVsPTEMCalwNeg
+      std::array<FlatHist<TH2F>, 4> distrSDPhiVsPTEMCalwNeg
       {
-         ROOT::TThreadedObject<TH2F>("sdphi vs pT: EMCalw0, charge<0", 
-                                     "sd#varphi_{EMCale0} vs p_{T}", 100, -5., 5., 20, 0., 10.),
-         ROOT::TThreadedObject<TH2F>("sdphi vs pT: EMCalw1, charge<0", 
-                                     "sd#varphi_{EMCale1} vs p_{T}", 100, -5., 5., 20, 0., 10.),
-         ROOT::TThreadedObject<TH2F>("sdphi vs pT: EMCalw2, charge<0", 
-                                     "sd#varphi_{EMCale2} vs p_{T}", 100, -5., 5., 20, 0., 10.),
-         ROOT::TThreadedObject<TH2F>("sdphi vs pT: EMCalw3, charge<0", 
-                                     "sd#varphi_{EMCale3} vs p_{T}", 100, -5., 5., 20, 0., 10.)
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "sdphi", "sdphi vs pT: EMCalw0, charge<0",
+                        "sd#varphi_{EMCale0} vs p_{T}", 100, -5., 5., 20, 0., 10.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "sdphi", "sdphi vs pT: EMCalw1, charge<0",
+                        "sd#varphi_{EMCale1} vs p_{T}", 100, -5., 5., 20, 0., 10.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "sdphi", "sdphi vs pT: EMCalw2, charge<0",
+                        "sd#varphi_{EMCale2} vs p_{T}", 100, -5., 5., 20, 0., 10.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "sdphi", "sdphi vs pT: EMCalw3, charge<0",
+                        "sd#varphi_{EMCale3} vs p_{T}", 100, -5., 5., 20, 0., 10.)
       };
       /// emcsdz vs pT distributions for (0-3) sectors in west arm for negative tracks
-      std::array<ROOT::TThreadedObject<TH2F>, 4> distrSDZVsPTEMCalwNeg
+      std::array<FlatHist<TH2F>, 4> distrSDZVsPTEMCalwNeg
       {
-         ROOT::TThreadedObject<TH2F>("sdz vs pT: EMCalw0, charge<0", "sdz_{EMCalw0} vs p_{T}", 
-                                     100, -5., 5., 20, 0., 10.),
-         ROOT::TThreadedObject<TH2F>("sdz vs pT: EMCalw1, charge<0", "sdz_{EMCalw1} vs p_{T}", 
-                                     100, -5., 5., 20, 0., 10.),
-         ROOT::TThreadedObject<TH2F>("sdz vs pT: EMCalw2, charge<0", "sdz_{EMCalw2} vs p_{T}", 
-                                     100, -5., 5., 20, 0., 10.),
-         ROOT::TThreadedObject<TH2F>("sdz vs pT: EMCalw3, charge<0", "sdz_{EMCalw3} vs p_{T}", 
-                                     100, -5., 5., 20, 0., 10.)
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "sdz", "sdz vs pT: EMCalw0, charge<0",
+                        "sdz_{EMCalw0} vs p_{T}", 100, -5., 5., 20, 0., 10.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "sdz", "sdz vs pT: EMCalw1, charge<0",
+                        "sdz_{EMCalw1} vs p_{T}", 100, -5., 5., 20, 0., 10.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "sdz", "sdz vs pT: EMCalw2, charge<0",
+                        "sdz_{EMCalw2} vs p_{T}", 100, -5., 5., 20, 0., 10.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "sdz", "sdz vs pT: EMCalw3, charge<0",
+                        "sdz_{EMCalw3} vs p_{T}", 100, -5., 5., 20, 0., 10.)
       };
       /// TOFe t-t_{exp}^{pi} distribution
-      ROOT::TThreadedObject<TH2F> distrTTOFe{"t - t_exp^pi, TOFe", "t - t_{exp}^{#pi^{+}} vs p_{T}",
-                                             1000., -20., 20., 20, 0., 10.};
+      FlatHist<TH2F> distrTTOFe{registry, HistRegistry::TOFe, "", "t - t_exp^pi, TOFe",
+                                "t - t_{exp}^{#pi^{+}} vs p_{T}", 1000., -20., 20., 20, 0., 10.};
       /// TOFw t-t_{exp}^{pi} distribution
-      ROOT::TThreadedObject<TH2F> distrTTOFw{"t - t_exp^pi, TOFw", "t - t_{exp}^{#pi^{+}} vs p_{T}",
-                                             1000., -20., 20., 20, 0., 10.};
+      FlatHist<TH2F> distrTTOFw{registry, HistRegistry::TOFw, "", "t - t_exp^pi, TOFw",
+                                "t - t_{exp}^{#pi^{+}} vs p_{T}", 1000., -20., 20., 20, 0., 10.};
       /// EMCale(0-3) t-t_{exp}^{pi} distributions
-      std::array<ROOT::TThreadedObject<TH2F>, 4> distrTEMCale
+      std::array<FlatHist<TH2F>, 4> distrTEMCale
       {
-         ROOT::TThreadedObject<TH2F>("t - t_exp^pi, EMCale0", "t - t_{exp}^{#pi^{+}} vs p_{T}", 
-                                     1000., -40., 40., 20, 0., 10.),
-         ROOT::TThreadedObject<TH2F>("t - t_exp^pi, EMCale1", "t - t_{exp}^{#pi^{+}} vs p_{T}", 
-                                     1000., -40., 40., 20, 0., 10.),
-         ROOT::TThreadedObject<TH2F>("t - t_exp^pi, EMCale2", "t - t_{exp}^{#pi^{+}} vs p_{T}", 
-                                     1000., -40., 40., 20, 0., 10.),
-         ROOT::TThreadedObject<TH2F>("t - t_exp^pi, EMCale3", "t - t_{exp}^{#pi^{+}} vs p_{T}", 
-                                     1000., -40., 40., 20, 0., 10.)
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "t - t_exp^pi, EMCale0",
+                        "t - t_{exp}^{#pi^{+}} vs p_{T}", 1000., -40., 40., 20, 0., 10.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "t - t_exp^pi, EMCale1",
+                        "t - t_{exp}^{#pi^{+}} vs p_{T}", 1000., -40., 40., 20, 0., 10.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "t - t_exp^pi, EMCale2",
+                        "t - t_{exp}^{#pi^{+}} vs p_{T}", 1000., -40., 40., 20, 0., 10.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "t - t_exp^pi, EMCale3",
+                        "t - t_{exp}^{#pi^{+}} vs p_{T}", 1000., -40., 40., 20, 0., 10.)
       };
       /// EMCalw(0-3) t-t_{exp}^{pi} distributions
-      std::array<ROOT::TThreadedObject<TH2F>, 4> distrTEMCalw
+      std::array<FlatHist<TH2F>, 4> distrTEMCalw
       {
-         ROOT::TThreadedObject<TH2F>("t - t_exp^pi, EMCalw0", "t - t_{exp}^{#pi^{+}} vs p_{T}", 
-                                     1000., -40., 40., 20, 0., 10.),
-         ROOT::TThreadedObject<TH2F>("t - t_exp^pi, EMCalw1", "t - t_{exp}^{#pi^{+}} vs p_{T}", 
-                                     1000., -40., 40., 20, 0., 10.),
-         ROOT::TThreadedObject<TH2F>("t - t_exp^pi, EMCalw2", "t - t_{exp}^{#pi^{+}} vs p_{T}", 
-                                     1000., -40., 40., 20, 0., 10.),
-         ROOT::TThreadedObject<TH2F>("t - t_exp^pi, EMCalw3", "t - t_{exp}^{#pi^{+}} vs p_{T}", 
-                                     1000., -40., 40., 20, 0., 10.)
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "t - t_exp^pi, EMCalw0",
+                        "t - t_{exp}^{#pi^{+}} vs p_{T}", 1000., -40., 40., 20, 0., 10.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "t - t_exp^pi, EMCalw1",
+                        "t - t_{exp}^{#pi^{+}} vs p_{T}", 1000., -40., 40., 20, 0., 10.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "t - t_exp^pi, EMCalw2",
+                        "t - t_{exp}^{#pi^{+}} vs p_{T}", 1000., -40., 40., 20, 0., 10.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "t - t_exp^pi, EMCalw3",
+                        "t - t_{exp}^{#pi^{+}} vs p_{T}", 1000., -40., 40., 20, 0., 10.)
       };
       /// TOFe m2 distribution for positive tracks
-      ROOT::TThreadedObject<TH2F> distrM2TOFePosCharge{"m2, TOFe, charge>0", "m^{2} vs p_{T}",
-                                                       500, -0.2, 1.5, 100, 0., 10.};
+      FlatHist<TH2F> distrM2TOFePosCharge{registry, HistRegistry::TOFe, "", "m2, TOFe, charge>0",
+                                          "m^{2} vs p_{T}", 500, -0.2, 1.5, 100, 0., 10.};
       /// TOFe m2 distribution for negative tracks
-      ROOT::TThreadedObject<TH2F> distrM2TOFeNegCharge{"m2, TOFe, charge<0", "m^{2} vs p_{T}",
-                                                       500, -0.2, 1.5, 100, 0., 10.};
+      FlatHist<TH2F> distrM2TOFeNegCharge{registry, HistRegistry::TOFe, "", "m2, TOFe, charge<0",
+                                          "m^{2} vs p_{T}", 500, -0.2, 1.5, 100, 0., 10.};
       /// TOFw m2 distribution for positive tracks
-      ROOT::TThreadedObject<TH2F> distrM2TOFwPosCharge{"m2, TOFw, charge>0", "m^{2} vs p_{T}",
-                                                       500, -0.2, 1.5, 100, 0., 10.};
+      FlatHist<TH2F> distrM2TOFwPosCharge{registry, HistRegistry::TOFw, "", "m2, TOFw, charge>0",
+                                          "m^{2} vs p_{T}", 500, -0.2, 1.5, 100, 0., 10.};
       /// TOFw m2 distribution for negative tracks
-      ROOT::TThreadedObject<TH2F> distrM2TOFwNegCharge{"m2, TOFw, charge<0", "m^{2} vs p_{T}",
-                                                       500, -0.2, 1.5, 100, 0., 10.};
+      FlatHist<TH2F> distrM2TOFwNegCharge{registry, HistRegistry::TOFw, "", "m2, TOFw, charge<0",
+                                          "m^{2} vs p_{T}", 500, -0.2, 1.5, 100, 0., 10.};
       /// EMCale(0-3) m2 distributions for positive tracks
-      std::array<ROOT::TThreadedObject<TH2F>, 4> distrM2EMCalePosCharge
+      std::array<FlatHist<TH2F>, 4> distrM2EMCalePosCharge
       {
-         ROOT::TThreadedObject<TH2F>("m2, EMCale0, charge>0", "m^{2} vs p_{T}", 
-                                     250, -0.5, 2.0, 100, 0., 10.),
-         ROOT::TThreadedObject<TH2F>("m2, EMCale1, charge>0", "m^{2} vs p_{T}", 
-                                     250, -0.5, 2.0, 100, 0., 10.),
-         ROOT::TThreadedObject<TH2F>("m2, EMCale2, charge>0", "m^{2} vs p_{T}", 
-                                     250, -0.5, 2.0, 100, 0., 10.),
-         ROOT::TThreadedObject<TH2F>("m2, EMCale3, charge>0", "m^{2} vs p_{T}", 
-                                     250, -0.5, 2.0, 100, 0., 10.)
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "m2, EMCale0, charge>0",
+                        "m^{2} vs p_{T}", 250, -0.5, 2.0, 100, 0., 10.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "m2, EMCale1, charge>0",
+                        "m^{2} vs p_{T}", 250, -0.5, 2.0, 100, 0., 10.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "m2, EMCale2, charge>0",
+                        "m^{2} vs p_{T}", 250, -0.5, 2.0, 100, 0., 10.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "m2, EMCale3, charge>0",
+                        "m^{2} vs p_{T}", 250, -0.5, 2.0, 100, 0., 10.)
       };
       /// EMCale(0-3) m2 distributions for negative tracks
-      std::array<ROOT::TThreadedObject<TH2F>, 4> distrM2EMCaleNegCharge
+      std::array<FlatHist<TH2F>, 4> distrM2EMCaleNegCharge
       {
-         ROOT::TThreadedObject<TH2F>("m2, EMCale0, charge<0", "p_{T} vs m^{2}", 
-                                     250, -0.5, 2.0, 100, 0., 10.),
-         ROOT::TThreadedObject<TH2F>("m2, EMCale1, charge<0", "p_{T} vs m^{2}", 
-                                     250, -0.5, 2.0, 100, 0., 10.),
-         ROOT::TThreadedObject<TH2F>("m2, EMCale2, charge<0", "p_{T} vs m^{2}", 
-                                     250, -0.5, 2.0, 100, 0., 10.),
-         ROOT::TThreadedObject<TH2F>("m2, EMCale3, charge<0", "p_{T} vs m^{2}", 
-                                     250, -0.5, 2.0, 100, 0., 10.)
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "m2, EMCale0, charge<0",
+                        "p_{T} vs m^{2}", 250, -0.5, 2.0, 100, 0., 10.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "m2, EMCale1, charge<0",
+                        "p_{T} vs m^{2}", 250, -0.5, 2.0, 100, 0., 10.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "m2, EMCale2, charge<0",
+                        "p_{T} vs m^{2}", 250, -0.5, 2.0, 100, 0., 10.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "m2, EMCale3, charge<0",
+                        "p_{T} vs m^{2}", 250, -0.5, 2.0, 100, 0., 10.)
       };
       /// EMCalw(0-3) m2 distributions for positive tracks
-      std::array<ROOT::TThreadedObject<TH2F>, 4> distrM2EMCalwPosCharge
+      std::array<FlatHist<TH2F>, 4> distrM2EMCalwPosCharge
       {
-         ROOT::TThreadedObject<TH2F>("m2, EMCalw0, charge>0", "p_{T} vs m^{2}", 
-                                     250, -0.5, 2.0, 100, 0., 10.),
-         ROOT::TThreadedObject<TH2F>("m2, EMCalw1, charge>0", "p_{T} vs m^{2}", 
-                                     250, -0.5, 2.0, 100, 0., 10.),
-         ROOT::TThreadedObject<TH2F>("m2, EMCalw2, charge>0", "p_{T} vs m^{2}", 
-                                     250, -0.5, 2.0, 100, 0., 10.),
-         ROOT::TThreadedObject<TH2F>("m2, EMCalw3, charge>0", "p_{T} vs m^{2}", 
-                                     250, -0.5, 2.0, 100, 0., 10.)
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "m2, EMCalw0, charge>0",
+                        "p_{T} vs m^{2}", 250, -0.5, 2.0, 100, 0., 10.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "m2, EMCalw1, charge>0",
+                        "p_{T} vs m^{2}", 250, -0.5, 2.0, 100, 0., 10.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "m2, EMCalw2, charge>0",
+                        "p_{T} vs m^{2}", 250, -0.5, 2.0, 100, 0., 10.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "m2, EMCalw3, charge>0",
+                        "p_{T} vs m^{2}", 250, -0.5, 2.0, 100, 0., 10.)
       };
       /// EMCalw(0-3) m2 distributions for negative tracks
-      std::array<ROOT::TThreadedObject<TH2F>, 4> distrM2EMCalwNegCharge
+      std::array<FlatHist<TH2F>, 4> distrM2EMCalwNegCharge
       {
-         ROOT::TThreadedObject<TH2F>("m2, EMCalw0, charge<0", "p_{T} vs m^{2}", 
-                                     250, -0.5, 2.0, 100, 0., 10.),
-         ROOT::TThreadedObject<TH2F>("m2, EMCalw1, charge<0", "p_{T} vs m^{2}", 
-                                     250, -0.5, 2.0, 100, 0., 10.),
-         ROOT::TThreadedObject<TH2F>("m2, EMCalw2, charge<0", "p_{T} vs m^{2}", 
-                                     250, -0.5, 2.0, 100, 0., 10.),
-         ROOT::TThreadedObject<TH2F>("m2, EMCalw3, charge<0", "p_{T} vs m^{2}", 
-                                     250, -0.5, 2.0, 100, 0., 10.)
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "m2, EMCalw0, charge<0",
+                        "p_{T} vs m^{2}", 250, -0.5, 2.0, 100, 0., 10.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "m2, EMCalw1, charge<0",
+                        "p_{T} vs m^{2}", 250, -0.5, 2.0, 100, 0., 10.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "m2, EMCalw2, charge<0",
+                        "p_{T} vs m^{2}", 250, -0.5, 2.0, 100, 0., 10.),
+         FlatHist<TH2F>(registry, HistRegistry::EMCal, "", "m2, EMCalw3, charge<0",
+                        "p_{T} vs m^{2}", 250, -0.5, 2.0, 100, 0., 10.)
       };
       /// NoPID invariant mass distribution
-      ROOT::TThreadedObject<TH2F> distrMInvNoPID{"M_inv: NoPID", "M_{inv} vs p_{T}", 
-                                                 200, 0., 20., 1000, 0., 5.};
+      FlatHist<TH2F> distrMInvNoPID{registry, HistRegistry::ANY, "", "M_inv: NoPID",
+                                    "M_{inv} vs p_{T}", 200, 0., 20., 1000, 0., 5.};
       /// NoPID invariant mass distribution without ghost cuts on detectors
-      ROOT::TThreadedObject<TH2F> distrMInvNoPIDNoGhost{"M_inv: NoPID, no ghost", "M_{inv} vs p_{T}", 
-                                                        200, 0., 20., 1000, 0., 5.};
+      FlatHist<TH2F> distrMInvNoPIDNoGhost{registry, HistRegistry::ANY, "",
+                                           "M_inv: NoPID, no ghost", "M_{inv} vs p_{T}", 200, 0.,
+                                           20., 1000, 0., 5.};
    };
+   /// container that provides each thread with its own HistContainer and merges them on write
+   using ThrContainer = ThrHistContainer<HistContainer>;
 
-   /* @brief Processes the single configuration (for the given particle, 
-    * magnetic field, and pT range) from one file
+   /* @struct Configuration
+    * @brief Parameters of the single configuration (for the given particle, 
+    * magnetic field, and pT range) that are needed to process the events from its file
+    */
+   struct Configuration
+   {
+      /// name of the file with the simulated tree
+      std::string simInputFileName;
+      /// name of the file with the track cache
+      std::string trackCacheFileName;
+      /// id of the simulated particle
+      int particleId;
+      /// GEANT id of the simulated particle
+      int particleGeantId;
+      /// normalization of the number of particles to the number of events
+      double eventNormWeight;
+      /// weight function for spectra
+      std::unique_ptr<TF1> weightFunc;
+      /// writer of the track cache (only created if trackCacheMode is write)
+      std::unique_ptr<SimTrackCacheWriter> trackCacheWriter;
+      /// shows whether the sidecar index of the file exists
+      bool isIndexed = false;
+      /// entries that pass the event level cuts (only filled if the sidecar index exists)
+      std::vector<unsigned long> selectedEntries;
+   };
+   /* @brief Sets the parameters of the single configuration (for the given particle, 
+    * magnetic field, and pT range); events that are rejected by the sidecar index 
+    * of the file are written in thrContainer
     *
+    * @param[out] configuration parameters of the configuration
     * @param[in] thrContainer the current ThrContainer in which the data will be written to 
-    * @param[in] particleName name of the particle to be analyzed 
+    * @param[in] particleId id of the particle to be analyzed 
     * @param[in] magneticFieldName name of the magnetic field to be analyzed 
     * @param[in] pTRangeName name of the pT range to be analyzed 
     */
-   void AnalyzeConfiguration(ThrContainer& thrContainer, const int particleId, 
-                             const std::string& magneticFieldName, const std::string& pTRangeName); 
+   void SetConfiguration(Configuration& configuration, ThrContainer& thrContainer, 
+                         const int particleId, const std::string& magneticFieldName, 
+                         const std::string& pTRangeName); 
+   /* @brief Processes the events of one task from the file of the configuration
+    *
+    * @param[in] simCNT reader that iterates over the events of the task
+    * @param[in] thrContainer the current ThrContainer in which the data will be written to 
+    * @param[in] configuration parameters of the configuration the file of which is processed
+    */
+   void ProcessTask(SimTreeReader& simCNT, ThrContainer& thrContainer, 
+                    const Configuration& configuration);
+   /* @brief Processes the configuration from the track cache without reading the simulated tree
+    *
+    * @param[in] thrContainer the current ThrContainer in which the data will be written to 
+    * @param[in] configuration parameters of the configuration
+    */
+   void ReplayConfiguration(ThrContainer& thrContainer, const Configuration& configuration);
+   /* @brief Sets the raw and derived (pT, DC board, sigmalized residuals, 
+    * dead map flags, etc.) quantities of the track from the event snapshot
+    *
+    * @param[out] track track to be set
+    * @param[in] simEvent snapshot of the current event
+    * @param[in] i index of the track in the event
+    * @param[in] particleGeantId GEANT id of the simulated particle
+    */
+   void SetSimTrack(SimTrack& track, const SimEventSnapshot& simEvent, 
+                    const int i, const int particleGeantId);
+   /* @brief Fills all histograms for the event and its tracks
+    *
+    * @param[in] histContainer container in which the histograms are filled
+    * @param[in] particleId id of the simulated particle
+    * @param[in] origPT original pT of the simulated particle
+    * @param[in] eventWeight weight of the event
+    * @param[in] tracks tracks of the event that passed the track preselection
+    * @param[in] numberOfTracks number of tracks
+    */
+   void ProcessEvent(HistContainer& histContainer, const int particleId, 
+                     const double origPT, const double eventWeight, 
+                     const SimTrack *tracks, const unsigned long numberOfTracks);
+   /* @brief Fills all single track histograms for the track and adds it 
+    * to the list of positive or negative tracks if it was registered in any detector
+    *
+    * @param[in] histContainer container in which the histograms are filled
+    * @param[in] track track to be processed
+    * @param[in] particleId id of the simulated particle
+    * @param[in] origPT original pT of the simulated particle
+    * @param[in] eventWeight weight of the event
+    * @param[out] positiveTracks list of positive tracks of the event
+    * @param[out] negativeTracks list of negative tracks of the event
+    */
+   void ProcessTrack(HistContainer& histContainer, const SimTrack& track, 
+                     const int particleId, const double origPT, const double eventWeight, 
+                     std::vector<ChargedTrack>& positiveTracks, 
+                     std::vector<ChargedTrack>& negativeTracks);
 }
 
 #endif /* ANALYZE_SIM_SINGLE_TRACK_HPP */
@@ -9,7 +9,9 @@
 #ifndef ANALYZE_SIM_WIDTLESS_RESONANCE_HPP
 #define ANALYZE_SIM_WIDTLESS_RESONANCE_HPP
 
+#include <atomic>
 #include <thread>
+#include <algorithm>
 
 #include "TF1.h"
 #include "TH1.h"
@@ -30,8 +32,10 @@
 #include "SingleTrackFunc.hpp"
 #include "PairTrackFunc.hpp"
 #include "SimTreeReader.hpp"
+#include "SimTreeIndex.hpp"
 #include "DeadMapCutter.hpp"
 #include "SimSigmalizedResiduals.hpp"
+#include "ProgressMonitor.hpp"
 
 #include "PBar.hpp"
 
@@ -68,8 +72,27 @@ namespace AnalyzeSimWidthlessResonance
    int numberOfThreads;
    /// number of events across all trees
    unsigned long numberOfEvents = 0;
-   /// parameter for monitoring the progress
-   unsigned long numberOfCalls = 0;
+   /// counters of processed events, tracks, and read bytes for monitoring the progress
+   ProgressMonitor progress;
+   /// names of all simulated trees that will be analyzed in the order they are processed
+   std::vector<std::string> simInputFileNames;
+   /// size of TTreeCache as a factor of the cluster size of simulated trees
+   double treeCacheSizeFactor;
+   /// number of entries TTreeCache learns which branches are read
+   int treeCacheLearnEntries;
+   /// shows whether the baskets of simulated trees are prefetched asynchronously
+   bool asyncPrefetching;
+   /// shows whether the next file in the queue is prefetched while the current one is processed
+   bool prefetchNextFile;
+   /// branches of simulated trees that are read (other branches are never activated)
+   const std::vector<std::string> simTreeBranches = 
+   {
+      "mom_orig", "nch", "bbcz", "dcarm", "phi", "alpha", "zed", "mom", "the0", "phi0",
+      "qual", "charge", "ttof", "pltof", "ppc1x", "ppc1y", "ppc1z", "ppc2x", "ppc2y", "ppc2z",
+      "ppc3x", "ppc3y", "ppc3z", "tofdz", "tofdphi", "tofwdz", "tofwdphi", "emcdz", "emcdphi",
+      "pc2dz", "pc2dphi", "pc3dz", "pc3dphi", "striptofw", "slat", "etof", "ecore", "sect",
+      "ysect", "zsect"
+   };
    /// cutter for deadmaps
    DeadMapCutter dmCutter;
    /// calibrator for simulated data
@@ -113,16 +136,48 @@ namespace AnalyzeSimWidthlessResonance
       ROOT::TThreadedObject<TH2F> distrMInvNoPID{"M_inv: NoPID", "M_{inv} vs p_{T}", 
                                                  100, 0., 10., 10000, 0., 10.};
    };
-   /* @brief Processes the single configuration (for the given particle, 
-    * magnetic field, and pT range) from one file
+   /* @struct Configuration
+    * @brief Parameters of the single configuration (for the given particle, 
+    * magnetic field, and pT range) that are needed to process the events from its file
+    */
+   struct Configuration
+   {
+      /// name of the file with the simulated tree
+      std::string simInputFileName;
+      /// id of the first daughter particle
+      int daughter1Id;
+      /// id of the second daughter particle
+      int daughter2Id;
+      /// normalization of the number of particles to the number of events
+      double eventNormWeight;
+      /// weight function for spectra
+      std::unique_ptr<TF1> weightFunc;
+      /// shows whether the sidecar index of the file exists
+      bool isIndexed = false;
+      /// entries that pass the event level cuts (only filled if the sidecar index exists)
+      std::vector<unsigned long> selectedEntries;
+   };
+   /* @brief Sets the parameters of the single configuration (for the given particle, 
+    * magnetic field, and pT range); events that are rejected by the sidecar index 
+    * of the file are written in thrContainer
     *
+    * @param[out] configuration parameters of the configuration
     * @param[in] thrContainer the current ThrContainer in which the data will be written to 
     * @param[in] particleName name of the particle to be analyzed 
     * @param[in] pTRangeName name of the pT range to be analyzed 
     */
-   void AnalyzeConfiguration(ThrContainer& thrContainer, const std::string& particleName,
-                             const int daughter1Id, const int daugther2Id,
-                             const std::string& magneticFieldName, const std::string& pTRangeName); 
+   void SetConfiguration(Configuration& configuration, ThrContainer& thrContainer, 
+                         const std::string& particleName, 
+                         const int daughter1Id, const int daugther2Id,
+                         const std::string& magneticFieldName, const std::string& pTRangeName);
+   /* @brief Processes the events of one task from the file of the configuration
+    *
+    * @param[in] simCNT reader that iterates over the events of the task
+    * @param[in] thrContainer the current ThrContainer in which the data will be written to 
+    * @param[in] configuration parameters of the configuration the file of which is processed
+    */
+   void ProcessTask(SimTreeReader& simCNT, ThrContainer& thrContainer, 
+                    const Configuration& configuration);
 }
 
 #endif /* ANALYZE_SIM_WIDTLESS_RESONANCE_HPP */
@@ -0,0 +1,34 @@
+/** 
+ *  @file   BuildSimTreeIndex.hpp
+ *  @brief  Contains declarations of functions and variables that are used for building sidecar indices (entry number, original pT, bbcz, and nch of every event) of the files with simulated trees
+ *
+ *  This file is a part of a project PairAnalysisPhenix (https://github.com/Sergeyir/PairAnalysisPhenix).
+ *
+ *  @author Sergei Antsupov (antsupov0124@gmail.com)
+ **/
+#ifndef BUILD_SIM_TREE_INDEX_HPP
+#define BUILD_SIM_TREE_INDEX_HPP
+
+#include <string>
+#include <vector>
+
+#include "IOTools.hpp"
+
+#include "SimTreeReader.hpp"
+#include "SimTreeIndex.hpp"
+
+/* @namespace BuildSimTreeIndex
+ *
+ * @brief Contains all functions, variables, and containers needed for BuildSimTreeIndex 
+ *
+ * This namespace is eployed so that documentation will not become a pile of variables, types, and functions from many different files that are intended to be compiled and used as executables. With this namespace finding the needed information for the given executable is easier since everything belongs to the current namespace
+ */
+namespace BuildSimTreeIndex
+{
+   /// number of threads
+   int numberOfThreads;
+   /// names of the files with simulated trees for which the indices are built
+   std::vector<std::string> simFileNames;
+}
+
+#endif /* BUILD_SIM_TREE_INDEX_HPP */
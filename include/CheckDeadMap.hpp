@@ -0,0 +1,110 @@
+/**
+ *  @file   CheckDeadMap.hpp
+ *  @brief  Contains declarations of functions and variables that are used for checking that the lookups of DeadMap (bit-packed cells, summed-area table, batch queries, and binary files) give the same results as the straightforward lookups over 2D array of cells
+ *
+ *  This file is a part of a project PairAnalysisPhenix (https://github.com/Sergeyir/PairAnalysisPhenix).
+ *
+ *  @author Sergei Antsupov (antsupov0124@gmail.com)
+ **/
+#ifndef CHECK_DEAD_MAP_HPP
+#define CHECK_DEAD_MAP_HPP
+
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+#include <iomanip>
+#include <algorithm>
+#include <fstream>
+#include <filesystem>
+
+#include "ErrorHandler.hpp"
+#include "IOTools.hpp"
+
+#include "DeadMap.hpp"
+
+/* @namespace CheckDeadMap
+ *
+ * @brief Contains all functions, variables, and containers needed for CheckDeadMap
+ *
+ * This namespace is eployed so that documentation will not become a pile of variables, types, and functions from many different files that are intended to be compiled and used as executables. With this namespace finding the needed information for the given executable is easier since everything belongs to the current namespace
+ */
+namespace CheckDeadMap
+{
+   /// number of random maps that are checked if no deadmap files were specified
+   const int numberOfRandomMaps = 24;
+   /// number of random queries of each type for every map
+   const unsigned long numberOfQueries = 200000;
+   /// generator of random maps and queries (fixed seed so that the check is reproducible)
+   std::mt19937_64 generator{20240607};
+   /// directory in which random maps are written
+   const std::string randomMapsDir =
+      (std::filesystem::temp_directory_path()/"CheckDeadMap").string();
+
+   /* @struct ReferenceMap
+    * @brief Deadmap stored as 2D array of cells that is looked up the same way
+    * as the deadmaps of DeadMapCutter were looked up before DeadMap was introduced
+    */
+   struct ReferenceMap
+   {
+      /// reads the map from the text file (same format as for DeadMap::Read)
+      void Read(const std::string& inputFileName);
+      /// returns the bin of X axis in which x is located
+      int GetXBin(const double x) const;
+      /// returns the bin of Y axis in which y is located
+      int GetYBin(const double y) const;
+      /// returns true if (x, y) is outside of the ranges of the map or in the dead cell
+      bool IsDead(const double x, const double y) const;
+      /// returns true if (x, y) is outside of the ranges of the map or if all cells
+      /// within [x - xVar, x + xVar], [y - yVar, y + yVar] are dead
+      bool IsDeadLoose(const double x, const double y, const double xVar, const double yVar) const;
+      /// returns true if (x, y) is outside of the ranges of the map or if any of the cells
+      /// within [x - xVar, x + xVar], [y - yVar, y + yVar] is dead
+      bool IsDeadTight(const double x, const double y, const double xVar, const double yVar) const;
+      /// returns true if the cell is outside of the ranges of the map or is dead
+      bool IsDeadCell(const int xBin, const int yBin) const;
+      /// returns true if the cell is outside of the ranges of the map or if all
+      /// cells within [xBin - xBinVar, xBin + xBinVar], [yBin - yBinVar, yBin + yBinVar] are dead
+      bool IsDeadCellLoose(const int xBin, const int yBin,
+                           const int xBinVar, const int yBinVar) const;
+      /// returns true if the cell is outside of the ranges of the map or if any of the
+      /// cells within [xBin - xBinVar, xBin + xBinVar], [yBin - yBinVar, yBin + yBinVar] is dead
+      bool IsDeadCellTight(const int xBin, const int yBin,
+                           const int xBinVar, const int yBinVar) const;
+      /// returns the number of dead cells in the window limited by the edges of the map
+      int GetNumberOfDeadCells(int xBinMin, int xBinMax, int yBinMin, int yBinMax) const;
+      /// number of bins of X axis
+      int xNBins;
+      /// number of bins of Y axis
+      int yNBins;
+      /// ranges of X [0], [1] and Y [2], [3] axis
+      double ranges[4];
+      /// cells of the map; cell [i][j] is in i-th bin of Y axis and j-th bin of X axis
+      std::vector<std::vector<bool>> cells;
+   };
+   /*! @brief Writes the random map in the text file
+    * @param[in] outputFileName name of the text file
+    * @param[in] isCellMap if true the cells are numbered from 0 the same way
+    * as the channels of the detector (e.g. TOF slats)
+    */
+   void WriteRandomMap(const std::string& outputFileName, const bool isCellMap);
+   /*! @brief Compares the lookups of DeadMap read from the text file and from the binary file 
+    * with the lookups of ReferenceMap on random queries; returns the number of queries 
+    * with different results
+    *
+    * Lookups of the cells are also checked if the cells of the map are numbered from 0
+    *
+    * @param[in] inputFileName name of the text file of the map
+    */
+   unsigned long CheckMap(const std::string& inputFileName);
+   /*! @brief Compares the lookups of DeadMap read from the file and ReferenceMap;
+    * returns the number of queries with different results
+    * @param[in] deadMap deadmap that is checked
+    * @param[in] referenceMap map with which deadMap is compared
+    * @param[in] isCellMap if true the lookups of the cells are also checked
+    */
+   unsigned long CompareMaps(const DeadMap& deadMap, const ReferenceMap& referenceMap,
+                             const bool isCellMap);
+}
+
+#endif /* CHECK_DEAD_MAP_HPP */
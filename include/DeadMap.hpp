@@ -0,0 +1,267 @@
+/**
+ *  @file   DeadMap.hpp
+ *  @brief  Contains declarations of classes DeadMap and FusedDeadMap that can be used to store one bad/dead areas map (deadmap) of a detector as a contiguous bit-packed array, to look up its cells, and to combine the geometric and the timing deadmaps of the detector
+ *
+ *  This file is a part of a project PairAnalysisPhenix (https://github.com/Sergeyir/PairAnalysisPhenix).
+ *
+ *  @author Sergei Antsupov (antsupov0124@gmail.com)
+ **/
+#ifndef DEAD_MAP_HPP
+#define DEAD_MAP_HPP
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <filesystem>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "ErrorHandler.hpp"
+
+/*! @class DeadMap
+ * @brief 2D map of bad/dead cells with fixed bins; each cell is a single bit and rows are stored one after another in one contiguous array
+ *
+ * Rows are padded to the size of the cache line so that every row starts at the beginning of the cache line; this way the whole map of a detector (e.g. PC1e with 380x170 cells takes ~11 kB) stays in L1/L2 cache. Reciprocal bin widths are evaluated once when the map is read so that no divisions are performed on lookup. Summed-area table of the dead cells is also built when the map is read so that the number of dead cells within any rectangular window is obtained with 4 lookups regardless of the size of the window
+ */
+class DeadMap
+{
+   public:
+
+   /// Default constructor
+   DeadMap() = default;
+   /*! @brief Reads the map from the text file; returns true if the map was read successfully
+    *
+    * Text file starts with the number of bins, the lower and the upper edge of X and Y axis
+    * (xNBins xMin xMax yNBins yMin yMax) followed by yNBins rows of xNBins cells (1 - dead, 0 - alive)
+    *
+    * Binary file with the same name and .bin extension is memory-mapped instead of parsing the text file if it was generated from the current version of the text file (size and time of the last modification of the text file are stored in the binary file) and its checksum is correct. Otherwise the text file is parsed and the binary file is (re)generated. Binary file is also used when the text file does not exist
+    */
+   bool Read(const std::string& inputFileName);
+   /// returns the number of bins of X axis
+   int GetXNBins() const;
+   /// returns the number of bins of Y axis
+   int GetYNBins() const;
+   /// returns the lower edge of X axis
+   double GetXMin() const;
+   /// returns the upper edge of X axis
+   double GetXMax() const;
+   /// returns the lower edge of Y axis
+   double GetYMin() const;
+   /// returns the upper edge of Y axis
+   double GetYMax() const;
+   /// returns the bin of X axis in which x is located (bins start from 0; the result
+   /// is negative if x is below the range and is the last bin if x is above the range)
+   int GetXBin(const double x) const;
+   /// returns the bin of Y axis in which y is located (bins start from 0; the result
+   /// is negative if y is below the range and is the last bin if y is above the range)
+   int GetYBin(const double y) const;
+   /// returns true if (x, y) is strictly inside of the ranges of the map
+   bool IsInRange(const double x, const double y) const;
+   /// returns true if the cell is inside of the map for the maps in which
+   /// the cells are numbered the same way as the channels of the detector (e.g. TOF slats)
+   bool IsCellInRange(const int xBin, const int yBin) const;
+   /// returns true if the cell is dead; the cell must be inside of the map
+   bool IsDeadCell(const int xBin, const int yBin) const;
+   /// returns true if (x, y) is outside of the ranges of the map or in the dead cell
+   bool IsDead(const double x, const double y) const;
+   /// returns the number of dead cells within the window [xBinMin, xBinMax], [yBinMin, yBinMax];
+   /// the window is limited by the edges of the map
+   int GetNumberOfDeadCells(int xBinMin, int xBinMax, int yBinMin, int yBinMax) const;
+   /// returns true if all cells within the window are dead; the window is limited
+   /// by the edges of the map; true is also returned if no cells are left in the window
+   bool IsAllDead(int xBinMin, int xBinMax, int yBinMin, int yBinMax) const;
+   /// returns true if any of the cells within the window is dead;
+   /// the window is limited by the edges of the map
+   bool IsAnyDead(int xBinMin, int xBinMax, int yBinMin, int yBinMax) const;
+   /// returns true if (x, y) is outside of the ranges of the map or if all cells
+   /// within [x - xVar, x + xVar], [y - yVar, y + yVar] are dead
+   bool IsDeadLoose(const double x, const double y, const double xVar, const double yVar) const;
+   /// returns true if (x, y) is outside of the ranges of the map or if any of the cells
+   /// within [x - xVar, x + xVar], [y - yVar, y + yVar] is dead
+   bool IsDeadTight(const double x, const double y, const double xVar, const double yVar) const;
+   /*! @brief Adds the bit to the masks of the points that are outside of the ranges of the map or in the dead cells
+    *
+    * @param[in] numberOfPoints number of points
+    * @param[in] x X coordinates of the points
+    * @param[in] y Y coordinates of the points
+    * @param[in] isSelected only the points for which isSelected is not 0 are looked up
+    * @param[in] bit bit that is added to the mask of the point
+    * @param[out] masks masks of the points
+    *
+    * Gives the same results as IsDead for every point. Cells of all points are evaluated in one vectorized loop and then the cells are gathered from the map without branching on the selection
+    */
+   void SetDead(const unsigned long numberOfPoints, const double *x, const double *y,
+                const unsigned char *isSelected, const unsigned int bit,
+                unsigned int *masks) const;
+   /*! @brief Adds the bit to the masks of the cells that are outside of the map or dead
+    *
+    * Same as SetDead but for the cells numbered the same way as the channels of the detector
+    * (gives the same results as IsCellInRange and IsDeadCell for every cell)
+    */
+   void SetDeadCells(const unsigned long numberOfCells, const int *xBin, const int *yBin,
+                     const unsigned char *isSelected, const unsigned int bit,
+                     unsigned int *masks) const;
+
+   private:
+
+   /// number of bits in one word of the map
+   static constexpr int bitsPerWord = 64;
+   /// number of words in one cache line
+   static constexpr int wordsPerLine = 8;
+   /// words of the map placed on the same cache line
+   struct alignas(64) CacheLine
+   {
+      /// words of the cache line
+      std::uint64_t words[wordsPerLine] = {};
+   };
+   /// returns the word of the map; word must be inside of the map
+   std::uint64_t GetWord(const int yBin, const int word) const;
+   /// returns true if the bit of the cell with the given index in the map
+   /// (yBin*wordsPerRow*bitsPerWord + xBin) is set or if the index is negative
+   bool IsDeadCellIndex(const int cellIndex) const;
+   /// reads the map from the text file
+   void ReadText(const std::string& inputFileName);
+   /// reads the map from the binary file; returns false if the binary file does not exist,
+   /// is corrupted, or was not generated from the text file (if the name of the text file is not empty)
+   bool ReadBinary(const std::string& binaryFileName, const std::string& textFileName);
+   /// writes the map to the binary file generated from the text file
+   void WriteBinary(const std::string& binaryFileName, const std::string& textFileName) const;
+   /// evaluates reciprocal bin widths and allocates cells (all alive) from the number of bins and the ranges
+   void SetAxes();
+   /// returns the number of cache lines in one row of the map with the given number of bins of X axis
+   static int GetLinesPerRow(const int xNBins);
+   /// builds the summed-area table from the cells of the map
+   void BuildDeadCellsSums();
+   /// number of bins of X axis
+   int xNBins = 0;
+   /// number of bins of Y axis
+   int yNBins = 0;
+   /// lower edge of X axis
+   double xMin = 0.;
+   /// upper edge of X axis
+   double xMax = 0.;
+   /// lower edge of Y axis
+   double yMin = 0.;
+   /// upper edge of Y axis
+   double yMax = 0.;
+   /// reciprocal of the bin width of X axis
+   double xInvBinWidth = 0.;
+   /// reciprocal of the bin width of Y axis
+   double yInvBinWidth = 0.;
+   /// number of words in one row (multiple of wordsPerLine)
+   int wordsPerRow = 0;
+   /// cells of the map; bit j%64 of word j/64 of row i is set if the cell [i][j] is dead
+   std::vector<CacheLine> lines;
+   /// summed-area table of the dead cells; element [i][j] (i-th row of xNBins + 1 elements)
+   /// is the number of dead cells in rows [0, i) and columns [0, j)
+   std::vector<int> deadCellsSums;
+};
+
+/*! @class FusedDeadMap
+ * @brief Geometric and timing deadmaps of the same detector (e.g. TOFe) combined into one map in which every cell holds the bits of both deadmaps, so that both are obtained with a single lookup
+ *
+ * Only the maps in which the cells are numbered the same way as the channels of the detector (TOF, EMCal) can be combined. Map covers the ranges of both deadmaps; the bit of the deadmap is set for the cells that are outside of its range the same way as in the separate lookups
+ */
+class FusedDeadMap
+{
+   public:
+
+   /// Default constructor
+   FusedDeadMap() = default;
+   /*! @brief Combines the deadmaps
+    *
+    * @param[in] geometricMap geometric deadmap (nullptr if it is not used)
+    * @param[in] geometricBit bit of the geometric deadmap
+    * @param[in] timingMap timing deadmap (nullptr if it is not used)
+    * @param[in] timingBit bit of the timing deadmap
+    * @param[in] isTimingEdgeExcluded if true the cells on the lower edges of the range
+    * of the timing deadmap are considered to be outside of it (same as in DeadMap::IsDead)
+    */
+   void Set(const DeadMap *geometricMap, const unsigned int geometricBit,
+            const DeadMap *timingMap, const unsigned int timingBit,
+            const bool isTimingEdgeExcluded = false);
+   /// returns the bits of the deadmaps that are set for the cell
+   unsigned int Get(const int xBin, const int yBin) const;
+
+   private:
+
+   /// lower edge of X axis
+   int xMin = 0;
+   /// number of cells of X axis
+   int xNBins = 0;
+   /// lower edge of Y axis
+   int yMin = 0;
+   /// number of cells of Y axis
+   int yNBins = 0;
+   /// bits that are set for the cells outside of the map (bits of all used deadmaps)
+   unsigned int outsideBits = 0;
+   /// bits of the cells; element [i*xNBins + j] holds the bits of the cell (xMin + j, yMin + i)
+   std::vector<unsigned short> cells;
+};
+
+inline int DeadMap::GetXBin(const double x) const
+{
+   // multiplication by the inverse width can round x just below xMax up to xNBins
+   const int xBin = static_cast<int>((x - xMin)*xInvBinWidth);
+   return (xBin < xNBins) ? xBin : xNBins - 1;
+}
+
+inline int DeadMap::GetYBin(const double y) const
+{
+   // multiplication by the inverse width can round y just below yMax up to yNBins
+   const int yBin = static_cast<int>((y - yMin)*yInvBinWidth);
+   return (yBin < yNBins) ? yBin : yNBins - 1;
+}
+
+inline bool DeadMap::IsInRange(const double x, const double y) const
+{
+   return (x > xMin && x < xMax && y > yMin && y < yMax);
+}
+
+inline bool DeadMap::IsCellInRange(const int xBin, const int yBin) const
+{
+   return (xBin >= xMin && xBin < xMax && yBin >= yMin && yBin < yMax);
+}
+
+inline std::uint64_t DeadMap::GetWord(const int yBin, const int word) const
+{
+   const int index = yBin*wordsPerRow + word;
+   return lines[index/wordsPerLine].words[index % wordsPerLine];
+}
+
+inline bool DeadMap::IsDeadCellIndex(const int cellIndex) const
+{
+   if (cellIndex < 0) return true;
+   const int word = cellIndex/bitsPerWord;
+   return (lines[word/wordsPerLine].words[word % wordsPerLine] >> (cellIndex % bitsPerWord)) & 1ULL;
+}
+
+inline bool DeadMap::IsDeadCell(const int xBin, const int yBin) const
+{
+   return (GetWord(yBin, xBin/bitsPerWord) >> (xBin % bitsPerWord)) & 1ULL;
+}
+
+inline bool DeadMap::IsDead(const double x, const double y) const
+{
+   if (!IsInRange(x, y)) return true;
+   return IsDeadCell(GetXBin(x), GetYBin(y));
+}
+
+inline unsigned int FusedDeadMap::Get(const int xBin, const int yBin) const
+{
+   const unsigned int x = static_cast<unsigned int>(xBin - xMin);
+   const unsigned int y = static_cast<unsigned int>(yBin - yMin);
+   // negative differences wrap around so one comparison per axis is enough
+   if (x >= static_cast<unsigned int>(xNBins) || y >= static_cast<unsigned int>(yNBins))
+   {
+      return outsideBits;
+   }
+   return cells[y*static_cast<unsigned int>(xNBins) + x];
+}
+
+#endif /* DEAD_MAP_HPP */
@@ -11,11 +11,18 @@
 
 #include <string>
 #include <vector>
+#include <map>
+#include <tuple>
+#include <memory>
 #include <fstream>
 
+#include "TH2.h"
+
 #include "ErrorHandler.hpp"
 #include "IOTools.hpp"
 
+#include "DeadMap.hpp"
+
 /*! @class DeadMapCutter
  * @brief Class DeadMapCutter provides simple means to implement and to use bad/dead areas cuts (deadmaps) onto 2D heatmaps
  */
@@ -167,114 +174,150 @@ class DeadMapCutter
                                const int yTower, const int zTower,
                                const int yTowerVar = 1, const int zTowerVar = 1);
 
+   /// bits of the masks that are filled by the batch queries
+   enum DeadBit {DEAD_DC = 1 << 0, DEAD_PC1 = 1 << 1, DEAD_PC2 = 1 << 2, DEAD_PC3 = 1 << 3,
+                 DEAD_TOFE = 1 << 4, DEAD_TOFW = 1 << 5, DEAD_EMCAL = 1 << 6,
+                 DEAD_TIMING_TOFE = 1 << 7, DEAD_TIMING_TOFW = 1 << 8, DEAD_TIMING_EMCAL = 1 << 9};
+   /// returns bits (DeadBit) of the deadmaps that are applied
+   unsigned int GetUsedMaps() const;
+   /*! @brief Returns DEAD_TOFE and DEAD_TIMING_TOFE bits of the TOFe slat in one lookup
+    *
+    * Geometric and timing deadmaps of TOF and EMCal are combined in Initialize so that both of them are obtained with a single lookup. Bits are the same as the results of the separate queries (e.g. IsDeadTOFe and IsDeadTimingTOFe)
+    */
+   unsigned int GetDeadTOFe(const int chamber, const int slat) const;
+   /// Returns DEAD_TOFW and DEAD_TIMING_TOFW bits of the TOFw strip in one lookup
+   unsigned int GetDeadTOFw(const int chamber, const int strip) const;
+   /// Returns DEAD_EMCAL and DEAD_TIMING_EMCAL bits of the EMCal tower in one lookup
+   unsigned int GetDeadEMCal(const int dcarm, const int sector,
+                             const int yTower, const int zTower) const;
+   /*! @brief Adds DEAD_DC bit to the masks of the tracks that are in bad/dead area of DC
+    *
+    * Batch queries take the arrays of numberOfTracks elements (one element per track of the event) of the same quantities as the single track queries and give the same results. Bits are added to the masks so that the masks of all detectors can be filled one after another. Nothing is added if the deadmaps of the detector are not used
+    */
+   void SetDeadDC(const unsigned long numberOfTracks, const int *dcarm, const double *zDC,
+                  const double *board, const double *alpha, unsigned int *masks);
+   /// Adds DEAD_PC1 bit to the masks of the tracks that are in bad/dead area of PC1
+   void SetDeadPC1(const unsigned long numberOfTracks, const int *dcarm,
+                   const double *ppc1z, const double *ppc1phi, unsigned int *masks);
+   /// Adds DEAD_PC2 bit to the masks of the tracks that are in bad/dead area of PC2
+   void SetDeadPC2(const unsigned long numberOfTracks, const double *ppc2z,
+                   const double *ppc2phi, unsigned int *masks);
+   /// Adds DEAD_PC3 bit to the masks of the tracks that are in bad/dead area of PC3
+   void SetDeadPC3(const unsigned long numberOfTracks, const int *dcarm,
+                   const double *ppc3z, const double *ppc3phi, unsigned int *masks);
+   /// Adds DEAD_TOFE bit to the masks of the tracks that are in bad/dead area of TOFe
+   void SetDeadTOFe(const unsigned long numberOfTracks, const int *chamber,
+                    const int *slat, unsigned int *masks);
+   /// Adds DEAD_TOFW bit to the masks of the tracks that are in bad/dead area of TOFw
+   void SetDeadTOFw(const unsigned long numberOfTracks, const int *chamber,
+                    const int *strip, unsigned int *masks);
+   /// Adds DEAD_EMCAL bit to the masks of the tracks that are in bad/dead area of EMCal
+   void SetDeadEMCal(const unsigned long numberOfTracks, const int *dcarm, const int *sector,
+                     const int *yTower, const int *zTower, unsigned int *masks);
+   /// Adds DEAD_TIMING_TOFE bit to the masks of the tracks for which timing distribution in TOFe is bad
+   void SetDeadTimingTOFe(const unsigned long numberOfTracks, const int *chamber,
+                          const int *slat, unsigned int *masks);
+   /// Adds DEAD_TIMING_TOFW bit to the masks of the tracks for which timing distribution in TOFw is bad
+   void SetDeadTimingTOFw(const unsigned long numberOfTracks, const int *chamber,
+                          const int *strip, unsigned int *masks);
+   /// Adds DEAD_TIMING_EMCAL bit to the masks of the tracks for which timing distribution in EMCal is bad
+   void SetDeadTimingEMCal(const unsigned long numberOfTracks, const int *dcarm, 
+                           const int *sector, const int *yTower, const int *zTower,
+                           unsigned int *masks);
+
+   /*! @brief Sets to 0 the contents of the bins of the heatmap that are in bad/dead area of the deadmap; returns the fraction of the integral of the heatmap that was outside of bad/dead area (live fraction)
+    *
+    * @param[in, out] hist heatmap
+    * @param[in] deadmap bit (DeadBit) of the deadmap that is applied
+    * @param[in] dcarm arm of the detector (0 - east, 1 - west) for DC, PC1, PC3, and EMCal
+    * @param[in] section part of DC (0 - zDC>=0, 1 - zDC<0) or sector of EMCal
+    *
+    * Bins are checked the same way as with the single queries: DC and PC deadmaps are looked up at the centres of the bins and bin i (starting from 1) of TOF and EMCal heatmaps corresponds to the cell i - 1 of the deadmap. Flags of the bins are evaluated once and cached for every deadmap, arm, section, and binning of the heatmap so that the deadmap is looked up only once for all heatmaps with the same axes (e.g. for all runs); the cache is cleared by Initialize. Live fraction is evaluated from the same flags before the contents are modified. Mask and GetLiveFraction modify the cache and are not thread-safe: they must not be called for the same DeadMapCutter from several threads at once. Contents of TH2F and TH2D are accessed directly. Integrals include all bins apart from underflow and overflow; 0 is returned for the empty heatmap
+    */
+   double Mask(TH2 *hist, const DeadBit deadmap, const int dcarm = 0, const int section = 0);
+   /// Returns the fraction of the integral of the heatmap that is outside of bad/dead area
+   /// of the deadmap (live fraction) without modifying the heatmap (see Mask; not thread-safe)
+   double GetLiveFraction(const TH2 *hist, const DeadBit deadmap, 
+                          const int dcarm = 0, const int section = 0);
+
    private:
-   /// Read 2D arrays from the file into class attributes. Returns true if dead areas were set succesfully
-   bool SetDeadAreas(const std::string& inputFileName, std::vector<std::vector<bool>>& cutAreas,
-                     double *ranges);
-   /// shows whether option for DC was specified
-   bool useDC = false;
-   /// shows whether option for PC1 was specified
-   bool usePC1 = false;
-   /// shows whether option for PC2 was specified
-   bool usePC2 = false;
-   /// shows whether option for PC3 was specified
-   bool usePC3 = false;
-   /// shows whether option for TOFe was specified
-   bool useTOFe = false;
-   /// shows whether option for TOFw was specified
-   bool useTOFw = false;
-   /// shows whether option for EMCal was specified
-   bool useEMCal = false;
-   /// shows whether option for TOFe timing was specified
-   bool useTOFeTiming = false;
-   /// shows whether option for TOFw timing was specified
-   bool useTOFwTiming = false;
-   /// shows whether option for EMCal timing was specified
-   bool useEMCalTiming = false;
+   /// returns the map of DCX1 for the given arm and the sign of zDC
+   const DeadMap& GetMapDCX1(const int dcarm, const double zDC) const;
+   /// returns the map of DCX2 for the given arm and the sign of zDC
+   const DeadMap& GetMapDCX2(const int dcarm, const double zDC) const;
+   /// returns the flags of the tracks (1 if the track is selected, 0 otherwise) that are
+   /// reused between the batch queries of the current thread
+   static std::vector<unsigned char>& GetSelection(const unsigned long numberOfTracks);
+   /// returns the flags of the bins of the heatmap (1 if the bin is in bad/dead area, 0 otherwise)
+   /// in the same order as the bins are stored in the heatmap (see TH2::GetBin); flags are 
+   /// evaluated only on the first request for the given deadmap and binning and stay valid 
+   /// until Initialize is called (not thread-safe)
+   const std::vector<unsigned char>& GetDeadBins(const TH2 *hist, const DeadBit deadmap,
+                                                 const int dcarm, const int section);
+   /// returns true if the bin of the heatmap is in bad/dead area of the deadmap 
+   /// (x and y are the centres of the bin)
+   bool IsDeadBin(const DeadBit deadmap, const int dcarm, const int section,
+                  const int xBin, const int yBin, const double x, const double y);
+   /// deadmap, arm, section, and centres of the bins of X and Y axes of the heatmap
+   using DeadBinsKey = std::tuple<DeadBit, int, int, std::vector<double>, std::vector<double>>;
+   /// flags of the bins (see GetDeadBins) of the heatmaps that were masked; the number of 
+   /// entries is the number of different deadmaps and binnings of the heatmaps; flags are 
+   /// stored in separate allocations so that the references returned by GetDeadBins are not 
+   /// invalidated by the new entries
+   std::map<DeadBinsKey, std::unique_ptr<std::vector<unsigned char>>> deadBinsCaches;
+   /// bits (DeadBit) of the deadmaps that were specified in options and read successfully;
+   /// resolved once in Initialize so that the queries only test the bit of their deadmap
+   unsigned int usedMaps = 0;
    /// cut areas for DCeX1, zDC>=0
-   std::vector<std::vector<bool>> cutAreasDCe0X1;
+   DeadMap cutAreasDCe0X1;
    /// cut areas for DCeX1, zDC<0
-   std::vector<std::vector<bool>> cutAreasDCe1X1;
+   DeadMap cutAreasDCe1X1;
    /// cut areas for DCwX1, zDC>=0
-   std::vector<std::vector<bool>> cutAreasDCw0X1;
+   DeadMap cutAreasDCw0X1;
    /// cut areas for DCwX1, zDC<0
-   std::vector<std::vector<bool>> cutAreasDCw1X1;
+   DeadMap cutAreasDCw1X1;
    /// cut areas for DCeX2, zDC>=0
-   std::vector<std::vector<bool>> cutAreasDCe0X2;
+   DeadMap cutAreasDCe0X2;
    /// cut areas for DCeX2, zDC<0
-   std::vector<std::vector<bool>> cutAreasDCe1X2;
+   DeadMap cutAreasDCe1X2;
    /// cut areas for DCwX2, zDC>=0
-   std::vector<std::vector<bool>> cutAreasDCw0X2;
+   DeadMap cutAreasDCw0X2;
    /// cut areas for DCwX2, zDC<0
-   std::vector<std::vector<bool>> cutAreasDCw1X2;
+   DeadMap cutAreasDCw1X2;
    /// cut areas for PC1e
-   std::vector<std::vector<bool>> cutAreasPC1e;
+   DeadMap cutAreasPC1e;
    /// cut areas for PC1w
-   std::vector<std::vector<bool>> cutAreasPC1w;
+   DeadMap cutAreasPC1w;
    /// cut areas for PC2
-   std::vector<std::vector<bool>> cutAreasPC2;
+   DeadMap cutAreasPC2;
    /// cut areas for PC3e
-   std::vector<std::vector<bool>> cutAreasPC3e;
+   DeadMap cutAreasPC3e;
    /// cut areas for PC3w
-   std::vector<std::vector<bool>> cutAreasPC3w;
+   DeadMap cutAreasPC3w;
    /// cut areas for TOFe
-   std::vector<std::vector<bool>> cutAreasTOFe;
+   DeadMap cutAreasTOFe;
    /// cut areas for TOFw
-   std::vector<std::vector<bool>> cutAreasTOFw;
+   DeadMap cutAreasTOFw;
    /// cut areas for EMCale(0-3)
-   std::vector<std::vector<bool>> cutAreasEMCale[4];
+   DeadMap cutAreasEMCale[4];
    /// cut areas for EMCalw(0-3)
-   std::vector<std::vector<bool>> cutAreasEMCalw[4];
+   DeadMap cutAreasEMCalw[4];
    /// cut areas for timing for TOFe
-   std::vector<std::vector<bool>> cutAreasTimingTOFe;
+   DeadMap cutAreasTimingTOFe;
    /// cut areas for timing for TOFw
-   std::vector<std::vector<bool>> cutAreasTimingTOFw;
+   DeadMap cutAreasTimingTOFw;
    /// cut areas for timing for EMCale(0-3)
-   std::vector<std::vector<bool>> cutAreasTimingEMCale[4];
+   DeadMap cutAreasTimingEMCale[4];
    /// cut areas for timing for EMCalw(0-3)
-   std::vector<std::vector<bool>> cutAreasTimingEMCalw[4];
-   /// ranges of X [0], [1] and Y, [2], [3] axis for DCeX1, zDC>=0 heatmaps
-   double cutAreasDCe0X1Range[4];
-   /// ranges of X [0], [1] and Y, [2], [3] axis for DCeX1, zDC<0 heatmaps
-   double cutAreasDCe1X1Range[4];
-   /// ranges of X [0], [1] and Y, [2], [3] axis for DCwX1, zDC>=0 heatmaps
-   double cutAreasDCw0X1Range[4];
-   /// ranges of X [0], [1] and Y, [2], [3] axis for DCwX1, zDC<0 heatmaps
-   double cutAreasDCw1X1Range[4];
-   /// ranges of X [0], [1] and Y, [2], [3] axis for DCeX2, zDC>=0 heatmaps
-   double cutAreasDCe0X2Range[4];
-   /// ranges of X [0], [1] and Y, [2], [3] axis for DCeX2, zDC<0 heatmaps
-   double cutAreasDCe1X2Range[4];
-   /// ranges of X [0], [1] and Y, [2], [3] axis for DCwX2, zDC>=0 heatmaps
-   double cutAreasDCw0X2Range[4];
-   /// ranges of X [0], [1] and Y, [2], [3] axis for DCwX2, zDC<0 heatmaps
-   double cutAreasDCw1X2Range[4];
-   /// ranges of X [0], [1] and Y, [2], [3] axis for PC1e heatmaps
-   double cutAreasPC1eRange[4];
-   /// ranges of X [0], [1] and Y, [2], [3] axis for PC1w heatmaps
-   double cutAreasPC1wRange[4];
-   /// ranges of X [0], [1] and Y, [2], [3] axis for PC2 heatmaps
-   double cutAreasPC2Range[4];
-   /// ranges of X [0], [1] and Y, [2], [3] axis for PC3e heatmaps
-   double cutAreasPC3eRange[4];
-   /// ranges of X [0], [1] and Y, [2], [3] axis for PC3w heatmaps
-   double cutAreasPC3wRange[4];
-   /// ranges of X [0], [1] and Y, [2], [3] axis for TOFe heatmaps
-   double cutAreasTOFeRange[4];
-   /// ranges of X [0], [1] and Y, [2], [3] axis for TOFw heatmaps
-   double cutAreasTOFwRange[4];
-   /// ranges of X [0], [1] and Y, [2], [3] axis for EMCale(0-3) heatmaps
-   double cutAreasEMCaleRange[4][4];
-   /// ranges of X [0], [1] and Y, [2], [3] axis for EMCalw(0-3) heatmaps
-   double cutAreasEMCalwRange[4][4];
-   /// ranges of X [0], [1] and Y, [2], [3] axis for TOFe timing heatmaps
-   double cutAreasTimingTOFeRange[4];
-   /// ranges of X [0], [1] and Y, [2], [3] axis for TOFw timing heatmaps
-   double cutAreasTimingTOFwRange[4];
-   /// ranges of X [0], [1] and Y, [2], [3] axis for EMCale(0-3) timing heatmaps
-   double cutAreasTimingEMCaleRange[4][4];
-   /// ranges of X [0], [1] and Y, [2], [3] axis for EMCalw(0-3) timing heatmaps
-   double cutAreasTimingEMCalwRange[4][4];
+   DeadMap cutAreasTimingEMCalw[4];
+   /// geometric and timing cut areas for TOFe
+   FusedDeadMap fusedCutAreasTOFe;
+   /// geometric and timing cut areas for TOFw
+   FusedDeadMap fusedCutAreasTOFw;
+   /// geometric and timing cut areas for EMCale(0-3)
+   FusedDeadMap fusedCutAreasEMCale[4];
+   /// geometric and timing cut areas for EMCalw(0-3)
+   FusedDeadMap fusedCutAreasEMCalw[4];
 };
 
 #endif /* DEAD_MAP_CUTTER_HPP */
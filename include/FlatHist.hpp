@@ -0,0 +1,534 @@
+/**
+ *  @file   FlatHist.hpp
+ *  @brief  Contains declarations of classes FlatHistAxis, FlatHistBase, FlatHist, HistRegistry, MergedHists, ThrHistContainer, and FlatHistTable that can be used to declare histograms with fixed bins once, fill them from many threads, merge them in memory and convert them into ROOT histograms only when they are written, and look up the contents of ROOT histograms in the event loop
+ *
+ *  This file is a part of a project PairAnalysisPhenix (https://github.com/Sergeyir/PairAnalysisPhenix).
+ *
+ *  @author Sergei Antsupov (antsupov0124@gmail.com)
+ **/
+#ifndef FLAT_HIST_HPP
+#define FLAT_HIST_HPP
+
+#include <array>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+#include <unordered_map>
+
+#include "TH1.h"
+#include "TH2.h"
+#include "TH3.h"
+#include "TFile.h"
+#include "TDirectory.h"
+
+#include "ErrorHandler.hpp"
+
+/*! @class FlatHistAxis
+ * @brief Axis with fixed bins of FlatHist
+ */
+class FlatHistAxis
+{
+   public:
+
+   /// Default constructor
+   FlatHistAxis() = default;
+   /*! @brief Constructor
+    * @param[in] nBins number of bins
+    * @param[in] min lower edge of the axis
+    * @param[in] max upper edge of the axis
+    */
+   FlatHistAxis(const int nBins, const double min, const double max);
+   /// returns the number of the bin (0 for underflow and nBins + 1 for overflow)
+   /// in which x is located; bin is evaluated the same way as in TAxis::FindBin
+   int FindBin(const double x) const;
+   /// returns the number of bins
+   int GetNBins() const;
+   /// returns the lower edge of the axis
+   double GetMin() const;
+   /// returns the upper edge of the axis
+   double GetMax() const;
+
+   private:
+
+   /// number of bins
+   int nBins = 1;
+   /// lower edge of the axis
+   double min = 0.;
+   /// upper edge of the axis
+   double max = 1.;
+};
+
+/*! @struct FlatHistTraits
+ * @brief Number of dimensions and the type of bin content of ROOT histograms that FlatHist can substitute
+ */
+template<typename H> struct FlatHistTraits;
+template<> struct FlatHistTraits<TH1F> {static constexpr int dimension = 1; using Content = float;};
+template<> struct FlatHistTraits<TH1D> {static constexpr int dimension = 1; using Content = double;};
+template<> struct FlatHistTraits<TH2F> {static constexpr int dimension = 2; using Content = float;};
+template<> struct FlatHistTraits<TH2D> {static constexpr int dimension = 2; using Content = double;};
+template<> struct FlatHistTraits<TH3F> {static constexpr int dimension = 3; using Content = float;};
+template<> struct FlatHistTraits<TH3D> {static constexpr int dimension = 3; using Content = double;};
+
+class FlatHistBase;
+
+/*! @class HistRegistry
+ * @brief Keeps the list of the histograms of a container in the order they are declared in and the detectors configuration that defines which of them are enabled
+ *
+ * Each FlatHist adds itself to the registry that is passed to its constructor. Since all containers of the same type declare the same histograms in the same order, the histograms of different containers can be matched by their number in the registry
+ */
+class HistRegistry
+{
+   public:
+
+   /// detectors in the same order as in detectors_configuration in main.yaml;
+   /// histograms declared with ANY are enabled for every detectors configuration
+   enum Detector {DC = 0, PC1, PC2, PC3, TOFe, TOFw, EMCal, ANY};
+   /// Default constructor (deleted)
+   HistRegistry() = delete;
+   /*! @brief Constructor
+    * @param[in] detectorsConfiguration detectors_configuration from main.yaml (e.g. '1101111')
+    */
+   HistRegistry(const std::string& detectorsConfiguration);
+   /// Copy constructor (deleted since the registry points to the histograms of its container)
+   HistRegistry(const HistRegistry&) = delete;
+   /// returns true if the given detector is enabled in the detectors configuration
+   bool IsEnabled(const int detector) const;
+   /// adds the histogram to the registry
+   void Add(FlatHistBase *hist);
+   /// returns the number of the histograms in the registry
+   unsigned long GetSize() const;
+   /// returns i-th histogram in the order of declaration
+   const FlatHistBase& Get(const unsigned long i) const;
+
+   private:
+
+   /// detectors_configuration from main.yaml
+   std::string detectorsConfiguration;
+   /// histograms in the order of declaration
+   std::vector<FlatHistBase *> hists;
+};
+
+/*! @class FlatHistBase
+ * @brief Part of FlatHist that does not depend on the type of the histogram; it is used to merge and write the histograms of any type
+ */
+class FlatHistBase
+{
+   public:
+
+   /// Default constructor (deleted)
+   FlatHistBase() = delete;
+   /*! @brief Constructor; adds the histogram to the registry
+    * @param[in] registry registry of the container the histogram belongs to
+    * @param[in] detector detector the histogram is filled for (HistRegistry::Detector)
+    * @param[in] directory directory of the output file the histogram is written in ("" for root)
+    * @param[in] name name of the histogram
+    * @param[in] title title of the histogram
+    */
+   FlatHistBase(HistRegistry& registry, const int detector, const std::string& directory,
+                const std::string& name, const std::string& title);
+   /// Copy constructor (deleted since the histogram is registered by its address)
+   FlatHistBase(const FlatHistBase&) = delete;
+   /// returns false if the detector of the histogram is disabled
+   bool IsEnabled() const;
+   /// returns directory of the output file the histogram is written in
+   const std::string& GetDirectory() const;
+   /// returns true if the histogram was filled with weights not equal to 1
+   virtual bool IsWeighted() const = 0;
+   /// returns empty ROOT histogram with the same name, title, and bins
+   virtual std::unique_ptr<TH1> MakeHist() const = 0;
+   /// adds the contents of the histogram to ROOT histogram created with MakeHist
+   /// and returns the number of fills of the histogram
+   virtual double AddTo(TH1& hist) const = 0;
+   /// Destructor
+   virtual ~FlatHistBase() = default;
+
+   protected:
+
+   /// name of the histogram
+   std::string name;
+   /// title of the histogram
+   std::string title;
+
+   private:
+
+   /// false if the detector of the histogram is disabled
+   bool isEnabled;
+   /// directory of the output file the histogram is written in
+   std::string directory;
+};
+
+/*! @class FlatHist
+ * @brief Histogram with fixed bins which contents are stored in a flat array in the same order as in ROOT histogram H (including underflow and overflow bins)
+ *
+ * Fills are not virtual and the bin is found without TAxis. Contents are allocated on the first fill so that the histograms that are never filled by a thread do not occupy memory; histograms of disabled detectors are never allocated. Sum of squares of weights is only stored after the first fill with weight not equal to 1 the same way as TH1::Fill calls TH1::Sumw2
+ */
+template<typename H>
+class FlatHist : public FlatHistBase
+{
+   public:
+
+   /// type of the bin content (same as in H)
+   using Content = typename FlatHistTraits<H>::Content;
+   /// number of dimensions (same as in H)
+   static constexpr int dimension = FlatHistTraits<H>::dimension;
+   /*! @brief Constructor; parameters after the title are the same as for the constructor of H with fixed bins
+    *
+    * @param[in] registry registry of the container the histogram belongs to
+    * @param[in] detector detector the histogram is filled for (HistRegistry::Detector)
+    * @param[in] directory directory of the output file the histogram is written in ("" for root)
+    * @param[in] name name of the histogram
+    * @param[in] title title of the histogram
+    * @param[in] axesParameters number of bins, lower edge, and upper edge for each axis
+    */
+   template<typename... Args>
+   FlatHist(HistRegistry& registry, const int detector, const std::string& directory,
+            const std::string& name, const std::string& title, const Args... axesParameters);
+   /// fills 1D histogram (same as TH1::Fill(x, w))
+   template<int D = dimension>
+   typename std::enable_if<D == 1>::type Fill(const double x, const double w = 1.);
+   /// fills 2D histogram (same as TH2::Fill(x, y, w))
+   template<int D = dimension>
+   typename std::enable_if<D == 2>::type Fill(const double x, const double y, const double w = 1.);
+   /// fills 3D histogram (same as TH3::Fill(x, y, z, w))
+   template<int D = dimension>
+   typename std::enable_if<D == 3>::type Fill(const double x, const double y,
+                                               const double z, const double w = 1.);
+   bool IsWeighted() const override;
+   std::unique_ptr<TH1> MakeHist() const override;
+   double AddTo(TH1& hist) const override;
+
+   private:
+
+   /// adds w to the content of the bin with the global bin number
+   void AddBinContent(const unsigned long bin, const double w);
+   /// axes of the histogram
+   std::array<FlatHistAxis, dimension> axes;
+   /// number of bins including underflow and overflow bins
+   unsigned long size = 1;
+   /// contents of the bins (empty until the first fill)
+   std::vector<Content> contents;
+   /// sums of squares of weights (empty until the first fill with weight not equal to 1)
+   std::vector<double> sumw2;
+   /// number of fills
+   double entries = 0.;
+};
+
+/*! @class MergedHists
+ * @brief ROOT histograms merged from all threads of ThrHistContainer in the order of their registry
+ *
+ * Merged histograms of containers of the same type can be summed in memory so that the sum of many outputs is written once without temporary files. Histograms are merged and summed in parallel since each histogram is independent from the others
+ */
+class MergedHists
+{
+   public:
+
+   /// Default constructor (no histograms)
+   MergedHists() = default;
+   /*! @brief Constructor
+    * @param[in] size number of histograms
+    */
+   MergedHists(const unsigned long size);
+   /*! @brief Sets i-th histogram
+    * @param[in] i number of the histogram in the registry
+    * @param[in] hist histogram
+    * @param[in] directory directory of the output file the histogram is written in ("" for root)
+    */
+   void Set(const unsigned long i, std::unique_ptr<TH1> hist, const std::string& directory);
+   /*! @brief Adds the histograms of other MergedHists with the same histograms to the current ones
+    *
+    * If the current MergedHists has no histograms the histograms of other are copied
+    *
+    * @param[in] other histograms to be added
+    * @param[in] numberOfThreads number of threads the histograms are added with
+    */
+   void Add(const MergedHists& other, 
+            const unsigned int numberOfThreads = std::thread::hardware_concurrency());
+   /*! @brief Writes all histograms into the file with a specified name
+    * @param[in] outputFileName name of the output file
+    * @param[in] compressionLevel compression level of the output file
+    */
+   void Write(const std::string& outputFileName, const int compressionLevel = 6) const;
+   /// writes all histograms into the directory of the output file (e.g. the file itself)
+   void Write(TDirectory& outputDirectory) const;
+   /// calls func(i) for every i from 0 to n - 1 from the specified number of threads
+   static void ParallelFor(const unsigned long n, const unsigned int numberOfThreads,
+                           const std::function<void(const unsigned long)>& func);
+
+   private:
+
+   /// histograms in the order of the registry
+   std::vector<std::unique_ptr<TH1>> hists;
+   /// directories of the output file the histograms are written in
+   std::vector<std::string> directories;
+};
+
+/*! @class ThrHistContainer
+ * @brief Provides each thread with its own Container of FlatHist histograms and merges the containers of all threads when they are written
+ *
+ * Container must be constructible from detectors_configuration string and must have HistRegistry member named registry that is declared before its histograms. Containers of the threads are constructed from the same declaration so the histograms are declared only once
+ */
+template<typename Container>
+class ThrHistContainer
+{
+   public:
+
+   /// Default constructor (deleted)
+   ThrHistContainer() = delete;
+   /*! @brief Constructor
+    * @param[in] detectorsConfiguration detectors_configuration from main.yaml (e.g. '1101111')
+    */
+   ThrHistContainer(const std::string& detectorsConfiguration);
+   /// returns the container of the current thread (the container is created on the first call)
+   Container& Get();
+   /*! @brief Merges the histograms across all threads; different histograms are merged in parallel
+    * @param[in] numberOfThreads number of threads the histograms are merged with
+    */
+   MergedHists Merge(const unsigned int numberOfThreads = std::thread::hardware_concurrency());
+   /*! @brief Writes the merged histograms across all threads into the file with a specified name
+    * @param[in] outputFileName name of the output file
+    * @param[in] compressionLevel compression level of the output file
+    */
+   void Write(const std::string& outputFileName, const int compressionLevel = 6);
+
+   private:
+
+   /// detectors_configuration from main.yaml
+   std::string detectorsConfiguration;
+   /// container that is used to write histograms when no thread has filled them
+   Container declaration;
+   /// mutex for accessing containers from several threads
+   std::mutex containersMutex;
+   /// containers of the threads
+   std::unordered_map<std::thread::id, std::unique_ptr<Container>> containers;
+};
+
+/*! @class FlatHistTable
+ * @brief Lookup table of the bin contents of 1D or 2D ROOT histogram with fixed bins
+ *
+ * Bin is found with FlatHistAxis so that lookups in the event loop do not call virtual TH1::FindBin and TH1::GetBinContent; contents of underflow and overflow bins are kept so that Get returns the same value as TH1::GetBinContent(TH1::FindBin(...))
+ */
+class FlatHistTable
+{
+   public:
+
+   /// Default constructor
+   FlatHistTable() = default;
+   /*! @brief Constructor
+    * @param[in] hist 1D or 2D histogram with fixed bins which contents are copied into the table
+    */
+   FlatHistTable(const TH1 *hist);
+   /// returns the content of the bin of 1D histogram in which x is located
+   double Get(const double x) const;
+   /// returns the content of the bin of 2D histogram in which (x, y) is located
+   double Get(const double x, const double y) const;
+
+   private:
+
+   /// x axis of the histogram
+   FlatHistAxis xAxis;
+   /// y axis of the histogram (only used for 2D histograms)
+   FlatHistAxis yAxis;
+   /// contents of the bins in the same order as in ROOT histogram
+   std::vector<double> contents;
+};
+
+inline int FlatHistAxis::FindBin(const double x) const
+{
+   if (x < min) return 0;
+   if (!(x < max)) return nBins + 1;
+   return 1 + static_cast<int>(nBins*(x - min)/(max - min));
+}
+
+template<typename H> template<typename... Args>
+FlatHist<H>::FlatHist(HistRegistry& registry, const int detector, const std::string& directory,
+                      const std::string& name, const std::string& title,
+                      const Args... axesParameters) :
+   FlatHistBase(registry, detector, directory, name, title)
+{
+   static_assert(sizeof...(Args) == 3*dimension,
+                 "FlatHist: number of bins, lower edge, and upper edge must be passed for each axis");
+
+   const std::array<double, 3*dimension> parameters{static_cast<double>(axesParameters)...};
+   for (int i = 0; i < dimension; i++)
+   {
+      axes[i] = FlatHistAxis(static_cast<int>(parameters[3*i]),
+                             parameters[3*i + 1], parameters[3*i + 2]);
+      size *= static_cast<unsigned long>(axes[i].GetNBins() + 2);
+   }
+}
+
+template<typename H>
+inline void FlatHist<H>::AddBinContent(const unsigned long bin, const double w)
+{
+   if (contents.empty())
+   {
+      // histograms of disabled detectors are never allocated
+      if (!IsEnabled()) return;
+      contents.resize(size, 0);
+   }
+   // contents that were filled until now had weights equal to 1
+   // which is the same as what TH1::Sumw2 does
+   if (sumw2.empty() && w != 1.) sumw2.assign(contents.begin(), contents.end());
+
+   contents[bin] += static_cast<Content>(w);
+   if (!sumw2.empty()) sumw2[bin] += w*w;
+   entries++;
+}
+
+template<typename H> template<int D>
+inline typename std::enable_if<D == 1>::type FlatHist<H>::Fill(const double x, const double w)
+{
+   AddBinContent(axes[0].FindBin(x), w);
+}
+
+template<typename H> template<int D>
+inline typename std::enable_if<D == 2>::type FlatHist<H>::Fill(const double x, const double y,
+                                                                const double w)
+{
+   AddBinContent(axes[0].FindBin(x) +
+                 static_cast<unsigned long>(axes[0].GetNBins() + 2)*axes[1].FindBin(y), w);
+}
+
+template<typename H> template<int D>
+inline typename std::enable_if<D == 3>::type FlatHist<H>::Fill(const double x, const double y,
+                                                                const double z, const double w)
+{
+   AddBinContent(axes[0].FindBin(x) +
+                 static_cast<unsigned long>(axes[0].GetNBins() + 2)*
+                 (axes[1].FindBin(y) +
+                  static_cast<unsigned long>(axes[1].GetNBins() + 2)*axes[2].FindBin(z)), w);
+}
+
+template<typename H>
+bool FlatHist<H>::IsWeighted() const
+{
+   return !sumw2.empty();
+}
+
+template<typename H>
+std::unique_ptr<TH1> FlatHist<H>::MakeHist() const
+{
+   std::unique_ptr<TH1> hist;
+   if constexpr (dimension == 1)
+   {
+      hist = std::make_unique<H>(name.c_str(), title.c_str(), axes[0].GetNBins(),
+                                 axes[0].GetMin(), axes[0].GetMax());
+   }
+   else if constexpr (dimension == 2)
+   {
+      hist = std::make_unique<H>(name.c_str(), title.c_str(),
+                                 axes[0].GetNBins(), axes[0].GetMin(), axes[0].GetMax(),
+                                 axes[1].GetNBins(), axes[1].GetMin(), axes[1].GetMax());
+   }
+   else
+   {
+      hist = std::make_unique<H>(name.c_str(), title.c_str(),
+                                 axes[0].GetNBins(), axes[0].GetMin(), axes[0].GetMax(),
+                                 axes[1].GetNBins(), axes[1].GetMin(), axes[1].GetMax(),
+                                 axes[2].GetNBins(), axes[2].GetMin(), axes[2].GetMax());
+   }
+   // the histogram is owned by unique_ptr and not by the current directory
+   hist->SetDirectory(nullptr);
+   return hist;
+}
+
+template<typename H>
+double FlatHist<H>::AddTo(TH1& hist) const
+{
+   if (contents.empty()) return 0.;
+
+   for (unsigned long bin = 0; bin < size; bin++)
+   {
+      if (contents[bin] == 0) continue;
+      hist.AddBinContent(static_cast<int>(bin), contents[bin]);
+   }
+
+   if (hist.GetSumw2N() > 0)
+   {
+      double *histSumw2 = hist.GetSumw2()->GetArray();
+      for (unsigned long bin = 0; bin < size; bin++)
+      {
+         histSumw2[bin] += (sumw2.empty() ? static_cast<double>(contents[bin]) : sumw2[bin]);
+      }
+   }
+
+   return entries;
+}
+
+template<typename Container>
+ThrHistContainer<Container>::ThrHistContainer(const std::string& detectorsConfiguration) :
+   detectorsConfiguration(detectorsConfiguration), declaration(detectorsConfiguration) {}
+
+template<typename Container>
+Container& ThrHistContainer<Container>::Get()
+{
+   std::lock_guard<std::mutex> lock(containersMutex);
+   std::unique_ptr<Container>& container = containers[std::this_thread::get_id()];
+   if (!container) container = std::make_unique<Container>(detectorsConfiguration);
+   return *container;
+}
+
+template<typename Container>
+MergedHists ThrHistContainer<Container>::Merge(const unsigned int numberOfThreads)
+{
+   std::lock_guard<std::mutex> lock(containersMutex);
+
+   MergedHists mergedHists(declaration.registry.GetSize());
+
+   MergedHists::ParallelFor(declaration.registry.GetSize(), numberOfThreads, 
+                            [&](const unsigned long i)
+   {
+      // histograms of disabled detectors are kept empty so that
+      // the output files have the same structure for every detectors configuration
+      std::unique_ptr<TH1> hist = declaration.registry.Get(i).MakeHist();
+
+      for (const auto& container : containers)
+      {
+         if (container.second->registry.Get(i).IsWeighted())
+         {
+            hist->Sumw2();
+            break;
+         }
+      }
+
+      double entries = 0.;
+      for (const auto& container : containers)
+      {
+         entries += container.second->registry.Get(i).AddTo(*hist);
+      }
+
+      // statistics are evaluated from the bin contents since they are not accumulated on fill
+      hist->ResetStats();
+      hist->SetEntries(entries);
+
+      mergedHists.Set(i, std::move(hist), declaration.registry.Get(i).GetDirectory());
+   });
+
+   return mergedHists;
+}
+
+template<typename Container>
+void ThrHistContainer<Container>::Write(const std::string& outputFileName, 
+                                        const int compressionLevel)
+{
+   Merge().Write(outputFileName, compressionLevel);
+}
+
+inline double FlatHistTable::Get(const double x) const
+{
+   return contents[xAxis.FindBin(x)];
+}
+
+inline double FlatHistTable::Get(const double x, const double y) const
+{
+   return contents[xAxis.FindBin(x) +
+                   static_cast<unsigned long>(xAxis.GetNBins() + 2)*yAxis.FindBin(y)];
+}
+
+#endif /* FLAT_HIST_HPP */
@@ -0,0 +1,139 @@
+/**
+ *  @file   MixedEventPool.hpp
+ *  @brief  Contains declarations of structs and classes PooledEvent, EventPool, and ThrEventPools that can be used to keep the last events of each centrality, z_{vtx}, and reaction plane bin for building mixed event background
+ *
+ *  This file is a part of a project PairAnalysisPhenix (https://github.com/Sergeyir/PairAnalysisPhenix).
+ *
+ *  @author Sergei Antsupov (antsupov0124@gmail.com)
+ **/
+#ifndef MIXED_EVENT_POOL_HPP
+#define MIXED_EVENT_POOL_HPP
+
+#include <mutex>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unordered_map>
+
+#include "ErrorHandler.hpp"
+
+#include "PairTrackFunc.hpp"
+
+/*! @struct PooledEvent
+ * @brief Charged tracks of the event that is kept in the pool to be mixed with the following events
+ *
+ * Containers are reused when the event is replaced by a newer one so that no memory is allocated once they have grown to the size of the largest event of the pool
+ */
+struct PooledEvent
+{
+   /*! @brief Copies the tracks of the event into the containers
+    * @param[in] positiveTracks positive tracks of the event
+    * @param[in] negativeTracks negative tracks of the event sorted by pT
+    * @param[in] weight weight of the event
+    */
+   void Set(const std::vector<ChargedTrack>& positiveTracks,
+            const std::vector<ChargedTrack>& negativeTracks, const double weight);
+   /// positive tracks of the event
+   std::vector<ChargedTrack> positiveTracks;
+   /// negative tracks of the event sorted by pT
+   std::vector<ChargedTrack> negativeTracks;
+   /// negative tracks of the event for the batched evaluation of pair kinematics
+   TrackBlock negativeTracksBlock;
+   /// weight of the event
+   double weight = 1.;
+};
+
+/*! @class EventPool
+ * @brief Ring buffer of the last events of the same centrality, z_{vtx}, and reaction plane bin; the oldest event is replaced when the pool is full
+ */
+class EventPool
+{
+   public:
+
+   /*! @brief Constructor
+    * @param[in] depth maximum number of events in the pool
+    */
+   EventPool(const unsigned long depth);
+   /// returns the number of events in the pool
+   unsigned long GetSize() const;
+   /// returns i-th event of the pool (events are not ordered by the time they were added)
+   const PooledEvent& Get(const unsigned long i) const;
+   /*! @brief Adds the event to the pool replacing the oldest one if the pool is full
+    * @param[in] positiveTracks positive tracks of the event
+    * @param[in] negativeTracks negative tracks of the event sorted by pT
+    * @param[in] weight weight of the event
+    */
+   void Add(const std::vector<ChargedTrack>& positiveTracks,
+            const std::vector<ChargedTrack>& negativeTracks, const double weight);
+
+   private:
+
+   /// events of the pool (all depth events are constructed at once and then reused)
+   std::vector<PooledEvent> events;
+   /// number of events that were added to the pool (but not more than depth)
+   unsigned long size = 0;
+   /// index of the event that is replaced next
+   unsigned long next = 0;
+};
+
+/*! @class ThrEventPools
+ * @brief Provides each thread with its own event pools for all centrality (c), z_{vtx} (z), and reaction plane (r) bins in the same layout as in CabanaBoy
+ *
+ * Pools are kept separately for each set of events (e.g. for each input file or decay mode) so that the events of different sets are never mixed. Since every thread mixes only the events it has processed, pools are neither locked nor shared between the threads
+ */
+class ThrEventPools
+{
+   public:
+
+   /// Default constructor (deleted)
+   ThrEventPools() = delete;
+   /*! @brief Constructor
+    * @param[in] numberOfCBins number of centrality bins
+    * @param[in] numberOfZBins number of z_{vtx} bins
+    * @param[in] numberOfRBins number of reaction plane bins
+    * @param[in] zMin lower edge of z_{vtx} range [cm]
+    * @param[in] zMax upper edge of z_{vtx} range [cm]
+    * @param[in] depth maximum number of events in each pool
+    * @param[in] numberOfSets number of sets of events that are mixed separately
+    */
+   ThrEventPools(const int numberOfCBins, const int numberOfZBins, const int numberOfRBins,
+                 const double zMin, const double zMax, const unsigned long depth,
+                 const unsigned long numberOfSets = 1);
+   /// Copy constructor (deleted since the threads keep references to their pools)
+   ThrEventPools(const ThrEventPools&) = delete;
+   /// returns the number of c, z, and r bins combined
+   int GetNumberOfBins() const;
+   /// returns the bin of the pool for the given centrality bin, z_{vtx}, and
+   /// reaction plane bin or -1 if the event is outside of the ranges of the pools
+   int GetBin(const int c, const double zVtx, const int r) const;
+   /// returns the name of the bin of the pool in the same format as the names of
+   /// the directories of CabanaBoy output (e.g. c00_z01_r00)
+   std::string GetBinName(const int bin) const;
+   /// returns the pools of the current thread (the pools are created on the first call);
+   /// pool of the set and the bin has the index set*GetNumberOfBins() + bin
+   std::vector<EventPool>& Get();
+
+   private:
+
+   /// number of centrality bins
+   int numberOfCBins;
+   /// number of z_{vtx} bins
+   int numberOfZBins;
+   /// number of reaction plane bins
+   int numberOfRBins;
+   /// lower edge of z_{vtx} range [cm]
+   double zMin;
+   /// upper edge of z_{vtx} range [cm]
+   double zMax;
+   /// maximum number of events in each pool
+   unsigned long depth;
+   /// number of sets of events that are mixed separately
+   unsigned long numberOfSets;
+   /// mutex for accessing the pools from several threads
+   std::mutex poolsMutex;
+   /// pools of the threads
+   std::unordered_map<std::thread::id, std::unique_ptr<std::vector<EventPool>>> pools;
+};
+
+#endif /* MIXED_EVENT_POOL_HPP */
@@ -10,6 +10,10 @@
 #define PAIR_TRACK_FUNC_HPP
 
 #include <cmath>
+#include <limits>
+#include <vector>
+#include <utility>
+#include <algorithm>
 
 #include "SingleTrackFunc.hpp"
 
@@ -149,6 +153,70 @@ double GetPairPT(const ChargedTrack& track1, const ChargedTrack& track2);
  * @param[in] track1 2nd charged track in a pair
  */
 double GetPairMass(const ChargedTrack& track1, const ChargedTrack& track2);
+/*! @struct TrackBlock
+ * @brief Momenta and energies of charged tracks stored in contiguous arrays (structure of arrays) for the batched evaluation of pair kinematics (see GetPairsMassPT)
+ */
+struct TrackBlock
+{
+   /// removes all tracks from the block; allocated memory is kept
+   void Clear();
+   /// adds the track to the block with its energy
+   void Add(const ChargedTrack& track);
+   /*! @brief Adds the track to the block with the energy evaluated for the given mass hypothesis
+    * @param[in] track charged track
+    * @param[in] m mass of a particle [GeV/c^2]
+    */
+   void Add(const ChargedTrack& track, const double m);
+   /// returns the number of tracks in the block
+   unsigned long GetSize() const;
+   /// X components of momenta of tracks [GeV/c]
+   std::vector<double> pX;
+   /// Y components of momenta of tracks [GeV/c]
+   std::vector<double> pY;
+   /// Z components of momenta of tracks [GeV/c]
+   std::vector<double> pZ;
+   /// energies of tracks [GeV]
+   std::vector<double> e;
+   /// transverse momenta of tracks [GeV/c]
+   std::vector<double> pT;
+   /// the smallest mass of the tracks in the block [GeV/c^2]
+   double mMin = std::numeric_limits<double>::max();
+};
+/*! @brief Evaluates invariant masses and pT of pairs of the charged track with every track of the block
+ *
+ * Gives the same values as GetPairMass and GetPairPT but the loop over the tracks of the block is vectorized (SIMD). PairTrackFunc.cpp is compiled with -fopenmp-simd and -fno-math-errno for this
+ *
+ * @param[in] track charged track (1st track in every pair)
+ * @param[in] block block of charged tracks (2nd tracks in pairs)
+ * @param[out] mInv invariant masses of pairs [GeV/c^2]; must have the size of at least block.GetSize()
+ * @param[out] pT pT of pairs [GeV/c]; must have the size of at least block.GetSize()
+ */
+void GetPairsMassPT(const ChargedTrack& track, const TrackBlock& block, 
+                    double *mInv, double *pT);
+/*! @brief Same as GetPairsMassPT for all tracks of the block but only the tracks with indices in [first, last) are paired; mInv and pT are indexed the same as the tracks of the block
+ * @param[in] track charged track (1st track in every pair)
+ * @param[in] block block of charged tracks (2nd tracks in pairs)
+ * @param[in] first index of the first track of the block to be paired
+ * @param[in] last index after the last track of the block to be paired
+ * @param[out] mInv invariant masses of pairs [GeV/c^2]; must have the size of at least last
+ * @param[out] pT pT of pairs [GeV/c]; must have the size of at least last
+ */
+void GetPairsMassPT(const ChargedTrack& track, const TrackBlock& block, 
+                    const unsigned long first, const unsigned long last, 
+                    double *mInv, double *pT);
+/*! @brief Returns the range of indices [first, last) of tracks of the block that can form a pair with the given track with invariant mass below mInvMax and pT below pTMax
+ *
+ * Tracks must be added to the block in the ascending order of pT. Pairs with the tracks outside of the range can only fill overflow bins of the histograms with these upper edges so they can be skipped without looping over them; overflow bins and the numbers of entries of such histograms then do not include the skipped pairs, so the range must only be used for the histograms whose overflow bins and numbers of entries are not used. The range is found with the binary search from the analytic lower bounds: invariant mass of a pair is the smallest when the tracks have the same rapidity and azimuthal angle, i.e. M_inv^2 >= m1^2 + m2^2 + 2(mT1*mT2 - pT1*pT2), and pT of a pair is not smaller than |pT1 - pT2|. Both bounds are satisfied for pT2 in a single interval. The range is slightly widened so that the pairs near the limits are never lost due to rounding
+ *
+ * @param[in] track charged track (1st track in every pair)
+ * @param[in] block block of charged tracks (2nd tracks in pairs) sorted by pT
+ * @param[in] mInvMax upper limit of invariant mass of pairs [GeV/c^2]
+ * @param[in] pTMax upper limit of pT of pairs [GeV/c]
+ */
+std::pair<unsigned long, unsigned long> GetPartnersRange(const ChargedTrack& track, 
+                                                         const TrackBlock& block, 
+                                                         const double mInvMax, 
+                                                         const double pTMax);
 /*! @brief Returns true if the pair of charged tracks does not pass 1 arm check
  * (i.e. both particles must be in one arm)
  * @param[in] track1 1st charged track in a pair
@@ -195,5 +263,194 @@ bool IsSailorCut(const ChargedTrack& track1, const ChargedTrack& track2);
  * @param[in] track1 2nd charged track in a pair
  */
 bool IsCowboyCut(const ChargedTrack& track1, const ChargedTrack& track2);
+/*! @brief Returns the mask of detectors (DETECTOR_BIT) for which the pair of charged tracks does not pass pair ghost cut
+ * @param[in] track1 1st charged track in a pair
+ * @param[in] track1 2nd charged track in a pair
+ */
+unsigned int GetGhostMask(const ChargedTrack& track1, const ChargedTrack& track2);
+
+/*! @struct PairMasks
+ * @brief Masks of detectors (DETECTOR_BIT) of a pair of charged tracks for the given ids 
+ *
+ * Masks are evaluated once per pair from the masks of the tracks (see ChargedTrack::SetMasks) and the ghost mask of a pair (see GetGhostMask) so that all pair selections below are evaluated with bitwise operations. Selections give the same results as the functions with the same names that compare the ids of the tracks
+ */
+struct PairMasks
+{
+   /*! @brief Constructor
+    * @param[in] track1 1st charged track in a pair
+    * @param[in] track1 2nd charged track in a pair
+    * @param[in] ghostMask mask of detectors for which the pair does not pass pair ghost cut
+    * @param[in] id1 id of a 1st track in a pair
+    * @param[in] id2 id of a 2nd track in a pair
+    */
+   PairMasks(const ChargedTrack& track1, const ChargedTrack& track2, 
+             const unsigned int ghostMask, const int id1, const int id2);
+   /// detectors for which the pair does not pass pair ghost cut
+   unsigned int ghost;
+   /// detectors in which both tracks are registered
+   unsigned int registered;
+   /// detectors in which both tracks are registered and the pair passes pair ghost cut
+   unsigned int noPID;
+   /// detectors in which the 1st track is identified as id1
+   unsigned int identified1;
+   /// detectors in which the 2nd track is identified as id2
+   unsigned int identified2;
+   /// detectors in which at least one track is identified as id1 
+   /// and the pair passes pair ghost cut
+   unsigned int identifiedAny;
+};
+
+/// Returns true if charged tracks in a pair are both registered and passed all cuts in PC2
+bool IsPC2NoPID(const PairMasks& masks);
+/// Returns true if charged tracks in a pair are both registered and passed all cuts in PC3
+bool IsPC3NoPID(const PairMasks& masks);
+/// Returns true if charged tracks in a pair are both registered and passed all cuts in EMCal
+bool IsEMCalNoPID(const PairMasks& masks);
+/// Returns true if charged tracks in a pair are both registered and passed all cuts in TOFe
+bool IsTOFeNoPID(const PairMasks& masks);
+/// Returns true if charged tracks in a pair are both registered and passed all cuts in TOFw
+bool IsTOFwNoPID(const PairMasks& masks);
+/// Returns true if charged tracks in a pair are both registered and passed all cuts 
+/// in either PC2, PC3, EMCal, TOFe, or TOFw
+bool IsNoPID(const PairMasks& masks);
+/// Returns true if at least one charged track in a pair is identified in TOFe, TOFw, or EMCal 
+/// while the other has no NoPID requirements
+bool IsDCPC11PID(const PairMasks& masks);
+/// Returns true if at least one charged track in a pair is identified in TOFe or TOFw 
+/// while the other has no NoPID requirements
+bool Is1TOFDCPC11PID(const PairMasks& masks);
+/// Returns true if at least one charged track in a pair is identified in EMCal
+/// while the other has no NoPID requirements
+bool Is1EMCalDCPC11PID(const PairMasks& masks);
+/// Returns true if at least one charged track in a pair is identified in TOFe or TOFw, or EMCal
+bool Is1PID(const PairMasks& masks);
+/// Returns true if at least one charged track in a pair is identified in TOFe or TOFw
+bool Is1TOF1PID(const PairMasks& masks);
+/// Returns true if at least one charged track in a pair is identified in EMCal
+bool Is1EMCal1PID(const PairMasks& masks);
+/// Returns true if both of charged tracks in a pair are identified in TOFe
+bool IsTOFe2PID(const PairMasks& masks);
+/// Returns true if both of charged tracks in a pair are identified in TOFw
+bool IsTOFw2PID(const PairMasks& masks);
+/// Returns true if both of charged tracks in a pair are identified in TOFe or TOFw
+bool IsTOF2PID(const PairMasks& masks);
+/// Returns true if both of charged tracks in a pair are identified in EMCal
+bool IsEMCal2PID(const PairMasks& masks);
+/// Returns true if 1 track of a pair was identified in TOF and the other in EMCal
+bool Is1TOF1EMCal2PID(const PairMasks& masks);
+/// Returns true if both of charged tracks in a pair are either identified in EMCal, TOFe, or TOFw
+bool Is2PID(const PairMasks& masks);
+
+inline unsigned long TrackBlock::GetSize() const
+{
+   return e.size();
+}
+
+inline PairMasks::PairMasks(const ChargedTrack& track1, const ChargedTrack& track2, 
+                            const unsigned int ghostMask, const int id1, const int id2)
+{
+   ghost = ghostMask;
+   registered = track1.registeredMask & track2.registeredMask;
+   noPID = registered & ~ghost;
+   identified1 = track1.GetIdMask(id1);
+   identified2 = track2.GetIdMask(id2);
+   identifiedAny = (identified1 | track2.GetIdMask(id1)) & ~ghost;
+}
+
+inline bool IsPC2NoPID(const PairMasks& masks)
+{
+   return (masks.noPID & DETECTOR_BIT::PC2);
+}
+
+inline bool IsPC3NoPID(const PairMasks& masks)
+{
+   return (masks.noPID & DETECTOR_BIT::PC3);
+}
+
+inline bool IsEMCalNoPID(const PairMasks& masks)
+{
+   return (masks.noPID & DETECTOR_BIT::EMCAL);
+}
+
+inline bool IsTOFeNoPID(const PairMasks& masks)
+{
+   return (masks.noPID & DETECTOR_BIT::TOFE);
+}
+
+inline bool IsTOFwNoPID(const PairMasks& masks)
+{
+   return (masks.noPID & DETECTOR_BIT::TOFW);
+}
+
+inline bool IsNoPID(const PairMasks& masks)
+{
+   return (masks.noPID != 0);
+}
+
+inline bool IsDCPC11PID(const PairMasks& masks)
+{
+   return (masks.identifiedAny & (DETECTOR_BIT::TOF | DETECTOR_BIT::EMCAL));
+}
+
+inline bool Is1TOFDCPC11PID(const PairMasks& masks)
+{
+   return (masks.identifiedAny & DETECTOR_BIT::TOF);
+}
+
+inline bool Is1EMCalDCPC11PID(const PairMasks& masks)
+{
+   return (masks.identifiedAny & DETECTOR_BIT::EMCAL);
+}
+
+inline bool Is1PID(const PairMasks& masks)
+{
+   return (IsNoPID(masks) && IsDCPC11PID(masks));
+}
+
+inline bool Is1TOF1PID(const PairMasks& masks)
+{
+   return (IsNoPID(masks) && Is1TOFDCPC11PID(masks));
+}
+
+inline bool Is1EMCal1PID(const PairMasks& masks)
+{
+   return (IsNoPID(masks) && Is1EMCalDCPC11PID(masks));
+}
+
+inline bool IsTOFe2PID(const PairMasks& masks)
+{
+   return (masks.identified1 & masks.identified2 & ~masks.ghost & DETECTOR_BIT::TOFE);
+}
+
+inline bool IsTOFw2PID(const PairMasks& masks)
+{
+   // ghost cut is not applied for TOFw same as in IsTOFw2PID for tracks
+   return (masks.identified1 & masks.identified2 & DETECTOR_BIT::TOFW);
+}
+
+inline bool IsTOF2PID(const PairMasks& masks)
+{
+   return (IsTOFe2PID(masks) || IsTOFw2PID(masks));
+}
+
+inline bool IsEMCal2PID(const PairMasks& masks)
+{
+   return (masks.identified1 & masks.identified2 & ~masks.ghost & DETECTOR_BIT::EMCAL);
+}
+
+inline bool Is1TOF1EMCal2PID(const PairMasks& masks)
+{
+   return ((((masks.identified1 & DETECTOR_BIT::EMCAL) && 
+             (masks.identified2 & DETECTOR_BIT::TOF)) ||
+            ((masks.identified1 & DETECTOR_BIT::TOF) && 
+             (masks.identified2 & DETECTOR_BIT::EMCAL))) &&
+           (masks.ghost & DETECTOR_BIT::TOF) != DETECTOR_BIT::TOF &&
+           !(masks.ghost & DETECTOR_BIT::EMCAL));
+}
+
+inline bool Is2PID(const PairMasks& masks)
+{
+   return (IsTOF2PID(masks) || IsEMCal2PID(masks) || Is1TOF1EMCal2PID(masks));
+}
 
 #endif /* PAIR_TRACK_FUNC_HPP */
@@ -0,0 +1,112 @@
+/**
+ *  @file   ProgressMonitor.hpp
+ *  @brief  Contains declaration of class ProgressMonitor that can be used to count processed events, tracks, and read bytes from many threads and to report the progress, the throughput, and the estimated remaining time of the event loops
+ *
+ *  This file is a part of a project PairAnalysisPhenix (https://github.com/Sergeyir/PairAnalysisPhenix).
+ *
+ *  @author Sergei Antsupov (antsupov0124@gmail.com)
+ **/
+#ifndef PROGRESS_MONITOR_HPP
+#define PROGRESS_MONITOR_HPP
+
+#include <array>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unordered_map>
+
+#include "TFile.h"
+
+#include "StrTools.hpp"
+
+/*! @class ProgressMonitor
+ * @brief Counts processed events, tracks, and read bytes from many threads without shared writes and evaluates the rates and the estimated remaining time of the current stage (e.g. configuration)
+ *
+ * Every thread increments only its own counters that are placed on separate cache lines, so increments are neither locked nor contended; the counters of all threads are summed only when they are read (e.g. by the progress bar thread). Bytes read by ROOT from all files (TFile::GetFileBytesRead) are added to the bytes counted by the threads
+ */
+class ProgressMonitor
+{
+   public:
+
+   /// counters of the monitor; pair counters are only used by the pair analyzers
+   enum Counter {EVENTS = 0, TRACKS, BYTES, PAIRS, PRUNED_PAIRS, LOST_PRUNED_PAIRS,
+                 NUMBER_OF_COUNTERS};
+   /// Default constructor
+   ProgressMonitor();
+   /// Copy constructor (deleted since the threads keep pointers to their counters)
+   ProgressMonitor(const ProgressMonitor&) = delete;
+   /// adds the value to the counter of the current thread
+   void Add(const Counter counter, const unsigned long value = 1);
+   /// returns the counter summed over all threads
+   unsigned long Get(const Counter counter);
+   /*! @brief Starts the new stage; rates and the remaining time are evaluated for the current stage
+    * @param[in] name name of the stage that is printed in the status
+    * @param[in] numberOfEvents number of events to be processed in the stage
+    */
+   void StartStage(const std::string& name, const unsigned long numberOfEvents);
+   /// returns the fraction of processed events from the number of events of all stages
+   double GetProgress(const unsigned long numberOfEvents);
+   /// returns the status of the current stage: rates of events, tracks, and bytes
+   /// and the estimated remaining time
+   std::string GetStatus();
+   /// Destructor
+   virtual ~ProgressMonitor() = default;
+
+   private:
+
+   /// counters of one thread; alignment prevents the counters
+   /// of different threads from sharing the same cache line
+   struct alignas(64) Shard
+   {
+      /// counters (only written by the thread the shard belongs to)
+      std::array<std::atomic<unsigned long>, NUMBER_OF_COUNTERS> counters{};
+   };
+   /// returns the shard of the current thread (the shard is created on the first call)
+   Shard& GetShard();
+   /// creates the shard for the current thread or returns the existing one
+   Shard& AddShard();
+   /// returns bytes counted by the threads and bytes read by ROOT
+   unsigned long GetBytes();
+   /// number that distinguishes the monitor in the thread local cache of shards
+   const unsigned long id;
+   /// mutex for adding and reading shards and for the stage parameters
+   std::mutex shardsMutex;
+   /// shards of the threads (unique_ptr keeps the addresses valid when the map is rehashed)
+   std::unordered_map<std::thread::id, std::unique_ptr<Shard>> shards;
+   /// name of the current stage
+   std::string stageName;
+   /// number of events in the current stage
+   unsigned long stageNumberOfEvents = 0;
+   /// values of the counters when the current stage started
+   std::array<unsigned long, NUMBER_OF_COUNTERS> stageStartCounters{};
+   /// time when the current stage started
+   std::chrono::steady_clock::time_point stageStartTime;
+};
+
+inline ProgressMonitor::Shard& ProgressMonitor::GetShard()
+{
+   // shard of the last monitor this thread has used
+   thread_local unsigned long cachedId = 0;
+   thread_local Shard *cachedShard = nullptr;
+
+   if (cachedId != id)
+   {
+      cachedShard = &AddShard();
+      cachedId = id;
+   }
+   return *cachedShard;
+}
+
+inline void ProgressMonitor::Add(const Counter counter, const unsigned long value)
+{
+   std::atomic<unsigned long>& count = GetShard().counters[counter];
+   // only the current thread writes to its shard so relaxed load and store are enough;
+   // atomic is only needed so that the reads from other threads are not torn
+   count.store(count.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+#endif /* PROGRESS_MONITOR_HPP */
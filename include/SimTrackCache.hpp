@@ -0,0 +1,280 @@
+/**
+ *  @file   SimTrackCache.hpp
+ *  @brief  Contains declarations of struct SimTrack and classes SimTrackCacheWriter and SimTrackCacheReader that can be used to store derived quantities of simulated charged tracks and to replay them without reading the simulated trees
+ *
+ *  This file is a part of a project PairAnalysisPhenix (https://github.com/Sergeyir/PairAnalysisPhenix).
+ *
+ *  @author Sergei Antsupov (antsupov0124@gmail.com)
+ **/
+#ifndef SIM_TRACK_CACHE_HPP
+#define SIM_TRACK_CACHE_HPP
+
+#include <mutex>
+#include <cstdio>
+#include <vector>
+#include <string>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <functional>
+#include <algorithm>
+#include <filesystem>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "ROOT/TSeq.hxx"
+#include "ROOT/TThreadExecutor.hxx"
+
+#include "ErrorHandler.hpp"
+
+/*! @struct SimTrack
+ * @brief Raw and derived quantities of a simulated charged track that are needed to fill all single track histograms
+ *
+ * Derived quantities that require calibrations (sigmalized residuals) or dead maps are evaluated once when the track is read from the simulated tree. Quantities that depend on the values that are tuned between the runs (weights, time shifts, cut thresholds) are stored as raw variables so that they can be changed when the track is replayed from the cache. SimTrack is a trivially copyable type since it is written in and read from the cache as it is
+ */
+struct SimTrack
+{
+   /// index of the track in the event
+   int index;
+   /// charge (same as in PHCentralTrack)
+   short charge;
+   /// dcarm (same as in PHCentralTrack)
+   short dcarm;
+   /// qual (same as in PHCentralTrack)
+   short qual;
+   /// nx1hits (same as in PHCentralTrack)
+   short nx1hits;
+   /// nx2hits (same as in PHCentralTrack)
+   short nx2hits;
+   /// sect (same as in PHCentralTrack)
+   short sect;
+   /// ysect (same as in PHCentralTrack)
+   short ysect;
+   /// zsect (same as in PHCentralTrack)
+   short zsect;
+   /// slat (same as in PHCentralTrack)
+   short slat;
+   /// striptofw (same as in PHCentralTrack)
+   short striptofw;
+   /// true if the track is the original simulated particle
+   bool isParticleOrig;
+   /// true if the track is in the dead area of DC
+   bool isDeadDC;
+   /// true if the track is in the dead area of PC1
+   bool isDeadPC1;
+   /// true if the track is in the dead area of PC2 (only evaluated if the track has a hit in PC2)
+   bool isDeadPC2;
+   /// true if the track is in the dead area of PC3 (only evaluated if the track has a hit in PC3)
+   bool isDeadPC3;
+   /// true if the track is in the dead area of EMCal (only evaluated if the track has a hit in EMCal)
+   bool isDeadEMCal;
+   /// true if the track is in the dead area of TOFe (only evaluated if the track has a hit in TOFe)
+   bool isDeadTOFe;
+   /// true if the track is in the dead area of TOFw (only evaluated if the track has a hit in TOFw)
+   bool isDeadTOFw;
+   /// phi (same as in PHCentralTrack)
+   float phi;
+   /// alpha (same as in PHCentralTrack)
+   float alpha;
+   /// zed (same as in PHCentralTrack)
+   float zed;
+   /// mom (same as in PHCentralTrack)
+   float mom;
+   /// the0 (same as in PHCentralTrack)
+   float the0;
+   /// phi0 (same as in PHCentralTrack)
+   float phi0;
+   /// ppc1z (same as in PHCentralTrack)
+   float ppc1z;
+   /// ppc2z (same as in PHCentralTrack)
+   float ppc2z;
+   /// ppc3z (same as in PHCentralTrack)
+   float ppc3z;
+   /// pc2dphi (same as in PHCentralTrack)
+   float pc2dphi;
+   /// pc2dz (same as in PHCentralTrack)
+   float pc2dz;
+   /// pc3dphi (same as in PHCentralTrack)
+   float pc3dphi;
+   /// pc3dz (same as in PHCentralTrack)
+   float pc3dz;
+   /// emcdphi (same as in PHCentralTrack)
+   float emcdphi;
+   /// emcdz (same as in PHCentralTrack)
+   float emcdz;
+   /// ecore (same as in PHCentralTrack)
+   float ecore;
+   /// prob (same as in PHCentralTrack)
+   float prob;
+   /// temc (same as in PHCentralTrack)
+   float temc;
+   /// plemc (same as in PHCentralTrack)
+   float plemc;
+   /// tofdphi (same as in PHCentralTrack)
+   float tofdphi;
+   /// tofdz (same as in PHCentralTrack)
+   float tofdz;
+   /// ttof (same as in PHCentralTrack)
+   float ttof;
+   /// pltof (same as in PHCentralTrack)
+   float pltof;
+   /// etof (same as in PHCentralTrack)
+   float etof;
+   /// tofwdphi (same as in PHCentralTrack)
+   float tofwdphi;
+   /// tofwdz (same as in PHCentralTrack)
+   float tofwdz;
+   /// ttofw (same as in PHCentralTrack)
+   float ttofw;
+   /// pltofw (same as in PHCentralTrack)
+   float pltofw;
+   /// transverse momentum [GeV/c]
+   double pT;
+   /// DC board
+   double board;
+   /// phi coordinate in PC1 (shifted to [0, 2pi] for PC1e)
+   double ppc1phi;
+   /// phi coordinate in PC2
+   double pc2phi;
+   /// phi coordinate in PC3 (shifted to [0, 2pi] for PC3e)
+   double pc3phi;
+   /// sigmalized dphi in PC2
+   double pc2sdphi;
+   /// sigmalized dz in PC2
+   double pc2sdz;
+   /// sigmalized dphi in PC3
+   double pc3sdphi;
+   /// sigmalized dz in PC3
+   double pc3sdz;
+   /// sigmalized dphi in EMCal
+   double emcsdphi;
+   /// sigmalized dz in EMCal
+   double emcsdz;
+   /// sigmalized dphi in TOFe
+   double tofesdphi;
+   /// sigmalized dz in TOFe
+   double tofesdz;
+   /// sigmalized dphi in TOFw
+   double tofwsdphi;
+   /// sigmalized dz in TOFw
+   double tofwsdz;
+};
+
+/*! @brief Returns the hash of the inputs from which the derived quantities of SimTrack are evaluated
+ *
+ * Contents of all .txt files in the specified directories (dead maps and calibrations), options, and parameters are hashed; the cache is considered outdated if the hash changes
+ *
+ * @param[in] inputDirs directories with the input files (directories that do not exist are hashed by their names)
+ * @param[in] options options with which the inputs were initialized (e.g. detectors_configuration)
+ * @param[in] parameters parameters used to evaluate derived quantities (e.g. DC board offsets)
+ */
+unsigned long GetSimTrackCacheInputsHash(const std::vector<std::string>& inputDirs,
+                                         const std::string& options,
+                                         const std::vector<double>& parameters);
+
+/*! @class SimTrackCacheWriter
+ * @brief Writes events with SimTrack records into the binary cache file
+ *
+ * Cache file consists of a header followed by events; each event is an event record (original pT and the number of tracks) followed by the SimTrack records of this event. Events can be written from several threads and their order in the file is not defined. The events are written in the temporary file that is renamed into the cache file only after the header is finalized so that an unfinished cache is never used
+ */
+class SimTrackCacheWriter
+{
+   public:
+
+   /// Default constructor (deleted)
+   SimTrackCacheWriter() = delete;
+   /*! @brief Constructor
+    * @param[in] fileName name of the cache file (the directories are created if they do not exist)
+    * @param[in] sourceFileName name of the file with the simulated tree from which the tracks are read
+    * @param[in] inputsHash hash of the inputs of the derived quantities (see GetSimTrackCacheInputsHash)
+    */
+   SimTrackCacheWriter(const std::string& fileName, const std::string& sourceFileName,
+                       const unsigned long inputsHash);
+   /*! @brief Appends the event to the cache file
+    * @param[in] origPT original pT of the simulated particle
+    * @param[in] tracks tracks of the event
+    */
+   void Write(const double origPT, const std::vector<SimTrack>& tracks);
+   /// Destructor; finalizes the header of the file and moves it into the cache file
+   virtual ~SimTrackCacheWriter();
+
+   private:
+
+   /// name of the cache file
+   std::string fileName;
+   /// name of the temporary file in which the cache is written (contains the id of the process
+   /// so that several processes writing the same cache do not write into the same file)
+   std::string tmpFileName;
+   /// size of the file with the simulated tree in bytes
+   unsigned long sourceSize;
+   /// last write time of the file with the simulated tree
+   long sourceTime;
+   /// hash of the inputs of the derived quantities
+   unsigned long inputsHash;
+   /// output stream of the cache file
+   std::ofstream file;
+   /// number of written events
+   unsigned long numberOfEvents = 0;
+   /// mutex for writing from several threads
+   std::mutex writeMutex;
+};
+
+/*! @class SimTrackCacheReader
+ * @brief Memory maps the cache file written by SimTrackCacheWriter and provides access to its events
+ */
+class SimTrackCacheReader
+{
+   public:
+
+   /// Default constructor (deleted)
+   SimTrackCacheReader() = delete;
+   /*! @brief Constructor
+    * @param[in] fileName name of the cache file
+    * @param[in] sourceFileName name of the file with the simulated tree from which the cache was written
+    * @param[in] inputsHash hash of the inputs of the derived quantities (see GetSimTrackCacheInputsHash)
+    */
+   SimTrackCacheReader(const std::string& fileName, const std::string& sourceFileName,
+                       const unsigned long inputsHash);
+   /// returns the number of events in the cache
+   unsigned long GetNumberOfEvents() const;
+   /// returns the original pT of the simulated particle of i-th event
+   double GetOrigPT(const unsigned long i) const;
+   /// returns the number of tracks in i-th event
+   unsigned long GetNumberOfTracks(const unsigned long i) const;
+   /// returns the pointer to the first track of i-th event
+   const SimTrack *GetTracks(const unsigned long i) const;
+   /*! @brief Processes the events of the cache in parallel
+    * (ROOT::EnableImplicitMT must be called beforehand to use more than 1 thread)
+    *
+    * func is called once for each task with the range [firstEvent, lastEvent) of events of this task
+    *
+    * @param[in] func function that is called for each task
+    */
+   void Process(const std::function<void(const SimTrackCacheReader&, const unsigned long,
+                                         const unsigned long)>& func) const;
+   /*! @brief Returns true if the cache file exists, was written with the same version of SimTrack,
+    * and matches the file with the simulated tree (size and last write time) and the inputs
+    *
+    * @param[in] fileName name of the cache file
+    * @param[in] sourceFileName name of the file with the simulated tree from which the cache was written
+    * @param[in] inputsHash hash of the inputs of the derived quantities (see GetSimTrackCacheInputsHash)
+    */
+   static bool IsValid(const std::string& fileName, const std::string& sourceFileName,
+                       const unsigned long inputsHash);
+   /// Destructor; unmaps the file
+   virtual ~SimTrackCacheReader();
+
+   private:
+
+   /// memory mapped contents of the file
+   const char *data = nullptr;
+   /// size of the file in bytes
+   size_t size = 0;
+   /// offsets of the event records from the beginning of the file
+   std::vector<size_t> eventOffsets;
+};
+
+#endif /* SIM_TRACK_CACHE_HPP */
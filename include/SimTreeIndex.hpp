@@ -0,0 +1,84 @@
+/**
+ *  @file   SimTreeIndex.hpp
+ *  @brief  Contains declaration of class SimTreeIndex that can be used to skim trees obtained from PHENIX simulation by event level variables without reading the full entries
+ *
+ *  This file is a part of a project PairAnalysisPhenix (https://github.com/Sergeyir/PairAnalysisPhenix).
+ *
+ *  @author Sergei Antsupov (antsupov0124@gmail.com)
+ **/
+
+#ifndef SIM_TREE_INDEX_HPP
+#define SIM_TREE_INDEX_HPP
+
+#include <cmath>
+#include <mutex>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <filesystem>
+
+#include "TFile.h"
+#include "TTree.h"
+#include "TParameter.h"
+
+#include "ErrorHandler.hpp"
+
+#include "SimTreeReader.hpp"
+
+/*! @class SimTreeIndex
+ * @brief Sidecar index of a simulated tree file that stores the entry number, original pT, bbcz and nch of every event
+ *
+ * Index is stored in the file next to the simulated tree (see GetIndexFileName) and is built with bin/BuildSimTreeIndex. Index is considered outdated and is not used if the simulated tree file was modified after the index was built
+ */
+class SimTreeIndex
+{
+   public:
+
+   /// Default constructor
+   SimTreeIndex() = default;
+   /*! @brief Builds the index for the simulated tree file and writes it in the index file
+    * (ROOT::EnableImplicitMT must be called beforehand to use more than 1 thread)
+    *
+    * @param[in] simFileName name of the file with the simulated tree or RNTuple
+    */
+   static void Build(const std::string& simFileName);
+   /*! @brief Reads the index of the simulated tree file
+    *
+    * @param[in] simFileName name of the file with the simulated tree or RNTuple
+    *
+    * Returns false if the index does not exist or is outdated
+    */
+   bool Load(const std::string& simFileName);
+   /// returns the number of indexed events
+   unsigned long GetSize() const;
+   /// returns the entry number of i-th indexed event
+   unsigned long entry(const unsigned long i) const;
+   /// returns the original pT of i-th indexed event
+   double origPT(const unsigned long i) const;
+   /// returns bbcz of i-th indexed event
+   float bbcz(const unsigned long i) const;
+   /// returns nch of i-th indexed event
+   short nch(const unsigned long i) const;
+   /// returns the name of the index file for the simulated tree file
+   static std::string GetIndexFileName(const std::string& simFileName);
+   /// returns true if the index for the simulated tree file exists and is not outdated
+   static bool IsValid(const std::string& simFileName);
+   /*! @brief Returns the number of events in the simulated tree file
+    *
+    * Number of events is taken from the index if it is valid; otherwise the tree or RNTuple is opened
+    */
+   static unsigned long GetNumberOfEntries(const std::string& simFileName);
+
+   private:
+
+   /// entry numbers of the indexed events
+   std::vector<unsigned long> entries;
+   /// original pT of the indexed events
+   std::vector<double> origPTs;
+   /// bbcz of the indexed events
+   std::vector<float> bbczs;
+   /// nch of the indexed events
+   std::vector<short> nchs;
+};
+
+#endif /* SIM_TREE_INDEX_HPP */
@@ -10,22 +10,268 @@
 #ifndef SIM_TREE_READER_HPP
 #define SIM_TREE_READER_HPP
 
+#include <vector>
+#include <string>
+#include <memory>
+#include <utility>
+#include <algorithm>
+#include <functional>
+#include <thread>
+#include <atomic>
+#include <numeric>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "RVersion.h"
+#include "TEnv.h"
+#include "TKey.h"
+#include "TFile.h"
+#include "TTree.h"
+#include "TBranch.h"
+#include "TTreeReader.h"
 #include "TTreeReaderArray.h"
 #include "TTreeReaderValue.h"
+#include "TEntryList.h"
+#include "TTreeCache.h"
+
+#include "ROOT/TSeq.hxx"
+#include "ROOT/TThreadExecutor.hxx"
+#include "ROOT/TTreeProcessorMT.hxx"
+
+// RNTuple is read and written only with the stable API that appeared in ROOT 6.36
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6, 36, 0)
+#define SIM_TREE_READER_RNTUPLE
+#include "ROOT/RNTupleView.hxx"
+#include "ROOT/RNTupleReader.hxx"
+#endif
+
+#include "IOTools.hpp"
+#include "Box.hpp"
+
+/*! @struct SimEventSnapshot
+ * @brief Contiguous per-event copies (struct of arrays indexed by track) of the branches that are used in the analysis of simulated trees
+ *
+ * Snapshot is filled once per event via SimTreeReader::Snapshot() so that the track loop reads plain arrays instead of calling TTreeReaderArray accessors for every variable of every track. Buffers are reused between the events and are only reallocated when the number of tracks exceeds the largest one encountered before
+ */
+struct SimEventSnapshot
+{
+   /// number of charged particles
+   int nch;
+   /// bbcz (same as in PHCentralTrack)
+   float bbcz;
+   /// original momentum (i=0,1,2 for px,py,pz respectively)
+   float mom_orig[3];
+   /// dcarm of all tracks in the event (same as in PHCentralTrack)
+   std::vector<short> dcarm;
+   /// phi of all tracks in the event (same as in PHCentralTrack)
+   std::vector<float> phi;
+   /// alpha of all tracks in the event (same as in PHCentralTrack)
+   std::vector<float> alpha;
+   /// zed of all tracks in the event (same as in PHCentralTrack)
+   std::vector<float> zed;
+   /// mom of all tracks in the event (same as in PHCentralTrack)
+   std::vector<float> mom;
+   /// the0 of all tracks in the event (same as in PHCentralTrack)
+   std::vector<float> the0;
+   /// phi0 of all tracks in the event (same as in PHCentralTrack)
+   std::vector<float> phi0;
+   /// nx1hits of all tracks in the event (same as in PHCentralTrack)
+   std::vector<short> nx1hits;
+   /// nx2hits of all tracks in the event (same as in PHCentralTrack)
+   std::vector<short> nx2hits;
+   /// qual of all tracks in the event (same as in PHCentralTrack)
+   std::vector<short> qual;
+   /// charge of all tracks in the event (same as in PHCentralTrack)
+   std::vector<short> charge;
+   /// primary_id of all tracks in the event (same as in PHCentralTrack)
+   std::vector<short> primary_id;
+   /// particle_id of all tracks in the event (same as in PHCentralTrack)
+   std::vector<short> particle_id;
+   /// ttof of all tracks in the event (same as in PHCentralTrack)
+   std::vector<float> ttof;
+   /// ttofw of all tracks in the event (same as in PHCentralTrack)
+   std::vector<float> ttofw;
+   /// temc of all tracks in the event (same as in PHCentralTrack)
+   std::vector<float> temc;
+   /// pltof of all tracks in the event (same as in PHCentralTrack)
+   std::vector<float> pltof;
+   /// pltofw of all tracks in the event (same as in PHCentralTrack)
+   std::vector<float> pltofw;
+   /// plemc of all tracks in the event (same as in PHCentralTrack)
+   std::vector<float> plemc;
+   /// ppc1x of all tracks in the event (same as in PHCentralTrack)
+   std::vector<float> ppc1x;
+   /// ppc1y of all tracks in the event (same as in PHCentralTrack)
+   std::vector<float> ppc1y;
+   /// ppc1z of all tracks in the event (same as in PHCentralTrack)
+   std::vector<float> ppc1z;
+   /// ppc2x of all tracks in the event (same as in PHCentralTrack)
+   std::vector<float> ppc2x;
+   /// ppc2y of all tracks in the event (same as in PHCentralTrack)
+   std::vector<float> ppc2y;
+   /// ppc2z of all tracks in the event (same as in PHCentralTrack)
+   std::vector<float> ppc2z;
+   /// ppc3x of all tracks in the event (same as in PHCentralTrack)
+   std::vector<float> ppc3x;
+   /// ppc3y of all tracks in the event (same as in PHCentralTrack)
+   std::vector<float> ppc3y;
+   /// ppc3z of all tracks in the event (same as in PHCentralTrack)
+   std::vector<float> ppc3z;
+   /// tofdz of all tracks in the event (same as in PHCentralTrack)
+   std::vector<float> tofdz;
+   /// tofdphi of all tracks in the event (same as in PHCentralTrack)
+   std::vector<float> tofdphi;
+   /// tofwdz of all tracks in the event (same as in PHCentralTrack)
+   std::vector<float> tofwdz;
+   /// tofwdphi of all tracks in the event (same as in PHCentralTrack)
+   std::vector<float> tofwdphi;
+   /// emcdz of all tracks in the event (same as in PHCentralTrack)
+   std::vector<float> emcdz;
+   /// emcdphi of all tracks in the event (same as in PHCentralTrack)
+   std::vector<float> emcdphi;
+   /// pc2dz of all tracks in the event (same as in PHCentralTrack)
+   std::vector<float> pc2dz;
+   /// pc2dphi of all tracks in the event (same as in PHCentralTrack)
+   std::vector<float> pc2dphi;
+   /// pc3dz of all tracks in the event (same as in PHCentralTrack)
+   std::vector<float> pc3dz;
+   /// pc3dphi of all tracks in the event (same as in PHCentralTrack)
+   std::vector<float> pc3dphi;
+   /// striptofw of all tracks in the event (same as in PHCentralTrack)
+   std::vector<short> striptofw;
+   /// slat of all tracks in the event (same as in PHCentralTrack)
+   std::vector<short> slat;
+   /// etof of all tracks in the event (same as in PHCentralTrack)
+   std::vector<float> etof;
+   /// ecore of all tracks in the event (same as in PHCentralTrack)
+   std::vector<float> ecore;
+   /// prob of all tracks in the event (same as in PHCentralTrack)
+   std::vector<float> prob;
+   /// sect of all tracks in the event (same as in PHCentralTrack)
+   std::vector<short> sect;
+   /// ysect of all tracks in the event (same as in PHCentralTrack)
+   std::vector<short> ysect;
+   /// zsect of all tracks in the event (same as in PHCentralTrack)
+   std::vector<short> zsect;
+};
 
 /*! @class SimTreeReader
  * @brief Class SimTreeReadercan be used to read data from Trees that were obtained from PHENIX simulation 
  *
- * See AnalyzeSingleTrack.cpp on its usage
+ * Both TTree and RNTuple (if ROOT supports it) inputs are supported. Per-track accessors are only available for TTree input while SimEventSnapshot is available for both. See AnalyzeSingleTrack.cpp on its usage
  */
 class SimTreeReader
 {
    public :
    /*! @brief Constructor with parameters
     * 
+    * Only the branches from the specified list are bound to the reader so that the baskets of other branches are never read or decompressed. Accessors and SimEventSnapshot members of the branches that are not in the list must not be used. Branch nch is always read since the number of tracks is needed to copy the arrays
+    *
     * @param[in] reader TTreeReader variable that will be used to point branches of a TTree to
+    * @param[in] branches names of the branches that will be read (all branches are read if the list is empty)
+    * @param[in] entries list of entries to be read; if specified the entries from the positions [firstEntry, lastEntry) in this list are loaded via TTreeReader::SetEntry instead of TTreeReader::Next
+    * @param[in] firstEntry first position in the list of entries to be read
+    * @param[in] lastEntry position after the last one in the list of entries to be read
+    */
+   SimTreeReader(TTreeReader &reader, const std::vector<std::string>& branches = {},
+                 const std::vector<unsigned long> *entries = nullptr, 
+                 const unsigned long firstEntry = 0, const unsigned long lastEntry = 0);
+   /*! @brief Constructor with parameters for reading the range of entries of RNTuple
+    *
+    * Only SimEventSnapshot is available for RNTuple input; per-track accessors must not be used
+    *
+    * @param[in] fileName name of the file in which RNTuple is stored
+    * @param[in] firstEntry first entry to be read
+    * @param[in] lastEntry entry after the last one to be read
+    * @param[in] branches names of the fields that will be read (all fields are read if the list is empty)
+    * @param[in] ntupleName name of the RNTuple in the file
+    * @param[in] entries list of entries to be read; if specified firstEntry and lastEntry are the positions in this list
+    */
+   SimTreeReader(const std::string& fileName, const unsigned long firstEntry, 
+                 const unsigned long lastEntry, const std::vector<std::string>& branches = {},
+                 const std::string& ntupleName = "Tree", 
+                 const std::vector<unsigned long> *entries = nullptr);
+   /// loads the next entry; returns false if there are no entries left
+   bool Next();
+   /// returns the number of the current entry in the tree or RNTuple
+   unsigned long GetCurrentEntry() const;
+   /*! @brief Processes the tree or RNTuple from the file in parallel 
+    * (ROOT::EnableImplicitMT must be called beforehand to use more than 1 thread)
+    *
+    * The format of the input is determined automatically. Function is called once for each task with SimTreeReader that iterates over the task's range of entries via SimTreeReader::Next()
+    *
+    * @param[in] fileName name of the file in which the tree or RNTuple is stored
+    * @param[in] branches names of the branches that will be read (all branches are read if the list is empty)
+    * @param[in] func function that is called for each task
+    * @param[in] treeName name of the tree or RNTuple in the file
+    * @param[in] entries sorted list of entries to be processed (all entries are processed if nullptr)
+    */
+   static void Process(const std::string& fileName, const std::vector<std::string>& branches,
+                       const std::function<void(SimTreeReader&)>& func, 
+                       const std::string& treeName = "Tree",
+                       const std::vector<unsigned long> *entries = nullptr);
+   /*! @brief Processes the trees or RNTuples from several files in parallel as one set of tasks
+    * (ROOT::EnableImplicitMT must be called beforehand to use more than 1 thread)
+    *
+    * Entries of all files are split into tasks (aligned to clusters for full trees) that the threads take from one shared queue. Tasks of the largest files are queued first so that the threads do not idle at the end of each file and the tasks of the smallest files fill the tail. Function is called once for each task with SimTreeReader that iterates over the task's range of entries and with the index of the task's file in fileNames so that the per-file parameters can be looked up
+    *
+    * @param[in] fileNames names of the files in which the trees or RNTuples are stored
+    * @param[in] branches names of the branches that will be read (all branches are read if the list is empty)
+    * @param[in] func function that is called for each task
+    * @param[in] treeName name of the trees or RNTuples in the files
+    * @param[in] entries sorted lists of entries to be processed for each file (all entries of the file are processed if its list is nullptr or if no lists are passed)
+    * @param[in] prefetchNextFile if true the next file in the queue is prefetched (see Prefetch) when the processing of the current one starts
+    */
+   static void Process(const std::vector<std::string>& fileNames, 
+                       const std::vector<std::string>& branches,
+                       const std::function<void(SimTreeReader&, const unsigned long)>& func, 
+                       const std::string& treeName = "Tree",
+                       const std::vector<const std::vector<unsigned long> *>& entries = {},
+                       const bool prefetchNextFile = false);
+   /// returns true if the object with the specified name in the file is RNTuple
+   static bool IsRNTuple(const std::string& fileName, const std::string& name = "Tree");
+   /// returns the number of entries in the tree or RNTuple with the specified name in the file
+   static unsigned long GetNumberOfEntries(const std::string& fileName, 
+                                           const std::string& name = "Tree");
+   /// returns true if the branch with the specified name is read
+   bool IsBranchRead(const std::string& branchName) const;
+   /*! @brief Prints the compressed bytes of each branch that were read from the trees by the job together with the size of all branches on disk
+    *
+    * Bytes of the branches are counted by every SimTreeReader of TTree input from the baskets it loaded and are added to the totals of the job when it is destroyed, so the report must be printed after the files were processed. Bytes read from all ROOT files by the process (TFile::GetFileBytesRead) are printed separately since they also include the metadata and the files that are not read with SimTreeReader; comparing the bytes read with the size of all branches on disk shows how much I/O is saved by reading only the active branches
+    *
+    * @param[in] fileNames names of the files from which the tree is read
+    * @param[in] branches names of the branches that are read (all branches are read if the list is empty)
+    * @param[in] treeName name of the tree in the files
+    */
+   static void PrintIOReport(const std::vector<std::string>& fileNames, 
+                             const std::vector<std::string>& branches,
+                             const std::string& treeName = "Tree");
+   /*! @brief Sets the parameters of reading trees for all files opened after this call
+    * (including the ones opened by ROOT::TTreeProcessorMT tasks)
+    *
+    * @param[in] cacheSizeFactor size of TTreeCache as a factor of the cluster size of the tree (0 disables the cache)
+    * @param[in] cacheLearnEntries number of entries TTreeCache learns which branches are read before prefetching them
+    * @param[in] asyncPrefetching if true the baskets are prefetched asynchronously in a separate thread
+    */
+   static void ConfigureIO(const double cacheSizeFactor = 1., const int cacheLearnEntries = 100,
+                           const bool asyncPrefetching = false);
+   /*! @brief Starts reading the file into the page cache in the background so that
+    * the file is warm by the time it is processed (e.g. the file of the next configuration
+    * can be prefetched while the current one is processed)
+    *
+    * @param[in] fileName name of the file to be prefetched
+    */
+   static void Prefetch(const std::string& fileName);
+   /// names of all branches that can be read by SimTreeReader
+   static const std::vector<std::string> allBranches;
+   /*! @brief Copies the branches of the current event that are stored in SimEventSnapshot into contiguous buffers
+    *
+    * Must be called after TTreeReader::Next(); the returned reference stays valid until the next call. Only the branches that are read are copied
+    *
+    * @return snapshot of the current event
     */
-   SimTreeReader(TTreeReader &reader);
+   const SimEventSnapshot& Snapshot();
    /// original momentum (i=0,1,2 for px,py,pz respectively)
    float mom_orig(int i) const;
    /// number of charged particles
@@ -196,6 +442,56 @@ class SimTreeReader
    ~SimTreeReader();
 
    private:
+   /// adds the compressed bytes of the baskets of the read branches 
+   /// that were loaded since the previous call to the bytes read by this reader
+   void CountBytesRead();
+   /// bytes of each branch (in the order of allBranches) read by all destroyed readers
+   static std::vector<std::atomic<unsigned long>> jobBranchesBytesRead;
+   /// tree from which the branches in countedBranches were taken
+   TTree *countedTree = nullptr;
+   /// branches of countedTree in the order of allBranches (nullptr if the branch is not read)
+   std::vector<TBranch *> countedBranches;
+   /// index of the last basket of each branch of which the bytes were counted
+   std::vector<int> lastCountedBaskets;
+   /// bytes of each branch (in the order of allBranches) read by this reader
+   std::vector<unsigned long> branchesBytesRead;
+   /// binds the branch to the reader if it is in the list of branches to be read
+   template<typename T>
+   void BindBranch(TTreeReader &reader, std::unique_ptr<T>& branch, const std::string& branchName);
+   /// names of the branches that are read (all branches are read if empty)
+   std::vector<std::string> branchesToRead;
+   /// reader for TTree input (nullptr for RNTuple input)
+   TTreeReader *treeReader = nullptr;
+   /// current entry for RNTuple input or for TTree input with the list of entries
+   unsigned long currentEntry = 0;
+   /// entry that will be loaded on the next call of Next() for RNTuple input
+   /// or for TTree input with the list of entries
+   unsigned long nextEntry = 0;
+   /// entry after the last one to be read for RNTuple input
+   /// or for TTree input with the list of entries
+   unsigned long lastEntry = 0;
+   /// list of entries to be read (all entries are read if nullptr)
+   const std::vector<unsigned long> *entriesToRead = nullptr;
+#ifdef SIM_TREE_READER_RNTUPLE
+   /// fills snapshot from RNTuple views
+   void SnapshotRNTuple();
+   /// reader for RNTuple input
+   std::unique_ptr<ROOT::RNTupleReader> ntupleReader;
+   /// view for number of charged particles field
+   std::unique_ptr<ROOT::RNTupleView<int>> v_nch;
+   /// view for bbcz field
+   std::unique_ptr<ROOT::RNTupleView<float>> v_bbcz;
+   /// view for original momentum field
+   std::unique_ptr<ROOT::RNTupleView<std::vector<float>>> v_mom_orig;
+   /// views for float per-track fields and the corresponding SimEventSnapshot members
+   std::vector<std::pair<std::vector<float> SimEventSnapshot::*, 
+                         ROOT::RNTupleView<std::vector<float>>>> floatViews;
+   /// views for short per-track fields and the corresponding SimEventSnapshot members
+   std::vector<std::pair<std::vector<short> SimEventSnapshot::*, 
+                         ROOT::RNTupleView<std::vector<short>>>> shortViews;
+#endif
+   /// per-event buffers that are filled by Snapshot()
+   SimEventSnapshot snapshot;
    /// branch for original momentum variables
    std::unique_ptr<TTreeReaderArray<float>> b_mom_orig;
    /// branch for number of charged particles variable
@@ -12,6 +12,7 @@
 #include <cmath>
 
 #include "SimTreeReader.hpp"
+#include "SimTrackCache.hpp"
 
 /*! @namespace PART_ID
  * @brief Contains constants that store absolute values of particle ids
@@ -28,6 +29,19 @@ namespace PART_ID
    const int FAIL_DUMMY = -999;
 }
 
+/*! @namespace DETECTOR_BIT
+ * @brief Contains bits of detectors in masks of charged tracks and pairs of charged tracks
+ */
+namespace DETECTOR_BIT
+{
+   const unsigned int PC2 = 1u << 0;
+   const unsigned int PC3 = 1u << 1;
+   const unsigned int EMCAL = 1u << 2;
+   const unsigned int TOFE = 1u << 3;
+   const unsigned int TOFW = 1u << 4;
+   const unsigned int TOF = TOFE | TOFW;
+}
+
 /*! @struct ChargedTrack
  * @brief Convenient data container for analysing simulated charged tracks
  */
@@ -37,15 +51,29 @@ struct ChargedTrack
    ChargedTrack() = delete;
    /*! @brief Constructor
     * @param[in] m mass of a particle [GeV/c^2]
-    * @param[in] simCNT SimTreeReader object for the current event of a tree from which particle was read
-    * @param[in] i partilce index in simCNT
+    * @param[in] simEvent snapshot of the current event of a tree from which particle was read
+    * @param[in] i partilce index in simEvent
     * @param[in] pTScale pT scale that will be applied to the current track
     */
-   ChargedTrack(const double m, const SimTreeReader& simCNT, const int i, const double pTScale = 1.);
+   ChargedTrack(const double m, const SimEventSnapshot& simEvent, 
+                const int i, const double pTScale = 1.);
+   /*! @brief Constructor
+    * @param[in] m mass of a particle [GeV/c^2]
+    * @param[in] track track read from the simulated tree or replayed from the track cache
+    */
+   ChargedTrack(const double m, const SimTrack& track);
+   /*! @brief Returns reconstructed phi obtained from PC2 [rad]
+    *
+    * phi is evaluated from the coordinates of the hit only on the first call since it is not needed for most of the tracks and pairs
+    */
+   double GetPC2Phi() const;
+   /*! @brief Returns reconstructed phi obtained from PC3 [rad]
+    *
+    * phi is evaluated from the coordinates of the hit only on the first call since it is not needed for most of the tracks and pairs
+    */
+   double GetPC3Phi() const;
    /// mass of a particle [GeV/c^2]
    double m;
-   /// index of SimTreeReader in the current event
-   int index;
    /// reconstructed X compoment of momentum of a track [GeV/c]
    double pX;
    /// reconstructed Y compoment of momentum of a track [GeV/c]
@@ -56,40 +84,53 @@ struct ChargedTrack
    double p;
    /// energy of a track [GeV]
    double e;
+   /// reconstructed phi obtained from PC2 (NaN until evaluated; use GetPC2Phi)
+   mutable double pc2phi = NAN;
+   /// reconstructed phi obtained from PC3 (NaN until evaluated; use GetPC3Phi)
+   mutable double pc3phi = NAN;
+   // variables below are read from the trees as floats so float does not lose precision
    /// reconstructed azimuthal angle of a track [rad]
-   double phi;
+   float phi;
    /// reconstructed polar angle of a track [rad]
-   double alpha;
+   float alpha;
    /// reconstructed zDC coordinate [cm]
-   double zed;
-   /// reconstructed phi obtained from PC2
-   double pc2phi;
+   float zed;
+   /// reconstructed x obtained from PC2
+   float pc2x;
+   /// reconstructed y obtained from PC2
+   float pc2y;
    /// reconstructed z obtained from PC2
-   double pc2z;
-   /// reconstructed phi obtained from PC3
-   double pc3phi;
+   float pc2z;
+   /// reconstructed x obtained from PC3
+   float pc3x;
+   /// reconstructed y obtained from PC3
+   float pc3y;
    /// reconstructed z obtained from PC3
-   double pc3z;
+   float pc3z;
+   /// index of a track in the current event
+   int index;
+   /// DC arm
+   short dcarm;
    /// EMCal sector
-   int sector;
+   short sector;
    /// y tower number in EMCal
-   int yTower;
+   short yTower;
    /// z tower number in EMCal
-   int zTower;
+   short zTower;
    /// slat number in TOFe
-   int slat;
+   short slat;
    /// strip number in TOFw
-   int strip;
+   short strip;
    /// id of a particle obtained in PC2
-   int idPC2 = PART_ID::JUNK;
+   short idPC2 = PART_ID::JUNK;
    /// id of a particle obtained in PC3
-   int idPC3 = PART_ID::JUNK;
+   short idPC3 = PART_ID::JUNK;
    /// id of a particle obtained in EMCal
-   int idEMCal = PART_ID::JUNK;
+   short idEMCal = PART_ID::JUNK;
    /// id of a particle obtained in TOFe
-   int idTOFe = PART_ID::JUNK;
+   short idTOFe = PART_ID::JUNK;
    /// id of a particle obtained in TOFw
-   int idTOFw = PART_ID::JUNK;
+   short idTOFw = PART_ID::JUNK;
    /// probability of a particle being registered in PC2
    double weightPC2 = 0.;
    /// probability of a particle being registered in PC3
@@ -106,6 +147,19 @@ struct ChargedTrack
    double weightIdTOFe = 0.;
    /// probability of a particle being identified in TOFw
    double weightIdTOFw = 0.;
+   /// mask of detectors (DETECTOR_BIT) in which the track was registered and passed all cuts
+   unsigned int registeredMask = 0;
+   /// mask of detectors (DETECTOR_BIT) in which the track was identified as identifiedId
+   unsigned int identifiedMask = 0;
+   /// id of a particle the track was identified as in EMCal, TOFe, or TOFw
+   int identifiedId = PART_ID::NONE;
+   /*! @brief Evaluates registeredMask, identifiedMask, and identifiedId from the ids in detectors
+    *
+    * Must be called every time the ids of a track are changed so that pair selections that use the masks can be evaluated with bitwise operations instead of comparing the ids of both tracks for every pair. In simulation a track is identified only as itself, i.e. the ids of a track in all detectors it was identified in are the same
+    */
+   void SetMasks();
+   /// returns the mask of detectors (DETECTOR_BIT) in which the track was identified as id
+   unsigned int GetIdMask(const int id) const;
 };
 
 /*! @brief Checks if the hit was detected in the given detector
@@ -139,4 +193,25 @@ bool IsGhostCut(const double theta, const double bbcVertex);
  */
 double TransformProb(double prob);
 
+inline double ChargedTrack::GetPC2Phi() const
+{
+   if (std::isnan(pc2phi)) pc2phi = atan2(pc2y, pc2x);
+   return pc2phi;
+}
+
+inline double ChargedTrack::GetPC3Phi() const
+{
+   if (std::isnan(pc3phi))
+   {
+      pc3phi = atan2(pc3y, pc3x);
+      if (dcarm == 0 && pc3phi < 0) pc3phi += 2.*M_PI;
+   }
+   return pc3phi;
+}
+
+inline unsigned int ChargedTrack::GetIdMask(const int id) const
+{
+   return (id == identifiedId ? identifiedMask : 0);
+}
+
 #endif /* SINGLE_TRACK_FUNC_HPP */
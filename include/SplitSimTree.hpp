@@ -10,6 +10,9 @@
 #define SPLIT_SIM_TREE_HPP
 
 #include <thread>
+#include <atomic>
+#include <mutex>
+#include <sstream>
 
 #include "TF1.h"
 #include "TH1.h"
@@ -18,12 +21,22 @@
 #include "TFile.h"
 #include "TTreeReader.h"
 
+#include "ROOT/TBufferMerger.hxx"
+
 #include "IOTools.hpp"
 #include "StrTools.hpp"
 #include "MathTools.hpp"
 
 #include "SimTreeReader.hpp"
 
+#ifdef SIM_TREE_READER_RNTUPLE
+#include "ROOT/REntry.hxx"
+#include "ROOT/RNTupleModel.hxx"
+#include "ROOT/RNTupleWriter.hxx"
+#include "ROOT/RNTupleFillContext.hxx"
+#include "ROOT/RNTupleParallelWriter.hxx"
+#endif
+
 #include "PBar.hpp"
 
 /* @namespace SplitSimTree
@@ -34,201 +47,275 @@
  */
 namespace SplitSimTree
 {
-   /// minimum pT cut for smaller TTree
-   double pTMin;
-   /// maximum pT cut for smaller TTree
-   double pTMax;
-   /// number of events across all trees
+   /// minimum pT cuts for smaller TTrees (one for each output)
+   std::vector<double> pTMin;
+   /// maximum pT cuts for smaller TTrees (one for each output)
+   std::vector<double> pTMax;
+   /// names of the output files (one for each pT range)
+   std::vector<std::string> outputFileNames;
+   /// maximum number of events written in each output
    unsigned long numberOfEvents = 0;
-   /// number of processed events
-   unsigned long numberOfProcessedEvents = 0;
+   /// number of threads
+   int numberOfThreads;
    /// parameter for monitoring the progress
-   unsigned long numberOfCalls = 0;
-
-   // the following code was copied from /gpfs/mnt/gpfs02/phenix/plhf/plhf1/dlario/sim/tree_maker/DataAnalyzer.C to avoid any possible mismatch
+   std::atomic<unsigned long> numberOfCalls{0};
+   /// @brief branches of the simulated tree that are read; the list is empty 
+   /// (i.e. all branches are read) since every branch is copied into the split tree
+   const std::vector<std::string> simTreeBranches = {};
 
-   TTree tree("Tree", "Tree");
-
-   TH1D distrOrigPT = TH1D("orig_pt", "pt", 200, 0., 20);
-   TH2D distrOrigPTVsPT = TH2D("distrOrigPTVsPT", "pt", 200, 0., 20, 200, 0., 20);;
-   
-   // namespace that stores all histograms added with structures below;
-   // this namespace allows straighforward access to the histograms and 
-   // provides an easy way to write them
-   namespace HistHolder
-   {
-      std::vector<TH1D *> vec;
-      void Write();
-      void Clear();
-      unsigned int CurrentPos();
-   };
+   struct Container;
 
    // below structs hold variable(s) and help fill the histogarms for this/these variable(s)
    /// structure for storing int variable
    struct SimVarInt
    {
-      SimVarInt(const std::string& name, const double xMin, 
+      SimVarInt(Container& container, const std::string& name, const double xMin, 
                 const double xMax, const int nbins = 100);
       void SetValue(const int newVal);
       int val;
-      unsigned int histHolderIndex;
+      TH1D *hist;
    }; 
    /// structure for storing short variable
    struct SimVarShort
    {	
-      SimVarShort(const std::string& name, const double xMin, 
+      SimVarShort(Container& container, const std::string& name, const double xMin, 
                   const double xMax, const int nbins = 100);
       void SetValue(const short newVal);
       short val;
-      unsigned int histHolderIndex;
+      TH1D *hist;
    }; 
    /// structure for storing float variable
    struct SimVarF
    {	
-      SimVarF(const std::string& name, const double xMin, 
+      SimVarF(Container& container, const std::string& name, const double xMin, 
               const double xMax, const int nbins = 100);
       void SetValue(const float newVal);
       float val;
-      unsigned int histHolderIndex;
+      TH1D *hist;
    }; 
    /// structure for storing int array
    struct SimVarIntArr
    {	
-      SimVarIntArr(const std::string& name, const double xMin, const double xMax, 
-                   const std::string& size, const int nbins = 100);
+      SimVarIntArr(Container& container, const std::string& name, const double xMin, 
+                   const double xMax, const std::string& size, const int nbins = 100);
       void SetValue(const int newVal, const unsigned int index);
       int val[50];
-      unsigned int histHolderIndex;
+      TH1D *hist;
    }; 
    /// structure for storing short array
    struct SimVarShortArr
    {	
-      SimVarShortArr(const std::string& name, const double xMin, const double xMax, 
-                     const std::string& size, const int nbins = 100);
+      SimVarShortArr(Container& container, const std::string& name, const double xMin, 
+                     const double xMax, const std::string& size, const int nbins = 100);
       void SetValue(const short newVal, const unsigned int index);
       short val[50];
-      unsigned int histHolderIndex;
+      TH1D *hist;
    }; 
    /// structure for storing float array
    struct SimVarFArr
    {	
-      SimVarFArr(const std::string& name, const double xMin, const double xMax, 
-                 const std::string& size, const int nbins = 100);
+      SimVarFArr(Container& container, const std::string& name, const double xMin, 
+                 const double xMax, const std::string& size, const int nbins = 100);
       void SetValue(const float newVal, const unsigned int index);
       float val[50];
-      unsigned int histHolderIndex;
+      TH1D *hist;
    }; 
 
-   namespace Container
+   /* @struct Container
+    * @brief Holds the output tree together with all its variables and their histograms
+    *
+    * One container is created for each output; in the multithreaded mode one container is created for each output in each task so that the tasks do not require synchronization
+    */
+   struct Container
    {
+      /*! @brief Constructor
+       * @param[in] directory directory in which the tree will be stored
+       * @param[in] isTreeOutput if false the output is written as RNTuple and the tree is not created since TTree and RNTuple with the same name cannot be stored in one directory
+       */
+      Container(TDirectory *directory, const bool isTreeOutput = true);
+      /// Destructor
+      ~Container();
+      /// sets the values of all variables for the current event and fills histograms
+      void SetValues(const SimTreeReader& simCNT, const double origPT);
+      /// fills the tree with the values of the current event
+      void Fill();
+      /// writes the tree (unless writeTree is false) and histograms into the current directory
+      void Write(const bool writeTree = true);
+      /// adds the histograms of the other container to the histograms of this one
+      void Add(const Container& container);
+      /// output tree (nullptr if the output is written as RNTuple)
+      TTree *tree = nullptr;
+      /// histograms of all variables
+      std::vector<TH1D *> hists;
+#ifdef SIM_TREE_READER_RNTUPLE
+      /// returns RNTuple model with the fields of all variables
+      std::unique_ptr<ROOT::RNTupleModel> CreateModel() const;
+      /// binds the fields of the entry to the variables so that FillEntry copies the values into it
+      void BindEntry(ROOT::REntry& entry);
+      /// copies the values of all variables of the current event into the fields of the bound entry
+      void FillEntry();
+      /// functions that add the fields of all variables to RNTuple model
+      std::vector<std::function<void(ROOT::RNTupleModel&)>> fieldMakers;
+      /// @brief functions that bind the fields of all variables to the entry; each of them 
+      /// returns the function that copies the current value of the variable into its field
+      std::vector<std::function<std::function<void()>(ROOT::REntry&)>> fieldBinders;
+      /// functions that copy the values of all variables into the fields of the bound entry
+      std::vector<std::function<void()>> entryFillers;
+#endif
+      /// distribution of original generated pT
+      TH1D distrOrigPT{"orig_pt", "pt", 200, 0., 20};
+      /// distribution of original generated pT vs reconstructed pT
+      TH2D distrOrigPTVsPT{"distrOrigPTVsPT", "pt", 200, 0., 20, 200, 0., 20};
+
+      // the following variables were copied from /gpfs/mnt/gpfs02/phenix/plhf/plhf1/dlario/sim/tree_maker/DataAnalyzer.C to avoid any possible mismatch
       // name of variables and branches are written similarly to the names in PHCentralTrack
+
       //event variables
-      SimVarInt nch("nch", 0., 20., 20);
-      SimVarF bbcz("bbcz", -50, 50, 100);
-      SimVarFArr mom_orig("mom_orig", -20, 20, "3", 200);
+      SimVarInt nch{*this, "nch", 0., 20., 20};
+      SimVarF bbcz{*this, "bbcz", -50, 50, 100};
+      SimVarFArr mom_orig{*this, "mom_orig", -20, 20, "3", 200};
       
-      SimVarShortArr dcarm("dcarm", 0., 2., "nch", 2);
-      SimVarFArr phi("phi", -1., 4., "nch", 64);
-      SimVarFArr alpha("alpha", -1.5, 1.5, "nch", 100);
-      SimVarFArr zed("zed", -100., 100., "nch", 100);
-      SimVarFArr mom("mom", 0., 20., "nch", 200);
-      SimVarFArr the0("the0", 1., 2.2, "nch", 100);
-      SimVarFArr phi0("phi0", -2., 5., "nch", 100);
-
-      SimVarShortArr nx1hits("nx1hits", 0., 20., "nch", 20);
-      SimVarShortArr nx2hits("nx2hits", 0., 20., "nch", 20);
+      SimVarShortArr dcarm{*this, "dcarm", 0., 2., "nch", 2};
+      SimVarFArr phi{*this, "phi", -1., 4., "nch", 64};
+      SimVarFArr alpha{*this, "alpha", -1.5, 1.5, "nch", 100};
+      SimVarFArr zed{*this, "zed", -100., 100., "nch", 100};
+      SimVarFArr mom{*this, "mom", 0., 20., "nch", 200};
+      SimVarFArr the0{*this, "the0", 1., 2.2, "nch", 100};
+      SimVarFArr phi0{*this, "phi0", -2., 5., "nch", 100};
+
+      SimVarShortArr nx1hits{*this, "nx1hits", 0., 20., "nch", 20};
+      SimVarShortArr nx2hits{*this, "nx2hits", 0., 20., "nch", 20};
       
-      SimVarShortArr qual("qual", 0., 100., "nch", 100);
-      SimVarShortArr charge("charge", -3., 3., "nch", 6);
+      SimVarShortArr qual{*this, "qual", 0., 100., "nch", 100};
+      SimVarShortArr charge{*this, "charge", -3., 3., "nch", 6};
       
-      SimVarShortArr parent_id("parent_id", 0., 20, "nch", 20);
-      SimVarShortArr primary_id("primary_id", 0., 20, "nch", 20);
-      SimVarShortArr particle_id("particle_id", 0., 20, "nch", 20);
+      SimVarShortArr parent_id{*this, "parent_id", 0., 20, "nch", 20};
+      SimVarShortArr primary_id{*this, "primary_id", 0., 20, "nch", 20};
+      SimVarShortArr particle_id{*this, "particle_id", 0., 20, "nch", 20};
 
-      SimVarFArr ttof("ttof", 0., 50., "nch", 200);
-      SimVarFArr ttofw("ttofw", 0., 50., "nch", 200);
-      SimVarFArr temc("temc", 0., 50., "nch", 200);
+      SimVarFArr ttof{*this, "ttof", 0., 50., "nch", 200};
+      SimVarFArr ttofw{*this, "ttofw", 0., 50., "nch", 200};
+      SimVarFArr temc{*this, "temc", 0., 50., "nch", 200};
 
-      SimVarFArr pltof("pltof", 480., 650., "nch", 100);
-      SimVarFArr pltofw("pltofw", 460., 600., "nch", 100);
-      SimVarFArr plemc("plemc", 500., 660., "nch", 100);
+      SimVarFArr pltof{*this, "pltof", 480., 650., "nch", 100};
+      SimVarFArr pltofw{*this, "pltofw", 460., 600., "nch", 100};
+      SimVarFArr plemc{*this, "plemc", 500., 660., "nch", 100};
 
-      SimVarFArr ptofx("ptofx", -520., -420., "nch", 100);
-      SimVarFArr ptofy("ptofy", -300., 100., "nch", 100);
-      SimVarFArr ptofz("ptofz", -210., 210., "nch", 100);
+      SimVarFArr ptofx{*this, "ptofx", -520., -420., "nch", 100};
+      SimVarFArr ptofy{*this, "ptofy", -300., 100., "nch", 100};
+      SimVarFArr ptofz{*this, "ptofz", -210., 210., "nch", 100};
 
-      SimVarFArr ptofwx("ptofwx", 390., 500., "nch", 100);
-      SimVarFArr ptofwy("ptofwy", -100., 300., "nch", 100);
-      SimVarFArr ptofwz("ptofwz", -200., 200., "nch", 100);
+      SimVarFArr ptofwx{*this, "ptofwx", 390., 500., "nch", 100};
+      SimVarFArr ptofwy{*this, "ptofwy", -100., 300., "nch", 100};
+      SimVarFArr ptofwz{*this, "ptofwz", -200., 200., "nch", 100};
 
-      SimVarFArr pemcx("pemcx", -800., 800., "nch", 100);
-      SimVarFArr pemcy("pemcy", -320., 460., "nch", 100);
-      SimVarFArr pemcz("pemcz", -220., 220., "nch", 100);
+      SimVarFArr pemcx{*this, "pemcx", -800., 800., "nch", 100};
+      SimVarFArr pemcy{*this, "pemcy", -320., 460., "nch", 100};
+      SimVarFArr pemcz{*this, "pemcz", -220., 220., "nch", 100};
 
-      SimVarFArr ppc1x("ppc1x", -300., 300., "nch", 100);
-      SimVarFArr ppc1y("ppc1y", -200., 250., "nch", 100);
-      SimVarFArr ppc1z("ppc1z", -100., 100., "nch", 100);
+      SimVarFArr ppc1x{*this, "ppc1x", -300., 300., "nch", 100};
+      SimVarFArr ppc1y{*this, "ppc1y", -200., 250., "nch", 100};
+      SimVarFArr ppc1z{*this, "ppc1z", -100., 100., "nch", 100};
 
-      SimVarFArr ppc2x("ppc2x", -450., 450., "nch", 100);
-      SimVarFArr ppc2y("ppc2y", -300., 400., "nch", 100);
-      SimVarFArr ppc2z("ppc2z", -200., 200., "nch", 100);
+      SimVarFArr ppc2x{*this, "ppc2x", -450., 450., "nch", 100};
+      SimVarFArr ppc2y{*this, "ppc2y", -300., 400., "nch", 100};
+      SimVarFArr ppc2z{*this, "ppc2z", -200., 200., "nch", 100};
       
-      SimVarFArr ppc3x("ppc3x", -550., 550., "nch", 100);
-      SimVarFArr ppc3y("ppc3y", -300., 300., "nch", 100);
-      SimVarFArr ppc3z("ppc3z", -200., 200., "nch", 100);
+      SimVarFArr ppc3x{*this, "ppc3x", -550., 550., "nch", 100};
+      SimVarFArr ppc3y{*this, "ppc3y", -300., 300., "nch", 100};
+      SimVarFArr ppc3z{*this, "ppc3z", -200., 200., "nch", 100};
 
-      SimVarFArr ptecx("ptecx", -550., 550., "nch", 100);
-      SimVarFArr ptecy("ptecy", -300., 300., "nch", 100);
-      SimVarFArr ptecz("ptecz", -200., 200., "nch", 100);
+      SimVarFArr ptecx{*this, "ptecx", -550., 550., "nch", 100};
+      SimVarFArr ptecy{*this, "ptecy", -300., 300., "nch", 100};
+      SimVarFArr ptecz{*this, "ptecz", -200., 200., "nch", 100};
 
-      SimVarFArr tofdz("tofdz", -50., 50., "nch", 100);
-      SimVarFArr tofdphi("tofdphi", -0.2, 0.2, "nch", 100);
+      SimVarFArr tofdz{*this, "tofdz", -50., 50., "nch", 100};
+      SimVarFArr tofdphi{*this, "tofdphi", -0.2, 0.2, "nch", 100};
 
-      SimVarFArr tofwdz("tofwdz", -50., 50., "nch", 100);
-      SimVarFArr tofwdphi("tofwdphi", -0.2, 0.2, "nch", 100);
+      SimVarFArr tofwdz{*this, "tofwdz", -50., 50., "nch", 100};
+      SimVarFArr tofwdphi{*this, "tofwdphi", -0.2, 0.2, "nch", 100};
       
-      SimVarFArr emcdz("emcdz", -60., 60., "nch", 100);
-      SimVarFArr emcdphi("emcdphi", -0.2, 0.2, "nch", 100);
+      SimVarFArr emcdz{*this, "emcdz", -60., 60., "nch", 100};
+      SimVarFArr emcdphi{*this, "emcdphi", -0.2, 0.2, "nch", 100};
       
-      SimVarFArr pc2dz("pc2dz", -50., 50., "nch", 100);
-      SimVarFArr pc2dphi("pc2dphi", -0.2, 0.2, "nch", 100);
+      SimVarFArr pc2dz{*this, "pc2dz", -50., 50., "nch", 100};
+      SimVarFArr pc2dphi{*this, "pc2dphi", -0.2, 0.2, "nch", 100};
 
-      SimVarFArr pc3dz("pc3dz", -50., 50., "nch", 100);
-      SimVarFArr pc3dphi("pc3dphi", -0.2, 0.2, "nch", 100);
+      SimVarFArr pc3dz{*this, "pc3dz", -50., 50., "nch", 100};
+      SimVarFArr pc3dphi{*this, "pc3dphi", -0.2, 0.2, "nch", 100};
 
-      SimVarShortArr striptofw("striptofw", 0., 550., "nch", 200);
-      SimVarShortArr slat("slat", 0., 1000., "nch", 200);
+      SimVarShortArr striptofw{*this, "striptofw", 0., 550., "nch", 200};
+      SimVarShortArr slat{*this, "slat", 0., 1000., "nch", 200};
       
-      SimVarFArr etof("etof", 0., 0.03, "nch", 100);
-      SimVarFArr ecore("ecore", 0., 5., "nch", 100);
-      SimVarFArr emce("emce", 0., 5., "nch", 100);
-      SimVarFArr ecent("ecent", 0., 5., "nch", 100);
-      SimVarFArr e9("e9", 0., 5., "nch", 100);
-      SimVarFArr emcchi2("emcchi2", 0., 20., "nch", 100);
-      SimVarShortArr twrhit("twrhit", 0., 20., "nch", 20);
-      SimVarFArr emcdispy("emcdispy", 0., 20., "nch", 100);
-      SimVarFArr emcdispz("emcdispz", 0., 20., "nch", 100);
-      SimVarFArr prob("prob", 0., 1., "nch", 100);
-
-      SimVarShortArr sect("sect", 0., 4., "nch", 4);
-      SimVarShortArr ysect("ysect", 0, 48., "nch", 48);
-      SimVarShortArr zsect("zsect", 0, 97., "nch", 97);
+      SimVarFArr etof{*this, "etof", 0., 0.03, "nch", 100};
+      SimVarFArr ecore{*this, "ecore", 0., 5., "nch", 100};
+      SimVarFArr emce{*this, "emce", 0., 5., "nch", 100};
+      SimVarFArr ecent{*this, "ecent", 0., 5., "nch", 100};
+      SimVarFArr e9{*this, "e9", 0., 5., "nch", 100};
+      SimVarFArr emcchi2{*this, "emcchi2", 0., 20., "nch", 100};
+      SimVarShortArr twrhit{*this, "twrhit", 0., 20., "nch", 20};
+      SimVarFArr emcdispy{*this, "emcdispy", 0., 20., "nch", 100};
+      SimVarFArr emcdispz{*this, "emcdispz", 0., 20., "nch", 100};
+      SimVarFArr prob{*this, "prob", 0., 1., "nch", 100};
+
+      SimVarShortArr sect{*this, "sect", 0., 4., "nch", 4};
+      SimVarShortArr ysect{*this, "ysect", 0, 48., "nch", 48};
+      SimVarShortArr zsect{*this, "zsect", 0, 97., "nch", 97};
       
-      SimVarShortArr n0("n0", 0., 20., "nch", 20);
-      SimVarShortArr npe0("npe0", 0., 20., "nch", 20);
-      SimVarShortArr n1("n1", 0., 20., "nch", 20);
-      SimVarShortArr npe1("npe1", 0., 20., "nch", 20);
-      SimVarShortArr n2("n2", 0., 20., "nch", 20);
-      SimVarShortArr npe2("npe2", 0., 20., "nch", 20);
-      SimVarShortArr n3("n3", 0., 20., "nch", 20);
-      SimVarShortArr npe3("npe3", 0., 20., "nch", 20);
-      SimVarFArr center_phi("center_phi", -2.*M_PI, 2.*M_PI, "nch", 100);
-      SimVarFArr center_z("center_z", -500., 500., "nch", 100);
-      SimVarFArr cross_phi("cross_phi", -2.*M_PI, 2*M_PI, "nch", 100);
-      SimVarFArr cross_z("cross_z", -500., 500., "nch", 100);
-      SimVarFArr disp("disp", 0., 10., "nch", 100);
-      SimVarFArr chi2("chi2", 0., 200., "nch", 100);
+      SimVarShortArr n0{*this, "n0", 0., 20., "nch", 20};
+      SimVarShortArr npe0{*this, "npe0", 0., 20., "nch", 20};
+      SimVarShortArr n1{*this, "n1", 0., 20., "nch", 20};
+      SimVarShortArr npe1{*this, "npe1", 0., 20., "nch", 20};
+      SimVarShortArr n2{*this, "n2", 0., 20., "nch", 20};
+      SimVarShortArr npe2{*this, "npe2", 0., 20., "nch", 20};
+      SimVarShortArr n3{*this, "n3", 0., 20., "nch", 20};
+      SimVarShortArr npe3{*this, "npe3", 0., 20., "nch", 20};
+      SimVarFArr center_phi{*this, "center_phi", -2.*M_PI, 2.*M_PI, "nch", 100};
+      SimVarFArr center_z{*this, "center_z", -500., 500., "nch", 100};
+      SimVarFArr cross_phi{*this, "cross_phi", -2.*M_PI, 2*M_PI, "nch", 100};
+      SimVarFArr cross_z{*this, "cross_z", -500., 500., "nch", 100};
+      SimVarFArr disp{*this, "disp", 0., 10., "nch", 100};
+      SimVarFArr chi2{*this, "chi2", 0., 200., "nch", 100};
    };
+   /// returns the number of elements in the array with the specified size
+   int GetArraySize(const Container& container, const std::string& size);
+#ifdef SIM_TREE_READER_RNTUPLE
+   /* @brief Adds the field of the variable to RNTuple model of the container 
+    * and the function that binds the field of the entry to the variable
+    *
+    * @param[in] container container of the variable
+    * @param[in] name name of the field
+    * @param[in] copy function that copies the current value of the variable into the field
+    */
+   template<typename T>
+   void AddField(Container& container, const std::string& name, 
+                 const std::function<void(T&)>& copy);
+#endif
+   /* @brief Splits the tree into several pT ranges in a single multithreaded pass
+    *
+    * Trees are compressed in parallel by ROOT::TBufferMerger; RNTuples are written by ROOT::RNTupleParallelWriter with one fill context per task so that their pages are also compressed in parallel while the histograms of the tasks are summed for each output
+    *
+    * @param[in] inputFileName name of the file with the tree to be split
+    * @param[in] outputFormat format of the outputs (TTree or RNTuple)
+    */
+   void SplitMT(const std::string& inputFileName, const std::string& outputFormat);
+   /* @brief Returns the entry after the last one written in each output 
+    *
+    * Outputs receive the first numberOfEvents events in their pT range in the order 
+    * of the entries; the limits are found before the multithreaded processing 
+    * so that the selected events do not depend on the order in which the tasks are run
+    *
+    * @param[in] inputFileName name of the file with the tree to be split
+    * @param[in] numberOfEntries number of entries in the tree
+    */
+   std::vector<unsigned long> GetLastEntries(const std::string& inputFileName, 
+                                             const unsigned long numberOfEntries);
+   /* @brief Splits the tree into one pT range in a single thread
+    *
+    * @param[in] inputFileName name of the file with the tree to be split
+    * @param[in] outputFormat format of the output (TTree or RNTuple)
+    */
+   void Split(const std::string& inputFileName, const std::string& outputFormat);
 }
 
 #endif /* SPLIT_SIM_TREE_HPP */
@@ -16,18 +16,22 @@
 // being accessed only via the scope resolution operator in this file
 using namespace AnalyzeSimResonance;
 
-void AnalyzeSimResonance::AnalyzeConfiguration(ThrContainer &thrContainer, 
-                                               const std::string& particleName, 
-                                               const int daughter1Id,
-                                               const int daughter2Id,
-                                               const std::string& magneticFieldName, 
-                                               const std::string &pTRangeName)
+void AnalyzeSimResonance::SetConfiguration(Configuration &configuration, 
+                                           const std::string& particleName, 
+                                           const int daughter1Id,
+                                           const int daughter2Id,
+                                           const std::string& magneticFieldName, 
+                                           const std::string &pTRangeName)
 { 
    std::string simInputFileName = "data/SimTrees/" + runName + "/Resonance/" + 
                                   particleName + "_" + ParticleMap::name[daughter1Id] + 
                                   ParticleMap::name[daughter2Id] + "_" + 
                                   pTRangeName + magneticFieldName + ".root";
 
+   configuration.simInputFileName = simInputFileName;
+   configuration.daughter1Id = daughter1Id;
+   configuration.daughter2Id = daughter2Id;
+
    TFile simInputFile = TFile(simInputFileName.c_str());
 
    TH1D *origPTHist = static_cast<TH1D *>(simInputFile.Get("orig_pt"));
@@ -89,605 +93,912 @@ void AnalyzeSimResonance::AnalyzeConfiguration(ThrContainer &thrContainer,
       weightFunc = std::make_unique<TF1>("weightFunc", "exp(-x)");
    }
 
-   AcceptanceVar accVar;
+   configuration.eventNormWeight = eventNormWeight;
 
-   if (acceptanceVar != 0)
+   // events that do not pass the event level cuts are taken from the sidecar index 
+   // (if it exists) so that they are never read from the simulated tree
+   SimTreeIndex simTreeIndex;
+   configuration.isIndexed = simTreeIndex.Load(simInputFileName);
+   if (configuration.isIndexed)
    {
-      accVar.Set("data/Parameters/" + runName + "/Acceptance.txt");
+      std::vector<HistContainer *> histContainers;
+      for (Variation& variation : variations)
+      {
+         histContainers.push_back(&variation.thrContainer->Get());
+      }
+
+      for (unsigned long i = 0; i < simTreeIndex.GetSize(); i++)
+      {
+         if (fabs(simTreeIndex.bbcz(i)) <= 30. && simTreeIndex.nch(i) > 0)
+         {
+            configuration.selectedEntries.push_back(simTreeIndex.entry(i));
+            continue;
+         }
+
+         for (unsigned long j = 0; j < variations.size(); j++)
+         {
+            const double origPT = simTreeIndex.origPT(i)*variations[j].pTScale;
+            histContainers[j]->distrOrigUnscaledPT.Fill(origPT);
+            histContainers[j]->distrOrigPT.Fill(origPT, 
+                                                weightFunc->Eval(origPT)/eventNormWeight);
+         }
+      }
+      progress.Add(ProgressMonitor::EVENTS, 
+                   simTreeIndex.GetSize() - configuration.selectedEntries.size());
    }
 
-   const double resonanceMass = inputYAMLResonance["mass"].as<double>();
-   const double resonanceGamma = inputYAMLResonance["gamma"].as<double>();
+   configuration.weightFunc = std::move(weightFunc);
+}
+
+void AnalyzeSimResonance::ProcessTask(SimTreeReader &simCNT, const Configuration &configuration)
+{
+   const int daughter1Id = configuration.daughter1Id;
+   const int daughter2Id = configuration.daughter2Id;
+   const double eventNormWeight = configuration.eventNormWeight;
+   const std::unique_ptr<TF1> &weightFunc = configuration.weightFunc;
 
    const double daughter1Mass = ParticleMap::mass[daughter1Id];
    const double daughter2Mass = ParticleMap::mass[daughter2Id];
 
-   ROOT::TTreeProcessorMT tp(simInputFileName.c_str());
-  
-   auto ProcessMP = [&](TTreeReader &reader)
-   { 
-      ThrContainerCopy histContainer = thrContainer.GetCopy();
+   std::vector<HistContainer *> histContainers;
+   for (Variation& variation : variations)
+   {
+      histContainers.push_back(&variation.thrContainer->Get());
+   }
 
-      SimTreeReader simCNT(reader);
+   // containers are reused between events so that they are not reallocated for every event
+   CandidateTracks candidateTracks;
+   std::vector<TrackDeadmaps> selectedTracks;
+   std::vector<ChargedTrack> positiveTracks;
+   std::vector<ChargedTrack> negativeTracks;
+   std::vector<TrackState> positiveTracksStates;
+   std::vector<TrackState> negativeTracksStates;
+   TrackBlock negativeTracksBlock;
+   std::vector<double> pairsMInv;
+   std::vector<double> pairsPT;
+   std::vector<PairCuts> pairsCuts;
+   std::vector<double> mixedPairsMInv;
+   std::vector<double> mixedPairsPT;
+
+   // pools and histograms of the mixed event background of the current thread
+   std::vector<EventPool> *threadEventPools = nullptr;
+   MixedHistContainer *mixedHistContainer = nullptr;
+   if (eventPools)
+   {
+      threadEventPools = &eventPools->Get();
+      mixedHistContainer = &thrMixedContainer->Get();
+   }
+
+   while (simCNT.Next())
+   { 
+      const SimEventSnapshot& simEvent = simCNT.Snapshot();
+      progress.Add(ProgressMonitor::EVENTS);
+      progress.Add(ProgressMonitor::TRACKS, simEvent.nch);
 
-      while (reader.Next())
-      { 
-         numberOfCalls++;
-         const double origPT = sqrt(pow(simCNT.mom_orig(0), 2) + 
-                                        pow(simCNT.mom_orig(1), 2))*pTScale;
+      const double origUnscaledPT = sqrt(pow(simEvent.mom_orig[0], 2) + 
+                                         pow(simEvent.mom_orig[1], 2));
 
-         double eventWeight = weightFunc->Eval(origPT)/eventNormWeight;
+      for (unsigned long i = 0; i < variations.size(); i++)
+      {
+         const double origPT = origUnscaledPT*variations[i].pTScale;
+         histContainers[i]->distrOrigUnscaledPT.Fill(origPT);
+         histContainers[i]->distrOrigPT.Fill(origPT, weightFunc->Eval(origPT)/eventNormWeight);
+      }
  
-         histContainer.distrOrigUnscaledPT->Fill(origPT);
-         histContainer.distrOrigPT->Fill(origPT, eventWeight);
+      const double bbcz = simEvent.bbcz;
+      if (fabs(bbcz) > 30.) continue;
+
+      // simulated events have neither centrality nor reaction plane 
+      // so only z_{vtx} defines the pool bin of the event
+      const int poolBin = (eventPools ? eventPools->GetBin(0, bbcz, 0) : -1);
+
+      // cuts and deadmaps that do not depend on pT scale are 
+      // evaluated once for all variations
+      candidateTracks.Clear();
+      for(int i = 0; i < simEvent.nch; i++) // loop over particles in one event
+      {
+         const double the0 = simEvent.the0[i];
+         if (IsGhostCut(the0, bbcz)) continue;
+
+         if (IsQualityCut(simEvent.qual[i])) continue;
+
+         const int charge = simEvent.charge[i];
+         if (charge != -1 && charge != 1) continue;
+
+         const int dcarm = simEvent.dcarm[i];
+
+         const double zed = simEvent.zed[i];
+         if (fabs(zed) > 75. && fabs(zed) < 3.) continue;
  
-         const double bbcz = simCNT.bbcz();
-         if (fabs(bbcz) > 30.) continue;
+         const double phi = simEvent.phi[i];
+         double board;
+
+         if (phi > M_PI/2.) board = ((3.72402 - phi + 0.008047*cos(phi + 0.87851))/0.01963496);
+         else board = ((0.573231 + phi - 0.0046 * cos(phi + 0.05721))/0.01963496);
+
+         double ppc1phi = atan2(simEvent.ppc1y[i], simEvent.ppc1x[i]);
+         if (dcarm == 0 && ppc1phi < 0) ppc1phi += 2.*M_PI;
+
+         candidateTracks.index.push_back(i);
+         candidateTracks.dcarm.push_back(dcarm);
+         candidateTracks.zed.push_back(zed);
+         candidateTracks.board.push_back(board);
+         candidateTracks.alpha.push_back(simEvent.alpha[i]);
+         candidateTracks.ppc1z.push_back(simEvent.ppc1z[i]);
+         candidateTracks.ppc1phi.push_back(ppc1phi);
+      }
 
-         std::vector<ChargedTrack> positiveTracks;
-         std::vector<ChargedTrack> negativeTracks;
+      // DC and PC1 deadmaps are applied to all tracks; 
+      // other detectors are only looked up for the tracks that have a hit in them
+      const unsigned long numberOfCandidates = candidateTracks.index.size();
+      candidateTracks.deadMasks.assign(numberOfCandidates, 0);
+      dmCutter.SetDeadDC(numberOfCandidates, candidateTracks.dcarm.data(), 
+                         candidateTracks.zed.data(), candidateTracks.board.data(), 
+                         candidateTracks.alpha.data(), candidateTracks.deadMasks.data());
+      dmCutter.SetDeadPC1(numberOfCandidates, candidateTracks.dcarm.data(), 
+                          candidateTracks.ppc1z.data(), candidateTracks.ppc1phi.data(), 
+                          candidateTracks.deadMasks.data());
+
+      selectedTracks.clear();
+      for (unsigned long j = 0; j < numberOfCandidates; j++)
+      {
+         if (candidateTracks.deadMasks[j] != 0) continue;
 
-         for(int i = 0; i < simCNT.nch(); i++) // loop over particles in one event
-         {
-            const double the0 = simCNT.the0(i);
-            if (IsGhostCut(the0, bbcz)) continue;
+         const int i = candidateTracks.index[j];
+         const int dcarm = candidateTracks.dcarm[j];
+         const double the0 = simEvent.the0[i];
 
-            const double pT = simCNT.mom(i)*sin(the0)*pTScale;
-            if (pT < pTMin || pT > pTMax) continue;
+         selectedTracks.emplace_back();
+         TrackDeadmaps &deadmaps = selectedTracks.back();
+         deadmaps.index = i;
+         deadmaps.pT = simEvent.mom[i]*sin(the0);
 
-            if (IsQualityCut(simCNT.qual(i))) continue;
+         if (usePC2 && IsHit(simEvent.pc2dphi[i]))
+         {
+            const double pc2phi = atan2(simEvent.ppc2y[i], simEvent.ppc2x[i]);
+            deadmaps.isDeadPC2 = dmCutter.IsDeadPC2(simEvent.ppc2z[i], pc2phi);
+         }
 
-            const int charge = simCNT.charge(i);
-            if (charge != -1 && charge != 1) continue;
+         if (usePC3 && IsHit(simEvent.pc3dphi[i]))
+         {
+            double pc3phi = atan2(simEvent.ppc3y[i], simEvent.ppc3x[i]);
+            if (dcarm == 0 && pc3phi < 0) pc3phi += 2.*M_PI;
+            deadmaps.isDeadPC3 = dmCutter.IsDeadPC3(dcarm, simEvent.ppc2z[i], pc3phi);
+         }
 
-            const int dcarm = simCNT.dcarm(i);
+         if (useEMCal && IsHit(simEvent.emcdz[i]))
+         {
+            // geometric and timing deadmaps are obtained with one lookup
+            const unsigned int deadBits = 
+               dmCutter.GetDeadEMCal(dcarm, simEvent.sect[i], 
+                                     simEvent.ysect[i], simEvent.zsect[i]);
+            deadmaps.isDeadEMCal = (deadBits & DeadMapCutter::DEAD_EMCAL);
+            if (useEMCalId && !(dcarm == 0 && simEvent.sect[i] < 2))
+            {
+               deadmaps.isDeadTimingEMCal = (deadBits & DeadMapCutter::DEAD_TIMING_EMCAL);
+            }
+         }
 
-            const double zed = simCNT.zed(i);
-            if (fabs(zed) > 75. && fabs(zed) < 3.) continue;
- 
-            const double alpha = simCNT.alpha(i);
-            const double phi = simCNT.phi(i);
-            double board;
+         if (useTOFe && IsHit(simEvent.tofdz[i]))
+         {
+            // slats are organized in 10 lines of 96 we define as chambers
+            const int chamber = simEvent.slat[i]/96;
+            // slat number for the current chamber
+            const int slat = simEvent.slat[i] % 96;
+
+            const unsigned int deadBits = dmCutter.GetDeadTOFe(chamber, slat);
+            deadmaps.isDeadTOFe = (deadBits & DeadMapCutter::DEAD_TOFE);
+            deadmaps.isDeadTimingTOFe = (deadBits & DeadMapCutter::DEAD_TIMING_TOFE);
+         }
+         else if (useTOFw && IsHit(simEvent.tofwdz[i]))
+         {
+            // strips are organized in 8 lines of 64 we define as chambers
+            const int chamber = simEvent.striptofw[i]/64;
+            // strip number for the current chamber
+            const int strip = simEvent.striptofw[i] % 64;
+
+            const unsigned int deadBits = dmCutter.GetDeadTOFw(chamber, strip);
+            deadmaps.isDeadTOFw = (deadBits & DeadMapCutter::DEAD_TOFW);
+            deadmaps.isDeadTimingTOFw = (deadBits & DeadMapCutter::DEAD_TIMING_TOFW);
+         }
+      }
 
-            if (phi > M_PI/2.) board = ((3.72402 - phi + 0.008047*cos(phi + 0.87851))/0.01963496);
-            else board = ((0.573231 + phi - 0.0046 * cos(phi + 0.05721))/0.01963496);
+      // tracks are sorted by pT so that the blocks of tracks of the mixed events
+      // that cannot form pairs in the mixed histograms ranges are skipped
+      std::sort(selectedTracks.begin(), selectedTracks.end(), 
+                [](const TrackDeadmaps& track1, const TrackDeadmaps& track2)
+                {return track1.pT < track2.pT;});
 
-            if (dmCutter.IsDeadDC(dcarm, zed, board, alpha)) continue;
+      // tracks and pair kinematics are evaluated once for all variations with the same pT scale
+      for (const std::vector<unsigned long>& pTScaleGroup : pTScaleGroups)
+      {
+         const double pTScale = variations[pTScaleGroup.front()].pTScale;
+         const double origPT = origUnscaledPT*pTScale;
+         const double eventWeight = weightFunc->Eval(origPT)/eventNormWeight;
 
-            double ppc1phi = atan2(simCNT.ppc1y(i), simCNT.ppc1x(i));
-            if (dcarm == 0 && ppc1phi < 0) ppc1phi += 2.*M_PI;
+         positiveTracks.clear();
+         negativeTracks.clear();
+         positiveTracksStates.clear();
+         negativeTracksStates.clear();
 
-            if (dmCutter.IsDeadPC1(dcarm, simCNT.ppc1z(i), ppc1phi)) continue;
+         for (const TrackDeadmaps& deadmaps : selectedTracks)
+         {
+            const int i = deadmaps.index;
 
-            histContainer.distrOrigPTVsRecDaughtersPT->Fill(origPT, pT, eventWeight);
+            const double pT = deadmaps.pT*pTScale;
+            if (pT < pTMin || pT > pTMax) continue;
 
-            int idPC2 = PART_ID::JUNK;
-            int idPC3 = PART_ID::JUNK;
-            int idEMCal = PART_ID::JUNK;
-            int idTOFe = PART_ID::JUNK;
-            int idTOFw = PART_ID::JUNK;
+            TrackState state;
+            state.charge = simEvent.charge[i];
+            state.dcarm = simEvent.dcarm[i];
+            state.sector = simEvent.sect[i];
 
-            double weightPC2 = 0.;
-            double weightPC3 = 0.;
-            double weightEMCal = 0.;
-            double weightTOFe = 0.;
-            double weightTOFw = 0.;
+            const int charge = state.charge;
+            const int dcarm = state.dcarm;
+            // in MC daughter particles are identified only as themselves
+            const int id = (charge == 1 ? daughter1Id : daughter2Id);
 
-            double weightIdEMCal = 0.;
-            double weightIdTOFe = 0.;
-            double weightIdTOFw = 0.;
+            for (const unsigned long variationIndex : pTScaleGroup)
+            {
+               histContainers[variationIndex]->
+                  distrOrigPTVsRecDaughtersPT.Fill(origPT, pT, eventWeight);
+            }
 
-            if (usePC2 && IsHit(simCNT.pc2dphi(i)))
+            if (usePC2 && IsHit(simEvent.pc2dphi[i]))
             {
-               const double sdphi = simSigmRes.PC2SDPhi(simCNT.pc2dphi(i), pT, charge);
-               const double sdz = simSigmRes.PC2SDZ(simCNT.pc2dz(i), pT, charge);
-               const double pc2phi = atan2(simCNT.ppc2y(i), simCNT.ppc2x(i));
+               const double sdphi = simSigmRes.PC2SDPhi(simEvent.pc2dphi[i], pT, charge);
+               const double sdz = simSigmRes.PC2SDZ(simEvent.pc2dz[i], pT, charge);
 
-               if (IsMatch(sdphi, sdz, 3.0))
-               {
-                  if (!dmCutter.IsDeadPC2(simCNT.ppc2z(i), pc2phi))
-                  {
-                     weightPC2 = 1. + accVar.PC2;
-                  }
-                  if (weightPC2 > 1e-15) idPC2 = PART_ID::NONE;
-               }
+               state.isPC2 = (IsMatch(sdphi, sdz, 3.0) && !deadmaps.isDeadPC2);
             }
 
-            if (usePC3 && IsHit(simCNT.pc3dphi(i)))
+            if (usePC3 && IsHit(simEvent.pc3dphi[i]))
             {
-               const double sdphi = simSigmRes.PC3SDPhi(simCNT.pc3dphi(i), pT, charge, dcarm);
-               const double sdz = simSigmRes.PC3SDZ(simCNT.pc3dz(i), pT, charge, dcarm);
-
-               double pc3phi = atan2(simCNT.ppc3y(i), simCNT.ppc3x(i));
-               if (dcarm == 0 && pc3phi < 0) pc3phi += 2.*M_PI;
+               const double sdphi = simSigmRes.PC3SDPhi(simEvent.pc3dphi[i], pT, charge, dcarm);
+               const double sdz = simSigmRes.PC3SDZ(simEvent.pc3dz[i], pT, charge, dcarm);
 
-               if (IsMatch(sdphi, sdz, 3.0))
-               {
-                  if (!dmCutter.IsDeadPC3(dcarm, simCNT.ppc2z(i), pc3phi))
-                  {
-                     weightPC3 = 1. + accVar.PC3[dcarm];
-                  }
-                  if (weightPC3 > 1e-15) idPC3 = PART_ID::NONE;
-               }
+               state.isPC3 = (IsMatch(sdphi, sdz, 3.0) && !deadmaps.isDeadPC3);
             }
 
-            if (useEMCal && IsHit(simCNT.emcdz(i)))
+            if (useEMCal && IsHit(simEvent.emcdz[i]))
             {
                const double sdphi = 
-                  simSigmRes.EMCalSDPhi(simCNT.emcdphi(i), pT, charge, dcarm, simCNT.sect(i));
+                  simSigmRes.EMCalSDPhi(simEvent.emcdphi[i], pT, charge, dcarm, simEvent.sect[i]);
                const double sdz = 
-                  simSigmRes.EMCalSDZ(simCNT.emcdz(i), pT, charge, dcarm, simCNT.sect(i));
+                  simSigmRes.EMCalSDZ(simEvent.emcdz[i], pT, charge, dcarm, simEvent.sect[i]);
 
-               /*
-               bool isCutByECore;
-               if (dcarm == 0 && simCNT.sect(i) < 2) isCutByECore = (simCNT.ecore(i) < 0.35);
-               else isCutByECore = (simCNT.ecore(i) < 0.25); // PbSc
-                                                             // */
+               state.isEMCal = (IsMatch(sdphi, sdz, 3.0) && !deadmaps.isDeadEMCal);
 
-               if (IsMatch(sdphi, sdz, 3.0)/* && !isCutByECore*/)
+               if (state.isEMCal && useEMCalId && !(dcarm == 0 && simEvent.sect[i] < 2) &&
+                   !deadmaps.isDeadTimingEMCal)
                {
-                  if (!dmCutter.IsDeadEMCal(dcarm, simCNT.sect(i), 
-                                            simCNT.ysect(i), simCNT.zsect(i)))
-                  {
-                     weightEMCal = 1. + accVar.EMCal[dcarm][simCNT.sect(i)];
-                  }
-
-                  if (weightEMCal > 1e-15)
-                  {
-                     if (useEMCalId && !(dcarm == 0 && simCNT.sect(i) < 2) &&
-                         !dmCutter.IsDeadTimingEMCal(dcarm, simCNT.sect(i), 
-                                                     simCNT.ysect(i), simCNT.zsect(i)))
-                     {
-                        switch (charge)
-                        {
-                           case 1:
-                              idEMCal = daughter1Id;
-                              break;
-                           case -1:
-                              idEMCal = daughter2Id;
-                              break;
-                        }
-                        weightIdEMCal = simM2Id.GetEMCalIdProb(simCNT.dcarm(i), simCNT.sect(i), 
-                                                               idEMCal, pT, 1., 2.)*weightEMCal;
-                        if (weightIdEMCal <= 0.)
-                        {
-                           idEMCal = PART_ID::NONE;
-                           weightIdEMCal = 0.;
-                        }
-                     }
-                     else idEMCal = PART_ID::NONE;
-                  }
+                  state.isIdEMCal = true;
+                  state.probIdEMCal = 
+                     simM2Id.GetEMCalIdProb(dcarm, simEvent.sect[i], id, pT, 1., 2.);
                }
             }
 
-            if (useTOFe && IsHit(simCNT.tofdz(i)))
+            if (useTOFe && IsHit(simEvent.tofdz[i]))
             {
-               const double sdphi = simSigmRes.TOFeSDPhi(simCNT.tofdphi(i), pT, charge);
-               const double sdz = simSigmRes.TOFeSDZ(simCNT.tofdz(i), pT, charge);
+               const double sdphi = simSigmRes.TOFeSDPhi(simEvent.tofdphi[i], pT, charge);
+               const double sdz = simSigmRes.TOFeSDZ(simEvent.tofdz[i], pT, charge);
 
                // eloss cut; parameters for MC may differ from real data 
                // since distributions may differ
-               const double beta = simCNT.pltof(i)/simCNT.ttof(i)/29.9792;
+               const double beta = simEvent.pltof[i]/simEvent.ttof[i]/29.9792;
                const double eloss = 0.0016*pow(beta, -2.6);
 
-               // slats are organized in 10 lines of 96 we define as chambers
-               const int chamber = simCNT.slat(i)/96;
-               // slat number for the current chamber
-               const int slat = simCNT.slat(i) % 96;
+               state.isTOFe = (simEvent.etof[i] > eloss && IsMatch(sdphi, sdz, 3.) && 
+                               !deadmaps.isDeadTOFe);
 
-               if (simCNT.etof(i) > eloss && IsMatch(sdphi, sdz, 3.))
+               if (state.isTOFe && !deadmaps.isDeadTimingTOFe)
                {
-                  if (!dmCutter.IsDeadTOFe(chamber, slat))
-                  {
-                     weightTOFe = 1. + accVar.TOFe;
-                  }
-
-                  if (weightTOFe > 1e-15)
-                  {
-                     if (!dmCutter.IsDeadTimingTOFe(chamber, slat))
-                     {
-                        switch (charge)
-                        {
-                           case 1:
-                              idTOFe = daughter1Id;
-                              break;
-                           case -1:
-                              idTOFe = daughter2Id;
-                              break;
-                        }
-                        weightIdTOFe = simM2Id.GetTOFeIdProb(idTOFe, pT, 2., 2.)*weightTOFe;
-
-                        if (weightIdTOFe <= 0.)
-                        {
-                           idTOFe = PART_ID::NONE;
-                           weightIdTOFe = 0.;
-                        }
-                     }
-                     else idTOFe = PART_ID::NONE;
-                  }
+                  state.isIdTOFe = true;
+                  state.probIdTOFe = simM2Id.GetTOFeIdProb(id, pT, 2., 2.);
                }
             }
-            else if (useTOFw && IsHit(simCNT.tofwdz(i)))
+            else if (useTOFw && IsHit(simEvent.tofwdz[i]))
             {
-               const double sdphi = simSigmRes.TOFwSDPhi(simCNT.tofwdphi(i), pT, charge);
-               const double sdz = simSigmRes.TOFwSDZ(simCNT.tofwdz(i), pT, charge);
+               const double sdphi = simSigmRes.TOFwSDPhi(simEvent.tofwdphi[i], pT, charge);
+               const double sdz = simSigmRes.TOFwSDZ(simEvent.tofwdz[i], pT, charge);
 
-               // strips are organized in 8 lines of 64 we define as chambers
-               const int chamber = simCNT.striptofw(i)/64;
-               // strip number for the current chamber
-               const int strip = simCNT.striptofw(i) % 64;
+               state.isTOFw = (IsMatch(sdphi, sdz, 3.0) && !deadmaps.isDeadTOFw);
 
-               if (IsMatch(sdphi, sdz, 3.0))
+               if (state.isTOFw && !deadmaps.isDeadTimingTOFw)
                {
-                  if (!dmCutter.IsDeadTOFw(chamber, strip))
-                  {
-                     weightTOFw = 0.7996*(1. + accVar.TOFw);
-                  }
-
-                  if (weightTOFw > 1e-15)
-                  {
-                     if (!dmCutter.IsDeadTimingTOFw(chamber, strip))
-                     {
-                        switch (charge)
-                        {
-                           case 1:
-                              idTOFw = daughter1Id;
-                              break;
-                           case -1:
-                              idTOFw = daughter2Id;
-                              break;
-                        }
-                        weightIdTOFw = simM2Id.GetTOFwIdProb(idTOFw, pT, 2., 2.)*weightTOFw;
-
-                        if (weightIdTOFw <= 0.)
-                        {
-                           idTOFw = PART_ID::NONE;
-                           weightIdTOFw = 0.;
-                        }
-                     }
-                     else idTOFw = PART_ID::NONE;
-                  }
+                  state.isIdTOFw = true;
+                  state.probIdTOFw = simM2Id.GetTOFwIdProb(id, pT, 2., 2.);
                }
             }
 
-            /*
-            if (idPC2 == PART_ID::JUNK && idPC3 == PART_ID::JUNK && idEMCal == PART_ID::JUNK && 
-                idTOFe == PART_ID::JUNK && idTOFw == PART_ID::JUNK) continue;
-                */
-
-            histContainer.distrOrigPTVsDecayRecPT->Fill(origPT, pT, eventWeight);
+            for (const unsigned long variationIndex : pTScaleGroup)
+            {
+               histContainers[variationIndex]->
+                  distrOrigPTVsDecayRecPT.Fill(origPT, pT, eventWeight);
+            }
 
             switch (charge)
             {
                case 1:
-                  positiveTracks.emplace_back(daughter1Mass, simCNT, i, pTScale);
-                  positiveTracks.back().idPC2 = idPC2;
-                  positiveTracks.back().idPC3 = idPC3;
-                  positiveTracks.back().idEMCal = idEMCal;
-                  positiveTracks.back().idTOFe = idTOFe;
-                  positiveTracks.back().idTOFw = idTOFw;
-                  positiveTracks.back().weightPC2 = weightPC2;
-                  positiveTracks.back().weightPC3 = weightPC3;
-                  positiveTracks.back().weightEMCal = weightEMCal;
-                  positiveTracks.back().weightTOFe = weightTOFe;
-                  positiveTracks.back().weightTOFw = weightTOFw;
-                  positiveTracks.back().weightIdEMCal = weightIdEMCal;
-                  positiveTracks.back().weightIdTOFe = weightIdTOFe;
-                  positiveTracks.back().weightIdTOFw = weightIdTOFw;
+                  positiveTracks.emplace_back(daughter1Mass, simEvent, i, pTScale);
+                  positiveTracksStates.push_back(state);
                   break;
                case -1:
-                  negativeTracks.emplace_back(daughter2Mass, simCNT, i, pTScale);
-                  negativeTracks.back().idPC2 = idPC2;
-                  negativeTracks.back().idPC3 = idPC3;
-                  negativeTracks.back().idEMCal = idEMCal;
-                  negativeTracks.back().idTOFe = idTOFe;
-                  negativeTracks.back().idTOFw = idTOFw;
-                  negativeTracks.back().weightPC2 = weightPC2;
-                  negativeTracks.back().weightPC3 = weightPC3;
-                  negativeTracks.back().weightEMCal = weightEMCal;
-                  negativeTracks.back().weightTOFe = weightTOFe;
-                  negativeTracks.back().weightTOFw = weightTOFw;
-                  negativeTracks.back().weightIdEMCal = weightIdEMCal;
-                  negativeTracks.back().weightIdTOFe = weightIdTOFe;
-                  negativeTracks.back().weightIdTOFw = weightIdTOFw;
+                  negativeTracks.emplace_back(daughter2Mass, simEvent, i, pTScale);
+                  negativeTracksStates.push_back(state);
                   break;
             }
          }
 
-         // looping over pairs of tracks
-         for (const auto& posTrack : positiveTracks)
+         negativeTracksBlock.Clear();
+         for (const auto& negTrack : negativeTracks) negativeTracksBlock.Add(negTrack);
+
+         const unsigned long numberOfPairs = positiveTracks.size()*negativeTracks.size();
+
+         pairsMInv.resize(numberOfPairs);
+         pairsPT.resize(numberOfPairs);
+         pairsCuts.resize(numberOfPairs);
+
+         for (unsigned long i = 0; i < positiveTracks.size(); i++)
          {
-            for (const auto& negTrack : negativeTracks)
+            const ChargedTrack& posTrack = positiveTracks[i];
+
+            // kinematics of all pairs of the positive track are evaluated in one batch;
+            // same event pairs are not skipped by kinematic bounds (see GetPartnersRange) 
+            // since the pairs outside of the axes fill the overflow bins and the numbers of 
+            // entries of M_inv distributions that are used to estimate the efficiency, and 
+            // the pairs within 2 gamma from the mass fill the hits differences at any pT
+            GetPairsMassPT(posTrack, negativeTracksBlock, 
+                           pairsMInv.data() + i*negativeTracks.size(), 
+                           pairsPT.data() + i*negativeTracks.size());
+
+            for (unsigned long j = 0; j < negativeTracks.size(); j++)
             {
-               // invariant mass [GeV/c^2]
-               const double mInv = GetPairMass(posTrack, negTrack);
-               // pT of a pair [GeV/c]
-               const double pT = GetPairPT(posTrack, negTrack);
+               const ChargedTrack& negTrack = negativeTracks[j];
+               pairsCuts[i*negativeTracks.size() + j] = {IsGhostCut(posTrack, negTrack), 
+                                                         IsOneArmCut(posTrack, negTrack), 
+                                                         GetGhostMask(posTrack, negTrack)};
+            }
+         }
 
-               // check that shows whether invariant mass is within 2 gamma from mean of the signal
-               // 10 is a rough estimation for gaussian widening 
-               // due to finite momentum resolution of a detector system 
-               const bool isWithin2Gamma = (mInv > resonanceMass - resonanceGamma*2. - 10. && 
-                                            mInv < resonanceMass + resonanceGamma*2. + 10.);
+         // only the weights of the tracks differ between the variations of the group
+         for (const unsigned long variationIndex : pTScaleGroup)
+         {
+            const AcceptanceVar &accVar = variations[variationIndex].accVar;
 
-               if (IsGhostCut(posTrack, negTrack)) continue;
+            for (unsigned long i = 0; i < positiveTracks.size(); i++)
+            {
+               SetTrackWeights(positiveTracks[i], positiveTracksStates[i], accVar, daughter1Id);
+            }
+            for (unsigned long i = 0; i < negativeTracks.size(); i++)
+            {
+               SetTrackWeights(negativeTracks[i], negativeTracksStates[i], accVar, daughter2Id);
+            }
 
-               if (IsOneArmCut(posTrack, negTrack)) 
-               {
-                  thrContainer.distrMInvOneArmAntiCut->Fill(pT, mInv, eventWeight);
-                  continue;
-               }
+            FillPairs(*histContainers[variationIndex], positiveTracks, negativeTracks, 
+                      pairsMInv, pairsPT, pairsCuts, origPT, eventWeight, configuration);
 
-               if (posTrack.idPC2 != PART_ID::JUNK && negTrack.idPC2 != PART_ID::JUNK)
-               {
-                  if (isWithin2Gamma)
-                  {
-                     thrContainer.distrDPC2PhiDPC2ZVsPT->Fill(posTrack.pc2z - negTrack.pc2z, 
-                                                              posTrack.pc2phi - negTrack.pc2phi,
-                                                              eventWeight);
-                  }
-               }
+            // mixed event background is only built for the default parameters
+            if (variationIndex == 0 && poolBin >= 0)
+            {
+               EventPool& pool = (*threadEventPools)[configuration.index*
+                                                     eventPools->GetNumberOfBins() + poolBin];
+               MixEvent(*mixedHistContainer, pool, poolBin, positiveTracks, negativeTracks, 
+                        negativeTracksBlock, pairsMInv, pairsPT, pairsCuts, mixedPairsMInv, 
+                        mixedPairsPT, eventWeight, configuration);
+            }
+         }
+      }
+   }
+}
 
-               if (posTrack.idPC3 != PART_ID::JUNK && negTrack.idPC3 != PART_ID::JUNK)
-               {
-                  if (isWithin2Gamma)
-                  {
-                     thrContainer.distrDPC3PhiDPC3ZVsPT->Fill(posTrack.pc3z - negTrack.pc3z, 
-                                                              posTrack.pc3phi - negTrack.pc3phi, 
-                                                              eventWeight);
-                  }
-               }
+void AnalyzeSimResonance::SetTrackWeights(ChargedTrack& track, const TrackState& state, 
+                                          const AcceptanceVar& accVar, const int id)
+{
+   track.idPC2 = PART_ID::JUNK;
+   track.idPC3 = PART_ID::JUNK;
+   track.idEMCal = PART_ID::JUNK;
+   track.idTOFe = PART_ID::JUNK;
+   track.idTOFw = PART_ID::JUNK;
+
+   track.weightPC2 = 0.;
+   track.weightPC3 = 0.;
+   track.weightEMCal = 0.;
+   track.weightTOFe = 0.;
+   track.weightTOFw = 0.;
+
+   track.weightIdEMCal = 0.;
+   track.weightIdTOFe = 0.;
+   track.weightIdTOFw = 0.;
+
+   if (state.isPC2) track.weightPC2 = 1. + accVar.PC2;
+   if (track.weightPC2 > 1e-15) track.idPC2 = PART_ID::NONE;
+
+   if (state.isPC3) track.weightPC3 = 1. + accVar.PC3[state.dcarm];
+   if (track.weightPC3 > 1e-15) track.idPC3 = PART_ID::NONE;
+
+   if (state.isEMCal) track.weightEMCal = 1. + accVar.EMCal[state.dcarm][state.sector];
+   if (track.weightEMCal > 1e-15)
+   {
+      if (state.isIdEMCal)
+      {
+         track.idEMCal = id;
+         track.weightIdEMCal = state.probIdEMCal*track.weightEMCal;
+         if (track.weightIdEMCal <= 0.)
+         {
+            track.idEMCal = PART_ID::NONE;
+            track.weightIdEMCal = 0.;
+         }
+      }
+      else track.idEMCal = PART_ID::NONE;
+   }
 
-               if (posTrack.idTOFe != PART_ID::JUNK && negTrack.idTOFe != PART_ID::JUNK)
-               {
-                  if (isWithin2Gamma)
-                  {
-                     thrContainer.distrDChamberDSlatVsPT->
-                        Fill(static_cast<double>(posTrack.slat/96 - negTrack.slat/96) + 0.5,
-                             static_cast<double>((posTrack.slat % 96) - 
-                                                 (negTrack.slat % 96)) + 0.5,
-                             pT, eventWeight);
-                  }
-
-                  if (posTrack.slat == negTrack.slat)
-                  {
-                     thrContainer.distrMInvTOFeGhostNoPID->Fill(pT, mInv, eventWeight);
-                  }
-               }
-               else if (posTrack.idTOFw != PART_ID::JUNK && negTrack.idTOFw != PART_ID::JUNK)
-               {
-                  if (isWithin2Gamma)
-                  {
-                     thrContainer.distrDChamberDStripVsPT->
-                        Fill(static_cast<double>(posTrack.strip/96 - negTrack.strip/96) + 0.5,
-                             static_cast<double>((posTrack.strip % 96) - 
-                                                 (negTrack.strip % 96)) + 0.5,
-                             pT, eventWeight);
-                  }
-                  if (posTrack.strip == negTrack.strip)
-                  {
-                     thrContainer.distrMInvTOFwGhostNoPID->Fill(pT, mInv, eventWeight);
-                  }
-               }
+   if (state.isTOFe) track.weightTOFe = 1. + accVar.TOFe;
+   if (track.weightTOFe > 1e-15)
+   {
+      if (state.isIdTOFe)
+      {
+         track.idTOFe = id;
+         track.weightIdTOFe = state.probIdTOFe*track.weightTOFe;
+         if (track.weightIdTOFe <= 0.)
+         {
+            track.idTOFe = PART_ID::NONE;
+            track.weightIdTOFe = 0.;
+         }
+      }
+      else track.idTOFe = PART_ID::NONE;
+   }
 
-               if (posTrack.idEMCal != PART_ID::JUNK && negTrack.idEMCal != PART_ID::JUNK &&
-                   posTrack.sector == negTrack.sector)
-               {
-                  if (isWithin2Gamma)
-                  {
-                     thrContainer.distrDYTowerDZTowerVsPT->
-                        Fill(static_cast<double>(posTrack.yTower - negTrack.yTower) + 0.5, 
-                             static_cast<double>(posTrack.zTower - negTrack.zTower) + 0.5, 
-                             pT, eventWeight);
-                  }
-                  if (posTrack.yTower == negTrack.yTower && posTrack.zTower == negTrack.zTower)
-                  {
-                     thrContainer.distrMInvEMCalGhostNoPID->Fill(pT, mInv, eventWeight);
-                  }
-               }
+   if (state.isTOFw) track.weightTOFw = 0.7996*(1. + accVar.TOFw);
+   if (track.weightTOFw > 1e-15)
+   {
+      if (state.isIdTOFw)
+      {
+         track.idTOFw = id;
+         track.weightIdTOFw = state.probIdTOFw*track.weightTOFw;
+         if (track.weightIdTOFw <= 0.)
+         {
+            track.idTOFw = PART_ID::NONE;
+            track.weightIdTOFw = 0.;
+         }
+      }
+      else track.idTOFw = PART_ID::NONE;
+   }
 
-               // 10 is approximately the average number of sigma from gauss that 
-               // is used to account for gaussian widening of the resonance signal
-               if (mInv > resonanceMass - resonanceGamma*2. - 10. && 
-                   mInv < resonanceMass + resonanceGamma*2. + 10.)
-               {
-                  histContainer.distrOrigPTVsRecPT->Fill(origPT, pT, eventWeight);
-               }
+   track.SetMasks();
+}
 
-               thrContainer.distrMInvDCPC1NoPID->Fill(pT, mInv, eventWeight);
+void AnalyzeSimResonance::FillPairs(HistContainer& histContainer, 
+                                    const std::vector<ChargedTrack>& positiveTracks,
+                                    const std::vector<ChargedTrack>& negativeTracks, 
+                                    const std::vector<double>& pairsMInv, 
+                                    const std::vector<double>& pairsPT, 
+                                    const std::vector<PairCuts>& pairsCuts, 
+                                    const double origPT, const double eventWeight, 
+                                    const Configuration& configuration)
+{
+   const int daughter1Id = configuration.daughter1Id;
+   const int daughter2Id = configuration.daughter2Id;
 
-               if (IsDCPC11PID(posTrack, negTrack, daughter1Id, daughter2Id))
-               {
-                  thrContainer.distrMInvDCPC11PID->
-                     Fill(pT, mInv, eventWeight*
-                          CppTools::AtLeast1Prob(CppTools::AtLeast1Prob(posTrack.weightIdTOFe + 
-                                                                        posTrack.weightIdTOFw,
-                                                                        posTrack.weightIdEMCal), 
-                                                 CppTools::AtLeast1Prob(negTrack.weightIdTOFe + 
-                                                                        negTrack.weightIdTOFw, 
-                                                                        negTrack.weightIdEMCal)));
-
-                  if (Is1TOFDCPC11PID(posTrack, negTrack, daughter1Id, daughter2Id))
-                  {
-                     thrContainer.distrMInv1TOFDCPC11PID->
-                        Fill(pT, mInv, eventWeight*
-                             CppTools::AtLeast1Prob(CppTools::AtLeast1Prob(posTrack.weightIdTOFe + 
-                                                                           posTrack.weightIdTOFw), 
-                                                    CppTools::AtLeast1Prob(negTrack.weightIdTOFe + 
-                                                                           negTrack.weightIdTOFw)));
-                     // In MC daughter particles are never identified as different particle species
-                     if (Is1TOFDCPC11PID(posTrack, negTrack, PART_ID::KAON, PART_ID::KAON))
-                     {
-                        thrContainer.distrMInv1K1TOFDCPC11PID->
-                           Fill(pT, mInv, eventWeight*
-                                CppTools::AtLeast1Prob(CppTools::AtLeast1Prob(posTrack.weightIdTOFe + 
-                                                                              posTrack.weightIdTOFw), 
-                                                       CppTools::AtLeast1Prob(negTrack.weightIdTOFe + 
-                                                                              negTrack.weightIdTOFw)));
-                     }
-                  }
-                  else if (Is1EMCalDCPC11PID(posTrack, negTrack, daughter1Id, daughter2Id))
-                  {
-                     thrContainer.distrMInv1EMCalDCPC11PID->
-                        Fill(pT, mInv, eventWeight*
-                             CppTools::AtLeast1Prob(posTrack.weightIdEMCal, negTrack.weightIdEMCal));
-                  }
-               }
+   PairSelection selection;
 
-               if (!IsNoPID(posTrack, negTrack)) continue;
+   // looping over pairs of tracks
+   for (unsigned long i = 0; i < positiveTracks.size(); i++)
+   {
+      const ChargedTrack& posTrack = positiveTracks[i];
+      for (unsigned long j = 0; j < negativeTracks.size(); j++)
+      {
+         const ChargedTrack& negTrack = negativeTracks[j];
+         const unsigned long pairIndex = i*negativeTracks.size() + j;
+         const PairCuts& pair = pairsCuts[pairIndex];
 
-               const double posTrackNoPIDProb = 
-                  CppTools::AtLeast1Prob(posTrack.weightPC2, posTrack.weightPC3, 
-                                         posTrack.weightTOFe, posTrack.weightTOFw, 
-                                         posTrack.weightEMCal);
+         // invariant mass [GeV/c^2]
+         const double mInv = pairsMInv[pairIndex];
+         // pT of a pair [GeV/c]
+         const double pT = pairsPT[pairIndex];
 
-               const double negTrackNoPIDProb = 
-                  CppTools::AtLeast1Prob(negTrack.weightPC2, negTrack.weightPC3, 
-                                         negTrack.weightTOFe, negTrack.weightTOFw, 
-                                         negTrack.weightEMCal);
+         // check that shows whether invariant mass is within 2 gamma from mean of the signal
+         // 10 is a rough estimation for gaussian widening 
+         // due to finite momentum resolution of a detector system 
+         const bool isWithin2Gamma = (mInv > resonanceMass - resonanceGamma*2. - 10. && 
+                                      mInv < resonanceMass + resonanceGamma*2. + 10.);
 
-               thrContainer.distrMInvNoPID->
-                  Fill(pT, mInv, eventWeight*posTrackNoPIDProb*negTrackNoPIDProb);
+         if (pair.isGhostCut) continue;
 
-               if (IsPC2NoPID(posTrack, negTrack))
-               {
-                  thrContainer.distrMInvPC2NoPID->
-                     Fill(pT, mInv, eventWeight*posTrack.weightPC2*negTrack.weightPC2);
-               }
+         if (pair.isOneArmCut)
+         {
+            histContainer.distrMInvOneArmAntiCut.Fill(pT, mInv, eventWeight);
+            continue;
+         }
 
-               if (IsPC3NoPID(posTrack, negTrack))
-               {
-                  thrContainer.distrMInvPC3NoPID->
-                     Fill(pT, mInv, eventWeight*posTrack.weightPC3*negTrack.weightPC3);
-               }
+         // all pair selections below are bitwise operations on these masks
+         const PairMasks masks(posTrack, negTrack, pair.ghostMask, daughter1Id, daughter2Id);
+         // masks for the pair of kaons used for the histograms of kaon identification
+         const PairMasks kaonMasks(posTrack, negTrack, pair.ghostMask, 
+                                   PART_ID::KAON, PART_ID::KAON);
 
-               if (IsTOFeNoPID(posTrack, negTrack))
-               {
-                  thrContainer.distrMInvTOFeNoPID->
-                     Fill(pT, mInv, eventWeight*posTrack.weightTOFe*negTrack.weightTOFe);
-               }
+         if (masks.registered & DETECTOR_BIT::PC2)
+         {
+            if (isWithin2Gamma)
+            {
+               histContainer.distrDPC2PhiDPC2ZVsPT.
+                  Fill(static_cast<double>(posTrack.pc2z) - negTrack.pc2z, 
+                       posTrack.GetPC2Phi() - negTrack.GetPC2Phi(), eventWeight);
+            }
+         }
 
-               if (IsTOFwNoPID(posTrack, negTrack))
-               {
-                  thrContainer.distrMInvTOFwNoPID->
-                     Fill(pT, mInv, eventWeight*posTrack.weightTOFw*negTrack.weightTOFw);
-               }
+         if (masks.registered & DETECTOR_BIT::PC3)
+         {
+            if (isWithin2Gamma)
+            {
+               histContainer.distrDPC3PhiDPC3ZVsPT.
+                  Fill(static_cast<double>(posTrack.pc3z) - negTrack.pc3z, 
+                       posTrack.GetPC3Phi() - negTrack.GetPC3Phi(), eventWeight);
+            }
+         }
 
-               if (IsEMCalNoPID(posTrack, negTrack))
-               {
-                  thrContainer.distrMInvEMCalNoPID->
-                     Fill(pT, mInv, eventWeight*posTrack.weightEMCal*negTrack.weightEMCal);
-               }
+         if (masks.registered & DETECTOR_BIT::TOFE)
+         {
+            if (isWithin2Gamma)
+            {
+               histContainer.distrDChamberDSlatVsPT.
+                  Fill(static_cast<double>(posTrack.slat/96 - negTrack.slat/96) + 0.5,
+                       static_cast<double>((posTrack.slat % 96) - 
+                                           (negTrack.slat % 96)) + 0.5,
+                       pT, eventWeight);
+            }
 
-               if (!Is1PID(posTrack, negTrack, daughter1Id, daughter2Id)) continue;
+            if (masks.ghost & DETECTOR_BIT::TOFE)
+            {
+               histContainer.distrMInvTOFeGhostNoPID.Fill(pT, mInv, eventWeight);
+            }
+         }
+         else if (masks.registered & DETECTOR_BIT::TOFW)
+         {
+            if (isWithin2Gamma)
+            {
+               histContainer.distrDChamberDStripVsPT.
+                  Fill(static_cast<double>(posTrack.strip/96 - negTrack.strip/96) + 0.5,
+                       static_cast<double>((posTrack.strip % 96) - 
+                                           (negTrack.strip % 96)) + 0.5,
+                       pT, eventWeight);
+            }
+            if (masks.ghost & DETECTOR_BIT::TOFW)
+            {
+               histContainer.distrMInvTOFwGhostNoPID.Fill(pT, mInv, eventWeight);
+            }
+         }
 
-               thrContainer.distrMInv1PID->
-                  Fill(pT, mInv, eventWeight*
-                       CppTools::AtLeast1Prob(CppTools::AtLeast1Prob(posTrack.weightIdTOFe + 
-                                                                     posTrack.weightIdTOFw,
-                                                                     posTrack.weightIdEMCal)*
-                                              negTrackNoPIDProb, 
-                                              CppTools::AtLeast1Prob(negTrack.weightIdTOFe + 
-                                                                     negTrack.weightIdTOFw, 
-                                                                     negTrack.weightIdEMCal)*
-                                              posTrackNoPIDProb));
+         if ((masks.registered & DETECTOR_BIT::EMCAL) && posTrack.sector == negTrack.sector)
+         {
+            if (isWithin2Gamma)
+            {
+               histContainer.distrDYTowerDZTowerVsPT.
+                  Fill(static_cast<double>(posTrack.yTower - negTrack.yTower) + 0.5, 
+                       static_cast<double>(posTrack.zTower - negTrack.zTower) + 0.5, 
+                       pT, eventWeight);
+            }
+            if (posTrack.yTower == negTrack.yTower && posTrack.zTower == negTrack.zTower)
+            {
+               histContainer.distrMInvEMCalGhostNoPID.Fill(pT, mInv, eventWeight);
+            }
+         }
 
-               if (Is1TOF1PID(posTrack, negTrack, daughter1Id, daughter2Id))
-               {
-                  thrContainer.distrMInv1TOF1PID->
-                     Fill(pT, mInv, eventWeight*
-                          CppTools::AtLeast1Prob(CppTools::AtLeast1Prob(posTrack.weightIdTOFe,
-                                                                        posTrack.weightIdTOFw)*
-                                                 negTrackNoPIDProb, 
-                                                 CppTools::AtLeast1Prob(negTrack.weightIdTOFe,
-                                                                        negTrack.weightIdTOFw)*
-                                                 posTrackNoPIDProb));
-                  // In MC daughter particles are never identified as different particle species
-                  if (Is1TOF1PID(posTrack, negTrack, PART_ID::KAON, PART_ID::KAON))
-                  {
-                     thrContainer.distrMInv1K1TOF1PID->
-                        Fill(pT, mInv, eventWeight*
-                             CppTools::AtLeast1Prob(CppTools::AtLeast1Prob(posTrack.weightIdTOFe,
-                                                                           posTrack.weightIdTOFw)*
-                                                    negTrackNoPIDProb, 
-                                                    CppTools::AtLeast1Prob(negTrack.weightIdTOFe,
-                                                                           negTrack.weightIdTOFw)*
-                                                    posTrackNoPIDProb));
-                  }
-               }
+         // 10 is approximately the average number of sigma from gauss that 
+         // is used to account for gaussian widening of the resonance signal
+         if (mInv > resonanceMass - resonanceGamma*2. - 10. && 
+             mInv < resonanceMass + resonanceGamma*2. + 10.)
+         {
+            histContainer.distrOrigPTVsRecPT.Fill(origPT, pT, eventWeight);
+         }
 
-               if (Is1EMCal1PID(posTrack, negTrack, daughter1Id, daughter2Id))
-               {
-                  thrContainer.distrMInv1EMCal1PID->
-                     Fill(pT, mInv, eventWeight*
-                          CppTools::AtLeast1Prob(posTrack.weightIdEMCal*negTrackNoPIDProb, 
-                                                 negTrack.weightIdEMCal*posTrackNoPIDProb));
-               }
+         SelectPair(selection, posTrack, negTrack, masks, kaonMasks);
 
-               if (!Is2PID(posTrack, negTrack, daughter1Id, daughter2Id)) continue;
+         for (int method = 0; method < NUMBER_OF_PAIR_METHODS; method++)
+         {
+            if (!(selection.methods & (1u << method))) continue;
+            histContainer.distrMInvMethods[method]->
+               Fill(pT, mInv, eventWeight*selection.weights[method]);
+         }
+      }
+   }
+}
 
-               thrContainer.distrMInv2PID->
-                  Fill(pT, mInv, eventWeight*CppTools::AtLeast1Prob(posTrack.weightIdTOFe,
-                                                                    posTrack.weightIdTOFw, 
-                                                                    posTrack.weightIdEMCal)*
-                                             CppTools::AtLeast1Prob(negTrack.weightIdTOFe,
-                                                                    negTrack.weightIdTOFw, 
-                                                                    negTrack.weightIdEMCal));
+void AnalyzeSimResonance::SelectPair(PairSelection& selection, const ChargedTrack& posTrack, 
+                                     const ChargedTrack& negTrack, const PairMasks& masks, 
+                                     const PairMasks& kaonMasks)
+{
+   auto select = [&](const PairMethod method, const double weight)
+   {
+      selection.methods |= (1u << method);
+      selection.weights[method] = weight;
+   };
 
-               if (IsTOFe2PID(posTrack, negTrack, daughter1Id, daughter2Id))
-               {
-                  thrContainer.distrMInvTOFe2PID->
-                     Fill(pT, mInv, eventWeight*posTrack.weightIdTOFe*negTrack.weightIdTOFe);
-               }
+   selection.methods = 0;
 
-               if (IsTOFw2PID(posTrack, negTrack, daughter1Id, daughter2Id))
-               {
-                  thrContainer.distrMInvTOFw2PID->
-                     Fill(pT, mInv, eventWeight*posTrack.weightIdTOFw*negTrack.weightIdTOFw);
-               }
+   select(DCPC1_NO_PID, 1.);
 
-               if (IsEMCal2PID(posTrack, negTrack, daughter1Id, daughter2Id))
-               {
-                  thrContainer.distrMInvEMCal2PID->
-                     Fill(pT, mInv, eventWeight*posTrack.weightIdEMCal*negTrack.weightIdEMCal);
-               }
+   if (IsDCPC11PID(masks))
+   {
+      select(DCPC1_1PID, 
+             CppTools::AtLeast1Prob(CppTools::AtLeast1Prob(posTrack.weightIdTOFe + 
+                                                           posTrack.weightIdTOFw,
+                                                           posTrack.weightIdEMCal), 
+                                    CppTools::AtLeast1Prob(negTrack.weightIdTOFe + 
+                                                           negTrack.weightIdTOFw, 
+                                                           negTrack.weightIdEMCal)));
+
+      if (Is1TOFDCPC11PID(masks))
+      {
+         const double weight = 
+            CppTools::AtLeast1Prob(CppTools::AtLeast1Prob(posTrack.weightIdTOFe + 
+                                                          posTrack.weightIdTOFw), 
+                                   CppTools::AtLeast1Prob(negTrack.weightIdTOFe + 
+                                                          negTrack.weightIdTOFw));
+         select(TOF_DCPC1_1PID, weight);
+         // In MC daughter particles are never identified as different particle species
+         if (Is1TOFDCPC11PID(kaonMasks)) select(K_TOF_DCPC1_1PID, weight);
+      }
+      else if (Is1EMCalDCPC11PID(masks))
+      {
+         select(EMCAL_DCPC1_1PID, 
+                CppTools::AtLeast1Prob(posTrack.weightIdEMCal, negTrack.weightIdEMCal));
+      }
+   }
+
+   if (!IsNoPID(masks)) return;
+
+   const double posTrackNoPIDProb = 
+      CppTools::AtLeast1Prob(posTrack.weightPC2, posTrack.weightPC3, 
+                             posTrack.weightTOFe, posTrack.weightTOFw, 
+                             posTrack.weightEMCal);
+
+   const double negTrackNoPIDProb = 
+      CppTools::AtLeast1Prob(negTrack.weightPC2, negTrack.weightPC3, 
+                             negTrack.weightTOFe, negTrack.weightTOFw, 
+                             negTrack.weightEMCal);
+
+   select(NO_PID, posTrackNoPIDProb*negTrackNoPIDProb);
+
+   if (IsPC2NoPID(masks)) select(PC2_NO_PID, posTrack.weightPC2*negTrack.weightPC2);
+   if (IsPC3NoPID(masks)) select(PC3_NO_PID, posTrack.weightPC3*negTrack.weightPC3);
+   if (IsTOFeNoPID(masks)) select(TOFE_NO_PID, posTrack.weightTOFe*negTrack.weightTOFe);
+   if (IsTOFwNoPID(masks)) select(TOFW_NO_PID, posTrack.weightTOFw*negTrack.weightTOFw);
+   if (IsEMCalNoPID(masks)) select(EMCAL_NO_PID, posTrack.weightEMCal*negTrack.weightEMCal);
+
+   if (!Is1PID(masks)) return;
+
+   select(ONE_PID, 
+          CppTools::AtLeast1Prob(CppTools::AtLeast1Prob(posTrack.weightIdTOFe + 
+                                                        posTrack.weightIdTOFw,
+                                                        posTrack.weightIdEMCal)*
+                                 negTrackNoPIDProb, 
+                                 CppTools::AtLeast1Prob(negTrack.weightIdTOFe + 
+                                                        negTrack.weightIdTOFw, 
+                                                        negTrack.weightIdEMCal)*
+                                 posTrackNoPIDProb));
+
+   if (Is1TOF1PID(masks))
+   {
+      const double weight = 
+         CppTools::AtLeast1Prob(CppTools::AtLeast1Prob(posTrack.weightIdTOFe,
+                                                       posTrack.weightIdTOFw)*
+                                negTrackNoPIDProb, 
+                                CppTools::AtLeast1Prob(negTrack.weightIdTOFe,
+                                                       negTrack.weightIdTOFw)*
+                                posTrackNoPIDProb);
+      select(TOF_1PID, weight);
+      // In MC daughter particles are never identified as different particle species
+      if (Is1TOF1PID(kaonMasks)) select(K_TOF_1PID, weight);
+   }
+
+   if (Is1EMCal1PID(masks))
+   {
+      select(EMCAL_1PID, CppTools::AtLeast1Prob(posTrack.weightIdEMCal*negTrackNoPIDProb, 
+                                                negTrack.weightIdEMCal*posTrackNoPIDProb));
+   }
+
+   if (!Is2PID(masks)) return;
+
+   select(TWO_PID, CppTools::AtLeast1Prob(posTrack.weightIdTOFe, posTrack.weightIdTOFw, 
+                                          posTrack.weightIdEMCal)*
+                   CppTools::AtLeast1Prob(negTrack.weightIdTOFe, negTrack.weightIdTOFw, 
+                                          negTrack.weightIdEMCal));
+
+   if (IsTOFe2PID(masks)) select(TOFE_2PID, posTrack.weightIdTOFe*negTrack.weightIdTOFe);
+   if (IsTOFw2PID(masks)) select(TOFW_2PID, posTrack.weightIdTOFw*negTrack.weightIdTOFw);
+   if (IsEMCal2PID(masks)) select(EMCAL_2PID, posTrack.weightIdEMCal*negTrack.weightIdEMCal);
+
+   if (IsTOF2PID(masks))
+   {
+      select(TOF_2PID, posTrack.weightIdTOFe*negTrack.weightIdTOFe + 
+                       posTrack.weightIdTOFw*negTrack.weightIdTOFw);
+   }
+}
+
+void AnalyzeSimResonance::MixEvent(MixedHistContainer& mixedHistContainer, EventPool& pool, 
+                                   const int poolBin, 
+                                   const std::vector<ChargedTrack>& positiveTracks,
+                                   const std::vector<ChargedTrack>& negativeTracks, 
+                                   const TrackBlock& negativeTracksBlock,
+                                   const std::vector<double>& pairsMInv, 
+                                   const std::vector<double>& pairsPT,
+                                   const std::vector<PairCuts>& pairsCuts, 
+                                   std::vector<double>& mixedPairsMInv, 
+                                   std::vector<double>& mixedPairsPT,
+                                   const double eventWeight, const Configuration& configuration)
+{
+   mixedHistContainer.poolStatistics[poolBin]->Fill(1.5);
+   if (pool.GetSize() > 0) mixedHistContainer.poolStatistics[poolBin]->Fill(0.5);
+
+   // kinematics and cuts of the same event pairs were already evaluated for FillPairs
+   for (unsigned long i = 0; i < positiveTracks.size(); i++)
+   {
+      for (unsigned long j = 0; j < negativeTracks.size(); j++)
+      {
+         const unsigned long pairIndex = i*negativeTracks.size() + j;
+         const PairCuts& pair = pairsCuts[pairIndex];
+
+         if (pair.isGhostCut || pair.isOneArmCut) continue;
+
+         FillMixedHists(mixedHistContainer, false, poolBin, positiveTracks[i], 
+                        negativeTracks[j], pairsMInv[pairIndex], pairsPT[pairIndex], 
+                        pair.ghostMask, eventWeight, configuration);
+      }
+   }
+
+   unsigned long numberOfPairs = 0;
+   unsigned long numberOfPrunedPairs = 0;
+   unsigned long numberOfLostPrunedPairs = 0;
+
+   // pairs of positive tracks of one event with negative tracks of the other 
+   // are evaluated the same way as the same event pairs; the mixed event pairs outside 
+   // of the ranges of the mixed histograms are skipped since only the bins within 
+   // the axes of these histograms are used to normalize and subtract the background
+   auto fillMixedPairs = [&](const std::vector<ChargedTrack>& mixedPositiveTracks,
+                             const std::vector<ChargedTrack>& mixedNegativeTracks,
+                             const TrackBlock& mixedNegativeTracksBlock, const double weight)
+   {
+      // buffers only grow so they are not reallocated once they fit the largest event
+      mixedPairsMInv.resize(mixedNegativeTracks.size());
+      mixedPairsPT.resize(mixedNegativeTracks.size());
+
+      for (const ChargedTrack& posTrack : mixedPositiveTracks)
+      {
+         const std::pair<unsigned long, unsigned long> partnersRange = 
+            GetPartnersRange(posTrack, mixedNegativeTracksBlock, mixedMInvMax, mixedPTMax);
+
+         numberOfPairs += mixedNegativeTracks.size();
+         numberOfPrunedPairs += 
+            mixedNegativeTracks.size() - (partnersRange.second - partnersRange.first);
 
-               if (IsTOF2PID(posTrack, negTrack, daughter1Id, daughter2Id))
+         if (verifyPairPruning)
+         {
+            GetPairsMassPT(posTrack, mixedNegativeTracksBlock, 
+                           mixedPairsMInv.data(), mixedPairsPT.data());
+            for (unsigned long j = 0; j < mixedNegativeTracks.size(); j++)
+            {
+               if ((j < partnersRange.first || j >= partnersRange.second) && 
+                   mixedPairsMInv[j] < mixedMInvMax && mixedPairsPT[j] < mixedPTMax)
                {
-                  thrContainer.distrMInvTOF2PID->
-                     Fill(pT, mInv, eventWeight*(posTrack.weightIdTOFe*negTrack.weightIdTOFe + 
-                                                 posTrack.weightIdTOFw*negTrack.weightIdTOFw));
+                  numberOfLostPrunedPairs++;
                }
             }
          }
+         else GetPairsMassPT(posTrack, mixedNegativeTracksBlock, 
+                             partnersRange.first, partnersRange.second, 
+                             mixedPairsMInv.data(), mixedPairsPT.data());
+
+         for (unsigned long j = partnersRange.first; j < partnersRange.second; j++)
+         {
+            const ChargedTrack& negTrack = mixedNegativeTracks[j];
+
+            if (IsGhostCut(posTrack, negTrack) || IsOneArmCut(posTrack, negTrack)) continue;
+
+            FillMixedHists(mixedHistContainer, true, poolBin, posTrack, negTrack, 
+                           mixedPairsMInv[j], mixedPairsPT[j], GetGhostMask(posTrack, negTrack), 
+                           weight, configuration);
+         }
       }
    };
 
-   tp.Process(ProcessMP);
+   for (unsigned long i = 0; i < pool.GetSize(); i++)
+   {
+      const PooledEvent& pooledEvent = pool.Get(i);
+      // geometric mean keeps the weights of the mixed event pairs 
+      // on the same scale as the weights of the same event pairs
+      const double weight = sqrt(eventWeight*pooledEvent.weight);
+
+      fillMixedPairs(positiveTracks, pooledEvent.negativeTracks, 
+                     pooledEvent.negativeTracksBlock, weight);
+      fillMixedPairs(pooledEvent.positiveTracks, negativeTracks, negativeTracksBlock, weight);
+   }
+
+   progress.Add(ProgressMonitor::PAIRS, numberOfPairs);
+   progress.Add(ProgressMonitor::PRUNED_PAIRS, numberOfPrunedPairs);
+   progress.Add(ProgressMonitor::LOST_PRUNED_PAIRS, numberOfLostPrunedPairs);
+
+   // events without tracks cannot form pairs so they are not kept in the pool
+   if (!positiveTracks.empty() || !negativeTracks.empty())
+   {
+      pool.Add(positiveTracks, negativeTracks, eventWeight);
+   }
+}
+
+void AnalyzeSimResonance::FillMixedHists(MixedHistContainer& mixedHistContainer, 
+                                         const bool isMixed, const int poolBin, 
+                                         const ChargedTrack& posTrack, 
+                                         const ChargedTrack& negTrack, 
+                                         const double mInv, const double pT, 
+                                         const unsigned int ghostMask, const double weight, 
+                                         const Configuration& configuration)
+{
+   const PairMasks masks(posTrack, negTrack, ghostMask, 
+                         configuration.daughter1Id, configuration.daughter2Id);
+   const PairMasks kaonMasks(posTrack, negTrack, ghostMask, PART_ID::KAON, PART_ID::KAON);
+
+   PairSelection selection;
+   SelectPair(selection, posTrack, negTrack, masks, kaonMasks);
+
+   for (unsigned long i = 0; i < mixedPairMethods.size(); i++)
+   {
+      const int method = mixedPairMethods[i];
+      if (!(selection.methods & (1u << method))) continue;
+
+      const unsigned long index = 
+         mixedHistContainer.GetIndex(poolBin, configuration.decayModeIndex, i);
+      const double pairWeight = weight*selection.weights[method];
+
+      if (isMixed)
+      {
+         mixedHistContainer.distrMInvBG[index]->Fill(pT, mInv, pairWeight);
+         mixedHistContainer.distrMInvBGLR[index]->Fill(pT, mInv, pairWeight);
+      }
+      else
+      {
+         mixedHistContainer.distrMInvFG[index]->Fill(pT, mInv, pairWeight);
+         mixedHistContainer.distrMInvFGLR[index]->Fill(pT, mInv, pairWeight);
+      }
+   }
 }
 
 int main(int argc, char **argv)
 {
-   if (argc < 2 || argc > 6) 
+   isMultiVariation = (argc > 2 && static_cast<std::string>(argv[2]) == "variations");
+
+   if (argc < 2 || argc > 6 || (isMultiVariation && argc > 4)) 
    {
       std::string errMsg = 
          "Expected 1-6 parameters while " + std::to_string(argc - 1) + " "\
          "parameter(s) were provided \n Usage: bin/AnalyzeSimResonance "\
          "inputYAMLName pTScale=1. acceptanceVar=0 cutsVar=0"\
          "numberOfThreads=std::thread::hardware_concurrency()\n"\
-         "Unless at leat pTScale is not a default parameter this program will "\
-         "run for all variations of every individual parameters (pTScale, acceptanceVar, "\
-         "and cutsVar) while setting values of the rest to default";
+         "or bin/AnalyzeSimResonance inputYAMLName variations "\
+         "numberOfThreads=std::thread::hardware_concurrency()\n"\
+         "In the second case the default parameters and all variations from the list "\
+         "\"variations\" of the input file are processed in the same pass over the "\
+         "simulated trees and are written in one file";
       CppTools::PrintError(errMsg);
    }
  
    CppTools::CheckInputFile(argv[1]);
 
-   if (argc > 2) pTScale = std::atof(argv[2]);
-   if (argc > 3) acceptanceVar = std::atoi(argv[3]);
-   if (argc > 4) cutsVar = std::atoi(argv[4]);
-   if (argc == 6) numberOfThreads = std::stoi(argv[5]);
-   else numberOfThreads = std::thread::hardware_concurrency();
+   // default parameters are always processed first
+   variations.emplace_back();
+
+   if (isMultiVariation)
+   {
+      if (argc == 4) numberOfThreads = std::stoi(argv[3]);
+      else numberOfThreads = std::thread::hardware_concurrency();
+   }
+   else
+   {
+      if (argc > 2) variations.back().pTScale = std::atof(argv[2]);
+      if (argc > 3) variations.back().acceptanceVar = std::atoi(argv[3]);
+      if (argc > 4) variations.back().cutsVar = std::atoi(argv[4]);
+      if (argc == 6) numberOfThreads = std::stoi(argv[5]);
+      else numberOfThreads = std::thread::hardware_concurrency();
+   }
 
    ROOT::EnableImplicitMT(numberOfThreads);
 
@@ -699,8 +1010,83 @@ int main(int argc, char **argv)
    inputYAMLMain.OpenFile("input/" + runName + "/main.yaml");
    inputYAMLMain.CheckStatus("main");
 
+   // parameters of reading simulated trees are optional; ROOT defaults are used otherwise
+   treeCacheSizeFactor = inputYAMLMain["tree_cache_size_factor"].as<double>(1.);
+   treeCacheLearnEntries = inputYAMLMain["tree_cache_learn_entries"].as<int>(100);
+   asyncPrefetching = inputYAMLMain["async_prefetching"].as<bool>(false);
+   prefetchNextFile = inputYAMLMain["prefetch_next_file"].as<bool>(true);
+   outputCompressionLevel = inputYAMLMain["output_compression_level"].as<int>(6);
+   verifyPairPruning = inputYAMLMain["verify_pair_pruning"].as<bool>(false);
+   mixedEventPoolDepth = inputYAMLMain["mixed_event_pool_depth"].as<unsigned long>(0);
+
+   SimTreeReader::ConfigureIO(treeCacheSizeFactor, treeCacheLearnEntries, asyncPrefetching);
+
    inputYAMLSimSingleTrack.OpenFile("input/" + runName + "/single_track_sim.yaml");
    inputYAMLSimSingleTrack.CheckStatus("single_track_sim");
+
+   resonanceMass = inputYAMLResonance["mass"].as<double>();
+   resonanceGamma = inputYAMLResonance["gamma"].as<double>();
+
+   if (isMultiVariation)
+   {
+      for (const auto& variationNode : inputYAMLResonance["variations"])
+      {
+         variations.emplace_back();
+         variations.back().pTScale = variationNode["pt_scale"].as<double>(1.);
+         variations.back().acceptanceVar = variationNode["acceptance_var"].as<int>(0);
+         variations.back().cutsVar = variationNode["cuts_var"].as<int>(0);
+      }
+   }
+
+   for (Variation& variation : variations)
+   {
+      variation.name = inputYAMLResonance["name"].as<std::string>();
+
+      if (fabs(variation.pTScale - 1.) > 1e-15)
+      {
+         variation.name += "_pTScale_" + CppTools::DtoStr(variation.pTScale, 3);
+      }
+
+      if (variation.acceptanceVar != 0) 
+      {
+         variation.name += std::string("_acceptance_var_") + 
+                           (variation.acceptanceVar > 0 ? "increased" : "decreased");
+         variation.accVar.Set("data/Parameters/" + runName + "/Acceptance.txt");
+      }
+
+      if (variation.cutsVar != 0) 
+      {
+         variation.name += std::string("_cuts_var_") + 
+                           (variation.cutsVar < 0 ? "tightened" : "loosened");
+      }
+
+      for (const Variation& otherVariation : variations)
+      {
+         if (&otherVariation != &variation && otherVariation.name == variation.name)
+         {
+            CppTools::PrintError("Variation " + variation.name + " is specified more than once");
+         }
+      }
+
+      variation.thrContainer = 
+         std::make_unique<ThrContainer>(inputYAMLMain["detectors_configuration"].
+                                        as<std::string>());
+   }
+
+   for (unsigned long i = 0; i < variations.size(); i++)
+   {
+      bool isGroupFound = false;
+      for (std::vector<unsigned long>& pTScaleGroup : pTScaleGroups)
+      {
+         if (fabs(variations[pTScaleGroup.front()].pTScale - variations[i].pTScale) < 1e-15)
+         {
+            pTScaleGroup.push_back(i);
+            isGroupFound = true;
+            break;
+         }
+      }
+      if (!isGroupFound) pTScaleGroups.push_back({i});
+   }
  
    collisionSystemName = inputYAMLMain["collision_system_name"].as<std::string>();
 
@@ -751,10 +1137,10 @@ int main(int argc, char **argv)
             magneticField["name"].as<std::string>() + ".root";
 
          CppTools::CheckInputFile(simInputFileName);
+         simInputFileNames.push_back(simInputFileName);
 
-         unsigned long currentConfigurationNumberOfEvents = static_cast<unsigned long>
-            ((static_cast<TTree *>(TFile::Open(simInputFileName.c_str())->
-                                   Get("Tree"))->GetEntries()));
+         unsigned long currentConfigurationNumberOfEvents = 
+            SimTreeIndex::GetNumberOfEntries(simInputFileName);
          if (currentConfigurationNumberOfEvents <= 0)
          {
             CppTools::PrintError("Number of events is equal or less than 0 in file " + 
@@ -773,20 +1159,55 @@ int main(int argc, char **argv)
                magneticField["name"].as<std::string>() + ".root";
 
             CppTools::CheckInputFile(simInputFileName);
+            simInputFileNames.push_back(simInputFileName);
 
-            currentConfigurationNumberOfEvents = static_cast<unsigned long>
-               ((static_cast<TTree *>(TFile::Open(simInputFileName.c_str())->
-                                      Get("Tree"))->GetEntries()));
+            currentConfigurationNumberOfEvents = 
+               SimTreeIndex::GetNumberOfEntries(simInputFileName);
             if (currentConfigurationNumberOfEvents <= 0)
             {
                CppTools::PrintError("Number of events is equal or less than 0 in file " + 
                                     simInputFileName);
             }
+            numberOfEvents += currentConfigurationNumberOfEvents;
          }
-         numberOfEvents += currentConfigurationNumberOfEvents;
       }
    }
 
+   if (mixedEventPoolDepth > 0)
+   {
+      const int daughter1Id = inputYAMLResonance["daughter1_id"].as<int>();
+      const int daughter2Id = inputYAMLResonance["daughter2_id"].as<int>();
+
+      mixedDecayModes.push_back(ParticleMap::nameShort[daughter1Id] + 
+                                ParticleMap::nameShort[daughter2Id]);
+      if (inputYAMLResonance["has_antiparticle"].as<bool>())
+      {
+         mixedDecayModes.push_back(ParticleMap::nameShort[-daughter2Id] + 
+                                   ParticleMap::nameShort[-daughter1Id]);
+      }
+
+      for (const auto& method : inputYAMLResonance["pair_selection_methods"])
+      {
+         const std::string methodName = method["name"].as<std::string>();
+         const auto methodNameIt = 
+            std::find(pairMethodsNames.begin(), pairMethodsNames.end(), methodName);
+         if (methodNameIt == pairMethodsNames.end())
+         {
+            CppTools::PrintError("Unknown pair selection method " + methodName);
+         }
+         mixedPairMethods.push_back(static_cast<int>(methodNameIt - pairMethodsNames.begin()));
+      }
+
+      // every file is mixed separately so that the tracks of different particles and of 
+      // different magnetic fields are never mixed; simulated events have neither centrality
+      // nor reaction plane so the pools are only split into z_{vtx} bins
+      eventPools = std::make_unique<ThrEventPools>(1, inputYAMLResonance["cb_z_bins"].as<int>(), 
+                                                   1, -30., 30., mixedEventPoolDepth, 
+                                                   simInputFileNames.size());
+      thrMixedContainer = std::make_unique<ThrHistContainer<MixedHistContainer>>
+         (inputYAMLMain["detectors_configuration"].as<std::string>());
+   }
+
    std::vector<std::string> magneticFieldsList;
    for (const auto& magneticField : inputYAMLMain["magnetic_field_configurations"])
    {
@@ -813,170 +1234,230 @@ int main(int argc, char **argv)
    box.AddEntry("Charged track minimum pT [GeV/c]", pTMin);
    box.AddEntry("Charged track maximum pT [GeV/c]", pTMax);
    box.AddEntry("Reweight for pT spectra", reweightForSpectra);
-   box.AddEntry("pT variation scale", pTScale, 3);
+   if (isMultiVariation)
+   {
+      std::vector<std::string> variationsNames;
+      for (const Variation& variation : variations)
+      {
+         variationsNames.push_back(variation.name);
+      }
+      box.AddEntry("Variations", variationsNames);
+   }
+   else
+   {
+      const Variation& variation = variations.front();
 
-   if (acceptanceVar > 0) box.AddEntry("Acceptance variation", "increased");
-   else if (acceptanceVar < 0) box.AddEntry("Acceptance variation", "decreased");
-   else box.AddEntry("Acceptance variation", "none");
+      box.AddEntry("pT variation scale", variation.pTScale, 3);
 
-   if (cutsVar < 0) box.AddEntry("Cuts variation", "loosened");
-   else if (cutsVar > 0) box.AddEntry("Cuts variation", "tightened");
-   else box.AddEntry("Cuts variation", "none");
+      if (variation.acceptanceVar > 0) box.AddEntry("Acceptance variation", "increased");
+      else if (variation.acceptanceVar < 0) box.AddEntry("Acceptance variation", "decreased");
+      else box.AddEntry("Acceptance variation", "none");
+
+      if (variation.cutsVar < 0) box.AddEntry("Cuts variation", "loosened");
+      else if (variation.cutsVar > 0) box.AddEntry("Cuts variation", "tightened");
+      else box.AddEntry("Cuts variation", "none");
+   }
 
    box.AddEntry("Number of threads", numberOfThreads);
+   box.AddEntry("Tree cache size, clusters", treeCacheSizeFactor, 2);
+   box.AddEntry("Tree cache learn entries", treeCacheLearnEntries);
+   box.AddEntry("Async prefetching", asyncPrefetching);
+   box.AddEntry("Prefetch next file", prefetchNextFile);
+   box.AddEntry("Output compression level", outputCompressionLevel);
+   box.AddEntry("Verify pair pruning", verifyPairPruning);
+   box.AddEntry("Mixed event pool depth", static_cast<int>(mixedEventPoolDepth));
    box.AddEntry("Number of events to be analyzed, 1e6", 
                 static_cast<double>(numberOfEvents)/1e6, 3);
    box.Print();
 
-   bool isProcessFinished = false;
+   std::atomic<bool> isProcessFinished = false;
 
    auto pBarCall = [&]()
    {
       ProgressBar pBar{"FANCY"};
-      while (!isProcessFinished)
+      for (unsigned long i = 1; !isProcessFinished; i++)
       {
-         pBar.Print(static_cast<double>(numberOfCalls)/
-                    static_cast<double>(numberOfEvents));
+         pBar.Print(progress.GetProgress(numberOfEvents));
+         // rates and the remaining time are reported every 10 seconds
+         if (i % 100 == 0)
+         {
+            pBar.Clear();
+            CppTools::PrintInfo(progress.GetStatus());
+            pBar.RePrint();
+         }
          std::this_thread::sleep_for(std::chrono::milliseconds(100));
       }
       pBar.Finish();
       CppTools::PrintInfo("AnalyzerResonance has finished processing simulated data");
    };
  
+   // all configurations are processed as one set of tasks so they form one stage
+   progress.StartStage(inputYAMLResonance["name"].as<std::string>(), numberOfEvents);
+
    std::thread pBarThread(pBarCall);
- 
-   ThrContainer thrContainer;
+
+   // configurations are set in the same order as the names in simInputFileNames
+   std::vector<Configuration> configurations;
 
    for (const auto& magneticField : inputYAMLMain["magnetic_field_configurations"])
    {
       for (const auto& pTRange : inputYAMLResonance["sim_pt_ranges"])
       {
-         AnalyzeConfiguration(thrContainer, inputYAMLResonance["name"].as<std::string>(), 
-                              inputYAMLResonance["daughter1_id"].as<int>(),
-                              inputYAMLResonance["daughter2_id"].as<int>(),
-                              magneticField["name"].as<std::string>(), 
-                              pTRange["name"].as<std::string>());
+         configurations.emplace_back();
+         SetConfiguration(configurations.back(), inputYAMLResonance["name"].as<std::string>(), 
+                          inputYAMLResonance["daughter1_id"].as<int>(),
+                          inputYAMLResonance["daughter2_id"].as<int>(),
+                          magneticField["name"].as<std::string>(), 
+                          pTRange["name"].as<std::string>());
          if (inputYAMLResonance["has_antiparticle"].as<bool>())
          {
-            AnalyzeConfiguration(thrContainer, inputYAMLResonance["name"].as<std::string>(), 
-                                 -1*inputYAMLResonance["daughter2_id"].as<int>(),
-                                 -1*inputYAMLResonance["daughter1_id"].as<int>(),
-                                 magneticField["name"].as<std::string>(), 
-                                 pTRange["name"].as<std::string>());
+            configurations.emplace_back();
+            SetConfiguration(configurations.back(), 
+                             inputYAMLResonance["name"].as<std::string>(), 
+                             -1*inputYAMLResonance["daughter2_id"].as<int>(),
+                             -1*inputYAMLResonance["daughter1_id"].as<int>(),
+                             magneticField["name"].as<std::string>(), 
+                             pTRange["name"].as<std::string>());
+            configurations.back().decayModeIndex = 1;
          }
       }
    }
 
+   for (unsigned long i = 0; i < configurations.size(); i++) configurations[i].index = i;
+
+   std::vector<const std::vector<unsigned long> *> selectedEntries;
+   for (const Configuration& configuration : configurations)
+   {
+      selectedEntries.push_back(configuration.isIndexed ? 
+                                &configuration.selectedEntries : nullptr);
+   }
+
+   // all files are processed as one set of tasks so that 
+   // the threads do not idle at the end of each file
+   SimTreeReader::Process(simInputFileNames, simTreeBranches, 
+                          [&](SimTreeReader &simCNT, const unsigned long fileIndex)
+   {
+      ProcessTask(simCNT, configurations[fileIndex]);
+   }, "Tree", selectedEntries, prefetchNextFile);
 
    isProcessFinished = true;
    pBarThread.join();
 
+   // only the mixed event pairs are skipped by kinematic bounds
+   if (eventPools)
+   {
+      const unsigned long numberOfPairs = progress.Get(ProgressMonitor::PAIRS);
+      const unsigned long numberOfPrunedPairs = progress.Get(ProgressMonitor::PRUNED_PAIRS);
+
+      CppTools::PrintInfo("Mixed event pairs skipped by kinematic bounds: " + 
+                          std::to_string(numberOfPrunedPairs) + " out of " + 
+                          std::to_string(numberOfPairs));
+      if (verifyPairPruning)
+      {
+         const unsigned long numberOfLostPairs = 
+            progress.Get(ProgressMonitor::LOST_PRUNED_PAIRS);
+         if (numberOfLostPairs == 0)
+         {
+            CppTools::PrintInfo("None of the skipped pairs could have filled "\
+                                "the mixed event histograms");
+         }
+         else
+         {
+            CppTools::PrintWarning(std::to_string(numberOfLostPairs) + " of the skipped pairs "\
+                                   "could have filled the mixed event histograms");
+         }
+      }
+   }
+
+   SimTreeReader::PrintIOReport(simInputFileNames, simTreeBranches);
+
    // writing the result
-   std::string outputFileName = "data/PostSim/" + runName + "/Resonance/" + 
-                                inputYAMLResonance["name"].as<std::string>();
+   if (isMultiVariation)
+   {
+      const std::string outputFileName = 
+         outputDir + inputYAMLResonance["name"].as<std::string>() + "_variations.root";
+
+      TFile outputFile(outputFileName.c_str(), "RECREATE");
+      outputFile.SetCompressionLevel(outputCompressionLevel);
+
+      // histograms of only one variation are merged at a time
+      for (const Variation& variation : variations)
+      {
+         variation.thrContainer->Merge(numberOfThreads).
+            Write(*outputFile.mkdir(variation.name.c_str()));
+      }
 
-   if (acceptanceVar != 0) 
+      outputFile.Close();
+      CppTools::PrintInfo("File " + outputFileName + " was written");
+   }
+   else
    {
-      outputFileName += std::string("_acceptance_var_") + 
-                        (acceptanceVar > 0 ? "increased" : "decreased");
+      variations.front().thrContainer->Merge(numberOfThreads).
+         Write(outputDir + variations.front().name + ".root", outputCompressionLevel);
    }
 
-   if (cutsVar != 0) 
+   // FG and BG histograms are written in the same layout as the histograms of the real data
+   if (thrMixedContainer)
    {
-      outputFileName += std::string("_cuts_var_") + (cutsVar < 0 ? "tightened" : "loosened");
+      const std::string outputFileName = outputDir + variations.front().name + "_mixed.root";
+      thrMixedContainer->Merge(numberOfThreads).Write(outputFileName, outputCompressionLevel);
+      CppTools::PrintInfo("File " + outputFileName + " was written");
    }
 
-   outputFileName += ".root";
-
-   thrContainer.Write(outputFileName);
-
    return 0;
 }
 
-ThrContainerCopy AnalyzeSimResonance::ThrContainer::GetCopy()
+AnalyzeSimResonance::HistContainer::HistContainer(const std::string& detectorsConfiguration) :
+   registry(detectorsConfiguration), 
+   distrMInvMethods{{&distrMInvDCPC1NoPID, &distrMInvNoPID, &distrMInvPC2NoPID, 
+                     &distrMInvPC3NoPID, &distrMInvTOFeNoPID, &distrMInvTOFwNoPID, 
+                     &distrMInvEMCalNoPID, &distrMInvDCPC11PID, &distrMInv1TOFDCPC11PID, 
+                     &distrMInv1K1TOFDCPC11PID, &distrMInv1EMCalDCPC11PID, &distrMInv1PID, 
+                     &distrMInv1TOF1PID, &distrMInv1K1TOF1PID, &distrMInv1EMCal1PID, 
+                     &distrMInv2PID, &distrMInvTOF2PID, &distrMInvTOFe2PID, &distrMInvTOFw2PID, 
+                     &distrMInvEMCal2PID}} {}
+
+AnalyzeSimResonance::MixedHistContainer::
+MixedHistContainer(const std::string& detectorsConfiguration) : registry(detectorsConfiguration)
 {
-   ThrContainerCopy copy;
-
-   copy.distrOrigUnscaledPT = distrOrigUnscaledPT->Get();
-   copy.distrOrigPT = distrOrigPT->Get();
-   copy.distrOrigPTVsRecDaughtersPT = distrOrigPTVsRecDaughtersPT.Get();
-   copy.distrOrigPTVsRecPT = distrOrigPTVsRecPT.Get();
-   copy.distrOrigPTVsDecayRecPT = distrOrigPTVsDecayRecPT.Get();
-   copy.distrMInvDCPC1NoPID = distrMInvDCPC1NoPID.Get();
-   copy.distrMInvOneArmAntiCut = distrMInvOneArmAntiCut.Get();
-   copy.distrMInvTOFeGhostNoPID = distrMInvTOFeGhostNoPID.Get();
-   copy.distrMInvTOFwGhostNoPID = distrMInvTOFwGhostNoPID.Get();
-   copy.distrMInvEMCalGhostNoPID = distrMInvEMCalGhostNoPID.Get();
-   copy.distrMInvNoPID = distrMInvNoPID.Get();
-   copy.distrMInvPC2NoPID = distrMInvPC2NoPID.Get();
-   copy.distrMInvPC3NoPID = distrMInvPC3NoPID.Get();
-   copy.distrMInvTOFeNoPID = distrMInvTOFeNoPID.Get();
-   copy.distrMInvTOFwNoPID = distrMInvTOFwNoPID.Get();
-   copy.distrMInvEMCalNoPID = distrMInvEMCalNoPID.Get();
-   copy.distrMInvDCPC11PID = distrMInvDCPC11PID.Get();
-   copy.distrMInv1TOFDCPC11PID = distrMInv1TOFDCPC11PID.Get();
-   copy.distrMInv1K1TOFDCPC11PID = distrMInv1K1TOFDCPC11PID.Get();
-   copy.distrMInv1EMCalDCPC11PID = distrMInv1EMCalDCPC11PID.Get();
-   copy.distrMInv1PID = distrMInv1PID.Get();
-   copy.distrMInv1TOF1PID = distrMInv1TOF1PID.Get();
-   copy.distrMInv1K1TOF1PID = distrMInv1K1TOF1PID.Get();
-   copy.distrMInv1EMCal1PID = distrMInv1EMCal1PID.Get();
-   copy.distrMInv2PID = distrMInv2PID.Get();
-   copy.distrMInvTOF2PID = distrMInvTOF2PID.Get();
-   copy.distrMInvTOFe2PID = distrMInvTOFe2PID.Get();
-   copy.distrMInvTOFw2PID = distrMInvTOFw2PID.Get();
-   copy.distrMInvEMCal2PID = distrMInvEMCal2PID.Get();
-   copy.distrDPC2PhiDPC2ZVsPT = distrDPC2PhiDPC2ZVsPT.Get();
-   copy.distrDPC3PhiDPC3ZVsPT = distrDPC3PhiDPC3ZVsPT.Get();
-   copy.distrDChamberDSlatVsPT = distrDChamberDSlatVsPT.Get();
-   copy.distrDChamberDStripVsPT = distrDChamberDStripVsPT.Get();
-   copy.distrDYTowerDZTowerVsPT = distrDYTowerDZTowerVsPT.Get();
-
-   return copy;
+   for (int bin = 0; bin < eventPools->GetNumberOfBins(); bin++)
+   {
+      const std::string directory = eventPools->GetBinName(bin);
+
+      // bin 1 - events that were mixed with at least one event, bin 2 - all events
+      poolStatistics.push_back(std::make_unique<FlatHist<TH1D>>
+         (registry, HistRegistry::ANY, directory, "PoolStatistics", "number of events", 
+          2, 0., 2.));
+
+      for (const std::string& decayMode : mixedDecayModes)
+      {
+         for (const int method : mixedPairMethods)
+         {
+            const std::string name = pairMethodsNames[method] + ": " + decayMode;
+
+            distrMInvFG.push_back(std::make_unique<FlatHist<TH2F>>
+               (registry, HistRegistry::ANY, directory, name + "_FG12", "M_{inv} vs p_{T}", 
+                200, 0., mixedPTMax, 1000, 0., mixedMInvMax));
+            distrMInvBG.push_back(std::make_unique<FlatHist<TH2F>>
+               (registry, HistRegistry::ANY, directory, name + "_BG12", "M_{inv} vs p_{T}", 
+                200, 0., mixedPTMax, 1000, 0., mixedMInvMax));
+            distrMInvFGLR.push_back(std::make_unique<FlatHist<TH2F>>
+               (registry, HistRegistry::ANY, directory, "LR " + name + "_FG12", 
+                "M_{inv} vs p_{T}", 200, 0., mixedPTMax, 100, 0., mixedMInvMax));
+            distrMInvBGLR.push_back(std::make_unique<FlatHist<TH2F>>
+               (registry, HistRegistry::ANY, directory, "LR " + name + "_BG12", 
+                "M_{inv} vs p_{T}", 200, 0., mixedPTMax, 100, 0., mixedMInvMax));
+         }
+      }
+   }
 }
 
-void AnalyzeSimResonance::ThrContainer::Write(const std::string& outputFileName)
+unsigned long AnalyzeSimResonance::MixedHistContainer::
+GetIndex(const int poolBin, const unsigned long decayModeIndex, 
+         const unsigned long methodIndex) const
 {
-   TFile outputFile(outputFileName.c_str(), "RECREATE");
-   outputFile.SetCompressionLevel(6);
-   outputFile.cd();
-
-   static_cast<std::shared_ptr<TH1D>>(distrOrigUnscaledPT->Merge())->Write();
-   static_cast<std::shared_ptr<TH1D>>(distrOrigPT->Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrOrigPTVsRecDaughtersPT.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrOrigPTVsRecPT.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrOrigPTVsDecayRecPT.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrMInvDCPC1NoPID.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrMInvOneArmAntiCut.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrMInvTOFeGhostNoPID.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrMInvTOFwGhostNoPID.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrMInvEMCalGhostNoPID.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrMInvNoPID.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrMInvPC2NoPID.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrMInvPC3NoPID.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrMInvTOFeNoPID.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrMInvTOFwNoPID.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrMInvEMCalNoPID.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrMInvDCPC11PID.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrMInv1TOFDCPC11PID.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrMInv1K1TOFDCPC11PID.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrMInv1EMCalDCPC11PID.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrMInv1PID.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrMInv1TOF1PID.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrMInv1K1TOF1PID.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrMInv1EMCal1PID.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrMInv2PID.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrMInvTOF2PID.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrMInvTOFe2PID.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrMInvTOFw2PID.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrMInvEMCal2PID.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrDPC2PhiDPC2ZVsPT.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrDPC3PhiDPC3ZVsPT.Merge())->Write();
-   static_cast<std::shared_ptr<TH3F>>(distrDChamberDSlatVsPT.Merge())->Write();
-   static_cast<std::shared_ptr<TH3F>>(distrDChamberDStripVsPT.Merge())->Write();
-   static_cast<std::shared_ptr<TH3F>>(distrDYTowerDZTowerVsPT.Merge())->Write();
-
-   outputFile.Close();
+   return (static_cast<unsigned long>(poolBin)*mixedDecayModes.size() + 
+           decayModeIndex)*mixedPairMethods.size() + methodIndex;
 }
 
 void AnalyzeSimResonance::AcceptanceVar::Set(const std::string& fileName)
@@ -996,4 +1477,16 @@ void AnalyzeSimResonance::AcceptanceVar::Set(const std::string& fileName)
    }
 }
 
+void AnalyzeSimResonance::CandidateTracks::Clear()
+{
+   index.clear();
+   dcarm.clear();
+   zed.clear();
+   board.clear();
+   alpha.clear();
+   ppc1z.clear();
+   ppc1phi.clear();
+   deadMasks.clear();
+}
+
 #endif /* ANALYZE_SIM_RESONANCE_CPP */
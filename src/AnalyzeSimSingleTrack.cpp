@@ -16,10 +16,11 @@
 // being accessed only via the scope resolution operator in this file
 using namespace AnalyzeSimSingleTrack;
 
-void AnalyzeSimSingleTrack::AnalyzeConfiguration(ThrContainer &thrContainer, 
-                                              const int particleId, 
-                                              const std::string& magneticFieldName, 
-                                              const std::string &pTRangeName)
+void AnalyzeSimSingleTrack::SetConfiguration(Configuration &configuration, 
+                                             ThrContainer &thrContainer, 
+                                             const int particleId, 
+                                             const std::string& magneticFieldName, 
+                                             const std::string &pTRangeName)
 { 
 
    const std::string particleName = ParticleMap::name[particleId];
@@ -137,947 +138,1306 @@ void AnalyzeSimSingleTrack::AnalyzeConfiguration(ThrContainer &thrContainer,
       }
    }
 
-   ROOT::TTreeProcessorMT tp(simInputFileName.c_str());
-  
-   auto ProcessMP = [&](TTreeReader &reader)
+   configuration.simInputFileName = simInputFileName;
+   configuration.trackCacheFileName = 
+      "data/TrackCache/" + runName + "/SingleTrack/" + 
+      particleName + "_" + pTRangeName + magneticFieldName + ".cache";
+   configuration.particleId = particleId;
+   configuration.particleGeantId = particleGeantId;
+   configuration.eventNormWeight = eventNormWeight;
+
+   // simulated tree is not read when tracks are replayed from the cache
+   if (trackCacheMode == "replay")
+   {
+      configuration.weightFunc = std::move(weightFunc);
+      return;
+   }
+
+   if (trackCacheMode == "write") 
+   {
+      configuration.trackCacheWriter = 
+         std::make_unique<SimTrackCacheWriter>(configuration.trackCacheFileName,
+                                               simInputFileName, trackCacheInputsHash);
+   }
+
+   // events that do not pass the event level cuts are taken from the sidecar index 
+   // (if it exists) so that they are never read from the simulated tree
+   SimTreeIndex simTreeIndex;
+   configuration.isIndexed = simTreeIndex.Load(simInputFileName);
+   if (configuration.isIndexed)
+   {
+      FlatHist<TH1D> &distrOrigPT = thrContainer.Get().distrOrigPT;
+
+      for (unsigned long i = 0; i < simTreeIndex.GetSize(); i++)
+      {
+         if (fabs(simTreeIndex.bbcz(i)) <= 30. && simTreeIndex.nch(i) > 0)
+         {
+            configuration.selectedEntries.push_back(simTreeIndex.entry(i));
+            continue;
+         }
+
+         const double origPT = simTreeIndex.origPT(i);
+         distrOrigPT.Fill(origPT, weightFunc->Eval(origPT)/eventNormWeight);
+         if (configuration.trackCacheWriter) configuration.trackCacheWriter->Write(origPT, {});
+      }
+      progress.Add(ProgressMonitor::EVENTS, 
+                   simTreeIndex.GetSize() - configuration.selectedEntries.size());
+   }
+
+   configuration.weightFunc = std::move(weightFunc);
+}
+
+void AnalyzeSimSingleTrack::ProcessTask(SimTreeReader &simCNT, ThrContainer &thrContainer, 
+                                        const Configuration &configuration)
+{
+   const int particleId = configuration.particleId;
+   const int particleGeantId = configuration.particleGeantId;
+   const double eventNormWeight = configuration.eventNormWeight;
+   const std::unique_ptr<TF1> &weightFunc = configuration.weightFunc;
+   SimTrackCacheWriter *trackCacheWriter = configuration.trackCacheWriter.get();
+
+   HistContainer &histContainer = thrContainer.Get();
+   std::vector<SimTrack> tracks;
+
+   while (simCNT.Next())
    { 
-      ThrContainerCopy histContainer = thrContainer.GetCopy();
+      const SimEventSnapshot& simEvent = simCNT.Snapshot();
+
+      const double origPT = sqrt(pow(simEvent.mom_orig[0], 2) + pow(simEvent.mom_orig[1], 2));
+
+      tracks.clear();
+
+      const double bbcz = simEvent.bbcz;
+      // only the original pT is needed from the events that do not pass bbcz cut
+      const int nch = (fabs(bbcz) > 30. ? 0 : simEvent.nch);
+
+      progress.Add(ProgressMonitor::EVENTS);
+      progress.Add(ProgressMonitor::TRACKS, nch);
+
+      for (int i = 0; i < nch; i++)
+      {
+         const double the0 = simEvent.the0[i];
+         const double pT = (simEvent.mom[i])*sin(the0);
 
-      SimTreeReader simCNT(reader);
+         if (pT < pTMin || pT > pTMax) continue;
 
-      while (reader.Next())
-      { 
-         numberOfCalls++;
-         const double origPT = sqrt(pow(simCNT.mom_orig(0), 2) + pow(simCNT.mom_orig(1), 2));
+         const int charge = simEvent.charge[i];
+         if (charge != -1 && charge != 1) continue;
 
-         double eventWeight;
+         const double zed = simEvent.zed[i];
+         if (fabs(zed) > 75. || fabs(zed) < 3.) continue;
+
+         if (!(fabs(the0) < 100. &&
+            ((bbcz > 0. && ((bbcz - 250.*tan(the0 - 3.1416/2.)) > 2. ||
+            (bbcz - 200.*tan(the0 - 3.1416/2)) < -2.)) ||
+            (bbcz < 0. && ((bbcz - 250.*tan(the0 - 3.1416/2.))< -2. ||
+            (bbcz - 200.*tan(the0 - 3.1416/2)) > 2.))))) continue;
+
+         tracks.emplace_back();
+         SetSimTrack(tracks.back(), simEvent, i, particleGeantId);
+      }
+
+      if (trackCacheWriter) trackCacheWriter->Write(origPT, tracks);
+
+      ProcessEvent(histContainer, particleId, origPT, weightFunc->Eval(origPT)/eventNormWeight, 
+                   tracks.data(), tracks.size());
+   }
+}
+
+void AnalyzeSimSingleTrack::ReplayConfiguration(ThrContainer &thrContainer, 
+                                                const Configuration &configuration)
+{
+   SimTrackCacheReader trackCache(configuration.trackCacheFileName, 
+                                  configuration.simInputFileName, trackCacheInputsHash);
+   trackCache.Process([&](const SimTrackCacheReader &cache, 
+                          const unsigned long firstEvent, const unsigned long lastEvent)
+   {
+      HistContainer &histContainer = thrContainer.Get();
+
+      for (unsigned long i = firstEvent; i < lastEvent; i++)
+      {
+         progress.Add(ProgressMonitor::EVENTS);
+         progress.Add(ProgressMonitor::TRACKS, cache.GetNumberOfTracks(i));
+         progress.Add(ProgressMonitor::BYTES, cache.GetNumberOfTracks(i)*sizeof(SimTrack));
+
+         const double origPT = cache.GetOrigPT(i);
+         ProcessEvent(histContainer, configuration.particleId, origPT, 
+                      configuration.weightFunc->Eval(origPT)/configuration.eventNormWeight, 
+                      cache.GetTracks(i), cache.GetNumberOfTracks(i));
+      }
+   });
+}
+
+int main(int argc, char **argv)
+{
+   if (argc < 2 || argc > 4) 
+   {
+      std::string errMsg = "Expected 1-3 parameters while " + std::to_string(argc - 1) + " ";
+      errMsg += "parameter(s) were provided \n Usage: bin/AnalyzeSimSingleTrack ";
+      errMsg += "inputYAMLName numberOfThreads=std::thread::hardware_concurrency() ";
+      errMsg += "trackCacheMode=none\n trackCacheMode can be none, write (tracks are also ";
+      errMsg += "written in the track cache), or replay (histograms are filled from the track ";
+      errMsg += "cache without reading simulated trees); with cached_reweight in inputYAML ";
+      errMsg += "the trees are read once and the track cache is replayed in 2 more passes ";
+      errMsg += "that derive alpha and PC1 reweights and fill the final histograms";
+      CppTools::PrintError(errMsg);
+   }
  
-         eventWeight = weightFunc->Eval(origPT)/eventNormWeight;
+   CppTools::CheckInputFile(argv[1]);
  
-         histContainer.distrOrigPT->Fill(origPT, eventWeight);
+   if (argc == 2) numberOfThreads = std::thread::hardware_concurrency();
+   else numberOfThreads = std::stoi(argv[2]);
+
+   if (argc == 4) trackCacheMode = argv[3];
+   if (trackCacheMode != "none" && trackCacheMode != "write" && trackCacheMode != "replay")
+   {
+      CppTools::PrintError("Unknown track cache mode " + trackCacheMode + 
+                           "; expected none, write, or replay");
+   }
+
+   ROOT::EnableImplicitMT(numberOfThreads);
+
+   inputYAMLSim.OpenFile(argv[1], "single_track_sim");
+   inputYAMLSim.CheckStatus("single_track_sim");
+
+   runName = inputYAMLSim["run_name"].as<std::string>();
+
+   inputYAMLMain.OpenFile("input/" + runName + "/main.yaml");
+   inputYAMLMain.CheckStatus("main");
+
+   // parameters of reading simulated trees are optional; ROOT defaults are used otherwise
+   treeCacheSizeFactor = inputYAMLMain["tree_cache_size_factor"].as<double>(1.);
+   treeCacheLearnEntries = inputYAMLMain["tree_cache_learn_entries"].as<int>(100);
+   asyncPrefetching = inputYAMLMain["async_prefetching"].as<bool>(false);
+   prefetchNextFile = inputYAMLMain["prefetch_next_file"].as<bool>(true);
+   outputCompressionLevel = inputYAMLMain["output_compression_level"].as<int>(6);
+
+   SimTreeReader::ConfigureIO(treeCacheSizeFactor, treeCacheLearnEntries, asyncPrefetching);
  
-         const double bbcz = simCNT.bbcz();
-         if (fabs(bbcz) > 30.) continue;
+   collisionSystemName = inputYAMLMain["collision_system_name"].as<std::string>();
+
+   boardOffsetDCe = inputYAMLMain["sim_board_offset_dce"].as<double>();
+   boardOffsetDCw = inputYAMLMain["sim_board_offset_dcw"].as<double>();
 
-         std::vector<ChargedTrack> positiveTracks;
-         std::vector<ChargedTrack> negativeTracks;
+   outputDir = "data/PostSim/" + runName + "/SingleTrack/";
+   std::filesystem::create_directories(outputDir);
 
-         for (int i = 0; i < simCNT.nch(); i++)
-         {
-            const double the0 = simCNT.the0(i);
-            const double pT = (simCNT.mom(i))*sin(the0);
+   pTMin = inputYAMLSim["pt_min"].as<double>();
+   pTMax = inputYAMLSim["pt_max"].as<double>();
+
+   doUserWeightSpectra = inputYAMLSim["reweight_for_spectra"].as<bool>();
+
+   cachedReweight = inputYAMLSim["cached_reweight"].as<bool>(false);
+   // simulated trees are read only in the first pass; the next passes replay the track cache
+   if (cachedReweight && trackCacheMode == "none") trackCacheMode = "write";
+
+   correctionTOFw = inputYAMLSim["correction_tofw"].as<double>();
+   timeShiftTOFe = inputYAMLSim["time_shift_tofe"].as<double>();
+   timeShiftTOFw = inputYAMLSim["time_shift_tofw"].as<double>();
+   timeShiftEMCal = inputYAMLSim["time_shift_emcal"].as<double>();
 
-            if (pT < pTMin || pT > pTMax) continue;
+   detectorsConfiguration = inputYAMLMain["detectors_configuration"].as<std::string>();
 
-            const int charge = simCNT.charge(i);
-            if (charge != -1 && charge != 1) continue;
+   dmCutter.Initialize(runName, detectorsConfiguration);
+   dmCutterMC.Initialize(runName, detectorsConfiguration, "data/Parameters/SimDeadmaps");
 
-            const int dcarm = simCNT.dcarm(i);
+   simSigmRes.Initialize(runName, detectorsConfiguration);
 
-            const double zed = simCNT.zed(i);
-            if (fabs(zed) > 75. || fabs(zed) < 3.) continue;
+   // cached tracks contain dead map flags, DC boards, and sigmalized residuals 
+   // so the cache is outdated if any of their inputs changes
+   trackCacheInputsHash = 
+      GetSimTrackCacheInputsHash({"data/Parameters/Deadmaps/" + runName, 
+                                  "data/Parameters/TimingDeadmaps/" + runName, 
+                                  "data/Parameters/CalibrateSimSigmalizedResiduals/" + runName}, 
+                                 detectorsConfiguration, {boardOffsetDCe, boardOffsetDCw});
 
-            if (!(fabs(the0) < 100. &&
-               ((bbcz > 0. && ((bbcz - 250.*tan(the0 - 3.1416/2.)) > 2. ||
-               (bbcz - 200.*tan(the0 - 3.1416/2)) < -2.)) ||
-               (bbcz < 0. && ((bbcz - 250.*tan(the0 - 3.1416/2.))< -2. ||
-               (bbcz - 200.*tan(the0 - 3.1416/2)) > 2.))))) continue;
+   usePC2 = (detectorsConfiguration[2] == '1');
+   usePC3 = (detectorsConfiguration[3] == '1');
+   useTOFe = (detectorsConfiguration[4] == '1');
+   useTOFw = (detectorsConfiguration[5] == '1');
+   useEMCal = (detectorsConfiguration[6] == '1');
+   simM2Id.Initialize(runName, false);
+
+   if (doUserWeightSpectra)
+   {
+      for (const auto& particle : inputYAMLSim["particles"])
+      {
+         CppTools::CheckInputFile("data/Parameters/SpectraFit/" + collisionSystemName + 
+                                  "/" + particle["name"].as<std::string>() + ".yaml");
+      }
+   }
  
-            const double alpha = simCNT.alpha(i);
-            const double phi = simCNT.phi(i);
+   for (const auto& magneticField : inputYAMLMain["magnetic_field_configurations"])
+   {
+      CppTools::CheckInputFile("data/Real/" + runName + "/SingleTrack/sum" + 
+                               magneticField["name"].as<std::string>() + ".root");
+   }
+
+   // number of events for each particle and magnetic field (i.e. for each ThrContainer)
+   std::vector<unsigned long> stagesNumberOfEvents;
+
+   // simulated trees are listed in the same order they are processed
+   for (const auto& particle : inputYAMLSim["particles"])
+   {
+      for (const auto& magneticField : inputYAMLMain["magnetic_field_configurations"])
+      {
+         stagesNumberOfEvents.push_back(0);
+         for (const auto& pTRange : inputYAMLSim["pt_ranges"])
+         {
+            const std::string simInputFileName = 
+               "data/SimTrees/" + runName + "/SingleTrack/" + 
+               particle["name"].as<std::string>() + "_" + pTRange["name"].as<std::string>() + 
+               magneticField["name"].as<std::string>() + ".root";
+
+            CppTools::CheckInputFile(simInputFileName);
+            simInputFileNames.push_back(simInputFileName);
 
-            const double board = 
-               (dcarm == 0 ?
-                ((3.72402 - phi + 0.008047*cos(phi + 0.87851))/0.01963496 + boardOffsetDCe) :
-                ((0.573231 + phi - 0.0046 * cos(phi + 0.05721))/0.01963496 + boardOffsetDCw));
+            const unsigned long currentConfigurationNumberOfEvents = 
+               SimTreeIndex::GetNumberOfEntries(simInputFileName);
+            if (currentConfigurationNumberOfEvents <= 0)
+            {
+               CppTools::PrintError("Number of events is equal or less than 0 in file " + 
+                                    simInputFileName);
+            }
+            numberOfEvents += currentConfigurationNumberOfEvents;
+            stagesNumberOfEvents.back() += currentConfigurationNumberOfEvents;
 
-            // reweight for heatmaps
-            double alphaReweight = 1.;
+            const std::string trackCacheFileName = 
+               "data/TrackCache/" + runName + "/SingleTrack/" + 
+               particle["name"].as<std::string>() + "_" + pTRange["name"].as<std::string>() + 
+               magneticField["name"].as<std::string>() + ".cache";
 
-            if (dcarm == 0) // DCe
+            if (trackCacheMode == "replay" && 
+                !SimTrackCacheReader::IsValid(trackCacheFileName, simInputFileName, 
+                                              trackCacheInputsHash))
             {
-               if (zed >= 0) 
-               {
-                  if (doReweightAlpha) alphaReweight = 
-                     alphaReweightDCe0->GetBinContent(alphaReweightDCe0->FindBin(alpha));
-                  histContainer.heatmapDCe0X1->Fill(board, alpha, eventWeight*alphaReweight*
-                                                    static_cast<double>(simCNT.nx1hits(i)));
-                  histContainer.heatmapDCe0X2->Fill(board, alpha, eventWeight*alphaReweight*
-                                                    static_cast<double>(simCNT.nx2hits(i)));
-               }
-               else 
-               {
-                  if (doReweightAlpha) alphaReweight = 
-                     alphaReweightDCe1->GetBinContent(alphaReweightDCe1->FindBin(alpha));
-                  histContainer.heatmapDCe1X1->Fill(board, alpha, eventWeight*alphaReweight*
-                                                    static_cast<double>(simCNT.nx1hits(i)));
-                  histContainer.heatmapDCe1X2->Fill(board, alpha, eventWeight*alphaReweight*
-                                                    static_cast<double>(simCNT.nx2hits(i)));
-               }
-            } // DCw
-            else
+               CppTools::PrintError("Track cache " + trackCacheFileName + " does not exist or "\
+                                    "is outdated; run with trackCacheMode=write first");
+            }
+         }
+      }
+   }
+
+   // real data file in which real data DC heatmaps are stored
+   const std::string realDataInputFileName = "data/Real/" + runName + "/SingleTrack/sum.root";
+   // file in which simulated unscaled DC heatmaps are stored
+   const std::string postSimInputFileName = "data/PostSim/" + runName + "/SingleTrack/all.root";
+
+   CppTools::CheckInputFile(realDataInputFileName);
+
+   if (cachedReweight)
+   {
+      // reweights are derived from the outputs of the previous passes of the current run
+      doReweightAlpha = false;
+      doReweightPC1 = false;
+   }
+   else
+   {
+      SetPC1Reweight(realDataInputFileName, postSimInputFileName);
+      SetAlphaReweight(realDataInputFileName, postSimInputFileName);
+   }
+
+   CppTools::PrintInfo("Clearing output directory: " + outputDir);
+   void(system(("find " + outputDir + " ! -name 'all.root' ! -name 'alpha_reweight.root' "\
+                "!  -name 'pc1_reweight.root' -type f -exec rm -f {} +").c_str()));
+
+   std::vector<std::string> particleList;
+   for (const auto& particle : inputYAMLSim["particles"])
+   {
+      particleList.emplace_back(particle["name"].as<std::string>());
+   }
+
+   std::vector<std::string> magneticFieldsList;
+   for (const auto& magneticField : inputYAMLMain["magnetic_field_configurations"])
+   {
+      magneticFieldsList.emplace_back(magneticField["name"].as<std::string>());
+   }
+
+   std::vector<std::string> pTRangesList;
+   for (const auto& pTRange : inputYAMLSim["pt_ranges"])
+   {
+      pTRangesList.emplace_back(pTRange["name"].as<std::string>());
+   }
+
+   CppTools::Box box{"AnalyzeSimSingleTrack"};
+ 
+   box.AddEntry("Run name", runName);
+   box.AddEntry("Particles", particleList);
+   if (magneticFieldsList.size() == 1 && magneticFieldsList[0] == "")
+   {
+      box.AddEntry("Magnetic field", "run default");
+   }
+   else box.AddEntry("Magnetic fields", magneticFieldsList);
+   box.AddEntry("pT ranges", pTRangesList);
+   box.AddEntry("Charged track minimum pT, GeV", pTMin);
+   box.AddEntry("Charged track maximum pT, GeV", pTMax);
+   box.AddEntry("Weight pT spectra", 
+                std::string(doUserWeightSpectra ? "user defined" : "default (exp)"));
+   box.AddEntry("Reweight DC alpha", doReweightAlpha);
+   box.AddEntry("Reweight PC1", doReweightPC1);
+   box.AddEntry("Cached reweight", cachedReweight);
+   box.AddEntry("Detectors configuration", detectorsConfiguration);
+   box.AddEntry("Number of threads", numberOfThreads);
+   box.AddEntry("Tree cache size, clusters", treeCacheSizeFactor, 2);
+   box.AddEntry("Tree cache learn entries", treeCacheLearnEntries);
+   box.AddEntry("Async prefetching", asyncPrefetching);
+   box.AddEntry("Prefetch next file", prefetchNextFile);
+   box.AddEntry("Track cache mode", trackCacheMode);
+   box.AddEntry("Output compression level", outputCompressionLevel);
+   box.AddEntry("Number of events to be analyzed, 1e6", 
+                static_cast<double>(numberOfEvents)/1e6, 3);
+   box.Print();
+
+   // passes of the cached reweight mode: the trees are read and DC heatmaps are filled
+   // for alpha reweight, then PC1 heatmaps are filled for PC1 reweight from the replayed 
+   // track cache, then all histograms are filled from it with both reweights applied
+   const std::vector<std::string> passNames = 
+      (cachedReweight ? std::vector<std::string>{"alpha reweight", "PC1 reweight", "final"} :
+                            std::vector<std::string>{""});
+
+   for (unsigned long pass = 0; pass < passNames.size(); pass++)
+   {
+      std::string stageNamePrefix = "";
+      if (cachedReweight)
+      {
+         stageNamePrefix = "pass " + std::to_string(pass + 1) + ", ";
+         CppTools::PrintInfo("Pass " + std::to_string(pass + 1) + "/" + 
+                             std::to_string(passNames.size()) + ": " + passNames[pass]);
+      }
+
+      const unsigned long passStartNumberOfEvents = progress.Get(ProgressMonitor::EVENTS);
+      std::atomic<bool> isProcessFinished = false;
+
+      auto pBarCall = [&]()
+      {
+         ProgressBar pBar{"FANCY"};
+         for (unsigned long i = 1; !isProcessFinished; i++)
+         {
+            pBar.Print(static_cast<double>(progress.Get(ProgressMonitor::EVENTS) - 
+                                           passStartNumberOfEvents)/
+                       static_cast<double>(numberOfEvents));
+            // rates and the remaining time are reported every 10 seconds
+            if (i % 100 == 0)
             {
-               if (zed >= 0) 
-               {
-                  if (doReweightAlpha) alphaReweight = 
-                     alphaReweightDCw0->GetBinContent(alphaReweightDCw0->FindBin(alpha));
-                  histContainer.heatmapDCw0X1->Fill(board, alpha, static_cast<double>
-                                                    (simCNT.nx1hits(i))*eventWeight*alphaReweight);
-                  histContainer.heatmapDCw0X2->Fill(board, alpha, eventWeight*alphaReweight*
-                                                    static_cast<double>(simCNT.nx2hits(i)));
-               }
-               else 
-               {
-                  if (doReweightAlpha) alphaReweight = 
-                     alphaReweightDCw1->GetBinContent(alphaReweightDCw1->FindBin(alpha));
-                  histContainer.heatmapDCw1X1->Fill(board, alpha, eventWeight*alphaReweight*
-                                                    static_cast<double>(simCNT.nx1hits(i)));
-                  histContainer.heatmapDCw1X2->Fill(board, alpha, eventWeight*alphaReweight*
-                                                    static_cast<double>(simCNT.nx2hits(i)));
-               }
+               pBar.Clear();
+               CppTools::PrintInfo(progress.GetStatus());
+               pBar.RePrint();
             }
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+         }
+         pBar.Finish();
+         CppTools::PrintInfo("AnalyzerSingleTrack has finished processing simulated data");
+      };
+    
+      std::thread pBarThread(pBarCall);
+
+      // sum of the histograms of all particles and magnetic fields
+      MergedHists allHists;
+
+      unsigned long stageIndex = 0;
+      for (const auto& particle : inputYAMLSim["particles"])
+      {
+         for (const auto& magneticField : inputYAMLMain["magnetic_field_configurations"])
+         {
+            progress.StartStage(stageNamePrefix + particle["name"].as<std::string>() + 
+                                magneticField["name"].as<std::string>(), 
+                                stagesNumberOfEvents[stageIndex]);
+            stageIndex++;
 
-            if (IsQualityCut(simCNT.qual(i))) continue;
+            ThrContainer thrContainer{detectorsConfiguration};
+            std::vector<Configuration> configurations;
 
-            if (dcarm == 0) // DCe
+            for (const auto& pTRange : inputYAMLSim["pt_ranges"])
             {
-               if (zed >= 0) 
-               {
-                  histContainer.heatmapUnscaledDCe0->Fill(board, alpha, eventWeight);
-                  histContainer.heatmapDCe0->Fill(board, alpha, eventWeight*alphaReweight);
-               }
-               else 
+               configurations.emplace_back();
+               SetConfiguration(configurations.back(), thrContainer, particle["id"].as<int>(), 
+                                magneticField["name"].as<std::string>(), 
+                                pTRange["name"].as<std::string>());
+            }
+
+            if (trackCacheMode == "replay")
+            {
+               for (const Configuration& configuration : configurations)
                {
-                  histContainer.heatmapUnscaledDCe1->Fill(board, alpha, eventWeight);
-                  histContainer.heatmapDCe1->Fill(board, alpha, eventWeight*alphaReweight);
+                  ReplayConfiguration(thrContainer, configuration);
                }
-            } // DCw
+            }
             else
             {
-               if (zed >= 0) 
+               std::vector<std::string> fileNames;
+               std::vector<const std::vector<unsigned long> *> selectedEntries;
+               for (const Configuration& configuration : configurations)
                {
-                  histContainer.heatmapUnscaledDCw0->Fill(board, alpha, eventWeight);
-                  histContainer.heatmapDCw0->Fill(board, alpha, static_cast<double>
-                                                  (simCNT.nx1hits(i))*eventWeight*alphaReweight);
+                  fileNames.push_back(configuration.simInputFileName);
+                  selectedEntries.push_back(configuration.isIndexed ? 
+                                            &configuration.selectedEntries : nullptr);
                }
-               else 
+
+               // files of all pT ranges are processed as one set of tasks so that the threads 
+               // do not idle at the end of each file; files of different ThrContainer are not 
+               // processed together since each of them holds per-thread copies of all histograms
+               SimTreeReader::Process(fileNames, simTreeBranches, 
+                                      [&](SimTreeReader &simCNT, const unsigned long fileIndex)
                {
-                  histContainer.heatmapUnscaledDCw1->Fill(board, alpha, eventWeight);
-                  histContainer.heatmapDCw1->Fill(board, alpha, eventWeight*alphaReweight);
-               }
+                  ProcessTask(simCNT, thrContainer, configurations[fileIndex]);
+               }, "Tree", selectedEntries, prefetchNextFile);
             }
+            // track cache writers finalize the files when configurations are destroyed
+            configurations.clear();
 
-            const bool isParticleOrig = (simCNT.particle_id(i) == particleGeantId && 
-                                         simCNT.primary_id(i) == -999);
+            // writing the result
+            std::string outputFileName = "data/PostSim/" + runName + "/SingleTrack/" + 
+                                         particle["name"].as<std::string>();
+            if (magneticField["name"].as<std::string>() != "") 
+            {
+               outputFileName += "magf" + magneticField["name"].as<std::string>();
+            }
+            outputFileName += ".root";
 
-            if (dmCutter.IsDeadDC(dcarm, zed, board, alpha)) continue;
+            const MergedHists hists = thrContainer.Merge(numberOfThreads);
+            hists.Write(outputFileName, outputCompressionLevel);
+            allHists.Add(hists, numberOfThreads);
+         }
+      }
 
-            if (!doReweightAlpha) continue;
+      isProcessFinished = true;
+      pBarThread.join();
 
-            double ppc1phi = atan2(simCNT.ppc1y(i), simCNT.ppc1x(i));
+      if (trackCacheMode != "replay") 
+      {
+         SimTreeReader::PrintIOReport(simInputFileNames, simTreeBranches);
+      }
 
-            // reweight for heatmaps
-            double reweightPC1 = 1.;
+      allHists.Write(outputDir + "all.root", outputCompressionLevel);
+      CppTools::PrintInfo("File " + outputDir + "all.root was written");
 
-            if (dcarm == 1) // PC1w
-            {
-               if (charge == 1)
-               {
-                  histContainer.heatmapPC1wPos->Fill(simCNT.ppc1z(i), ppc1phi, 
-                                                     eventWeight*alphaReweight);
+      if (pass + 1 == passNames.size()) break;
 
-                  if (doReweightPC1) reweightPC1 = reweightPC1wPos->
-                     GetBinContent(reweightPC1wPos->GetXaxis()->FindBin(simCNT.ppc1z(i)),
-                                   reweightPC1wPos->GetYaxis()->FindBin(ppc1phi));
+      // next passes fill the histograms from the track cache written in the first pass
+      trackCacheMode = "replay";
 
-                  if (simCNT.ppc1z(i) < 0.)
-                  {
-                     histContainer.heatmapPC1w->Fill(simCNT.ppc1z(i), ppc1phi, 
-                                                     eventWeight*alphaReweight*
-                                                     reweightPC1Simple[4]);
-                  }
-                  else
-                  {
-                     histContainer.heatmapPC1w->Fill(simCNT.ppc1z(i), ppc1phi, 
-                                                     eventWeight*alphaReweight*
-                                                     reweightPC1Simple[5]);
-                  }
-               }
-               else
-               {
-                  histContainer.heatmapPC1wNeg->Fill(simCNT.ppc1z(i), ppc1phi, 
-                                                     eventWeight*alphaReweight);
+      if (pass == 0)
+      {
+         doReweightAlpha = true;
+         SetAlphaReweight(realDataInputFileName, postSimInputFileName);
+         // without alpha reweight the next passes would produce the same output
+         if (!doReweightAlpha) break;
+         isPC1ReweightPass = true;
+      }
+      else
+      {
+         isPC1ReweightPass = false;
+         doReweightPC1 = true;
+         SetPC1Reweight(realDataInputFileName, postSimInputFileName);
+      }
+   }
 
-                  if (doReweightPC1) reweightPC1 = reweightPC1wNeg->
-                     GetBinContent(reweightPC1wNeg->GetXaxis()->FindBin(simCNT.ppc1z(i)),
-                                   reweightPC1wNeg->GetYaxis()->FindBin(ppc1phi));
+   return 0;
+}
 
-                  if (simCNT.ppc1z(i) < 0.)
-                  {
-                     histContainer.heatmapPC1w->Fill(simCNT.ppc1z(i), ppc1phi, 
-                                                     eventWeight*alphaReweight*
-                                                     reweightPC1Simple[6]);
-                  }
-                  else
-                  {
-                     histContainer.heatmapPC1w->Fill(simCNT.ppc1z(i), ppc1phi, 
-                                                     eventWeight*alphaReweight*
-                                                     reweightPC1Simple[7]);
-                  }
-               }
-            }
-            else // PC1e
-            {
-               if (ppc1phi < 0) ppc1phi += 2.*M_PI;
+void AnalyzeSimSingleTrack::SetSimTrack(SimTrack& track, const SimEventSnapshot& simEvent, 
+                                        const int i, const int particleGeantId)
+{
+   track.index = i;
+   track.charge = simEvent.charge[i];
+   track.dcarm = simEvent.dcarm[i];
+   track.qual = simEvent.qual[i];
+   track.nx1hits = simEvent.nx1hits[i];
+   track.nx2hits = simEvent.nx2hits[i];
+   track.sect = simEvent.sect[i];
+   track.ysect = simEvent.ysect[i];
+   track.zsect = simEvent.zsect[i];
+   track.slat = simEvent.slat[i];
+   track.striptofw = simEvent.striptofw[i];
+   track.isParticleOrig = (simEvent.particle_id[i] == particleGeantId && 
+                           simEvent.primary_id[i] == -999);
+   track.phi = simEvent.phi[i];
+   track.alpha = simEvent.alpha[i];
+   track.zed = simEvent.zed[i];
+   track.mom = simEvent.mom[i];
+   track.the0 = simEvent.the0[i];
+   track.phi0 = simEvent.phi0[i];
+   track.ppc1z = simEvent.ppc1z[i];
+   track.ppc2z = simEvent.ppc2z[i];
+   track.ppc3z = simEvent.ppc3z[i];
+   track.pc2dphi = simEvent.pc2dphi[i];
+   track.pc2dz = simEvent.pc2dz[i];
+   track.pc3dphi = simEvent.pc3dphi[i];
+   track.pc3dz = simEvent.pc3dz[i];
+   track.emcdphi = simEvent.emcdphi[i];
+   track.emcdz = simEvent.emcdz[i];
+   track.ecore = simEvent.ecore[i];
+   track.prob = simEvent.prob[i];
+   track.temc = simEvent.temc[i];
+   track.plemc = simEvent.plemc[i];
+   track.tofdphi = simEvent.tofdphi[i];
+   track.tofdz = simEvent.tofdz[i];
+   track.ttof = simEvent.ttof[i];
+   track.pltof = simEvent.pltof[i];
+   track.etof = simEvent.etof[i];
+   track.tofwdphi = simEvent.tofwdphi[i];
+   track.tofwdz = simEvent.tofwdz[i];
+   track.ttofw = simEvent.ttofw[i];
+   track.pltofw = simEvent.pltofw[i];
+
+   const double pT = (simEvent.mom[i])*sin(simEvent.the0[i]);
+   const int charge = track.charge;
+   const int dcarm = track.dcarm;
+   const double phi = simEvent.phi[i];
+
+   track.pT = pT;
+   track.board = 
+      (dcarm == 0 ?
+       ((3.72402 - phi + 0.008047*cos(phi + 0.87851))/0.01963496 + boardOffsetDCe) :
+       ((0.573231 + phi - 0.0046 * cos(phi + 0.05721))/0.01963496 + boardOffsetDCw));
+   track.isDeadDC = dmCutter.IsDeadDC(dcarm, track.zed, track.board, track.alpha);
+
+   track.ppc1phi = atan2(simEvent.ppc1y[i], simEvent.ppc1x[i]);
+   if (dcarm != 1 && track.ppc1phi < 0) track.ppc1phi += 2.*M_PI; // PC1e
+   track.isDeadPC1 = dmCutter.IsDeadPC1(dcarm, track.ppc1z, track.ppc1phi);
+
+   track.pc2phi = atan2(simEvent.ppc2y[i], simEvent.ppc2x[i]);
+   track.pc3phi = atan2(simEvent.ppc3y[i], simEvent.ppc3x[i]);
+   if (dcarm == 0 && track.pc3phi < 0) track.pc3phi += 2.*M_PI; // PC3e
+
+   if (IsHit(track.pc2dphi))
+   {
+      track.pc2sdphi = simSigmRes.PC2SDPhi(track.pc2dphi, pT, charge);
+      track.pc2sdz = simSigmRes.PC2SDZ(track.pc2dz, pT, charge);
+      track.isDeadPC2 = dmCutter.IsDeadPC2(track.ppc2z, track.pc2phi);
+   }
 
-               if (charge == 1)
-               {
-                  histContainer.heatmapPC1ePos->Fill(simCNT.ppc1z(i), ppc1phi, 
-                                                     eventWeight*alphaReweight);
+   if (IsHit(track.pc3dphi))
+   {
+      track.pc3sdphi = simSigmRes.PC3SDPhi(track.pc3dphi, pT, charge, dcarm);
+      track.pc3sdz = simSigmRes.PC3SDZ(track.pc3dz, pT, charge, dcarm);
+      track.isDeadPC3 = dmCutter.IsDeadPC3(dcarm, track.ppc3z, track.pc3phi);
+   }
 
-                  if (doReweightPC1) reweightPC1 = reweightPC1ePos->
-                     GetBinContent(reweightPC1ePos->GetXaxis()->FindBin(simCNT.ppc1z(i)),
-                                   reweightPC1ePos->GetYaxis()->FindBin(ppc1phi));
+   if (IsHit(track.emcdz))
+   {
+      track.emcsdphi = simSigmRes.EMCalSDPhi(track.emcdphi, pT, charge, dcarm, track.sect);
+      track.emcsdz = simSigmRes.EMCalSDZ(track.emcdz, pT, charge, dcarm, track.sect);
+      track.isDeadEMCal = dmCutter.IsDeadEMCal(dcarm, track.sect, track.ysect, track.zsect);
+   }
 
-                  if (simCNT.ppc1z(i) < 0.)
-                  {
-                     histContainer.heatmapPC1e->Fill(simCNT.ppc1z(i), ppc1phi, 
-                                                     eventWeight*alphaReweight*
-                                                     reweightPC1Simple[0]);
-                  }
-                  else
-                  {
-                     histContainer.heatmapPC1e->Fill(simCNT.ppc1z(i), ppc1phi, 
-                                                     eventWeight*alphaReweight*
-                                                     reweightPC1Simple[1]);
-                  }
-               }
-               else
-               {
-                  histContainer.heatmapPC1eNeg->Fill(simCNT.ppc1z(i), ppc1phi, 
-                                                     eventWeight*alphaReweight);
-                  if (doReweightPC1) reweightPC1 = reweightPC1eNeg->
-                     GetBinContent(reweightPC1eNeg->GetXaxis()->FindBin(simCNT.ppc1z(i)),
-                                   reweightPC1eNeg->GetYaxis()->FindBin(ppc1phi));
+   if (IsHit(track.tofdz))
+   {
+      track.tofesdphi = simSigmRes.TOFeSDPhi(track.tofdphi, pT, charge);
+      track.tofesdz = simSigmRes.TOFeSDZ(track.tofdz, pT, charge);
+      // slats are organized in 10 lines of 96 we define as chambers
+      track.isDeadTOFe = dmCutter.IsDeadTOFe(track.slat/96, track.slat % 96);
+   }
 
-                  if (simCNT.ppc1z(i) < 0.)
-                  {
-                     histContainer.heatmapPC1e->Fill(simCNT.ppc1z(i), ppc1phi, 
-                                                     eventWeight*alphaReweight*
-                                                     reweightPC1Simple[2]);
-                     //reweightPC1 *= reweightPC1Simple[2];
-                  }
-                  else
-                  {
-                     histContainer.heatmapPC1e->Fill(simCNT.ppc1z(i), ppc1phi, 
-                                                     eventWeight*alphaReweight*
-                                                     reweightPC1Simple[3]);
-                     //reweightPC1 *= reweightPC1Simple[3];
-                  }
-               }
-            }
-            if (dmCutter.IsDeadPC1(dcarm, simCNT.ppc1z(i), ppc1phi)) continue;
+   if (IsHit(track.tofwdz))
+   {
+      track.tofwsdphi = simSigmRes.TOFwSDPhi(track.tofwdphi, pT, charge);
+      track.tofwsdz = simSigmRes.TOFwSDZ(track.tofwdz, pT, charge);
+      // strips are organized in 8 lines of 64 we define as chambers
+      track.isDeadTOFw = dmCutter.IsDeadTOFw(track.striptofw/64, track.striptofw % 64);
+   }
+}
 
-            histContainer.distrOrigPTVsRecPT->Fill(origPT, pT, eventWeight);
+void AnalyzeSimSingleTrack::ProcessEvent(HistContainer& histContainer, const int particleId, 
+                                         const double origPT, const double eventWeight, 
+                                         const SimTrack *tracks, 
+                                         const unsigned long numberOfTracks)
+{
+   histContainer.distrOrigPT.Fill(origPT, eventWeight);
 
-            histContainer.distrRecPT->Fill(pT, eventWeight);
-            //histContainer.distrRecPTNoScaleReweight->Fill(pT, eventWeight/scaleReweight);
+   // tracks of each thread are reused between the events so that they are not reallocated
+   thread_local std::vector<ChargedTrack> positiveTracks;
+   thread_local std::vector<ChargedTrack> negativeTracks;
+   positiveTracks.clear();
+   negativeTracks.clear();
 
-            int idPC2 = PART_ID::JUNK;
-            int idPC3 = PART_ID::JUNK;
-            int idEMCal = PART_ID::JUNK;
-            int idTOFe = PART_ID::JUNK;
-            int idTOFw = PART_ID::JUNK;
+   for (unsigned long i = 0; i < numberOfTracks; i++)
+   {
+      ProcessTrack(histContainer, tracks[i], particleId, origPT, eventWeight, 
+                   positiveTracks, negativeTracks);
+   }
 
-            if (IsHit(simCNT.pc2dphi(i)))
-            {
-               const double sdphi = simSigmRes.PC2SDPhi(simCNT.pc2dphi(i), pT, charge);
-               const double sdz = simSigmRes.PC2SDZ(simCNT.pc2dz(i), pT, charge);
+   // looping over pairs of tracks
+   for (auto& posTrack : positiveTracks)
+   {
+      for (auto& negTrack : negativeTracks)
+      {
+         // invariant mass [GeV/c^2] of pi+ k- pair
+         const double mInvPiK = GetPairMass(posTrack, negTrack);
 
-               if (charge == 1) 
-               {
-                  histContainer.distrDPhiVsPTPC2Pos->Fill(simCNT.pc2dphi(i), pT, eventWeight);
-                  histContainer.distrDZVsPTPC2Pos->Fill(simCNT.pc2dz(i), pT, eventWeight);
+         posTrack.m = MASS_KAON;
+         negTrack.m = MASS_KAON;
 
-                  histContainer.distrSDPhiVsPTPC2Pos->Fill(sdphi, pT, eventWeight);
-                  histContainer.distrSDZVsPTPC2Pos->Fill(sdz, pT, eventWeight);
-               }
-               else
-               {
-                  histContainer.distrDPhiVsPTPC2Neg->Fill(simCNT.pc2dphi(i), pT, eventWeight);
-                  histContainer.distrDZVsPTPC2Neg->Fill(simCNT.pc2dz(i), pT, eventWeight);
+         // invariant mass [GeV/c^2] of k+ pi- pair
+         const double mInvKPi = GetPairMass(posTrack, negTrack);
 
-                  histContainer.distrSDPhiVsPTPC2Neg->Fill(sdphi, pT, eventWeight);
-                  histContainer.distrSDZVsPTPC2Neg->Fill(sdz, pT, eventWeight);
-               }
+         // pT of a pair [GeV/c]
+         const double pT = GetPairPT(posTrack, negTrack);
 
-               if (IsMatch(sdphi, sdz))
-               {
-                  const double pc2phi = atan2(simCNT.ppc2y(i), simCNT.ppc2x(i));
+         if (IsGhostCut(posTrack, negTrack)) continue;
+         if (IsOneArmCut(posTrack, negTrack)) continue;
 
-                  histContainer.heatmapPC2->Fill(simCNT.ppc2z(i), pc2phi, 
-                                                 eventWeight*alphaReweight*reweightPC1);
+         histContainer.distrMInvNoPIDNoGhost.Fill(pT, mInvPiK, eventWeight);
+         histContainer.distrMInvNoPIDNoGhost.Fill(pT, mInvKPi, eventWeight);
 
-                  if (!dmCutter.IsDeadPC2(simCNT.ppc2z(i), pc2phi))
-                  {
-                     idPC2 = PART_ID::NONE;
-                     if (isParticleOrig) histContainer.distrRecPTPC2->Fill(pT, eventWeight);
-                  }
-               }
-            }
+         if (!IsNoPID(posTrack, negTrack)) continue;
 
-            if (IsHit(simCNT.pc3dphi(i)))
-            {
-               const double sdphi = simSigmRes.PC3SDPhi(simCNT.pc3dphi(i), pT, charge, dcarm);
-               const double sdz = simSigmRes.PC3SDZ(simCNT.pc3dz(i), pT, charge, dcarm);
+         histContainer.distrMInvNoPID.Fill(pT, mInvPiK, eventWeight);
+         histContainer.distrMInvNoPID.Fill(pT, mInvKPi, eventWeight);
+      }
+   }
+}
 
-               if (dcarm == 0) // PC3e
-               {
-                  if (charge == 1) 
-                  {
-                     histContainer.distrDPhiVsPTPC3ePos->Fill(simCNT.pc3dphi(i), pT, eventWeight);
-                     histContainer.distrDZVsPTPC3ePos->Fill(simCNT.pc3dz(i), pT, eventWeight);
+void AnalyzeSimSingleTrack::ProcessTrack(HistContainer& histContainer, const SimTrack& track, 
+                                         const int particleId, const double origPT, 
+                                         const double eventWeight, 
+                                         std::vector<ChargedTrack>& positiveTracks, 
+                                         std::vector<ChargedTrack>& negativeTracks)
+{
+   const double pT = track.pT;
+   const int charge = track.charge;
+   const int dcarm = track.dcarm;
+   const double zed = track.zed;
+   const double alpha = track.alpha;
+   const double board = track.board;
 
-                     histContainer.distrSDPhiVsPTPC3ePos->Fill(sdphi, pT, eventWeight);
-                     histContainer.distrSDZVsPTPC3ePos->Fill(sdz, pT, eventWeight);
-                  }
-                  else
-                  {
-                     histContainer.distrDPhiVsPTPC3eNeg->Fill(simCNT.pc3dphi(i), pT, eventWeight);
-                     histContainer.distrDZVsPTPC3eNeg->Fill(simCNT.pc3dz(i), pT, eventWeight);
+   // reweight for heatmaps
+   double alphaReweight = 1.;
 
-                     histContainer.distrSDPhiVsPTPC3eNeg->Fill(sdphi, pT, eventWeight);
-                     histContainer.distrSDZVsPTPC3eNeg->Fill(sdz, pT, eventWeight);
-                  }
-               }
-               else // PC3w
-               {
-                  if (charge == 1) 
-                  {
-                     histContainer.distrDPhiVsPTPC3wPos->Fill(simCNT.pc3dphi(i), pT, eventWeight);
-                     histContainer.distrDZVsPTPC3wPos->Fill(simCNT.pc3dz(i), pT, eventWeight);
+   if (dcarm == 0) // DCe
+   {
+      if (zed >= 0) 
+      {
+         if (doReweightAlpha) alphaReweight = alphaReweightDCe0Table.Get(alpha);
+         histContainer.heatmapDCe0X1.Fill(board, alpha, eventWeight*alphaReweight*
+                                           static_cast<double>(track.nx1hits));
+         histContainer.heatmapDCe0X2.Fill(board, alpha, eventWeight*alphaReweight*
+                                           static_cast<double>(track.nx2hits));
+      }
+      else 
+      {
+         if (doReweightAlpha) alphaReweight = alphaReweightDCe1Table.Get(alpha);
+         histContainer.heatmapDCe1X1.Fill(board, alpha, eventWeight*alphaReweight*
+                                           static_cast<double>(track.nx1hits));
+         histContainer.heatmapDCe1X2.Fill(board, alpha, eventWeight*alphaReweight*
+                                           static_cast<double>(track.nx2hits));
+      }
+   } // DCw
+   else
+   {
+      if (zed >= 0) 
+      {
+         if (doReweightAlpha) alphaReweight = alphaReweightDCw0Table.Get(alpha);
+         histContainer.heatmapDCw0X1.Fill(board, alpha, static_cast<double>
+                                           (track.nx1hits)*eventWeight*alphaReweight);
+         histContainer.heatmapDCw0X2.Fill(board, alpha, eventWeight*alphaReweight*
+                                           static_cast<double>(track.nx2hits));
+      }
+      else 
+      {
+         if (doReweightAlpha) alphaReweight = alphaReweightDCw1Table.Get(alpha);
+         histContainer.heatmapDCw1X1.Fill(board, alpha, eventWeight*alphaReweight*
+                                           static_cast<double>(track.nx1hits));
+         histContainer.heatmapDCw1X2.Fill(board, alpha, eventWeight*alphaReweight*
+                                           static_cast<double>(track.nx2hits));
+      }
+   }
 
-                     histContainer.distrSDPhiVsPTPC3wPos->Fill(sdphi, pT, eventWeight);
-                     histContainer.distrSDZVsPTPC3wPos->Fill(sdz, pT, eventWeight);
-                  }
-                  else
-                  {
-                     histContainer.distrDPhiVsPTPC3wNeg->Fill(simCNT.pc3dphi(i), pT, eventWeight);
-                     histContainer.distrDZVsPTPC3wNeg->Fill(simCNT.pc3dz(i), pT, eventWeight);
+   if (IsQualityCut(track.qual)) return;
+
+   if (dcarm == 0) // DCe
+   {
+      if (zed >= 0) 
+      {
+         histContainer.heatmapUnscaledDCe0.Fill(board, alpha, eventWeight);
+         histContainer.heatmapDCe0.Fill(board, alpha, eventWeight*alphaReweight);
+      }
+      else 
+      {
+         histContainer.heatmapUnscaledDCe1.Fill(board, alpha, eventWeight);
+         histContainer.heatmapDCe1.Fill(board, alpha, eventWeight*alphaReweight);
+      }
+   } // DCw
+   else
+   {
+      if (zed >= 0) 
+      {
+         histContainer.heatmapUnscaledDCw0.Fill(board, alpha, eventWeight);
+         histContainer.heatmapDCw0.Fill(board, alpha, static_cast<double>
+                                         (track.nx1hits)*eventWeight*alphaReweight);
+      }
+      else 
+      {
+         histContainer.heatmapUnscaledDCw1.Fill(board, alpha, eventWeight);
+         histContainer.heatmapDCw1.Fill(board, alpha, eventWeight*alphaReweight);
+      }
+   }
+
+   if (track.isDeadDC) return;
+
+   if (!doReweightAlpha) return;
+
+   const double ppc1phi = track.ppc1phi;
+
+   // reweight for heatmaps
+   double reweightPC1 = 1.;
+
+   if (dcarm == 1) // PC1w
+   {
+      if (charge == 1)
+      {
+         histContainer.heatmapPC1wPos.Fill(track.ppc1z, ppc1phi, 
+                                            eventWeight*alphaReweight);
+
+         if (doReweightPC1) reweightPC1 = reweightPC1wPosTable.Get(track.ppc1z, ppc1phi);
+
+         if (track.ppc1z < 0.)
+         {
+            histContainer.heatmapPC1w.Fill(track.ppc1z, ppc1phi, 
+                                            eventWeight*alphaReweight*
+                                            reweightPC1Simple[4]);
+         }
+         else
+         {
+            histContainer.heatmapPC1w.Fill(track.ppc1z, ppc1phi, 
+                                            eventWeight*alphaReweight*
+                                            reweightPC1Simple[5]);
+         }
+      }
+      else
+      {
+         histContainer.heatmapPC1wNeg.Fill(track.ppc1z, ppc1phi, 
+                                            eventWeight*alphaReweight);
+
+         if (doReweightPC1) reweightPC1 = reweightPC1wNegTable.Get(track.ppc1z, ppc1phi);
+
+         if (track.ppc1z < 0.)
+         {
+            histContainer.heatmapPC1w.Fill(track.ppc1z, ppc1phi, 
+                                            eventWeight*alphaReweight*
+                                            reweightPC1Simple[6]);
+         }
+         else
+         {
+            histContainer.heatmapPC1w.Fill(track.ppc1z, ppc1phi, 
+                                            eventWeight*alphaReweight*
+                                            reweightPC1Simple[7]);
+         }
+      }
+   }
+   else // PC1e
+   {
+      if (charge == 1)
+      {
+         histContainer.heatmapPC1ePos.Fill(track.ppc1z, ppc1phi, 
+                                            eventWeight*alphaReweight);
+
+         if (doReweightPC1) reweightPC1 = reweightPC1ePosTable.Get(track.ppc1z, ppc1phi);
+
+         if (track.ppc1z < 0.)
+         {
+            histContainer.heatmapPC1e.Fill(track.ppc1z, ppc1phi, 
+                                            eventWeight*alphaReweight*
+                                            reweightPC1Simple[0]);
+         }
+         else
+         {
+            histContainer.heatmapPC1e.Fill(track.ppc1z, ppc1phi, 
+                                            eventWeight*alphaReweight*
+                                            reweightPC1Simple[1]);
+         }
+      }
+      else
+      {
+         histContainer.heatmapPC1eNeg.Fill(track.ppc1z, ppc1phi, 
+                                            eventWeight*alphaReweight);
+         if (doReweightPC1) reweightPC1 = reweightPC1eNegTable.Get(track.ppc1z, ppc1phi);
+
+         if (track.ppc1z < 0.)
+         {
+            histContainer.heatmapPC1e.Fill(track.ppc1z, ppc1phi, 
+                                            eventWeight*alphaReweight*
+                                            reweightPC1Simple[2]);
+            //reweightPC1 *= reweightPC1Simple[2];
+         }
+         else
+         {
+            histContainer.heatmapPC1e.Fill(track.ppc1z, ppc1phi, 
+                                            eventWeight*alphaReweight*
+                                            reweightPC1Simple[3]);
+            //reweightPC1 *= reweightPC1Simple[3];
+         }
+      }
+   }
+   // only PC1 heatmaps are needed to derive PC1 reweight
+   if (isPC1ReweightPass) return;
+
+   if (track.isDeadPC1) return;
+
+   histContainer.distrOrigPTVsRecPT.Fill(origPT, pT, eventWeight);
+
+   histContainer.distrRecPT.Fill(pT, eventWeight);
+   //histContainer.distrRecPTNoScaleReweight.Fill(pT, eventWeight/scaleReweight);
+
+   int idPC2 = PART_ID::JUNK;
+   int idPC3 = PART_ID::JUNK;
+   int idEMCal = PART_ID::JUNK;
+   int idTOFe = PART_ID::JUNK;
+   int idTOFw = PART_ID::JUNK;
+
+   if (usePC2 && IsHit(track.pc2dphi))
+   {
+      const double sdphi = track.pc2sdphi;
+      const double sdz = track.pc2sdz;
+
+      if (charge == 1) 
+      {
+         histContainer.distrDPhiVsPTPC2Pos.Fill(track.pc2dphi, pT, eventWeight);
+         histContainer.distrDZVsPTPC2Pos.Fill(track.pc2dz, pT, eventWeight);
+
+         histContainer.distrSDPhiVsPTPC2Pos.Fill(sdphi, pT, eventWeight);
+         histContainer.distrSDZVsPTPC2Pos.Fill(sdz, pT, eventWeight);
+      }
+      else
+      {
+         histContainer.distrDPhiVsPTPC2Neg.Fill(track.pc2dphi, pT, eventWeight);
+         histContainer.distrDZVsPTPC2Neg.Fill(track.pc2dz, pT, eventWeight);
+
+         histContainer.distrSDPhiVsPTPC2Neg.Fill(sdphi, pT, eventWeight);
+         histContainer.distrSDZVsPTPC2Neg.Fill(sdz, pT, eventWeight);
+      }
+
+      if (IsMatch(sdphi, sdz))
+      {
+         const double pc2phi = track.pc2phi;
+
+         histContainer.heatmapPC2.Fill(track.ppc2z, pc2phi, 
+                                        eventWeight*alphaReweight*reweightPC1);
+
+         if (!track.isDeadPC2)
+         {
+            idPC2 = PART_ID::NONE;
+            if (track.isParticleOrig) histContainer.distrRecPTPC2.Fill(pT, eventWeight);
+         }
+      }
+   }
+
+   if (usePC3 && IsHit(track.pc3dphi))
+   {
+      const double sdphi = track.pc3sdphi;
+      const double sdz = track.pc3sdz;
+
+      if (dcarm == 0) // PC3e
+      {
+         if (charge == 1) 
+         {
+            histContainer.distrDPhiVsPTPC3ePos.Fill(track.pc3dphi, pT, eventWeight);
+            histContainer.distrDZVsPTPC3ePos.Fill(track.pc3dz, pT, eventWeight);
+
+            histContainer.distrSDPhiVsPTPC3ePos.Fill(sdphi, pT, eventWeight);
+            histContainer.distrSDZVsPTPC3ePos.Fill(sdz, pT, eventWeight);
+         }
+         else
+         {
+            histContainer.distrDPhiVsPTPC3eNeg.Fill(track.pc3dphi, pT, eventWeight);
+            histContainer.distrDZVsPTPC3eNeg.Fill(track.pc3dz, pT, eventWeight);
+
+            histContainer.distrSDPhiVsPTPC3eNeg.Fill(sdphi, pT, eventWeight);
+            histContainer.distrSDZVsPTPC3eNeg.Fill(sdz, pT, eventWeight);
+         }
+      }
+      else // PC3w
+      {
+         if (charge == 1) 
+         {
+            histContainer.distrDPhiVsPTPC3wPos.Fill(track.pc3dphi, pT, eventWeight);
+            histContainer.distrDZVsPTPC3wPos.Fill(track.pc3dz, pT, eventWeight);
+
+            histContainer.distrSDPhiVsPTPC3wPos.Fill(sdphi, pT, eventWeight);
+            histContainer.distrSDZVsPTPC3wPos.Fill(sdz, pT, eventWeight);
+         }
+         else
+         {
+            histContainer.distrDPhiVsPTPC3wNeg.Fill(track.pc3dphi, pT, eventWeight);
+            histContainer.distrDZVsPTPC3wNeg.Fill(track.pc3dz, pT, eventWeight);
+
+            histContainer.distrSDPhiVsPTPC3wNeg.Fill(sdphi, pT, eventWeight);
+            histContainer.distrSDZVsPTPC3wNeg.Fill(sdz, pT, eventWeight);
+         }
+      }
+
+      if (IsMatch(sdphi, sdz))
+      {
+         const double pc3phi = track.pc3phi;
+
+         if (dcarm == 0) // PC3e
+         {
+            histContainer.heatmapPC3e.Fill(track.ppc3z, pc3phi, 
+                                            eventWeight*alphaReweight*reweightPC1);
+         }
+         else // PC3w
+         {
+            histContainer.heatmapPC3w.Fill(track.ppc3z, pc3phi, 
+                                            eventWeight*alphaReweight*reweightPC1);
+         }
+         if (!track.isDeadPC3) 
+         {
+            idPC3 = PART_ID::NONE;
+            if (track.isParticleOrig) histContainer.distrRecPTPC3.Fill(pT, eventWeight);
+         }
+      }
+   }
+
+   if (useEMCal && IsHit(track.emcdz))
+   {
+      const double sdphi = track.emcsdphi;
+      const double sdz = track.emcsdz;
+
+      if (dcarm == 0) // EMCale
+      {
+         histContainer.distrECoreVsPTEMCale[track.sect].
+            Fill(pT, track.ecore, eventWeight);
+
+         if (track.isParticleOrig)
+         {
+            histContainer.distrECoreVsPTEMCaleOrig[track.sect].
+               Fill(pT, track.ecore, eventWeight);
+         }
+         if (charge == 1) 
+         {
+            histContainer.distrProbVsPTEMCale[track.sect].
+               Fill(pT, track.prob, eventWeight);
+
+            histContainer.distrDPhiVsPTEMCalePos[track.sect].
+               Fill(track.emcdphi, pT, eventWeight);
+            histContainer.distrDZVsPTEMCalePos[track.sect].
+               Fill(track.emcdz, pT, eventWeight);
+
+            histContainer.distrSDPhiVsPTEMCalePos[track.sect].
+               Fill(sdphi, pT, eventWeight);
+            histContainer.distrSDZVsPTEMCalePos[track.sect].
+               Fill(sdz, pT, eventWeight);
+         }
+         else
+         {
+            histContainer.distrDPhiVsPTEMCaleNeg[track.sect].
+               Fill(track.emcdphi, pT, eventWeight);
+            histContainer.distrDZVsPTEMCaleNeg[track.sect].
+               Fill(track.emcdz, pT, eventWeight);
+
+            histContainer.distrSDPhiVsPTEMCaleNeg[track.sect].
+               Fill(sdphi, pT, eventWeight);
+            histContainer.distrSDZVsPTEMCaleNeg[track.sect].
+               Fill(sdz, pT, eventWeight);
+         }
+      }
+      else // EMCalw
+      {
+         histContainer.distrProbVsPTEMCalw[track.sect].
+            Fill(pT, track.prob, eventWeight);
+         histContainer.distrECoreVsPTEMCalw[track.sect].
+            Fill(pT, track.ecore, eventWeight);
 
-                     histContainer.distrSDPhiVsPTPC3wNeg->Fill(sdphi, pT, eventWeight);
-                     histContainer.distrSDZVsPTPC3wNeg->Fill(sdz, pT, eventWeight);
-                  }
-               }
+         if (track.isParticleOrig)
+         {
+            histContainer.distrECoreVsPTEMCalwOrig[track.sect].
+               Fill(pT, track.ecore, eventWeight);
+         }
 
-               if (IsMatch(sdphi, sdz))
-               {
-                  double pc3phi = atan2(simCNT.ppc3y(i), simCNT.ppc3x(i));
+         if (charge == 1) 
+         {
+            histContainer.distrDPhiVsPTEMCalwPos[track.sect].
+               Fill(track.emcdphi, pT, eventWeight);
+            histContainer.distrDZVsPTEMCalwPos[track.sect].
+               Fill(track.emcdz, pT, eventWeight);
+
+            histContainer.distrSDPhiVsPTEMCalwPos[track.sect].
+               Fill(sdphi, pT, eventWeight);
+            histContainer.distrSDZVsPTEMCalwPos[track.sect].
+               Fill(sdz, pT, eventWeight);
+         }
+         else
+         {
+            histContainer.distrDPhiVsPTEMCalwNeg[track.sect].
+               Fill(track.emcdphi, pT, eventWeight);
+            histContainer.distrDZVsPTEMCalwNeg[track.sect].
+               Fill(track.emcdz, pT, eventWeight);
+
+            histContainer.distrSDPhiVsPTEMCalwNeg[track.sect].
+               Fill(sdphi, pT, eventWeight);
+            histContainer.distrSDZVsPTEMCalwNeg[track.sect].
+               Fill(sdz, pT, eventWeight);
+         }
+      }
 
-                  if (dcarm == 0 && pc3phi < 0) pc3phi += 2.*M_PI;
+      if (IsMatch(sdphi, sdz))
+      {
+         bool isCutByECore;
+         if (dcarm == 0 && track.sect < 2) isCutByECore = (track.ecore < 0.35);
+         else isCutByECore = (track.ecore < 0.25); // PbSc
 
-                  if (dcarm == 0) // PC3e
-                  {
-                     histContainer.heatmapPC3e->Fill(simCNT.ppc3z(i), pc3phi, 
-                                                     eventWeight*alphaReweight*reweightPC1);
-                  }
-                  else // PC3w
-                  {
-                     histContainer.heatmapPC3w->Fill(simCNT.ppc3z(i), pc3phi, 
-                                                     eventWeight*alphaReweight*reweightPC1);
-                  }
-                  if (!dmCutter.IsDeadPC3(dcarm, simCNT.ppc3z(i), pc3phi)) 
-                  {
-                     idPC3 = PART_ID::NONE;
-                     if (isParticleOrig) histContainer.distrRecPTPC3->Fill(pT, eventWeight);
-                  }
-               }
+         if (!isCutByECore)
+         { 
+            if (dcarm == 0) // EMCale
+            {
+               histContainer.heatmapEMCale[track.sect].
+                  Fill(static_cast<double>(track.ysect) + 0.5, 
+                       static_cast<double>(track.zsect) + 0.5, 
+                       track.ecore*eventWeight*alphaReweight*reweightPC1);
+               histContainer.heatmapEMCaleHit[track.sect].
+                  Fill(static_cast<double>(track.ysect) + 0.5, 
+                       static_cast<double>(track.zsect) + 0.5, 
+                       eventWeight*alphaReweight*reweightPC1);
             }
-
-            if (IsHit(simCNT.emcdz(i)))
+            else // EMCalw
             {
-               const double sdphi = 
-                  simSigmRes.EMCalSDPhi(simCNT.emcdphi(i), pT, charge, dcarm, simCNT.sect(i));
-               const double sdz = 
-                  simSigmRes.EMCalSDZ(simCNT.emcdz(i), pT, charge, dcarm, simCNT.sect(i));
-
-               if (dcarm == 0) // EMCale
-               {
-                  histContainer.distrECoreVsPTEMCale[simCNT.sect(i)]->
-                     Fill(pT, simCNT.ecore(i), eventWeight);
-
-                  if (isParticleOrig)
-                  {
-                     histContainer.distrECoreVsPTEMCaleOrig[simCNT.sect(i)]->
-                        Fill(pT, simCNT.ecore(i), eventWeight);
-                  }
-                  if (charge == 1) 
-                  {
-                     histContainer.distrProbVsPTEMCale[simCNT.sect(i)]->
-                        Fill(pT, simCNT.prob(i), eventWeight);
-
-                     histContainer.distrDPhiVsPTEMCalePos[simCNT.sect(i)]->
-                        Fill(simCNT.emcdphi(i), pT, eventWeight);
-                     histContainer.distrDZVsPTEMCalePos[simCNT.sect(i)]->
-                        Fill(simCNT.emcdz(i), pT, eventWeight);
-
-                     histContainer.distrSDPhiVsPTEMCalePos[simCNT.sect(i)]->
-                        Fill(sdphi, pT, eventWeight);
-                     histContainer.distrSDZVsPTEMCalePos[simCNT.sect(i)]->
-                        Fill(sdz, pT, eventWeight);
-                  }
-                  else
-                  {
-                     histContainer.distrDPhiVsPTEMCaleNeg[simCNT.sect(i)]->
-                        Fill(simCNT.emcdphi(i), pT, eventWeight);
-                     histContainer.distrDZVsPTEMCaleNeg[simCNT.sect(i)]->
-                        Fill(simCNT.emcdz(i), pT, eventWeight);
-
-                     histContainer.distrSDPhiVsPTEMCaleNeg[simCNT.sect(i)]->
-                        Fill(sdphi, pT, eventWeight);
-                     histContainer.distrSDZVsPTEMCaleNeg[simCNT.sect(i)]->
-                        Fill(sdz, pT, eventWeight);
-                  }
-               }
-               else // EMCalw
-               {
-                  histContainer.distrProbVsPTEMCalw[simCNT.sect(i)]->
-                     Fill(pT, simCNT.prob(i), eventWeight);
-                  histContainer.distrECoreVsPTEMCalw[simCNT.sect(i)]->
-                     Fill(pT, simCNT.ecore(i), eventWeight);
-
-                  if (isParticleOrig)
-                  {
-                     histContainer.distrECoreVsPTEMCalwOrig[simCNT.sect(i)]->
-                        Fill(pT, simCNT.ecore(i), eventWeight);
-                  }
+               histContainer.heatmapEMCalw[track.sect].
+                  Fill(static_cast<double>(track.ysect) + 0.5, 
+                       static_cast<double>(track.zsect) + 0.5, 
+                       track.ecore*eventWeight*alphaReweight*reweightPC1);
+               histContainer.heatmapEMCalwHit[track.sect].
+                  Fill(static_cast<double>(track.ysect) + 0.5, 
+                       static_cast<double>(track.zsect) + 0.5, 
+                       eventWeight*alphaReweight*reweightPC1);
+            }
+         }
 
-                  if (charge == 1) 
-                  {
-                     histContainer.distrDPhiVsPTEMCalwPos[simCNT.sect(i)]->
-                        Fill(simCNT.emcdphi(i), pT, eventWeight);
-                     histContainer.distrDZVsPTEMCalwPos[simCNT.sect(i)]->
-                        Fill(simCNT.emcdz(i), pT, eventWeight);
-
-                     histContainer.distrSDPhiVsPTEMCalwPos[simCNT.sect(i)]->
-                        Fill(sdphi, pT, eventWeight);
-                     histContainer.distrSDZVsPTEMCalwPos[simCNT.sect(i)]->
-                        Fill(sdz, pT, eventWeight);
-                  }
-                  else
-                  {
-                     histContainer.distrDPhiVsPTEMCalwNeg[simCNT.sect(i)]->
-                        Fill(simCNT.emcdphi(i), pT, eventWeight);
-                     histContainer.distrDZVsPTEMCalwNeg[simCNT.sect(i)]->
-                        Fill(simCNT.emcdz(i), pT, eventWeight);
-
-                     histContainer.distrSDPhiVsPTEMCalwNeg[simCNT.sect(i)]->
-                        Fill(sdphi, pT, eventWeight);
-                     histContainer.distrSDZVsPTEMCalwNeg[simCNT.sect(i)]->
-                        Fill(sdz, pT, eventWeight);
-                  }
-               }
+         if (!track.isDeadEMCal && !isCutByECore)
+         {
+            idEMCal = PART_ID::NONE;
 
-               if (IsMatch(sdphi, sdz))
-               {
-                  bool isCutByECore;
-                  if (dcarm == 0 && simCNT.sect(i) < 2) isCutByECore = (simCNT.ecore(i) < 0.35);
-                  else isCutByECore = (simCNT.ecore(i) < 0.25); // PbSc
-
-                  if (!isCutByECore)
-                  { 
-                     if (dcarm == 0) // EMCale
-                     {
-                        histContainer.heatmapEMCale[simCNT.sect(i)]->
-                           Fill(static_cast<double>(simCNT.ysect(i)) + 0.5, 
-                                static_cast<double>(simCNT.zsect(i)) + 0.5, 
-                                simCNT.ecore(i)*eventWeight*alphaReweight*reweightPC1);
-                        histContainer.heatmapEMCaleHit[simCNT.sect(i)]->
-                           Fill(static_cast<double>(simCNT.ysect(i)) + 0.5, 
-                                static_cast<double>(simCNT.zsect(i)) + 0.5, 
-                                eventWeight*alphaReweight*reweightPC1);
-                     }
-                     else // EMCalw
-                     {
-                        histContainer.heatmapEMCalw[simCNT.sect(i)]->
-                           Fill(static_cast<double>(simCNT.ysect(i)) + 0.5, 
-                                static_cast<double>(simCNT.zsect(i)) + 0.5, 
-                                simCNT.ecore(i)*eventWeight*alphaReweight*reweightPC1);
-                        histContainer.heatmapEMCalwHit[simCNT.sect(i)]->
-                           Fill(static_cast<double>(simCNT.ysect(i)) + 0.5, 
-                                static_cast<double>(simCNT.zsect(i)) + 0.5, 
-                                eventWeight*alphaReweight*reweightPC1);
-                     }
-                  }
+            const double tExpPi = sqrt(track.plemc*track.plemc/
+                                       (SPEED_OF_LIGHT*SPEED_OF_LIGHT)*
+                                       (MASS_PION*MASS_PION/
+                                        (track.mom*track.mom) + 1.));
 
-                  if (!dmCutter.IsDeadEMCal(dcarm, simCNT.sect(i), 
-                                            simCNT.ysect(i), simCNT.zsect(i)) && 
-                      !isCutByECore)
-                  {
-                     idEMCal = PART_ID::NONE;
-
-                     const double tExpPi = sqrt(simCNT.plemc(i)*simCNT.plemc(i)/
-                                                (SPEED_OF_LIGHT*SPEED_OF_LIGHT)*
-                                                (MASS_PION*MASS_PION/
-                                                 (simCNT.mom(i)*simCNT.mom(i)) + 1.));
-
-                     const double tEMCal = simCNT.temc(i) + timeShiftEMCal;
-                     const double m2 = simCNT.mom(i)*simCNT.mom(i)*
-                                       (tEMCal*tEMCal*SPEED_OF_LIGHT*SPEED_OF_LIGHT/
-                                        (simCNT.plemc(i)*simCNT.plemc(i)) - 1.);
-
-                     if (dcarm == 0)
-                     {
-                        histContainer.distrTEMCale[simCNT.sect(i)]->
-                           Fill(simCNT.temc(i) - tExpPi, pT, eventWeight);
-
-                        if (charge == 1)
-                        {
-                           histContainer.distrM2EMCalePosCharge[simCNT.sect(i)]->
-                              Fill(m2, pT, eventWeight);
-                        }
-                        else
-                        {
-                           histContainer.distrM2EMCaleNegCharge[simCNT.sect(i)]->
-                              Fill(m2, pT, eventWeight);
-                        }
-
-                        if (isParticleOrig)
-                        {
-                           histContainer.distrRecPTEMCale[simCNT.sect(i)]->Fill(pT, eventWeight);
-                           if (simCNT.sect(i) > 1)
-                           {
-                              histContainer.distrRecIdPTEMCale[simCNT.sect(i) - 2]->
-                                 Fill(pT, eventWeight*
-                                      simM2Id.GetEMCalIdProb(simCNT.dcarm(i), simCNT.sect(i), 
-                                                             particleId, pT, 1., 2.));
-                           }
-                        }
-                     }
-                     else
-                     {
-                        histContainer.distrTEMCalw[simCNT.sect(i)]->
-                           Fill(simCNT.temc(i) - tExpPi, pT, eventWeight);
-
-                        if (charge == 1)
-                        {
-                           histContainer.distrM2EMCalwPosCharge[simCNT.sect(i)]->
-                              Fill(m2, pT, eventWeight);
-                        }
-                        else
-                        {
-                           histContainer.distrM2EMCalwNegCharge[simCNT.sect(i)]->
-                              Fill(m2, pT, eventWeight);
-                        }
-
-                        if (isParticleOrig)
-                        {
-                           histContainer.distrRecPTEMCalw[simCNT.sect(i)]->Fill(pT, eventWeight);
-                           idEMCal = PART_ID::NONE;
-                           histContainer.distrRecIdPTEMCalw[simCNT.sect(i)]->
-                              Fill(pT, simM2Id.GetEMCalIdProb(simCNT.dcarm(i), simCNT.sect(i), 
-                                                              particleId, pT, 1., 2.)*eventWeight);
-                        }
-                     }
-                  }
-               }
-            }
+            const double tEMCal = track.temc + timeShiftEMCal;
+            const double m2 = track.mom*track.mom*
+                              (tEMCal*tEMCal*SPEED_OF_LIGHT*SPEED_OF_LIGHT/
+                               (track.plemc*track.plemc) - 1.);
 
-            if (IsHit(simCNT.tofdz(i)))
+            if (dcarm == 0)
             {
-               const double sdphi = simSigmRes.TOFeSDPhi(simCNT.tofdphi(i), pT, charge);
-               const double sdz = simSigmRes.TOFeSDZ(simCNT.tofdz(i), pT, charge);
+               histContainer.distrTEMCale[track.sect].
+                  Fill(track.temc - tExpPi, pT, eventWeight);
 
-               if (charge == 1) 
+               if (charge == 1)
                {
-                  histContainer.distrDPhiVsPTTOFePos->Fill(simCNT.tofdphi(i), pT, eventWeight);
-                  histContainer.distrDZVsPTTOFePos->Fill(simCNT.tofdz(i), pT, eventWeight);
-
-                  histContainer.distrSDPhiVsPTTOFePos->Fill(sdphi, pT, eventWeight);
-                  histContainer.distrSDZVsPTTOFePos->Fill(sdz, pT, eventWeight);
+                  histContainer.distrM2EMCalePosCharge[track.sect].
+                     Fill(m2, pT, eventWeight);
                }
                else
                {
-                  histContainer.distrDPhiVsPTTOFeNeg->Fill(simCNT.tofdphi(i), pT, eventWeight);
-                  histContainer.distrDZVsPTTOFeNeg->Fill(simCNT.tofdz(i), pT, eventWeight);
-
-                  histContainer.distrSDPhiVsPTTOFeNeg->Fill(sdphi, pT, eventWeight);
-                  histContainer.distrSDZVsPTTOFeNeg->Fill(sdz, pT, eventWeight);
+                  histContainer.distrM2EMCaleNegCharge[track.sect].
+                     Fill(m2, pT, eventWeight);
                }
 
-               const double beta = simCNT.pltof(i)/simCNT.ttof(i)/29.9792;
-               const double eloss = 0.0015*pow(beta, -2.5);
-               histContainer.distrBetaVsETOFe->Fill(beta, simCNT.etof(i), eventWeight);
-
-               if (simCNT.etof(i) > eloss && IsMatch(sdphi, sdz))
+               if (track.isParticleOrig)
                {
-                  // slats are organized in 10 lines of 96 we define as chambers
-                  const int chamber = simCNT.slat(i)/96;
-                  // slat number for the current chamber
-                  const int slat = simCNT.slat(i) % 96;
-
-                  histContainer.heatmapTOFe->Fill(static_cast<double>(chamber) + 0.5, 
-                                                  static_cast<double>(slat) + 0.5, 
-                                                  simCNT.etof(i)*eventWeight*
-                                                  alphaReweight*reweightPC1);
-
-                  histContainer.heatmapTOFeHit->Fill(static_cast<double>(chamber) + 0.5, 
-                                                     static_cast<double>(slat) + 0.5, 
-                                                     eventWeight* alphaReweight*reweightPC1);
-
-                  if (!dmCutter.IsDeadTOFe(chamber, slat))
+                  histContainer.distrRecPTEMCale[track.sect].Fill(pT, eventWeight);
+                  if (track.sect > 1)
                   {
-                     idTOFe = PART_ID::NONE;
-
-                     const double tExpPi = sqrt(simCNT.pltof(i)*simCNT.pltof(i)/
-                                                (SPEED_OF_LIGHT*SPEED_OF_LIGHT)*
-                                                (MASS_PION*MASS_PION/
-                                                 (simCNT.mom(i)*simCNT.mom(i)) + 1.));
-
-                     const double tTOFe = simCNT.ttof(i) + timeShiftTOFe;
-                     const double m2 = simCNT.mom(i)*simCNT.mom(i)*
-                                       (tTOFe*tTOFe*SPEED_OF_LIGHT*SPEED_OF_LIGHT/
-                                        (simCNT.pltof(i)*simCNT.pltof(i)) - 1.);
-
-                     histContainer.distrTTOFe->Fill(simCNT.ttof(i) - tExpPi, pT, eventWeight);
-
-                     if (charge == 1) histContainer.distrM2TOFePosCharge->Fill(m2, pT, eventWeight);
-                     else histContainer.distrM2TOFeNegCharge->Fill(m2, pT, eventWeight);
-
-                     if (isParticleOrig)
-                     {
-                        histContainer.distrRecPTTOFe->Fill(pT, eventWeight);
-                        idTOFe = PART_ID::NONE;
-                        histContainer.distrRecIdPTTOFe->
-                           Fill(pT, eventWeight*simM2Id.GetTOFeIdProb(particleId, pT, 2., 2.));
-                     }
+                     histContainer.distrRecIdPTEMCale[track.sect - 2].
+                        Fill(pT, eventWeight*
+                             simM2Id.GetEMCalIdProb(track.dcarm, track.sect, 
+                                                    particleId, pT, 1., 2.));
                   }
                }
             }
-            else if (IsHit(simCNT.tofwdz(i)))
+            else
             {
-               const double sdphi = simSigmRes.TOFwSDPhi(simCNT.tofwdphi(i), pT, charge);
-               const double sdz = simSigmRes.TOFwSDZ(simCNT.tofwdz(i), pT, charge);
+               histContainer.distrTEMCalw[track.sect].
+                  Fill(track.temc - tExpPi, pT, eventWeight);
 
-               if (charge == 1) 
+               if (charge == 1)
                {
-                  histContainer.distrDPhiVsPTTOFwPos->
-                     Fill(simCNT.tofwdphi(i), pT, eventWeight*correctionTOFw);
-                  histContainer.distrDZVsPTTOFwPos->
-                     Fill(simCNT.tofwdz(i), pT, eventWeight*correctionTOFw);
-
-                  histContainer.distrSDPhiVsPTTOFwPos->Fill(sdphi, pT, eventWeight*correctionTOFw);
-                  histContainer.distrSDZVsPTTOFwPos->Fill(sdz, pT, eventWeight*correctionTOFw);
+                  histContainer.distrM2EMCalwPosCharge[track.sect].
+                     Fill(m2, pT, eventWeight);
                }
                else
                {
-                  histContainer.distrDPhiVsPTTOFwNeg->
-                     Fill(simCNT.tofwdphi(i), pT, eventWeight*correctionTOFw);
-                  histContainer.distrDZVsPTTOFwNeg->
-                     Fill(simCNT.tofwdz(i), pT, eventWeight*correctionTOFw);
-
-                  histContainer.distrSDPhiVsPTTOFwNeg->Fill(sdphi, pT, eventWeight*correctionTOFw);
-                  histContainer.distrSDZVsPTTOFwNeg->Fill(sdz, pT, eventWeight*correctionTOFw);
+                  histContainer.distrM2EMCalwNegCharge[track.sect].
+                     Fill(m2, pT, eventWeight);
                }
 
-               // strips are organized in 8 lines of 64 we define as chambers
-               const int chamber = simCNT.striptofw(i)/64;
-               // strip number for the current chamber
-               const int strip = simCNT.striptofw(i) % 64;
-
-               if (IsMatch(sdphi, sdz))
+               if (track.isParticleOrig)
                {
-                  histContainer.heatmapTOFw->Fill(static_cast<double>(chamber) + 0.5, 
-                                                  static_cast<double>(strip) + 0.5, 
-                                                  eventWeight*correctionTOFw*
-                                                  alphaReweight*reweightPC1);
-
-                  if (!dmCutter.IsDeadTOFw(chamber, strip))
-                  {
-                     idTOFw = PART_ID::NONE;
-
-                     const double tExpPi = sqrt(simCNT.pltofw(i)*simCNT.pltofw(i)/
-                                                (SPEED_OF_LIGHT*SPEED_OF_LIGHT)*
-                                                (MASS_PION*MASS_PION/
-                                                 (simCNT.mom(i)*simCNT.mom(i)) + 1.));
-
-                     const double tTOFw = simCNT.ttofw(i) + timeShiftTOFw;
-
-                     const double m2 = simCNT.mom(i)*simCNT.mom(i)*
-                                       (tTOFw*tTOFw*SPEED_OF_LIGHT*SPEED_OF_LIGHT/
-                                        (simCNT.pltofw(i)*simCNT.pltofw(i)) - 1.);
-
-                     histContainer.distrTTOFw->Fill(simCNT.ttofw(i) - tExpPi, pT, 
-                                                    eventWeight*correctionTOFw);
-
-                     if (charge == 1) histContainer.distrM2TOFwPosCharge->
-                        Fill(m2, pT, eventWeight*correctionTOFw);
-                     else histContainer.distrM2TOFwNegCharge->
-                        Fill(m2, pT, eventWeight*correctionTOFw);
-
-                     if (isParticleOrig)
-                     {
-                        histContainer.distrRecPTTOFw->Fill(pT, eventWeight*correctionTOFw);
-                        histContainer.distrRecIdPTTOFw->
-                           Fill(pT, eventWeight*correctionTOFw*
-                                simM2Id.GetTOFwIdProb(particleId, pT, 2., 2.));
-                     }
-                  }
+                  histContainer.distrRecPTEMCalw[track.sect].Fill(pT, eventWeight);
+                  idEMCal = PART_ID::NONE;
+                  histContainer.distrRecIdPTEMCalw[track.sect].
+                     Fill(pT, simM2Id.GetEMCalIdProb(track.dcarm, track.sect, 
+                                                     particleId, pT, 1., 2.)*eventWeight);
                }
             }
-
-            if (idPC2 == PART_ID::JUNK && idPC3 == PART_ID::JUNK && idEMCal == PART_ID::JUNK && 
-                idTOFe == PART_ID::JUNK && idTOFw == PART_ID::JUNK) continue;
-
-            switch (charge)
-            {
-               case 1:
-                  positiveTracks.emplace_back(MASS_PION, simCNT, i, 1.);
-                  positiveTracks.back().idPC2 = idPC2;
-                  positiveTracks.back().idPC3 = idPC3;
-                  positiveTracks.back().idEMCal = idEMCal;
-                  positiveTracks.back().idTOFe = idTOFe;
-                  positiveTracks.back().idTOFw = idTOFw;
-                  break;
-               case -1:
-                  negativeTracks.emplace_back(MASS_KAON, simCNT, i, 1.);
-                  negativeTracks.back().idPC2 = idPC2;
-                  negativeTracks.back().idPC3 = idPC3;
-                  negativeTracks.back().idEMCal = idEMCal;
-                  negativeTracks.back().idTOFe = idTOFe;
-                  negativeTracks.back().idTOFw = idTOFw;
-                  break;
-            }
-         }
-         // looping over pairs of tracks
-         for (auto& posTrack : positiveTracks)
-         {
-            for (auto& negTrack : negativeTracks)
-            {
-               // invariant mass [GeV/c^2] of pi+ k- pair
-               const double mInvPiK = GetPairMass(posTrack, negTrack);
-
-               posTrack.m = MASS_KAON;
-               negTrack.m = MASS_KAON;
-
-               // invariant mass [GeV/c^2] of k+ pi- pair
-               const double mInvKPi = GetPairMass(posTrack, negTrack);
-
-               // pT of a pair [GeV/c]
-               const double pT = GetPairPT(posTrack, negTrack);
-
-               if (IsGhostCut(posTrack, negTrack)) continue;
-               if (IsOneArmCut(posTrack, negTrack)) continue;
-
-               histContainer.distrMInvNoPIDNoGhost->Fill(pT, mInvPiK, eventWeight);
-               histContainer.distrMInvNoPIDNoGhost->Fill(pT, mInvKPi, eventWeight);
-
-               if (!IsNoPID(posTrack, negTrack)) continue;
-
-               histContainer.distrMInvNoPID->Fill(pT, mInvPiK, eventWeight);
-               histContainer.distrMInvNoPID->Fill(pT, mInvKPi, eventWeight);
-            }
          }
       }
-   };
-
-   tp.Process(ProcessMP);
-}
+   }
 
-int main(int argc, char **argv)
-{
-   if (argc < 2 || argc > 3) 
+   if (useTOFe && IsHit(track.tofdz))
    {
-      std::string errMsg = "Expected 1-2 parameters while " + std::to_string(argc - 1) + " ";
-      errMsg += "parameter(s) were provided \n Usage: bin/AnalyzeSimSingleTrack ";
-      errMsg += "inputYAMLName numberOfThreads=std::thread::hardware_concurrency()";
-      CppTools::PrintError(errMsg);
-   }
- 
-   CppTools::CheckInputFile(argv[1]);
- 
-   if (argc == 2) numberOfThreads = std::thread::hardware_concurrency();
-   else numberOfThreads = std::stoi(argv[2]);
+      const double sdphi = track.tofesdphi;
+      const double sdz = track.tofesdz;
 
-   ROOT::EnableImplicitMT(numberOfThreads);
+      if (charge == 1) 
+      {
+         histContainer.distrDPhiVsPTTOFePos.Fill(track.tofdphi, pT, eventWeight);
+         histContainer.distrDZVsPTTOFePos.Fill(track.tofdz, pT, eventWeight);
 
-   inputYAMLSim.OpenFile(argv[1], "single_track_sim");
-   inputYAMLSim.CheckStatus("single_track_sim");
+         histContainer.distrSDPhiVsPTTOFePos.Fill(sdphi, pT, eventWeight);
+         histContainer.distrSDZVsPTTOFePos.Fill(sdz, pT, eventWeight);
+      }
+      else
+      {
+         histContainer.distrDPhiVsPTTOFeNeg.Fill(track.tofdphi, pT, eventWeight);
+         histContainer.distrDZVsPTTOFeNeg.Fill(track.tofdz, pT, eventWeight);
 
-   runName = inputYAMLSim["run_name"].as<std::string>();
+         histContainer.distrSDPhiVsPTTOFeNeg.Fill(sdphi, pT, eventWeight);
+         histContainer.distrSDZVsPTTOFeNeg.Fill(sdz, pT, eventWeight);
+      }
 
-   inputYAMLMain.OpenFile("input/" + runName + "/main.yaml");
-   inputYAMLMain.CheckStatus("main");
- 
-   collisionSystemName = inputYAMLMain["collision_system_name"].as<std::string>();
+      const double beta = track.pltof/track.ttof/29.9792;
+      const double eloss = 0.0015*pow(beta, -2.5);
+      histContainer.distrBetaVsETOFe.Fill(beta, track.etof, eventWeight);
 
-   boardOffsetDCe = inputYAMLMain["sim_board_offset_dce"].as<double>();
-   boardOffsetDCw = inputYAMLMain["sim_board_offset_dcw"].as<double>();
+      if (track.etof > eloss && IsMatch(sdphi, sdz))
+      {
+         // slats are organized in 10 lines of 96 we define as chambers
+         const int chamber = track.slat/96;
+         // slat number for the current chamber
+         const int slat = track.slat % 96;
 
-   outputDir = "data/PostSim/" + runName + "/SingleTrack/";
-   std::filesystem::create_directories(outputDir);
+         histContainer.heatmapTOFe.Fill(static_cast<double>(chamber) + 0.5, 
+                                         static_cast<double>(slat) + 0.5, 
+                                         track.etof*eventWeight*
+                                         alphaReweight*reweightPC1);
 
-   pTMin = inputYAMLSim["pt_min"].as<double>();
-   pTMax = inputYAMLSim["pt_max"].as<double>();
+         histContainer.heatmapTOFeHit.Fill(static_cast<double>(chamber) + 0.5, 
+                                            static_cast<double>(slat) + 0.5, 
+                                            eventWeight* alphaReweight*reweightPC1);
 
-   doUserWeightSpectra = inputYAMLSim["reweight_for_spectra"].as<bool>();
+         if (!track.isDeadTOFe)
+         {
+            idTOFe = PART_ID::NONE;
 
-   correctionTOFw = inputYAMLSim["correction_tofw"].as<double>();
-   timeShiftTOFe = inputYAMLSim["time_shift_tofe"].as<double>();
-   timeShiftTOFw = inputYAMLSim["time_shift_tofw"].as<double>();
-   timeShiftEMCal = inputYAMLSim["time_shift_emcal"].as<double>();
+            const double tExpPi = sqrt(track.pltof*track.pltof/
+                                       (SPEED_OF_LIGHT*SPEED_OF_LIGHT)*
+                                       (MASS_PION*MASS_PION/
+                                        (track.mom*track.mom) + 1.));
 
-   dmCutter.Initialize(runName, inputYAMLMain["detectors_configuration"].as<std::string>());
-   dmCutterMC.Initialize(runName, inputYAMLMain["detectors_configuration"].as<std::string>(),
-                          "data/Parameters/SimDeadmaps");
+            const double tTOFe = track.ttof + timeShiftTOFe;
+            const double m2 = track.mom*track.mom*
+                              (tTOFe*tTOFe*SPEED_OF_LIGHT*SPEED_OF_LIGHT/
+                               (track.pltof*track.pltof) - 1.);
 
-   simSigmRes.Initialize(runName, inputYAMLMain["detectors_configuration"].as<std::string>());
-   simM2Id.Initialize(runName, false);
+            histContainer.distrTTOFe.Fill(track.ttof - tExpPi, pT, eventWeight);
 
-   if (doUserWeightSpectra)
-   {
-      for (const auto& particle : inputYAMLSim["particles"])
-      {
-         CppTools::CheckInputFile("data/Parameters/SpectraFit/" + collisionSystemName + 
-                                  "/" + particle["name"].as<std::string>() + ".yaml");
+            if (charge == 1) histContainer.distrM2TOFePosCharge.Fill(m2, pT, eventWeight);
+            else histContainer.distrM2TOFeNegCharge.Fill(m2, pT, eventWeight);
+
+            if (track.isParticleOrig)
+            {
+               histContainer.distrRecPTTOFe.Fill(pT, eventWeight);
+               idTOFe = PART_ID::NONE;
+               histContainer.distrRecIdPTTOFe.
+                  Fill(pT, eventWeight*simM2Id.GetTOFeIdProb(particleId, pT, 2., 2.));
+            }
+         }
       }
    }
- 
-   for (const auto& magneticField : inputYAMLMain["magnetic_field_configurations"])
+   else if (useTOFw && IsHit(track.tofwdz))
    {
-      CppTools::CheckInputFile("data/Real/" + runName + "/SingleTrack/sum" + 
-                               magneticField["name"].as<std::string>() + ".root");
+      const double sdphi = track.tofwsdphi;
+      const double sdz = track.tofwsdz;
 
-      for (const auto& particle : inputYAMLSim["particles"])
+      if (charge == 1) 
       {
-         for (const auto& pTRange : inputYAMLSim["pt_ranges"])
-         {
-            const std::string simInputFileName = 
-               "data/SimTrees/" + runName + "/SingleTrack/" + 
-               particle["name"].as<std::string>() + "_" + pTRange["name"].as<std::string>() + 
-               magneticField["name"].as<std::string>() + ".root";
-
-            CppTools::CheckInputFile(simInputFileName);
+         histContainer.distrDPhiVsPTTOFwPos.
+            Fill(track.tofwdphi, pT, eventWeight*correctionTOFw);
+         histContainer.distrDZVsPTTOFwPos.
+            Fill(track.tofwdz, pT, eventWeight*correctionTOFw);
 
-            const unsigned long currentConfigurationNumberOfEvents = static_cast<unsigned long>
-               ((static_cast<TTree *>(TFile::Open(simInputFileName.c_str())->
-                                      Get("Tree"))->GetEntries()));
-            if (currentConfigurationNumberOfEvents <= 0)
-            {
-               CppTools::PrintError("Number of events is equal or less than 0 in file " + 
-                                    simInputFileName);
-            }
-            numberOfEvents += currentConfigurationNumberOfEvents;
-         }
+         histContainer.distrSDPhiVsPTTOFwPos.Fill(sdphi, pT, eventWeight*correctionTOFw);
+         histContainer.distrSDZVsPTTOFwPos.Fill(sdz, pT, eventWeight*correctionTOFw);
       }
-   }
+      else
+      {
+         histContainer.distrDPhiVsPTTOFwNeg.
+            Fill(track.tofwdphi, pT, eventWeight*correctionTOFw);
+         histContainer.distrDZVsPTTOFwNeg.
+            Fill(track.tofwdz, pT, eventWeight*correctionTOFw);
 
-   // real data file in which real data DC heatmaps are stored
-   const std::string realDataInputFileName = "data/Real/" + runName + "/SingleTrack/sum.root";
-   // file in which simulated unscaled DC heatmaps are stored
-   const std::string postSimInputFileName = "data/PostSim/" + runName + "/SingleTrack/all.root";
+         histContainer.distrSDPhiVsPTTOFwNeg.Fill(sdphi, pT, eventWeight*correctionTOFw);
+         histContainer.distrSDZVsPTTOFwNeg.Fill(sdz, pT, eventWeight*correctionTOFw);
+      }
 
-   CppTools::CheckInputFile(realDataInputFileName);
+      // strips are organized in 8 lines of 64 we define as chambers
+      const int chamber = track.striptofw/64;
+      // strip number for the current chamber
+      const int strip = track.striptofw % 64;
 
-   SetPC1Reweight(realDataInputFileName, postSimInputFileName);
-   SetAlphaReweight(realDataInputFileName, postSimInputFileName);
+      if (IsMatch(sdphi, sdz))
+      {
+         histContainer.heatmapTOFw.Fill(static_cast<double>(chamber) + 0.5, 
+                                         static_cast<double>(strip) + 0.5, 
+                                         eventWeight*correctionTOFw*
+                                         alphaReweight*reweightPC1);
 
-   CppTools::PrintInfo("Clearing output directory: " + outputDir);
-   void(system(("find " + outputDir + " ! -name 'all.root' ! -name 'alpha_reweight.root' "\
-                "!  -name 'pc1_reweight.root' -type f -exec rm -f {} +").c_str()));
+         if (!track.isDeadTOFw)
+         {
+            idTOFw = PART_ID::NONE;
 
-   std::vector<std::string> particleList;
-   for (const auto& particle : inputYAMLSim["particles"])
-   {
-      particleList.emplace_back(particle["name"].as<std::string>());
-   }
+            const double tExpPi = sqrt(track.pltofw*track.pltofw/
+                                       (SPEED_OF_LIGHT*SPEED_OF_LIGHT)*
+                                       (MASS_PION*MASS_PION/
+                                        (track.mom*track.mom) + 1.));
 
-   std::vector<std::string> magneticFieldsList;
-   for (const auto& magneticField : inputYAMLMain["magnetic_field_configurations"])
-   {
-      magneticFieldsList.emplace_back(magneticField["name"].as<std::string>());
-   }
+            const double tTOFw = track.ttofw + timeShiftTOFw;
 
-   std::vector<std::string> pTRangesList;
-   for (const auto& pTRange : inputYAMLSim["pt_ranges"])
-   {
-      pTRangesList.emplace_back(pTRange["name"].as<std::string>());
-   }
+            const double m2 = track.mom*track.mom*
+                              (tTOFw*tTOFw*SPEED_OF_LIGHT*SPEED_OF_LIGHT/
+                               (track.pltofw*track.pltofw) - 1.);
 
-   CppTools::Box box{"AnalyzeSimSingleTrack"};
- 
-   box.AddEntry("Run name", runName);
-   box.AddEntry("Particles", particleList);
-   if (magneticFieldsList.size() == 1 && magneticFieldsList[0] == "")
-   {
-      box.AddEntry("Magnetic field", "run default");
-   }
-   else box.AddEntry("Magnetic fields", magneticFieldsList);
-   box.AddEntry("pT ranges", pTRangesList);
-   box.AddEntry("Charged track minimum pT, GeV", pTMin);
-   box.AddEntry("Charged track maximum pT, GeV", pTMax);
-   box.AddEntry("Weight pT spectra", 
-                std::string(doUserWeightSpectra ? "user defined" : "default (exp)"));
-   box.AddEntry("Reweight DC alpha", doReweightAlpha);
-   box.AddEntry("Reweight PC1", doReweightPC1);
-   box.AddEntry("Number of threads", numberOfThreads);
-   box.AddEntry("Number of events to be analyzed, 1e6", 
-                static_cast<double>(numberOfEvents)/1e6, 3);
-   box.Print();
+            histContainer.distrTTOFw.Fill(track.ttofw - tExpPi, pT, 
+                                           eventWeight*correctionTOFw);
 
-   bool isProcessFinished = false;
+            if (charge == 1) histContainer.distrM2TOFwPosCharge.
+               Fill(m2, pT, eventWeight*correctionTOFw);
+            else histContainer.distrM2TOFwNegCharge.
+               Fill(m2, pT, eventWeight*correctionTOFw);
 
-   auto pBarCall = [&]()
-   {
-      ProgressBar pBar{"FANCY"};
-      while (!isProcessFinished)
-      {
-         pBar.Print(static_cast<double>(numberOfCalls)/
-                    static_cast<double>(numberOfEvents));
-         std::this_thread::sleep_for(std::chrono::milliseconds(100));
-      }
-      pBar.Finish();
-      CppTools::PrintInfo("AnalyzerSingleTrack has finished processing simulated data");
-   };
- 
-   std::thread pBarThread(pBarCall);
- 
-   for (const auto& particle : inputYAMLSim["particles"])
-   {
-      for (const auto& magneticField : inputYAMLMain["magnetic_field_configurations"])
-      {
-         ThrContainer thrContainer;
-         for (const auto& pTRange : inputYAMLSim["pt_ranges"])
-         {
-            AnalyzeConfiguration(thrContainer, particle["id"].as<int>(), 
-                                 magneticField["name"].as<std::string>(), 
-                                 pTRange["name"].as<std::string>());
-         }
-         // writing the result
-         std::string outputFileName = "data/PostSim/" + runName + "/SingleTrack/" + 
-                                      particle["name"].as<std::string>();
-         if (magneticField["name"].as<std::string>() != "") 
-         {
-            outputFileName += "magf" + magneticField["name"].as<std::string>();
+            if (track.isParticleOrig)
+            {
+               histContainer.distrRecPTTOFw.Fill(pT, eventWeight*correctionTOFw);
+               histContainer.distrRecIdPTTOFw.
+                  Fill(pT, eventWeight*correctionTOFw*
+                       simM2Id.GetTOFwIdProb(particleId, pT, 2., 2.));
+            }
          }
-         outputFileName += ".root";
-         thrContainer.Write(outputFileName);
       }
    }
 
-   isProcessFinished = true;
-   pBarThread.join();
+   if (idPC2 == PART_ID::JUNK && idPC3 == PART_ID::JUNK && idEMCal == PART_ID::JUNK && 
+       idTOFe == PART_ID::JUNK && idTOFw == PART_ID::JUNK) return;
 
-   CppTools::PrintInfo("Merging output files into one");
-
-   std::string haddCommand = "hadd -f9 -j " + outputDir + "all.root ";
-   for (const auto& particle : inputYAMLSim["particles"])
+   switch (charge)
    {
-      haddCommand += outputDir + particle["name"].as<std::string>() + ".root ";
+      case 1:
+         positiveTracks.emplace_back(MASS_PION, track);
+         positiveTracks.back().idPC2 = idPC2;
+         positiveTracks.back().idPC3 = idPC3;
+         positiveTracks.back().idEMCal = idEMCal;
+         positiveTracks.back().idTOFe = idTOFe;
+         positiveTracks.back().idTOFw = idTOFw;
+         break;
+      case -1:
+         negativeTracks.emplace_back(MASS_KAON, track);
+         negativeTracks.back().idPC2 = idPC2;
+         negativeTracks.back().idPC3 = idPC3;
+         negativeTracks.back().idEMCal = idEMCal;
+         negativeTracks.back().idTOFe = idTOFe;
+         negativeTracks.back().idTOFw = idTOFw;
+         break;
    }
-   void(system(haddCommand.c_str()));
-
-   return 0;
 }
 
 TH2F *AnalyzeSimSingleTrack::GetHistogramFromFile(TFile& file, const std::string& histName)
@@ -1356,8 +1716,13 @@ void AnalyzeSimSingleTrack::SetAlphaReweight(const std::string& realDataInputFil
 
          alphaReweightOutputFile.Close();
          CppTools::PrintInfo("File " + alphaReweightOutputFileName + " was written");
+
+         alphaReweightDCe0Table = FlatHistTable(alphaReweightDCe0);
+         alphaReweightDCe1Table = FlatHistTable(alphaReweightDCe1);
+         alphaReweightDCw0Table = FlatHistTable(alphaReweightDCw0);
+         alphaReweightDCw1Table = FlatHistTable(alphaReweightDCw1);
       }
-      else if (doReweightPC1)
+      else if (doReweightAlpha)
       {
          CppTools::PrintInfo("Alpha reweight is now disabled due to insonsistent histogram axis");
          doReweightAlpha = false;
@@ -1662,10 +2027,16 @@ void AnalyzeSimSingleTrack::SetPC1Reweight(const std::string& realDataInputFileN
 
          reweightPC1OutputFile.Close();
          CppTools::PrintInfo("File " + reweightPC1OutputFileName + " was written");
+
+         reweightPC1ePosTable = FlatHistTable(reweightPC1ePos);
+         reweightPC1eNegTable = FlatHistTable(reweightPC1eNeg);
+         reweightPC1wPosTable = FlatHistTable(reweightPC1wPos);
+         reweightPC1wNegTable = FlatHistTable(reweightPC1wNeg);
       }
       else if (doReweightPC1)
       {
          CppTools::PrintInfo("PC1 reweight is now disabled due to insonsistent histogram axis");
+         doReweightPC1 = false;
       }
    }
    else
@@ -1718,321 +2089,7 @@ bool AnalyzeSimSingleTrack::CheckHistsAxis(const TH2F *hist1, const TH2F *hist2)
    return checkPassed;
 }
 
-ThrContainerCopy AnalyzeSimSingleTrack::ThrContainer::GetCopy()
-{
-   ThrContainerCopy copy;
-
-   copy.distrOrigPT = distrOrigPT.Get();
-   copy.distrRecPT = distrRecPT.Get();
-   copy.distrRecPTNoScaleReweight = distrRecPTNoScaleReweight.Get();
-   copy.distrOrigPTVsRecPT = distrOrigPTVsRecPT.Get();
-   copy.heatmapUnscaledDCe0 = heatmapUnscaledDCe0.Get();
-   copy.heatmapUnscaledDCe1 = heatmapUnscaledDCe1.Get();
-   copy.heatmapUnscaledDCw0 = heatmapUnscaledDCw0.Get();
-   copy.heatmapUnscaledDCw1 = heatmapUnscaledDCw1.Get();
-   copy.heatmapDCe0 = heatmapDCe0.Get();
-   copy.heatmapDCe1 = heatmapDCe1.Get();
-   copy.heatmapDCw0 = heatmapDCw0.Get();
-   copy.heatmapDCw1 = heatmapDCw1.Get();
-   copy.heatmapDCe0X1 = heatmapDCe0X1.Get();
-   copy.heatmapDCe1X1 = heatmapDCe1X1.Get();
-   copy.heatmapDCw0X1 = heatmapDCw0X1.Get();
-   copy.heatmapDCw1X1 = heatmapDCw1X1.Get();
-   copy.heatmapDCe0X2 = heatmapDCe0X2.Get();
-   copy.heatmapDCe1X2 = heatmapDCe1X2.Get();
-   copy.heatmapDCw0X2 = heatmapDCw0X2.Get();
-   copy.heatmapDCw1X2 = heatmapDCw1X2.Get();
-   copy.heatmapPC1e = heatmapPC1e.Get();
-   copy.heatmapPC1w = heatmapPC1w.Get();
-   copy.heatmapPC1ePos = heatmapPC1ePos.Get();
-   copy.heatmapPC1eNeg = heatmapPC1eNeg.Get();
-   copy.heatmapPC1wPos = heatmapPC1wPos.Get();
-   copy.heatmapPC1wNeg = heatmapPC1wNeg.Get();
-   copy.heatmapPC2 = heatmapPC2.Get();
-   copy.heatmapPC3e = heatmapPC3e.Get();
-   copy.heatmapPC3w = heatmapPC3w.Get();
-   copy.heatmapTOFe = heatmapTOFe.Get();
-   copy.heatmapTOFeHit = heatmapTOFeHit.Get();
-   copy.heatmapTOFw = heatmapTOFw.Get();
-   copy.distrRecPTPC2 = distrRecPTPC2.Get();
-   copy.distrRecPTPC3 = distrRecPTPC3.Get();
-   copy.distrRecPTTOFe = distrRecPTTOFe.Get();
-   copy.distrRecPTTOFw = distrRecPTTOFw.Get();
-   copy.distrRecIdPTTOFe = distrRecIdPTTOFe.Get();
-   copy.distrRecIdPTTOFw = distrRecIdPTTOFw.Get();
-   copy.distrBetaVsETOFe = distrBetaVsETOFe.Get();
-   copy.distrDPhiVsPTPC2Pos = distrDPhiVsPTPC2Pos.Get();
-   copy.distrDZVsPTPC2Pos = distrDZVsPTPC2Pos.Get();
-   copy.distrDPhiVsPTPC2Neg = distrDPhiVsPTPC2Neg.Get();
-   copy.distrDZVsPTPC2Neg = distrDZVsPTPC2Neg.Get();
-   copy.distrDPhiVsPTPC3ePos = distrDPhiVsPTPC3ePos.Get();
-   copy.distrDZVsPTPC3ePos = distrDZVsPTPC3ePos.Get();
-   copy.distrDPhiVsPTPC3eNeg = distrDPhiVsPTPC3eNeg.Get();
-   copy.distrDZVsPTPC3eNeg = distrDZVsPTPC3eNeg.Get();
-   copy.distrDPhiVsPTPC3wPos = distrDPhiVsPTPC3wPos.Get();
-   copy.distrDZVsPTPC3wPos = distrDZVsPTPC3wPos.Get();
-   copy.distrDPhiVsPTPC3wNeg = distrDPhiVsPTPC3wNeg.Get();
-   copy.distrDZVsPTPC3wNeg = distrDZVsPTPC3wNeg.Get();
-   copy.distrDPhiVsPTTOFePos = distrDPhiVsPTTOFePos.Get();
-   copy.distrDZVsPTTOFePos = distrDZVsPTTOFePos.Get();
-   copy.distrDPhiVsPTTOFeNeg = distrDPhiVsPTTOFeNeg.Get();
-   copy.distrDZVsPTTOFeNeg = distrDZVsPTTOFeNeg.Get();
-   copy.distrDPhiVsPTTOFwPos = distrDPhiVsPTTOFwPos.Get();
-   copy.distrDZVsPTTOFwPos = distrDZVsPTTOFwPos.Get();
-   copy.distrDPhiVsPTTOFwNeg = distrDPhiVsPTTOFwNeg.Get();
-   copy.distrDZVsPTTOFwNeg = distrDZVsPTTOFwNeg.Get();
-   copy.distrSDPhiVsPTPC2Pos = distrSDPhiVsPTPC2Pos.Get();
-   copy.distrSDZVsPTPC2Pos = distrSDZVsPTPC2Pos.Get();
-   copy.distrSDPhiVsPTPC2Neg = distrSDPhiVsPTPC2Neg.Get();
-   copy.distrSDZVsPTPC2Neg = distrSDZVsPTPC2Neg.Get();
-   copy.distrSDPhiVsPTPC3ePos = distrSDPhiVsPTPC3ePos.Get();
-   copy.distrSDZVsPTPC3ePos = distrSDZVsPTPC3ePos.Get();
-   copy.distrSDPhiVsPTPC3eNeg = distrSDPhiVsPTPC3eNeg.Get();
-   copy.distrSDZVsPTPC3eNeg = distrSDZVsPTPC3eNeg.Get();
-   copy.distrSDPhiVsPTPC3wPos = distrSDPhiVsPTPC3wPos.Get();
-   copy.distrSDZVsPTPC3wPos = distrSDZVsPTPC3wPos.Get();
-   copy.distrSDPhiVsPTPC3wNeg = distrSDPhiVsPTPC3wNeg.Get();
-   copy.distrSDZVsPTPC3wNeg = distrSDZVsPTPC3wNeg.Get();
-   copy.distrSDPhiVsPTTOFePos = distrSDPhiVsPTTOFePos.Get();
-   copy.distrSDZVsPTTOFePos = distrSDZVsPTTOFePos.Get();
-   copy.distrSDPhiVsPTTOFeNeg = distrSDPhiVsPTTOFeNeg.Get();
-   copy.distrSDZVsPTTOFeNeg = distrSDZVsPTTOFeNeg.Get();
-   copy.distrSDPhiVsPTTOFwPos = distrSDPhiVsPTTOFwPos.Get();
-   copy.distrSDZVsPTTOFwPos = distrSDZVsPTTOFwPos.Get();
-   copy.distrSDPhiVsPTTOFwNeg = distrSDPhiVsPTTOFwNeg.Get();
-   copy.distrSDZVsPTTOFwNeg = distrSDZVsPTTOFwNeg.Get();
-   copy.distrTTOFe = distrTTOFe.Get();
-   copy.distrTTOFw = distrTTOFw.Get();
-   copy.distrM2TOFePosCharge = distrM2TOFePosCharge.Get();
-   copy.distrM2TOFeNegCharge = distrM2TOFeNegCharge.Get();
-   copy.distrM2TOFwPosCharge = distrM2TOFwPosCharge.Get();
-   copy.distrM2TOFwNegCharge = distrM2TOFwNegCharge.Get();
-
-   // iterating over EMCal sectors
-   for (int i = 0; i < 4; i++)
-   {
-      copy.heatmapEMCale[i] = heatmapEMCale[i].Get();
-      copy.heatmapEMCalw[i] = heatmapEMCalw[i].Get();
-      copy.heatmapEMCaleHit[i] = heatmapEMCaleHit[i].Get();
-      copy.heatmapEMCalwHit[i] = heatmapEMCalwHit[i].Get();
-      copy.distrRecPTEMCale[i] = distrRecPTEMCale[i].Get();
-      copy.distrRecPTEMCalw[i] = distrRecPTEMCalw[i].Get();
-      copy.distrRecIdPTEMCalw[i] = distrRecIdPTEMCalw[i].Get();
-      copy.distrECoreVsPTEMCale[i] = distrECoreVsPTEMCale[i].Get();
-      copy.distrECoreVsPTEMCalw[i] = distrECoreVsPTEMCalw[i].Get();
-      copy.distrECoreVsPTEMCaleOrig[i] = distrECoreVsPTEMCaleOrig[i].Get();
-      copy.distrECoreVsPTEMCalwOrig[i] = distrECoreVsPTEMCalwOrig[i].Get();
-      copy.distrProbVsPTEMCale[i] = distrProbVsPTEMCale[i].Get();
-      copy.distrProbVsPTEMCalw[i] = distrProbVsPTEMCalw[i].Get();
-      copy.distrDPhiVsPTEMCalePos[i] = distrDPhiVsPTEMCalePos[i].Get();
-      copy.distrDZVsPTEMCalePos[i] = distrDZVsPTEMCalePos[i].Get();
-      copy.distrDPhiVsPTEMCaleNeg[i] = distrDPhiVsPTEMCaleNeg[i].Get();
-      copy.distrDZVsPTEMCaleNeg[i] = distrDZVsPTEMCaleNeg[i].Get();
-      copy.distrDPhiVsPTEMCalwPos[i] = distrDPhiVsPTEMCalwPos[i].Get();
-      copy.distrDZVsPTEMCalwPos[i] = distrDZVsPTEMCalwPos[i].Get();
-      copy.distrDPhiVsPTEMCalwNeg[i] = distrDPhiVsPTEMCalwNeg[i].Get();
-      copy.distrDZVsPTEMCalwNeg[i] = distrDZVsPTEMCalwNeg[i].Get();
-      copy.distrSDPhiVsPTEMCalePos[i] = distrSDPhiVsPTEMCalePos[i].Get();
-      copy.distrSDZVsPTEMCalePos[i] = distrSDZVsPTEMCalePos[i].Get();
-      copy.distrSDPhiVsPTEMCaleNeg[i] = distrSDPhiVsPTEMCaleNeg[i].Get();
-      copy.distrSDZVsPTEMCaleNeg[i] = distrSDZVsPTEMCaleNeg[i].Get();
-      copy.distrSDPhiVsPTEMCalwPos[i] = distrSDPhiVsPTEMCalwPos[i].Get();
-      copy.distrSDZVsPTEMCalwPos[i] = distrSDZVsPTEMCalwPos[i].Get();
-      copy.distrSDPhiVsPTEMCalwNeg[i] = distrSDPhiVsPTEMCalwNeg[i].Get();
-      copy.distrSDZVsPTEMCalwNeg[i] = distrSDZVsPTEMCalwNeg[i].Get();
-      copy.distrTEMCale[i] = distrTEMCale[i].Get();
-      copy.distrTEMCalw[i] = distrTEMCalw[i].Get();
-      copy.distrM2EMCalePosCharge[i] = distrM2EMCalePosCharge[i].Get();
-      copy.distrM2EMCaleNegCharge[i] = distrM2EMCaleNegCharge[i].Get();
-      copy.distrM2EMCalwPosCharge[i] = distrM2EMCalwPosCharge[i].Get();
-      copy.distrM2EMCalwNegCharge[i] = distrM2EMCalwNegCharge[i].Get();
-   }
-
-   // iterating over PBSc EMCale sectors
-   for (int i = 0; i < 2; i++)
-   {
-      copy.distrRecIdPTEMCale[i] = distrRecIdPTEMCale[i].Get();
-   }
-
-   copy.distrMInvNoPID = distrMInvNoPID.Get();
-   copy.distrMInvNoPIDNoGhost = distrMInvNoPIDNoGhost.Get();
-   return copy;
-}
-
-void AnalyzeSimSingleTrack::ThrContainer::Write(const std::string& outputFileName)
-{
-   TFile outputFile(outputFileName.c_str(), "RECREATE");
-   outputFile.SetCompressionLevel(6);
-   outputFile.cd();
-
-   static_cast<std::shared_ptr<TH1D>>(distrOrigPT.Merge())->Write();
-   static_cast<std::shared_ptr<TH1D>>(distrRecPT.Merge())->Write();
-   static_cast<std::shared_ptr<TH1D>>(distrRecPTNoScaleReweight.Merge())->Write();
-   static_cast<std::shared_ptr<TH2D>>(distrOrigPTVsRecPT.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(heatmapUnscaledDCe0.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(heatmapUnscaledDCe1.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(heatmapUnscaledDCw0.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(heatmapUnscaledDCw1.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(heatmapDCe0.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(heatmapDCe1.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(heatmapDCw0.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(heatmapDCw1.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(heatmapDCe0X1.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(heatmapDCe1X1.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(heatmapDCw0X1.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(heatmapDCw1X1.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(heatmapDCe0X2.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(heatmapDCe1X2.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(heatmapDCw0X2.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(heatmapDCw1X2.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(heatmapPC1e.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(heatmapPC1w.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(heatmapPC1ePos.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(heatmapPC1eNeg.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(heatmapPC1wPos.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(heatmapPC1wNeg.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(heatmapPC2.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(heatmapPC3e.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(heatmapPC3w.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(heatmapTOFe.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(heatmapTOFeHit.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(heatmapTOFw.Merge())->Write();
-   static_cast<std::shared_ptr<TH1D>>(distrRecPTPC2.Merge())->Write();
-   static_cast<std::shared_ptr<TH1D>>(distrRecPTPC3.Merge())->Write();
-   static_cast<std::shared_ptr<TH1D>>(distrRecPTTOFe.Merge())->Write();
-   static_cast<std::shared_ptr<TH1D>>(distrRecPTTOFw.Merge())->Write();
-   static_cast<std::shared_ptr<TH1D>>(distrRecIdPTTOFe.Merge())->Write();
-   static_cast<std::shared_ptr<TH1D>>(distrRecIdPTTOFw.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrBetaVsETOFe.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrTTOFe.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrTTOFw.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrM2TOFePosCharge.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrM2TOFeNegCharge.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrM2TOFwPosCharge.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrM2TOFwNegCharge.Merge())->Write();
-
-   // iterating over EMCal sectors
-   for (int i = 0; i < 4; i++)
-   {
-      static_cast<std::shared_ptr<TH2F>>(heatmapEMCale[i].Merge())->Write();
-      static_cast<std::shared_ptr<TH2F>>(heatmapEMCalw[i].Merge())->Write();
-      static_cast<std::shared_ptr<TH2F>>(heatmapEMCaleHit[i].Merge())->Write();
-      static_cast<std::shared_ptr<TH2F>>(heatmapEMCalwHit[i].Merge())->Write();
-      static_cast<std::shared_ptr<TH1D>>(distrRecPTEMCale[i].Merge())->Write();
-      static_cast<std::shared_ptr<TH1D>>(distrRecPTEMCalw[i].Merge())->Write();
-      static_cast<std::shared_ptr<TH1D>>(distrRecIdPTEMCalw[i].Merge())->Write();
-      static_cast<std::shared_ptr<TH2F>>(distrECoreVsPTEMCale[i].Merge())->Write();
-      static_cast<std::shared_ptr<TH2F>>(distrECoreVsPTEMCalw[i].Merge())->Write();
-      static_cast<std::shared_ptr<TH2F>>(distrECoreVsPTEMCaleOrig[i].Merge())->Write();
-      static_cast<std::shared_ptr<TH2F>>(distrECoreVsPTEMCalwOrig[i].Merge())->Write();
-      static_cast<std::shared_ptr<TH2F>>(distrProbVsPTEMCale[i].Merge())->Write();
-      static_cast<std::shared_ptr<TH2F>>(distrProbVsPTEMCalw[i].Merge())->Write();
-      static_cast<std::shared_ptr<TH2F>>(distrTEMCale[i].Merge())->Write();
-      static_cast<std::shared_ptr<TH2F>>(distrTEMCalw[i].Merge())->Write();
-      static_cast<std::shared_ptr<TH2F>>(distrM2EMCalePosCharge[i].Merge())->Write();
-      static_cast<std::shared_ptr<TH2F>>(distrM2EMCaleNegCharge[i].Merge())->Write();
-      static_cast<std::shared_ptr<TH2F>>(distrM2EMCalwPosCharge[i].Merge())->Write();
-      static_cast<std::shared_ptr<TH2F>>(distrM2EMCalwNegCharge[i].Merge())->Write();
-   }
-
-   // iterating over PbSc EMCale sectors
-   for (int i = 0; i < 2; i++)
-   {
-      static_cast<std::shared_ptr<TH1D>>(distrRecIdPTEMCale[i].Merge())->Write();
-   }
-
-   static_cast<std::shared_ptr<TH2F>>(distrMInvNoPID.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrMInvNoPIDNoGhost.Merge())->Write();
-
-   outputFile.mkdir("dphi");
-   outputFile.cd("dphi");
-
-   static_cast<std::shared_ptr<TH2F>>(distrDPhiVsPTPC2Pos.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrDPhiVsPTPC2Neg.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrDPhiVsPTPC3ePos.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrDPhiVsPTPC3eNeg.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrDPhiVsPTPC3wPos.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrDPhiVsPTPC3wNeg.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrDPhiVsPTTOFePos.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrDPhiVsPTTOFeNeg.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrDPhiVsPTTOFwPos.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrDPhiVsPTTOFwNeg.Merge())->Write();
-
-   for (int i = 0; i < 4; i++)
-   {
-      static_cast<std::shared_ptr<TH2F>>(distrDPhiVsPTEMCalePos[i].Merge())->Write();
-      static_cast<std::shared_ptr<TH2F>>(distrDPhiVsPTEMCaleNeg[i].Merge())->Write();
-      static_cast<std::shared_ptr<TH2F>>(distrDPhiVsPTEMCalwPos[i].Merge())->Write();
-      static_cast<std::shared_ptr<TH2F>>(distrDPhiVsPTEMCalwNeg[i].Merge())->Write();
-   }
-
-   outputFile.mkdir("dz");
-   outputFile.cd("dz");
-
-   static_cast<std::shared_ptr<TH2F>>(distrDZVsPTPC2Pos.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrDZVsPTPC2Neg.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrDZVsPTPC3ePos.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrDZVsPTPC3eNeg.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrDZVsPTPC3wPos.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrDZVsPTPC3wNeg.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrDZVsPTTOFePos.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrDZVsPTTOFeNeg.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrDZVsPTTOFwPos.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrDZVsPTTOFwNeg.Merge())->Write();
-
-   for (int i = 0; i < 4; i++)
-   {
-      static_cast<std::shared_ptr<TH2F>>(distrDZVsPTEMCalePos[i].Merge())->Write();
-      static_cast<std::shared_ptr<TH2F>>(distrDZVsPTEMCaleNeg[i].Merge())->Write();
-      static_cast<std::shared_ptr<TH2F>>(distrDZVsPTEMCalwPos[i].Merge())->Write();
-      static_cast<std::shared_ptr<TH2F>>(distrDZVsPTEMCalwNeg[i].Merge())->Write();
-   }
-
-   outputFile.mkdir("sdphi");
-   outputFile.cd("sdphi");
-
-   static_cast<std::shared_ptr<TH2F>>(distrSDPhiVsPTPC2Pos.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrSDPhiVsPTPC2Neg.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrSDPhiVsPTPC3ePos.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrSDPhiVsPTPC3eNeg.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrSDPhiVsPTPC3wPos.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrSDPhiVsPTPC3wNeg.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrSDPhiVsPTTOFePos.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrSDPhiVsPTTOFeNeg.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrSDPhiVsPTTOFwPos.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrSDPhiVsPTTOFwNeg.Merge())->Write();
-
-   for (int i = 0; i < 4; i++)
-   {
-      static_cast<std::shared_ptr<TH2F>>(distrSDPhiVsPTEMCalePos[i].Merge())->Write();
-      static_cast<std::shared_ptr<TH2F>>(distrSDPhiVsPTEMCaleNeg[i].Merge())->Write();
-      static_cast<std::shared_ptr<TH2F>>(distrSDPhiVsPTEMCalwPos[i].Merge())->Write();
-      static_cast<std::shared_ptr<TH2F>>(distrSDPhiVsPTEMCalwNeg[i].Merge())->Write();
-   }
-
-   outputFile.mkdir("sdz");
-   outputFile.cd("sdz");
-
-   static_cast<std::shared_ptr<TH2F>>(distrSDZVsPTPC2Pos.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrSDZVsPTPC2Neg.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrSDZVsPTPC3ePos.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrSDZVsPTPC3eNeg.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrSDZVsPTPC3wPos.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrSDZVsPTPC3wNeg.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrSDZVsPTTOFePos.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrSDZVsPTTOFeNeg.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrSDZVsPTTOFwPos.Merge())->Write();
-   static_cast<std::shared_ptr<TH2F>>(distrSDZVsPTTOFwNeg.Merge())->Write();
-
-   for (int i = 0; i < 4; i++)
-   {
-      static_cast<std::shared_ptr<TH2F>>(distrSDZVsPTEMCalePos[i].Merge())->Write();
-      static_cast<std::shared_ptr<TH2F>>(distrSDZVsPTEMCaleNeg[i].Merge())->Write();
-      static_cast<std::shared_ptr<TH2F>>(distrSDZVsPTEMCalwPos[i].Merge())->Write();
-      static_cast<std::shared_ptr<TH2F>>(distrSDZVsPTEMCalwNeg[i].Merge())->Write();
-   }
-
-   outputFile.Close();
-}
+AnalyzeSimSingleTrack::HistContainer::HistContainer(const std::string& detectorsConfiguration) :
+   registry(detectorsConfiguration) {}
 
 #endif /* ANALYZE_SIM_SINGLE_TRACK_CPP */
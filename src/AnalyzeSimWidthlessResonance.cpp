@@ -16,18 +16,23 @@
 // being accessed only via the scope resolution operator in this file
 using namespace AnalyzeSimWidthlessResonance;
 
-void AnalyzeSimWidthlessResonance::AnalyzeConfiguration(ThrContainer &thrContainer, 
-                                                     const std::string& particleName, 
-                                                     const int daughter1Id,
-                                                     const int daughter2Id,
-                                                     const std::string& magneticFieldName, 
-                                                     const std::string &pTRangeName)
+void AnalyzeSimWidthlessResonance::SetConfiguration(Configuration &configuration, 
+                                                    ThrContainer &thrContainer, 
+                                                    const std::string& particleName, 
+                                                    const int daughter1Id,
+                                                    const int daughter2Id,
+                                                    const std::string& magneticFieldName, 
+                                                    const std::string &pTRangeName)
 { 
    std::string simInputFileName = "data/SimTrees/" + runName + "/WidthlessResonance/" + 
                                   particleName + "_" + ParticleMap::name[daughter1Id] + 
                                   ParticleMap::name[daughter2Id] + "_" + 
                                   pTRangeName + magneticFieldName + ".root";
 
+   configuration.simInputFileName = simInputFileName;
+   configuration.daughter1Id = daughter1Id;
+   configuration.daughter2Id = daughter2Id;
+
    TFile simInputFile = TFile(simInputFileName.c_str());
 
    TH1F *origPTHist = static_cast<TH1F *>(simInputFile.Get("orig_pt"));
@@ -90,195 +95,243 @@ void AnalyzeSimWidthlessResonance::AnalyzeConfiguration(ThrContainer &thrContain
       weightFunc->SetParameters(0., -1.);
    }
 
+   configuration.eventNormWeight = eventNormWeight;
+
+   // events that do not pass the event level cuts are taken from the sidecar index 
+   // (if it exists) so that they are never read from the simulated tree
+   SimTreeIndex simTreeIndex;
+   configuration.isIndexed = simTreeIndex.Load(simInputFileName);
+   if (configuration.isIndexed)
+   {
+      std::shared_ptr<TH1F> distrOrigPT = thrContainer.distrOrigPT->Get();
+
+      for (unsigned long i = 0; i < simTreeIndex.GetSize(); i++)
+      {
+         if (fabs(simTreeIndex.bbcz(i)) <= 30. && simTreeIndex.nch(i) > 0)
+         {
+            configuration.selectedEntries.push_back(simTreeIndex.entry(i));
+            continue;
+         }
+
+         const double origPT = simTreeIndex.origPT(i);
+         distrOrigPT->Fill(origPT, weightFunc->Eval(origPT)/eventNormWeight);
+      }
+      progress.Add(ProgressMonitor::EVENTS, 
+                   simTreeIndex.GetSize() - configuration.selectedEntries.size());
+   }
+
+   configuration.weightFunc = std::move(weightFunc);
+}
+
+void AnalyzeSimWidthlessResonance::ProcessTask(SimTreeReader &simCNT, ThrContainer &thrContainer, 
+                                               const Configuration &configuration)
+{
+   const int daughter1Id = configuration.daughter1Id;
+   const int daughter2Id = configuration.daughter2Id;
+   const double eventNormWeight = configuration.eventNormWeight;
+   const std::unique_ptr<TF1> &weightFunc = configuration.weightFunc;
+
    const double daughter1Mass = ParticleMap::mass[daughter1Id];
    const double daughter2Mass = ParticleMap::mass[daughter2Id];
 
-   ROOT::TTreeProcessorMT tp(simInputFileName.c_str());
-  
-   auto ProcessMP = [&](TTreeReader &reader)
-   { 
-      ThrContainerCopy histContainer = thrContainer.GetCopy();
+   ThrContainerCopy histContainer = thrContainer.GetCopy();
 
-      SimTreeReader simCNT(reader);
+   // tracks and buffers for the batched evaluation of pair kinematics 
+   // are reused between the events so that they are not reallocated for every event
+   std::vector<ChargedTrack> positiveTracks;
+   std::vector<ChargedTrack> negativeTracks;
+   TrackBlock negativeTracksBlock;
+   std::vector<double> pairsMInv;
+   std::vector<double> pairsPT;
 
-      while (reader.Next())
-      { 
-         numberOfCalls++;
-         const double origPT = sqrt(pow(simCNT.mom_orig(0), 2) + pow(simCNT.mom_orig(1), 2));
+   while (simCNT.Next())
+   { 
+      const SimEventSnapshot& simEvent = simCNT.Snapshot();
+      progress.Add(ProgressMonitor::EVENTS);
+      progress.Add(ProgressMonitor::TRACKS, simEvent.nch);
+
+      const double origPT = sqrt(pow(simEvent.mom_orig[0], 2) + pow(simEvent.mom_orig[1], 2));
 
-         double eventWeight;
+      double eventWeight;
  
-         eventWeight = weightFunc->Eval(origPT)/eventNormWeight;
+      eventWeight = weightFunc->Eval(origPT)/eventNormWeight;
  
-         histContainer.distrOrigPT->Fill(origPT, eventWeight);
+      histContainer.distrOrigPT->Fill(origPT, eventWeight);
  
-         const double bbcz = simCNT.bbcz();
-         if (fabs(bbcz) > 30.) continue;
+      const double bbcz = simEvent.bbcz;
+      if (fabs(bbcz) > 30.) continue;
 
-         std::vector<ChargedTrack> positiveTracks;
-         std::vector<ChargedTrack> negativeTracks;
+      positiveTracks.clear();
+      negativeTracks.clear();
 
-         for(int i = 0; i < simCNT.nch(); i++)
-         {
-            const double the0 = simCNT.the0(i);
-            const double pT = (simCNT.mom(i))*sin(the0);
+      for(int i = 0; i < simEvent.nch; i++)
+      {
+         const double the0 = simEvent.the0[i];
+         const double pT = (simEvent.mom[i])*sin(the0);
 
-            if (pT < pTMin || pT > pTMax) continue;
-            if (IsQualityCut(simCNT.qual(i))) continue;
+         if (pT < pTMin || pT > pTMax) continue;
+         if (IsQualityCut(simEvent.qual[i])) continue;
 
-            const int charge = simCNT.charge(i);
-            if (charge != -1 && charge != 1) continue;
+         const int charge = simEvent.charge[i];
+         if (charge != -1 && charge != 1) continue;
 
-            const int dcarm = simCNT.dcarm(i);
+         const int dcarm = simEvent.dcarm[i];
 
-            const double zed = simCNT.zed(i);
-            if (fabs(zed) > 75. && fabs(zed) < 3.) continue;
+         const double zed = simEvent.zed[i];
+         if (fabs(zed) > 75. && fabs(zed) < 3.) continue;
 
-            if (!(fabs(the0) < 100. &&
-               ((bbcz > 0. && ((bbcz - 250.*tan(the0 - 3.1416/2.)) > 2. ||
-               (bbcz - 200.*tan(the0 - 3.1416/2)) < -2.)) ||
-               (bbcz < 0. && ((bbcz - 250.*tan(the0 - 3.1416/2.))< -2. ||
-               (bbcz - 200.*tan(the0 - 3.1416/2)) > 2.))))) continue;
+         if (!(fabs(the0) < 100. &&
+            ((bbcz > 0. && ((bbcz - 250.*tan(the0 - 3.1416/2.)) > 2. ||
+            (bbcz - 200.*tan(the0 - 3.1416/2)) < -2.)) ||
+            (bbcz < 0. && ((bbcz - 250.*tan(the0 - 3.1416/2.))< -2. ||
+            (bbcz - 200.*tan(the0 - 3.1416/2)) > 2.))))) continue;
  
-            //end of basic cuts
+         //end of basic cuts
 
-            const double alpha = simCNT.alpha(i);
-            const double phi = simCNT.phi(i);
-            double board;
+         const double alpha = simEvent.alpha[i];
+         const double phi = simEvent.phi[i];
+         double board;
 
-            if (phi > M_PI/2.) board = ((3.72402 - phi + 0.008047*cos(phi + 0.87851))/0.01963496);
-            else board = ((0.573231 + phi - 0.0046 * cos(phi + 0.05721))/0.01963496);
+         if (phi > M_PI/2.) board = ((3.72402 - phi + 0.008047*cos(phi + 0.87851))/0.01963496);
+         else board = ((0.573231 + phi - 0.0046 * cos(phi + 0.05721))/0.01963496);
 
-            if (dmCutter.IsDeadDC(dcarm, zed, board, alpha)) continue;
+         if (dmCutter.IsDeadDC(dcarm, zed, board, alpha)) continue;
 
-            double ppc1phi = atan2(simCNT.ppc1y(i), simCNT.ppc1x(i));
-            if (dcarm == 0 && ppc1phi < 0) ppc1phi += 2.*M_PI;
-            if (dmCutter.IsDeadPC1(dcarm, simCNT.ppc1z(i), ppc1phi)) continue;
+         double ppc1phi = atan2(simEvent.ppc1y[i], simEvent.ppc1x[i]);
+         if (dcarm == 0 && ppc1phi < 0) ppc1phi += 2.*M_PI;
+         if (dmCutter.IsDeadPC1(dcarm, simEvent.ppc1z[i], ppc1phi)) continue;
 
-            histContainer.distrOrigPTVsRecPT->Fill(origPT, pT, eventWeight);
+         histContainer.distrOrigPTVsRecPT->Fill(origPT, pT, eventWeight);
 
-            int idPC2 = PART_ID::JUNK;
-            int idPC3 = PART_ID::JUNK;
-            int idEMCal = PART_ID::JUNK;
-            int idTOFe = PART_ID::JUNK;
-            int idTOFw = PART_ID::JUNK;
+         int idPC2 = PART_ID::JUNK;
+         int idPC3 = PART_ID::JUNK;
+         int idEMCal = PART_ID::JUNK;
+         int idTOFe = PART_ID::JUNK;
+         int idTOFw = PART_ID::JUNK;
 
-            if (IsHit(simCNT.pc2dphi(i)))
-            {
-               const double sdphi = simSigmRes.PC2SDPhi(simCNT.pc2dphi(i), pT, charge);
-               const double sdz = simSigmRes.PC2SDZ(simCNT.pc2dz(i), pT, charge);
-               const double pc2phi = atan2(simCNT.ppc2y(i), simCNT.ppc2x(i));
-
-               if (IsMatch(sdphi, sdz) && !dmCutter.IsDeadPC2(simCNT.ppc2z(i), pc2phi))
-               {
-                  idPC2 = PART_ID::NONE;
-               }
-            }
+         if (IsHit(simEvent.pc2dphi[i]))
+         {
+            const double sdphi = simSigmRes.PC2SDPhi(simEvent.pc2dphi[i], pT, charge);
+            const double sdz = simSigmRes.PC2SDZ(simEvent.pc2dz[i], pT, charge);
+            const double pc2phi = atan2(simEvent.ppc2y[i], simEvent.ppc2x[i]);
 
-            if (IsHit(simCNT.pc3dphi(i)))
+            if (IsMatch(sdphi, sdz) && !dmCutter.IsDeadPC2(simEvent.ppc2z[i], pc2phi))
             {
-               const double sdphi = simSigmRes.PC3SDPhi(simCNT.pc3dphi(i), pT, charge, dcarm);
-               const double sdz = simSigmRes.PC3SDZ(simCNT.pc3dz(i), pT, charge, dcarm);
+               idPC2 = PART_ID::NONE;
+            }
+         }
 
-               double pc3phi = atan2(simCNT.ppc3y(i), simCNT.ppc3x(i));
-               if (dcarm == 0 && pc3phi < 0) pc3phi += 2.*M_PI;
+         if (IsHit(simEvent.pc3dphi[i]))
+         {
+            const double sdphi = simSigmRes.PC3SDPhi(simEvent.pc3dphi[i], pT, charge, dcarm);
+            const double sdz = simSigmRes.PC3SDZ(simEvent.pc3dz[i], pT, charge, dcarm);
 
-               if (IsMatch(sdphi, sdz) && !dmCutter.IsDeadPC3(dcarm, simCNT.ppc2z(i), pc3phi))
-               {
-                  idPC3 = PART_ID::NONE;
-               }
-            }
+            double pc3phi = atan2(simEvent.ppc3y[i], simEvent.ppc3x[i]);
+            if (dcarm == 0 && pc3phi < 0) pc3phi += 2.*M_PI;
 
-            if (IsHit(simCNT.emcdz(i)))
+            if (IsMatch(sdphi, sdz) && !dmCutter.IsDeadPC3(dcarm, simEvent.ppc2z[i], pc3phi))
             {
-               const double sdphi = 
-                  simSigmRes.EMCalSDPhi(simCNT.emcdphi(i), pT, charge, dcarm, simCNT.sect(i));
-               const double sdz = 
-                  simSigmRes.EMCalSDZ(simCNT.emcdz(i), pT, charge, dcarm, simCNT.sect(i));
-
-               bool isCutByECore;
-               if (dcarm == 0 && simCNT.sect(i) < 2) isCutByECore = (simCNT.ecore(i) < 0.35);
-               else isCutByECore = (simCNT.ecore(i) < 0.25); // PbSc
-
-               if (IsMatch(sdphi, sdz) && !isCutByECore && 
-                   !dmCutter.IsDeadEMCal(dcarm, simCNT.sect(i), simCNT.ysect(i), simCNT.zsect(i)))
-               {
-                  idEMCal = PART_ID::NONE;
-               }
+               idPC3 = PART_ID::NONE;
             }
+         }
 
-            if (IsHit(simCNT.tofdz(i)))
+         if (IsHit(simEvent.emcdz[i]))
+         {
+            const double sdphi = 
+               simSigmRes.EMCalSDPhi(simEvent.emcdphi[i], pT, charge, dcarm, simEvent.sect[i]);
+            const double sdz = 
+               simSigmRes.EMCalSDZ(simEvent.emcdz[i], pT, charge, dcarm, simEvent.sect[i]);
+
+            bool isCutByECore;
+            if (dcarm == 0 && simEvent.sect[i] < 2) isCutByECore = (simEvent.ecore[i] < 0.35);
+            else isCutByECore = (simEvent.ecore[i] < 0.25); // PbSc
+
+            if (IsMatch(sdphi, sdz) && !isCutByECore && 
+                !dmCutter.IsDeadEMCal(dcarm, simEvent.sect[i], simEvent.ysect[i], simEvent.zsect[i]))
             {
-               const double sdphi = simSigmRes.TOFeSDPhi(simCNT.tofdphi(i), pT, charge);
-               const double sdz = simSigmRes.TOFeSDZ(simCNT.tofdz(i), pT, charge);
-
-               const double beta = simCNT.pltof(i)/simCNT.ttof(i)/29.9792;
-               const double eloss = 0.0005*pow(beta, -2.5);
-
-               // slats are organized in 10 lines of 96 we define as chambers
-               const int chamber = simCNT.slat(i)/96;
-               // slat number for the current chamber
-               const int slat = simCNT.slat(i) % 96;
-
-               if (simCNT.etof(i) > eloss && IsMatch(sdphi, sdz) && 
-                   !dmCutter.IsDeadTOFe(chamber, slat))
-               {
-                  idTOFe = PART_ID::NONE;
-               }
+               idEMCal = PART_ID::NONE;
             }
-            else if (IsHit(simCNT.tofwdz(i)))
+         }
+
+         if (IsHit(simEvent.tofdz[i]))
+         {
+            const double sdphi = simSigmRes.TOFeSDPhi(simEvent.tofdphi[i], pT, charge);
+            const double sdz = simSigmRes.TOFeSDZ(simEvent.tofdz[i], pT, charge);
+
+            const double beta = simEvent.pltof[i]/simEvent.ttof[i]/29.9792;
+            const double eloss = 0.0005*pow(beta, -2.5);
+
+            // slats are organized in 10 lines of 96 we define as chambers
+            const int chamber = simEvent.slat[i]/96;
+            // slat number for the current chamber
+            const int slat = simEvent.slat[i] % 96;
+
+            if (simEvent.etof[i] > eloss && IsMatch(sdphi, sdz) && 
+                !dmCutter.IsDeadTOFe(chamber, slat))
             {
-               const double sdphi = simSigmRes.TOFwSDPhi(simCNT.tofwdphi(i), pT, charge);
-               const double sdz = simSigmRes.TOFwSDZ(simCNT.tofwdz(i), pT, charge);
-
-               // strips are organized in 8 lines of 64 we define as chambers
-               const int chamber = simCNT.striptofw(i)/64;
-               // strip number for the current chamber
-               const int strip = simCNT.striptofw(i) % 64;
-
-               if (IsMatch(sdphi, sdz) && !dmCutter.IsDeadTOFw(chamber, strip))
-               {
-                  idTOFw = PART_ID::NONE;
-               }
+               idTOFe = PART_ID::NONE;
             }
+         }
+         else if (IsHit(simEvent.tofwdz[i]))
+         {
+            const double sdphi = simSigmRes.TOFwSDPhi(simEvent.tofwdphi[i], pT, charge);
+            const double sdz = simSigmRes.TOFwSDZ(simEvent.tofwdz[i], pT, charge);
+
+            // strips are organized in 8 lines of 64 we define as chambers
+            const int chamber = simEvent.striptofw[i]/64;
+            // strip number for the current chamber
+            const int strip = simEvent.striptofw[i] % 64;
 
-            switch (charge)
+            if (IsMatch(sdphi, sdz) && !dmCutter.IsDeadTOFw(chamber, strip))
             {
-               case 1:
-                  positiveTracks.emplace_back(daughter1Mass, simCNT, i);
-                  positiveTracks.back().idPC2 = idPC2;
-                  positiveTracks.back().idPC3 = idPC3;
-                  positiveTracks.back().idEMCal = idEMCal;
-                  positiveTracks.back().idTOFe = idTOFe;
-                  positiveTracks.back().idTOFw = idTOFw;
-                  break;
-               case -1:
-                  negativeTracks.emplace_back(daughter2Mass, simCNT, i);
-                  negativeTracks.back().idPC2 = idPC2;
-                  negativeTracks.back().idPC3 = idPC3;
-                  negativeTracks.back().idEMCal = idEMCal;
-                  negativeTracks.back().idTOFe = idTOFe;
-                  negativeTracks.back().idTOFw = idTOFw;
-                  break;
+               idTOFw = PART_ID::NONE;
             }
          }
 
-         for (const auto& posTrack : positiveTracks)
+         switch (charge)
          {
-            for (const auto& negTrack : negativeTracks)
-            {
-               if (IsOneArmCut(posTrack, negTrack) || IsGhostCut(posTrack, negTrack)) continue;
+            case 1:
+               positiveTracks.emplace_back(daughter1Mass, simEvent, i);
+               positiveTracks.back().idPC2 = idPC2;
+               positiveTracks.back().idPC3 = idPC3;
+               positiveTracks.back().idEMCal = idEMCal;
+               positiveTracks.back().idTOFe = idTOFe;
+               positiveTracks.back().idTOFw = idTOFw;
+               break;
+            case -1:
+               negativeTracks.emplace_back(daughter2Mass, simEvent, i);
+               negativeTracks.back().idPC2 = idPC2;
+               negativeTracks.back().idPC3 = idPC3;
+               negativeTracks.back().idEMCal = idEMCal;
+               negativeTracks.back().idTOFe = idTOFe;
+               negativeTracks.back().idTOFw = idTOFw;
+               break;
+         }
+      }
 
-               const double mInv = GetPairMass(posTrack, negTrack);
-               const double pT = GetPairPT(posTrack, negTrack);
+      negativeTracksBlock.Clear();
+      for (const auto& negTrack : negativeTracks) negativeTracksBlock.Add(negTrack);
 
-               thrContainer.distrMInvNoPID->Fill(pT, mInv, eventWeight);
-            }
+      pairsMInv.resize(negativeTracks.size());
+      pairsPT.resize(negativeTracks.size());
+
+      for (const auto& posTrack : positiveTracks)
+      {
+         // kinematics of all pairs of the positive track are evaluated in one batch; 
+         // pairs are not skipped by kinematic bounds (see GetPartnersRange) since the pairs 
+         // outside of the axes fill the overflow bins and the number of entries of the 
+         // projections of M_inv distribution that are used to estimate gaussian broadening
+         GetPairsMassPT(posTrack, negativeTracksBlock, pairsMInv.data(), pairsPT.data());
+
+         for (unsigned long i = 0; i < negativeTracks.size(); i++)
+         {
+            const ChargedTrack& negTrack = negativeTracks[i];
+            if (IsOneArmCut(posTrack, negTrack) || IsGhostCut(posTrack, negTrack)) continue;
+
+            thrContainer.distrMInvNoPID->Fill(pairsPT[i], pairsMInv[i], eventWeight);
          }
       }
-   };
-
-   tp.Process(ProcessMP);
+   }
 }
 
 int main(int argc, char **argv)
@@ -306,6 +359,14 @@ int main(int argc, char **argv)
    inputYAMLMain.OpenFile("input/" + runName + "/main.yaml");
    inputYAMLMain.CheckStatus("main");
 
+   // parameters of reading simulated trees are optional; ROOT defaults are used otherwise
+   treeCacheSizeFactor = inputYAMLMain["tree_cache_size_factor"].as<double>(1.);
+   treeCacheLearnEntries = inputYAMLMain["tree_cache_learn_entries"].as<int>(100);
+   asyncPrefetching = inputYAMLMain["async_prefetching"].as<bool>(false);
+   prefetchNextFile = inputYAMLMain["prefetch_next_file"].as<bool>(true);
+
+   SimTreeReader::ConfigureIO(treeCacheSizeFactor, treeCacheLearnEntries, asyncPrefetching);
+
    inputYAMLSimSingleTrack.OpenFile("input/" + runName + "/single_track_sim.yaml");
    inputYAMLSimSingleTrack.CheckStatus("single_track_sim");
  
@@ -346,10 +407,10 @@ int main(int argc, char **argv)
             magneticField["name"].as<std::string>() + ".root";
 
          CppTools::CheckInputFile(simInputFileName);
+         simInputFileNames.push_back(simInputFileName);
 
-         unsigned long currentConfigurationNumberOfEvents = static_cast<unsigned long>
-            ((static_cast<TTree *>(TFile::Open(simInputFileName.c_str())->
-                                   Get("Tree"))->GetEntries()));
+         unsigned long currentConfigurationNumberOfEvents = 
+            SimTreeIndex::GetNumberOfEntries(simInputFileName);
          if (currentConfigurationNumberOfEvents <= 0)
          {
             CppTools::PrintError("Number of events is equal or less than 0 in file " + 
@@ -368,17 +429,17 @@ int main(int argc, char **argv)
                magneticField["name"].as<std::string>() + ".root";
 
             CppTools::CheckInputFile(simInputFileName);
+            simInputFileNames.push_back(simInputFileName);
 
-            currentConfigurationNumberOfEvents = static_cast<unsigned long>
-               ((static_cast<TTree *>(TFile::Open(simInputFileName.c_str())->
-                                      Get("Tree"))->GetEntries()));
+            currentConfigurationNumberOfEvents = 
+               SimTreeIndex::GetNumberOfEntries(simInputFileName);
             if (currentConfigurationNumberOfEvents <= 0)
             {
                CppTools::PrintError("Number of events is equal or less than 0 in file " + 
                                     simInputFileName);
             }
+            numberOfEvents += currentConfigurationNumberOfEvents;
          }
-         numberOfEvents += currentConfigurationNumberOfEvents;
       }
    }
 
@@ -409,52 +470,88 @@ int main(int argc, char **argv)
    box.AddEntry("Re-weight for pT spectra", 
                 std::string(reweightForSpectra ? "user defined" : "default (exp)"));
    box.AddEntry("Number of threads", numberOfThreads);
+   box.AddEntry("Tree cache size, clusters", treeCacheSizeFactor, 2);
+   box.AddEntry("Tree cache learn entries", treeCacheLearnEntries);
+   box.AddEntry("Async prefetching", asyncPrefetching);
+   box.AddEntry("Prefetch next file", prefetchNextFile);
    box.AddEntry("Number of events to be analyzed, 1e6", static_cast<double>(numberOfEvents)/1e6, 3);
    box.Print();
 
-   bool isProcessFinished = false;
+   std::atomic<bool> isProcessFinished = false;
 
    auto pBarCall = [&]()
    {
       ProgressBar pBar{"FANCY"};
-      while (!isProcessFinished)
+      for (unsigned long i = 1; !isProcessFinished; i++)
       {
-         pBar.Print(static_cast<double>(numberOfCalls)/
-                    static_cast<double>(numberOfEvents));
+         pBar.Print(progress.GetProgress(numberOfEvents));
+         // rates and the remaining time are reported every 10 seconds
+         if (i % 100 == 0)
+         {
+            pBar.Clear();
+            CppTools::PrintInfo(progress.GetStatus());
+            pBar.RePrint();
+         }
          std::this_thread::sleep_for(std::chrono::milliseconds(100));
       }
       pBar.Finish();
       CppTools::PrintInfo("AnalyzerWidthlessResonance has finished processing simulated data");
    };
  
+   // all configurations are processed as one set of tasks so they form one stage
+   progress.StartStage(inputYAMLResonance["name"].as<std::string>(), numberOfEvents);
+
    std::thread pBarThread(pBarCall);
  
    ThrContainer thrContainer;
 
+   // configurations are set in the same order as the names in simInputFileNames
+   std::vector<Configuration> configurations;
+
    for (const auto& magneticField : inputYAMLMain["magnetic_field_configurations"])
    {
       for (const auto& pTRange : inputYAMLResonance["sim_pt_ranges"])
       {
-         AnalyzeConfiguration(thrContainer, inputYAMLResonance["name"].as<std::string>(), 
-                              inputYAMLResonance["daughter1_id"].as<int>(),
-                              inputYAMLResonance["daughter2_id"].as<int>(),
-                              magneticField["name"].as<std::string>(), 
-                              pTRange["name"].as<std::string>());
+         configurations.emplace_back();
+         SetConfiguration(configurations.back(), thrContainer, 
+                          inputYAMLResonance["name"].as<std::string>(), 
+                          inputYAMLResonance["daughter1_id"].as<int>(),
+                          inputYAMLResonance["daughter2_id"].as<int>(),
+                          magneticField["name"].as<std::string>(), 
+                          pTRange["name"].as<std::string>());
          if (inputYAMLResonance["has_antiparticle"].as<bool>())
          {
-            AnalyzeConfiguration(thrContainer, inputYAMLResonance["name"].as<std::string>(), 
-                                 -1*inputYAMLResonance["daughter2_id"].as<int>(),
-                                 -1*inputYAMLResonance["daughter1_id"].as<int>(),
-                                 magneticField["name"].as<std::string>(), 
-                                 pTRange["name"].as<std::string>());
+            configurations.emplace_back();
+            SetConfiguration(configurations.back(), thrContainer, 
+                             inputYAMLResonance["name"].as<std::string>(), 
+                             -1*inputYAMLResonance["daughter2_id"].as<int>(),
+                             -1*inputYAMLResonance["daughter1_id"].as<int>(),
+                             magneticField["name"].as<std::string>(), 
+                             pTRange["name"].as<std::string>());
          }
       }
    }
 
+   std::vector<const std::vector<unsigned long> *> selectedEntries;
+   for (const Configuration& configuration : configurations)
+   {
+      selectedEntries.push_back(configuration.isIndexed ? 
+                                &configuration.selectedEntries : nullptr);
+   }
+
+   // all files are processed as one set of tasks so that 
+   // the threads do not idle at the end of each file
+   SimTreeReader::Process(simInputFileNames, simTreeBranches, 
+                          [&](SimTreeReader &simCNT, const unsigned long fileIndex)
+   {
+      ProcessTask(simCNT, thrContainer, configurations[fileIndex]);
+   }, "Tree", selectedEntries, prefetchNextFile);
 
    isProcessFinished = true;
    pBarThread.join();
 
+   SimTreeReader::PrintIOReport(simInputFileNames, simTreeBranches);
+
    // writing the result
    std::string outputFileName = "data/PostSim/" + runName + "/WidthlessResonance/" + 
                                 inputYAMLResonance["name"].as<std::string>() + ".root";
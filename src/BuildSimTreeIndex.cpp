@@ -0,0 +1,56 @@
+/** 
+ *  @file   BuildSimTreeIndex.cpp
+ *  @brief  Contains realisation of functions that are used for building sidecar indices (entry number, original pT, bbcz, and nch of every event) of the files with simulated trees
+ *
+ *  This file is a part of a project PairAnalysisPhenix (https://github.com/Sergeyir/PairAnalysisPhenix).
+ *
+ *  @author Sergei Antsupov (antsupov0124@gmail.com)
+ **/
+#ifndef BUILD_SIM_TREE_INDEX_CPP
+#define BUILD_SIM_TREE_INDEX_CPP
+
+#include "BuildSimTreeIndex.hpp"
+
+// this namespace is only used so that documentation does not become a mess
+// so there is no need to enforce the contents inside of it 
+// being accessed only via the scope resolution operator in this file
+using namespace BuildSimTreeIndex;
+
+int main(int argc, char **argv)
+{
+   if (argc < 3) 
+   {
+      std::string errMsg = "Expected at least 2 parameters while " + std::to_string(argc - 1) + " ";
+      errMsg += "parameter(s) were provided \n Usage: bin/BuildSimTreeIndex ";
+      errMsg += "numberOfThreads simTreeFileName1.root [simTreeFileName2.root ...]\n";
+      errMsg += "Index of each file is written next to it as simTreeFileName.index.root";
+      CppTools::PrintError(errMsg);
+   }
+
+   numberOfThreads = std::stoi(argv[1]);
+   if (numberOfThreads < 1) CppTools::PrintError("Number of threads must be bigger than 0");
+
+   for (int i = 2; i < argc; i++)
+   {
+      const std::string simFileName = argv[i];
+      // indices can be caught by wildcards together with the trees
+      if (simFileName.find(".index.root") != std::string::npos) continue;
+
+      CppTools::CheckInputFile(simFileName);
+      simFileNames.push_back(simFileName);
+   }
+
+   ROOT::EnableImplicitMT(numberOfThreads);
+
+   for (const std::string& simFileName : simFileNames)
+   {
+      SimTreeIndex::Build(simFileName);
+      CppTools::PrintInfo("Index of " + simFileName + " with " + 
+                          std::to_string(SimTreeIndex::GetNumberOfEntries(simFileName)) + 
+                          " events was written as " + SimTreeIndex::GetIndexFileName(simFileName));
+   }
+
+   return 0;
+}
+
+#endif /* BUILD_SIM_TREE_INDEX_CPP */
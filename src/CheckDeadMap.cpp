@@ -0,0 +1,397 @@
+/**
+ *  @file   CheckDeadMap.cpp
+ *  @brief  Contains realisation of functions that are used for checking that the lookups of DeadMap (bit-packed cells, summed-area table, batch queries, and binary files) give the same results as the straightforward lookups over 2D array of cells
+ *
+ *  This file is a part of a project PairAnalysisPhenix (https://github.com/Sergeyir/PairAnalysisPhenix).
+ *
+ *  @author Sergei Antsupov (antsupov0124@gmail.com)
+ **/
+#ifndef CHECK_DEAD_MAP_CPP
+#define CHECK_DEAD_MAP_CPP
+
+#include "CheckDeadMap.hpp"
+
+// this namespace is only used so that documentation does not become a mess
+// so there is no need to enforce the contents inside of it
+// being accessed only via the scope resolution operator in this file
+using namespace CheckDeadMap;
+
+int main(int argc, char **argv)
+{
+   std::vector<std::string> inputFileNames;
+
+   // random maps are checked if no deadmaps were specified
+   if (argc == 1)
+   {
+      std::filesystem::create_directories(randomMapsDir);
+      for (int i = 0; i < numberOfRandomMaps; i++)
+      {
+         const std::string outputFileName = randomMapsDir + "/map" + std::to_string(i) + ".txt";
+         // binary file of the previous check must not be used for the new map
+         std::filesystem::remove(std::filesystem::path(outputFileName).replace_extension(".bin"));
+         // every second map is numbered the same way as the channels of the detector
+         WriteRandomMap(outputFileName, i % 2 == 1);
+         inputFileNames.push_back(outputFileName);
+      }
+   }
+
+   for (int i = 1; i < argc; i++)
+   {
+      CppTools::CheckInputFile(argv[i]);
+      inputFileNames.push_back(argv[i]);
+   }
+
+   unsigned long numberOfMismatches = 0;
+   for (const std::string& inputFileName : inputFileNames)
+   {
+      numberOfMismatches += CheckMap(inputFileName);
+   }
+
+   if (argc == 1) std::filesystem::remove_all(randomMapsDir);
+
+   if (numberOfMismatches != 0)
+   {
+      CppTools::PrintWarning("CheckDeadMap: " + std::to_string(numberOfMismatches) +
+                             " lookups of DeadMap differ from the reference");
+      return 1;
+   }
+
+   CppTools::PrintInfo("CheckDeadMap: lookups of DeadMap match the reference for " +
+                       std::to_string(inputFileNames.size()) + " map(s)");
+   return 0;
+}
+
+void CheckDeadMap::WriteRandomMap(const std::string& outputFileName, const bool isCellMap)
+{
+   std::uniform_int_distribution<int> xNBinsDistr(1, 600);
+   std::uniform_int_distribution<int> yNBinsDistr(1, 200);
+   std::uniform_real_distribution<double> minDistr(-200., 200.);
+   std::uniform_real_distribution<double> widthDistr(0.1, 400.);
+   // maps with mostly alive, mixed, and mostly dead cells are checked
+   std::discrete_distribution<int> densityDistr({1., 1., 1.});
+   const double densities[3] = {0.05, 0.5, 0.95};
+
+   const int xNBins = xNBinsDistr(generator);
+   const int yNBins = yNBinsDistr(generator);
+
+   double ranges[4];
+   if (isCellMap)
+   {
+      ranges[0] = 0.;
+      ranges[1] = static_cast<double>(xNBins);
+      ranges[2] = 0.;
+      ranges[3] = static_cast<double>(yNBins);
+   }
+   else
+   {
+      ranges[0] = minDistr(generator);
+      ranges[1] = ranges[0] + widthDistr(generator);
+      ranges[2] = minDistr(generator);
+      ranges[3] = ranges[2] + widthDistr(generator);
+   }
+
+   std::bernoulli_distribution isDeadDistr(densities[densityDistr(generator)]);
+
+   std::ofstream outputFile(outputFileName);
+   outputFile << std::setprecision(17);
+   outputFile << xNBins << " " << ranges[0] << " " << ranges[1] << " " <<
+                 yNBins << " " << ranges[2] << " " << ranges[3] << std::endl;
+
+   for (int i = 0; i < yNBins; i++)
+   {
+      for (int j = 0; j < xNBins; j++)
+      {
+         outputFile << isDeadDistr(generator) << " ";
+      }
+      outputFile << std::endl;
+   }
+}
+
+unsigned long CheckDeadMap::CheckMap(const std::string& inputFileName)
+{
+   ReferenceMap referenceMap;
+   referenceMap.Read(inputFileName);
+
+   const bool isCellMap = (referenceMap.ranges[0] == 0. && referenceMap.ranges[2] == 0. &&
+                           referenceMap.ranges[1] == static_cast<double>(referenceMap.xNBins) &&
+                           referenceMap.ranges[3] == static_cast<double>(referenceMap.yNBins));
+
+   // the first read parses the text file and writes the binary file (if it is outdated)
+   // and the second read maps the binary file
+   DeadMap textMap, binaryMap;
+   if (!textMap.Read(inputFileName) || !binaryMap.Read(inputFileName))
+   {
+      CppTools::PrintWarning("CheckDeadMap: map " + inputFileName + " was not read");
+      return 1;
+   }
+
+   const unsigned long numberOfMismatches = CompareMaps(textMap, referenceMap, isCellMap) +
+                                            CompareMaps(binaryMap, referenceMap, isCellMap);
+   if (numberOfMismatches != 0)
+   {
+      CppTools::PrintWarning("CheckDeadMap: lookups differ for map " + inputFileName);
+   }
+   return numberOfMismatches;
+}
+
+unsigned long CheckDeadMap::CompareMaps(const DeadMap& deadMap, const ReferenceMap& referenceMap,
+                                        const bool isCellMap)
+{
+   const double xWidth = referenceMap.ranges[1] - referenceMap.ranges[0];
+   const double yWidth = referenceMap.ranges[3] - referenceMap.ranges[2];
+
+   // points slightly outside of the ranges are also queried
+   std::uniform_real_distribution<double> xDistr(referenceMap.ranges[0] - 0.05*xWidth,
+                                                 referenceMap.ranges[1] + 0.05*xWidth);
+   std::uniform_real_distribution<double> yDistr(referenceMap.ranges[2] - 0.05*yWidth,
+                                                 referenceMap.ranges[3] + 0.05*yWidth);
+   // variations up to 4 bins
+   std::uniform_real_distribution<double> xVarDistr(0., 4.*xWidth/referenceMap.xNBins);
+   std::uniform_real_distribution<double> yVarDistr(0., 4.*yWidth/referenceMap.yNBins);
+   std::uniform_int_distribution<int> xBinDistr(-3, referenceMap.xNBins + 2);
+   std::uniform_int_distribution<int> yBinDistr(-3, referenceMap.yNBins + 2);
+   std::uniform_int_distribution<int> binVarDistr(0, 3);
+   std::bernoulli_distribution isSelectedDistr(0.7);
+
+   unsigned long numberOfMismatches = 0;
+
+   auto compare = [&](const std::string& lookupName, const unsigned long mismatches)
+   {
+      if (mismatches == 0) return;
+      CppTools::PrintWarning("CheckDeadMap: " + lookupName + " differs for " +
+                             std::to_string(mismatches) + " out of " +
+                             std::to_string(numberOfQueries) + " queries");
+      numberOfMismatches += mismatches;
+   };
+
+   unsigned long mismatchesIsDead = 0;
+   unsigned long mismatchesLoose = 0;
+   unsigned long mismatchesTight = 0;
+   unsigned long mismatchesDeadCells = 0;
+
+   // points for the batch queries
+   std::vector<double> x(numberOfQueries), y(numberOfQueries);
+   std::vector<unsigned char> isSelected(numberOfQueries);
+
+   for (unsigned long i = 0; i < numberOfQueries; i++)
+   {
+      x[i] = xDistr(generator);
+      y[i] = yDistr(generator);
+      // points just below the upper edges are also queried since their bins can be rounded up
+      if (i % 16 == 0) x[i] = std::nextafter(referenceMap.ranges[1], referenceMap.ranges[0]);
+      if (i % 16 == 1) y[i] = std::nextafter(referenceMap.ranges[3], referenceMap.ranges[2]);
+      isSelected[i] = isSelectedDistr(generator);
+
+      const double xVar = xVarDistr(generator);
+      const double yVar = yVarDistr(generator);
+
+      if (deadMap.IsDead(x[i], y[i]) != referenceMap.IsDead(x[i], y[i])) mismatchesIsDead++;
+      if (deadMap.IsDeadLoose(x[i], y[i], xVar, yVar) !=
+          referenceMap.IsDeadLoose(x[i], y[i], xVar, yVar)) mismatchesLoose++;
+      if (deadMap.IsDeadTight(x[i], y[i], xVar, yVar) !=
+          referenceMap.IsDeadTight(x[i], y[i], xVar, yVar)) mismatchesTight++;
+
+      // windows partially outside of the map are also queried
+      const int xBinMin = xBinDistr(generator);
+      const int xBinMax = xBinMin + 2*binVarDistr(generator);
+      const int yBinMin = yBinDistr(generator);
+      const int yBinMax = yBinMin + 2*binVarDistr(generator);
+
+      if (deadMap.GetNumberOfDeadCells(xBinMin, xBinMax, yBinMin, yBinMax) !=
+          referenceMap.GetNumberOfDeadCells(xBinMin, xBinMax, yBinMin, yBinMax))
+      {
+         mismatchesDeadCells++;
+      }
+   }
+
+   compare("IsDead", mismatchesIsDead);
+   compare("IsDeadLoose", mismatchesLoose);
+   compare("IsDeadTight", mismatchesTight);
+   compare("GetNumberOfDeadCells", mismatchesDeadCells);
+
+   // bit 0 is set by the batch query and bit 1 must be kept as it is
+   std::vector<unsigned int> masks(numberOfQueries);
+   for (unsigned long i = 0; i < numberOfQueries; i++) masks[i] = (i % 3 == 0 ? 2 : 0);
+
+   deadMap.SetDead(numberOfQueries, x.data(), y.data(), isSelected.data(), 1, masks.data());
+
+   unsigned long mismatchesSetDead = 0;
+   for (unsigned long i = 0; i < numberOfQueries; i++)
+   {
+      const unsigned int expectedMask = (i % 3 == 0 ? 2 : 0) |
+         ((isSelected[i] && referenceMap.IsDead(x[i], y[i])) ? 1 : 0);
+      if (masks[i] != expectedMask) mismatchesSetDead++;
+   }
+   compare("SetDead", mismatchesSetDead);
+
+   if (!isCellMap) return numberOfMismatches;
+
+   unsigned long mismatchesIsDeadCell = 0;
+   unsigned long mismatchesCellLoose = 0;
+   unsigned long mismatchesCellTight = 0;
+
+   // cells for the batch queries
+   std::vector<int> xBins(numberOfQueries), yBins(numberOfQueries);
+
+   for (unsigned long i = 0; i < numberOfQueries; i++)
+   {
+      const int xBin = xBinDistr(generator);
+      const int yBin = yBinDistr(generator);
+      const int xBinVar = binVarDistr(generator);
+      const int yBinVar = binVarDistr(generator);
+
+      xBins[i] = xBin;
+      yBins[i] = yBin;
+
+      const bool isInRange = deadMap.IsCellInRange(xBin, yBin);
+
+      // cells are looked up the same way as in DeadMapCutter for TOF and EMCal
+      if ((!isInRange || deadMap.IsDeadCell(xBin, yBin)) !=
+          referenceMap.IsDeadCell(xBin, yBin)) mismatchesIsDeadCell++;
+      if ((!isInRange || deadMap.IsAllDead(xBin - xBinVar, xBin + xBinVar,
+                                           yBin - yBinVar, yBin + yBinVar)) !=
+          referenceMap.IsDeadCellLoose(xBin, yBin, xBinVar, yBinVar)) mismatchesCellLoose++;
+      if ((!isInRange || deadMap.IsAnyDead(xBin - xBinVar, xBin + xBinVar,
+                                           yBin - yBinVar, yBin + yBinVar)) !=
+          referenceMap.IsDeadCellTight(xBin, yBin, xBinVar, yBinVar)) mismatchesCellTight++;
+   }
+
+   compare("IsDeadCell", mismatchesIsDeadCell);
+   compare("IsAllDead", mismatchesCellLoose);
+   compare("IsAnyDead", mismatchesCellTight);
+
+   for (unsigned long i = 0; i < numberOfQueries; i++) masks[i] = (i % 3 == 0 ? 2 : 0);
+
+   deadMap.SetDeadCells(numberOfQueries, xBins.data(), yBins.data(), isSelected.data(),
+                        1, masks.data());
+
+   unsigned long mismatchesSetDeadCells = 0;
+   for (unsigned long i = 0; i < numberOfQueries; i++)
+   {
+      const unsigned int expectedMask = (i % 3 == 0 ? 2 : 0) |
+         ((isSelected[i] && referenceMap.IsDeadCell(xBins[i], yBins[i])) ? 1 : 0);
+      if (masks[i] != expectedMask) mismatchesSetDeadCells++;
+   }
+   compare("SetDeadCells", mismatchesSetDeadCells);
+
+   return numberOfMismatches;
+}
+
+void CheckDeadMap::ReferenceMap::Read(const std::string& inputFileName)
+{
+   std::ifstream inputFile(inputFileName);
+
+   if (!(inputFile >> xNBins >> ranges[0] >> ranges[1] >> yNBins >> ranges[2] >> ranges[3]))
+   {
+      CppTools::PrintError("CheckDeadMap: Unexpected end of file: " + inputFileName);
+   }
+
+   cells.resize(yNBins);
+
+   for (int i = 0; i < yNBins; i++)
+   {
+      cells[i].resize(xNBins);
+      for (int j = 0; j < xNBins; j++)
+      {
+         bool isDead;
+         if (!(inputFile >> isDead))
+         {
+            CppTools::PrintError("CheckDeadMap: Unexpected end of file: " + inputFileName);
+         }
+         cells[i][j] = isDead;
+      }
+   }
+}
+
+int CheckDeadMap::ReferenceMap::GetXBin(const double x) const
+{
+   // division can round x just below the upper edge up to the number of bins
+   return std::min(static_cast<int>((x - ranges[0])/(ranges[1] - ranges[0])*
+                                    static_cast<double>(xNBins)), xNBins - 1);
+}
+
+int CheckDeadMap::ReferenceMap::GetYBin(const double y) const
+{
+   // division can round y just below the upper edge up to the number of bins
+   return std::min(static_cast<int>((y - ranges[2])/(ranges[3] - ranges[2])*
+                                    static_cast<double>(yNBins)), yNBins - 1);
+}
+
+bool CheckDeadMap::ReferenceMap::IsDead(const double x, const double y) const
+{
+   if (x <= ranges[0] || x >= ranges[1] || y <= ranges[2] || y >= ranges[3]) return true;
+   return cells[GetYBin(y)][GetXBin(x)];
+}
+
+bool CheckDeadMap::ReferenceMap::IsDeadLoose(const double x, const double y,
+                                             const double xVar, const double yVar) const
+{
+   if (x <= ranges[0] || x >= ranges[1] || y <= ranges[2] || y >= ranges[3]) return true;
+   // the window is limited by the edges of the map
+   const int xBinMin = std::max(GetXBin(x - xVar), 0);
+   const int xBinMax = std::min(GetXBin(x + xVar), xNBins - 1);
+   const int yBinMin = std::max(GetYBin(y - yVar), 0);
+   const int yBinMax = std::min(GetYBin(y + yVar), yNBins - 1);
+
+   for (int xBin = xBinMin; xBin <= xBinMax; xBin++)
+   {
+      for (int yBin = yBinMin; yBin <= yBinMax; yBin++)
+      {
+         if (!cells[yBin][xBin]) return false;
+      }
+   }
+   return true;
+}
+
+bool CheckDeadMap::ReferenceMap::IsDeadTight(const double x, const double y,
+                                             const double xVar, const double yVar) const
+{
+   if (x <= ranges[0] || x >= ranges[1] || y <= ranges[2] || y >= ranges[3]) return true;
+   return (GetNumberOfDeadCells(GetXBin(x - xVar), GetXBin(x + xVar),
+                                GetYBin(y - yVar), GetYBin(y + yVar)) > 0);
+}
+
+bool CheckDeadMap::ReferenceMap::IsDeadCell(const int xBin, const int yBin) const
+{
+   if (xBin < 0 || xBin >= xNBins || yBin < 0 || yBin >= yNBins) return true;
+   return cells[yBin][xBin];
+}
+
+bool CheckDeadMap::ReferenceMap::IsDeadCellLoose(const int xBin, const int yBin,
+                                                 const int xBinVar, const int yBinVar) const
+{
+   if (xBin < 0 || xBin >= xNBins || yBin < 0 || yBin >= yNBins) return true;
+
+   for (int i = std::max(xBin - xBinVar, 0); i <= std::min(xBin + xBinVar, xNBins - 1); i++)
+   {
+      for (int j = std::max(yBin - yBinVar, 0); j <= std::min(yBin + yBinVar, yNBins - 1); j++)
+      {
+         if (!cells[j][i]) return false;
+      }
+   }
+   return true;
+}
+
+bool CheckDeadMap::ReferenceMap::IsDeadCellTight(const int xBin, const int yBin,
+                                                 const int xBinVar, const int yBinVar) const
+{
+   if (xBin < 0 || xBin >= xNBins || yBin < 0 || yBin >= yNBins) return true;
+   return (GetNumberOfDeadCells(xBin - xBinVar, xBin + xBinVar,
+                                yBin - yBinVar, yBin + yBinVar) > 0);
+}
+
+int CheckDeadMap::ReferenceMap::GetNumberOfDeadCells(int xBinMin, int xBinMax,
+                                                     int yBinMin, int yBinMax) const
+{
+   int numberOfDeadCells = 0;
+   for (int xBin = std::max(xBinMin, 0); xBin <= std::min(xBinMax, xNBins - 1); xBin++)
+   {
+      for (int yBin = std::max(yBinMin, 0); yBin <= std::min(yBinMax, yNBins - 1); yBin++)
+      {
+         if (cells[yBin][xBin]) numberOfDeadCells++;
+      }
+   }
+   return numberOfDeadCells;
+}
+
+#endif /* CHECK_DEAD_MAP_CPP */
@@ -212,53 +212,16 @@ void CheckRuns::CheckRunsByDCBoard()
    TH2F *heatmapSumDCw0 = static_cast<TH2F *>(sumFile->Get("_Heatmap: DCw, zDC>=0"));
    TH2F *heatmapSumDCw1 = static_cast<TH2F *>(sumFile->Get("_Heatmap: DCw, zDC<0"));
 
-   for (int i = 1; i <= heatmapSumDCe0->GetXaxis()->GetNbins(); i++)
-   {
-      for (int j = 1; j <= heatmapSumDCe0->GetYaxis()->GetNbins(); j++)
-      {
-         if (dmCutter.IsDeadDC(0, 1., heatmapSumDCe0->GetXaxis()->GetBinCenter(i),
-                               heatmapSumDCe0->GetYaxis()->GetBinCenter(j)))
-         {
-            heatmapSumDCe0->SetBinContent(i, j, 0.);
-         }
-      }
-   }
+   const double liveFractionDCe0 = dmCutter.Mask(heatmapSumDCe0, DeadMapCutter::DEAD_DC, 0, 0);
+   const double liveFractionDCe1 = dmCutter.Mask(heatmapSumDCe1, DeadMapCutter::DEAD_DC, 0, 1);
+   const double liveFractionDCw0 = dmCutter.Mask(heatmapSumDCw0, DeadMapCutter::DEAD_DC, 1, 0);
+   const double liveFractionDCw1 = dmCutter.Mask(heatmapSumDCw1, DeadMapCutter::DEAD_DC, 1, 1);
 
-   for (int i = 1; i <= heatmapSumDCe1->GetXaxis()->GetNbins(); i++)
-   {
-      for (int j = 1; j <= heatmapSumDCe1->GetYaxis()->GetNbins(); j++)
-      {
-         if (dmCutter.IsDeadDC(0, -1., heatmapSumDCe1->GetXaxis()->GetBinCenter(i),
-                               heatmapSumDCe1->GetYaxis()->GetBinCenter(j)))
-         {
-            heatmapSumDCe1->SetBinContent(i, j, 0.);
-         }
-      }
-   }
-
-   for (int i = 1; i <= heatmapSumDCw0->GetXaxis()->GetNbins(); i++)
-   {
-      for (int j = 1; j <= heatmapSumDCw0->GetYaxis()->GetNbins(); j++)
-      {
-         if (dmCutter.IsDeadDC(1, 1., heatmapSumDCw0->GetXaxis()->GetBinCenter(i),
-                               heatmapSumDCw0->GetYaxis()->GetBinCenter(j)))
-         {
-            heatmapSumDCw0->SetBinContent(i, j, 0.);
-         }
-      }
-   }
-
-   for (int i = 1; i <= heatmapSumDCw1->GetXaxis()->GetNbins(); i++)
-   {
-      for (int j = 1; j <= heatmapSumDCw1->GetYaxis()->GetNbins(); j++)
-      {
-         if (dmCutter.IsDeadDC(1, -1., heatmapSumDCw1->GetXaxis()->GetBinCenter(i),
-                               heatmapSumDCw1->GetYaxis()->GetBinCenter(j)))
-         {
-            heatmapSumDCw1->SetBinContent(i, j, 0.);
-         }
-      }
-   }
+   CppTools::PrintInfo("Fractions of DC tracks of all runs outside of the deadmaps: "\
+                       "DCe0 " + CppTools::DtoStr(liveFractionDCe0, 3) + ", "\
+                       "DCe1 " + CppTools::DtoStr(liveFractionDCe1, 3) + ", "\
+                       "DCw0 " + CppTools::DtoStr(liveFractionDCw0, 3) + ", "\
+                       "DCw1 " + CppTools::DtoStr(liveFractionDCw1, 3));
 
    TH1D *projSumDCe0Board = heatmapSumDCe0->
       ProjectionY("sum DCe0 board", 1, heatmapSumDCe0->GetXaxis()->GetNbins());
@@ -305,53 +268,13 @@ void CheckRuns::CheckRunsByDCBoard()
       TH2F *heatmapDCw0 = static_cast<TH2F *>(inputFile->Get("_Heatmap: DCw, zDC>=0"));
       TH2F *heatmapDCw1 = static_cast<TH2F *>(inputFile->Get("_Heatmap: DCw, zDC<0"));
 
-      for (int i = 1; i <= heatmapDCe0->GetXaxis()->GetNbins(); i++)
-      {
-         for (int j = 1; j <= heatmapDCe0->GetYaxis()->GetNbins(); j++)
-         {
-            if (dmCutter.IsDeadDC(0, 1., heatmapDCe0->GetXaxis()->GetBinCenter(i),
-                                  heatmapDCe0->GetYaxis()->GetBinCenter(j)))
-            {
-               heatmapDCe0->SetBinContent(i, j, 0.);
-            }
-         }
-      }
-
-      for (int i = 1; i <= heatmapDCe1->GetXaxis()->GetNbins(); i++)
-      {
-         for (int j = 1; j <= heatmapDCe1->GetYaxis()->GetNbins(); j++)
-         {
-            if (dmCutter.IsDeadDC(0, -1., heatmapDCe1->GetXaxis()->GetBinCenter(i),
-                                  heatmapDCe1->GetYaxis()->GetBinCenter(j)))
-            {
-               heatmapDCe1->SetBinContent(i, j, 0.);
-            }
-         }
-      }
-
-      for (int i = 1; i <= heatmapDCw0->GetXaxis()->GetNbins(); i++)
-      {
-         for (int j = 1; j <= heatmapDCw0->GetYaxis()->GetNbins(); j++)
-         {
-            if (dmCutter.IsDeadDC(1, 1., heatmapDCw0->GetXaxis()->GetBinCenter(i),
-                                  heatmapDCw0->GetYaxis()->GetBinCenter(j)))
-            {
-               heatmapDCw0->SetBinContent(i, j, 0.);
-            }
-         }
-      }
-
-      for (int i = 1; i <= heatmapDCw1->GetXaxis()->GetNbins(); i++)
-      {
-         for (int j = 1; j <= heatmapDCw1->GetYaxis()->GetNbins(); j++)
-         {
-            if (dmCutter.IsDeadDC(1, -1., heatmapDCw1->GetXaxis()->GetBinCenter(i),
-                                  heatmapDCw1->GetYaxis()->GetBinCenter(j)))
-            {
-               heatmapDCw1->SetBinContent(i, j, 0.);
-            }
-         }
-      }
+      // flags of the dead bins are evaluated for the first run and reused for the others
+      // since the heatmaps of all runs have the same axes; live fractions of single runs
+      // are not needed since the projections are normalized
+      dmCutter.Mask(heatmapDCe0, DeadMapCutter::DEAD_DC, 0, 0);
+      dmCutter.Mask(heatmapDCe1, DeadMapCutter::DEAD_DC, 0, 1);
+      dmCutter.Mask(heatmapDCw0, DeadMapCutter::DEAD_DC, 1, 0);
+      dmCutter.Mask(heatmapDCw1, DeadMapCutter::DEAD_DC, 1, 1);
 
       TH1D *projDCe0Board = heatmapDCe0->
          ProjectionY("proj DCe0 board to ref ratio", 1, heatmapDCe0->GetXaxis()->GetNbins());
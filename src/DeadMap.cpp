@@ -0,0 +1,460 @@
+/**
+ *  @file   DeadMap.cpp
+ *  @brief  Contains realisation of classes DeadMap and FusedDeadMap
+ *
+ *  This file is a part of a project PairAnalysisPhenix (https://github.com/Sergeyir/PairAnalysisPhenix).
+ *
+ *  @author Sergei Antsupov (antsupov0124@gmail.com)
+ **/
+#ifndef DEAD_MAP_CPP
+#define DEAD_MAP_CPP
+
+#include <cmath>
+#include <algorithm>
+
+#include "../include/DeadMap.hpp"
+
+// header of the binary deadmap file; cells of the map follow the header
+// in the same layout as in DeadMap::lines (rows padded to the whole cache lines)
+struct alignas(64) DeadMapBinaryHeader
+{
+   // identifier of the binary deadmap file
+   char magic[8];
+   // version of the format; must be incremented when the layout changes
+   unsigned int version;
+   // number of bins of X axis
+   int xNBins;
+   // number of bins of Y axis
+   int yNBins;
+   // number of words in one row
+   int wordsPerRow;
+   // lower edge of X axis
+   double xMin;
+   // upper edge of X axis
+   double xMax;
+   // lower edge of Y axis
+   double yMin;
+   // upper edge of Y axis
+   double yMax;
+   // size of the text file the binary file was generated from
+   long sourceSize;
+   // time of the last modification of the text file the binary file was generated from
+   long sourceTime;
+   // checksum of the cells
+   unsigned long checksum;
+};
+
+static const char deadMapBinaryMagic[8] = "DEADMAP";
+static const unsigned int deadMapBinaryVersion = 1;
+
+// FNV-1a hash of the data
+static unsigned long GetDeadMapChecksum(const void *data, const size_t size)
+{
+   const unsigned char *bytes = static_cast<const unsigned char *>(data);
+   unsigned long hash = 14695981039346656037UL;
+   for (size_t i = 0; i < size; i++)
+   {
+      hash ^= bytes[i];
+      hash *= 1099511628211UL;
+   }
+   return hash;
+}
+
+bool DeadMap::Read(const std::string& inputFileName)
+{
+   const std::string binaryFileName =
+      std::filesystem::path(inputFileName).replace_extension(".bin").string();
+
+   const bool isTextFileFound = std::filesystem::exists(inputFileName);
+
+   if (!isTextFileFound && !std::filesystem::exists(binaryFileName))
+   {
+      CppTools::PrintWarning("DeadMapCutter: File " + inputFileName + " does not exists");
+      return false;
+   }
+
+   // binary file is only used if it was generated from the current text file
+   if (!ReadBinary(binaryFileName, isTextFileFound ? inputFileName : ""))
+   {
+      if (!isTextFileFound)
+      {
+         CppTools::PrintWarning("DeadMapCutter: File " + binaryFileName + " is corrupted "\
+                                "and text file " + inputFileName + " does not exists");
+         return false;
+      }
+      ReadText(inputFileName);
+      WriteBinary(binaryFileName, inputFileName);
+   }
+
+   BuildDeadCellsSums();
+
+   return true;
+}
+
+void DeadMap::ReadText(const std::string& inputFileName)
+{
+   std::ifstream inputFile(inputFileName);
+
+   bool isUnexpectedEndOfFile = false;
+
+   if (!(inputFile >> xNBins >> xMin >> xMax >> yNBins >> yMin >> yMax) ||
+       xNBins <= 0 || yNBins <= 0)
+   {
+      CppTools::PrintError("DeadMapCutter: Unexpected end of file: " + inputFileName);
+   }
+
+   SetAxes();
+
+   for (int i = 0; i < yNBins && !isUnexpectedEndOfFile; i++)
+   {
+      for (int j = 0; j < xNBins; j++)
+      {
+         bool isDead;
+         if (!(inputFile >> isDead))
+         {
+            isUnexpectedEndOfFile = true;
+            break;
+         }
+         if (!isDead) continue;
+
+         const int index = i*wordsPerRow + j/bitsPerWord;
+         lines[index/wordsPerLine].words[index % wordsPerLine] |= (1ULL << (j % bitsPerWord));
+      }
+   }
+
+   if (isUnexpectedEndOfFile)
+   {
+      CppTools::PrintError("DeadMapCutter: Unexpected end of file: " + inputFileName);
+   }
+}
+
+bool DeadMap::ReadBinary(const std::string& binaryFileName, const std::string& textFileName)
+{
+   const int fd = open(binaryFileName.c_str(), O_RDONLY);
+   if (fd < 0) return false;
+
+   struct stat fileStat;
+   if (fstat(fd, &fileStat) != 0 ||
+       static_cast<size_t>(fileStat.st_size) < sizeof(DeadMapBinaryHeader))
+   {
+      close(fd);
+      return false;
+   }
+   const size_t size = static_cast<size_t>(fileStat.st_size);
+
+   void *map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+   close(fd);
+   if (map == MAP_FAILED) return false;
+
+   DeadMapBinaryHeader header;
+   std::memcpy(&header, map, sizeof(header));
+
+   bool isValid = (std::memcmp(header.magic, deadMapBinaryMagic, sizeof(header.magic)) == 0 &&
+                   header.version == deadMapBinaryVersion &&
+                   header.xNBins > 0 && header.yNBins > 0);
+
+   if (isValid && !textFileName.empty())
+   {
+      std::error_code error;
+      const long textFileSize = static_cast<long>(std::filesystem::file_size(textFileName, error));
+      const long textFileTime = static_cast<long>
+         (std::filesystem::last_write_time(textFileName, error).time_since_epoch().count());
+      isValid = (!error && header.sourceSize == textFileSize && header.sourceTime == textFileTime);
+   }
+
+   // size of the cells expected from the header is checked before anything is allocated 
+   // so that a corrupted header cannot lead to reading outside of the file
+   const size_t linesPerRow = static_cast<size_t>(isValid ? GetLinesPerRow(header.xNBins) : 0);
+   const size_t cellsSize = linesPerRow*static_cast<size_t>(header.yNBins)*sizeof(CacheLine);
+   const char *cells = static_cast<const char *>(map) + sizeof(header);
+
+   isValid = (isValid && header.wordsPerRow == static_cast<int>(linesPerRow*wordsPerLine) &&
+              size == sizeof(header) + cellsSize &&
+              header.checksum == GetDeadMapChecksum(cells, cellsSize));
+
+   if (isValid)
+   {
+      xNBins = header.xNBins;
+      xMin = header.xMin;
+      xMax = header.xMax;
+      yNBins = header.yNBins;
+      yMin = header.yMin;
+      yMax = header.yMax;
+
+      SetAxes();
+
+      std::memcpy(static_cast<void *>(lines.data()), cells, cellsSize);
+   }
+
+   munmap(map, size);
+   return isValid;
+}
+
+void DeadMap::WriteBinary(const std::string& binaryFileName, const std::string& textFileName) const
+{
+   DeadMapBinaryHeader header;
+   std::memset(static_cast<void *>(&header), 0, sizeof(header));
+   std::memcpy(header.magic, deadMapBinaryMagic, sizeof(header.magic));
+   header.version = deadMapBinaryVersion;
+   header.xNBins = xNBins;
+   header.yNBins = yNBins;
+   header.wordsPerRow = wordsPerRow;
+   header.xMin = xMin;
+   header.xMax = xMax;
+   header.yMin = yMin;
+   header.yMax = yMax;
+   header.sourceSize = static_cast<long>(std::filesystem::file_size(textFileName));
+   header.sourceTime = static_cast<long>
+      (std::filesystem::last_write_time(textFileName).time_since_epoch().count());
+   header.checksum = GetDeadMapChecksum(lines.data(), lines.size()*sizeof(CacheLine));
+
+   // file is written under a temporary name and then renamed so that other processes
+   // reading the same deadmaps never see a partially written file
+   const std::string tmpFileName = binaryFileName + "." + std::to_string(getpid()) + ".tmp";
+   {
+      std::ofstream file(tmpFileName, std::ios::binary | std::ios::trunc);
+      file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+      file.write(reinterpret_cast<const char *>(lines.data()), lines.size()*sizeof(CacheLine));
+      if (!file.fail()) file.close();
+      if (file.fail())
+      {
+         CppTools::PrintWarning("DeadMapCutter: Failed to write " + binaryFileName);
+         std::filesystem::remove(tmpFileName);
+         return;
+      }
+   }
+
+   std::error_code error;
+   std::filesystem::rename(tmpFileName, binaryFileName, error);
+   if (error)
+   {
+      CppTools::PrintWarning("DeadMapCutter: Failed to write " + binaryFileName);
+      std::filesystem::remove(tmpFileName, error);
+   }
+}
+
+int DeadMap::GetLinesPerRow(const int xNBins)
+{
+   // rows are rounded up to the whole number of cache lines
+   return (xNBins + bitsPerWord*wordsPerLine - 1)/(bitsPerWord*wordsPerLine);
+}
+
+void DeadMap::SetAxes()
+{
+   xInvBinWidth = static_cast<double>(xNBins)/(xMax - xMin);
+   yInvBinWidth = static_cast<double>(yNBins)/(yMax - yMin);
+
+   const int linesPerRow = GetLinesPerRow(xNBins);
+   wordsPerRow = linesPerRow*wordsPerLine;
+
+   lines.assign(static_cast<unsigned long>(linesPerRow*yNBins), CacheLine());
+}
+
+int DeadMap::GetXNBins() const
+{
+   return xNBins;
+}
+
+int DeadMap::GetYNBins() const
+{
+   return yNBins;
+}
+
+double DeadMap::GetXMin() const
+{
+   return xMin;
+}
+
+double DeadMap::GetXMax() const
+{
+   return xMax;
+}
+
+double DeadMap::GetYMin() const
+{
+   return yMin;
+}
+
+double DeadMap::GetYMax() const
+{
+   return yMax;
+}
+
+int DeadMap::GetNumberOfDeadCells(int xBinMin, int xBinMax, int yBinMin, int yBinMax) const
+{
+   if (xBinMin < 0) xBinMin = 0;
+   if (yBinMin < 0) yBinMin = 0;
+   if (xBinMax >= xNBins) xBinMax = xNBins - 1;
+   if (yBinMax >= yNBins) yBinMax = yNBins - 1;
+
+   if (xBinMin > xBinMax || yBinMin > yBinMax) return 0;
+
+   const int rowSize = xNBins + 1;
+
+   return deadCellsSums[(yBinMax + 1)*rowSize + xBinMax + 1] - 
+          deadCellsSums[yBinMin*rowSize + xBinMax + 1] -
+          deadCellsSums[(yBinMax + 1)*rowSize + xBinMin] + 
+          deadCellsSums[yBinMin*rowSize + xBinMin];
+}
+
+bool DeadMap::IsAllDead(int xBinMin, int xBinMax, int yBinMin, int yBinMax) const
+{
+   if (xBinMin < 0) xBinMin = 0;
+   if (yBinMin < 0) yBinMin = 0;
+   if (xBinMax >= xNBins) xBinMax = xNBins - 1;
+   if (yBinMax >= yNBins) yBinMax = yNBins - 1;
+
+   if (xBinMin > xBinMax || yBinMin > yBinMax) return true;
+
+   return (GetNumberOfDeadCells(xBinMin, xBinMax, yBinMin, yBinMax) == 
+           (xBinMax - xBinMin + 1)*(yBinMax - yBinMin + 1));
+}
+
+bool DeadMap::IsAnyDead(int xBinMin, int xBinMax, int yBinMin, int yBinMax) const
+{
+   return (GetNumberOfDeadCells(xBinMin, xBinMax, yBinMin, yBinMax) > 0);
+}
+
+void DeadMap::BuildDeadCellsSums()
+{
+   const int rowSize = xNBins + 1;
+
+   deadCellsSums.assign(static_cast<unsigned long>(rowSize*(yNBins + 1)), 0);
+
+   for (int i = 0; i < yNBins; i++)
+   {
+      int rowSum = 0;
+      for (int j = 0; j < xNBins; j++)
+      {
+         rowSum += IsDeadCell(j, i);
+         deadCellsSums[(i + 1)*rowSize + j + 1] = deadCellsSums[i*rowSize + j + 1] + rowSum;
+      }
+   }
+}
+
+bool DeadMap::IsDeadLoose(const double x, const double y,
+                          const double xVar, const double yVar) const
+{
+   if (!IsInRange(x, y)) return true;
+   return IsAllDead(GetXBin(x - xVar), GetXBin(x + xVar), GetYBin(y - yVar), GetYBin(y + yVar));
+}
+
+bool DeadMap::IsDeadTight(const double x, const double y,
+                          const double xVar, const double yVar) const
+{
+   if (!IsInRange(x, y)) return true;
+   return IsAnyDead(GetXBin(x - xVar), GetXBin(x + xVar), GetYBin(y - yVar), GetYBin(y + yVar));
+}
+
+void DeadMap::SetDead(const unsigned long numberOfPoints, const double *x, const double *y,
+                      const unsigned char *isSelected, const unsigned int bit,
+                      unsigned int *masks) const
+{
+   // indices are reused between the calls so that they are not reallocated
+   thread_local std::vector<int> cellIndices;
+   cellIndices.resize(numberOfPoints);
+   int *indices = cellIndices.data();
+
+   const int bitsPerRow = wordsPerRow*bitsPerWord;
+
+   #pragma omp simd
+   for (unsigned long i = 0; i < numberOfPoints; i++)
+   {
+      const bool isInRange = (x[i] > xMin && x[i] < xMax && y[i] > yMin && y[i] < yMax);
+      // points outside of the ranges are moved to the lower edges so that
+      // the conversion to int is always defined
+      // bins are clamped the same way as in GetXBin and GetYBin
+      const int xBin = std::min(static_cast<int>(((isInRange ? x[i] : xMin) - xMin)*
+                                                 xInvBinWidth), xNBins - 1);
+      const int yBin = std::min(static_cast<int>(((isInRange ? y[i] : yMin) - yMin)*
+                                                 yInvBinWidth), yNBins - 1);
+      indices[i] = isInRange ? yBin*bitsPerRow + xBin : -1;
+   }
+
+   for (unsigned long i = 0; i < numberOfPoints; i++)
+   {
+      masks[i] |= bit*static_cast<unsigned int>(isSelected[i] && IsDeadCellIndex(indices[i]));
+   }
+}
+
+void DeadMap::SetDeadCells(const unsigned long numberOfCells, const int *xBin, const int *yBin,
+                           const unsigned char *isSelected, const unsigned int bit,
+                           unsigned int *masks) const
+{
+   thread_local std::vector<int> cellIndices;
+   cellIndices.resize(numberOfCells);
+   int *indices = cellIndices.data();
+
+   const int bitsPerRow = wordsPerRow*bitsPerWord;
+
+   #pragma omp simd
+   for (unsigned long i = 0; i < numberOfCells; i++)
+   {
+      const bool isInRange = (xBin[i] >= xMin && xBin[i] < xMax && 
+                              yBin[i] >= yMin && yBin[i] < yMax);
+      indices[i] = isInRange ? yBin[i]*bitsPerRow + xBin[i] : -1;
+   }
+
+   for (unsigned long i = 0; i < numberOfCells; i++)
+   {
+      masks[i] |= bit*static_cast<unsigned int>(isSelected[i] && IsDeadCellIndex(indices[i]));
+   }
+}
+
+void FusedDeadMap::Set(const DeadMap *geometricMap, const unsigned int geometricBit,
+                       const DeadMap *timingMap, const unsigned int timingBit,
+                       const bool isTimingEdgeExcluded)
+{
+   outsideBits = (geometricMap ? geometricBit : 0) | (timingMap ? timingBit : 0);
+
+   cells.clear();
+   xNBins = 0;
+   yNBins = 0;
+   if (!geometricMap && !timingMap) return;
+
+   // map covers the ranges of both deadmaps
+   double xLow = 1e31, xUp = -1e31, yLow = 1e31, yUp = -1e31;
+   for (const DeadMap *map : {geometricMap, timingMap})
+   {
+      if (!map) continue;
+      xLow = std::min(xLow, map->GetXMin());
+      xUp = std::max(xUp, map->GetXMax());
+      yLow = std::min(yLow, map->GetYMin());
+      yUp = std::max(yUp, map->GetYMax());
+   }
+
+   xMin = static_cast<int>(std::floor(xLow));
+   yMin = static_cast<int>(std::floor(yLow));
+   xNBins = static_cast<int>(std::ceil(xUp)) - xMin;
+   yNBins = static_cast<int>(std::ceil(yUp)) - yMin;
+
+   cells.assign(static_cast<unsigned long>(xNBins*yNBins), 0);
+
+   for (int i = 0; i < yNBins; i++)
+   {
+      const int yBin = yMin + i;
+      for (int j = 0; j < xNBins; j++)
+      {
+         const int xBin = xMin + j;
+         unsigned int bits = 0;
+
+         if (geometricMap && (!geometricMap->IsCellInRange(xBin, yBin) || 
+                              geometricMap->IsDeadCell(xBin, yBin)))
+         {
+            bits |= geometricBit;
+         }
+
+         if (timingMap)
+         {
+            const bool isDead = (isTimingEdgeExcluded ? timingMap->IsDead(xBin, yBin) :
+                                 (!timingMap->IsCellInRange(xBin, yBin) ||
+                                  timingMap->IsDeadCell(xBin, yBin)));
+            if (isDead) bits |= timingBit;
+         }
+
+         cells[i*xNBins + j] = static_cast<unsigned short>(bits);
+      }
+   }
+}
+
+#endif /* DEAD_MAP_CPP */
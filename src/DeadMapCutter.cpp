@@ -12,6 +12,74 @@
 
 #include "../include/DeadMapCutter.hpp"
 
+// returns the centres of the bins of the axis apart from underflow and overflow
+static std::vector<double> GetBinCenters(const TAxis *axis)
+{
+   std::vector<double> binCenters(static_cast<unsigned long>(axis->GetNbins()));
+   for (int i = 0; i < axis->GetNbins(); i++) binCenters[i] = axis->GetBinCenter(i + 1);
+   return binCenters;
+}
+
+// sums the contents of the bins apart from underflow and overflow
+// (integral) and of the bins among them that are not dead (liveIntegral)
+template<typename T>
+static void SumContents(const T *contents, const std::vector<unsigned char>& deadBins, 
+                        const int xNBins, const int yNBins, double& integral, double& liveIntegral)
+{
+   for (int j = 1; j <= yNBins; j++)
+   {
+      for (int i = 1; i <= xNBins; i++)
+      {
+         const int bin = j*(xNBins + 2) + i;
+         integral += contents[bin];
+         if (!deadBins[bin]) liveIntegral += contents[bin];
+      }
+   }
+}
+
+// sets to 0 the contents of the dead bins
+template<typename T>
+static void ZeroDeadBins(T *contents, const std::vector<unsigned char>& deadBins)
+{
+   for (unsigned long bin = 0; bin < deadBins.size(); bin++)
+   {
+      if (deadBins[bin]) contents[bin] = 0;
+   }
+}
+
+// returns the fraction of the integral of the heatmap that is outside of the dead bins
+static double GetHistLiveFraction(const TH2 *hist, const std::vector<unsigned char>& deadBins)
+{
+   const int xNBins = hist->GetXaxis()->GetNbins();
+   const int yNBins = hist->GetYaxis()->GetNbins();
+
+   double integral = 0., liveIntegral = 0.;
+
+   if (const TArrayF *contents = dynamic_cast<const TArrayF *>(hist))
+   {
+      SumContents(contents->GetArray(), deadBins, xNBins, yNBins, integral, liveIntegral);
+   }
+   else if (const TArrayD *contents = dynamic_cast<const TArrayD *>(hist))
+   {
+      SumContents(contents->GetArray(), deadBins, xNBins, yNBins, integral, liveIntegral);
+   }
+   else
+   {
+      for (int j = 1; j <= yNBins; j++)
+      {
+         for (int i = 1; i <= xNBins; i++)
+         {
+            const double content = hist->GetBinContent(i, j);
+            integral += content;
+            if (!deadBins[hist->GetBin(i, j)]) liveIntegral += content;
+         }
+      }
+   }
+
+   if (integral == 0.) return 0.;
+   return liveIntegral/integral;
+}
+
 DeadMapCutter::DeadMapCutter() {}
 
 DeadMapCutter::DeadMapCutter(const std::string& runName, const std::string& options, 
@@ -29,51 +97,54 @@ void DeadMapCutter::Initialize(const std::string& runName, const std::string& op
                            " while 7 has been expected");
    }
 
+   bool useDC = false, usePC1 = false, usePC2 = false, usePC3 = false;
+   bool useTOFe = false, useTOFw = false, useEMCal = false;
+   bool useTOFeTiming = false, useTOFwTiming = false, useEMCalTiming = false;
+
    const std::string inputDirDM = deadmapsDir + "/" + runName + "/";
    const std::string inputDirTDM = timingDeadmapsDir + "/" + runName + "/";
 
    if (options[0] == '1')
    {
-      useDC = (SetDeadAreas(inputDirDM + "DCeX1_0.txt", cutAreasDCe0X1, cutAreasDCe0X1Range) &&
-               SetDeadAreas(inputDirDM + "DCeX1_1.txt", cutAreasDCe1X1, cutAreasDCe1X1Range) &&
-               SetDeadAreas(inputDirDM + "DCwX1_0.txt", cutAreasDCw0X1, cutAreasDCw0X1Range) &&
-               SetDeadAreas(inputDirDM + "DCwX1_1.txt", cutAreasDCw1X1, cutAreasDCw1X1Range) &&
-               SetDeadAreas(inputDirDM + "DCeX2_0.txt", cutAreasDCe0X2, cutAreasDCe0X2Range) &&
-               SetDeadAreas(inputDirDM + "DCeX2_1.txt", cutAreasDCe1X2, cutAreasDCe1X2Range) &&
-               SetDeadAreas(inputDirDM + "DCwX2_0.txt", cutAreasDCw0X2, cutAreasDCw0X2Range) &&
-               SetDeadAreas(inputDirDM + "DCwX2_1.txt", cutAreasDCw1X2, cutAreasDCw1X2Range));
+      useDC = (cutAreasDCe0X1.Read(inputDirDM + "DCeX1_0.txt") &&
+               cutAreasDCe1X1.Read(inputDirDM + "DCeX1_1.txt") &&
+               cutAreasDCw0X1.Read(inputDirDM + "DCwX1_0.txt") &&
+               cutAreasDCw1X1.Read(inputDirDM + "DCwX1_1.txt") &&
+               cutAreasDCe0X2.Read(inputDirDM + "DCeX2_0.txt") &&
+               cutAreasDCe1X2.Read(inputDirDM + "DCeX2_1.txt") &&
+               cutAreasDCw0X2.Read(inputDirDM + "DCwX2_0.txt") &&
+               cutAreasDCw1X2.Read(inputDirDM + "DCwX2_1.txt"));
    }
    else CppTools::PrintInfo("DeadMapCutter: Cuts for DC were specified to be not initialized");
    if (!useDC) CppTools::PrintInfo("DeadMapCutter: No cuts for DC will be applied");
 
    if (options[1] == '1')
    {
-      usePC1 = (SetDeadAreas(inputDirDM + "PC1e.txt", cutAreasPC1e, cutAreasPC1eRange) &&
-                SetDeadAreas(inputDirDM + "PC1w.txt", cutAreasPC1w, cutAreasPC1wRange));
+      usePC1 = (cutAreasPC1e.Read(inputDirDM + "PC1e.txt") &&
+                cutAreasPC1w.Read(inputDirDM + "PC1w.txt"));
    }
    else CppTools::PrintInfo("DeadMapCutter: Cuts for PC1 were specified to be not initialized");
    if (!usePC1) CppTools::PrintInfo("DeadMapCutter: No cuts for PC1 will be applied");
 
    if (options[2] == '1')
    {
-      usePC2 = SetDeadAreas(inputDirDM + "PC2.txt", cutAreasPC2, cutAreasPC2Range);
+      usePC2 = cutAreasPC2.Read(inputDirDM + "PC2.txt");
    }
    else CppTools::PrintInfo("DeadMapCutter: Cuts for PC2 were specified to be not initialized");
    if (!usePC2) CppTools::PrintInfo("DeadMapCutter: No cuts for PC2 will be applied");
 
    if (options[3] == '1')
    {
-      usePC3 = (SetDeadAreas(inputDirDM + "PC3e.txt", cutAreasPC3e, cutAreasPC3eRange) && 
-                SetDeadAreas(inputDirDM + "PC3w.txt", cutAreasPC3w, cutAreasPC3wRange));
+      usePC3 = (cutAreasPC3e.Read(inputDirDM + "PC3e.txt") && 
+                cutAreasPC3w.Read(inputDirDM + "PC3w.txt"));
    }
    else CppTools::PrintInfo("DeadMapCutter: Cuts for PC3 were specified to be not initialized");
    if (!usePC3) CppTools::PrintInfo("DeadMapCutter: No cuts for PC3 will be applied");
 
    if (options[4] == '1')
    {
-      useTOFe = SetDeadAreas(inputDirDM + "TOFe.txt", cutAreasTOFe, cutAreasTOFeRange);
-      useTOFeTiming = SetDeadAreas(inputDirTDM + "TimingDeadmapTOFe.txt", 
-                                   cutAreasTimingTOFe, cutAreasTimingTOFeRange);
+      useTOFe = cutAreasTOFe.Read(inputDirDM + "TOFe.txt");
+      useTOFeTiming = cutAreasTimingTOFe.Read(inputDirTDM + "TimingDeadmapTOFe.txt");
    }
    else CppTools::PrintInfo("DeadMapCutter: Cuts for TOFe were specified to be not initialized");
    if (!useTOFe) CppTools::PrintInfo("DeadMapCutter: No cuts for TOFe will be applied");
@@ -82,9 +153,8 @@ void DeadMapCutter::Initialize(const std::string& runName, const std::string& op
 
    if (options[5] == '1')
    {
-      useTOFw = SetDeadAreas(inputDirDM + "TOFw.txt", cutAreasTOFw, cutAreasTOFwRange);
-      useTOFwTiming = SetDeadAreas(inputDirTDM + "TimingDeadmapTOFw.txt", 
-                                   cutAreasTimingTOFw, cutAreasTimingTOFwRange);
+      useTOFw = cutAreasTOFw.Read(inputDirDM + "TOFw.txt");
+      useTOFwTiming = cutAreasTimingTOFw.Read(inputDirTDM + "TimingDeadmapTOFw.txt");
    }
    else CppTools::PrintInfo("DeadMapCutter: Cuts for TOFe were specified to be not initialized");
    if (!useTOFw) CppTools::PrintInfo("DeadMapCutter: No cuts for TOFe will be applied");
@@ -96,1725 +166,599 @@ void DeadMapCutter::Initialize(const std::string& runName, const std::string& op
       useEMCal = true;
       for (int i = 0; i < 4 && useEMCal; i++)
       {
-         useEMCal = (SetDeadAreas(inputDirDM + "EMCale" + std::to_string(i) + ".txt", 
-                                  cutAreasEMCale[i], cutAreasEMCaleRange[i]) &&
-                     SetDeadAreas(inputDirDM + "EMCalw" + std::to_string(i) + ".txt", 
-                                  cutAreasEMCalw[i], cutAreasEMCalwRange[i]));
+         useEMCal = (cutAreasEMCale[i].Read(inputDirDM + "EMCale" + std::to_string(i) + ".txt") &&
+                     cutAreasEMCalw[i].Read(inputDirDM + "EMCalw" + std::to_string(i) + ".txt"));
       }
       useEMCalTiming = true;
       for (int i = 0; i < 4 && useEMCalTiming; i++)
       {
-         useEMCalTiming = (SetDeadAreas(inputDirTDM + "TimingDeadmapEMCale" + 
-                                        std::to_string(i) + ".txt", 
-                                        cutAreasTimingEMCale[i], cutAreasTimingEMCaleRange[i]) &&
-                           SetDeadAreas(inputDirTDM + "TimingDeadmapEMCalw" + 
-                                        std::to_string(i) + ".txt", 
-                                        cutAreasTimingEMCalw[i], cutAreasTimingEMCalwRange[i]));
+         useEMCalTiming = (cutAreasTimingEMCale[i].Read(inputDirTDM + "TimingDeadmapEMCale" +
+                                                        std::to_string(i) + ".txt") &&
+                           cutAreasTimingEMCalw[i].Read(inputDirTDM + "TimingDeadmapEMCalw" +
+                                                        std::to_string(i) + ".txt"));
       }
    }
    else CppTools::PrintInfo("DeadMapCutter: Cuts for EMCal were specified to be not initialized");
    if (!useEMCal) CppTools::PrintInfo("DeadMapCutter: No cuts for EMCal will be applied");
    if (!useEMCalTiming) CppTools::PrintInfo("DeadMapCutter: No cuts for EMCal will be "\
                                            "applied for improved timing");
+
+   // flags of the bins of the heatmaps are evaluated again for the new deadmaps
+   deadBinsCaches.clear();
+
+   usedMaps = 0;
+   if (useDC) usedMaps |= DEAD_DC;
+   if (usePC1) usedMaps |= DEAD_PC1;
+   if (usePC2) usedMaps |= DEAD_PC2;
+   if (usePC3) usedMaps |= DEAD_PC3;
+   if (useTOFe) usedMaps |= DEAD_TOFE;
+   if (useTOFw) usedMaps |= DEAD_TOFW;
+   if (useEMCal) usedMaps |= DEAD_EMCAL;
+   if (useTOFeTiming) usedMaps |= DEAD_TIMING_TOFE;
+   if (useTOFwTiming) usedMaps |= DEAD_TIMING_TOFW;
+   // timing deadmaps of EMCal are only applied together with the geometric ones
+   if (useEMCal && useEMCalTiming) usedMaps |= DEAD_TIMING_EMCAL;
+
+   fusedCutAreasTOFe.Set(useTOFe ? &cutAreasTOFe : nullptr, DEAD_TOFE,
+                         useTOFeTiming ? &cutAreasTimingTOFe : nullptr, DEAD_TIMING_TOFE);
+   fusedCutAreasTOFw.Set(useTOFw ? &cutAreasTOFw : nullptr, DEAD_TOFW,
+                         useTOFwTiming ? &cutAreasTimingTOFw : nullptr, DEAD_TIMING_TOFW);
+   const bool useFusedEMCalTiming = (usedMaps & DEAD_TIMING_EMCAL);
+   for (int i = 0; i < 4; i++)
+   {
+      // edges of the range are excluded for EMCal timing deadmaps
+      fusedCutAreasEMCale[i].Set(useEMCal ? &cutAreasEMCale[i] : nullptr, DEAD_EMCAL,
+                                 useFusedEMCalTiming ? &cutAreasTimingEMCale[i] : nullptr,
+                                 DEAD_TIMING_EMCAL, true);
+      fusedCutAreasEMCalw[i].Set(useEMCal ? &cutAreasEMCalw[i] : nullptr, DEAD_EMCAL,
+                                 useFusedEMCalTiming ? &cutAreasTimingEMCalw[i] : nullptr,
+                                 DEAD_TIMING_EMCAL, true);
+   }
 }
 
 bool DeadMapCutter::IsDeadDC(const int dcarm, const double zDC, 
                              const double board, const double alpha)
 {
-   if (!useDC) return false;
-   if (dcarm == 0) // DCe
-   {
-      if (zDC >= 0)
-      {
-         if (board <= cutAreasDCe0X1Range[0] || board >= cutAreasDCe0X1Range[1] ||
-             alpha <= cutAreasDCe0X1Range[2] || alpha >= cutAreasDCe0X1Range[3] ||
-             board <= cutAreasDCe0X2Range[0] || board >= cutAreasDCe0X2Range[1] ||
-             alpha <= cutAreasDCe0X2Range[2] || alpha >= cutAreasDCe0X2Range[3]) return true;
-
-         const short yBinX1 = static_cast<short>((alpha - cutAreasDCe0X1Range[2])/
-                                                (cutAreasDCe0X1Range[3] - cutAreasDCe0X1Range[2])*
-                                                static_cast<double>(cutAreasDCe0X1.size()));
-         const short xBinX1 = static_cast<short>((board - cutAreasDCe0X1Range[0])/
-                                                (cutAreasDCe0X1Range[1] - cutAreasDCe0X1Range[0])*
-                                                static_cast<double>(cutAreasDCe0X1[0].size()));
-         const short yBinX2 = static_cast<short>((alpha - cutAreasDCe0X2Range[2])/
-                                                (cutAreasDCe0X2Range[3] - cutAreasDCe0X2Range[2])*
-                                                static_cast<double>(cutAreasDCe0X2.size()));
-         const short xBinX2 = static_cast<short>((board - cutAreasDCe0X2Range[0])/
-                                                (cutAreasDCe0X2Range[1] - cutAreasDCe0X2Range[0])*
-                                                static_cast<double>(cutAreasDCe0X2[0].size()));
-
-         return (cutAreasDCe0X1[yBinX1][xBinX1] || cutAreasDCe0X2[yBinX2][xBinX2]);
-      }
-      else
-      {
-         if (board <= cutAreasDCe1X1Range[0] || board >= cutAreasDCe1X1Range[1] ||
-             alpha <= cutAreasDCe1X1Range[2] || alpha >= cutAreasDCe1X1Range[3] ||
-             board <= cutAreasDCe1X2Range[0] || board >= cutAreasDCe1X2Range[1] ||
-             alpha <= cutAreasDCe1X2Range[2] || alpha >= cutAreasDCe1X2Range[3]) return true;
-
-         const short yBinX1 = static_cast<short>((alpha - cutAreasDCe1X1Range[2])/
-                                                (cutAreasDCe1X1Range[3] - cutAreasDCe1X1Range[2])*
-                                                static_cast<double>(cutAreasDCe1X1.size()));
-         const short xBinX1 = static_cast<short>((board - cutAreasDCe1X1Range[0])/
-                                                (cutAreasDCe1X1Range[1] - cutAreasDCe1X1Range[0])*
-                                                static_cast<double>(cutAreasDCe1X1[0].size()));
-         const short yBinX2 = static_cast<short>((alpha - cutAreasDCe1X2Range[2])/
-                                                (cutAreasDCe1X2Range[3] - cutAreasDCe1X2Range[2])*
-                                                static_cast<double>(cutAreasDCe1X2.size()));
-         const short xBinX2 = static_cast<short>((board - cutAreasDCe1X2Range[0])/
-                                                (cutAreasDCe1X2Range[1] - cutAreasDCe1X2Range[0])*
-                                                static_cast<double>(cutAreasDCe1X2[0].size()));
-
-         return (cutAreasDCe1X1[yBinX1][xBinX1] || cutAreasDCe1X2[yBinX2][xBinX2]);
-      }
-   }
-   // DCw
-   if (zDC >= 0)
-   {
-      if (board <= cutAreasDCw0X1Range[0] || board >= cutAreasDCw0X1Range[1] ||
-          alpha <= cutAreasDCw0X1Range[2] || alpha >= cutAreasDCw0X1Range[3] ||
-          board <= cutAreasDCw0X2Range[0] || board >= cutAreasDCw0X2Range[1] ||
-          alpha <= cutAreasDCw0X2Range[2] || alpha >= cutAreasDCw0X2Range[3]) return true;
-
-      const short yBinX1 = static_cast<short>((alpha - cutAreasDCw0X1Range[2])/
-                                             (cutAreasDCw0X1Range[3] - cutAreasDCw0X1Range[2])*
-                                             static_cast<double>(cutAreasDCw0X1.size()));
-      const short xBinX1 = static_cast<short>((board - cutAreasDCw0X1Range[0])/
-                                             (cutAreasDCw0X1Range[1] - cutAreasDCw0X1Range[0])*
-                                             static_cast<double>(cutAreasDCw0X1[0].size()));
-      const short yBinX2 = static_cast<short>((alpha - cutAreasDCw0X2Range[2])/
-                                             (cutAreasDCw0X2Range[3] - cutAreasDCw0X2Range[2])*
-                                             static_cast<double>(cutAreasDCw0X2.size()));
-      const short xBinX2 = static_cast<short>((board - cutAreasDCw0X2Range[0])/
-                                             (cutAreasDCw0X2Range[1] - cutAreasDCw0X2Range[0])*
-                                             static_cast<double>(cutAreasDCw0X2[0].size()));
-
-      return (cutAreasDCw0X1[yBinX1][xBinX1] || cutAreasDCw0X2[yBinX2][xBinX2]);
-   }
-   else
-   {
-      if (board <= cutAreasDCw1X1Range[0] || board >= cutAreasDCw1X1Range[1] ||
-          alpha <= cutAreasDCw1X1Range[2] || alpha >= cutAreasDCw1X1Range[3] ||
-          board <= cutAreasDCw1X2Range[0] || board >= cutAreasDCw1X2Range[1] ||
-          alpha <= cutAreasDCw1X2Range[2] || alpha >= cutAreasDCw1X2Range[3]) return true;
-
-      const short yBinX1 = static_cast<short>((alpha - cutAreasDCw1X1Range[2])/
-                                             (cutAreasDCw1X1Range[3] - cutAreasDCw1X1Range[2])*
-                                             static_cast<double>(cutAreasDCw1X1.size()));
-      const short xBinX1 = static_cast<short>((board - cutAreasDCw1X1Range[0])/
-                                             (cutAreasDCw1X1Range[1] - cutAreasDCw1X1Range[0])*
-                                             static_cast<double>(cutAreasDCw1X1[0].size()));
-      const short yBinX2 = static_cast<short>((alpha - cutAreasDCw1X2Range[2])/
-                                             (cutAreasDCw1X2Range[3] - cutAreasDCw1X2Range[2])*
-                                             static_cast<double>(cutAreasDCw1X2.size()));
-      const short xBinX2 = static_cast<short>((board - cutAreasDCw1X2Range[0])/
-                                             (cutAreasDCw1X2Range[1] - cutAreasDCw1X2Range[0])*
-                                             static_cast<double>(cutAreasDCw1X2[0].size()));
-
-      return (cutAreasDCw1X1[yBinX1][xBinX1] || cutAreasDCw1X2[yBinX2][xBinX2]);
-   }
+   if (!(usedMaps & DEAD_DC)) return false;
+   return (GetMapDCX1(dcarm, zDC).IsDead(board, alpha) || 
+           GetMapDCX2(dcarm, zDC).IsDead(board, alpha));
 }
 
 bool DeadMapCutter::IsDeadPC1(const int dcarm, const double ppc1z, const double ppc1phi)
 {
-   if (!usePC1) return false;
-   if (dcarm == 0) // PC1e
-   {
-      if (ppc1z <= cutAreasPC1eRange[0] || ppc1z >= cutAreasPC1eRange[1] ||
-          ppc1phi <= cutAreasPC1eRange[2] || ppc1phi >= cutAreasPC1eRange[3]) return true;
-
-      const short yBin = static_cast<short>((ppc1phi - cutAreasPC1eRange[2])/
-                                            (cutAreasPC1eRange[3] - cutAreasPC1eRange[2])*
-                                            static_cast<double>(cutAreasPC1e.size()));
-      const short xBin = static_cast<short>((ppc1z - cutAreasPC1eRange[0])/
-                                            (cutAreasPC1eRange[1] - cutAreasPC1eRange[0])*
-                                            static_cast<double>(cutAreasPC1e[0].size()));
-      return cutAreasPC1e[yBin][xBin];
-   }
-   // PC1w
-   if (ppc1z <= cutAreasPC1wRange[0] || ppc1z >= cutAreasPC1wRange[1] ||
-       ppc1phi <= cutAreasPC1wRange[2] || ppc1phi >= cutAreasPC1wRange[3]) return true;
-
-   const short yBin = static_cast<short>((ppc1phi - cutAreasPC1wRange[2])/
-                                         (cutAreasPC1wRange[3] - cutAreasPC1wRange[2])*
-                                         static_cast<double>(cutAreasPC1w.size()));
-   const short xBin = static_cast<short>((ppc1z - cutAreasPC1wRange[0])/
-                                         (cutAreasPC1wRange[1] - cutAreasPC1wRange[0])*
-                                         static_cast<double>(cutAreasPC1w[0].size()));
-   return cutAreasPC1w[yBin][xBin];
+   if (!(usedMaps & DEAD_PC1)) return false;
+   if (dcarm == 0) return cutAreasPC1e.IsDead(ppc1z, ppc1phi);
+   return cutAreasPC1w.IsDead(ppc1z, ppc1phi);
 }
 
 bool DeadMapCutter::IsDeadPC2(const double ppc2z, const double ppc2phi)
 {
-   if (!usePC2) return false;
-   if (ppc2z <= cutAreasPC2Range[0] || ppc2z >= cutAreasPC2Range[1] ||
-       ppc2phi <= cutAreasPC2Range[2] || ppc2phi >= cutAreasPC2Range[3]) return true;
-
-   const short yBin = static_cast<short>((ppc2phi - cutAreasPC2Range[2])/
-                                         (cutAreasPC2Range[3] - cutAreasPC2Range[2])*
-                                         static_cast<double>(cutAreasPC2.size()));
-   const short xBin = static_cast<short>((ppc2z - cutAreasPC2Range[0])/
-                                         (cutAreasPC2Range[1] - cutAreasPC2Range[0])*
-                                         static_cast<double>(cutAreasPC2[0].size()));
-   return cutAreasPC2[yBin][xBin];
+   if (!(usedMaps & DEAD_PC2)) return false;
+   return cutAreasPC2.IsDead(ppc2z, ppc2phi);
 }
 
 bool DeadMapCutter::IsDeadPC3(const int dcarm, const double ppc3z, const double ppc3phi)
 {
-   if (!usePC3) return false;
-   if (dcarm == 0) // PC3e
-   {
-      if (ppc3z <= cutAreasPC3eRange[0] || ppc3z >= cutAreasPC3eRange[1] ||
-          ppc3phi <= cutAreasPC3eRange[2] || ppc3phi >= cutAreasPC3eRange[3]) return true;
-
-      const short yBin = static_cast<short>((ppc3phi - cutAreasPC3eRange[2])/
-                                            (cutAreasPC3eRange[3] - cutAreasPC3eRange[2])*
-                                            static_cast<double>(cutAreasPC3e.size()));
-      const short xBin = static_cast<short>((ppc3z - cutAreasPC3eRange[0])/
-                                            (cutAreasPC3eRange[1] - cutAreasPC3eRange[0])*
-                                            static_cast<double>(cutAreasPC3e[0].size()));
-      return cutAreasPC3e[yBin][xBin];
-   }
-   // PC3w
-   if (ppc3z <= cutAreasPC3wRange[0] || ppc3z >= cutAreasPC3wRange[1] ||
-       ppc3phi <= cutAreasPC3wRange[2] || ppc3phi >= cutAreasPC3wRange[3]) return true;
-
-   const short yBin = static_cast<short>((ppc3phi - cutAreasPC3wRange[2])/
-                                         (cutAreasPC3wRange[3] - cutAreasPC3wRange[2])*
-                                         static_cast<double>(cutAreasPC3w.size()));
-   const short xBin = static_cast<short>((ppc3z - cutAreasPC3wRange[0])/
-                                         (cutAreasPC3wRange[1] - cutAreasPC3wRange[0])*
-                                         static_cast<double>(cutAreasPC3w[0].size()));
-   return cutAreasPC3w[yBin][xBin];
+   if (!(usedMaps & DEAD_PC3)) return false;
+   if (dcarm == 0) return cutAreasPC3e.IsDead(ppc3z, ppc3phi);
+   return cutAreasPC3w.IsDead(ppc3z, ppc3phi);
 }
 
 bool DeadMapCutter::IsDeadTOFe(const int chamber, const int slat)
 {
-   if (!useTOFe) return false;
-   if (chamber < cutAreasTOFeRange[0] || chamber >= cutAreasTOFeRange[1] ||
-       slat < cutAreasTOFeRange[2] || slat >= cutAreasTOFeRange[3]) return true;
-
-   return cutAreasTOFe[slat][chamber];
+   return GetDeadTOFe(chamber, slat) & DEAD_TOFE;
 }
 
 bool DeadMapCutter::IsDeadTOFw(const int chamber, const int strip)
 {
-   if (!useTOFw) return false;
-
-   if (chamber < cutAreasTOFwRange[0] || chamber >= cutAreasTOFwRange[1] ||
-       strip < cutAreasTOFwRange[2] || strip >= cutAreasTOFwRange[3]) return true;
-
-   return cutAreasTOFw[strip][chamber];
+   return GetDeadTOFw(chamber, strip) & DEAD_TOFW;
 }
 
 bool DeadMapCutter::IsDeadEMCal(const int dcarm, const int sector, 
                                 const int yTower, const int zTower)
 {
-   if (!useEMCal) return false;
-   if (dcarm == 0) // EMCale
-   {
-      if (yTower < cutAreasEMCaleRange[sector][0] || 
-          yTower >= cutAreasEMCaleRange[sector][1] ||
-          zTower < cutAreasEMCaleRange[sector][2] || 
-          zTower >= cutAreasEMCaleRange[sector][3]) return true;
-
-      return cutAreasEMCale[sector][zTower][yTower];
-   }
-   // EMCalw
-   if (yTower < cutAreasEMCalwRange[sector][0] || 
-       yTower >= cutAreasEMCalwRange[sector][1] ||
-       zTower < cutAreasEMCalwRange[sector][2] || 
-       zTower >= cutAreasEMCalwRange[sector][3]) return true;
-
-   return cutAreasEMCalw[sector][zTower][yTower];
+   return GetDeadEMCal(dcarm, sector, yTower, zTower) & DEAD_EMCAL;
 }
 
 bool DeadMapCutter::IsDeadTimingTOFe(const int chamber, const int slat)
 {
-   if (!useTOFeTiming) return false;
-   if (chamber < cutAreasTimingTOFeRange[0] || chamber >= cutAreasTimingTOFeRange[1] ||
-       slat < cutAreasTimingTOFeRange[2] || slat >= cutAreasTimingTOFeRange[3]) return true;
-
-   return cutAreasTimingTOFe[slat][chamber];
+   return GetDeadTOFe(chamber, slat) & DEAD_TIMING_TOFE;
 }
 
 bool DeadMapCutter::IsDeadTimingTOFw(const int chamber, const int strip)
 {
-   if (!useTOFwTiming) return false;
-
-   if (chamber < cutAreasTimingTOFwRange[0] || chamber >= cutAreasTimingTOFwRange[1] ||
-       strip < cutAreasTimingTOFwRange[2] || strip >= cutAreasTimingTOFwRange[3]) return true;
-
-   return cutAreasTimingTOFw[strip][chamber];
+   return GetDeadTOFw(chamber, strip) & DEAD_TIMING_TOFW;
 }
 
 bool DeadMapCutter::IsDeadTimingEMCal(const int dcarm, const int sector, 
                                       const int yTower, const int zTower)
 {
-   if (!useEMCal) return false;
-   if (dcarm == 0) // EMCale
-   {
-      if (yTower <= cutAreasTimingEMCaleRange[sector][0] || 
-          yTower >= cutAreasTimingEMCaleRange[sector][1] ||
-          zTower <= cutAreasTimingEMCaleRange[sector][2] || 
-          zTower >= cutAreasTimingEMCaleRange[sector][3]) return true;
-
-      return cutAreasTimingEMCale[sector][zTower][yTower];
-   }
-   // EMCalw
-   if (yTower <= cutAreasTimingEMCalwRange[sector][0] || 
-       yTower >= cutAreasTimingEMCalwRange[sector][1] ||
-       zTower <= cutAreasTimingEMCalwRange[sector][2] || 
-       zTower >= cutAreasTimingEMCalwRange[sector][3]) return true;
-
-   return cutAreasTimingEMCalw[sector][zTower][yTower];
-}
-
-bool DeadMapCutter::SetDeadAreas(const std::string& inputFileName,
-                                 std::vector<std::vector<bool>>& cutAreas, double *ranges)
-{
-   if (!std::filesystem::exists(inputFileName))
-   {
-      CppTools::PrintWarning("DeadMapCutter: File " + inputFileName + " does not exists");
-      return false;
-   }
-
-   std::ifstream inputFile(inputFileName);
-
-   int xNBins, yNBins;
-   bool isUnexpectedEndOfFile = false;
-
-   if (!(inputFile >> xNBins >> ranges[0] >> ranges[1] >> yNBins >> ranges[2] >> ranges[3]))
-   {
-      isUnexpectedEndOfFile = true;
-   }
-
-   cutAreas.resize(yNBins);
-
-   for (int i = 0; i < yNBins; i++)
-   {
-      cutAreas[i].resize(xNBins);
-      for (int j = 0; j < xNBins; j++)
-      {
-         bool tmp;
-         if (!(inputFile >> tmp)) 
-         {
-            isUnexpectedEndOfFile = true;
-            break;
-         }
-         cutAreas[i][j] = tmp;
-      }
-   }
-
-   if (isUnexpectedEndOfFile) 
-   {
-      CppTools::PrintError("DeadMapCutter: Unexpected end of file: " + inputFileName);
-   }
-
-   return true;
+   return GetDeadEMCal(dcarm, sector, yTower, zTower) & DEAD_TIMING_EMCAL;
 }
 
 bool DeadMapCutter::IsDeadDCLoose(const int dcarm, const double zDC, 
                                   const double board, const double alpha,
                                   const double boardVar, const double alphaVar)
 {
-   if (!useDC) return false;
-   if (dcarm == 0) // DCe
-   {
-      if (zDC >= 0)
-      {
-         if (board <= cutAreasDCe0X1Range[0] || board >= cutAreasDCe0X1Range[1] ||
-             alpha <= cutAreasDCe0X1Range[2] || alpha >= cutAreasDCe0X1Range[3] ||
-             board <= cutAreasDCe0X2Range[0] || board >= cutAreasDCe0X2Range[1] ||
-             alpha <= cutAreasDCe0X2Range[2] || alpha >= cutAreasDCe0X2Range[3]) return true;
-
-         short yBinX1Min = static_cast<short>((alpha - alphaVar - cutAreasDCe0X1Range[2])/
-                                              (cutAreasDCe0X1Range[3] - cutAreasDCe0X1Range[2])*
-                                              static_cast<double>(cutAreasDCe0X1.size()));
-         short xBinX1Min = static_cast<short>((board - boardVar - cutAreasDCe0X1Range[0])/
-                                              (cutAreasDCe0X1Range[1] - cutAreasDCe0X1Range[0])*
-                                              static_cast<double>(cutAreasDCe0X1[0].size()));
-         short yBinX2Min = static_cast<short>((alpha - alphaVar - cutAreasDCe0X2Range[2])/
-                                              (cutAreasDCe0X2Range[3] - cutAreasDCe0X2Range[2])*
-                                              static_cast<double>(cutAreasDCe0X2.size()));
-         short xBinX2Min = static_cast<short>((board - boardVar - cutAreasDCe0X2Range[0])/
-                                              (cutAreasDCe0X2Range[1] - cutAreasDCe0X2Range[0])*
-                                              static_cast<double>(cutAreasDCe0X2[0].size()));
-
-         short yBinX1Max = static_cast<short>((alpha + alphaVar - cutAreasDCe0X1Range[2])/
-                                              (cutAreasDCe0X1Range[3] - cutAreasDCe0X1Range[2])*
-                                              static_cast<double>(cutAreasDCe0X1.size()));
-         short xBinX1Max = static_cast<short>((board + boardVar - cutAreasDCe0X1Range[0])/
-                                              (cutAreasDCe0X1Range[1] - cutAreasDCe0X1Range[0])*
-                                              static_cast<double>(cutAreasDCe0X1[0].size()));
-         short yBinX2Max = static_cast<short>((alpha + alphaVar - cutAreasDCe0X2Range[2])/
-                                              (cutAreasDCe0X2Range[3] - cutAreasDCe0X2Range[2])*
-                                              static_cast<double>(cutAreasDCe0X2.size()));
-         short xBinX2Max = static_cast<short>((board + boardVar - cutAreasDCe0X2Range[0])/
-                                              (cutAreasDCe0X2Range[1] - cutAreasDCe0X2Range[0])*
-                                              static_cast<double>(cutAreasDCe0X2[0].size()));
-
-         if (yBinX1Min < 0) yBinX1Min = 0;
-         if (xBinX1Min < 0) xBinX1Min = 0;
-         if (yBinX2Min < 0) yBinX2Min = 0;
-         if (xBinX2Min < 0) xBinX2Min = 0;
-
-         if (yBinX1Max >= static_cast<short>(cutAreasDCe0X1.size())) 
-            yBinX1Max = static_cast<short>(cutAreasDCe0X1.size()) - 1;
-         if (xBinX1Max >= static_cast<short>(cutAreasDCe0X1[0].size())) 
-            xBinX1Max = static_cast<short>(cutAreasDCe0X1[0].size()) - 1;
-         if (yBinX2Max >= static_cast<short>(cutAreasDCe0X2.size())) 
-            yBinX2Max = static_cast<short>(cutAreasDCe0X2.size()) - 1;
-         if (xBinX2Max >= static_cast<short>(cutAreasDCe0X2[0].size())) 
-            xBinX2Max = static_cast<short>(cutAreasDCe0X2[0].size()) - 1;
-
-         bool isDeadDCX1 = true;
-         for (short xBin = xBinX1Min; xBin <= xBinX1Max; xBin++)
-         {
-            for (short yBin = yBinX1Min; yBin <= yBinX1Max; yBin++)
-            {
-               if (!cutAreasDCe0X1[yBin][xBin]) 
-               {
-                  isDeadDCX1 = false;
-                  break;
-               }
-            }
-         }
-
-         bool isDeadDCX2 = true;
-         for (short xBin = xBinX2Min; xBin <= xBinX2Max; xBin++)
-         {
-            for (short yBin = yBinX2Min; yBin <= yBinX2Max; yBin++)
-            {
-               if (!cutAreasDCe0X2[yBin][xBin])
-               {
-                  isDeadDCX2 = false;
-                  break;
-               }
-            }
-         }
-         return (isDeadDCX1 || isDeadDCX2);
-      }
-      else
-      {
-         if (board <= cutAreasDCe1X1Range[0] || board >= cutAreasDCe1X1Range[1] ||
-             alpha <= cutAreasDCe1X1Range[2] || alpha >= cutAreasDCe1X1Range[3] ||
-             board <= cutAreasDCe1X2Range[0] || board >= cutAreasDCe1X2Range[1] ||
-             alpha <= cutAreasDCe1X2Range[2] || alpha >= cutAreasDCe1X2Range[3]) return true;
-
-         short yBinX1Min = static_cast<short>((alpha - alphaVar - cutAreasDCe1X1Range[2])/
-                                              (cutAreasDCe1X1Range[3] - cutAreasDCe1X1Range[2])*
-                                              static_cast<double>(cutAreasDCe1X1.size()));
-         short xBinX1Min = static_cast<short>((board - boardVar - cutAreasDCe1X1Range[0])/
-                                              (cutAreasDCe1X1Range[1] - cutAreasDCe1X1Range[0])*
-                                              static_cast<double>(cutAreasDCe1X1[0].size()));
-         short yBinX2Min = static_cast<short>((alpha - alphaVar - cutAreasDCe1X2Range[2])/
-                                              (cutAreasDCe1X2Range[3] - cutAreasDCe1X2Range[2])*
-                                              static_cast<double>(cutAreasDCe1X2.size()));
-         short xBinX2Min = static_cast<short>((board - boardVar - cutAreasDCe1X2Range[0])/
-                                              (cutAreasDCe1X2Range[1] - cutAreasDCe1X2Range[0])*
-                                              static_cast<double>(cutAreasDCe1X2[0].size()));
-
-         short yBinX1Max = static_cast<short>((alpha + alphaVar - cutAreasDCe1X1Range[2])/
-                                              (cutAreasDCe1X1Range[3] - cutAreasDCe1X1Range[2])*
-                                              static_cast<double>(cutAreasDCe1X1.size()));
-         short xBinX1Max = static_cast<short>((board + boardVar - cutAreasDCe1X1Range[0])/
-                                              (cutAreasDCe1X1Range[1] - cutAreasDCe1X1Range[0])*
-                                              static_cast<double>(cutAreasDCe1X1[0].size()));
-         short yBinX2Max = static_cast<short>((alpha + alphaVar - cutAreasDCe1X2Range[2])/
-                                              (cutAreasDCe1X2Range[3] - cutAreasDCe1X2Range[2])*
-                                              static_cast<double>(cutAreasDCe1X2.size()));
-         short xBinX2Max = static_cast<short>((board + boardVar - cutAreasDCe1X2Range[0])/
-                                              (cutAreasDCe1X2Range[1] - cutAreasDCe1X2Range[0])*
-                                              static_cast<double>(cutAreasDCe1X2[0].size()));
-
-         if (yBinX1Min < 0) yBinX1Min = 0;
-         if (xBinX1Min < 0) xBinX1Min = 0;
-         if (yBinX2Min < 0) yBinX2Min = 0;
-         if (xBinX2Min < 0) xBinX2Min = 0;
-
-         if (yBinX1Max >= static_cast<short>(cutAreasDCe1X1.size())) 
-            yBinX1Max = static_cast<short>(cutAreasDCe1X1.size()) - 1;
-         if (xBinX1Max >= static_cast<short>(cutAreasDCe1X1[0].size())) 
-            xBinX1Max = static_cast<short>(cutAreasDCe1X1[0].size()) - 1;
-         if (yBinX2Max >= static_cast<short>(cutAreasDCe1X2.size())) 
-            yBinX2Max = static_cast<short>(cutAreasDCe1X2.size()) - 1;
-         if (xBinX2Max >= static_cast<short>(cutAreasDCe1X2[0].size())) 
-            xBinX2Max = static_cast<short>(cutAreasDCe1X2[0].size()) - 1;
-
-         bool isDeadDCX1 = true;
-         for (short xBin = xBinX1Min; xBin <= xBinX1Max; xBin++)
-         {
-            for (short yBin = yBinX1Min; yBin <= yBinX1Max; yBin++)
-            {
-               if(!cutAreasDCe1X1[yBin][xBin])
-               {
-                  isDeadDCX1 = false;
-                  break;
-               }
-            }
-         }
-
-         bool isDeadDCX2 = true;
-         for (short xBin = xBinX2Min; xBin <= xBinX2Max; xBin++)
-         {
-            for (short yBin = yBinX2Min; yBin <= yBinX2Max; yBin++)
-            {
-               if (!cutAreasDCe1X2[yBin][xBin])
-               {
-                  isDeadDCX2 = false;
-                  break;
-               }
-            }
-         }
-         return (isDeadDCX1 || isDeadDCX2);
-      }
-   }
-   // DCw
-   if (zDC >= 0)
-   {
-      if (board <= cutAreasDCw0X1Range[0] || board >= cutAreasDCw0X1Range[1] ||
-          alpha <= cutAreasDCw0X1Range[2] || alpha >= cutAreasDCw0X1Range[3] ||
-          board <= cutAreasDCw0X2Range[0] || board >= cutAreasDCw0X2Range[1] ||
-          alpha <= cutAreasDCw0X2Range[2] || alpha >= cutAreasDCw0X2Range[3]) return true;
-
-      short yBinX1Min = static_cast<short>((alpha - alphaVar - cutAreasDCw0X1Range[2])/
-                                           (cutAreasDCw0X1Range[3] - cutAreasDCw0X1Range[2])*
-                                           static_cast<double>(cutAreasDCw0X1.size()));
-      short xBinX1Min = static_cast<short>((board - boardVar - cutAreasDCw0X1Range[0])/
-                                           (cutAreasDCw0X1Range[1] - cutAreasDCw0X1Range[0])*
-                                           static_cast<double>(cutAreasDCw0X1[0].size()));
-      short yBinX2Min = static_cast<short>((alpha - alphaVar - cutAreasDCw0X2Range[2])/
-                                           (cutAreasDCw0X2Range[3] - cutAreasDCw0X2Range[2])*
-                                           static_cast<double>(cutAreasDCw0X2.size()));
-      short xBinX2Min = static_cast<short>((board - boardVar - cutAreasDCw0X2Range[0])/
-                                           (cutAreasDCw0X2Range[1] - cutAreasDCw0X2Range[0])*
-                                           static_cast<double>(cutAreasDCw0X2[0].size()));
-
-      short yBinX1Max = static_cast<short>((alpha + alphaVar - cutAreasDCw0X1Range[2])/
-                                           (cutAreasDCw0X1Range[3] - cutAreasDCw0X1Range[2])*
-                                           static_cast<double>(cutAreasDCw0X1.size()));
-      short xBinX1Max = static_cast<short>((board + boardVar - cutAreasDCw0X1Range[0])/
-                                           (cutAreasDCw0X1Range[1] - cutAreasDCw0X1Range[0])*
-                                           static_cast<double>(cutAreasDCw0X1[0].size()));
-      short yBinX2Max = static_cast<short>((alpha + alphaVar - cutAreasDCw0X2Range[2])/
-                                           (cutAreasDCw0X2Range[3] - cutAreasDCw0X2Range[2])*
-                                           static_cast<double>(cutAreasDCw0X2.size()));
-      short xBinX2Max = static_cast<short>((board + boardVar - cutAreasDCw0X2Range[0])/
-                                           (cutAreasDCw0X2Range[1] - cutAreasDCw0X2Range[0])*
-                                           static_cast<double>(cutAreasDCw0X2[0].size()));
-
-      if (yBinX1Min < 0) yBinX1Min = 0;
-      if (xBinX1Min < 0) xBinX1Min = 0;
-      if (yBinX2Min < 0) yBinX2Min = 0;
-      if (xBinX2Min < 0) xBinX2Min = 0;
-
-      if (yBinX1Max >= static_cast<short>(cutAreasDCw0X1.size())) 
-         yBinX1Max = static_cast<short>(cutAreasDCw0X1.size()) - 1;
-      if (xBinX1Max >= static_cast<short>(cutAreasDCw0X1[0].size())) 
-         xBinX1Max = static_cast<short>(cutAreasDCw0X1[0].size()) - 1;
-      if (yBinX2Max >= static_cast<short>(cutAreasDCw0X2.size())) 
-         yBinX2Max = static_cast<short>(cutAreasDCw0X2.size()) - 1;
-      if (xBinX2Max >= static_cast<short>(cutAreasDCw0X2[0].size())) 
-         xBinX2Max = static_cast<short>(cutAreasDCw0X2[0].size()) - 1;
-
-      bool isDeadDCX1 = true;
-      for (short xBin = xBinX1Min; xBin <= xBinX1Max; xBin++)
-      {
-         for (short yBin = yBinX1Min; yBin <= yBinX1Max; yBin++)
-         {
-            if (!cutAreasDCw0X1[yBin][xBin])
-            {
-               isDeadDCX1 = false;
-               break;
-            }
-         }
-      }
+   if (!(usedMaps & DEAD_DC)) return false;
 
-      bool isDeadDCX2 = true;
-      for (short xBin = xBinX2Min; xBin <= xBinX2Max; xBin++)
-      {
-         for (short yBin = yBinX2Min; yBin <= yBinX2Max; yBin++)
-         {
-            if (!cutAreasDCw0X2[yBin][xBin])
-            {
-               isDeadDCX2 = false;
-               break;
-            }
-         }
-      }
-      return (isDeadDCX1 || isDeadDCX2);
-   }
-   else
-   {
-      if (board <= cutAreasDCw1X1Range[0] || board >= cutAreasDCw1X1Range[1] ||
-          alpha <= cutAreasDCw1X1Range[2] || alpha >= cutAreasDCw1X1Range[3] ||
-          board <= cutAreasDCw1X2Range[0] || board >= cutAreasDCw1X2Range[1] ||
-          alpha <= cutAreasDCw1X2Range[2] || alpha >= cutAreasDCw1X2Range[3]) return true;
-
-      short yBinX1Min = static_cast<short>((alpha - alphaVar - cutAreasDCw1X1Range[2])/
-                                           (cutAreasDCw1X1Range[3] - cutAreasDCw1X1Range[2])*
-                                           static_cast<double>(cutAreasDCw1X1.size()));
-      short xBinX1Min = static_cast<short>((board - boardVar - cutAreasDCw1X1Range[0])/
-                                           (cutAreasDCw1X1Range[1] - cutAreasDCw1X1Range[0])*
-                                           static_cast<double>(cutAreasDCw1X1[0].size()));
-      short yBinX2Min = static_cast<short>((alpha - alphaVar - cutAreasDCw1X2Range[2])/
-                                           (cutAreasDCw1X2Range[3] - cutAreasDCw1X2Range[2])*
-                                           static_cast<double>(cutAreasDCw1X2.size()));
-      short xBinX2Min = static_cast<short>((board - boardVar - cutAreasDCw1X2Range[0])/
-                                           (cutAreasDCw1X2Range[1] - cutAreasDCw1X2Range[0])*
-                                           static_cast<double>(cutAreasDCw1X2[0].size()));
-
-      short yBinX1Max = static_cast<short>((alpha + alphaVar - cutAreasDCw1X1Range[2])/
-                                           (cutAreasDCw1X1Range[3] - cutAreasDCw1X1Range[2])*
-                                           static_cast<double>(cutAreasDCw1X1.size()));
-      short xBinX1Max = static_cast<short>((board + boardVar - cutAreasDCw1X1Range[0])/
-                                           (cutAreasDCw1X1Range[1] - cutAreasDCw1X1Range[0])*
-                                           static_cast<double>(cutAreasDCw1X1[0].size()));
-      short yBinX2Max = static_cast<short>((alpha + alphaVar - cutAreasDCw1X2Range[2])/
-                                           (cutAreasDCw1X2Range[3] - cutAreasDCw1X2Range[2])*
-                                           static_cast<double>(cutAreasDCw1X2.size()));
-      short xBinX2Max = static_cast<short>((board + boardVar - cutAreasDCw1X2Range[0])/
-                                           (cutAreasDCw1X2Range[1] - cutAreasDCw1X2Range[0])*
-                                           static_cast<double>(cutAreasDCw1X2[0].size()));
-
-      if (yBinX1Min < 0) yBinX1Min = 0;
-      if (xBinX1Min < 0) xBinX1Min = 0;
-      if (yBinX2Min < 0) yBinX2Min = 0;
-      if (xBinX2Min < 0) xBinX2Min = 0;
-
-      if (yBinX1Max >= static_cast<short>(cutAreasDCw1X1.size())) 
-         yBinX1Max = static_cast<short>(cutAreasDCw1X1.size()) - 1;
-      if (xBinX1Max >= static_cast<short>(cutAreasDCw1X1[0].size())) 
-         xBinX1Max = static_cast<short>(cutAreasDCw1X1[0].size()) - 1;
-      if (yBinX2Max >= static_cast<short>(cutAreasDCw1X2.size())) 
-         yBinX2Max = static_cast<short>(cutAreasDCw1X2.size()) - 1;
-      if (xBinX2Max >= static_cast<short>(cutAreasDCw1X2[0].size())) 
-         xBinX2Max = static_cast<short>(cutAreasDCw1X2[0].size()) - 1;
-
-      bool isDeadDCX1 = true;
-      for (short xBin = xBinX1Min; xBin <= xBinX1Max; xBin++)
-      {
-         for (short yBin = yBinX1Min; yBin <= yBinX1Max; yBin++)
-         {
-            if (!cutAreasDCw1X1[yBin][xBin])
-            {
-               isDeadDCX1 = false;
-               break;
-            }
-         }
-      }
+   const DeadMap& cutAreasX1 = GetMapDCX1(dcarm, zDC);
+   const DeadMap& cutAreasX2 = GetMapDCX2(dcarm, zDC);
 
-      bool isDeadDCX2 = true;
-      for (short xBin = xBinX2Min; xBin <= xBinX2Max; xBin++)
-      {
-         for (short yBin = yBinX2Min; yBin <= yBinX2Max; yBin++)
-         {
-            if (!cutAreasDCw1X2[yBin][xBin])
-            {
-               isDeadDCX2 = false;
-               break;
-            }
-         }
-      }
-      return (isDeadDCX1 || isDeadDCX2);
-   }
+   return (cutAreasX1.IsDeadLoose(board, alpha, boardVar, alphaVar) ||
+           cutAreasX2.IsDeadLoose(board, alpha, boardVar, alphaVar));
 }
 
 bool DeadMapCutter::IsDeadPC1Loose(const int dcarm, const double ppc1z, const double ppc1phi,
                                    const double ppc1zVar, const double ppc1phiVar)
 {
-   if (!usePC1) return false;
-   if (dcarm == 0) // PC1e
-   {
-      if (ppc1z <= cutAreasPC1eRange[0] || ppc1z >= cutAreasPC1eRange[1] ||
-          ppc1phi <= cutAreasPC1eRange[2] || ppc1phi >= cutAreasPC1eRange[3]) return true;
-
-      short yBinMin = static_cast<short>((ppc1phi - ppc1phiVar - cutAreasPC1eRange[2])/
-                                         (cutAreasPC1eRange[3] - cutAreasPC1eRange[2])*
-                                         static_cast<double>(cutAreasPC1e.size()));
-      short xBinMin = static_cast<short>((ppc1z - ppc1zVar - cutAreasPC1eRange[0])/
-                                         (cutAreasPC1eRange[1] - cutAreasPC1eRange[0])*
-                                         static_cast<double>(cutAreasPC1e[0].size()));
-      short yBinMax = static_cast<short>((ppc1phi + ppc1phiVar - cutAreasPC1eRange[2])/
-                                         (cutAreasPC1eRange[3] - cutAreasPC1eRange[2])*
-                                         static_cast<double>(cutAreasPC1e.size()));
-      short xBinMax = static_cast<short>((ppc1z + ppc1zVar - cutAreasPC1eRange[0])/
-                                         (cutAreasPC1eRange[1] - cutAreasPC1eRange[0])*
-                                         static_cast<double>(cutAreasPC1e[0].size()));
-
-      if (yBinMin < 0) yBinMin = 0;
-      if (xBinMin < 0) xBinMin = 0;
-      if (yBinMax >= static_cast<short>(cutAreasPC1e.size())) 
-         yBinMax = static_cast<short>(cutAreasPC1e.size()) - 1;
-      if (xBinMax >= static_cast<short>(cutAreasPC1e[0].size())) 
-         xBinMax = static_cast<short>(cutAreasPC1e[0].size()) - 1;
-
-      for (short xBin = xBinMin; xBin <= xBinMax; xBin++)
-      {
-         for (short yBin = yBinMin; yBin <= yBinMax; yBin++)
-         {
-            if (!cutAreasPC1e[yBin][xBin]) return false;
-         }
-      }
-      return true;
-   }
-   // PC1w
-   if (ppc1z <= cutAreasPC1wRange[0] || ppc1z >= cutAreasPC1wRange[1] ||
-       ppc1phi <= cutAreasPC1wRange[2] || ppc1phi >= cutAreasPC1wRange[3]) return true;
-
-   short yBinMin = static_cast<short>((ppc1phi - ppc1phiVar - cutAreasPC1wRange[2])/
-                                      (cutAreasPC1wRange[3] - cutAreasPC1wRange[2])*
-                                      static_cast<double>(cutAreasPC1w.size()));
-   short xBinMin = static_cast<short>((ppc1z - ppc1zVar - cutAreasPC1wRange[0])/
-                                      (cutAreasPC1wRange[1] - cutAreasPC1wRange[0])*
-                                      static_cast<double>(cutAreasPC1w[0].size()));
-   short yBinMax = static_cast<short>((ppc1phi + ppc1phiVar - cutAreasPC1wRange[2])/
-                                      (cutAreasPC1wRange[3] - cutAreasPC1wRange[2])*
-                                      static_cast<double>(cutAreasPC1w.size()));
-   short xBinMax = static_cast<short>((ppc1z + ppc1zVar - cutAreasPC1wRange[0])/
-                                      (cutAreasPC1wRange[1] - cutAreasPC1wRange[0])*
-                                      static_cast<double>(cutAreasPC1w[0].size()));
-
-   if (yBinMin < 0) yBinMin = 0;
-   if (xBinMin < 0) xBinMin = 0;
-   if (yBinMax >= static_cast<short>(cutAreasPC1w.size())) 
-      yBinMax = static_cast<short>(cutAreasPC1w.size()) - 1;
-   if (xBinMax >= static_cast<short>(cutAreasPC1w[0].size())) 
-      xBinMax = static_cast<short>(cutAreasPC1w[0].size()) - 1;
-
-   for (short xBin = xBinMin; xBin <= xBinMax; xBin++)
-   {
-      for (short yBin = yBinMin; yBin <= yBinMax; yBin++)
-      {
-         if (!cutAreasPC1w[yBin][xBin]) return false;
-      }
-   }
-   return true;
+   if (!(usedMaps & DEAD_PC1)) return false;
+   if (dcarm == 0) return cutAreasPC1e.IsDeadLoose(ppc1z, ppc1phi, ppc1zVar, ppc1phiVar);
+   return cutAreasPC1w.IsDeadLoose(ppc1z, ppc1phi, ppc1zVar, ppc1phiVar);
 }
 
 bool DeadMapCutter::IsDeadPC2Loose(const double ppc2z, const double ppc2phi,
                                    const double ppc2zVar, const double ppc2phiVar)
 {
-   if (!usePC2) return false;
-   if (ppc2z <= cutAreasPC2Range[0] || ppc2z >= cutAreasPC2Range[1] ||
-       ppc2phi <= cutAreasPC2Range[2] || ppc2phi >= cutAreasPC2Range[3]) return true;
-
-   short yBinMin = static_cast<short>((ppc2phi - ppc2phiVar - cutAreasPC2Range[2])/
-                                      (cutAreasPC2Range[3] - cutAreasPC2Range[2])*
-                                      static_cast<double>(cutAreasPC2.size()));
-   short xBinMin = static_cast<short>((ppc2z - ppc2zVar - cutAreasPC2Range[0])/
-                                      (cutAreasPC2Range[1] - cutAreasPC2Range[0])*
-                                      static_cast<double>(cutAreasPC2[0].size()));
-   short yBinMax = static_cast<short>((ppc2phi + ppc2phiVar - cutAreasPC2Range[2])/
-                                      (cutAreasPC2Range[3] - cutAreasPC2Range[2])*
-                                      static_cast<double>(cutAreasPC2.size()));
-   short xBinMax = static_cast<short>((ppc2z + ppc2zVar - cutAreasPC2Range[0])/
-                                      (cutAreasPC2Range[1] - cutAreasPC2Range[0])*
-                                      static_cast<double>(cutAreasPC2[0].size()));
-
-   if (yBinMin < 0) yBinMin = 0;
-   if (xBinMin < 0) xBinMin = 0;
-   if (yBinMax >= static_cast<short>(cutAreasPC2.size())) 
-      yBinMax = static_cast<short>(cutAreasPC2.size()) - 1;
-   if (xBinMax >= static_cast<short>(cutAreasPC2[0].size())) 
-      xBinMax = static_cast<short>(cutAreasPC2[0].size()) - 1;
-
-   for (short xBin = xBinMin; xBin <= xBinMax; xBin++)
-   {
-      for (short yBin = yBinMin; yBin <= yBinMax; yBin++)
-      {
-         if (!cutAreasPC2[yBin][xBin]) return false;
-      }
-   }
-   return true;
+   if (!(usedMaps & DEAD_PC2)) return false;
+   return cutAreasPC2.IsDeadLoose(ppc2z, ppc2phi, ppc2zVar, ppc2phiVar);
 }
 
 bool DeadMapCutter::IsDeadPC3Loose(const int dcarm, const double ppc3z, const double ppc3phi,
                                    const double ppc3zVar, const double ppc3phiVar)
 {
-   if (!usePC3) return false;
-   if (dcarm == 0) // PC3e
-   {
-      if (ppc3z <= cutAreasPC3eRange[0] || ppc3z >= cutAreasPC3eRange[1] ||
-          ppc3phi <= cutAreasPC3eRange[2] || ppc3phi >= cutAreasPC3eRange[3]) return true;
-
-      short yBinMin = static_cast<short>((ppc3phi - ppc3phiVar - cutAreasPC3eRange[2])/
-                                         (cutAreasPC3eRange[3] - cutAreasPC3eRange[2])*
-                                         static_cast<double>(cutAreasPC3e.size()));
-      short xBinMin = static_cast<short>((ppc3z - ppc3zVar - cutAreasPC3eRange[0])/
-                                         (cutAreasPC3eRange[1] - cutAreasPC3eRange[0])*
-                                         static_cast<double>(cutAreasPC3e[0].size()));
-      short yBinMax = static_cast<short>((ppc3phi + ppc3phiVar - cutAreasPC3eRange[2])/
-                                         (cutAreasPC3eRange[3] - cutAreasPC3eRange[2])*
-                                         static_cast<double>(cutAreasPC3e.size()));
-      short xBinMax = static_cast<short>((ppc3z + ppc3zVar - cutAreasPC3eRange[0])/
-                                         (cutAreasPC3eRange[1] - cutAreasPC3eRange[0])*
-                                         static_cast<double>(cutAreasPC3e[0].size()));
-
-      if (yBinMin < 0) yBinMin = 0;
-      if (xBinMin < 0) xBinMin = 0;
-      if (yBinMax >= static_cast<short>(cutAreasPC3e.size())) 
-         yBinMax = static_cast<short>(cutAreasPC3e.size()) - 1;
-      if (xBinMax >= static_cast<short>(cutAreasPC3e[0].size())) 
-         xBinMax = static_cast<short>(cutAreasPC3e[0].size()) - 1;
-
-      for (short xBin = xBinMin; xBin <= xBinMax; xBin++)
-      {
-         for (short yBin = yBinMin; yBin <= yBinMax; yBin++)
-         {
-            if (!cutAreasPC3e[yBin][xBin]) return false;
-         }
-      }
-      return true;
-   }
-   // PC3w
-   if (ppc3z <= cutAreasPC3wRange[0] || ppc3z >= cutAreasPC3wRange[1] ||
-       ppc3phi <= cutAreasPC3wRange[2] || ppc3phi >= cutAreasPC3wRange[3]) return true;
-
-   short yBinMin = static_cast<short>((ppc3phi - ppc3phiVar - cutAreasPC3wRange[2])/
-                                      (cutAreasPC3wRange[3] - cutAreasPC3wRange[2])*
-                                      static_cast<double>(cutAreasPC3w.size()));
-   short xBinMin = static_cast<short>((ppc3z - ppc3zVar - cutAreasPC3wRange[0])/
-                                      (cutAreasPC3wRange[1] - cutAreasPC3wRange[0])*
-                                      static_cast<double>(cutAreasPC3w[0].size()));
-   short yBinMax = static_cast<short>((ppc3phi + ppc3phiVar - cutAreasPC3wRange[2])/
-                                      (cutAreasPC3wRange[3] - cutAreasPC3wRange[2])*
-                                      static_cast<double>(cutAreasPC3w.size()));
-   short xBinMax = static_cast<short>((ppc3z + ppc3zVar - cutAreasPC3wRange[0])/
-                                      (cutAreasPC3wRange[1] - cutAreasPC3wRange[0])*
-                                      static_cast<double>(cutAreasPC3w[0].size()));
-
-   if (yBinMin < 0) yBinMin = 0;
-   if (xBinMin < 0) xBinMin = 0;
-   if (yBinMax >= static_cast<short>(cutAreasPC3w.size())) 
-      yBinMax = static_cast<short>(cutAreasPC3w.size()) - 1;
-   if (xBinMax >= static_cast<short>(cutAreasPC3w[0].size())) 
-      xBinMax = static_cast<short>(cutAreasPC3w[0].size()) - 1;
-
-   for (short xBin = xBinMin; xBin <= xBinMax; xBin++)
-   {
-      for (short yBin = yBinMin; yBin <= yBinMax; yBin++)
-      {
-         if (!cutAreasPC3w[yBin][xBin]) return false;
-      }
-   }
-   return true;
+   if (!(usedMaps & DEAD_PC3)) return false;
+   if (dcarm == 0) return cutAreasPC3e.IsDeadLoose(ppc3z, ppc3phi, ppc3zVar, ppc3phiVar);
+   return cutAreasPC3w.IsDeadLoose(ppc3z, ppc3phi, ppc3zVar, ppc3phiVar);
 }
 
 bool DeadMapCutter::IsDeadTOFeLoose(const int chamber, const int slat, 
                                     const int chamberVar, const int slatVar)
 {
-   if (!useTOFe) return false;
-   if (chamber < cutAreasTOFeRange[0] || chamber >= cutAreasTOFeRange[1] ||
-       slat < cutAreasTOFeRange[2] || slat >= cutAreasTOFeRange[3]) return true;
-
-   short yBinMin = slat - slatVar;
-   short xBinMin = chamber - chamberVar;
-   short yBinMax = slat + slatVar;
-   short xBinMax = chamber + chamberVar;
-
-   if (yBinMin < cutAreasTOFeRange[2]) yBinMin = cutAreasTOFeRange[2];
-   if (xBinMin < cutAreasTOFeRange[0]) xBinMin = cutAreasTOFeRange[0];
-   if (yBinMax >= cutAreasTOFeRange[1]) yBinMax = cutAreasTOFeRange[3] - 1;
-   if (xBinMax >= cutAreasTOFeRange[3]) xBinMax = cutAreasTOFeRange[1] - 1;
-
-   for (short xBin = xBinMin; xBin <= xBinMax; xBin++)
-   {
-      for (short yBin = yBinMin; yBin <= yBinMax; yBin++)
-      {
-         if (!cutAreasTOFe[yBin][xBin]) return false;
-      }
-   }
-   return true;
+   if (!(usedMaps & DEAD_TOFE)) return false;
+   if (!cutAreasTOFe.IsCellInRange(chamber, slat)) return true;
+   return cutAreasTOFe.IsAllDead(chamber - chamberVar, chamber + chamberVar,
+                                 slat - slatVar, slat + slatVar);
 }
 
 bool DeadMapCutter::IsDeadTOFwLoose(const int chamber, const int strip,
                                     const int chamberVar, const int stripVar)
 {
-   if (!useTOFw) return false;
-
-   if (chamber < cutAreasTOFwRange[0] || chamber >= cutAreasTOFwRange[1] ||
-       strip < cutAreasTOFwRange[2] || strip >= cutAreasTOFwRange[3]) return true;
-
-   short yBinMin = strip - stripVar;
-   short xBinMin = chamber - chamberVar;
-   short yBinMax = strip + stripVar;
-   short xBinMax = chamber + chamberVar;
-
-   if (yBinMin < cutAreasTOFwRange[2]) yBinMin = cutAreasTOFwRange[2];
-   if (xBinMin < cutAreasTOFwRange[0]) xBinMin = cutAreasTOFwRange[0];
-   if (yBinMax >= cutAreasTOFwRange[1]) yBinMax = cutAreasTOFwRange[3] - 1;
-   if (xBinMax >= cutAreasTOFwRange[3]) xBinMax = cutAreasTOFwRange[1] - 1;
-
-   for (short xBin = xBinMin; xBin <= xBinMax; xBin++)
-   {
-      for (short yBin = yBinMin; yBin <= yBinMax; yBin++)
-      {
-         if (!cutAreasTOFw[yBin][xBin]) return false;
-      }
-   }
-   return true;
+   if (!(usedMaps & DEAD_TOFW)) return false;
+   if (!cutAreasTOFw.IsCellInRange(chamber, strip)) return true;
+   return cutAreasTOFw.IsAllDead(chamber - chamberVar, chamber + chamberVar,
+                                 strip - stripVar, strip + stripVar);
 }
 
 bool DeadMapCutter::IsDeadEMCalLoose(const int dcarm, const int sector, 
                                      const int yTower, const int zTower,
                                      const int yTowerVar, const int zTowerVar)
 {
-   if (!useEMCal) return false;
-
-   if (dcarm == 0) // EMCale
-   {
-      if (yTower < cutAreasEMCaleRange[sector][0] || 
-          yTower >= cutAreasEMCaleRange[sector][1] ||
-          zTower < cutAreasEMCaleRange[sector][2] || 
-          zTower >= cutAreasEMCaleRange[sector][3]) return true;
-
-      short yBinMin = zTower - zTowerVar;
-      short xBinMin = yTower - yTowerVar;
-      short yBinMax = zTower + zTowerVar;
-      short xBinMax = yTower + yTowerVar;
-
-      if (yBinMin < cutAreasEMCaleRange[sector][2]) yBinMin = cutAreasEMCaleRange[sector][2];
-      if (xBinMin < cutAreasEMCaleRange[sector][0]) xBinMin = cutAreasEMCaleRange[sector][0];
-      if (yBinMax >= cutAreasEMCaleRange[sector][1]) yBinMax = cutAreasEMCaleRange[sector][3] - 1;
-      if (xBinMax >= cutAreasEMCaleRange[sector][3]) xBinMax = cutAreasEMCaleRange[sector][1] - 1;
-
-      for (short xBin = xBinMin; xBin <= xBinMax; xBin++)
-      {
-         for (short yBin = yBinMin; yBin <= yBinMax; yBin++)
-         {
-            if (!cutAreasEMCale[sector][yBin][xBin]) return false;
-         }
-      }
-      return true;
-   }
-   // EMCalw
-   if (yTower < cutAreasEMCalwRange[sector][0] || 
-       yTower >= cutAreasEMCalwRange[sector][1] ||
-       zTower < cutAreasEMCalwRange[sector][2] || 
-       zTower >= cutAreasEMCalwRange[sector][3]) return true;
-
-   short yBinMin = zTower - zTowerVar;
-   short xBinMin = yTower - yTowerVar;
-   short yBinMax = zTower + zTowerVar;
-   short xBinMax = yTower + yTowerVar;
-
-   if (yBinMin < cutAreasEMCalwRange[sector][2]) yBinMin = cutAreasEMCalwRange[sector][2];
-   if (xBinMin < cutAreasEMCalwRange[sector][0]) xBinMin = cutAreasEMCalwRange[sector][0];
-   if (yBinMax >= cutAreasEMCalwRange[sector][1]) yBinMax = cutAreasEMCalwRange[sector][3] - 1;
-   if (xBinMax >= cutAreasEMCalwRange[sector][3]) xBinMax = cutAreasEMCalwRange[sector][1] - 1;
-
-   for (short xBin = xBinMin; xBin <= xBinMax; xBin++)
-   {
-      for (short yBin = yBinMin; yBin <= yBinMax; yBin++)
-      {
-         if (!cutAreasEMCalw[sector][yBin][xBin]) return false;
-      }
-   }
-   return true;
+   if (!(usedMaps & DEAD_EMCAL)) return false;
+   const DeadMap& cutAreas = (dcarm == 0) ? cutAreasEMCale[sector] : cutAreasEMCalw[sector];
+   if (!cutAreas.IsCellInRange(yTower, zTower)) return true;
+   return cutAreas.IsAllDead(yTower - yTowerVar, yTower + yTowerVar,
+                             zTower - zTowerVar, zTower + zTowerVar);
 }
 
 bool DeadMapCutter::IsDeadTimingTOFeLoose(const int chamber, const int slat, 
                                           const int chamberVar, const int slatVar)
 {
-   if (!useTOFe) return false;
-   if (chamber < cutAreasTimingTOFeRange[0] || chamber >= cutAreasTimingTOFeRange[1] ||
-       slat < cutAreasTimingTOFeRange[2] || slat >= cutAreasTimingTOFeRange[3]) return true;
-
-   short yBinMin = slat - slatVar;
-   short xBinMin = chamber - chamberVar;
-   short yBinMax = slat + slatVar;
-   short xBinMax = chamber + chamberVar;
-
-   if (yBinMin < cutAreasTimingTOFeRange[2]) yBinMin = cutAreasTimingTOFeRange[2];
-   if (xBinMin < cutAreasTimingTOFeRange[0]) xBinMin = cutAreasTimingTOFeRange[0];
-   if (yBinMax >= cutAreasTimingTOFeRange[1]) yBinMax = cutAreasTimingTOFeRange[3] - 1;
-   if (xBinMax >= cutAreasTimingTOFeRange[3]) xBinMax = cutAreasTimingTOFeRange[1] - 1;
-
-   for (short xBin = xBinMin; xBin <= xBinMax; xBin++)
-   {
-      for (short yBin = yBinMin; yBin <= yBinMax; yBin++)
-      {
-         if (!cutAreasTimingTOFe[yBin][xBin]) return false;
-      }
-   }
-   return true;
+   if (!(usedMaps & DEAD_TIMING_TOFE)) return false;
+   if (!cutAreasTimingTOFe.IsCellInRange(chamber, slat)) return true;
+   return cutAreasTimingTOFe.IsAllDead(chamber - chamberVar, chamber + chamberVar,
+                                       slat - slatVar, slat + slatVar);
 }
 
 bool DeadMapCutter::IsDeadTimingTOFwLoose(const int chamber, const int strip,
                                           const int chamberVar, const int stripVar)
 {
-   if (!useTOFw) return false;
-
-   if (chamber < cutAreasTimingTOFwRange[0] || chamber >= cutAreasTimingTOFwRange[1] ||
-       strip < cutAreasTimingTOFwRange[2] || strip >= cutAreasTimingTOFwRange[3]) return true;
-
-   short yBinMin = strip - stripVar;
-   short xBinMin = chamber - chamberVar;
-   short yBinMax = strip + stripVar;
-   short xBinMax = chamber + chamberVar;
-
-   if (yBinMin < cutAreasTimingTOFwRange[2]) yBinMin = cutAreasTimingTOFwRange[2];
-   if (xBinMin < cutAreasTimingTOFwRange[0]) xBinMin = cutAreasTimingTOFwRange[0];
-   if (yBinMax >= cutAreasTimingTOFwRange[1]) yBinMax = cutAreasTimingTOFwRange[3] - 1;
-   if (xBinMax >= cutAreasTimingTOFwRange[3]) xBinMax = cutAreasTimingTOFwRange[1] - 1;
-
-   for (short xBin = xBinMin; xBin <= xBinMax; xBin++)
-   {
-      for (short yBin = yBinMin; yBin <= yBinMax; yBin++)
-      {
-         if (!cutAreasTimingTOFw[yBin][xBin]) return false;
-      }
-   }
-   return true;
+   if (!(usedMaps & DEAD_TIMING_TOFW)) return false;
+   if (!cutAreasTimingTOFw.IsCellInRange(chamber, strip)) return true;
+   return cutAreasTimingTOFw.IsAllDead(chamber - chamberVar, chamber + chamberVar,
+                                       strip - stripVar, strip + stripVar);
 }
 
 bool DeadMapCutter::IsDeadTimingEMCalLoose(const int dcarm, const int sector, 
                                            const int yTower, const int zTower,
                                            const int yTowerVar, const int zTowerVar)
 {
-   if (!useEMCal) return false;
-
-   if (dcarm == 0) // EMCale
-   {
-      if (yTower < cutAreasTimingEMCaleRange[sector][0] || 
-          yTower >= cutAreasTimingEMCaleRange[sector][1] ||
-          zTower < cutAreasTimingEMCaleRange[sector][2] || 
-          zTower >= cutAreasTimingEMCaleRange[sector][3]) return true;
-
-      short yBinMin = zTower - zTowerVar;
-      short xBinMin = yTower - yTowerVar;
-      short yBinMax = zTower + zTowerVar;
-      short xBinMax = yTower + yTowerVar;
-
-      if (yBinMin < cutAreasTimingEMCaleRange[sector][2]) 
-         yBinMin = cutAreasTimingEMCaleRange[sector][2];
-      if (xBinMin < cutAreasTimingEMCaleRange[sector][0]) 
-         xBinMin = cutAreasTimingEMCaleRange[sector][0];
-      if (yBinMax >= cutAreasTimingEMCaleRange[sector][1]) 
-         yBinMax = cutAreasTimingEMCaleRange[sector][3] - 1;
-      if (xBinMax >= cutAreasTimingEMCaleRange[sector][3]) 
-         xBinMax = cutAreasTimingEMCaleRange[sector][1] - 1;
-
-      for (short xBin = xBinMin; xBin <= xBinMax; xBin++)
-      {
-         for (short yBin = yBinMin; yBin <= yBinMax; yBin++)
-         {
-            if (!cutAreasTimingEMCale[sector][yBin][xBin]) return false;
-         }
-      }
-      return true;
-   }
-   // EMCalw
-   if (yTower < cutAreasTimingEMCalwRange[sector][0] || 
-       yTower >= cutAreasTimingEMCalwRange[sector][1] ||
-       zTower < cutAreasTimingEMCalwRange[sector][2] || 
-       zTower >= cutAreasTimingEMCalwRange[sector][3]) return true;
-
-   short yBinMin = zTower - zTowerVar;
-   short xBinMin = yTower - yTowerVar;
-   short yBinMax = zTower + zTowerVar;
-   short xBinMax = yTower + yTowerVar;
-
-   if (yBinMin < cutAreasTimingEMCalwRange[sector][2]) 
-      yBinMin = cutAreasTimingEMCalwRange[sector][2];
-   if (xBinMin < cutAreasTimingEMCalwRange[sector][0]) 
-      xBinMin = cutAreasTimingEMCalwRange[sector][0];
-   if (yBinMax >= cutAreasTimingEMCalwRange[sector][1]) 
-      yBinMax = cutAreasTimingEMCalwRange[sector][3] - 1;
-   if (xBinMax >= cutAreasTimingEMCalwRange[sector][3]) 
-      xBinMax = cutAreasTimingEMCalwRange[sector][1] - 1;
-
-   for (short xBin = xBinMin; xBin <= xBinMax; xBin++)
-   {
-      for (short yBin = yBinMin; yBin <= yBinMax; yBin++)
-      {
-         if (!cutAreasTimingEMCalw[sector][yBin][xBin]) return false;
-      }
-   }
-   return true;
+   if (!(usedMaps & DEAD_TIMING_EMCAL)) return false;
+   const DeadMap& cutAreas = 
+      (dcarm == 0) ? cutAreasTimingEMCale[sector] : cutAreasTimingEMCalw[sector];
+   if (!cutAreas.IsCellInRange(yTower, zTower)) return true;
+   return cutAreas.IsAllDead(yTower - yTowerVar, yTower + yTowerVar,
+                             zTower - zTowerVar, zTower + zTowerVar);
 }
 
 bool DeadMapCutter::IsDeadDCTight(const int dcarm, const double zDC, 
                                   const double board, const double alpha,
                                   const double boardVar, const double alphaVar)
 {
-   if (!useDC) return false;
-   if (dcarm == 0) // DCe
-   {
-      if (zDC >= 0)
-      {
-         if (board <= cutAreasDCe0X1Range[0] || board >= cutAreasDCe0X1Range[1] ||
-             alpha <= cutAreasDCe0X1Range[2] || alpha >= cutAreasDCe0X1Range[3] ||
-             board <= cutAreasDCe0X2Range[0] || board >= cutAreasDCe0X2Range[1] ||
-             alpha <= cutAreasDCe0X2Range[2] || alpha >= cutAreasDCe0X2Range[3]) return true;
-
-         short yBinX1Min = static_cast<short>((alpha - alphaVar - cutAreasDCe0X1Range[2])/
-                                              (cutAreasDCe0X1Range[3] - cutAreasDCe0X1Range[2])*
-                                              static_cast<double>(cutAreasDCe0X1.size()));
-         short xBinX1Min = static_cast<short>((board - boardVar - cutAreasDCe0X1Range[0])/
-                                              (cutAreasDCe0X1Range[1] - cutAreasDCe0X1Range[0])*
-                                              static_cast<double>(cutAreasDCe0X1[0].size()));
-         short yBinX2Min = static_cast<short>((alpha - alphaVar - cutAreasDCe0X2Range[2])/
-                                              (cutAreasDCe0X2Range[3] - cutAreasDCe0X2Range[2])*
-                                              static_cast<double>(cutAreasDCe0X2.size()));
-         short xBinX2Min = static_cast<short>((board - boardVar - cutAreasDCe0X2Range[0])/
-                                              (cutAreasDCe0X2Range[1] - cutAreasDCe0X2Range[0])*
-                                              static_cast<double>(cutAreasDCe0X2[0].size()));
-
-         short yBinX1Max = static_cast<short>((alpha + alphaVar - cutAreasDCe0X1Range[2])/
-                                              (cutAreasDCe0X1Range[3] - cutAreasDCe0X1Range[2])*
-                                              static_cast<double>(cutAreasDCe0X1.size()));
-         short xBinX1Max = static_cast<short>((board + boardVar - cutAreasDCe0X1Range[0])/
-                                              (cutAreasDCe0X1Range[1] - cutAreasDCe0X1Range[0])*
-                                              static_cast<double>(cutAreasDCe0X1[0].size()));
-         short yBinX2Max = static_cast<short>((alpha + alphaVar - cutAreasDCe0X2Range[2])/
-                                              (cutAreasDCe0X2Range[3] - cutAreasDCe0X2Range[2])*
-                                              static_cast<double>(cutAreasDCe0X2.size()));
-         short xBinX2Max = static_cast<short>((board + boardVar - cutAreasDCe0X2Range[0])/
-                                              (cutAreasDCe0X2Range[1] - cutAreasDCe0X2Range[0])*
-                                              static_cast<double>(cutAreasDCe0X2[0].size()));
-
-         if (yBinX1Min < 0) yBinX1Min = 0;
-         if (xBinX1Min < 0) xBinX1Min = 0;
-         if (yBinX2Min < 0) yBinX2Min = 0;
-         if (xBinX2Min < 0) xBinX2Min = 0;
-
-         if (yBinX1Max >= static_cast<short>(cutAreasDCe0X1.size())) 
-            yBinX1Max = static_cast<short>(cutAreasDCe0X1.size()) - 1;
-         if (xBinX1Max >= static_cast<short>(cutAreasDCe0X1[0].size())) 
-            xBinX1Max = static_cast<short>(cutAreasDCe0X1[0].size()) - 1;
-         if (yBinX2Max >= static_cast<short>(cutAreasDCe0X2.size())) 
-            yBinX2Max = static_cast<short>(cutAreasDCe0X2.size()) - 1;
-         if (xBinX2Max >= static_cast<short>(cutAreasDCe0X2[0].size())) 
-            xBinX2Max = static_cast<short>(cutAreasDCe0X2[0].size()) - 1;
-
-         for (short xBin = xBinX1Min; xBin <= xBinX1Max; xBin++)
-         {
-            for (short yBin = yBinX1Min; yBin <= yBinX1Max; yBin++)
-            {
-               if (cutAreasDCe0X1[yBin][xBin]) return true;
-            }
-         }
+   if (!(usedMaps & DEAD_DC)) return false;
 
-         for (short xBin = xBinX2Min; xBin <= xBinX2Max; xBin++)
-         {
-            for (short yBin = yBinX2Min; yBin <= yBinX2Max; yBin++)
-            {
-               if (cutAreasDCe0X2[yBin][xBin]) return true;
-            }
-         }
-         return false;
-      }
-      else
-      {
-         if (board <= cutAreasDCe1X1Range[0] || board >= cutAreasDCe1X1Range[1] ||
-             alpha <= cutAreasDCe1X1Range[2] || alpha >= cutAreasDCe1X1Range[3] ||
-             board <= cutAreasDCe1X2Range[0] || board >= cutAreasDCe1X2Range[1] ||
-             alpha <= cutAreasDCe1X2Range[2] || alpha >= cutAreasDCe1X2Range[3]) return true;
-
-         short yBinX1Min = static_cast<short>((alpha - alphaVar - cutAreasDCe1X1Range[2])/
-                                              (cutAreasDCe1X1Range[3] - cutAreasDCe1X1Range[2])*
-                                              static_cast<double>(cutAreasDCe1X1.size()));
-         short xBinX1Min = static_cast<short>((board - boardVar - cutAreasDCe1X1Range[0])/
-                                              (cutAreasDCe1X1Range[1] - cutAreasDCe1X1Range[0])*
-                                              static_cast<double>(cutAreasDCe1X1[0].size()));
-         short yBinX2Min = static_cast<short>((alpha - alphaVar - cutAreasDCe1X2Range[2])/
-                                              (cutAreasDCe1X2Range[3] - cutAreasDCe1X2Range[2])*
-                                              static_cast<double>(cutAreasDCe1X2.size()));
-         short xBinX2Min = static_cast<short>((board - boardVar - cutAreasDCe1X2Range[0])/
-                                              (cutAreasDCe1X2Range[1] - cutAreasDCe1X2Range[0])*
-                                              static_cast<double>(cutAreasDCe1X2[0].size()));
-
-         short yBinX1Max = static_cast<short>((alpha + alphaVar - cutAreasDCe1X1Range[2])/
-                                              (cutAreasDCe1X1Range[3] - cutAreasDCe1X1Range[2])*
-                                              static_cast<double>(cutAreasDCe1X1.size()));
-         short xBinX1Max = static_cast<short>((board + boardVar - cutAreasDCe1X1Range[0])/
-                                              (cutAreasDCe1X1Range[1] - cutAreasDCe1X1Range[0])*
-                                              static_cast<double>(cutAreasDCe1X1[0].size()));
-         short yBinX2Max = static_cast<short>((alpha + alphaVar - cutAreasDCe1X2Range[2])/
-                                              (cutAreasDCe1X2Range[3] - cutAreasDCe1X2Range[2])*
-                                              static_cast<double>(cutAreasDCe1X2.size()));
-         short xBinX2Max = static_cast<short>((board + boardVar - cutAreasDCe1X2Range[0])/
-                                              (cutAreasDCe1X2Range[1] - cutAreasDCe1X2Range[0])*
-                                              static_cast<double>(cutAreasDCe1X2[0].size()));
-
-         if (yBinX1Min < 0) yBinX1Min = 0;
-         if (xBinX1Min < 0) xBinX1Min = 0;
-         if (yBinX2Min < 0) yBinX2Min = 0;
-         if (xBinX2Min < 0) xBinX2Min = 0;
-
-         if (yBinX1Max >= static_cast<short>(cutAreasDCe1X1.size())) 
-            yBinX1Max = static_cast<short>(cutAreasDCe1X1.size()) - 1;
-         if (xBinX1Max >= static_cast<short>(cutAreasDCe1X1[0].size())) 
-            xBinX1Max = static_cast<short>(cutAreasDCe1X1[0].size()) - 1;
-         if (yBinX2Max >= static_cast<short>(cutAreasDCe1X2.size())) 
-            yBinX2Max = static_cast<short>(cutAreasDCe1X2.size()) - 1;
-         if (xBinX2Max >= static_cast<short>(cutAreasDCe1X2[0].size())) 
-            xBinX2Max = static_cast<short>(cutAreasDCe1X2[0].size()) - 1;
-
-         for (short xBin = xBinX1Min; xBin <= xBinX1Max; xBin++)
-         {
-            for (short yBin = yBinX1Min; yBin <= yBinX1Max; yBin++)
-            {
-               if (cutAreasDCe1X1[yBin][xBin]) return true;
-            }
-         }
-
-         for (short xBin = xBinX2Min; xBin <= xBinX2Max; xBin++)
-         {
-            for (short yBin = yBinX2Min; yBin <= yBinX2Max; yBin++)
-            {
-               if (cutAreasDCe1X2[yBin][xBin]) return true;
-            }
-         }
-         return false;
-      }
-   }
-   // DCw
-   if (zDC >= 0)
-   {
-      if (board <= cutAreasDCw0X1Range[0] || board >= cutAreasDCw0X1Range[1] ||
-          alpha <= cutAreasDCw0X1Range[2] || alpha >= cutAreasDCw0X1Range[3] ||
-          board <= cutAreasDCw0X2Range[0] || board >= cutAreasDCw0X2Range[1] ||
-          alpha <= cutAreasDCw0X2Range[2] || alpha >= cutAreasDCw0X2Range[3]) return true;
-
-      short yBinX1Min = static_cast<short>((alpha - alphaVar - cutAreasDCw0X1Range[2])/
-                                           (cutAreasDCw0X1Range[3] - cutAreasDCw0X1Range[2])*
-                                           static_cast<double>(cutAreasDCw0X1.size()));
-      short xBinX1Min = static_cast<short>((board - boardVar - cutAreasDCw0X1Range[0])/
-                                           (cutAreasDCw0X1Range[1] - cutAreasDCw0X1Range[0])*
-                                           static_cast<double>(cutAreasDCw0X1[0].size()));
-      short yBinX2Min = static_cast<short>((alpha - alphaVar - cutAreasDCw0X2Range[2])/
-                                           (cutAreasDCw0X2Range[3] - cutAreasDCw0X2Range[2])*
-                                           static_cast<double>(cutAreasDCw0X2.size()));
-      short xBinX2Min = static_cast<short>((board - boardVar - cutAreasDCw0X2Range[0])/
-                                           (cutAreasDCw0X2Range[1] - cutAreasDCw0X2Range[0])*
-                                           static_cast<double>(cutAreasDCw0X2[0].size()));
-
-      short yBinX1Max = static_cast<short>((alpha + alphaVar - cutAreasDCw0X1Range[2])/
-                                           (cutAreasDCw0X1Range[3] - cutAreasDCw0X1Range[2])*
-                                           static_cast<double>(cutAreasDCw0X1.size()));
-      short xBinX1Max = static_cast<short>((board + boardVar - cutAreasDCw0X1Range[0])/
-                                           (cutAreasDCw0X1Range[1] - cutAreasDCw0X1Range[0])*
-                                           static_cast<double>(cutAreasDCw0X1[0].size()));
-      short yBinX2Max = static_cast<short>((alpha + alphaVar - cutAreasDCw0X2Range[2])/
-                                           (cutAreasDCw0X2Range[3] - cutAreasDCw0X2Range[2])*
-                                           static_cast<double>(cutAreasDCw0X2.size()));
-      short xBinX2Max = static_cast<short>((board + boardVar - cutAreasDCw0X2Range[0])/
-                                           (cutAreasDCw0X2Range[1] - cutAreasDCw0X2Range[0])*
-                                           static_cast<double>(cutAreasDCw0X2[0].size()));
-
-      if (yBinX1Min < 0) yBinX1Min = 0;
-      if (xBinX1Min < 0) xBinX1Min = 0;
-      if (yBinX2Min < 0) yBinX2Min = 0;
-      if (xBinX2Min < 0) xBinX2Min = 0;
-
-      if (yBinX1Max >= static_cast<short>(cutAreasDCw0X1.size())) 
-         yBinX1Max = static_cast<short>(cutAreasDCw0X1.size()) - 1;
-      if (xBinX1Max >= static_cast<short>(cutAreasDCw0X1[0].size())) 
-         xBinX1Max = static_cast<short>(cutAreasDCw0X1[0].size()) - 1;
-      if (yBinX2Max >= static_cast<short>(cutAreasDCw0X2.size())) 
-         yBinX2Max = static_cast<short>(cutAreasDCw0X2.size()) - 1;
-      if (xBinX2Max >= static_cast<short>(cutAreasDCw0X2[0].size())) 
-         xBinX2Max = static_cast<short>(cutAreasDCw0X2[0].size()) - 1;
-
-      for (short xBin = xBinX1Min; xBin <= xBinX1Max; xBin++)
-      {
-         for (short yBin = yBinX1Min; yBin <= yBinX1Max; yBin++)
-         {
-            if (cutAreasDCw0X1[yBin][xBin]) return true;
-         }
-      }
-
-      for (short xBin = xBinX2Min; xBin <= xBinX2Max; xBin++)
-      {
-         for (short yBin = yBinX2Min; yBin <= yBinX2Max; yBin++)
-         {
-            if (cutAreasDCw0X2[yBin][xBin]) return true;
-         }
-      }
-      return false;
-   }
-   else
-   {
-      if (board <= cutAreasDCw1X1Range[0] || board >= cutAreasDCw1X1Range[1] ||
-          alpha <= cutAreasDCw1X1Range[2] || alpha >= cutAreasDCw1X1Range[3] ||
-          board <= cutAreasDCw1X2Range[0] || board >= cutAreasDCw1X2Range[1] ||
-          alpha <= cutAreasDCw1X2Range[2] || alpha >= cutAreasDCw1X2Range[3]) return true;
-
-      short yBinX1Min = static_cast<short>((alpha - alphaVar - cutAreasDCw1X1Range[2])/
-                                           (cutAreasDCw1X1Range[3] - cutAreasDCw1X1Range[2])*
-                                           static_cast<double>(cutAreasDCw1X1.size()));
-      short xBinX1Min = static_cast<short>((board - boardVar - cutAreasDCw1X1Range[0])/
-                                           (cutAreasDCw1X1Range[1] - cutAreasDCw1X1Range[0])*
-                                           static_cast<double>(cutAreasDCw1X1[0].size()));
-      short yBinX2Min = static_cast<short>((alpha - alphaVar - cutAreasDCw1X2Range[2])/
-                                           (cutAreasDCw1X2Range[3] - cutAreasDCw1X2Range[2])*
-                                           static_cast<double>(cutAreasDCw1X2.size()));
-      short xBinX2Min = static_cast<short>((board - boardVar - cutAreasDCw1X2Range[0])/
-                                           (cutAreasDCw1X2Range[1] - cutAreasDCw1X2Range[0])*
-                                           static_cast<double>(cutAreasDCw1X2[0].size()));
-
-      short yBinX1Max = static_cast<short>((alpha + alphaVar - cutAreasDCw1X1Range[2])/
-                                           (cutAreasDCw1X1Range[3] - cutAreasDCw1X1Range[2])*
-                                           static_cast<double>(cutAreasDCw1X1.size()));
-      short xBinX1Max = static_cast<short>((board + boardVar - cutAreasDCw1X1Range[0])/
-                                           (cutAreasDCw1X1Range[1] - cutAreasDCw1X1Range[0])*
-                                           static_cast<double>(cutAreasDCw1X1[0].size()));
-      short yBinX2Max = static_cast<short>((alpha + alphaVar - cutAreasDCw1X2Range[2])/
-                                           (cutAreasDCw1X2Range[3] - cutAreasDCw1X2Range[2])*
-                                           static_cast<double>(cutAreasDCw1X2.size()));
-      short xBinX2Max = static_cast<short>((board + boardVar - cutAreasDCw1X2Range[0])/
-                                           (cutAreasDCw1X2Range[1] - cutAreasDCw1X2Range[0])*
-                                           static_cast<double>(cutAreasDCw1X2[0].size()));
-
-      if (yBinX1Min < 0) yBinX1Min = 0;
-      if (xBinX1Min < 0) xBinX1Min = 0;
-      if (yBinX2Min < 0) yBinX2Min = 0;
-      if (xBinX2Min < 0) xBinX2Min = 0;
-
-      if (yBinX1Max >= static_cast<short>(cutAreasDCw1X1.size())) 
-         yBinX1Max = static_cast<short>(cutAreasDCw1X1.size()) - 1;
-      if (xBinX1Max >= static_cast<short>(cutAreasDCw1X1[0].size())) 
-         xBinX1Max = static_cast<short>(cutAreasDCw1X1[0].size()) - 1;
-      if (yBinX2Max >= static_cast<short>(cutAreasDCw1X2.size())) 
-         yBinX2Max = static_cast<short>(cutAreasDCw1X2.size()) - 1;
-      if (xBinX2Max >= static_cast<short>(cutAreasDCw1X2[0].size())) 
-         xBinX2Max = static_cast<short>(cutAreasDCw1X2[0].size()) - 1;
-
-      for (short xBin = xBinX1Min; xBin <= xBinX1Max; xBin++)
-      {
-         for (short yBin = yBinX1Min; yBin <= yBinX1Max; yBin++)
-         {
-            if (cutAreasDCw1X1[yBin][xBin]) return true;
-         }
-      }
+   const DeadMap& cutAreasX1 = GetMapDCX1(dcarm, zDC);
+   const DeadMap& cutAreasX2 = GetMapDCX2(dcarm, zDC);
 
-      for (short xBin = xBinX2Min; xBin <= xBinX2Max; xBin++)
-      {
-         for (short yBin = yBinX2Min; yBin <= yBinX2Max; yBin++)
-         {
-            if (cutAreasDCw1X2[yBin][xBin]) return true;
-         }
-      }
-      return false;
-   }
+   return (cutAreasX1.IsDeadTight(board, alpha, boardVar, alphaVar) ||
+           cutAreasX2.IsDeadTight(board, alpha, boardVar, alphaVar));
 }
 
 bool DeadMapCutter::IsDeadPC1Tight(const int dcarm, const double ppc1z, const double ppc1phi,
                                    const double ppc1zVar, const double ppc1phiVar)
 {
-   if (!usePC1) return false;
-   if (dcarm == 0) // PC1e
-   {
-      if (ppc1z <= cutAreasPC1eRange[0] || ppc1z >= cutAreasPC1eRange[1] ||
-          ppc1phi <= cutAreasPC1eRange[2] || ppc1phi >= cutAreasPC1eRange[3]) return true;
-
-      short yBinMin = static_cast<short>((ppc1phi - ppc1phiVar - cutAreasPC1eRange[2])/
-                                         (cutAreasPC1eRange[3] - cutAreasPC1eRange[2])*
-                                         static_cast<double>(cutAreasPC1e.size()));
-      short xBinMin = static_cast<short>((ppc1z - ppc1zVar - cutAreasPC1eRange[0])/
-                                         (cutAreasPC1eRange[1] - cutAreasPC1eRange[0])*
-                                         static_cast<double>(cutAreasPC1e[0].size()));
-      short yBinMax = static_cast<short>((ppc1phi + ppc1phiVar - cutAreasPC1eRange[2])/
-                                         (cutAreasPC1eRange[3] - cutAreasPC1eRange[2])*
-                                         static_cast<double>(cutAreasPC1e.size()));
-      short xBinMax = static_cast<short>((ppc1z + ppc1zVar - cutAreasPC1eRange[0])/
-                                         (cutAreasPC1eRange[1] - cutAreasPC1eRange[0])*
-                                         static_cast<double>(cutAreasPC1e[0].size()));
-
-      if (yBinMin < 0) yBinMin = 0;
-      if (xBinMin < 0) xBinMin = 0;
-      if (yBinMax >= static_cast<short>(cutAreasPC1e.size())) 
-         yBinMax = static_cast<short>(cutAreasPC1e.size()) - 1;
-      if (xBinMax >= static_cast<short>(cutAreasPC1e[0].size())) 
-         xBinMax = static_cast<short>(cutAreasPC1e[0].size()) - 1;
-
-      for (short xBin = xBinMin; xBin <= xBinMax; xBin++)
-      {
-         for (short yBin = yBinMin; yBin <= yBinMax; yBin++)
-         {
-            if (cutAreasPC1e[yBin][xBin]) return true;
-         }
-      }
-      return false;
-   }
-   // PC1w
-   if (ppc1z <= cutAreasPC1wRange[0] || ppc1z >= cutAreasPC1wRange[1] ||
-       ppc1phi <= cutAreasPC1wRange[2] || ppc1phi >= cutAreasPC1wRange[3]) return true;
-
-   short yBinMin = static_cast<short>((ppc1phi - ppc1phiVar - cutAreasPC1wRange[2])/
-                                      (cutAreasPC1wRange[3] - cutAreasPC1wRange[2])*
-                                      static_cast<double>(cutAreasPC1w.size()));
-   short xBinMin = static_cast<short>((ppc1z - ppc1zVar - cutAreasPC1wRange[0])/
-                                      (cutAreasPC1wRange[1] - cutAreasPC1wRange[0])*
-                                      static_cast<double>(cutAreasPC1w[0].size()));
-   short yBinMax = static_cast<short>((ppc1phi + ppc1phiVar - cutAreasPC1wRange[2])/
-                                      (cutAreasPC1wRange[3] - cutAreasPC1wRange[2])*
-                                      static_cast<double>(cutAreasPC1w.size()));
-   short xBinMax = static_cast<short>((ppc1z + ppc1zVar - cutAreasPC1wRange[0])/
-                                      (cutAreasPC1wRange[1] - cutAreasPC1wRange[0])*
-                                      static_cast<double>(cutAreasPC1w[0].size()));
-
-   if (yBinMin < 0) yBinMin = 0;
-   if (xBinMin < 0) xBinMin = 0;
-   if (yBinMax >= static_cast<short>(cutAreasPC1w.size())) 
-      yBinMax = static_cast<short>(cutAreasPC1w.size()) - 1;
-   if (xBinMax >= static_cast<short>(cutAreasPC1w[0].size())) 
-      xBinMax = static_cast<short>(cutAreasPC1w[0].size()) - 1;
-
-   for (short xBin = xBinMin; xBin <= xBinMax; xBin++)
-   {
-      for (short yBin = yBinMin; yBin <= yBinMax; yBin++)
-      {
-         if (cutAreasPC1w[yBin][xBin]) return true;
-      }
-   }
-   return false;
+   if (!(usedMaps & DEAD_PC1)) return false;
+   if (dcarm == 0) return cutAreasPC1e.IsDeadTight(ppc1z, ppc1phi, ppc1zVar, ppc1phiVar);
+   return cutAreasPC1w.IsDeadTight(ppc1z, ppc1phi, ppc1zVar, ppc1phiVar);
 }
 
 bool DeadMapCutter::IsDeadPC2Tight(const double ppc2z, const double ppc2phi,
                                    const double ppc2zVar, const double ppc2phiVar)
 {
-   if (!usePC2) return false;
-   if (ppc2z <= cutAreasPC2Range[0] || ppc2z >= cutAreasPC2Range[1] ||
-       ppc2phi <= cutAreasPC2Range[2] || ppc2phi >= cutAreasPC2Range[3]) return true;
-
-   short yBinMin = static_cast<short>((ppc2phi - ppc2phiVar - cutAreasPC2Range[2])/
-                                      (cutAreasPC2Range[3] - cutAreasPC2Range[2])*
-                                      static_cast<double>(cutAreasPC2.size()));
-   short xBinMin = static_cast<short>((ppc2z - ppc2zVar - cutAreasPC2Range[0])/
-                                      (cutAreasPC2Range[1] - cutAreasPC2Range[0])*
-                                      static_cast<double>(cutAreasPC2[0].size()));
-   short yBinMax = static_cast<short>((ppc2phi + ppc2phiVar - cutAreasPC2Range[2])/
-                                      (cutAreasPC2Range[3] - cutAreasPC2Range[2])*
-                                      static_cast<double>(cutAreasPC2.size()));
-   short xBinMax = static_cast<short>((ppc2z + ppc2zVar - cutAreasPC2Range[0])/
-                                      (cutAreasPC2Range[1] - cutAreasPC2Range[0])*
-                                      static_cast<double>(cutAreasPC2[0].size()));
-
-   if (yBinMin < 0) yBinMin = 0;
-   if (xBinMin < 0) xBinMin = 0;
-   if (yBinMax >= static_cast<short>(cutAreasPC2.size())) 
-      yBinMax = static_cast<short>(cutAreasPC2.size()) - 1;
-   if (xBinMax >= static_cast<short>(cutAreasPC2[0].size())) 
-      xBinMax = static_cast<short>(cutAreasPC2[0].size()) - 1;
-
-   for (short xBin = xBinMin; xBin <= xBinMax; xBin++)
-   {
-      for (short yBin = yBinMin; yBin <= yBinMax; yBin++)
-      {
-         if (cutAreasPC2[yBin][xBin]) return true;
-      }
-   }
-   return false;
+   if (!(usedMaps & DEAD_PC2)) return false;
+   return cutAreasPC2.IsDeadTight(ppc2z, ppc2phi, ppc2zVar, ppc2phiVar);
 }
 
 bool DeadMapCutter::IsDeadPC3Tight(const int dcarm, const double ppc3z, const double ppc3phi,
                                    const double ppc3zVar, const double ppc3phiVar)
 {
-   if (!usePC3) return false;
-   if (dcarm == 0) // PC3e
+   if (!(usedMaps & DEAD_PC3)) return false;
+   if (dcarm == 0) return cutAreasPC3e.IsDeadTight(ppc3z, ppc3phi, ppc3zVar, ppc3phiVar);
+   return cutAreasPC3w.IsDeadTight(ppc3z, ppc3phi, ppc3zVar, ppc3phiVar);
+}
+
+bool DeadMapCutter::IsDeadTOFeTight(const int chamber, const int slat, 
+                                    const int chamberVar, const int slatVar)
+{
+   if (!(usedMaps & DEAD_TOFE)) return false;
+   if (!cutAreasTOFe.IsCellInRange(chamber, slat)) return true;
+   return cutAreasTOFe.IsAnyDead(chamber - chamberVar, chamber + chamberVar,
+                                 slat - slatVar, slat + slatVar);
+}
+
+bool DeadMapCutter::IsDeadTOFwTight(const int chamber, const int strip,
+                                    const int chamberVar, const int stripVar)
+{
+   if (!(usedMaps & DEAD_TOFW)) return false;
+   if (!cutAreasTOFw.IsCellInRange(chamber, strip)) return true;
+   return cutAreasTOFw.IsAnyDead(chamber - chamberVar, chamber + chamberVar,
+                                 strip - stripVar, strip + stripVar);
+}
+
+bool DeadMapCutter::IsDeadEMCalTight(const int dcarm, const int sector, 
+                                     const int yTower, const int zTower,
+                                     const int yTowerVar, const int zTowerVar)
+{
+   if (!(usedMaps & DEAD_EMCAL)) return false;
+   const DeadMap& cutAreas = (dcarm == 0) ? cutAreasEMCale[sector] : cutAreasEMCalw[sector];
+   if (!cutAreas.IsCellInRange(yTower, zTower)) return true;
+   return cutAreas.IsAnyDead(yTower - yTowerVar, yTower + yTowerVar,
+                             zTower - zTowerVar, zTower + zTowerVar);
+}
+
+bool DeadMapCutter::IsDeadTimingTOFeTight(const int chamber, const int slat, 
+                                          const int chamberVar, const int slatVar)
+{
+   if (!(usedMaps & DEAD_TIMING_TOFE)) return false;
+   if (!cutAreasTimingTOFe.IsCellInRange(chamber, slat)) return true;
+   return cutAreasTimingTOFe.IsAnyDead(chamber - chamberVar, chamber + chamberVar,
+                                       slat - slatVar, slat + slatVar);
+}
+
+bool DeadMapCutter::IsDeadTimingTOFwTight(const int chamber, const int strip,
+                                          const int chamberVar, const int stripVar)
+{
+   if (!(usedMaps & DEAD_TIMING_TOFW)) return false;
+   if (!cutAreasTimingTOFw.IsCellInRange(chamber, strip)) return true;
+   return cutAreasTimingTOFw.IsAnyDead(chamber - chamberVar, chamber + chamberVar,
+                                       strip - stripVar, strip + stripVar);
+}
+
+bool DeadMapCutter::IsDeadTimingEMCalTight(const int dcarm, const int sector, 
+                                           const int yTower, const int zTower,
+                                           const int yTowerVar, const int zTowerVar)
+{
+   if (!(usedMaps & DEAD_TIMING_EMCAL)) return false;
+   const DeadMap& cutAreas = 
+      (dcarm == 0) ? cutAreasTimingEMCale[sector] : cutAreasTimingEMCalw[sector];
+   if (!cutAreas.IsCellInRange(yTower, zTower)) return true;
+   return cutAreas.IsAnyDead(yTower - yTowerVar, yTower + yTowerVar,
+                             zTower - zTowerVar, zTower + zTowerVar);
+}
+
+unsigned int DeadMapCutter::GetUsedMaps() const
+{
+   return usedMaps;
+}
+
+unsigned int DeadMapCutter::GetDeadTOFe(const int chamber, const int slat) const
+{
+   return fusedCutAreasTOFe.Get(chamber, slat);
+}
+
+unsigned int DeadMapCutter::GetDeadTOFw(const int chamber, const int strip) const
+{
+   return fusedCutAreasTOFw.Get(chamber, strip);
+}
+
+unsigned int DeadMapCutter::GetDeadEMCal(const int dcarm, const int sector,
+                                         const int yTower, const int zTower) const
+{
+   if (dcarm == 0) return fusedCutAreasEMCale[sector].Get(yTower, zTower);
+   return fusedCutAreasEMCalw[sector].Get(yTower, zTower);
+}
+
+void DeadMapCutter::SetDeadDC(const unsigned long numberOfTracks, const int *dcarm,
+                              const double *zDC, const double *board, const double *alpha,
+                              unsigned int *masks)
+{
+   if (!(usedMaps & DEAD_DC)) return;
+
+   std::vector<unsigned char>& isSelected = GetSelection(numberOfTracks);
+
+   // every map is looked up for the tracks of its arm and the sign of zDC
+   for (int arm = 0; arm < 2; arm++)
    {
-      if (ppc3z <= cutAreasPC3eRange[0] || ppc3z >= cutAreasPC3eRange[1] ||
-          ppc3phi <= cutAreasPC3eRange[2] || ppc3phi >= cutAreasPC3eRange[3]) return true;
-
-      short yBinMin = static_cast<short>((ppc3phi - ppc3phiVar - cutAreasPC3eRange[2])/
-                                         (cutAreasPC3eRange[3] - cutAreasPC3eRange[2])*
-                                         static_cast<double>(cutAreasPC3e.size()));
-      short xBinMin = static_cast<short>((ppc3z - ppc3zVar - cutAreasPC3eRange[0])/
-                                         (cutAreasPC3eRange[1] - cutAreasPC3eRange[0])*
-                                         static_cast<double>(cutAreasPC3e[0].size()));
-      short yBinMax = static_cast<short>((ppc3phi + ppc3phiVar - cutAreasPC3eRange[2])/
-                                         (cutAreasPC3eRange[3] - cutAreasPC3eRange[2])*
-                                         static_cast<double>(cutAreasPC3e.size()));
-      short xBinMax = static_cast<short>((ppc3z + ppc3zVar - cutAreasPC3eRange[0])/
-                                         (cutAreasPC3eRange[1] - cutAreasPC3eRange[0])*
-                                         static_cast<double>(cutAreasPC3e[0].size()));
-
-      if (yBinMin < 0) yBinMin = 0;
-      if (xBinMin < 0) xBinMin = 0;
-      if (yBinMax >= static_cast<short>(cutAreasPC3e.size())) 
-         yBinMax = static_cast<short>(cutAreasPC3e.size()) - 1;
-      if (xBinMax >= static_cast<short>(cutAreasPC3e[0].size())) 
-         xBinMax = static_cast<short>(cutAreasPC3e[0].size()) - 1;
-
-      for (short xBin = xBinMin; xBin <= xBinMax; xBin++)
+      for (const double zSign : {1., -1.})
       {
-         for (short yBin = yBinMin; yBin <= yBinMax; yBin++)
+         for (unsigned long i = 0; i < numberOfTracks; i++)
          {
-            if (cutAreasPC3e[yBin][xBin]) return true;
+            isSelected[i] = ((dcarm[i] == 0) == (arm == 0) && (zDC[i] >= 0) == (zSign > 0));
          }
+         GetMapDCX1(arm, zSign).SetDead(numberOfTracks, board, alpha, 
+                                        isSelected.data(), DEAD_DC, masks);
+         GetMapDCX2(arm, zSign).SetDead(numberOfTracks, board, alpha, 
+                                        isSelected.data(), DEAD_DC, masks);
       }
-      return false;
    }
-   // PC3w
-   if (ppc3z <= cutAreasPC3wRange[0] || ppc3z >= cutAreasPC3wRange[1] ||
-       ppc3phi <= cutAreasPC3wRange[2] || ppc3phi >= cutAreasPC3wRange[3]) return true;
-
-   short yBinMin = static_cast<short>((ppc3phi - ppc3phiVar - cutAreasPC3wRange[2])/
-                                      (cutAreasPC3wRange[3] - cutAreasPC3wRange[2])*
-                                      static_cast<double>(cutAreasPC3w.size()));
-   short xBinMin = static_cast<short>((ppc3z - ppc3zVar - cutAreasPC3wRange[0])/
-                                      (cutAreasPC3wRange[1] - cutAreasPC3wRange[0])*
-                                      static_cast<double>(cutAreasPC3w[0].size()));
-   short yBinMax = static_cast<short>((ppc3phi + ppc3phiVar - cutAreasPC3wRange[2])/
-                                      (cutAreasPC3wRange[3] - cutAreasPC3wRange[2])*
-                                      static_cast<double>(cutAreasPC3w.size()));
-   short xBinMax = static_cast<short>((ppc3z + ppc3zVar - cutAreasPC3wRange[0])/
-                                      (cutAreasPC3wRange[1] - cutAreasPC3wRange[0])*
-                                      static_cast<double>(cutAreasPC3w[0].size()));
-
-   if (yBinMin < 0) yBinMin = 0;
-   if (xBinMin < 0) xBinMin = 0;
-   if (yBinMax >= static_cast<short>(cutAreasPC3w.size())) 
-      yBinMax = static_cast<short>(cutAreasPC3w.size()) - 1;
-   if (xBinMax >= static_cast<short>(cutAreasPC3w[0].size())) 
-      xBinMax = static_cast<short>(cutAreasPC3w[0].size()) - 1;
-
-   for (short xBin = xBinMin; xBin <= xBinMax; xBin++)
-   {
-      for (short yBin = yBinMin; yBin <= yBinMax; yBin++)
-      {
-         if (cutAreasPC3w[yBin][xBin]) return true;
-      }
-   }
-   return false;
 }
 
-bool DeadMapCutter::IsDeadTOFeTight(const int chamber, const int slat, 
-                                    const int chamberVar, const int slatVar)
+void DeadMapCutter::SetDeadPC1(const unsigned long numberOfTracks, const int *dcarm,
+                               const double *ppc1z, const double *ppc1phi, unsigned int *masks)
+{
+   if (!(usedMaps & DEAD_PC1)) return;
+
+   std::vector<unsigned char>& isSelected = GetSelection(numberOfTracks);
+
+   for (unsigned long i = 0; i < numberOfTracks; i++) isSelected[i] = (dcarm[i] == 0);
+   cutAreasPC1e.SetDead(numberOfTracks, ppc1z, ppc1phi, isSelected.data(), DEAD_PC1, masks);
+
+   for (unsigned long i = 0; i < numberOfTracks; i++) isSelected[i] = !isSelected[i];
+   cutAreasPC1w.SetDead(numberOfTracks, ppc1z, ppc1phi, isSelected.data(), DEAD_PC1, masks);
+}
+
+void DeadMapCutter::SetDeadPC2(const unsigned long numberOfTracks, const double *ppc2z,
+                               const double *ppc2phi, unsigned int *masks)
+{
+   if (!(usedMaps & DEAD_PC2)) return;
+
+   std::vector<unsigned char>& isSelected = GetSelection(numberOfTracks);
+
+   for (unsigned long i = 0; i < numberOfTracks; i++) isSelected[i] = 1;
+   cutAreasPC2.SetDead(numberOfTracks, ppc2z, ppc2phi, isSelected.data(), DEAD_PC2, masks);
+}
+
+void DeadMapCutter::SetDeadPC3(const unsigned long numberOfTracks, const int *dcarm,
+                               const double *ppc3z, const double *ppc3phi, unsigned int *masks)
+{
+   if (!(usedMaps & DEAD_PC3)) return;
+
+   std::vector<unsigned char>& isSelected = GetSelection(numberOfTracks);
+
+   for (unsigned long i = 0; i < numberOfTracks; i++) isSelected[i] = (dcarm[i] == 0);
+   cutAreasPC3e.SetDead(numberOfTracks, ppc3z, ppc3phi, isSelected.data(), DEAD_PC3, masks);
+
+   for (unsigned long i = 0; i < numberOfTracks; i++) isSelected[i] = !isSelected[i];
+   cutAreasPC3w.SetDead(numberOfTracks, ppc3z, ppc3phi, isSelected.data(), DEAD_PC3, masks);
+}
+
+void DeadMapCutter::SetDeadTOFe(const unsigned long numberOfTracks, const int *chamber,
+                                const int *slat, unsigned int *masks)
 {
-   if (!useTOFe) return false;
-   if (chamber < cutAreasTOFeRange[0] || chamber >= cutAreasTOFeRange[1] ||
-       slat < cutAreasTOFeRange[2] || slat >= cutAreasTOFeRange[3]) return true;
+   if (!(usedMaps & DEAD_TOFE)) return;
+
+   std::vector<unsigned char>& isSelected = GetSelection(numberOfTracks);
 
-   short yBinMin = slat - slatVar;
-   short xBinMin = chamber - chamberVar;
-   short yBinMax = slat + slatVar;
-   short xBinMax = chamber + chamberVar;
+   for (unsigned long i = 0; i < numberOfTracks; i++) isSelected[i] = 1;
+   cutAreasTOFe.SetDeadCells(numberOfTracks, chamber, slat, 
+                             isSelected.data(), DEAD_TOFE, masks);
+}
+
+void DeadMapCutter::SetDeadTOFw(const unsigned long numberOfTracks, const int *chamber,
+                                const int *strip, unsigned int *masks)
+{
+   if (!(usedMaps & DEAD_TOFW)) return;
 
-   if (yBinMin < cutAreasTOFeRange[2]) yBinMin = cutAreasTOFeRange[2];
-   if (xBinMin < cutAreasTOFeRange[0]) xBinMin = cutAreasTOFeRange[0];
-   if (yBinMax >= cutAreasTOFeRange[1]) yBinMax = cutAreasTOFeRange[3] - 1;
-   if (xBinMax >= cutAreasTOFeRange[3]) xBinMax = cutAreasTOFeRange[1] - 1;
+   std::vector<unsigned char>& isSelected = GetSelection(numberOfTracks);
 
-   for (short xBin = xBinMin; xBin <= xBinMax; xBin++)
+   for (unsigned long i = 0; i < numberOfTracks; i++) isSelected[i] = 1;
+   cutAreasTOFw.SetDeadCells(numberOfTracks, chamber, strip, 
+                             isSelected.data(), DEAD_TOFW, masks);
+}
+
+void DeadMapCutter::SetDeadEMCal(const unsigned long numberOfTracks, const int *dcarm,
+                                 const int *sector, const int *yTower, const int *zTower,
+                                 unsigned int *masks)
+{
+   if (!(usedMaps & DEAD_EMCAL)) return;
+
+   std::vector<unsigned char>& isSelected = GetSelection(numberOfTracks);
+
+   for (int i = 0; i < 4; i++)
    {
-      for (short yBin = yBinMin; yBin <= yBinMax; yBin++)
+      for (unsigned long j = 0; j < numberOfTracks; j++)
       {
-         if (cutAreasTOFe[yBin][xBin]) return true;
+         isSelected[j] = (dcarm[j] == 0 && sector[j] == i);
       }
+      cutAreasEMCale[i].SetDeadCells(numberOfTracks, yTower, zTower, 
+                                     isSelected.data(), DEAD_EMCAL, masks);
+
+      for (unsigned long j = 0; j < numberOfTracks; j++)
+      {
+         isSelected[j] = (dcarm[j] != 0 && sector[j] == i);
+      }
+      cutAreasEMCalw[i].SetDeadCells(numberOfTracks, yTower, zTower, 
+                                     isSelected.data(), DEAD_EMCAL, masks);
    }
-   return false;
 }
 
-bool DeadMapCutter::IsDeadTOFwTight(const int chamber, const int strip,
-                                    const int chamberVar, const int stripVar)
+void DeadMapCutter::SetDeadTimingTOFe(const unsigned long numberOfTracks, const int *chamber,
+                                      const int *slat, unsigned int *masks)
+{
+   if (!(usedMaps & DEAD_TIMING_TOFE)) return;
+
+   std::vector<unsigned char>& isSelected = GetSelection(numberOfTracks);
+
+   for (unsigned long i = 0; i < numberOfTracks; i++) isSelected[i] = 1;
+   cutAreasTimingTOFe.SetDeadCells(numberOfTracks, chamber, slat, 
+                                   isSelected.data(), DEAD_TIMING_TOFE, masks);
+}
+
+void DeadMapCutter::SetDeadTimingTOFw(const unsigned long numberOfTracks, const int *chamber,
+                                      const int *strip, unsigned int *masks)
 {
-   if (!useTOFw) return false;
+   if (!(usedMaps & DEAD_TIMING_TOFW)) return;
 
-   if (chamber < cutAreasTOFwRange[0] || chamber >= cutAreasTOFwRange[1] ||
-       strip < cutAreasTOFwRange[2] || strip >= cutAreasTOFwRange[3]) return true;
+   std::vector<unsigned char>& isSelected = GetSelection(numberOfTracks);
 
-   short yBinMin = strip - stripVar;
-   short xBinMin = chamber - chamberVar;
-   short yBinMax = strip + stripVar;
-   short xBinMax = chamber + chamberVar;
+   for (unsigned long i = 0; i < numberOfTracks; i++) isSelected[i] = 1;
+   cutAreasTimingTOFw.SetDeadCells(numberOfTracks, chamber, strip, 
+                                   isSelected.data(), DEAD_TIMING_TOFW, masks);
+}
 
-   if (yBinMin < cutAreasTOFwRange[2]) yBinMin = cutAreasTOFwRange[2];
-   if (xBinMin < cutAreasTOFwRange[0]) xBinMin = cutAreasTOFwRange[0];
-   if (yBinMax >= cutAreasTOFwRange[1]) yBinMax = cutAreasTOFwRange[3] - 1;
-   if (xBinMax >= cutAreasTOFwRange[3]) xBinMax = cutAreasTOFwRange[1] - 1;
+void DeadMapCutter::SetDeadTimingEMCal(const unsigned long numberOfTracks, const int *dcarm,
+                                       const int *sector, const int *yTower, const int *zTower,
+                                       unsigned int *masks)
+{
+   if (!(usedMaps & DEAD_TIMING_EMCAL)) return;
 
-   for (short xBin = xBinMin; xBin <= xBinMax; xBin++)
+   std::vector<unsigned char>& isSelected = GetSelection(numberOfTracks);
+
+   // edges of the range are excluded for EMCal timing deadmaps 
+   // so towers are looked up the same way as the coordinates
+   thread_local std::vector<double> yTowers, zTowers;
+   yTowers.assign(yTower, yTower + numberOfTracks);
+   zTowers.assign(zTower, zTower + numberOfTracks);
+
+   for (int i = 0; i < 4; i++)
    {
-      for (short yBin = yBinMin; yBin <= yBinMax; yBin++)
+      for (unsigned long j = 0; j < numberOfTracks; j++)
       {
-         if (cutAreasTOFw[yBin][xBin]) return true;
+         isSelected[j] = (dcarm[j] == 0 && sector[j] == i);
       }
+      cutAreasTimingEMCale[i].SetDead(numberOfTracks, yTowers.data(), zTowers.data(), 
+                                      isSelected.data(), DEAD_TIMING_EMCAL, masks);
+
+      for (unsigned long j = 0; j < numberOfTracks; j++)
+      {
+         isSelected[j] = (dcarm[j] != 0 && sector[j] == i);
+      }
+      cutAreasTimingEMCalw[i].SetDead(numberOfTracks, yTowers.data(), zTowers.data(), 
+                                      isSelected.data(), DEAD_TIMING_EMCAL, masks);
    }
-   return false;
 }
 
-bool DeadMapCutter::IsDeadEMCalTight(const int dcarm, const int sector, 
-                                     const int yTower, const int zTower,
-                                     const int yTowerVar, const int zTowerVar)
+double DeadMapCutter::Mask(TH2 *hist, const DeadBit deadmap, 
+                           const int dcarm, const int section)
 {
-   if (!useEMCal) return false;
+   const std::vector<unsigned char>& deadBins = GetDeadBins(hist, deadmap, dcarm, section);
+   // live fraction is evaluated before the contents of the dead bins are set to 0
+   const double liveFraction = GetHistLiveFraction(hist, deadBins);
 
-   if (dcarm == 0) // EMCale
+   if (TArrayF *contents = dynamic_cast<TArrayF *>(hist))
    {
-      if (yTower < cutAreasEMCaleRange[sector][0] || 
-          yTower >= cutAreasEMCaleRange[sector][1] ||
-          zTower < cutAreasEMCaleRange[sector][2] || 
-          zTower >= cutAreasEMCaleRange[sector][3]) return true;
-
-      short yBinMin = zTower - zTowerVar;
-      short xBinMin = yTower - yTowerVar;
-      short yBinMax = zTower + zTowerVar;
-      short xBinMax = yTower + yTowerVar;
-
-      if (yBinMin < cutAreasEMCaleRange[sector][2]) yBinMin = cutAreasEMCaleRange[sector][2];
-      if (xBinMin < cutAreasEMCaleRange[sector][0]) xBinMin = cutAreasEMCaleRange[sector][0];
-      if (yBinMax >= cutAreasEMCaleRange[sector][1]) yBinMax = cutAreasEMCaleRange[sector][3] - 1;
-      if (xBinMax >= cutAreasEMCaleRange[sector][3]) xBinMax = cutAreasEMCaleRange[sector][1] - 1;
-
-      for (short xBin = xBinMin; xBin <= xBinMax; xBin++)
-      {
-         for (short yBin = yBinMin; yBin <= yBinMax; yBin++)
-         {
-            if (cutAreasEMCale[sector][yBin][xBin]) return true;
-         }
-      }
-      return false;
+      ZeroDeadBins(contents->GetArray(), deadBins);
    }
-   // EMCalw
-   if (yTower < cutAreasEMCalwRange[sector][0] || 
-       yTower >= cutAreasEMCalwRange[sector][1] ||
-       zTower < cutAreasEMCalwRange[sector][2] || 
-       zTower >= cutAreasEMCalwRange[sector][3]) return true;
-
-   short yBinMin = zTower - zTowerVar;
-   short xBinMin = yTower - yTowerVar;
-   short yBinMax = zTower + zTowerVar;
-   short xBinMax = yTower + yTowerVar;
-
-   if (yBinMin < cutAreasEMCalwRange[sector][2]) yBinMin = cutAreasEMCalwRange[sector][2];
-   if (xBinMin < cutAreasEMCalwRange[sector][0]) xBinMin = cutAreasEMCalwRange[sector][0];
-   if (yBinMax >= cutAreasEMCalwRange[sector][1]) yBinMax = cutAreasEMCalwRange[sector][3] - 1;
-   if (xBinMax >= cutAreasEMCalwRange[sector][3]) xBinMax = cutAreasEMCalwRange[sector][1] - 1;
-
-   for (short xBin = xBinMin; xBin <= xBinMax; xBin++)
+   else if (TArrayD *contents = dynamic_cast<TArrayD *>(hist))
    {
-      for (short yBin = yBinMin; yBin <= yBinMax; yBin++)
+      ZeroDeadBins(contents->GetArray(), deadBins);
+   }
+   else
+   {
+      for (unsigned long bin = 0; bin < deadBins.size(); bin++)
       {
-         if (cutAreasEMCalw[sector][yBin][xBin]) return true;
+         if (deadBins[bin]) hist->SetBinContent(static_cast<int>(bin), 0.);
       }
    }
-   return false;
+
+   // statistics are evaluated from the bin contents since the contents were changed directly
+   hist->ResetStats();
+
+   return liveFraction;
 }
 
-bool DeadMapCutter::IsDeadTimingTOFeTight(const int chamber, const int slat, 
-                                          const int chamberVar, const int slatVar)
+double DeadMapCutter::GetLiveFraction(const TH2 *hist, const DeadBit deadmap, 
+                                      const int dcarm, const int section)
 {
-   if (!useTOFe) return false;
-   if (chamber < cutAreasTimingTOFeRange[0] || chamber >= cutAreasTimingTOFeRange[1] ||
-       slat < cutAreasTimingTOFeRange[2] || slat >= cutAreasTimingTOFeRange[3]) return true;
+   return GetHistLiveFraction(hist, GetDeadBins(hist, deadmap, dcarm, section));
+}
 
-   short yBinMin = slat - slatVar;
-   short xBinMin = chamber - chamberVar;
-   short yBinMax = slat + slatVar;
-   short xBinMax = chamber + chamberVar;
+const DeadMap& DeadMapCutter::GetMapDCX1(const int dcarm, const double zDC) const
+{
+   if (dcarm == 0) return (zDC >= 0) ? cutAreasDCe0X1 : cutAreasDCe1X1;
+   return (zDC >= 0) ? cutAreasDCw0X1 : cutAreasDCw1X1;
+}
 
-   if (yBinMin < cutAreasTimingTOFeRange[2]) yBinMin = cutAreasTimingTOFeRange[2];
-   if (xBinMin < cutAreasTimingTOFeRange[0]) xBinMin = cutAreasTimingTOFeRange[0];
-   if (yBinMax >= cutAreasTimingTOFeRange[1]) yBinMax = cutAreasTimingTOFeRange[3] - 1;
-   if (xBinMax >= cutAreasTimingTOFeRange[3]) xBinMax = cutAreasTimingTOFeRange[1] - 1;
+const DeadMap& DeadMapCutter::GetMapDCX2(const int dcarm, const double zDC) const
+{
+   if (dcarm == 0) return (zDC >= 0) ? cutAreasDCe0X2 : cutAreasDCe1X2;
+   return (zDC >= 0) ? cutAreasDCw0X2 : cutAreasDCw1X2;
+}
 
-   for (short xBin = xBinMin; xBin <= xBinMax; xBin++)
-   {
-      for (short yBin = yBinMin; yBin <= yBinMax; yBin++)
-      {
-         if (cutAreasTimingTOFe[yBin][xBin]) return true;
-      }
-   }
-   return false;
+std::vector<unsigned char>& DeadMapCutter::GetSelection(const unsigned long numberOfTracks)
+{
+   thread_local std::vector<unsigned char> isSelected;
+   isSelected.resize(numberOfTracks);
+   return isSelected;
 }
 
-bool DeadMapCutter::IsDeadTimingTOFwTight(const int chamber, const int strip,
-                                          const int chamberVar, const int stripVar)
+const std::vector<unsigned char>& 
+DeadMapCutter::GetDeadBins(const TH2 *hist, const DeadBit deadmap, 
+                           const int dcarm, const int section)
 {
-   if (!useTOFw) return false;
+   DeadBinsKey key(deadmap, dcarm, section, 
+                   GetBinCenters(hist->GetXaxis()), GetBinCenters(hist->GetYaxis()));
 
-   if (chamber < cutAreasTimingTOFwRange[0] || chamber >= cutAreasTimingTOFwRange[1] ||
-       strip < cutAreasTimingTOFwRange[2] || strip >= cutAreasTimingTOFwRange[3]) return true;
+   std::unique_ptr<std::vector<unsigned char>>& deadBins = deadBinsCaches[key];
+   if (deadBins) return *deadBins;
 
-   short yBinMin = strip - stripVar;
-   short xBinMin = chamber - chamberVar;
-   short yBinMax = strip + stripVar;
-   short xBinMax = chamber + chamberVar;
+   const std::vector<double>& xBinCenters = std::get<3>(key);
+   const std::vector<double>& yBinCenters = std::get<4>(key);
 
-   if (yBinMin < cutAreasTimingTOFwRange[2]) yBinMin = cutAreasTimingTOFwRange[2];
-   if (xBinMin < cutAreasTimingTOFwRange[0]) xBinMin = cutAreasTimingTOFwRange[0];
-   if (yBinMax >= cutAreasTimingTOFwRange[1]) yBinMax = cutAreasTimingTOFwRange[3] - 1;
-   if (xBinMax >= cutAreasTimingTOFwRange[3]) xBinMax = cutAreasTimingTOFwRange[1] - 1;
+   const int xNBins = static_cast<int>(xBinCenters.size());
+   const int yNBins = static_cast<int>(yBinCenters.size());
 
-   for (short xBin = xBinMin; xBin <= xBinMax; xBin++)
+   // underflow and overflow bins are never dead
+   deadBins = std::make_unique<std::vector<unsigned char>>
+      (static_cast<unsigned long>((xNBins + 2)*(yNBins + 2)), 0);
+
+   for (int j = 1; j <= yNBins; j++)
    {
-      for (short yBin = yBinMin; yBin <= yBinMax; yBin++)
+      for (int i = 1; i <= xNBins; i++)
       {
-         if (cutAreasTimingTOFw[yBin][xBin]) return true;
+         (*deadBins)[j*(xNBins + 2) + i] = 
+            IsDeadBin(deadmap, dcarm, section, i, j, xBinCenters[i - 1], yBinCenters[j - 1]);
       }
    }
-   return false;
+
+   return *deadBins;
 }
 
-bool DeadMapCutter::IsDeadTimingEMCalTight(const int dcarm, const int sector, 
-                                           const int yTower, const int zTower,
-                                           const int yTowerVar, const int zTowerVar)
+bool DeadMapCutter::IsDeadBin(const DeadBit deadmap, const int dcarm, const int section,
+                              const int xBin, const int yBin, const double x, const double y)
 {
-   if (!useEMCal) return false;
-
-   if (dcarm == 0) // EMCale
-   {
-      if (yTower < cutAreasTimingEMCaleRange[sector][0] || 
-          yTower >= cutAreasTimingEMCaleRange[sector][1] ||
-          zTower < cutAreasTimingEMCaleRange[sector][2] || 
-          zTower >= cutAreasTimingEMCaleRange[sector][3]) return true;
-
-      short yBinMin = zTower - zTowerVar;
-      short xBinMin = yTower - yTowerVar;
-      short yBinMax = zTower + zTowerVar;
-      short xBinMax = yTower + yTowerVar;
-
-      if (yBinMin < cutAreasTimingEMCaleRange[sector][2]) 
-         yBinMin = cutAreasTimingEMCaleRange[sector][2];
-      if (xBinMin < cutAreasTimingEMCaleRange[sector][0]) 
-         xBinMin = cutAreasTimingEMCaleRange[sector][0];
-      if (yBinMax >= cutAreasTimingEMCaleRange[sector][1]) 
-         yBinMax = cutAreasTimingEMCaleRange[sector][3] - 1;
-      if (xBinMax >= cutAreasTimingEMCaleRange[sector][3]) 
-         xBinMax = cutAreasTimingEMCaleRange[sector][1] - 1;
-
-      for (short xBin = xBinMin; xBin <= xBinMax; xBin++)
-      {
-         for (short yBin = yBinMin; yBin <= yBinMax; yBin++)
-         {
-            if (cutAreasTimingEMCale[sector][yBin][xBin]) return true;
-         }
-      }
-      return false;
-   }
-   // EMCalw
-   if (yTower < cutAreasTimingEMCalwRange[sector][0] || 
-       yTower >= cutAreasTimingEMCalwRange[sector][1] ||
-       zTower < cutAreasTimingEMCalwRange[sector][2] || 
-       zTower >= cutAreasTimingEMCalwRange[sector][3]) return true;
-
-   short yBinMin = zTower - zTowerVar;
-   short xBinMin = yTower - yTowerVar;
-   short yBinMax = zTower + zTowerVar;
-   short xBinMax = yTower + yTowerVar;
-
-   if (yBinMin < cutAreasTimingEMCalwRange[sector][2]) 
-      yBinMin = cutAreasTimingEMCalwRange[sector][2];
-   if (xBinMin < cutAreasTimingEMCalwRange[sector][0]) 
-      xBinMin = cutAreasTimingEMCalwRange[sector][0];
-   if (yBinMax >= cutAreasTimingEMCalwRange[sector][1]) 
-      yBinMax = cutAreasTimingEMCalwRange[sector][3] - 1;
-   if (xBinMax >= cutAreasTimingEMCalwRange[sector][3]) 
-      xBinMax = cutAreasTimingEMCalwRange[sector][1] - 1;
-
-   for (short xBin = xBinMin; xBin <= xBinMax; xBin++)
+   switch (deadmap)
    {
-      for (short yBin = yBinMin; yBin <= yBinMax; yBin++)
-      {
-         if (cutAreasTimingEMCalw[sector][yBin][xBin]) return true;
-      }
+      case DEAD_DC: return IsDeadDC(dcarm, (section == 0) ? 1. : -1., x, y);
+      case DEAD_PC1: return IsDeadPC1(dcarm, x, y);
+      case DEAD_PC2: return IsDeadPC2(x, y);
+      case DEAD_PC3: return IsDeadPC3(dcarm, x, y);
+      case DEAD_TOFE: return IsDeadTOFe(xBin - 1, yBin - 1);
+      case DEAD_TOFW: return IsDeadTOFw(xBin - 1, yBin - 1);
+      case DEAD_EMCAL: return IsDeadEMCal(dcarm, section, xBin - 1, yBin - 1);
+      case DEAD_TIMING_TOFE: return IsDeadTimingTOFe(xBin - 1, yBin - 1);
+      case DEAD_TIMING_TOFW: return IsDeadTimingTOFw(xBin - 1, yBin - 1);
+      case DEAD_TIMING_EMCAL: return IsDeadTimingEMCal(dcarm, section, xBin - 1, yBin - 1);
    }
    return false;
 }
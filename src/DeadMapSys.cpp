@@ -391,36 +391,17 @@ int main(int argc, char **argv)
       TH2F *simCutHeatmapDCw0 = static_cast<TH2F *>(simHeatmapDCw0->Clone("DCw, zDC>=0 sim"));
       TH2F *simCutHeatmapDCw1 = static_cast<TH2F *>(simHeatmapDCw1->Clone("DCw, zDC<0 sim"));
 
-      // for this project X and Y axis for different DC heatmaps are the same
-      for (int i = 1; i <= realHeatmapDCe0->GetXaxis()->GetNbins(); i++)
-      {
-         const double x = realHeatmapDCe0->GetXaxis()->GetBinCenter(i);
-         for (int j = 1; j <= realHeatmapDCe0->GetYaxis()->GetNbins(); j++)
-         {
-            const double y = realHeatmapDCe0->GetYaxis()->GetBinCenter(j);
+      dmCutter.Mask(realCutHeatmapDCe0, DeadMapCutter::DEAD_DC, 0, 0);
+      dmCutter.Mask(simCutHeatmapDCe0, DeadMapCutter::DEAD_DC, 0, 0);
 
-            if (dmCutter.IsDeadDC(0, 1., x, y))
-            {
-               realCutHeatmapDCe0->SetBinContent(i, j, 0.);
-               simCutHeatmapDCe0->SetBinContent(i, j, 0.);
-            }
-            if (dmCutter.IsDeadDC(0, -1., x, y))
-            {
-               realCutHeatmapDCe1->SetBinContent(i, j, 0.);
-               simCutHeatmapDCe1->SetBinContent(i, j, 0.);
-            }
-            if (dmCutter.IsDeadDC(1, 1., x, y))
-            {
-               realCutHeatmapDCw0->SetBinContent(i, j, 0.);
-               simCutHeatmapDCw0->SetBinContent(i, j, 0.);
-            }
-            if (dmCutter.IsDeadDC(1, -1., x, y))
-            {
-               realCutHeatmapDCw1->SetBinContent(i, j, 0.);
-               simCutHeatmapDCw1->SetBinContent(i, j, 0.);
-            }
-         }
-      }
+      dmCutter.Mask(realCutHeatmapDCe1, DeadMapCutter::DEAD_DC, 0, 1);
+      dmCutter.Mask(simCutHeatmapDCe1, DeadMapCutter::DEAD_DC, 0, 1);
+
+      dmCutter.Mask(realCutHeatmapDCw0, DeadMapCutter::DEAD_DC, 1, 0);
+      dmCutter.Mask(simCutHeatmapDCw0, DeadMapCutter::DEAD_DC, 1, 0);
+
+      dmCutter.Mask(realCutHeatmapDCw1, DeadMapCutter::DEAD_DC, 1, 1);
+      dmCutter.Mask(simCutHeatmapDCw1, DeadMapCutter::DEAD_DC, 1, 1);
 
       DrawDeadmap(realHeatmapDCe0, realCutHeatmapDCe0,
                   "DCe0", "DC east, #it{z}_{DC}#geq0", "board", "#it{#alpha}");
@@ -552,34 +533,10 @@ int main(int argc, char **argv)
       TH2F *simCutHeatmapPC1e = static_cast<TH2F *>(simHeatmapPC1e->Clone());
       TH2F *simCutHeatmapPC1w = static_cast<TH2F *>(simHeatmapPC1w->Clone());
 
-      for (int i = 1; i <= realHeatmapPC1e->GetXaxis()->GetNbins(); i++)
-      {
-         const double x = realHeatmapPC1e->GetXaxis()->GetBinCenter(i);
-         for (int j = 1; j <= realHeatmapPC1e->GetYaxis()->GetNbins(); j++)
-         {
-            const double y = realHeatmapPC1e->GetYaxis()->GetBinCenter(j);
-
-            if (dmCutter.IsDeadPC1(0, x, y))
-            {
-               realCutHeatmapPC1e->SetBinContent(i, j, 0.);
-               simCutHeatmapPC1e->SetBinContent(i, j, 0.);
-            }
-         }
-      }
-      for (int i = 1; i <= realHeatmapPC1w->GetXaxis()->GetNbins(); i++)
-      {
-         const double x = realHeatmapPC1w->GetXaxis()->GetBinCenter(i);
-         for (int j = 1; j <= realHeatmapPC1w->GetYaxis()->GetNbins(); j++)
-         {
-            const double y = realHeatmapPC1w->GetYaxis()->GetBinCenter(j);
-
-            if (dmCutter.IsDeadPC1(1, x, y))
-            {
-               realCutHeatmapPC1w->SetBinContent(i, j, 0.);
-               simCutHeatmapPC1w->SetBinContent(i, j, 0.);
-            }
-         }
-      }
+      dmCutter.Mask(realCutHeatmapPC1e, DeadMapCutter::DEAD_PC1, 0);
+      dmCutter.Mask(simCutHeatmapPC1e, DeadMapCutter::DEAD_PC1, 0);
+      dmCutter.Mask(realCutHeatmapPC1w, DeadMapCutter::DEAD_PC1, 1);
+      dmCutter.Mask(simCutHeatmapPC1w, DeadMapCutter::DEAD_PC1, 1);
 
       DrawDeadmap(realHeatmapPC1e, realCutHeatmapPC1e,
                   "PC1e", "PC1 east", "#it{z}_{PC1}", "#it{#varphi}_{PC1}");
@@ -599,34 +556,14 @@ int main(int argc, char **argv)
       simHeatmapPC1e = static_cast<TH2F *>(simCutHeatmapPC1e->Clone());
       simHeatmapPC1w = static_cast<TH2F *>(simCutHeatmapPC1w->Clone());
 
-      for (int i = 1; i <= realHeatmapPC1e->GetXaxis()->GetNbins(); i++)
-      {
-         const double x = realHeatmapPC1e->GetXaxis()->GetBinCenter(i);
-         for (int j = 1; j <= realHeatmapPC1e->GetYaxis()->GetNbins(); j++)
-         {
-            const double y = realHeatmapPC1e->GetYaxis()->GetBinCenter(j);
-
-            if (dmCutterMC.IsDeadPC1(0, x, y))
-            {
-               realCutHeatmapPC1e->SetBinContent(i, j, 0.);
-               simCutHeatmapPC1e->SetBinContent(i, j, 0.);
-            }
-         }
-      }
-      for (int i = 1; i <= realHeatmapPC1w->GetXaxis()->GetNbins(); i++)
-      {
-         const double x = realHeatmapPC1w->GetXaxis()->GetBinCenter(i);
-         for (int j = 1; j <= realHeatmapPC1w->GetYaxis()->GetNbins(); j++)
-         {
-            const double y = realHeatmapPC1w->GetYaxis()->GetBinCenter(j);
-
-            if (dmCutterMC.IsDeadPC1(1, x, y))
-            {
-               realCutHeatmapPC1w->SetBinContent(i, j, 0.);
-               simCutHeatmapPC1w->SetBinContent(i, j, 0.);
-            }
-         }
-      }
+      // live fraction of data after the additional cuts on MC
+      const double liveFractionPC1e = 
+         dmCutterMC.Mask(realCutHeatmapPC1e, DeadMapCutter::DEAD_PC1, 0);
+      dmCutterMC.Mask(simCutHeatmapPC1e, DeadMapCutter::DEAD_PC1, 0);
+      // live fraction of data after the additional cuts on MC
+      const double liveFractionPC1w = 
+         dmCutterMC.Mask(realCutHeatmapPC1w, DeadMapCutter::DEAD_PC1, 1);
+      dmCutterMC.Mask(simCutHeatmapPC1w, DeadMapCutter::DEAD_PC1, 1);
 
       DrawDeadmap(simHeatmapPC1e, simCutHeatmapPC1e,
                   "PC1e_MC", "PC1 east", "#it{z}_{PC1}", "#it{#varphi}_{PC1}");
@@ -640,14 +577,8 @@ int main(int argc, char **argv)
                         "PC1w_MC", "PC1 west", "#it{z}_{PC1}", "#it{#varphi}_{PC1}", 2) << 
          std::endl;
 
-      reweightPC1e = realHeatmapPC1e->Integral(1, realHeatmapPC1e->GetXaxis()->GetNbins(),
-                                             1, realHeatmapPC1e->GetYaxis()->GetNbins())/
-                     realCutHeatmapPC1e->Integral(1, realHeatmapPC1e->GetXaxis()->GetNbins(),
-                                                1, realHeatmapPC1e->GetYaxis()->GetNbins());
-      reweightPC1w = realHeatmapPC1w->Integral(1, realHeatmapPC1w->GetXaxis()->GetNbins(),
-                                             1, realHeatmapPC1w->GetYaxis()->GetNbins())/
-                     realCutHeatmapPC1w->Integral(1, realHeatmapPC1w->GetXaxis()->GetNbins(),
-                                                1, realHeatmapPC1w->GetYaxis()->GetNbins());
+      reweightPC1e = 1./liveFractionPC1e;
+      reweightPC1w = 1./liveFractionPC1w;
    }
    else
    {
@@ -664,20 +595,8 @@ int main(int argc, char **argv)
       TH2F *realCutHeatmapPC2 = static_cast<TH2F *>(realHeatmapPC2->Clone());
       TH2F *simCutHeatmapPC2 = static_cast<TH2F *>(simHeatmapPC2->Clone());
 
-      for (int i = 1; i <= realHeatmapPC2->GetXaxis()->GetNbins(); i++)
-      {
-         const double x = realHeatmapPC2->GetXaxis()->GetBinCenter(i);
-         for (int j = 1; j <= realHeatmapPC2->GetYaxis()->GetNbins(); j++)
-         {
-            const double y = realHeatmapPC2->GetYaxis()->GetBinCenter(j);
-
-            if (dmCutter.IsDeadPC2(x, y))
-            {
-               realCutHeatmapPC2->SetBinContent(i, j, 0.);
-               simCutHeatmapPC2->SetBinContent(i, j, 0.);
-            }
-         }
-      }
+      dmCutter.Mask(realCutHeatmapPC2, DeadMapCutter::DEAD_PC2);
+      dmCutter.Mask(simCutHeatmapPC2, DeadMapCutter::DEAD_PC2);
 
       DrawDeadmap(realHeatmapPC2, realCutHeatmapPC2,
                   "PC2", "PC2", "#it{z}_{PC2}", "#it{#varphi}_{PC2}");
@@ -690,20 +609,9 @@ int main(int argc, char **argv)
       realHeatmapPC2 = static_cast<TH2F *>(realCutHeatmapPC2->Clone());
       simHeatmapPC2 = static_cast<TH2F *>(simCutHeatmapPC2->Clone());
 
-      for (int i = 1; i <= realHeatmapPC2->GetXaxis()->GetNbins(); i++)
-      {
-         const double x = realHeatmapPC2->GetXaxis()->GetBinCenter(i);
-         for (int j = 1; j <= realHeatmapPC2->GetYaxis()->GetNbins(); j++)
-         {
-            const double y = realHeatmapPC2->GetYaxis()->GetBinCenter(j);
-
-            if (dmCutterMC.IsDeadPC2(x, y))
-            {
-               realCutHeatmapPC2->SetBinContent(i, j, 0.);
-               simCutHeatmapPC2->SetBinContent(i, j, 0.);
-            }
-         }
-      }
+      // live fraction of data after the additional cuts on MC
+      const double liveFractionPC2 = dmCutterMC.Mask(realCutHeatmapPC2, DeadMapCutter::DEAD_PC2);
+      dmCutterMC.Mask(simCutHeatmapPC2, DeadMapCutter::DEAD_PC2);
 
       DrawDeadmap(simHeatmapPC2, simCutHeatmapPC2,
                   "PC2_MC", "PC2", "#it{z}_{PC2}", "#it{#varphi}_{PC2}");
@@ -713,10 +621,7 @@ int main(int argc, char **argv)
                         realCutHeatmapPC2, simCutHeatmapPC2, 10,
                         "PC2_MC", "PC2", "#it{z}_{PC2}", "#it{#varphi}_{PC2}") << std::endl;
 
-      reweightPC2 = realHeatmapPC2->Integral(1, realHeatmapPC2->GetXaxis()->GetNbins(),
-                                           1, realHeatmapPC2->GetYaxis()->GetNbins())/
-                     realCutHeatmapPC2->Integral(1, realHeatmapPC2->GetXaxis()->GetNbins(),
-                                               1, realHeatmapPC2->GetYaxis()->GetNbins());
+      reweightPC2 = 1./liveFractionPC2;
    }
    else
    {
@@ -740,34 +645,10 @@ int main(int argc, char **argv)
       TH2F *simCutHeatmapPC3e = static_cast<TH2F *>(simHeatmapPC3e->Clone());
       TH2F *simCutHeatmapPC3w = static_cast<TH2F *>(simHeatmapPC3w->Clone());
 
-      for (int i = 1; i <= realHeatmapPC3e->GetXaxis()->GetNbins(); i++)
-      {
-         const double x = realHeatmapPC3e->GetXaxis()->GetBinCenter(i);
-         for (int j = 1; j <= realHeatmapPC3e->GetYaxis()->GetNbins(); j++)
-         {
-            const double y = realHeatmapPC3e->GetYaxis()->GetBinCenter(j);
-
-            if (dmCutter.IsDeadPC3(0, x, y))
-            {
-               realCutHeatmapPC3e->SetBinContent(i, j, 0.);
-               simCutHeatmapPC3e->SetBinContent(i, j, 0.);
-            }
-         }
-      }
-      for (int i = 1; i <= realHeatmapPC3w->GetXaxis()->GetNbins(); i++)
-      {
-         const double x = realHeatmapPC3w->GetXaxis()->GetBinCenter(i);
-         for (int j = 1; j <= realHeatmapPC3w->GetYaxis()->GetNbins(); j++)
-         {
-            const double y = realHeatmapPC3w->GetYaxis()->GetBinCenter(j);
-
-            if (dmCutter.IsDeadPC3(1, x, y))
-            {
-               realCutHeatmapPC3w->SetBinContent(i, j, 0.);
-               simCutHeatmapPC3w->SetBinContent(i, j, 0.);
-            }
-         }
-      }
+      dmCutter.Mask(realCutHeatmapPC3e, DeadMapCutter::DEAD_PC3, 0);
+      dmCutter.Mask(simCutHeatmapPC3e, DeadMapCutter::DEAD_PC3, 0);
+      dmCutter.Mask(realCutHeatmapPC3w, DeadMapCutter::DEAD_PC3, 1);
+      dmCutter.Mask(simCutHeatmapPC3w, DeadMapCutter::DEAD_PC3, 1);
 
       DrawDeadmap(realHeatmapPC3e, realCutHeatmapPC3e,
                   "PC3e", "PC3 east", "#it{z}_{PC3}", "#it{#varphi}_{PC3}");
@@ -790,34 +671,14 @@ int main(int argc, char **argv)
       simHeatmapPC3e = static_cast<TH2F *>(simCutHeatmapPC3e->Clone());
       simHeatmapPC3w = static_cast<TH2F *>(simCutHeatmapPC3w->Clone());
 
-      for (int i = 1; i <= realHeatmapPC3e->GetXaxis()->GetNbins(); i++)
-      {
-         const double x = realHeatmapPC3e->GetXaxis()->GetBinCenter(i);
-         for (int j = 1; j <= realHeatmapPC3e->GetYaxis()->GetNbins(); j++)
-         {
-            const double y = realHeatmapPC3e->GetYaxis()->GetBinCenter(j);
-
-            if (dmCutterMC.IsDeadPC3(0, x, y))
-            {
-               realCutHeatmapPC3e->SetBinContent(i, j, 0.);
-               simCutHeatmapPC3e->SetBinContent(i, j, 0.);
-            }
-         }
-      }
-      for (int i = 1; i <= realHeatmapPC3w->GetXaxis()->GetNbins(); i++)
-      {
-         const double x = realHeatmapPC3w->GetXaxis()->GetBinCenter(i);
-         for (int j = 1; j <= realHeatmapPC3w->GetYaxis()->GetNbins(); j++)
-         {
-            const double y = realHeatmapPC3w->GetYaxis()->GetBinCenter(j);
-
-            if (dmCutterMC.IsDeadPC3(1, x, y))
-            {
-               realCutHeatmapPC3w->SetBinContent(i, j, 0.);
-               simCutHeatmapPC3w->SetBinContent(i, j, 0.);
-            }
-         }
-      }
+      // live fraction of data after the additional cuts on MC
+      const double liveFractionPC3e = 
+         dmCutterMC.Mask(realCutHeatmapPC3e, DeadMapCutter::DEAD_PC3, 0);
+      dmCutterMC.Mask(simCutHeatmapPC3e, DeadMapCutter::DEAD_PC3, 0);
+      // live fraction of data after the additional cuts on MC
+      const double liveFractionPC3w = 
+         dmCutterMC.Mask(realCutHeatmapPC3w, DeadMapCutter::DEAD_PC3, 1);
+      dmCutterMC.Mask(simCutHeatmapPC3w, DeadMapCutter::DEAD_PC3, 1);
 
       DrawDeadmap(simHeatmapPC3e, simCutHeatmapPC3e,
                   "PC3e_MC", "PC3 east", "#it{z}_{PC3}", "#it{#varphi}_{PC3}");
@@ -833,14 +694,8 @@ int main(int argc, char **argv)
                         "PC3w_MC", "PC3 west", "#it{z}_{PC3}", "#it{#varphi}_{PC3}", 2) << 
          std::endl;
 
-      reweightPC3e = realHeatmapPC3e->Integral(1, realHeatmapPC3e->GetXaxis()->GetNbins(),
-                                             1, realHeatmapPC3e->GetYaxis()->GetNbins())/
-                     realCutHeatmapPC3e->Integral(1, realHeatmapPC3e->GetXaxis()->GetNbins(),
-                                                1, realHeatmapPC3e->GetYaxis()->GetNbins());
-      reweightPC3w = realHeatmapPC3w->Integral(1, realHeatmapPC3w->GetXaxis()->GetNbins(),
-                                             1, realHeatmapPC3w->GetYaxis()->GetNbins())/
-                     realCutHeatmapPC3w->Integral(1, realHeatmapPC3w->GetXaxis()->GetNbins(),
-                                                1, realHeatmapPC3w->GetYaxis()->GetNbins());
+      reweightPC3e = 1./liveFractionPC3e;
+      reweightPC3w = 1./liveFractionPC3w;
    }
    else
    {
@@ -869,32 +724,19 @@ int main(int argc, char **argv)
       TH2F *realMCCutHeatmapTOFeSys = static_cast<TH2F *>(realCutHeatmapTOFeSys->Clone());
       TH2F *simMCCutHeatmapTOFeSys = static_cast<TH2F *>(simCutHeatmapTOFeSys->Clone());
 
-      for (int i = 1; i <= realHeatmapTOFe->GetXaxis()->GetNbins(); i++)
-      {
-         for (int j = 1; j <= realHeatmapTOFe->GetYaxis()->GetNbins(); j++)
-         {
-            if (dmCutter.IsDeadTOFe(i - 1, j - 1))
-            {
-               realCutHeatmapTOFe->SetBinContent(i, j, 0.);
-               simCutHeatmapTOFe->SetBinContent(i, j, 0.);
-
-               simMCCutHeatmapTOFe->SetBinContent(i, j, 0.);
+      dmCutter.Mask(realCutHeatmapTOFe, DeadMapCutter::DEAD_TOFE);
+      dmCutter.Mask(simCutHeatmapTOFe, DeadMapCutter::DEAD_TOFE);
+      dmCutter.Mask(simMCCutHeatmapTOFe, DeadMapCutter::DEAD_TOFE);
+      dmCutter.Mask(realCutHeatmapTOFeSys, DeadMapCutter::DEAD_TOFE);
+      dmCutter.Mask(simCutHeatmapTOFeSys, DeadMapCutter::DEAD_TOFE);
+      dmCutter.Mask(realMCCutHeatmapTOFeSys, DeadMapCutter::DEAD_TOFE);
+      dmCutter.Mask(simMCCutHeatmapTOFeSys, DeadMapCutter::DEAD_TOFE);
 
-               realCutHeatmapTOFeSys->SetBinContent(i, j, 0.);
-               simCutHeatmapTOFeSys->SetBinContent(i, j, 0.);
-
-               realMCCutHeatmapTOFeSys->SetBinContent(i, j, 0.);
-               simMCCutHeatmapTOFeSys->SetBinContent(i, j, 0.);
-            }
-            if (dmCutterMC.IsDeadTOFe(i - 1, j - 1))
-            {
-               simMCCutHeatmapTOFe->SetBinContent(i, j, 0.);
-
-               realMCCutHeatmapTOFeSys->SetBinContent(i, j, 0.);
-               simMCCutHeatmapTOFeSys->SetBinContent(i, j, 0.);
-            }
-         }
-      }
+      dmCutterMC.Mask(simMCCutHeatmapTOFe, DeadMapCutter::DEAD_TOFE);
+      // live fraction of data after the additional cuts on MC
+      const double liveFractionTOFe = 
+         dmCutterMC.Mask(realMCCutHeatmapTOFeSys, DeadMapCutter::DEAD_TOFE);
+      dmCutterMC.Mask(simMCCutHeatmapTOFeSys, DeadMapCutter::DEAD_TOFE);
 
       DrawDeadmap(realHeatmapTOFe, realCutHeatmapTOFe,
                   "TOFe", "TOFe", "#it{Y}_{slat}", "#it{Z}_{slat}");
@@ -910,34 +752,17 @@ int main(int argc, char **argv)
                         realMCCutHeatmapTOFeSys, simMCCutHeatmapTOFeSys, 5,
                         "TOFe_MC", "TOFe", "#it{Y}_{slat}", "#it{Z}_{slat}") << " ";
 
-      reweightTOFe = 
-         realCutHeatmapTOFeSys->Integral(1, realHeatmapTOFe->GetXaxis()->GetNbins(),
-                                         1, realHeatmapTOFe->GetYaxis()->GetNbins())/
-         realMCCutHeatmapTOFeSys->Integral(1, realHeatmapTOFe->GetXaxis()->GetNbins(),
-                                           1, realHeatmapTOFe->GetYaxis()->GetNbins());
+      reweightTOFe = 1./liveFractionTOFe;
 
-      for (int i = 1; i <= realHeatmapTOFe->GetXaxis()->GetNbins(); i++)
-      {
-         for (int j = 1; j <= realHeatmapTOFe->GetYaxis()->GetNbins(); j++)
-         {
-            if (dmCutter.IsDeadTimingTOFe(i - 1, j - 1))
-            {
-               realCutHeatmapTOFe->SetBinContent(i, j, 0.);
-               simCutHeatmapTOFe->SetBinContent(i, j, 0.);
-
-               realCutHeatmapTOFeSys->SetBinContent(i, j, 0.);
-               simCutHeatmapTOFeSys->SetBinContent(i, j, 0.);
+      dmCutter.Mask(realCutHeatmapTOFe, DeadMapCutter::DEAD_TIMING_TOFE);
+      dmCutter.Mask(simCutHeatmapTOFe, DeadMapCutter::DEAD_TIMING_TOFE);
+      dmCutter.Mask(realCutHeatmapTOFeSys, DeadMapCutter::DEAD_TIMING_TOFE);
+      dmCutter.Mask(simCutHeatmapTOFeSys, DeadMapCutter::DEAD_TIMING_TOFE);
+      dmCutter.Mask(realMCCutHeatmapTOFeSys, DeadMapCutter::DEAD_TIMING_TOFE);
+      dmCutter.Mask(simMCCutHeatmapTOFeSys, DeadMapCutter::DEAD_TIMING_TOFE);
 
-               realMCCutHeatmapTOFeSys->SetBinContent(i, j, 0.);
-               simMCCutHeatmapTOFeSys->SetBinContent(i, j, 0.);
-            }
-            if (dmCutterMC.IsDeadTimingTOFe(i - 1, j - 1))
-            {
-               realMCCutHeatmapTOFeSys->SetBinContent(i, j, 0.);
-               simMCCutHeatmapTOFeSys->SetBinContent(i, j, 0.);
-            }
-         }
-      }
+      dmCutterMC.Mask(realMCCutHeatmapTOFeSys, DeadMapCutter::DEAD_TIMING_TOFE);
+      dmCutterMC.Mask(simMCCutHeatmapTOFeSys, DeadMapCutter::DEAD_TIMING_TOFE);
 
       DrawDeadmap(realCutHeatmapTOFe, realCutHeatmapTOFe,
                   "TimingTOFe", "TOFe", "#it{Y}_{slat}", "#it{Z}_{slat}");
@@ -977,25 +802,15 @@ int main(int argc, char **argv)
       TH2F *realMCCutHeatmapTOFw = static_cast<TH2F *>(realHeatmapTOFw->Clone());
       TH2F *simMCCutHeatmapTOFw = static_cast<TH2F *>(simHeatmapTOFw->Clone());
 
-      for (int i = 1; i <= realHeatmapTOFw->GetXaxis()->GetNbins(); i++)
-      {
-         for (int j = 1; j <= realHeatmapTOFw->GetYaxis()->GetNbins(); j++)
-         {
-            if (dmCutter.IsDeadTOFw(i - 1, j - 1))
-            {
-               realCutHeatmapTOFw->SetBinContent(i, j, 0.);
-               simCutHeatmapTOFw->SetBinContent(i, j, 0.);
+      dmCutter.Mask(realCutHeatmapTOFw, DeadMapCutter::DEAD_TOFW);
+      dmCutter.Mask(simCutHeatmapTOFw, DeadMapCutter::DEAD_TOFW);
+      dmCutter.Mask(realMCCutHeatmapTOFw, DeadMapCutter::DEAD_TOFW);
+      dmCutter.Mask(simMCCutHeatmapTOFw, DeadMapCutter::DEAD_TOFW);
 
-               realMCCutHeatmapTOFw->SetBinContent(i, j, 0.);
-               simMCCutHeatmapTOFw->SetBinContent(i, j, 0.);
-            }
-            if (dmCutterMC.IsDeadTOFw(i - 1, j - 1))
-            {
-               realMCCutHeatmapTOFw->SetBinContent(i, j, 0.);
-               simMCCutHeatmapTOFw->SetBinContent(i, j, 0.);
-            }
-         }
-      }
+      // live fraction of data after the additional cuts on MC
+      const double liveFractionTOFw = 
+         dmCutterMC.Mask(realMCCutHeatmapTOFw, DeadMapCutter::DEAD_TOFW);
+      dmCutterMC.Mask(simMCCutHeatmapTOFw, DeadMapCutter::DEAD_TOFW);
 
       DrawDeadmap(realHeatmapTOFw, realCutHeatmapTOFw, 
                   "TOFw", "TOFw", "#it{Y}_{strip}", "#it{Z}_{strip}");
@@ -1010,31 +825,15 @@ int main(int argc, char **argv)
                         realMCCutHeatmapTOFw, simMCCutHeatmapTOFw, 4,
                         "TOFw_MC", "TOFw", "#it{Y}_{strip}", "#it{Z}_{strip}") << " ";
 
-      reweightTOFw = 
-         realCutHeatmapTOFw->Integral(1, realHeatmapTOFw->GetXaxis()->GetNbins(),
-                                      1, realHeatmapTOFw->GetYaxis()->GetNbins())/
-         realMCCutHeatmapTOFw->Integral(1, realHeatmapTOFw->GetXaxis()->GetNbins(),
-                                        1, realHeatmapTOFw->GetYaxis()->GetNbins());
+      reweightTOFw = 1./liveFractionTOFw;
 
-      for (int i = 1; i <= realHeatmapTOFw->GetXaxis()->GetNbins(); i++)
-      {
-         for (int j = 1; j <= realHeatmapTOFw->GetYaxis()->GetNbins(); j++)
-         {
-            if (dmCutter.IsDeadTimingTOFw(i - 1, j - 1))
-            {
-               realCutHeatmapTOFw->SetBinContent(i, j, 0.);
-               simCutHeatmapTOFw->SetBinContent(i, j, 0.);
+      dmCutter.Mask(realCutHeatmapTOFw, DeadMapCutter::DEAD_TIMING_TOFW);
+      dmCutter.Mask(simCutHeatmapTOFw, DeadMapCutter::DEAD_TIMING_TOFW);
+      dmCutter.Mask(realMCCutHeatmapTOFw, DeadMapCutter::DEAD_TIMING_TOFW);
+      dmCutter.Mask(simMCCutHeatmapTOFw, DeadMapCutter::DEAD_TIMING_TOFW);
 
-               realMCCutHeatmapTOFw->SetBinContent(i, j, 0.);
-               simMCCutHeatmapTOFw->SetBinContent(i, j, 0.);
-            }
-            if (dmCutterMC.IsDeadTimingTOFw(i - 1, j - 1))
-            {
-               realMCCutHeatmapTOFw->SetBinContent(i, j, 0.);
-               simMCCutHeatmapTOFw->SetBinContent(i, j, 0.);
-            }
-         }
-      }
+      dmCutterMC.Mask(realMCCutHeatmapTOFw, DeadMapCutter::DEAD_TIMING_TOFW);
+      dmCutterMC.Mask(simMCCutHeatmapTOFw, DeadMapCutter::DEAD_TIMING_TOFW);
 
       DrawDeadmap(realHeatmapTOFw, realCutHeatmapTOFw, 
                   "TimingTOFw", "TOFw", "#it{Y}_{strip}", "#it{Z}_{strip}");
@@ -1088,31 +887,19 @@ int main(int argc, char **argv)
          TH2F *realMCCutHeatmapEMCaleSys = static_cast<TH2F *>(realHeatmapEMCaleSys->Clone());
          TH2F *simMCCutHeatmapEMCaleSys = static_cast<TH2F *>(simHeatmapEMCaleSys->Clone());
 
-         for (int j = 1; j <= realHeatmapEMCale->GetXaxis()->GetNbins(); j++)
-         {
-            for (int k = 1; k <= realHeatmapEMCale->GetYaxis()->GetNbins(); k++)
-            {
-               if (dmCutter.IsDeadEMCal(0, i, j - 1, k - 1))
-               {
-                  realCutHeatmapEMCale->SetBinContent(j, k, 0.);
-                  simCutHeatmapEMCale->SetBinContent(j, k, 0.);
-                  simMCCutHeatmapEMCale->SetBinContent(j, k, 0.);
-
-                  realCutHeatmapEMCaleSys->SetBinContent(j, k, 0.);
-                  simCutHeatmapEMCaleSys->SetBinContent(j, k, 0.);
-
-                  realMCCutHeatmapEMCaleSys->SetBinContent(j, k, 0.);
-                  simMCCutHeatmapEMCaleSys->SetBinContent(j, k, 0.);
-               }
-               if (dmCutterMC.IsDeadEMCal(0, i, j - 1, k - 1))
-               {
-                  simMCCutHeatmapEMCale->SetBinContent(j, k, 0.);
-
-                  realMCCutHeatmapEMCaleSys->SetBinContent(j, k, 0.);
-                  simMCCutHeatmapEMCaleSys->SetBinContent(j, k, 0.);
-               }
-            }
-         }
+         dmCutter.Mask(realCutHeatmapEMCale, DeadMapCutter::DEAD_EMCAL, 0, i);
+         dmCutter.Mask(simCutHeatmapEMCale, DeadMapCutter::DEAD_EMCAL, 0, i);
+         dmCutter.Mask(simMCCutHeatmapEMCale, DeadMapCutter::DEAD_EMCAL, 0, i);
+         dmCutter.Mask(realCutHeatmapEMCaleSys, DeadMapCutter::DEAD_EMCAL, 0, i);
+         dmCutter.Mask(simCutHeatmapEMCaleSys, DeadMapCutter::DEAD_EMCAL, 0, i);
+         dmCutter.Mask(realMCCutHeatmapEMCaleSys, DeadMapCutter::DEAD_EMCAL, 0, i);
+         dmCutter.Mask(simMCCutHeatmapEMCaleSys, DeadMapCutter::DEAD_EMCAL, 0, i);
+
+         dmCutterMC.Mask(simMCCutHeatmapEMCale, DeadMapCutter::DEAD_EMCAL, 0, i);
+         // live fraction of data after the additional cuts on MC
+         const double liveFractionEMCale = 
+            dmCutterMC.Mask(realMCCutHeatmapEMCaleSys, DeadMapCutter::DEAD_EMCAL, 0, i);
+         dmCutterMC.Mask(simMCCutHeatmapEMCaleSys, DeadMapCutter::DEAD_EMCAL, 0, i);
 
          DrawDeadmap(realHeatmapEMCale, realCutHeatmapEMCale,
                      "EMCale" + std::to_string(i), "EMCale" + std::to_string(i), 
@@ -1135,11 +922,7 @@ int main(int argc, char **argv)
 
          if (i < 3) systematicsOutputFile << " ";
 
-         reweightEMCale[i] = 
-            realCutHeatmapEMCaleSys->Integral(1, realHeatmapEMCale->GetXaxis()->GetNbins(),
-                                              1, realHeatmapEMCale->GetYaxis()->GetNbins())/
-            realMCCutHeatmapEMCaleSys->Integral(1, realHeatmapEMCale->GetXaxis()->GetNbins(),
-                                                1, realHeatmapEMCale->GetYaxis()->GetNbins());
+         reweightEMCale[i] = 1./liveFractionEMCale;
       }
       systematicsOutputFile << std::endl;
 
@@ -1171,31 +954,19 @@ int main(int argc, char **argv)
          TH2F *realMCCutHeatmapEMCalwSys = static_cast<TH2F *>(realHeatmapEMCalwSys->Clone());
          TH2F *simMCCutHeatmapEMCalwSys = static_cast<TH2F *>(simHeatmapEMCalwSys->Clone());
 
-         for (int j = 1; j <= realHeatmapEMCalw->GetXaxis()->GetNbins(); j++)
-         {
-            for (int k = 1; k <= realHeatmapEMCalw->GetYaxis()->GetNbins(); k++)
-            {
-               if (dmCutter.IsDeadEMCal(1, i, j - 1, k - 1))
-               {
-                  realCutHeatmapEMCalw->SetBinContent(j, k, 0.);
-                  simCutHeatmapEMCalw->SetBinContent(j, k, 0.);
-                  simMCCutHeatmapEMCalw->SetBinContent(j, k, 0.);
-
-                  realCutHeatmapEMCalwSys->SetBinContent(j, k, 0.);
-                  simCutHeatmapEMCalwSys->SetBinContent(j, k, 0.);
-
-                  realMCCutHeatmapEMCalwSys->SetBinContent(j, k, 0.);
-                  simMCCutHeatmapEMCalwSys->SetBinContent(j, k, 0.);
-               }
-               if (dmCutterMC.IsDeadEMCal(1, i, j - 1, k - 1))
-               {
-                  simMCCutHeatmapEMCalw->SetBinContent(j, k, 0.);
-
-                  realMCCutHeatmapEMCalwSys->SetBinContent(j, k, 0.);
-                  simMCCutHeatmapEMCalwSys->SetBinContent(j, k, 0.);
-               }
-            }
-         }
+         dmCutter.Mask(realCutHeatmapEMCalw, DeadMapCutter::DEAD_EMCAL, 1, i);
+         dmCutter.Mask(simCutHeatmapEMCalw, DeadMapCutter::DEAD_EMCAL, 1, i);
+         dmCutter.Mask(simMCCutHeatmapEMCalw, DeadMapCutter::DEAD_EMCAL, 1, i);
+         dmCutter.Mask(realCutHeatmapEMCalwSys, DeadMapCutter::DEAD_EMCAL, 1, i);
+         dmCutter.Mask(simCutHeatmapEMCalwSys, DeadMapCutter::DEAD_EMCAL, 1, i);
+         dmCutter.Mask(realMCCutHeatmapEMCalwSys, DeadMapCutter::DEAD_EMCAL, 1, i);
+         dmCutter.Mask(simMCCutHeatmapEMCalwSys, DeadMapCutter::DEAD_EMCAL, 1, i);
+
+         dmCutterMC.Mask(simMCCutHeatmapEMCalw, DeadMapCutter::DEAD_EMCAL, 1, i);
+         // live fraction of data after the additional cuts on MC
+         const double liveFractionEMCalw = 
+            dmCutterMC.Mask(realMCCutHeatmapEMCalwSys, DeadMapCutter::DEAD_EMCAL, 1, i);
+         dmCutterMC.Mask(simMCCutHeatmapEMCalwSys, DeadMapCutter::DEAD_EMCAL, 1, i);
 
          DrawDeadmap(realHeatmapEMCalw, realCutHeatmapEMCalw,
                      "EMCalw" + std::to_string(i), "EMCalw" + std::to_string(i), 
@@ -1217,11 +988,7 @@ int main(int argc, char **argv)
                            "#it{Y}_{tower}", "#it{Z}_{tower}");
          if (i < 3) systematicsOutputFile << " ";
 
-         reweightEMCalw[i] = 
-            realCutHeatmapEMCalwSys->Integral(1, realHeatmapEMCalw->GetXaxis()->GetNbins(),
-                                              1, realHeatmapEMCalw->GetYaxis()->GetNbins())/
-            realMCCutHeatmapEMCalwSys->Integral(1, realHeatmapEMCalw->GetXaxis()->GetNbins(),
-                                                1, realHeatmapEMCalw->GetYaxis()->GetNbins());
+         reweightEMCalw[i] = 1./liveFractionEMCalw;
       }
       systematicsOutputFile << std::endl;
    }
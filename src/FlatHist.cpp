@@ -0,0 +1,175 @@
+/**
+ *  @file   FlatHist.cpp
+ *  @brief  Contains realisations of classes FlatHistAxis, HistRegistry, FlatHistBase, MergedHists, and FlatHistTable
+ *
+ *  This file is a part of a project PairAnalysisPhenix (https://github.com/Sergeyir/PairAnalysisPhenix).
+ *
+ *  @author Sergei Antsupov (antsupov0124@gmail.com)
+ **/
+#ifndef FLAT_HIST_CPP
+#define FLAT_HIST_CPP
+
+#include "../include/FlatHist.hpp"
+
+FlatHistAxis::FlatHistAxis(const int nBins, const double min, const double max) :
+   nBins(nBins), min(min), max(max) {}
+
+int FlatHistAxis::GetNBins() const {return nBins;}
+double FlatHistAxis::GetMin() const {return min;}
+double FlatHistAxis::GetMax() const {return max;}
+
+HistRegistry::HistRegistry(const std::string& detectorsConfiguration) :
+   detectorsConfiguration(detectorsConfiguration)
+{
+   if (detectorsConfiguration.size() != ANY)
+   {
+      CppTools::PrintError("HistRegistry: Detector configuration size is " +
+                           std::to_string(detectorsConfiguration.size()) +
+                           " while " + std::to_string(ANY) + " has been expected");
+   }
+}
+
+bool HistRegistry::IsEnabled(const int detector) const
+{
+   return (detector == ANY || detectorsConfiguration[detector] == '1');
+}
+
+void HistRegistry::Add(FlatHistBase *hist)
+{
+   hists.push_back(hist);
+}
+
+unsigned long HistRegistry::GetSize() const
+{
+   return hists.size();
+}
+
+const FlatHistBase& HistRegistry::Get(const unsigned long i) const
+{
+   return *hists[i];
+}
+
+FlatHistBase::FlatHistBase(HistRegistry& registry, const int detector,
+                           const std::string& directory, const std::string& name,
+                           const std::string& title) :
+   name(name), title(title), isEnabled(registry.IsEnabled(detector)), directory(directory)
+{
+   registry.Add(this);
+}
+
+bool FlatHistBase::IsEnabled() const {return isEnabled;}
+const std::string& FlatHistBase::GetDirectory() const {return directory;}
+
+MergedHists::MergedHists(const unsigned long size) : hists(size), directories(size) {}
+
+void MergedHists::Set(const unsigned long i, std::unique_ptr<TH1> hist, 
+                      const std::string& directory)
+{
+   hists[i] = std::move(hist);
+   directories[i] = directory;
+}
+
+void MergedHists::Add(const MergedHists& other, const unsigned int numberOfThreads)
+{
+   if (hists.empty())
+   {
+      hists.resize(other.hists.size());
+      directories = other.directories;
+
+      ParallelFor(hists.size(), numberOfThreads, [&](const unsigned long i)
+      {
+         hists[i].reset(static_cast<TH1 *>(other.hists[i]->Clone()));
+         hists[i]->SetDirectory(nullptr);
+      });
+      return;
+   }
+
+   if (hists.size() != other.hists.size())
+   {
+      CppTools::PrintError("MergedHists: histograms with different number of "\
+                           "histograms cannot be added");
+   }
+
+   ParallelFor(hists.size(), numberOfThreads, [&](const unsigned long i)
+   {
+      hists[i]->Add(other.hists[i].get());
+   });
+}
+
+void MergedHists::Write(const std::string& outputFileName, const int compressionLevel) const
+{
+   TFile outputFile(outputFileName.c_str(), "RECREATE");
+   outputFile.SetCompressionLevel(compressionLevel);
+   Write(outputFile);
+   outputFile.Close();
+}
+
+void MergedHists::Write(TDirectory& outputDirectory) const
+{
+   for (unsigned long i = 0; i < hists.size(); i++)
+   {
+      TDirectory *directory = &outputDirectory;
+      if (directories[i] != "")
+      {
+         directory = outputDirectory.GetDirectory(directories[i].c_str());
+         if (!directory) directory = outputDirectory.mkdir(directories[i].c_str());
+      }
+      directory->cd();
+      hists[i]->Write();
+   }
+}
+
+void MergedHists::ParallelFor(const unsigned long n, const unsigned int numberOfThreads,
+                              const std::function<void(const unsigned long)>& func)
+{
+   // next index to be processed; threads take indexes one by one since
+   // the time needed for different histograms differs by orders of magnitude
+   std::atomic<unsigned long> next{0};
+
+   auto call = [&]()
+   {
+      for (unsigned long i = next++; i < n; i = next++) func(i);
+   };
+
+   std::vector<std::thread> threads;
+   for (unsigned int i = 1; i < std::min<unsigned long>(numberOfThreads, n); i++)
+   {
+      threads.emplace_back(call);
+   }
+   call();
+
+   for (std::thread& thread : threads) thread.join();
+}
+
+FlatHistTable::FlatHistTable(const TH1 *hist)
+{
+   if (hist->GetDimension() > 2)
+   {
+      CppTools::PrintError("FlatHistTable: histogram " + static_cast<std::string>(hist->GetName()) +
+                           " has more than 2 dimensions");
+   }
+   if (hist->GetXaxis()->IsVariableBinSize() || hist->GetYaxis()->IsVariableBinSize())
+   {
+      CppTools::PrintError("FlatHistTable: histogram " + static_cast<std::string>(hist->GetName()) +
+                           " has variable bins");
+   }
+
+   xAxis = FlatHistAxis(hist->GetXaxis()->GetNbins(),
+                        hist->GetXaxis()->GetXmin(), hist->GetXaxis()->GetXmax());
+   unsigned long size = static_cast<unsigned long>(xAxis.GetNBins() + 2);
+
+   if (hist->GetDimension() == 2)
+   {
+      yAxis = FlatHistAxis(hist->GetYaxis()->GetNbins(),
+                           hist->GetYaxis()->GetXmin(), hist->GetYaxis()->GetXmax());
+      size *= static_cast<unsigned long>(yAxis.GetNBins() + 2);
+   }
+
+   contents.resize(size);
+   for (unsigned long bin = 0; bin < size; bin++)
+   {
+      contents[bin] = hist->GetBinContent(static_cast<int>(bin));
+   }
+}
+
+#endif /* FLAT_HIST_CPP */
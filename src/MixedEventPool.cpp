@@ -0,0 +1,106 @@
+/**
+ *  @file   MixedEventPool.cpp
+ *  @brief  Contains realisation of structs and classes PooledEvent, EventPool, and ThrEventPools
+ *
+ *  This file is a part of a project PairAnalysisPhenix (https://github.com/Sergeyir/PairAnalysisPhenix).
+ *
+ *  @author Sergei Antsupov (antsupov0124@gmail.com)
+ **/
+#ifndef MIXED_EVENT_POOL_CPP
+#define MIXED_EVENT_POOL_CPP
+
+#include "../include/MixedEventPool.hpp"
+
+void PooledEvent::Set(const std::vector<ChargedTrack>& positiveTracks,
+                      const std::vector<ChargedTrack>& negativeTracks, const double weight)
+{
+   // assign reuses the memory of the replaced event
+   this->positiveTracks.assign(positiveTracks.begin(), positiveTracks.end());
+   this->negativeTracks.assign(negativeTracks.begin(), negativeTracks.end());
+
+   negativeTracksBlock.Clear();
+   for (const ChargedTrack& track : negativeTracks) negativeTracksBlock.Add(track);
+
+   this->weight = weight;
+}
+
+EventPool::EventPool(const unsigned long depth) : events(depth) {}
+
+unsigned long EventPool::GetSize() const
+{
+   return size;
+}
+
+const PooledEvent& EventPool::Get(const unsigned long i) const
+{
+   return events[i];
+}
+
+void EventPool::Add(const std::vector<ChargedTrack>& positiveTracks,
+                    const std::vector<ChargedTrack>& negativeTracks, const double weight)
+{
+   if (events.empty()) return;
+
+   events[next].Set(positiveTracks, negativeTracks, weight);
+
+   next = (next + 1) % events.size();
+   if (size < events.size()) size++;
+}
+
+ThrEventPools::ThrEventPools(const int numberOfCBins, const int numberOfZBins,
+                             const int numberOfRBins, const double zMin, const double zMax,
+                             const unsigned long depth, const unsigned long numberOfSets) :
+   numberOfCBins(numberOfCBins), numberOfZBins(numberOfZBins), numberOfRBins(numberOfRBins),
+   zMin(zMin), zMax(zMax), depth(depth), numberOfSets(numberOfSets)
+{
+   if (numberOfCBins <= 0 || numberOfZBins <= 0 || numberOfRBins <= 0)
+   {
+      CppTools::PrintError("ThrEventPools: number of c, z, and r bins must be positive");
+   }
+   if (zMax <= zMin)
+   {
+      CppTools::PrintError("ThrEventPools: upper edge of z range must be larger than the lower");
+   }
+}
+
+int ThrEventPools::GetNumberOfBins() const
+{
+   return numberOfCBins*numberOfZBins*numberOfRBins;
+}
+
+int ThrEventPools::GetBin(const int c, const double zVtx, const int r) const
+{
+   if (c < 0 || c >= numberOfCBins || r < 0 || r >= numberOfRBins) return -1;
+   if (zVtx < zMin || !(zVtx < zMax)) return -1;
+
+   const int z = static_cast<int>(numberOfZBins*(zVtx - zMin)/(zMax - zMin));
+
+   return (c*numberOfZBins + z)*numberOfRBins + r;
+}
+
+std::string ThrEventPools::GetBinName(const int bin) const
+{
+   const int c = bin/(numberOfZBins*numberOfRBins);
+   const int z = (bin/numberOfRBins) % numberOfZBins;
+   const int r = bin % numberOfRBins;
+
+   const std::string cName = (c > 9) ? std::to_string(c) : "0" + std::to_string(c);
+   const std::string zName = (z > 9) ? std::to_string(z) : "0" + std::to_string(z);
+   const std::string rName = (r > 9) ? std::to_string(r) : "0" + std::to_string(r);
+
+   return "c" + cName + "_z" + zName + "_r" + rName;
+}
+
+std::vector<EventPool>& ThrEventPools::Get()
+{
+   std::lock_guard<std::mutex> lock(poolsMutex);
+   std::unique_ptr<std::vector<EventPool>>& threadPools = pools[std::this_thread::get_id()];
+   if (!threadPools)
+   {
+      threadPools = std::make_unique<std::vector<EventPool>>
+         (numberOfSets*static_cast<unsigned long>(GetNumberOfBins()), EventPool(depth));
+   }
+   return *threadPools;
+}
+
+#endif /* MIXED_EVENT_POOL_CPP */
@@ -141,6 +141,107 @@ double GetPairMass(const ChargedTrack& track1, const ChargedTrack& track2)
                (track1.pZ + track2.pZ)*(track1.pZ + track2.pZ));
 }
 
+void TrackBlock::Clear()
+{
+   pX.clear();
+   pY.clear();
+   pZ.clear();
+   e.clear();
+   pT.clear();
+   mMin = std::numeric_limits<double>::max();
+}
+
+void TrackBlock::Add(const ChargedTrack& track)
+{
+   Add(track, track.m);
+   e.back() = track.e;
+}
+
+void TrackBlock::Add(const ChargedTrack& track, const double m)
+{
+   pX.push_back(track.pX);
+   pY.push_back(track.pY);
+   pZ.push_back(track.pZ);
+   e.push_back(sqrt(track.p*track.p + m*m));
+   pT.push_back(sqrt(track.pX*track.pX + track.pY*track.pY));
+   mMin = std::min(mMin, m);
+}
+
+void GetPairsMassPT(const ChargedTrack& track, const TrackBlock& block, 
+                    double *mInv, double *pT)
+{
+   GetPairsMassPT(track, block, 0, block.GetSize(), mInv, pT);
+}
+
+void GetPairsMassPT(const ChargedTrack& track, const TrackBlock& block, 
+                    const unsigned long first, const unsigned long last, 
+                    double *mInv, double *pT)
+{
+   const double *pX = block.pX.data();
+   const double *pY = block.pY.data();
+   const double *pZ = block.pZ.data();
+   const double *e = block.e.data();
+
+   #pragma omp simd
+   for (unsigned long i = first; i < last; i++)
+   {
+      const double pairPX = track.pX + pX[i];
+      const double pairPY = track.pY + pY[i];
+      const double pairPZ = track.pZ + pZ[i];
+      const double pairE = track.e + e[i];
+
+      pT[i] = sqrt(pairPX*pairPX + pairPY*pairPY);
+      mInv[i] = sqrt(pairE*pairE - pairPX*pairPX - pairPY*pairPY - pairPZ*pairPZ);
+   }
+}
+
+std::pair<unsigned long, unsigned long> GetPartnersRange(const ChargedTrack& track, 
+                                                         const TrackBlock& block, 
+                                                         const double mInvMax, 
+                                                         const double pTMax)
+{
+   const double m1 = track.m;
+   const double m2 = block.mMin;
+
+   if (block.GetSize() == 0) return {0, 0};
+   // bounds are only derived for massive particles
+   if (m1 <= 0. || m2 <= 0.) return {0, block.GetSize()};
+
+   const double pT1 = sqrt(track.pX*track.pX + track.pY*track.pY);
+
+   double pT2Min = pT1 - pTMax;
+   double pT2Max = pT1 + pTMax;
+
+   if (std::isfinite(mInvMax))
+   {
+      const double mT1 = sqrt(pT1*pT1 + m1*m1);
+
+      // M_inv < mInvMax requires mT1*mT2 - pT1*pT2 < k which is satisfied between 
+      // the roots of m1^2*pT2^2 - 2*k*pT1*pT2 + mT1^2*m2^2 - k^2 = 0
+      const double k = (mInvMax*mInvMax - m1*m1 - m2*m2)/2.;
+      // the smallest invariant mass of a pair is m1 + m2
+      if (k <= m1*m2) return {0, 0};
+
+      const double sqrtD = mT1*sqrt(k*k - m1*m1*m2*m2);
+
+      pT2Min = std::max((k*pT1 - sqrtD)/(m1*m1), pT2Min);
+      pT2Max = std::min((k*pT1 + sqrtD)/(m1*m1), pT2Max);
+   }
+
+   // the range is widened to account for rounding
+   pT2Min -= 1e-9*(1. + fabs(pT2Min));
+   pT2Max += 1e-9*(1. + fabs(pT2Max));
+
+   if (pT2Min > pT2Max) return {0, 0};
+
+   const unsigned long first = 
+      std::lower_bound(block.pT.begin(), block.pT.end(), pT2Min) - block.pT.begin();
+   const unsigned long last = 
+      std::upper_bound(block.pT.begin() + first, block.pT.end(), pT2Max) - block.pT.begin();
+
+   return {first, last};
+}
+
 bool IsOneArmCut(const ChargedTrack& track1, const ChargedTrack& track2)
 {
    return ((track1.phi > M_PI/2. && track2.phi < M_PI/2.) ||
@@ -149,12 +250,16 @@ bool IsOneArmCut(const ChargedTrack& track1, const ChargedTrack& track2)
 
 bool IsPC2Ghost(const ChargedTrack& track1, const ChargedTrack& track2)
 {
-   return (fabs(track1.pc2phi - track2.pc2phi) < 0.02 && fabs(track1.pc2z - track2.pc2z) < 4.);
+   // z is checked first so that phi is evaluated only for the tracks with close hits
+   return (fabs(static_cast<double>(track1.pc2z) - track2.pc2z) < 4. && 
+           fabs(track1.GetPC2Phi() - track2.GetPC2Phi()) < 0.02);
 }
 
 bool IsPC3Ghost(const ChargedTrack& track1, const ChargedTrack& track2)
 {
-   return (fabs(track1.pc3phi - track2.pc3phi) < 0.02 && fabs(track1.pc3z - track2.pc3z) < 4.);
+   // z is checked first so that phi is evaluated only for the tracks with close hits
+   return (fabs(static_cast<double>(track1.pc3z) - track2.pc3z) < 4. && 
+           fabs(track1.GetPC3Phi() - track2.GetPC3Phi()) < 0.02);
 }
 
 bool IsEMCalGhost(const ChargedTrack& track1, const ChargedTrack& track2)
@@ -175,9 +280,9 @@ bool IsTOFwGhost(const ChargedTrack& track1, const ChargedTrack& track2)
 
 bool IsGhostCut(const ChargedTrack& track1, const ChargedTrack& track2)
 {
-   const double dPhi = track1.phi - track2.phi;
-   const double dAlpha = track1.alpha - track2.alpha;
-   const double dZed = track1.zed - track2.zed;
+   const double dPhi = static_cast<double>(track1.phi) - track2.phi;
+   const double dAlpha = static_cast<double>(track1.alpha) - track2.alpha;
+   const double dZed = static_cast<double>(track1.zed) - track2.zed;
 
    return ((fabs(dZed) < 6.0 && fabs(dPhi - (0.13*dAlpha)) < 0.015) ||
            fabs(dPhi - (0.04*dAlpha)) < 0.015 ||
@@ -194,4 +299,15 @@ bool IsCowboyCut(const ChargedTrack& track1, const ChargedTrack& track2)
    return !IsSailorCut(track1, track2);
 }
 
+unsigned int GetGhostMask(const ChargedTrack& track1, const ChargedTrack& track2)
+{
+   unsigned int ghostMask = 0;
+   if (IsPC2Ghost(track1, track2)) ghostMask |= DETECTOR_BIT::PC2;
+   if (IsPC3Ghost(track1, track2)) ghostMask |= DETECTOR_BIT::PC3;
+   if (IsEMCalGhost(track1, track2)) ghostMask |= DETECTOR_BIT::EMCAL;
+   if (IsTOFeGhost(track1, track2)) ghostMask |= DETECTOR_BIT::TOFE;
+   if (IsTOFwGhost(track1, track2)) ghostMask |= DETECTOR_BIT::TOFW;
+   return ghostMask;
+}
+
 #endif /* PAIR_TRACK_FUNC_CPP */
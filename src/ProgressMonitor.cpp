@@ -0,0 +1,96 @@
+/**
+ *  @file   ProgressMonitor.cpp
+ *  @brief  Contains realisation of class ProgressMonitor
+ *
+ *  This file is a part of a project PairAnalysisPhenix (https://github.com/Sergeyir/PairAnalysisPhenix).
+ *
+ *  @author Sergei Antsupov (antsupov0124@gmail.com)
+ **/
+#ifndef PROGRESS_MONITOR_CPP
+#define PROGRESS_MONITOR_CPP
+
+#include "../include/ProgressMonitor.hpp"
+
+// ids start from 1 since 0 marks the thread local cache of shards as empty
+static std::atomic<unsigned long> progressMonitorNextId{1};
+
+ProgressMonitor::ProgressMonitor() : id(progressMonitorNextId++)
+{
+   stageStartTime = std::chrono::steady_clock::now();
+}
+
+ProgressMonitor::Shard& ProgressMonitor::AddShard()
+{
+   std::lock_guard<std::mutex> lock(shardsMutex);
+   std::unique_ptr<Shard>& shard = shards[std::this_thread::get_id()];
+   if (!shard) shard = std::make_unique<Shard>();
+   return *shard;
+}
+
+unsigned long ProgressMonitor::Get(const Counter counter)
+{
+   std::lock_guard<std::mutex> lock(shardsMutex);
+   unsigned long sum = 0;
+   for (const auto& shard : shards)
+   {
+      sum += shard.second->counters[counter].load(std::memory_order_relaxed);
+   }
+   return sum;
+}
+
+unsigned long ProgressMonitor::GetBytes()
+{
+   return Get(BYTES) + static_cast<unsigned long>(TFile::GetFileBytesRead());
+}
+
+void ProgressMonitor::StartStage(const std::string& name, const unsigned long numberOfEvents)
+{
+   const unsigned long events = Get(EVENTS);
+   const unsigned long tracks = Get(TRACKS);
+   const unsigned long bytes = GetBytes();
+
+   std::lock_guard<std::mutex> lock(shardsMutex);
+   stageName = name;
+   stageNumberOfEvents = numberOfEvents;
+   stageStartCounters = {events, tracks, bytes};
+   stageStartTime = std::chrono::steady_clock::now();
+}
+
+double ProgressMonitor::GetProgress(const unsigned long numberOfEvents)
+{
+   if (numberOfEvents == 0) return 1.;
+   return static_cast<double>(Get(EVENTS))/static_cast<double>(numberOfEvents);
+}
+
+std::string ProgressMonitor::GetStatus()
+{
+   const unsigned long events = Get(EVENTS);
+   const unsigned long tracks = Get(TRACKS);
+   const unsigned long bytes = GetBytes();
+
+   std::lock_guard<std::mutex> lock(shardsMutex);
+
+   const double time = std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                                     stageStartTime).count();
+   const double stageEvents = static_cast<double>(events - stageStartCounters[EVENTS]);
+   const double eventsRate = (time > 0. ? stageEvents/time : 0.);
+   const double tracksRate =
+      (time > 0. ? static_cast<double>(tracks - stageStartCounters[TRACKS])/time : 0.);
+   const double bytesRate =
+      (time > 0. ? static_cast<double>(bytes - stageStartCounters[BYTES])/time : 0.);
+
+   std::string status = stageName + ": " + CppTools::DtoStr(eventsRate/1e3, 1) + "k events/s, " +
+                        CppTools::DtoStr(tracksRate/1e3, 1) + "k tracks/s, " +
+                        CppTools::DtoStr(bytesRate/1048576., 1) + " MB/s, ETA ";
+
+   const double remainingEvents = static_cast<double>(stageNumberOfEvents) - stageEvents;
+   if (eventsRate <= 0.) return status + "unknown";
+   if (remainingEvents <= 0.) return status + "0s";
+
+   const unsigned long eta = static_cast<unsigned long>(remainingEvents/eventsRate);
+   if (eta >= 3600) status += std::to_string(eta/3600) + "h";
+   if (eta >= 60) status += std::to_string((eta % 3600)/60) + "m";
+   return status + std::to_string(eta % 60) + "s";
+}
+
+#endif /* PROGRESS_MONITOR_CPP */
@@ -0,0 +1,282 @@
+/**
+ *  @file   SimTrackCache.cpp
+ *  @brief  Contains realisations of classes SimTrackCacheWriter and SimTrackCacheReader that can be used to store derived quantities of simulated charged tracks and to replay them without reading the simulated trees
+ *
+ *  This file is a part of a project PairAnalysisPhenix (https://github.com/Sergeyir/PairAnalysisPhenix).
+ *
+ *  @author Sergei Antsupov (antsupov0124@gmail.com)
+ **/
+#ifndef SIM_TRACK_CACHE_CPP
+#define SIM_TRACK_CACHE_CPP
+
+#include "../include/SimTrackCache.hpp"
+
+// header of the cache file
+struct SimTrackCacheHeader
+{
+   // identifier of the cache file
+   char magic[8];
+   // version of the format; must be incremented when SimTrack changes
+   unsigned int version;
+   // size of SimTrack record in bytes
+   unsigned int trackSize;
+   // number of events in the file
+   unsigned long numberOfEvents;
+   // size of the file with the simulated tree in bytes
+   unsigned long sourceSize;
+   // last write time of the file with the simulated tree
+   long sourceTime;
+   // hash of the dead maps, calibrations, and parameters used to evaluate derived quantities
+   unsigned long inputsHash;
+};
+
+// record that precedes the tracks of each event
+struct SimTrackCacheEvent
+{
+   // original pT of the simulated particle
+   double origPT;
+   // number of SimTrack records that follow
+   unsigned long numberOfTracks;
+};
+
+static const char simTrackCacheMagic[8] = "SIMTRKC";
+static const unsigned int simTrackCacheVersion = 2;
+
+// FNV-1a hash of the data that continues from the given hash
+static unsigned long UpdateSimTrackCacheHash(unsigned long hash, const void *data, 
+                                             const size_t size)
+{
+   const unsigned char *bytes = static_cast<const unsigned char *>(data);
+   for (size_t i = 0; i < size; i++)
+   {
+      hash ^= bytes[i];
+      hash *= 1099511628211UL;
+   }
+   return hash;
+}
+
+// last write time of the file in the units of the file clock
+static long GetSimTrackCacheSourceTime(const std::string& sourceFileName)
+{
+   return static_cast<long>(std::filesystem::last_write_time(sourceFileName).
+                            time_since_epoch().count());
+}
+
+// header filled with all fields except the number of events
+static SimTrackCacheHeader GetSimTrackCacheHeader(const unsigned long sourceSize,
+                                                  const long sourceTime,
+                                                  const unsigned long inputsHash)
+{
+   SimTrackCacheHeader header;
+   std::memcpy(header.magic, simTrackCacheMagic, sizeof(header.magic));
+   header.version = simTrackCacheVersion;
+   header.trackSize = sizeof(SimTrack);
+   header.numberOfEvents = 0;
+   header.sourceSize = sourceSize;
+   header.sourceTime = sourceTime;
+   header.inputsHash = inputsHash;
+   return header;
+}
+
+unsigned long GetSimTrackCacheInputsHash(const std::vector<std::string>& inputDirs,
+                                         const std::string& options,
+                                         const std::vector<double>& parameters)
+{
+   unsigned long hash = 14695981039346656037UL;
+
+   for (const std::string& inputDir : inputDirs)
+   {
+      hash = UpdateSimTrackCacheHash(hash, inputDir.data(), inputDir.size());
+      if (!std::filesystem::is_directory(inputDir)) continue;
+
+      // files are sorted since the order of the directory iteration is not defined
+      std::vector<std::filesystem::path> inputFiles;
+      for (const auto& entry : std::filesystem::directory_iterator(inputDir))
+      {
+         if (entry.is_regular_file() && entry.path().extension() == ".txt")
+         {
+            inputFiles.push_back(entry.path());
+         }
+      }
+      std::sort(inputFiles.begin(), inputFiles.end());
+
+      for (const std::filesystem::path& inputFile : inputFiles)
+      {
+         const std::string inputFileName = inputFile.filename().string();
+         hash = UpdateSimTrackCacheHash(hash, inputFileName.data(), inputFileName.size());
+
+         std::ifstream file(inputFile, std::ios::binary);
+         const std::string contents((std::istreambuf_iterator<char>(file)),
+                                    std::istreambuf_iterator<char>());
+         hash = UpdateSimTrackCacheHash(hash, contents.data(), contents.size());
+      }
+   }
+
+   hash = UpdateSimTrackCacheHash(hash, options.data(), options.size());
+   return UpdateSimTrackCacheHash(hash, parameters.data(), parameters.size()*sizeof(double));
+}
+
+SimTrackCacheWriter::SimTrackCacheWriter(const std::string& fileName, 
+                                         const std::string& sourceFileName,
+                                         const unsigned long inputsHash) : 
+   fileName(fileName), tmpFileName(fileName + "." + std::to_string(getpid()) + ".tmp"), 
+   sourceSize(static_cast<unsigned long>(std::filesystem::file_size(sourceFileName))),
+   sourceTime(GetSimTrackCacheSourceTime(sourceFileName)), inputsHash(inputsHash)
+{
+   const std::filesystem::path dir = std::filesystem::path(fileName).parent_path();
+   if (!dir.empty()) std::filesystem::create_directories(dir);
+
+   // outdated cache is removed so that it is not used if the writing is not finished
+   std::filesystem::remove(fileName);
+
+   file.open(tmpFileName, std::ios::binary | std::ios::trunc);
+   if (!file.is_open()) 
+   {
+      CppTools::PrintError("SimTrackCacheWriter: cannot open file " + tmpFileName);
+   }
+
+   // header is rewritten with the actual number of events when the writing is finished
+   const SimTrackCacheHeader header = GetSimTrackCacheHeader(sourceSize, sourceTime, inputsHash);
+   file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+}
+
+void SimTrackCacheWriter::Write(const double origPT, const std::vector<SimTrack>& tracks)
+{
+   const SimTrackCacheEvent event{origPT, tracks.size()};
+
+   std::lock_guard<std::mutex> lock(writeMutex);
+   file.write(reinterpret_cast<const char *>(&event), sizeof(event));
+   file.write(reinterpret_cast<const char *>(tracks.data()), tracks.size()*sizeof(SimTrack));
+   numberOfEvents++;
+}
+
+SimTrackCacheWriter::~SimTrackCacheWriter()
+{
+   SimTrackCacheHeader header = GetSimTrackCacheHeader(sourceSize, sourceTime, inputsHash);
+   header.numberOfEvents = numberOfEvents;
+
+   file.seekp(0);
+   file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+   file.close();
+
+   if (file.fail()) 
+   {
+      CppTools::PrintWarning("SimTrackCacheWriter: failed to write " + tmpFileName);
+      std::filesystem::remove(tmpFileName);
+      return;
+   }
+
+   // rename is atomic so the cache file is either complete or does not exist
+   if (std::rename(tmpFileName.c_str(), fileName.c_str()) != 0)
+   {
+      CppTools::PrintWarning("SimTrackCacheWriter: failed to rename " + tmpFileName + 
+                             " into " + fileName);
+      std::filesystem::remove(tmpFileName);
+   }
+}
+
+SimTrackCacheReader::SimTrackCacheReader(const std::string& fileName, 
+                                         const std::string& sourceFileName,
+                                         const unsigned long inputsHash)
+{
+   if (!IsValid(fileName, sourceFileName, inputsHash))
+   {
+      CppTools::PrintError("SimTrackCacheReader: file " + fileName + " does not exist or "\
+                           "is outdated; it was written with a different version of SimTrack, "\
+                           "file " + sourceFileName + ", dead maps, or calibrations");
+   }
+
+   const int fd = open(fileName.c_str(), O_RDONLY);
+   struct stat fileStat;
+   fstat(fd, &fileStat);
+   size = static_cast<size_t>(fileStat.st_size);
+
+   void *map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+   close(fd);
+   if (map == MAP_FAILED) CppTools::PrintError("SimTrackCacheReader: cannot map file " + fileName);
+   // events are mostly read in order by each task
+   madvise(map, size, MADV_SEQUENTIAL);
+   data = static_cast<const char *>(map);
+
+   SimTrackCacheHeader header;
+   std::memcpy(&header, data, sizeof(header));
+   eventOffsets.reserve(header.numberOfEvents);
+
+   size_t offset = sizeof(header);
+   for (unsigned long i = 0; i < header.numberOfEvents; i++)
+   {
+      SimTrackCacheEvent event;
+      if (offset + sizeof(event) > size) break;
+      std::memcpy(&event, data + offset, sizeof(event));
+
+      eventOffsets.push_back(offset);
+      offset += sizeof(event) + event.numberOfTracks*sizeof(SimTrack);
+   }
+
+   if (eventOffsets.size() != header.numberOfEvents || offset != size)
+   {
+      CppTools::PrintError("SimTrackCacheReader: file " + fileName + " is corrupted");
+   }
+}
+
+unsigned long SimTrackCacheReader::GetNumberOfEvents() const
+{
+   return eventOffsets.size();
+}
+
+double SimTrackCacheReader::GetOrigPT(const unsigned long i) const
+{
+   return reinterpret_cast<const SimTrackCacheEvent *>(data + eventOffsets[i])->origPT;
+}
+
+unsigned long SimTrackCacheReader::GetNumberOfTracks(const unsigned long i) const
+{
+   return reinterpret_cast<const SimTrackCacheEvent *>(data + eventOffsets[i])->numberOfTracks;
+}
+
+const SimTrack *SimTrackCacheReader::GetTracks(const unsigned long i) const
+{
+   return reinterpret_cast<const SimTrack *>(data + eventOffsets[i] + sizeof(SimTrackCacheEvent));
+}
+
+void SimTrackCacheReader::Process(const std::function<void(const SimTrackCacheReader&,
+                                                           const unsigned long,
+                                                           const unsigned long)>& func) const
+{
+   const unsigned long numberOfEvents = GetNumberOfEvents();
+   const unsigned int numberOfThreads =
+      (ROOT::IsImplicitMTEnabled() ? ROOT::GetThreadPoolSize() : 1);
+   // several tasks per thread are used for better load balancing
+   const unsigned long numberOfTasks =
+      std::min(4*static_cast<unsigned long>(numberOfThreads), std::max(numberOfEvents, 1UL));
+
+   ROOT::TThreadExecutor executor(numberOfThreads);
+   executor.Foreach([&](const unsigned long task)
+   {
+      func(*this, numberOfEvents*task/numberOfTasks, numberOfEvents*(task + 1)/numberOfTasks);
+   }, ROOT::TSeqUL(numberOfTasks));
+}
+
+bool SimTrackCacheReader::IsValid(const std::string& fileName, 
+                                  const std::string& sourceFileName,
+                                  const unsigned long inputsHash)
+{
+   std::ifstream file(fileName, std::ios::binary);
+   if (!file.is_open() || !std::filesystem::exists(sourceFileName)) return false;
+
+   SimTrackCacheHeader header;
+   if (!file.read(reinterpret_cast<char *>(&header), sizeof(header))) return false;
+
+   return (std::memcmp(header.magic, simTrackCacheMagic, sizeof(header.magic)) == 0 &&
+           header.version == simTrackCacheVersion && header.trackSize == sizeof(SimTrack) &&
+           header.sourceSize == std::filesystem::file_size(sourceFileName) &&
+           header.sourceTime == GetSimTrackCacheSourceTime(sourceFileName) &&
+           header.inputsHash == inputsHash);
+}
+
+SimTrackCacheReader::~SimTrackCacheReader()
+{
+   if (data) munmap(const_cast<char *>(data), size);
+}
+
+#endif /* SIM_TRACK_CACHE_CPP */
@@ -0,0 +1,178 @@
+/**
+ *  @file   SimTreeIndex.cpp
+ *  @brief  Contains realisation of class SimTreeIndex that can be used to skim trees obtained from PHENIX simulation by event level variables without reading the full entries
+ *
+ *  This file is a part of a project PairAnalysisPhenix (https://github.com/Sergeyir/PairAnalysisPhenix).
+ *
+ *  @author Sergei Antsupov (antsupov0124@gmail.com)
+ **/
+
+#ifndef SIM_TREE_INDEX_CPP
+#define SIM_TREE_INDEX_CPP
+
+#include "../include/SimTreeIndex.hpp"
+
+// branches that are needed to build the index
+static const std::vector<std::string> indexBranches = {"mom_orig", "bbcz", "nch"};
+
+void SimTreeIndex::Build(const std::string& simFileName)
+{
+   SimTreeIndex index;
+   std::mutex indexMutex;
+
+   SimTreeReader::Process(simFileName, indexBranches, [&](SimTreeReader &simCNT)
+   {
+      SimTreeIndex taskIndex;
+      while (simCNT.Next())
+      {
+         const SimEventSnapshot& simEvent = simCNT.Snapshot();
+
+         taskIndex.entries.push_back(simCNT.GetCurrentEntry());
+         taskIndex.origPTs.push_back(sqrt(pow(simEvent.mom_orig[0], 2) +
+                                          pow(simEvent.mom_orig[1], 2)));
+         taskIndex.bbczs.push_back(simEvent.bbcz);
+         taskIndex.nchs.push_back(static_cast<short>(simEvent.nch));
+      }
+
+      std::lock_guard<std::mutex> lock(indexMutex);
+      index.entries.insert(index.entries.end(),
+                           taskIndex.entries.begin(), taskIndex.entries.end());
+      index.origPTs.insert(index.origPTs.end(),
+                           taskIndex.origPTs.begin(), taskIndex.origPTs.end());
+      index.bbczs.insert(index.bbczs.end(), taskIndex.bbczs.begin(), taskIndex.bbczs.end());
+      index.nchs.insert(index.nchs.end(), taskIndex.nchs.begin(), taskIndex.nchs.end());
+   });
+
+   // tasks finish in arbitrary order while entry lists passed to SimTreeReader must be sorted
+   std::vector<unsigned long> order(index.GetSize());
+   for (unsigned long i = 0; i < order.size(); i++) order[i] = i;
+   std::sort(order.begin(), order.end(), [&](const unsigned long i, const unsigned long j)
+   {
+      return index.entries[i] < index.entries[j];
+   });
+
+   TFile indexFile(GetIndexFileName(simFileName).c_str(), "RECREATE");
+   TTree indexTree("Index", "Index");
+
+   Long64_t entry;
+   double origPT;
+   float bbcz;
+   short nch;
+
+   indexTree.Branch("entry", &entry, "entry/L");
+   indexTree.Branch("origPT", &origPT, "origPT/D");
+   indexTree.Branch("bbcz", &bbcz, "bbcz/F");
+   indexTree.Branch("nch", &nch, "nch/S");
+
+   for (const unsigned long i : order)
+   {
+      entry = static_cast<Long64_t>(index.entries[i]);
+      origPT = index.origPTs[i];
+      bbcz = index.bbczs[i];
+      nch = index.nchs[i];
+      indexTree.Fill();
+   }
+
+   indexTree.Write();
+   // size of the simulated tree file is stored to detect outdated indices
+   TParameter<Long64_t>("simFileSize", static_cast<Long64_t>
+                        (std::filesystem::file_size(simFileName))).Write();
+}
+
+bool SimTreeIndex::Load(const std::string& simFileName)
+{
+   if (!IsValid(simFileName)) return false;
+
+   TFile indexFile(GetIndexFileName(simFileName).c_str());
+   TTree *indexTree = static_cast<TTree *>(indexFile.Get("Index"));
+
+   Long64_t entry;
+   double origPT;
+   float bbcz;
+   short nch;
+
+   indexTree->SetBranchAddress("entry", &entry);
+   indexTree->SetBranchAddress("origPT", &origPT);
+   indexTree->SetBranchAddress("bbcz", &bbcz);
+   indexTree->SetBranchAddress("nch", &nch);
+
+   const unsigned long size = static_cast<unsigned long>(indexTree->GetEntries());
+
+   entries.resize(size);
+   origPTs.resize(size);
+   bbczs.resize(size);
+   nchs.resize(size);
+
+   for (unsigned long i = 0; i < size; i++)
+   {
+      indexTree->GetEntry(i);
+      entries[i] = static_cast<unsigned long>(entry);
+      origPTs[i] = origPT;
+      bbczs[i] = bbcz;
+      nchs[i] = nch;
+   }
+
+   return true;
+}
+
+unsigned long SimTreeIndex::GetSize() const
+{
+   return entries.size();
+}
+
+unsigned long SimTreeIndex::entry(const unsigned long i) const {return entries[i];}
+double SimTreeIndex::origPT(const unsigned long i) const {return origPTs[i];}
+float SimTreeIndex::bbcz(const unsigned long i) const {return bbczs[i];}
+short SimTreeIndex::nch(const unsigned long i) const {return nchs[i];}
+
+std::string SimTreeIndex::GetIndexFileName(const std::string& simFileName)
+{
+   const std::string extension = ".root";
+   if (simFileName.size() > extension.size() &&
+       simFileName.compare(simFileName.size() - extension.size(),
+                           extension.size(), extension) == 0)
+   {
+      return simFileName.substr(0, simFileName.size() - extension.size()) + ".index.root";
+   }
+   return simFileName + ".index.root";
+}
+
+bool SimTreeIndex::IsValid(const std::string& simFileName)
+{
+   const std::string indexFileName = GetIndexFileName(simFileName);
+
+   if (!std::filesystem::exists(indexFileName)) return false;
+
+   if (std::filesystem::last_write_time(indexFileName) <
+       std::filesystem::last_write_time(simFileName))
+   {
+      CppTools::PrintWarning("SimTreeIndex: index " + indexFileName + " is older than " +
+                             simFileName + "; it will not be used");
+      return false;
+   }
+
+   TFile indexFile(indexFileName.c_str());
+   TParameter<Long64_t> *simFileSize =
+      static_cast<TParameter<Long64_t> *>(indexFile.Get("simFileSize"));
+
+   if (!indexFile.Get("Index") || !simFileSize ||
+       simFileSize->GetVal() != static_cast<Long64_t>(std::filesystem::file_size(simFileName)))
+   {
+      CppTools::PrintWarning("SimTreeIndex: index " + indexFileName +
+                             " does not match " + simFileName + "; it will not be used");
+      return false;
+   }
+
+   return true;
+}
+
+unsigned long SimTreeIndex::GetNumberOfEntries(const std::string& simFileName)
+{
+   if (!IsValid(simFileName)) return SimTreeReader::GetNumberOfEntries(simFileName);
+
+   TFile indexFile(GetIndexFileName(simFileName).c_str());
+   return static_cast<unsigned long>
+      (static_cast<TTree *>(indexFile.Get("Index"))->GetEntries());
+}
+
+#endif /* SIM_TREE_INDEX_CPP */
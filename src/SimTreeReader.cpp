@@ -12,177 +12,685 @@
 
 #include "../include/SimTreeReader.hpp"
 
-SimTreeReader::SimTreeReader(TTreeReader &reader)
+const std::vector<std::string> SimTreeReader::allBranches = 
 {
+   "mom_orig", "nch", "bbcz", "dcarm", "phi", "alpha", "zed", "mom", "the0", "phi0",
+   "nx1hits", "nx2hits", "qual", "charge", "parent_id", "primary_id", "particle_id", "ttof",
+   "ttofw", "temc", "pltof", "pltofw", "plemc", "ptofx", "ptofy", "ptofz", "ptofwx", "ptofwy",
+   "ptofwz", "pemcx", "pemcy", "pemcz", "ppc1x", "ppc1y", "ppc1z", "ppc2x", "ppc2y", "ppc2z",
+   "ppc3x", "ppc3y", "ppc3z", "ptecx", "ptecy", "ptecz", "tofdz", "tofdphi", "tofwdz",
+   "tofwdphi", "emcdz", "emcdphi", "pc2dz", "pc2dphi", "pc3dz", "pc3dphi", "striptofw",
+   "slat", "etof", "ecore", "emce", "ecent", "e9", "emcchi2", "twrhit", "emcdispy",
+   "emcdispz", "prob", "sect", "ysect", "zsect", "n0", "npe0", "n1", "npe1", "n2", "npe2",
+   "n3", "npe3", "center_phi", "center_z", "cross_phi", "cross_z", "disp", "chi2"
+};
+
+std::vector<std::atomic<unsigned long>> 
+   SimTreeReader::jobBranchesBytesRead(SimTreeReader::allBranches.size());
+
+#ifdef SIM_TREE_READER_RNTUPLE
+// float per-track fields of RNTuple and the corresponding SimEventSnapshot members
+static const std::vector<std::pair<std::string, std::vector<float> SimEventSnapshot::*>> 
+   snapshotFloatColumns =
+{
+   {"phi", &SimEventSnapshot::phi},
+   {"alpha", &SimEventSnapshot::alpha},
+   {"zed", &SimEventSnapshot::zed},
+   {"mom", &SimEventSnapshot::mom},
+   {"the0", &SimEventSnapshot::the0},
+   {"phi0", &SimEventSnapshot::phi0},
+   {"ttof", &SimEventSnapshot::ttof},
+   {"ttofw", &SimEventSnapshot::ttofw},
+   {"temc", &SimEventSnapshot::temc},
+   {"pltof", &SimEventSnapshot::pltof},
+   {"pltofw", &SimEventSnapshot::pltofw},
+   {"plemc", &SimEventSnapshot::plemc},
+   {"ppc1x", &SimEventSnapshot::ppc1x},
+   {"ppc1y", &SimEventSnapshot::ppc1y},
+   {"ppc1z", &SimEventSnapshot::ppc1z},
+   {"ppc2x", &SimEventSnapshot::ppc2x},
+   {"ppc2y", &SimEventSnapshot::ppc2y},
+   {"ppc2z", &SimEventSnapshot::ppc2z},
+   {"ppc3x", &SimEventSnapshot::ppc3x},
+   {"ppc3y", &SimEventSnapshot::ppc3y},
+   {"ppc3z", &SimEventSnapshot::ppc3z},
+   {"tofdz", &SimEventSnapshot::tofdz},
+   {"tofdphi", &SimEventSnapshot::tofdphi},
+   {"tofwdz", &SimEventSnapshot::tofwdz},
+   {"tofwdphi", &SimEventSnapshot::tofwdphi},
+   {"emcdz", &SimEventSnapshot::emcdz},
+   {"emcdphi", &SimEventSnapshot::emcdphi},
+   {"pc2dz", &SimEventSnapshot::pc2dz},
+   {"pc2dphi", &SimEventSnapshot::pc2dphi},
+   {"pc3dz", &SimEventSnapshot::pc3dz},
+   {"pc3dphi", &SimEventSnapshot::pc3dphi},
+   {"etof", &SimEventSnapshot::etof},
+   {"ecore", &SimEventSnapshot::ecore},
+   {"prob", &SimEventSnapshot::prob}
+};
+
+// short per-track fields of RNTuple and the corresponding SimEventSnapshot members
+static const std::vector<std::pair<std::string, std::vector<short> SimEventSnapshot::*>> 
+   snapshotShortColumns =
+{
+   {"dcarm", &SimEventSnapshot::dcarm},
+   {"nx1hits", &SimEventSnapshot::nx1hits},
+   {"nx2hits", &SimEventSnapshot::nx2hits},
+   {"qual", &SimEventSnapshot::qual},
+   {"charge", &SimEventSnapshot::charge},
+   {"primary_id", &SimEventSnapshot::primary_id},
+   {"particle_id", &SimEventSnapshot::particle_id},
+   {"striptofw", &SimEventSnapshot::striptofw},
+   {"slat", &SimEventSnapshot::slat},
+   {"sect", &SimEventSnapshot::sect},
+   {"ysect", &SimEventSnapshot::ysect},
+   {"zsect", &SimEventSnapshot::zsect}
+};
+#endif
+
+template<typename T>
+void SimTreeReader::BindBranch(TTreeReader &reader, std::unique_ptr<T>& branch, 
+                               const std::string& branchName)
+{
+   if (!IsBranchRead(branchName)) return;
+   branch = std::make_unique<T>(reader, branchName.c_str());
+}
+
+SimTreeReader::SimTreeReader(TTreeReader &reader, const std::vector<std::string>& branches,
+                             const std::vector<unsigned long> *entries, 
+                             const unsigned long firstEntry, const unsigned long lastEntry) :
+   branchesToRead(branches), treeReader(&reader), nextEntry(firstEntry), 
+   lastEntry(lastEntry), entriesToRead(entries), 
+   countedBranches(allBranches.size(), nullptr), lastCountedBaskets(allBranches.size(), -1),
+   branchesBytesRead(allBranches.size(), 0)
+{
+   for (const std::string& branchName : branchesToRead)
+   {
+      if (std::find(allBranches.begin(), allBranches.end(), branchName) == allBranches.end())
+      {
+         CppTools::PrintError("SimTreeReader: Unknown branch \"" + branchName + "\" was requested");
+      }
+   }
+
    // branch for original momentum
-   b_mom_orig = std::make_unique<TTreeReaderArray<float>>
-      (TTreeReaderArray<float>(reader, "mom_orig"));
-   // branches for event variables
-   b_nch = std::make_unique<TTreeReaderValue<int>>
-      (TTreeReaderValue<int>(reader, "nch"));
-   b_bbcz = std::make_unique<TTreeReaderValue<float>>
-      (TTreeReaderValue<float>(reader, "bbcz"));
+   BindBranch(reader, b_mom_orig, "mom_orig");
+   // branches for event variables; nch is always read 
+   // since the sizes of the arrays of the tracks are taken from it
+   b_nch = std::make_unique<TTreeReaderValue<int>>(reader, "nch");
+   BindBranch(reader, b_bbcz, "bbcz");
    // branches for charged track variables
-   b_dcarm = std::make_unique<TTreeReaderArray<short>>
-      (TTreeReaderArray<short>(reader, "dcarm"));
-   b_phi = std::make_unique<TTreeReaderArray<float>>
-      (TTreeReaderArray<float>(reader, "phi"));
-   b_alpha = std::make_unique<TTreeReaderArray<float>>
-      (TTreeReaderArray<float>(reader, "alpha"));
-   b_zed = std::make_unique<TTreeReaderArray<float>>
-      (TTreeReaderArray<float>(reader, "zed"));
-   b_mom = std::make_unique<TTreeReaderArray<float>>
-      (TTreeReaderArray<float>(reader, "mom"));
-   b_the0 = std::make_unique<TTreeReaderArray<float>>
-      (TTreeReaderArray<float>(reader, "the0"));
-   b_phi0 = std::make_unique<TTreeReaderArray<float>>
-      (TTreeReaderArray<float>(reader, "phi0"));
-   b_nx1hits = std::make_unique<TTreeReaderArray<short>>
-      (TTreeReaderArray<short>(reader, "nx1hits"));
-   b_nx2hits = std::make_unique<TTreeReaderArray<short>>
-      (TTreeReaderArray<short>(reader, "nx2hits"));
-   b_qual = std::make_unique<TTreeReaderArray<short>>
-      (TTreeReaderArray<short>(reader, "qual"));
-   b_charge = std::make_unique<TTreeReaderArray<short>>
-      (TTreeReaderArray<short>(reader, "charge"));
-   b_parent_id = std::make_unique<TTreeReaderArray<short>>
-      (TTreeReaderArray<short>(reader, "parent_id"));
-   b_primary_id = std::make_unique<TTreeReaderArray<short>>
-      (TTreeReaderArray<short>(reader, "primary_id"));
-   b_particle_id = std::make_unique<TTreeReaderArray<short>>
-      (TTreeReaderArray<short>(reader, "particle_id"));
-   b_ttof = std::make_unique<TTreeReaderArray<float>>
-      (TTreeReaderArray<float>(reader, "ttof"));
-   b_ttofw = std::make_unique<TTreeReaderArray<float>>
-      (TTreeReaderArray<float>(reader, "ttofw"));
-   b_temc = std::make_unique<TTreeReaderArray<float>>
-      (TTreeReaderArray<float>(reader, "temc"));
-   b_pltof = std::make_unique<TTreeReaderArray<float>>
-      (TTreeReaderArray<float>(reader, "pltof"));
-   b_pltofw = std::make_unique<TTreeReaderArray<float>>
-      (TTreeReaderArray<float>(reader, "pltofw"));
-   b_plemc = std::make_unique<TTreeReaderArray<float>>
-      (TTreeReaderArray<float>(reader, "plemc"));
-   b_ptofx = std::make_unique<TTreeReaderArray<float>>
-      (TTreeReaderArray<float>(reader, "ptofx"));
-   b_ptofy = std::make_unique<TTreeReaderArray<float>>
-      (TTreeReaderArray<float>(reader, "ptofy"));
-   b_ptofz = std::make_unique<TTreeReaderArray<float>>
-      (TTreeReaderArray<float>(reader, "ptofz"));
-   b_ptofwx = std::make_unique<TTreeReaderArray<float>>
-      (TTreeReaderArray<float>(reader, "ptofwx"));
-   b_ptofwy = std::make_unique<TTreeReaderArray<float>>
-      (TTreeReaderArray<float>(reader, "ptofwy"));
-   b_ptofwz = std::make_unique<TTreeReaderArray<float>>
-      (TTreeReaderArray<float>(reader, "ptofwz"));
-   b_pemcx = std::make_unique<TTreeReaderArray<float>>
-      (TTreeReaderArray<float>(reader, "pemcx"));
-   b_pemcy = std::make_unique<TTreeReaderArray<float>>
-      (TTreeReaderArray<float>(reader, "pemcy"));
-   b_pemcz = std::make_unique<TTreeReaderArray<float>>
-      (TTreeReaderArray<float>(reader, "pemcz"));
-   b_ppc1x = std::make_unique<TTreeReaderArray<float>>
-      (TTreeReaderArray<float>(reader, "ppc1x"));
-   b_ppc1y = std::make_unique<TTreeReaderArray<float>>
-      (TTreeReaderArray<float>(reader, "ppc1y"));
-   b_ppc1z = std::make_unique<TTreeReaderArray<float>>
-      (TTreeReaderArray<float>(reader, "ppc1z"));
-   b_ppc2x = std::make_unique<TTreeReaderArray<float>>
-      (TTreeReaderArray<float>(reader, "ppc2x"));
-   b_ppc2y = std::make_unique<TTreeReaderArray<float>>
-      (TTreeReaderArray<float>(reader, "ppc2y"));
-   b_ppc2z = std::make_unique<TTreeReaderArray<float>>
-      (TTreeReaderArray<float>(reader, "ppc2z"));
-   b_ppc3x = std::make_unique<TTreeReaderArray<float>>
-      (TTreeReaderArray<float>(reader, "ppc3x"));
-   b_ppc3y = std::make_unique<TTreeReaderArray<float>>
-      (TTreeReaderArray<float>(reader, "ppc3y"));
-   b_ppc3z = std::make_unique<TTreeReaderArray<float>>
-      (TTreeReaderArray<float>(reader, "ppc3z"));
-   b_ptecx = std::make_unique<TTreeReaderArray<float>>
-      (TTreeReaderArray<float>(reader, "ptecx"));
-   b_ptecy = std::make_unique<TTreeReaderArray<float>>
-      (TTreeReaderArray<float>(reader, "ptecy"));
-   b_ptecz = std::make_unique<TTreeReaderArray<float>>
-      (TTreeReaderArray<float>(reader, "ptecz"));
-   b_tofdz = std::make_unique<TTreeReaderArray<float>>
-      (TTreeReaderArray<float>(reader, "tofdz"));
-   b_tofdphi = std::make_unique<TTreeReaderArray<float>>
-      (TTreeReaderArray<float>(reader, "tofdphi"));
-   b_tofwdz = std::make_unique<TTreeReaderArray<float>>
-      (TTreeReaderArray<float>(reader, "tofwdz"));
-   b_tofwdphi = std::make_unique<TTreeReaderArray<float>>
-      (TTreeReaderArray<float>(reader, "tofwdphi"));
-   b_emcdz = std::make_unique<TTreeReaderArray<float>>
-      (TTreeReaderArray<float>(reader, "emcdz"));
-   b_emcdphi = std::make_unique<TTreeReaderArray<float>>
-      (TTreeReaderArray<float>(reader, "emcdphi"));
-   b_pc2dz = std::make_unique<TTreeReaderArray<float>>
-      (TTreeReaderArray<float>(reader, "pc2dz"));
-   b_pc2dphi = std::make_unique<TTreeReaderArray<float>>
-      (TTreeReaderArray<float>(reader, "pc2dphi"));
-   b_pc3dz = std::make_unique<TTreeReaderArray<float>>
-      (TTreeReaderArray<float>(reader, "pc3dz"));
-   b_pc3dphi = std::make_unique<TTreeReaderArray<float>>
-      (TTreeReaderArray<float>(reader, "pc3dphi"));
-   b_striptofw = std::make_unique<TTreeReaderArray<short>>
-      (TTreeReaderArray<short>(reader, "striptofw"));
-   b_slat = std::make_unique<TTreeReaderArray<short>>
-      (TTreeReaderArray<short>(reader, "slat"));
-   b_etof = std::make_unique<TTreeReaderArray<float>>
-      (TTreeReaderArray<float>(reader, "etof"));
-   b_ecore = std::make_unique<TTreeReaderArray<float>>
-      (TTreeReaderArray<float>(reader, "ecore"));
-   b_emce = std::make_unique<TTreeReaderArray<float>>
-      (TTreeReaderArray<float>(reader, "emce"));
-   b_ecent = std::make_unique<TTreeReaderArray<float>>
-      (TTreeReaderArray<float>(reader, "ecent"));
-   b_e9 = std::make_unique<TTreeReaderArray<float>>
-      (TTreeReaderArray<float>(reader, "e9"));
-   b_emcchi2 = std::make_unique<TTreeReaderArray<float>>
-      (TTreeReaderArray<float>(reader, "emcchi2"));
-   b_twrhit = std::make_unique<TTreeReaderArray<short>>
-      (TTreeReaderArray<short>(reader, "twrhit"));
-   b_emcdispy = std::make_unique<TTreeReaderArray<float>>
-      (TTreeReaderArray<float>(reader, "emcdispy"));
-   b_emcdispz = std::make_unique<TTreeReaderArray<float>>
-      (TTreeReaderArray<float>(reader, "emcdispz"));
-   b_prob = std::make_unique<TTreeReaderArray<float>>
-      (TTreeReaderArray<float>(reader, "prob"));
-   b_sect = std::make_unique<TTreeReaderArray<short>>
-      (TTreeReaderArray<short>(reader, "sect"));
-   b_ysect = std::make_unique<TTreeReaderArray<short>>
-      (TTreeReaderArray<short>(reader, "ysect"));
-   b_zsect = std::make_unique<TTreeReaderArray<short>>
-      (TTreeReaderArray<short>(reader, "zsect"));
-   b_n0 = std::make_unique<TTreeReaderArray<short>>
-      (TTreeReaderArray<short>(reader, "n0"));
-   b_npe0 = std::make_unique<TTreeReaderArray<short>>
-      (TTreeReaderArray<short>(reader, "npe0"));
-   b_n1 = std::make_unique<TTreeReaderArray<short>>
-      (TTreeReaderArray<short>(reader, "n1"));
-   b_npe1 = std::make_unique<TTreeReaderArray<short>>
-      (TTreeReaderArray<short>(reader, "npe1"));
-   b_n2 = std::make_unique<TTreeReaderArray<short>>
-      (TTreeReaderArray<short>(reader, "n2"));
-   b_npe2 = std::make_unique<TTreeReaderArray<short>>
-      (TTreeReaderArray<short>(reader, "npe2"));
-   b_n3 = std::make_unique<TTreeReaderArray<short>>
-      (TTreeReaderArray<short>(reader, "n3"));
-   b_npe3 = std::make_unique<TTreeReaderArray<short>>
-      (TTreeReaderArray<short>(reader, "npe3"));
-   b_center_phi = std::make_unique<TTreeReaderArray<float>>
-      (TTreeReaderArray<float>(reader, "center_phi"));
-   b_center_z = std::make_unique<TTreeReaderArray<float>>
-      (TTreeReaderArray<float>(reader, "center_z"));
-   b_cross_phi = std::make_unique<TTreeReaderArray<float>>
-      (TTreeReaderArray<float>(reader, "cross_phi"));
-   b_cross_z = std::make_unique<TTreeReaderArray<float>>
-      (TTreeReaderArray<float>(reader, "cross_z"));
-   b_disp = std::make_unique<TTreeReaderArray<float>>
-      (TTreeReaderArray<float>(reader, "disp"));
-   b_chi2 = std::make_unique<TTreeReaderArray<float>>
-      (TTreeReaderArray<float>(reader, "chi2"));
+   BindBranch(reader, b_dcarm, "dcarm");
+   BindBranch(reader, b_phi, "phi");
+   BindBranch(reader, b_alpha, "alpha");
+   BindBranch(reader, b_zed, "zed");
+   BindBranch(reader, b_mom, "mom");
+   BindBranch(reader, b_the0, "the0");
+   BindBranch(reader, b_phi0, "phi0");
+   BindBranch(reader, b_nx1hits, "nx1hits");
+   BindBranch(reader, b_nx2hits, "nx2hits");
+   BindBranch(reader, b_qual, "qual");
+   BindBranch(reader, b_charge, "charge");
+   BindBranch(reader, b_parent_id, "parent_id");
+   BindBranch(reader, b_primary_id, "primary_id");
+   BindBranch(reader, b_particle_id, "particle_id");
+   BindBranch(reader, b_ttof, "ttof");
+   BindBranch(reader, b_ttofw, "ttofw");
+   BindBranch(reader, b_temc, "temc");
+   BindBranch(reader, b_pltof, "pltof");
+   BindBranch(reader, b_pltofw, "pltofw");
+   BindBranch(reader, b_plemc, "plemc");
+   BindBranch(reader, b_ptofx, "ptofx");
+   BindBranch(reader, b_ptofy, "ptofy");
+   BindBranch(reader, b_ptofz, "ptofz");
+   BindBranch(reader, b_ptofwx, "ptofwx");
+   BindBranch(reader, b_ptofwy, "ptofwy");
+   BindBranch(reader, b_ptofwz, "ptofwz");
+   BindBranch(reader, b_pemcx, "pemcx");
+   BindBranch(reader, b_pemcy, "pemcy");
+   BindBranch(reader, b_pemcz, "pemcz");
+   BindBranch(reader, b_ppc1x, "ppc1x");
+   BindBranch(reader, b_ppc1y, "ppc1y");
+   BindBranch(reader, b_ppc1z, "ppc1z");
+   BindBranch(reader, b_ppc2x, "ppc2x");
+   BindBranch(reader, b_ppc2y, "ppc2y");
+   BindBranch(reader, b_ppc2z, "ppc2z");
+   BindBranch(reader, b_ppc3x, "ppc3x");
+   BindBranch(reader, b_ppc3y, "ppc3y");
+   BindBranch(reader, b_ppc3z, "ppc3z");
+   BindBranch(reader, b_ptecx, "ptecx");
+   BindBranch(reader, b_ptecy, "ptecy");
+   BindBranch(reader, b_ptecz, "ptecz");
+   BindBranch(reader, b_tofdz, "tofdz");
+   BindBranch(reader, b_tofdphi, "tofdphi");
+   BindBranch(reader, b_tofwdz, "tofwdz");
+   BindBranch(reader, b_tofwdphi, "tofwdphi");
+   BindBranch(reader, b_emcdz, "emcdz");
+   BindBranch(reader, b_emcdphi, "emcdphi");
+   BindBranch(reader, b_pc2dz, "pc2dz");
+   BindBranch(reader, b_pc2dphi, "pc2dphi");
+   BindBranch(reader, b_pc3dz, "pc3dz");
+   BindBranch(reader, b_pc3dphi, "pc3dphi");
+   BindBranch(reader, b_striptofw, "striptofw");
+   BindBranch(reader, b_slat, "slat");
+   BindBranch(reader, b_etof, "etof");
+   BindBranch(reader, b_ecore, "ecore");
+   BindBranch(reader, b_emce, "emce");
+   BindBranch(reader, b_ecent, "ecent");
+   BindBranch(reader, b_e9, "e9");
+   BindBranch(reader, b_emcchi2, "emcchi2");
+   BindBranch(reader, b_twrhit, "twrhit");
+   BindBranch(reader, b_emcdispy, "emcdispy");
+   BindBranch(reader, b_emcdispz, "emcdispz");
+   BindBranch(reader, b_prob, "prob");
+   BindBranch(reader, b_sect, "sect");
+   BindBranch(reader, b_ysect, "ysect");
+   BindBranch(reader, b_zsect, "zsect");
+   BindBranch(reader, b_n0, "n0");
+   BindBranch(reader, b_npe0, "npe0");
+   BindBranch(reader, b_n1, "n1");
+   BindBranch(reader, b_npe1, "npe1");
+   BindBranch(reader, b_n2, "n2");
+   BindBranch(reader, b_npe2, "npe2");
+   BindBranch(reader, b_n3, "n3");
+   BindBranch(reader, b_npe3, "npe3");
+   BindBranch(reader, b_center_phi, "center_phi");
+   BindBranch(reader, b_center_z, "center_z");
+   BindBranch(reader, b_cross_phi, "cross_phi");
+   BindBranch(reader, b_cross_z, "cross_z");
+   BindBranch(reader, b_disp, "disp");
+   BindBranch(reader, b_chi2, "chi2");
+}
+
+SimTreeReader::SimTreeReader(const std::string& fileName, const unsigned long firstEntry, 
+                             const unsigned long lastEntry, 
+                             const std::vector<std::string>& branches,
+                             const std::string& ntupleName, 
+                             const std::vector<unsigned long> *entries) :
+   branchesToRead(branches), nextEntry(firstEntry), lastEntry(lastEntry), entriesToRead(entries)
+{
+#ifdef SIM_TREE_READER_RNTUPLE
+   ntupleReader = ROOT::RNTupleReader::Open(ntupleName, fileName);
+
+   v_nch = std::make_unique<ROOT::RNTupleView<int>>(ntupleReader->GetView<int>("nch"));
+   if (IsBranchRead("bbcz")) 
+   {
+      v_bbcz = std::make_unique<ROOT::RNTupleView<float>>
+         (ntupleReader->GetView<float>("bbcz"));
+   }
+   if (IsBranchRead("mom_orig")) 
+   {
+      v_mom_orig = std::make_unique<ROOT::RNTupleView<std::vector<float>>>
+         (ntupleReader->GetView<std::vector<float>>("mom_orig"));
+   }
+
+   for (const auto& column : snapshotFloatColumns)
+   {
+      if (!IsBranchRead(column.first)) continue;
+      floatViews.emplace_back(column.second, 
+                              ntupleReader->GetView<std::vector<float>>(column.first));
+   }
+   for (const auto& column : snapshotShortColumns)
+   {
+      if (!IsBranchRead(column.first)) continue;
+      shortViews.emplace_back(column.second, 
+                              ntupleReader->GetView<std::vector<short>>(column.first));
+   }
+#else
+   (void) fileName;
+   (void) ntupleName;
+   CppTools::PrintError("SimTreeReader: RNTuple input requires ROOT 6.36 or newer");
+#endif
+}
+
+bool SimTreeReader::Next()
+{
+   // baskets are loaded lazily when the branches of the entry are accessed
+   // so the bytes of the previous entry are counted before the next one is loaded
+   if (treeReader) CountBytesRead();
+
+   if (treeReader && !entriesToRead) return treeReader->Next();
+   if (nextEntry >= lastEntry) return false;
+   currentEntry = (entriesToRead ? (*entriesToRead)[nextEntry] : nextEntry);
+   nextEntry++;
+   // entries from the list are not contiguous and are loaded directly
+   if (treeReader) return (treeReader->SetEntry(currentEntry) == TTreeReader::kEntryValid);
+   return true;
+}
+
+void SimTreeReader::CountBytesRead()
+{
+   TTree *tree = treeReader->GetTree();
+   if (!tree) return;
+   // current tree of TChain (e.g. in ROOT::TTreeProcessorMT tasks)
+   tree = tree->GetTree();
+   if (!tree) return;
+
+   // branches are looked up again when the reader switches to another tree
+   if (tree != countedTree)
+   {
+      countedTree = tree;
+      for (unsigned int i = 0; i < allBranches.size(); i++)
+      {
+         countedBranches[i] = (IsBranchRead(allBranches[i]) || allBranches[i] == "nch") ? 
+                              tree->GetBranch(allBranches[i].c_str()) : nullptr;
+         lastCountedBaskets[i] = -1;
+      }
+   }
+
+   for (unsigned int i = 0; i < allBranches.size(); i++)
+   {
+      TBranch *branch = countedBranches[i];
+      if (!branch) continue;
+
+      // each basket is counted once when it becomes the last one read by the branch
+      const int basket = branch->GetReadBasket();
+      if (basket < 0 || basket == lastCountedBaskets[i] || !branch->GetBasketBytes()) continue;
+
+      lastCountedBaskets[i] = basket;
+      branchesBytesRead[i] += static_cast<unsigned long>(branch->GetBasketBytes()[basket]);
+   }
+}
+
+unsigned long SimTreeReader::GetCurrentEntry() const
+{
+   if (treeReader) return static_cast<unsigned long>(treeReader->GetCurrentEntry());
+   return currentEntry;
+}
+
+void SimTreeReader::Process(const std::string& fileName, const std::vector<std::string>& branches,
+                            const std::function<void(SimTreeReader&)>& func, 
+                            const std::string& treeName, 
+                            const std::vector<unsigned long> *entries)
+{
+   if (entries && entries->empty()) return;
+
+   auto ProcessTask = [&](TTreeReader &reader)
+   {
+      SimTreeReader simTreeReader(reader, branches);
+      func(simTreeReader);
+   };
+
+   if (!IsRNTuple(fileName, treeName))
+   {
+      if (!entries)
+      {
+         ROOT::TTreeProcessorMT tp(fileName.c_str(), treeName.c_str());
+         tp.Process(ProcessTask);
+         return;
+      }
+
+      TFile file(fileName.c_str());
+      TTree *tree = static_cast<TTree *>(file.Get(treeName.c_str()));
+
+      TEntryList entryList("", "", treeName.c_str(), fileName.c_str());
+      for (const unsigned long entry : *entries) entryList.Enter(entry);
+
+      ROOT::TTreeProcessorMT tp(*tree, entryList);
+      tp.Process(ProcessTask);
+      return;
+   }
+
+   const unsigned long numberOfEntries = 
+      (entries ? entries->size() : GetNumberOfEntries(fileName, treeName));
+   const unsigned int numberOfThreads = 
+      (ROOT::IsImplicitMTEnabled() ? ROOT::GetThreadPoolSize() : 1);
+   // several tasks per thread are used for better load balancing
+   const unsigned long numberOfTasks = 
+      std::min(4*static_cast<unsigned long>(numberOfThreads), std::max(numberOfEntries, 1UL));
+
+   ROOT::TThreadExecutor executor(numberOfThreads);
+   executor.Foreach([&](const unsigned long task)
+   {
+      SimTreeReader simTreeReader(fileName, numberOfEntries*task/numberOfTasks, 
+                                  numberOfEntries*(task + 1)/numberOfTasks, 
+                                  branches, treeName, entries);
+      func(simTreeReader);
+   }, ROOT::TSeqUL(numberOfTasks));
+}
+
+void SimTreeReader::Process(const std::vector<std::string>& fileNames, 
+                            const std::vector<std::string>& branches,
+                            const std::function<void(SimTreeReader&, const unsigned long)>& func, 
+                            const std::string& treeName,
+                            const std::vector<const std::vector<unsigned long> *>& entries,
+                            const bool prefetchNextFile)
+{
+   // range of entries (or of positions in the list of entries) of one file
+   struct Task
+   {
+      unsigned long fileIndex;
+      unsigned long firstEntry;
+      unsigned long lastEntry;
+   };
+
+   auto GetEntries = [&](const unsigned long fileIndex) -> const std::vector<unsigned long> *
+   {
+      return (entries.empty() ? nullptr : entries[fileIndex]);
+   };
+
+   std::vector<bool> isRNTuple(fileNames.size());
+   std::vector<unsigned long> numberOfEntries(fileNames.size());
+   unsigned long totalNumberOfEntries = 0;
+
+   for (unsigned long i = 0; i < fileNames.size(); i++)
+   {
+      isRNTuple[i] = IsRNTuple(fileNames[i], treeName);
+      numberOfEntries[i] = (GetEntries(i) ? GetEntries(i)->size() : 
+                            GetNumberOfEntries(fileNames[i], treeName));
+      totalNumberOfEntries += numberOfEntries[i];
+   }
+
+   // the largest files are queued first so that the tasks 
+   // of the smallest ones fill the tail of the processing
+   std::vector<unsigned long> fileOrder(fileNames.size());
+   std::iota(fileOrder.begin(), fileOrder.end(), 0);
+   std::stable_sort(fileOrder.begin(), fileOrder.end(), 
+                    [&](const unsigned long i, const unsigned long j)
+   {
+      return numberOfEntries[i] > numberOfEntries[j];
+   });
+
+   // file that is prefetched when the processing of the given file starts
+   std::vector<long> nextFileIndex(fileNames.size(), -1);
+   for (unsigned long i = 0; i + 1 < fileOrder.size(); i++)
+   {
+      nextFileIndex[fileOrder[i]] = static_cast<long>(fileOrder[i + 1]);
+   }
+
+   const unsigned int numberOfThreads = 
+      (ROOT::IsImplicitMTEnabled() ? ROOT::GetThreadPoolSize() : 1);
+   // same number of tasks per thread as in ROOT::TTreeProcessorMT by default
+   const unsigned long entriesPerTask = 
+      std::max(totalNumberOfEntries/(10*static_cast<unsigned long>(numberOfThreads)), 1UL);
+
+   std::vector<Task> tasks;
+   for (const unsigned long fileIndex : fileOrder)
+   {
+      if (numberOfEntries[fileIndex] == 0) continue;
+
+      // tasks over the full tree are aligned to clusters 
+      // so that no basket is read and decompressed by 2 tasks
+      if (!isRNTuple[fileIndex] && !GetEntries(fileIndex))
+      {
+         TFile file(fileNames[fileIndex].c_str());
+         TTree *tree = static_cast<TTree *>(file.Get(treeName.c_str()));
+         TTree::TClusterIterator clusterIterator = tree->GetClusterIterator(0);
+
+         unsigned long firstEntry = 0;
+         while (static_cast<unsigned long>(clusterIterator()) < numberOfEntries[fileIndex])
+         {
+            const unsigned long clusterEnd = 
+               std::min(static_cast<unsigned long>(clusterIterator.GetNextEntry()), 
+                        numberOfEntries[fileIndex]);
+            if (clusterEnd - firstEntry >= entriesPerTask || 
+                clusterEnd == numberOfEntries[fileIndex])
+            {
+               tasks.push_back({fileIndex, firstEntry, clusterEnd});
+               firstEntry = clusterEnd;
+            }
+         }
+         continue;
+      }
+
+      const unsigned long numberOfTasks = 
+         (numberOfEntries[fileIndex] + entriesPerTask - 1)/entriesPerTask;
+      for (unsigned long i = 0; i < numberOfTasks; i++)
+      {
+         tasks.push_back({fileIndex, numberOfEntries[fileIndex]*i/numberOfTasks, 
+                          numberOfEntries[fileIndex]*(i + 1)/numberOfTasks});
+      }
+   }
+
+   if (prefetchNextFile && !fileOrder.empty()) Prefetch(fileNames[fileOrder.front()]);
+
+   // threads take the tasks in the queue order until none are left
+   std::atomic<unsigned long> nextTask{0};
+
+   ROOT::TThreadExecutor executor(numberOfThreads);
+   executor.Foreach([&](const unsigned long)
+   {
+      // file stays open while this thread processes the consecutive tasks of the same file
+      std::unique_ptr<TFile> file;
+      TTree *tree = nullptr;
+      unsigned long openFileIndex = fileNames.size();
+
+      for (unsigned long taskIndex = nextTask++; taskIndex < tasks.size(); taskIndex = nextTask++)
+      {
+         const Task& task = tasks[taskIndex];
+         const std::vector<unsigned long> *fileEntries = GetEntries(task.fileIndex);
+
+         if (prefetchNextFile && task.firstEntry == 0 && nextFileIndex[task.fileIndex] >= 0)
+         {
+            Prefetch(fileNames[static_cast<unsigned long>(nextFileIndex[task.fileIndex])]);
+         }
+
+         if (isRNTuple[task.fileIndex])
+         {
+            SimTreeReader simTreeReader(fileNames[task.fileIndex], task.firstEntry, 
+                                        task.lastEntry, branches, treeName, fileEntries);
+            func(simTreeReader, task.fileIndex);
+            continue;
+         }
+
+         if (task.fileIndex != openFileIndex)
+         {
+            file = std::make_unique<TFile>(fileNames[task.fileIndex].c_str());
+            tree = static_cast<TTree *>(file->Get(treeName.c_str()));
+            // tasks are already processed in parallel so the branches are read sequentially
+            tree->SetImplicitMT(false);
+            openFileIndex = task.fileIndex;
+         }
+
+         TTreeReader reader(tree);
+         if (!fileEntries) reader.SetEntriesRange(task.firstEntry, task.lastEntry);
+
+         SimTreeReader simTreeReader(reader, branches, fileEntries, 
+                                     task.firstEntry, task.lastEntry);
+         func(simTreeReader, task.fileIndex);
+      }
+   }, ROOT::TSeqUL(numberOfThreads));
+}
+
+bool SimTreeReader::IsRNTuple(const std::string& fileName, const std::string& name)
+{
+   TFile file(fileName.c_str());
+   TKey *key = file.GetKey(name.c_str());
+   if (!key) 
+   {
+      CppTools::PrintError("SimTreeReader: " + name + " does not exist in file " + fileName);
+      return false;
+   }
+   return (std::string(key->GetClassName()).find("RNTuple") != std::string::npos);
+}
+
+unsigned long SimTreeReader::GetNumberOfEntries(const std::string& fileName, 
+                                                const std::string& name)
+{
+   if (IsRNTuple(fileName, name))
+   {
+#ifdef SIM_TREE_READER_RNTUPLE
+      return ROOT::RNTupleReader::Open(name, fileName)->GetNEntries();
+#else
+      CppTools::PrintError("SimTreeReader: RNTuple input requires ROOT 6.36 or newer");
+#endif
+   }
+
+   TFile file(fileName.c_str());
+   return static_cast<unsigned long>(static_cast<TTree *>(file.Get(name.c_str()))->GetEntries());
+}
+
+bool SimTreeReader::IsBranchRead(const std::string& branchName) const
+{
+   // empty list means that all branches are read
+   if (branchesToRead.empty()) return true;
+   return (std::find(branchesToRead.begin(), branchesToRead.end(), 
+                     branchName) != branchesToRead.end());
+}
+
+// copies the first size values of the branch (if it is read) into the contiguous buffer
+template<typename T>
+static void CopyArray(const std::unique_ptr<TTreeReaderArray<T>>& branch, 
+                      std::vector<T>& buffer, const int size)
+{
+   if (!branch) return;
+   if (buffer.size() < static_cast<std::size_t>(size)) buffer.resize(size);
+   for (int i = 0; i < size; i++) buffer[i] = (*branch)[i];
+}
+
+const SimEventSnapshot& SimTreeReader::Snapshot()
+{
+#ifdef SIM_TREE_READER_RNTUPLE
+   if (!treeReader)
+   {
+      SnapshotRNTuple();
+      return snapshot;
+   }
+#endif
+
+   snapshot.nch = *(b_nch->Get());
+   if (b_bbcz) snapshot.bbcz = *(b_bbcz->Get());
+   if (b_mom_orig) 
+   {
+      for (int i = 0; i < 3; i++) snapshot.mom_orig[i] = (*b_mom_orig)[i];
+   }
+
+   CopyArray(b_dcarm, snapshot.dcarm, snapshot.nch);
+   CopyArray(b_phi, snapshot.phi, snapshot.nch);
+   CopyArray(b_alpha, snapshot.alpha, snapshot.nch);
+   CopyArray(b_zed, snapshot.zed, snapshot.nch);
+   CopyArray(b_mom, snapshot.mom, snapshot.nch);
+   CopyArray(b_the0, snapshot.the0, snapshot.nch);
+   CopyArray(b_phi0, snapshot.phi0, snapshot.nch);
+   CopyArray(b_nx1hits, snapshot.nx1hits, snapshot.nch);
+   CopyArray(b_nx2hits, snapshot.nx2hits, snapshot.nch);
+   CopyArray(b_qual, snapshot.qual, snapshot.nch);
+   CopyArray(b_charge, snapshot.charge, snapshot.nch);
+   CopyArray(b_primary_id, snapshot.primary_id, snapshot.nch);
+   CopyArray(b_particle_id, snapshot.particle_id, snapshot.nch);
+   CopyArray(b_ttof, snapshot.ttof, snapshot.nch);
+   CopyArray(b_ttofw, snapshot.ttofw, snapshot.nch);
+   CopyArray(b_temc, snapshot.temc, snapshot.nch);
+   CopyArray(b_pltof, snapshot.pltof, snapshot.nch);
+   CopyArray(b_pltofw, snapshot.pltofw, snapshot.nch);
+   CopyArray(b_plemc, snapshot.plemc, snapshot.nch);
+   CopyArray(b_ppc1x, snapshot.ppc1x, snapshot.nch);
+   CopyArray(b_ppc1y, snapshot.ppc1y, snapshot.nch);
+   CopyArray(b_ppc1z, snapshot.ppc1z, snapshot.nch);
+   CopyArray(b_ppc2x, snapshot.ppc2x, snapshot.nch);
+   CopyArray(b_ppc2y, snapshot.ppc2y, snapshot.nch);
+   CopyArray(b_ppc2z, snapshot.ppc2z, snapshot.nch);
+   CopyArray(b_ppc3x, snapshot.ppc3x, snapshot.nch);
+   CopyArray(b_ppc3y, snapshot.ppc3y, snapshot.nch);
+   CopyArray(b_ppc3z, snapshot.ppc3z, snapshot.nch);
+   CopyArray(b_tofdz, snapshot.tofdz, snapshot.nch);
+   CopyArray(b_tofdphi, snapshot.tofdphi, snapshot.nch);
+   CopyArray(b_tofwdz, snapshot.tofwdz, snapshot.nch);
+   CopyArray(b_tofwdphi, snapshot.tofwdphi, snapshot.nch);
+   CopyArray(b_emcdz, snapshot.emcdz, snapshot.nch);
+   CopyArray(b_emcdphi, snapshot.emcdphi, snapshot.nch);
+   CopyArray(b_pc2dz, snapshot.pc2dz, snapshot.nch);
+   CopyArray(b_pc2dphi, snapshot.pc2dphi, snapshot.nch);
+   CopyArray(b_pc3dz, snapshot.pc3dz, snapshot.nch);
+   CopyArray(b_pc3dphi, snapshot.pc3dphi, snapshot.nch);
+   CopyArray(b_striptofw, snapshot.striptofw, snapshot.nch);
+   CopyArray(b_slat, snapshot.slat, snapshot.nch);
+   CopyArray(b_etof, snapshot.etof, snapshot.nch);
+   CopyArray(b_ecore, snapshot.ecore, snapshot.nch);
+   CopyArray(b_prob, snapshot.prob, snapshot.nch);
+   CopyArray(b_sect, snapshot.sect, snapshot.nch);
+   CopyArray(b_ysect, snapshot.ysect, snapshot.nch);
+   CopyArray(b_zsect, snapshot.zsect, snapshot.nch);
+
+   return snapshot;
+}
+
+#ifdef SIM_TREE_READER_RNTUPLE
+void SimTreeReader::SnapshotRNTuple()
+{
+   snapshot.nch = (*v_nch)(currentEntry);
+   if (v_bbcz) snapshot.bbcz = (*v_bbcz)(currentEntry);
+   if (v_mom_orig)
+   {
+      const std::vector<float>& momOrig = (*v_mom_orig)(currentEntry);
+      for (int i = 0; i < 3; i++) snapshot.mom_orig[i] = momOrig[i];
+   }
+
+   for (auto& view : floatViews) snapshot.*(view.first) = view.second(currentEntry);
+   for (auto& view : shortViews) snapshot.*(view.first) = view.second(currentEntry);
+}
+#endif
+
+void SimTreeReader::PrintIOReport(const std::vector<std::string>& fileNames, 
+                                  const std::vector<std::string>& branches,
+                                  const std::string& treeName)
+{
+   // bytes that were read by the process from all files; 
+   // evaluated before the files are opened below to get the sizes of the trees
+   const double fileBytesRead = static_cast<double>(TFile::GetFileBytesRead());
+
+   // compressed bytes of all branches on disk summed over all files
+   double totalBytes = 0.;
+
+   for (const std::string& fileName : fileNames)
+   {
+      TFile file(fileName.c_str());
+      TTree *tree = file.Get<TTree>(treeName.c_str());
+      if (!tree) 
+      {
+         CppTools::PrintWarning("SimTreeReader: TTree " + treeName + 
+                                " does not exist in file " + fileName);
+         continue;
+      }
+      totalBytes += static_cast<double>(tree->GetZipBytes());
+   }
+
+   double readBytes = 0.;
+
+   CppTools::Box box{"SimTreeReader: bytes read per branch"};
+
+   for (unsigned int i = 0; i < allBranches.size(); i++)
+   {
+      const double branchBytesRead = static_cast<double>(jobBranchesBytesRead[i].load());
+      readBytes += branchBytesRead;
+      // branches that were not requested are only printed if they were read (e.g. nch)
+      if (!branches.empty() && branchBytesRead == 0. &&
+          std::find(branches.begin(), branches.end(), allBranches[i]) == branches.end())
+      {
+         continue;
+      }
+      box.AddEntry(allBranches[i] + " read, MB", branchBytesRead/1048576., 3);
+   }
+
+   box.AddEntry("Total read from the branches, MB", readBytes/1048576., 3);
+   box.AddEntry("All branches on disk, MB", totalBytes/1048576., 3);
+   if (totalBytes > 0.) 
+   {
+      box.AddEntry("Read from the branches / all branches on disk", readBytes/totalBytes, 3);
+   }
+   box.AddEntry("Read from all files by the process, MB", fileBytesRead/1048576., 3);
+   box.Print();
+}
+
+void SimTreeReader::ConfigureIO(const double cacheSizeFactor, const int cacheLearnEntries,
+                                const bool asyncPrefetching)
+{
+   // these settings are read by ROOT every time the cache of a tree is created
+   gEnv->SetValue("TTreeCache.Size", cacheSizeFactor);
+   gEnv->SetValue("TFile.AsyncPrefetching", static_cast<int>(asyncPrefetching));
+   TTreeCache::SetLearnEntries(cacheLearnEntries);
+}
+
+void SimTreeReader::Prefetch(const std::string& fileName)
+{
+   // readahead is requested from a separate thread since
+   // the request may block until the reads are submitted
+   std::thread([fileName]()
+   {
+      const int fd = open(fileName.c_str(), O_RDONLY);
+      if (fd < 0) return;
+      posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+      close(fd);
+   }).detach();
 }
 
 // original momentum
@@ -272,6 +780,16 @@ float SimTreeReader::cross_z(const int i) const {return (*b_cross_z)[i];}
 float SimTreeReader::disp(const int i) const {return (*b_disp)[i];}
 float SimTreeReader::chi2(const int i) const {return (*b_chi2)[i];}
 
-SimTreeReader::~SimTreeReader() {}
+SimTreeReader::~SimTreeReader() 
+{
+   if (!treeReader) return;
+
+   // bytes of the last entry are counted here since Next() is not called after it
+   CountBytesRead();
+   for (unsigned int i = 0; i < allBranches.size(); i++)
+   {
+      jobBranchesBytesRead[i] += branchesBytesRead[i];
+   }
+}
 
 #endif /* SIM_TREE_READER_CPP */
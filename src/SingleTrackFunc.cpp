@@ -12,30 +12,84 @@
 
 #include "../include/SingleTrackFunc.hpp"
 
-ChargedTrack::ChargedTrack(const double m, const SimTreeReader& simCNT, 
+ChargedTrack::ChargedTrack(const double m, const SimEventSnapshot& simEvent, 
                            const int i, const double pTScale)
 {
    this->m = m;
    index = i;
-   pX = simCNT.mom(i)*sin(simCNT.the0(i))*cos(simCNT.phi0(i))*pTScale;
-   pY = simCNT.mom(i)*sin(simCNT.the0(i))*sin(simCNT.phi0(i))*pTScale;
-   pZ = simCNT.mom(i)*cos(simCNT.the0(i));
-   phi = simCNT.phi(i);
-   alpha = simCNT.alpha(i);
-   zed = simCNT.zed(i);
+   pX = simEvent.mom[i]*sin(simEvent.the0[i])*cos(simEvent.phi0[i])*pTScale;
+   pY = simEvent.mom[i]*sin(simEvent.the0[i])*sin(simEvent.phi0[i])*pTScale;
+   pZ = simEvent.mom[i]*cos(simEvent.the0[i]);
+   phi = simEvent.phi[i];
+   alpha = simEvent.alpha[i];
+   zed = simEvent.zed[i];
    p = sqrt(pX*pX + pY*pY + pZ*pZ);
    e = sqrt(p*p + m*m);
-   pc2phi = atan2(simCNT.ppc2y(i), simCNT.ppc2x(i));
-   pc2z = simCNT.ppc2z(i);
-   pc3phi = atan2(simCNT.ppc3y(i), simCNT.ppc3x(i));
-   pc3z = simCNT.ppc3z(i);
-   sector = simCNT.sect(i);
-   yTower = simCNT.ysect(i);
-   zTower = simCNT.zsect(i);
-   slat = simCNT.slat(i);
-   strip = simCNT.striptofw(i);
+   // pc2phi and pc3phi are evaluated from the coordinates only when needed
+   pc2x = simEvent.ppc2x[i];
+   pc2y = simEvent.ppc2y[i];
+   pc2z = simEvent.ppc2z[i];
+   pc3x = simEvent.ppc3x[i];
+   pc3y = simEvent.ppc3y[i];
+   pc3z = simEvent.ppc3z[i];
+   dcarm = simEvent.dcarm[i];
+   sector = simEvent.sect[i];
+   yTower = simEvent.ysect[i];
+   zTower = simEvent.zsect[i];
+   slat = simEvent.slat[i];
+   strip = simEvent.striptofw[i];
+}
+
+ChargedTrack::ChargedTrack(const double m, const SimTrack& track)
+{
+   this->m = m;
+   index = track.index;
+   pX = track.mom*sin(track.the0)*cos(track.phi0);
+   pY = track.mom*sin(track.the0)*sin(track.phi0);
+   pZ = track.mom*cos(track.the0);
+   phi = track.phi;
+   alpha = track.alpha;
+   zed = track.zed;
+   p = sqrt(pX*pX + pY*pY + pZ*pZ);
+   e = sqrt(p*p + m*m);
+   // phi of the hits in PC2 and PC3 are already evaluated in the track cache
+   pc2phi = track.pc2phi;
+   pc2z = track.ppc2z;
+   pc3phi = track.pc3phi;
+   pc3z = track.ppc3z;
+   pc2x = pc2y = pc3x = pc3y = 0.;
+   dcarm = track.dcarm;
+   sector = track.sect;
+   yTower = track.ysect;
+   zTower = track.zsect;
+   slat = track.slat;
+   strip = track.striptofw;
+}
+
+void ChargedTrack::SetMasks()
+{
+   registeredMask = 0;
+   if (idPC2 != PART_ID::JUNK) registeredMask |= DETECTOR_BIT::PC2;
+   if (idPC3 != PART_ID::JUNK) registeredMask |= DETECTOR_BIT::PC3;
+   if (idEMCal != PART_ID::JUNK) registeredMask |= DETECTOR_BIT::EMCAL;
+   if (idTOFe != PART_ID::JUNK) registeredMask |= DETECTOR_BIT::TOFE;
+   if (idTOFw != PART_ID::JUNK) registeredMask |= DETECTOR_BIT::TOFW;
+
+   identifiedId = PART_ID::NONE;
+   for (const int id : {idEMCal, idTOFe, idTOFw})
+   {
+      if (id != PART_ID::NONE && id != PART_ID::JUNK)
+      {
+         identifiedId = id;
+         break;
+      }
+   }
 
-   if (simCNT.dcarm(i) == 0 && pc3phi < 0) pc3phi += 2.*M_PI;
+   identifiedMask = 0;
+   if (identifiedId == PART_ID::NONE) return;
+   if (idEMCal == identifiedId) identifiedMask |= DETECTOR_BIT::EMCAL;
+   if (idTOFe == identifiedId) identifiedMask |= DETECTOR_BIT::TOFE;
+   if (idTOFw == identifiedId) identifiedMask |= DETECTOR_BIT::TOFW;
 }
 
 bool IsHit(const double dVal)
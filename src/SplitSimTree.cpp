@@ -18,11 +18,16 @@ using namespace SplitSimTree;
 
 int main(int argc, char **argv)
 {
-   if (argc < 4 || argc > 5) 
+   if (argc < 4 || argc > 7) 
    {
-      std::string errMsg = "Expected 3-4 parameters while " + std::to_string(argc - 1) + " ";
+      std::string errMsg = "Expected 3-6 parameters while " + std::to_string(argc - 1) + " ";
       errMsg += "parameter(s) were provided \n Usage: bin/SplitSimTree ";
-      errMsg += "treeFileName.root pTMin pTMax numberOfEvents=all";
+      errMsg += "treeFileName.root pTMin pTMax numberOfEvents=all outputFormat=TTree ";
+      errMsg += "numberOfThreads=1\n outputFormat can be TTree or RNTuple; pTMin and pTMax ";
+      errMsg += "can be comma separated lists (e.g. 0,2,4 2,4,8) to split the tree ";
+      errMsg += "into several pT ranges in a single pass; several pT ranges or threads ";
+      errMsg += "are processed in parallel and all outputs are compressed in parallel ";
+      errMsg += "for both output formats";
       CppTools::PrintError(errMsg);
    }
  
@@ -30,280 +35,641 @@ int main(int argc, char **argv)
  
    std::filesystem::create_directories("tmp");
 
-   pTMin = std::stod(argv[2]);
-   pTMax = std::stod(argv[3]);
+   std::stringstream pTMinStream(argv[2]);
+   std::stringstream pTMaxStream(argv[3]);
+   std::string pTMinName, pTMaxName;
 
-   TFile *inputFile = TFile::Open(argv[1]);
+   while (std::getline(pTMinStream, pTMinName, ','))
+   {
+      if (!std::getline(pTMaxStream, pTMaxName, ',')) break;
 
-   numberOfEvents = ((static_cast<TTree *>(inputFile->Get("Tree"))->GetEntries()));
-   if (argc >= 5) numberOfEvents = CppTools::Minimum(std::stoul(argv[4]), numberOfEvents);
+      pTMin.push_back(std::stod(pTMinName));
+      pTMax.push_back(std::stod(pTMaxName));
+      outputFileNames.push_back("tmp/split_tree_" + pTMinName + "-" + pTMaxName + ".root");
+   }
 
-   ProgressBar pBar{"BLOCK"};
+   if (pTMin.size() == 0 || std::getline(pTMaxStream, pTMaxName, ','))
+   {
+      CppTools::PrintError("Lists of minimum and maximum pT have different sizes");
+   }
+
+   numberOfEvents = SimTreeReader::GetNumberOfEntries(argv[1]);
+   if (argc >= 5 && std::string(argv[4]) != "all") 
+   {
+      numberOfEvents = CppTools::Minimum(std::stoul(argv[4]), numberOfEvents);
+   }
+
+   const std::string outputFormat = (argc >= 6 ? argv[5] : "TTree");
+   if (outputFormat != "TTree" && outputFormat != "RNTuple")
+   {
+      CppTools::PrintError("Unknown output format " + outputFormat + 
+                           "; expected TTree or RNTuple");
+   }
+#ifndef SIM_TREE_READER_RNTUPLE
+   if (outputFormat == "RNTuple") 
+   {
+      CppTools::PrintError("RNTuple output requires ROOT 6.36 or newer");
+   }
+#endif
+
+   if (argc == 7) numberOfThreads = std::stoi(argv[6]);
+   else numberOfThreads = 1;
+
+   // histograms are written explicitly; this also keeps histograms 
+   // of containers from different threads out of the shared directories
+   TH1::AddDirectory(false);
+
+   if (pTMin.size() == 1 && numberOfThreads == 1) Split(argv[1], outputFormat);
+   else SplitMT(argv[1], outputFormat);
+
+   SimTreeReader::PrintIOReport({argv[1]}, simTreeBranches);
+   for (const std::string& outputFileName : outputFileNames)
+   {
+      CppTools::PrintInfo("SplitSimTree has finished running; "\
+                          "split " + outputFormat + " was written as " + outputFileName);
+   }
+
+   return 0;
+}
+
+void SplitSimTree::Split(const std::string& inputFileName, const std::string& outputFormat)
+{
+   TFile *inputFile = TFile::Open(inputFileName.c_str());
 
    TTreeReader reader("Tree", inputFile);
-   SimTreeReader simCNT(reader);
+   SimTreeReader simCNT(reader, simTreeBranches);
 
-   const std::string outputFileName = "tmp/split_tree_" + std::string(argv[2]) + "-" + 
-                                      std::string(argv[3]) + ".root";
+   const unsigned long numberOfEntries = static_cast<unsigned long>(reader.GetEntries());
 
-   TFile outputFile(outputFileName.c_str(), "RECREATE");
+   ProgressBar pBar{"BLOCK"};
+
+   TFile outputFile(outputFileNames[0].c_str(), "RECREATE");
    outputFile.SetCompressionLevel(6);
 
-   while (reader.Next() && numberOfProcessedEvents < numberOfEvents)
+   Container container(&outputFile, outputFormat == "TTree");
+
+#ifdef SIM_TREE_READER_RNTUPLE
+   std::unique_ptr<ROOT::RNTupleWriter> ntupleWriter;
+   // entry into which the values of all variables are copied before it is written
+   std::unique_ptr<ROOT::REntry> ntupleEntry;
+
+   if (outputFormat == "RNTuple")
    {
-      pBar.Print(static_cast<double>(numberOfCalls)/
-                 static_cast<double>(numberOfEvents));
+      ntupleWriter = ROOT::RNTupleWriter::Append(container.CreateModel(), "Tree", outputFile);
+      ntupleEntry = ntupleWriter->CreateEntry();
+      container.BindEntry(*ntupleEntry);
+   }
+#endif
+
+   // number of events written in the output
+   unsigned long numberOfProcessedEvents = 0;
+
+   while (simCNT.Next() && numberOfProcessedEvents < numberOfEvents)
+   {
+      pBar.Print(static_cast<double>(numberOfCalls)/static_cast<double>(numberOfEntries));
 
       numberOfCalls++;
       const double origPT = sqrt(pow(simCNT.mom_orig(0), 2) + pow(simCNT.mom_orig(1), 2));
 
-      if (origPT < pTMin || origPT > pTMax) continue;
+      if (origPT < pTMin[0] || origPT > pTMax[0]) continue;
 
       numberOfProcessedEvents++;
 
-      int nch = simCNT.nch();
-
-      Container::nch.SetValue(nch);
-      Container::bbcz.SetValue(simCNT.bbcz());
-
-      for (int i = 0; i < 3; i++) {Container::mom_orig.SetValue(simCNT.mom_orig(i), i);}
+      container.SetValues(simCNT, origPT);
 
-      distrOrigPT.Fill(origPT);
-      
-      for (int i = 0; i < nch; i++)
+#ifdef SIM_TREE_READER_RNTUPLE
+      if (ntupleWriter)
       {
-         distrOrigPTVsPT.Fill(origPT, simCNT.mom(0)*sin(simCNT.the0(0)));
-
-         Container::dcarm.SetValue(simCNT.dcarm(i), i);
-         Container::phi.SetValue(simCNT.phi(i), i);
-         Container::alpha.SetValue(simCNT.alpha(i), i);
-         Container::zed.SetValue(simCNT.zed(i), i);
-         Container::mom.SetValue(simCNT.mom(i), i);
-
-         Container::phi0.SetValue(simCNT.phi0(i), i);
-         Container::the0.SetValue(simCNT.the0(i), i);
-
-         Container::nx1hits.SetValue(simCNT.nx1hits(i), i);
-         Container::nx2hits.SetValue(simCNT.nx2hits(i), i);
-         
-         Container::qual.SetValue(simCNT.qual(i), i);
-         Container::charge .SetValue(simCNT.charge(i), i);
-
-         Container::parent_id.SetValue(simCNT.parent_id(i), i);
-         Container::particle_id.SetValue(simCNT.particle_id(i), i);
-         Container::primary_id.SetValue(simCNT.primary_id(i), i);
-
-         Container::ttof.SetValue(simCNT.ttof(i), i);
-         Container::ttofw.SetValue(simCNT.ttofw(i), i);
-         Container::temc.SetValue(simCNT.temc(i), i);
-
-         Container::pltof.SetValue(simCNT.pltof(i), i);
-         Container::pltofw.SetValue(simCNT.pltofw(i), i);
-         Container::plemc.SetValue(simCNT.plemc(i), i);
-
-         Container::ptofx.SetValue(simCNT.ptofx(i), i);
-         Container::ptofy.SetValue(simCNT.ptofy(i), i);
-         Container::ptofz.SetValue(simCNT.ptofz(i), i);
-
-         Container::ptofwx.SetValue(simCNT.ptofwx(i), i);
-         Container::ptofwy.SetValue(simCNT.ptofwy(i), i);
-         Container::ptofwz.SetValue(simCNT.ptofwz(i), i);
-
-         Container::pemcx.SetValue(simCNT.pemcx(i), i);
-         Container::pemcy.SetValue(simCNT.pemcy(i), i);
-         Container::pemcz.SetValue(simCNT.pemcz(i), i);
-
-         Container::ppc1x.SetValue(simCNT.ppc1x(i), i);
-         Container::ppc1y.SetValue(simCNT.ppc1y(i), i);
-         Container::ppc1z.SetValue(simCNT.ppc1z(i), i);
-
-         Container::ppc2x.SetValue(simCNT.ppc2x(i), i);
-         Container::ppc2y.SetValue(simCNT.ppc2y(i), i);
-         Container::ppc2z.SetValue(simCNT.ppc2z(i), i);
-
-         Container::ppc3x.SetValue(simCNT.ppc3x(i), i);
-         Container::ppc3y.SetValue(simCNT.ppc3y(i), i);
-         Container::ppc3z.SetValue(simCNT.ppc3z(i), i);
-
-         Container::ptecx.SetValue(simCNT.ptecx(i), i);
-         Container::ptecy.SetValue(simCNT.ptecy(i), i);
-         Container::ptecz.SetValue(simCNT.ptecz(i), i);
-
-         Container::tofdz.SetValue(simCNT.tofdz(i), i);
-         Container::tofdphi.SetValue(simCNT.tofdphi(i), i);
-
-         Container::tofwdz.SetValue(simCNT.tofwdz(i), i);
-         Container::tofwdphi.SetValue(simCNT.tofwdphi(i), i);
-
-         Container::emcdz.SetValue(simCNT.emcdz(i), i);
-         Container::emcdphi.SetValue(simCNT.emcdphi(i), i);
-         
-         Container::pc2dphi.SetValue(simCNT.pc2dphi(i), i);
-         Container::pc2dz.SetValue(simCNT.pc2dz(i), i);
-         
-         Container::pc3dphi.SetValue(simCNT.pc3dphi(i), i);
-         Container::pc3dz.SetValue(simCNT.pc3dz(i), i);
-
-         Container::striptofw.SetValue(simCNT.striptofw(i), i);
-         Container::slat.SetValue(simCNT.slat(i), i);
-
-         Container::etof.SetValue(simCNT.etof(i), i);
-         Container::ecore.SetValue(simCNT.ecore(i), i);
-         Container::emce.SetValue(simCNT.emce(i), i);
-         Container::ecent.SetValue(simCNT.ecent(i), i);
-         Container::e9.SetValue(simCNT.e9(i), i);
-         Container::emcchi2.SetValue(simCNT.emcchi2(i), i);
-         Container::twrhit.SetValue(simCNT.twrhit(i), i);
-         Container::emcdispy.SetValue(simCNT.emcdispy(i), i);
-         Container::emcdispz.SetValue(simCNT.emcdispz(i), i);
-         Container::prob.SetValue(simCNT.prob(i), i);
-
-         Container::sect.SetValue(simCNT.sect(i), i);
-         Container::ysect.SetValue(simCNT.ysect(i), i);
-         Container::zsect.SetValue(simCNT.zsect(i), i);
-         
-         Container::n0.SetValue(simCNT.n0(i), i);
-         Container::npe0.SetValue(simCNT.npe0(i), i);
-         Container::n1.SetValue(simCNT.n1(i), i);
-         Container::npe1.SetValue(simCNT.npe1(i), i);
-         Container::n2.SetValue(simCNT.n2(i), i);
-         Container::npe2.SetValue(simCNT.npe2(i), i);
-         Container::n3.SetValue(simCNT.n3(i), i);
-         Container::npe3.SetValue(simCNT.npe3(i), i);
-         Container::center_phi.SetValue(simCNT.center_phi(i), i);
-         Container::center_z.SetValue(simCNT.center_z(i), i);
-         Container::cross_phi.SetValue(simCNT.cross_phi(i), i);
-         Container::cross_z.SetValue(simCNT.cross_z(i), i);
-         Container::disp.SetValue(simCNT.disp(i), i);
-         Container::chi2.SetValue(simCNT.chi2(i), i);
+         container.FillEntry();
+         ntupleWriter->Fill(*ntupleEntry);
+         continue;
       }
+#endif
 
-      tree.Fill();
-
+      container.Fill();
    }
 
-   HistHolder::Write();
-   tree.Write();
-   distrOrigPT.Write();
-   distrOrigPTVsPT.Write();
+#ifdef SIM_TREE_READER_RNTUPLE
+   // RNTuple is committed to the file when its writer is destroyed
+   ntupleEntry.reset();
+   ntupleWriter.reset();
+#endif
 
+   outputFile.cd();
+   container.Write(outputFormat == "TTree");
    outputFile.Close();
  
    pBar.Finish();
-   CppTools::PrintInfo("SplitSimTree has finished running; "\
-                       "split tree was written as " + outputFileName);
+}
 
-   return 0;
+void SplitSimTree::SplitMT(const std::string& inputFileName, const std::string& outputFormat)
+{
+   ROOT::EnableImplicitMT(numberOfThreads);
+
+   const unsigned long numberOfEntries = SimTreeReader::GetNumberOfEntries(inputFileName);
+
+   const bool isTreeOutput = (outputFormat == "TTree");
+
+   // each merger collects the trees and histograms from all tasks for one pT range;
+   // baskets are compressed in the tasks' threads before they are passed to the merger
+   std::vector<std::unique_ptr<ROOT::TBufferMerger>> mergers;
+#ifdef SIM_TREE_READER_RNTUPLE
+   // RNTuple cannot be merged by ROOT::TBufferMerger so each task fills its own context 
+   // of the parallel writer of each pT range in which the pages are compressed 
+   // in the task's thread; histograms of the tasks are summed in one container for each range
+   std::vector<std::unique_ptr<TFile>> ntupleFiles;
+   std::vector<std::unique_ptr<Container>> ntupleContainers;
+   std::vector<std::unique_ptr<ROOT::RNTupleParallelWriter>> ntupleWriters;
+   std::mutex ntupleContainersMutex;
+#endif
+
+   for (const std::string& outputFileName : outputFileNames)
+   {
+      if (isTreeOutput)
+      {
+         mergers.push_back(std::make_unique<ROOT::TBufferMerger>(outputFileName.c_str(), 
+                                                                 "RECREATE", 6));
+         continue;
+      }
+#ifdef SIM_TREE_READER_RNTUPLE
+      ntupleFiles.push_back(std::make_unique<TFile>(outputFileName.c_str(), "RECREATE"));
+      ntupleFiles.back()->SetCompressionLevel(6);
+      ntupleContainers.push_back(std::make_unique<Container>(ntupleFiles.back().get(), false));
+      ntupleWriters.push_back(ROOT::RNTupleParallelWriter::
+                              Append(ntupleContainers.back()->CreateModel(), "Tree", 
+                                     *ntupleFiles.back()));
+#endif
+   }
+
+   // the limit on the number of events is converted into the entry range before the processing
+   // so that each output contains the same first events regardless of the order of the tasks
+   const std::vector<unsigned long> lastEntries = GetLastEntries(inputFileName, numberOfEntries);
+
+   std::atomic<bool> isProcessFinished{false};
+
+   auto pBarCall = [&]()
+   {
+      ProgressBar pBar{"BLOCK"};
+      while (!isProcessFinished)
+      {
+         pBar.Print(static_cast<double>(numberOfCalls)/static_cast<double>(numberOfEntries));
+         std::this_thread::sleep_for(std::chrono::milliseconds(100));
+      }
+      pBar.Finish();
+   };
+
+   std::thread pBarThread(pBarCall);
+
+   ROOT::TTreeProcessorMT tp(inputFileName.c_str(), "Tree");
+
+   tp.Process([&](TTreeReader &reader)
+   {
+      SimTreeReader simCNT(reader, simTreeBranches);
+
+      std::vector<std::shared_ptr<ROOT::TBufferMergerFile>> outputFiles;
+      std::vector<std::unique_ptr<Container>> containers;
+#ifdef SIM_TREE_READER_RNTUPLE
+      std::vector<std::shared_ptr<ROOT::RNTupleFillContext>> fillContexts;
+      // entries are declared after the contexts so that they are destroyed first
+      std::vector<std::unique_ptr<ROOT::REntry>> ntupleEntries;
+#endif
+
+      for (unsigned int i = 0; i < outputFileNames.size(); i++)
+      {
+         if (isTreeOutput)
+         {
+            outputFiles.push_back(mergers[i]->GetFile());
+            containers.push_back(std::make_unique<Container>(outputFiles.back().get()));
+            continue;
+         }
+#ifdef SIM_TREE_READER_RNTUPLE
+         containers.push_back(std::make_unique<Container>(nullptr, false));
+         fillContexts.push_back(ntupleWriters[i]->CreateFillContext());
+         ntupleEntries.push_back(fillContexts.back()->CreateEntry());
+         containers.back()->BindEntry(*ntupleEntries.back());
+#endif
+      }
+
+      while (simCNT.Next())
+      {
+         numberOfCalls++;
+         const double origPT = sqrt(pow(simCNT.mom_orig(0), 2) + pow(simCNT.mom_orig(1), 2));
+
+         // the event is read once and is written into every output with the matching pT range
+         for (unsigned int i = 0; i < containers.size(); i++)
+         {
+            if (origPT < pTMin[i] || origPT > pTMax[i]) continue;
+            if (static_cast<unsigned long>(reader.GetCurrentEntry()) >= lastEntries[i]) continue;
+
+            containers[i]->SetValues(simCNT, origPT);
+
+            if (isTreeOutput)
+            {
+               containers[i]->Fill();
+               continue;
+            }
+#ifdef SIM_TREE_READER_RNTUPLE
+            containers[i]->FillEntry();
+            fillContexts[i]->Fill(*ntupleEntries[i]);
+#endif
+         }
+      }
+
+      for (unsigned int i = 0; i < containers.size(); i++)
+      {
+         if (isTreeOutput)
+         {
+            outputFiles[i]->cd();
+            // tree is attached to the file and is written with it
+            containers[i]->Write(false);
+            outputFiles[i]->Write();
+            continue;
+         }
+#ifdef SIM_TREE_READER_RNTUPLE
+         // remaining entries of the task are written when its fill context is destroyed
+         std::lock_guard<std::mutex> lock(ntupleContainersMutex);
+         ntupleContainers[i]->Add(*containers[i]);
+#endif
+      }
+   });
+
+   isProcessFinished = true;
+   pBarThread.join();
+
+#ifdef SIM_TREE_READER_RNTUPLE
+   for (unsigned int i = 0; i < ntupleWriters.size(); i++)
+   {
+      // RNTuple is committed to the file when its writer is destroyed
+      ntupleWriters[i].reset();
+      ntupleFiles[i]->cd();
+      ntupleContainers[i]->Write(false);
+      ntupleFiles[i]->Close();
+   }
+#endif
 }
 
-void SplitSimTree::HistHolder::Write()
+std::vector<unsigned long> SplitSimTree::GetLastEntries(const std::string& inputFileName, 
+                                                       const unsigned long numberOfEntries)
 {
-   for (unsigned int i = 0; i < vec.size(); i++)
+   std::vector<unsigned long> lastEntries(pTMin.size(), numberOfEntries);
+
+   // no limit on the number of events was specified
+   if (numberOfEvents >= numberOfEntries) return lastEntries;
+
+   TFile *inputFile = TFile::Open(inputFileName.c_str());
+
+   TTreeReader reader("Tree", inputFile);
+   // only the momentum is needed to determine the pT range of the event
+   SimTreeReader simCNT(reader, {"mom_orig"});
+
+   // number of events in each pT range up to the current entry
+   std::vector<unsigned long> numberOfSelectedEvents(pTMin.size(), 0);
+   // number of outputs that have reached the limit on the number of events
+   unsigned int numberOfFilledOutputs = 0;
+
+   while (numberOfFilledOutputs < pTMin.size() && simCNT.Next())
    {
-      vec[i]->Write();
+      const double origPT = sqrt(pow(simCNT.mom_orig(0), 2) + pow(simCNT.mom_orig(1), 2));
+
+      for (unsigned int i = 0; i < pTMin.size(); i++)
+      {
+         if (origPT < pTMin[i] || origPT > pTMax[i]) continue;
+         if (numberOfSelectedEvents[i] >= numberOfEvents) continue;
+
+         if (++numberOfSelectedEvents[i] == numberOfEvents)
+         {
+            lastEntries[i] = static_cast<unsigned long>(reader.GetCurrentEntry()) + 1;
+            numberOfFilledOutputs++;
+         }
+      }
+   }
+
+   inputFile->Close();
+
+   return lastEntries;
+}
+
+SplitSimTree::Container::Container(TDirectory *directory, const bool isTreeOutput) : 
+   tree(isTreeOutput ? new TTree("Tree", "Tree") : nullptr)
+{
+   if (tree) tree->SetDirectory(directory);
+}
+
+SplitSimTree::Container::~Container()
+{
+   for (TH1D *hist : hists) delete hist;
+}
+
+void SplitSimTree::Container::SetValues(const SimTreeReader& simCNT, const double origPT)
+{
+   const int numberOfTracks = simCNT.nch();
+
+   nch.SetValue(numberOfTracks);
+   bbcz.SetValue(simCNT.bbcz());
+
+   for (int i = 0; i < 3; i++) {mom_orig.SetValue(simCNT.mom_orig(i), i);}
+
+   distrOrigPT.Fill(origPT);
+   
+   for (int i = 0; i < numberOfTracks; i++)
+   {
+      distrOrigPTVsPT.Fill(origPT, simCNT.mom(0)*sin(simCNT.the0(0)));
+
+      dcarm.SetValue(simCNT.dcarm(i), i);
+      phi.SetValue(simCNT.phi(i), i);
+      alpha.SetValue(simCNT.alpha(i), i);
+      zed.SetValue(simCNT.zed(i), i);
+      mom.SetValue(simCNT.mom(i), i);
+
+      phi0.SetValue(simCNT.phi0(i), i);
+      the0.SetValue(simCNT.the0(i), i);
+
+      nx1hits.SetValue(simCNT.nx1hits(i), i);
+      nx2hits.SetValue(simCNT.nx2hits(i), i);
+      
+      qual.SetValue(simCNT.qual(i), i);
+      charge.SetValue(simCNT.charge(i), i);
+
+      parent_id.SetValue(simCNT.parent_id(i), i);
+      particle_id.SetValue(simCNT.particle_id(i), i);
+      primary_id.SetValue(simCNT.primary_id(i), i);
+
+      ttof.SetValue(simCNT.ttof(i), i);
+      ttofw.SetValue(simCNT.ttofw(i), i);
+      temc.SetValue(simCNT.temc(i), i);
+
+      pltof.SetValue(simCNT.pltof(i), i);
+      pltofw.SetValue(simCNT.pltofw(i), i);
+      plemc.SetValue(simCNT.plemc(i), i);
+
+      ptofx.SetValue(simCNT.ptofx(i), i);
+      ptofy.SetValue(simCNT.ptofy(i), i);
+      ptofz.SetValue(simCNT.ptofz(i), i);
+
+      ptofwx.SetValue(simCNT.ptofwx(i), i);
+      ptofwy.SetValue(simCNT.ptofwy(i), i);
+      ptofwz.SetValue(simCNT.ptofwz(i), i);
+
+      pemcx.SetValue(simCNT.pemcx(i), i);
+      pemcy.SetValue(simCNT.pemcy(i), i);
+      pemcz.SetValue(simCNT.pemcz(i), i);
+
+      ppc1x.SetValue(simCNT.ppc1x(i), i);
+      ppc1y.SetValue(simCNT.ppc1y(i), i);
+      ppc1z.SetValue(simCNT.ppc1z(i), i);
+
+      ppc2x.SetValue(simCNT.ppc2x(i), i);
+      ppc2y.SetValue(simCNT.ppc2y(i), i);
+      ppc2z.SetValue(simCNT.ppc2z(i), i);
+
+      ppc3x.SetValue(simCNT.ppc3x(i), i);
+      ppc3y.SetValue(simCNT.ppc3y(i), i);
+      ppc3z.SetValue(simCNT.ppc3z(i), i);
+
+      ptecx.SetValue(simCNT.ptecx(i), i);
+      ptecy.SetValue(simCNT.ptecy(i), i);
+      ptecz.SetValue(simCNT.ptecz(i), i);
+
+      tofdz.SetValue(simCNT.tofdz(i), i);
+      tofdphi.SetValue(simCNT.tofdphi(i), i);
+
+      tofwdz.SetValue(simCNT.tofwdz(i), i);
+      tofwdphi.SetValue(simCNT.tofwdphi(i), i);
+
+      emcdz.SetValue(simCNT.emcdz(i), i);
+      emcdphi.SetValue(simCNT.emcdphi(i), i);
+      
+      pc2dphi.SetValue(simCNT.pc2dphi(i), i);
+      pc2dz.SetValue(simCNT.pc2dz(i), i);
+      
+      pc3dphi.SetValue(simCNT.pc3dphi(i), i);
+      pc3dz.SetValue(simCNT.pc3dz(i), i);
+
+      striptofw.SetValue(simCNT.striptofw(i), i);
+      slat.SetValue(simCNT.slat(i), i);
+
+      etof.SetValue(simCNT.etof(i), i);
+      ecore.SetValue(simCNT.ecore(i), i);
+      emce.SetValue(simCNT.emce(i), i);
+      ecent.SetValue(simCNT.ecent(i), i);
+      e9.SetValue(simCNT.e9(i), i);
+      emcchi2.SetValue(simCNT.emcchi2(i), i);
+      twrhit.SetValue(simCNT.twrhit(i), i);
+      emcdispy.SetValue(simCNT.emcdispy(i), i);
+      emcdispz.SetValue(simCNT.emcdispz(i), i);
+      prob.SetValue(simCNT.prob(i), i);
+
+      sect.SetValue(simCNT.sect(i), i);
+      ysect.SetValue(simCNT.ysect(i), i);
+      zsect.SetValue(simCNT.zsect(i), i);
+      
+      n0.SetValue(simCNT.n0(i), i);
+      npe0.SetValue(simCNT.npe0(i), i);
+      n1.SetValue(simCNT.n1(i), i);
+      npe1.SetValue(simCNT.npe1(i), i);
+      n2.SetValue(simCNT.n2(i), i);
+      npe2.SetValue(simCNT.npe2(i), i);
+      n3.SetValue(simCNT.n3(i), i);
+      npe3.SetValue(simCNT.npe3(i), i);
+      center_phi.SetValue(simCNT.center_phi(i), i);
+      center_z.SetValue(simCNT.center_z(i), i);
+      cross_phi.SetValue(simCNT.cross_phi(i), i);
+      cross_z.SetValue(simCNT.cross_z(i), i);
+      disp.SetValue(simCNT.disp(i), i);
+      chi2.SetValue(simCNT.chi2(i), i);
    }
 }
 
-void SplitSimTree::HistHolder::Clear()
+void SplitSimTree::Container::Fill()
+{
+   tree->Fill();
+}
+
+void SplitSimTree::Container::Write(const bool writeTree)
 {
-   for (unsigned int i = 0; i < vec.size(); i++) {delete vec[i];}
-   vec.clear();
+   if (writeTree && tree) tree->Write();
+   for (TH1D *hist : hists) hist->Write();
+   distrOrigPT.Write();
+   distrOrigPTVsPT.Write();
 }
 
-unsigned int SplitSimTree::HistHolder::CurrentPos() 
+void SplitSimTree::Container::Add(const Container& container)
 {
-   return vec.size();
+   for (unsigned long i = 0; i < hists.size(); i++) hists[i]->Add(container.hists[i]);
+   distrOrigPT.Add(&container.distrOrigPT);
+   distrOrigPTVsPT.Add(&container.distrOrigPTVsPT);
 }
 
-SplitSimTree::SimVarInt::SimVarInt(const std::string& name, const double xMin, 
-                                   const double xMax, const int nbins)
+#ifdef SIM_TREE_READER_RNTUPLE
+std::unique_ptr<ROOT::RNTupleModel> SplitSimTree::Container::CreateModel() const
 {
-   tree.Branch(name.c_str(), &val, (name + "/I").c_str());
-   HistHolder::vec.push_back(new TH1D(name.c_str(), name.c_str(), nbins, xMin, xMax));
-   histHolderIndex = HistHolder::CurrentPos() - 1;
+   std::unique_ptr<ROOT::RNTupleModel> model = ROOT::RNTupleModel::Create();
+   for (const auto& fieldMaker : fieldMakers) fieldMaker(*model);
+   return model;
+}
+
+void SplitSimTree::Container::BindEntry(ROOT::REntry& entry)
+{
+   entryFillers.clear();
+   for (const auto& fieldBinder : fieldBinders) entryFillers.push_back(fieldBinder(entry));
+}
+
+void SplitSimTree::Container::FillEntry()
+{
+   for (const auto& entryFiller : entryFillers) entryFiller();
+}
+#endif
+
+int SplitSimTree::GetArraySize(const Container& container, const std::string& size)
+{
+   if (size == "nch") return container.nch.val;
+   return std::stoi(size);
+}
+
+#ifdef SIM_TREE_READER_RNTUPLE
+template<typename T>
+void SplitSimTree::AddField(Container& container, const std::string& name, 
+                            const std::function<void(T&)>& copy)
+{
+   container.fieldMakers.push_back([name](ROOT::RNTupleModel& model)
+   {
+      model.MakeField<T>(name);
+   });
+   container.fieldBinders.push_back([name, copy](ROOT::REntry& entry)
+   {
+      std::shared_ptr<T> field = entry.GetPtr<T>(name);
+      return std::function<void()>([field, copy]() {copy(*field);});
+   });
+}
+#endif
+
+SplitSimTree::SimVarInt::SimVarInt(Container& container, const std::string& name, 
+                                   const double xMin, const double xMax, const int nbins)
+{
+   if (container.tree) container.tree->Branch(name.c_str(), &val, (name + "/I").c_str());
+   
+   hist = new TH1D(name.c_str(), name.c_str(), nbins, xMin, xMax);
+   container.hists.push_back(hist);
+#ifdef SIM_TREE_READER_RNTUPLE
+   AddField<int>(container, name, [this](int& field) {field = val;});
+#endif
 }
 
 void SplitSimTree::SimVarInt::SetValue(const int newVal)
 {
    val = newVal;
-   HistHolder::vec[histHolderIndex]->Fill(static_cast<double>(newVal));
+   hist->Fill(static_cast<double>(newVal));
 }
 
-SplitSimTree::SimVarShort::SimVarShort(const std::string& name, const double xMin, 
-                                       const double xMax, const int nbins)
+SplitSimTree::SimVarShort::SimVarShort(Container& container, const std::string& name, 
+                                       const double xMin, const double xMax, const int nbins)
 {
-   tree.Branch(name.c_str(), &val, (name + "/S").c_str());
+   if (container.tree) container.tree->Branch(name.c_str(), &val, (name + "/S").c_str());
    
-   HistHolder::vec.push_back(new TH1D(name.c_str(), name.c_str(), nbins, xMin, xMax));
-   histHolderIndex = HistHolder::CurrentPos() - 1;
+   hist = new TH1D(name.c_str(), name.c_str(), nbins, xMin, xMax);
+   container.hists.push_back(hist);
+#ifdef SIM_TREE_READER_RNTUPLE
+   AddField<short>(container, name, [this](short& field) {field = val;});
+#endif
 }
 
 void SplitSimTree::SimVarShort::SetValue(const short newVal)
 {
    val = newVal;
-   HistHolder::vec[histHolderIndex]->Fill(static_cast<double>(newVal));
+   hist->Fill(static_cast<double>(newVal));
 }
 
-SplitSimTree::SimVarF::SimVarF(const std::string& name, const double xMin, 
-                               const double xMax, const int nbins)
+SplitSimTree::SimVarF::SimVarF(Container& container, const std::string& name, 
+                               const double xMin, const double xMax, const int nbins)
 {
-   tree.Branch(name.c_str(), &val, (name + "/F").c_str());
+   if (container.tree) container.tree->Branch(name.c_str(), &val, (name + "/F").c_str());
    
-   HistHolder::vec.push_back(new TH1D(name.c_str(), name.c_str(), nbins, xMin, xMax));
-   histHolderIndex = HistHolder::CurrentPos()-1;
+   hist = new TH1D(name.c_str(), name.c_str(), nbins, xMin, xMax);
+   container.hists.push_back(hist);
+#ifdef SIM_TREE_READER_RNTUPLE
+   AddField<float>(container, name, [this](float& field) {field = val;});
+#endif
 }
 
 void SplitSimTree::SimVarF::SetValue(const float newVal)
 {
    val = newVal;
-   HistHolder::vec[histHolderIndex]->Fill(static_cast<double>(newVal));
+   hist->Fill(static_cast<double>(newVal));
 }
 
-SplitSimTree::SimVarIntArr::SimVarIntArr(const std::string& name, 
+SplitSimTree::SimVarIntArr::SimVarIntArr(Container& container, const std::string& name, 
                                          const double xMin, const double xMax, 
                                          const std::string& size, const int nbins)
 {
-   tree.Branch(name.c_str(), &val, (name + "[" + size + "]/I").c_str());
+   if (container.tree) 
+   {
+      container.tree->Branch(name.c_str(), &val, (name + "[" + size + "]/I").c_str());
+   }
    
-   HistHolder::vec.push_back(new TH1D(name.c_str(), name.c_str(), nbins, xMin, xMax));
-   histHolderIndex = HistHolder::CurrentPos()-1;
+   hist = new TH1D(name.c_str(), name.c_str(), nbins, xMin, xMax);
+   container.hists.push_back(hist);
+#ifdef SIM_TREE_READER_RNTUPLE
+   AddField<std::vector<int>>(container, name, [this, &container, size](std::vector<int>& field)
+   {
+      field.assign(val, val + GetArraySize(container, size));
+   });
+#endif
 }
+
 void SplitSimTree::SimVarIntArr::SetValue(const int newVal, const unsigned int index)
 {
    val[index] = newVal;
-   HistHolder::vec[histHolderIndex]->Fill(static_cast<double>(newVal));
+   hist->Fill(static_cast<double>(newVal));
 }
 
-SplitSimTree::SimVarShortArr::SimVarShortArr(const std::string& name, 
+SplitSimTree::SimVarShortArr::SimVarShortArr(Container& container, const std::string& name, 
                                              const double xMin, const double xMax, 
                                              const std::string& size, const int nbins)
 {
-   tree.Branch(name.c_str(), &val, (name + "[" + size + "]/S").c_str());
+   if (container.tree) 
+   {
+      container.tree->Branch(name.c_str(), &val, (name + "[" + size + "]/S").c_str());
+   }
    
-   HistHolder::vec.push_back(new TH1D(name.c_str(), name.c_str(), nbins, xMin, xMax));
-   histHolderIndex = HistHolder::CurrentPos()-1;
+   hist = new TH1D(name.c_str(), name.c_str(), nbins, xMin, xMax);
+   container.hists.push_back(hist);
+#ifdef SIM_TREE_READER_RNTUPLE
+   AddField<std::vector<short>>(container, name, [this, &container, size](std::vector<short>& field)
+   {
+      field.assign(val, val + GetArraySize(container, size));
+   });
+#endif
 }
 
 void SplitSimTree::SimVarShortArr::SetValue(const short newVal, const unsigned int index)
 {
    val[index] = newVal;
-   HistHolder::vec[histHolderIndex]->Fill(static_cast<double>(newVal));
+   hist->Fill(static_cast<double>(newVal));
 }
 
-SplitSimTree::SimVarFArr::SimVarFArr(const std::string& name, 
+SplitSimTree::SimVarFArr::SimVarFArr(Container& container, const std::string& name, 
                                      const double xMin, const double xMax, 
                                      const std::string& size, const int nbins)
 {
-   tree.Branch(name.c_str(), &val, (name + "[" + size + "]/F").c_str());
+   if (container.tree) 
+   {
+      container.tree->Branch(name.c_str(), &val, (name + "[" + size + "]/F").c_str());
+   }
    
-   HistHolder::vec.push_back(new TH1D(name.c_str(), name.c_str(), nbins, xMin, xMax));
-   histHolderIndex = HistHolder::CurrentPos()-1;
+   hist = new TH1D(name.c_str(), name.c_str(), nbins, xMin, xMax);
+   container.hists.push_back(hist);
+#ifdef SIM_TREE_READER_RNTUPLE
+   AddField<std::vector<float>>(container, name, [this, &container, size](std::vector<float>& field)
+   {
+      field.assign(val, val + GetArraySize(container, size));
+   });
+#endif
 }
 
 void SplitSimTree::SimVarFArr::SetValue(const float newVal, const unsigned int index)
 {
    val[index] = newVal;
-   HistHolder::vec[histHolderIndex]->Fill(static_cast<double>(newVal));
+   hist->Fill(static_cast<double>(newVal));
 }
 
 #endif /* SPLIT_SIM_TREE_CPP */